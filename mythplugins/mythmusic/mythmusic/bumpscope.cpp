@@ -10,22 +10,34 @@
 #include <numbers>
 
 // QT headers
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6,5,0)
+#include <QtProcessorDetection>
+#endif
 #include <QCoreApplication>
-#include <QPainter>
 
 // MythTV headers
 #include <libmythbase/compat.h>
-#include <libmythbase/mythlogging.h>
+#include <libmythbase/mythconfig.h>
 #include <libmythbase/mythrandom.h>
-#ifndef __cpp_size_t_suffix
-#include <libmythbase/sizetliteral.h>
-#endif
 
 // Mythmusic Headers
 #include "bumpscope.h"
 #include "mainvisual.h"
 
+#ifdef Q_PROCESSOR_X86_64
+#   include <emmintrin.h>
+static const bool s_haveSIMD = true;
+#elif HAVE_INTRINSICS_NEON
+#   include <arm_neon.h>
+extern "C" {
+#include <libavutil/cpu.h>
+}
+static const bool s_haveSIMD = (av_get_cpu_flags() & AV_CPU_FLAG_NEON) != 0;
+#endif
+
 BumpScope::BumpScope()
+  : ThreadedVisual("BumpScope")
 {
     m_fps = 15;
 
@@ -40,91 +52,125 @@ BumpScope::BumpScope()
 
 BumpScope::~BumpScope()
 {
-    delete [] m_rgbBuf;
-    delete m_image;
-    for (auto & dat : m_phongDat)
-        dat.clear();
-    m_phongDat.clear();
+    stopRendering();
 }
 
-void BumpScope::resize(const QSize &newsize)
+// called on the render thread
+void BumpScope::resizeBuffers(QSize size)
 {
-    m_size = newsize;
-
-    m_size.setHeight((m_size.height() / 2) * 2);
-    m_size.setWidth((m_size.width() / 4) * 4);
-
-    delete [] m_rgbBuf;
+    m_renderSize = size;
 
-    int bufsize = (m_size.height() + 2) * (m_size.width() + 2);
+    m_width = (size.width() / 4) * 4;
+    m_height = (size.height() / 2) * 2;
+    m_bpl = m_width + 2;
 
-    m_rgbBuf = new unsigned char[bufsize];
+    size_t bufsize = static_cast<size_t>(m_height + 2) * (m_width + 2);
+    m_rgbBuf.assign(bufsize, 0);
+    m_blurBuf.assign(bufsize, 0);
 
-    m_bpl = m_size.width() + 2;
-
-    delete m_image;
-    m_image = new QImage(m_size.width(), m_size.height(), QImage::Format_Indexed8);
-
-    m_width = m_size.width();
-    m_height = m_size.height();
     m_phongRad = m_width;
 
     m_x = m_width / 2;
     m_y = m_height;
 
-#ifdef __cpp_size_t_suffix
-    m_phongDat.resize(m_phongRad * 2UZ);
-    for (auto & dat : m_phongDat)
-        dat.resize(m_phongRad * 2UZ);
-#else
-    m_phongDat.resize(m_phongRad * 2_UZ);
-    for (auto & dat : m_phongDat)
-        dat.resize(m_phongRad * 2_UZ);
-#endif
+    m_phongDat.assign(static_cast<size_t>(m_phongRad) * 2 * m_phongRad * 2, 0);
 
     generate_phongdat();
     generate_cmap(m_color);
 }
 
-void BumpScope::blur_8(unsigned char *ptr, [[maybe_unused]] int w, int h, ptrdiff_t bpl)
+#ifdef Q_PROCESSOR_X86_64
+static inline __m128i blurLanes(__m128i up, __m128i left, __m128i right, __m128i down)
+{
+    const __m128i two = _mm_set1_epi16(2);
+    __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(up, left),
+                                               _mm_add_epi16(right, down)), 2);
+    return _mm_sub_epi16(sum, _mm_and_si128(_mm_cmpgt_epi16(sum, two), two));
+}
+#elif HAVE_INTRINSICS_NEON
+static inline uint8x8_t blurLanes(uint8x8_t up, uint8x8_t left, uint8x8_t right, uint8x8_t down)
 {
-    uchar *iptr = ptr + bpl + 1;
-    uint i = bpl * h;
+    const uint16x8_t two = vdupq_n_u16(2);
+    uint16x8_t sum = vshrq_n_u16(vaddq_u16(vaddl_u8(up, left), vaddl_u8(right, down)), 2);
+    return vmovn_u16(vsubq_u16(sum, vandq_u16(vcgtq_u16(sum, two), two)));
+}
+#endif
+
+/* Each pixel becomes the average of the four around it in src, less 2 if
+ * that is more than 2. The first and last rows are never written, so they
+ * must start out zero in dst. */
+void BumpScope::blur_8(const unsigned char *src, unsigned char *dst, int h, ptrdiff_t bpl)
+{
+    const uchar *iptr = src + bpl + 1;
+    uchar *optr = dst + bpl + 1;
+    ptrdiff_t count = (bpl * h) - 1;
+    ptrdiff_t i = 0;
+
+#if defined(Q_PROCESSOR_X86_64) || HAVE_INTRINSICS_NEON
+    if (s_haveSIMD)
+    {
+        for (; i + 16 <= count; i += 16)
+        {
+#ifdef Q_PROCESSOR_X86_64
+            auto load = [](const uchar *p)
+                { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); };
+            const __m128i zero  = _mm_setzero_si128();
+            const __m128i up    = load(iptr + i - bpl);
+            const __m128i left  = load(iptr + i - 1);
+            const __m128i right = load(iptr + i + 1);
+            const __m128i down  = load(iptr + i + bpl);
+            __m128i lo = blurLanes(_mm_unpacklo_epi8(up, zero), _mm_unpacklo_epi8(left, zero),
+                                   _mm_unpacklo_epi8(right, zero), _mm_unpacklo_epi8(down, zero));
+            __m128i hi = blurLanes(_mm_unpackhi_epi8(up, zero), _mm_unpackhi_epi8(left, zero),
+                                   _mm_unpackhi_epi8(right, zero), _mm_unpackhi_epi8(down, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(optr + i), _mm_packus_epi16(lo, hi));
+#else
+            const uint8x16_t up    = vld1q_u8(iptr + i - bpl);
+            const uint8x16_t left  = vld1q_u8(iptr + i - 1);
+            const uint8x16_t right = vld1q_u8(iptr + i + 1);
+            const uint8x16_t down  = vld1q_u8(iptr + i + bpl);
+            vst1q_u8(optr + i, vcombine_u8(
+                         blurLanes(vget_low_u8(up), vget_low_u8(left),
+                                   vget_low_u8(right), vget_low_u8(down)),
+                         blurLanes(vget_high_u8(up), vget_high_u8(left),
+                                   vget_high_u8(right), vget_high_u8(down))));
+#endif
+        }
+    }
+#endif
 
-    while (i--)
+    for (; i < count; i++)
     {
-        uint sum = (iptr[-bpl] + iptr[-1] + iptr[1] + iptr[bpl]) >> 2;
+        uint sum = (iptr[i - bpl] + iptr[i - 1] + iptr[i + 1] + iptr[i + bpl]) >> 2;
         if (sum > 2)
             sum -= 2;
-        *(iptr++) = sum;
+        optr[i] = sum;
     }
 }
 
 void BumpScope::generate_cmap(unsigned int color)
 {
-    if (m_image)
-    {
-        uint red = color / 0x10000;
-        uint green = (color % 0x10000) / 0x100;
-        uint blue = color % 0x100;
+    uint red = color / 0x10000;
+    uint green = (color % 0x10000) / 0x100;
+    uint blue = color % 0x100;
 
-        for (uint i = 255; i > 0; i--)
-        {
-             uint r = (unsigned int)(((100 * static_cast<double>(red) / 255)
-                                * m_intense1[i]) + m_intense2[i]);
-             r = std::min<uint>(r, 255);
-             uint g = (unsigned int)(((100 * static_cast<double>(green) / 255)
-                                * m_intense1[i]) + m_intense2[i]);
-             g = std::min<uint>(g, 255);
-             uint b = (unsigned int)(((100 * static_cast<double>(blue) / 255)
-                                * m_intense1[i]) + m_intense2[i]);
-             b = std::min<uint>(b, 255);
-
-             m_image->setColor(i, qRgba(r, g, b, 255));
-         }
-
-         m_image->setColor(0, m_image->color(1));
+    m_colorTable.resize(256);
+    for (uint i = 255; i > 0; i--)
+    {
+        uint r = (unsigned int)(((100 * static_cast<double>(red) / 255)
+                                 * m_intense1[i]) + m_intense2[i]);
+        r = std::min<uint>(r, 255);
+        uint g = (unsigned int)(((100 * static_cast<double>(green) / 255)
+                                 * m_intense1[i]) + m_intense2[i]);
+        g = std::min<uint>(g, 255);
+        uint b = (unsigned int)(((100 * static_cast<double>(blue) / 255)
+                                 * m_intense1[i]) + m_intense2[i]);
+        b = std::min<uint>(b, 255);
+
+        m_colorTable[i] = qRgba(r, g, b, 255);
     }
+
+    m_colorTable[0] = m_colorTable[1];
 }
 
 void BumpScope::generate_phongdat(void)
@@ -153,17 +199,17 @@ void BumpScope::generate_phongdat(void)
                 i = std::min<double>(i, 255);
                 auto uci = (unsigned char)i;
 
-                m_phongDat[y][x] = uci;
-                m_phongDat[(PHONGRES-1)-y][x] = uci;
-                m_phongDat[y][(PHONGRES-1)-x] = uci;
-                m_phongDat[(PHONGRES-1)-y][(PHONGRES-1)-x] = uci;
+                m_phongDat[(y * PHONGRES) + x] = uci;
+                m_phongDat[(((PHONGRES-1)-y) * PHONGRES) + x] = uci;
+                m_phongDat[(y * PHONGRES) + (PHONGRES-1)-x] = uci;
+                m_phongDat[(((PHONGRES-1)-y) * PHONGRES) + (PHONGRES-1)-x] = uci;
             }
             else
             {
-                m_phongDat[y][x] = 0;
-                m_phongDat[(PHONGRES-1)-y][x] = 0;
-                m_phongDat[y][(PHONGRES-1)-x] = 0;
-                m_phongDat[(PHONGRES-1)-y][(PHONGRES-1)-x] = 0;
+                m_phongDat[(y * PHONGRES) + x] = 0;
+                m_phongDat[(((PHONGRES-1)-y) * PHONGRES) + x] = 0;
+                m_phongDat[(y * PHONGRES) + (PHONGRES-1)-x] = 0;
+                m_phongDat[(((PHONGRES-1)-y) * PHONGRES) + (PHONGRES-1)-x] = 0;
             }
         }
     }
@@ -247,7 +293,7 @@ inline void BumpScope::draw_vert_line(unsigned char *buffer, int x, int y1,
     }
 }
 
-void BumpScope::render_light(int lx, int ly)
+void BumpScope::render_light(unsigned char *outputbuf, int lx, int ly)
 {
     int dy = 0;
     unsigned int PHONGRES = m_phongRad * 2;
@@ -255,7 +301,7 @@ void BumpScope::render_light(int lx, int ly)
 
     int prev_y = m_bpl + 1;
     int out_y = 0;
-    unsigned char *outputbuf = m_image->bits();
+    const unsigned char *phongDat = m_phongDat.data();
 
     for (dy = (-ly) + (PHONGRES / 2), j = 0; j < m_height; j++, dy++,
          prev_y += m_bpl - m_width)
@@ -275,7 +321,7 @@ void BumpScope::render_light(int lx, int ly)
                 continue;
             }
 
-            outputbuf[out_y] = m_phongDat[yp][xp];
+            outputbuf[out_y] = phongDat[(yp * PHONGRES) + xp];
         }
     }
 }
@@ -355,48 +401,62 @@ void BumpScope::hsv_to_rgb(double h, double s, double v, unsigned int *color)
   *color = ((unsigned int)(r*255)<<16) | ((unsigned int)(g*255)<<8) | ((unsigned int)(b*255));
 }
 
-bool BumpScope::process(VisualNode *node)
+// called on the render thread
+bool BumpScope::renderFrame(const VisualRenderer::Samples &samples,
+                            QSize size, QImage &image)
 {
-    if (!node || node->m_length == 0 || !m_image)
+    if (size != m_renderSize)
+        resizeBuffers(size);
+    if (m_width == 0 || m_height == 0)
         return false;
 
-    int numSamps = 512;
-    if (node->m_length < 512)
-        numSamps = node->m_length;
+    if (!samples.m_left.empty())
+        drawScope(samples.m_left);
+
+    const AudioAnalysis *analysis = samples.m_analysis.get();
+    animateLight((analysis && analysis->IsReady()) ? analysis : nullptr);
+
+    if (image.width() != (int)m_width || image.height() != (int)m_height ||
+        image.format() != QImage::Format_Indexed8)
+    {
+        image = QImage(m_width, m_height, QImage::Format_Indexed8);
+    }
+    image.setColorTable(m_colorTable);
+    render_light(image.bits(), m_ilx, m_ily);
+
+    return true;
+}
+
+void BumpScope::drawScope(const std::vector<short> &samples)
+{
+    int numSamps = std::min<int>(samples.size(), 512);
 
     int prev_y = ((int)m_height / 2) +
-        (((int)node->m_left[0] * (int)m_height) / 0x10000);
+        (((int)samples[0] * (int)m_height) / 0x10000);
 
     prev_y = std::max(prev_y, 0);
     if (prev_y >= (int)m_height) prev_y = m_height - 1;
 
     for (uint i = 0; i < m_width; i++)
     {
-        int y = (i * numSamps) / (m_width - 1);
+        int y = std::min<int>((i * numSamps) / (m_width - 1), numSamps - 1);
         y = ((int)m_height / 2) +
-            (((int)node->m_left[y] * (int)m_height) / 0x10000);
+            (((int)samples[y] * (int)m_height) / 0x10000);
 
         y = std::max(y, 0);
         if (y >= (int)m_height)
             y = m_height - 1;
 
-        draw_vert_line(m_rgbBuf, i, prev_y, y);
+        draw_vert_line(m_rgbBuf.data(), i, prev_y, y);
         prev_y = y;
     }
 
-    blur_8(m_rgbBuf, m_width, m_height, m_bpl);
-
-    return false;
+    blur_8(m_rgbBuf.data(), m_blurBuf.data(), m_height, m_bpl);
+    m_rgbBuf.swap(m_blurBuf);
 }
 
-bool BumpScope::draw(QPainter *p, [[maybe_unused]] const QColor &back)
+void BumpScope::animateLight(const AudioAnalysis *analysis)
 {
-    if (!m_image || m_image->isNull())
-    {
-        LOG(VB_GENERAL, LOG_ERR, "BumpScope::draw: Bad image");
-        return false;
-    }
-
     m_ilx = m_x;
     m_ily = m_y;
 
@@ -467,7 +527,18 @@ bool BumpScope::draw(QPainter *p, [[maybe_unused]] const QColor &back)
             }
         }
 
-        hsv_to_rgb(m_ih, m_is, m_iv, &m_icolor);
+        // a beat turns the colour, counted so one between frames is not
+        // missed, and louder music is brighter
+        bool beat = rand_bool(150);
+        double v = m_iv;
+        if (analysis)
+        {
+            beat = (analysis->m_beatCount != m_beatCount);
+            m_beatCount = analysis->m_beatCount;
+            v *= std::clamp(0.5 + (2.0 * std::sqrt(analysis->m_energy)), 0.5, 1.0);
+        }
+
+        hsv_to_rgb(m_ih, m_is, v, &m_icolor);
 
         generate_cmap(m_icolor);
 
@@ -478,7 +549,7 @@ bool BumpScope::draw(QPainter *p, [[maybe_unused]] const QColor &back)
                 m_ih = 0;
             if (m_ih < 0)
                 m_ih = 359;
-            if (rand_bool(150))
+            if (beat)
             {
                 if (rand_bool())
                 {
@@ -525,11 +596,6 @@ bool BumpScope::draw(QPainter *p, [[maybe_unused]] const QColor &back)
         }
     }
 
-    render_light(m_ilx, m_ily);
-
-    p->drawImage(0, 0, *m_image);
-
-    return true;
 }
 
 static class BumpScopeFactory : public VisFactory
@@ -5,19 +5,28 @@
 
 #include <vector>
 
-class BumpScope : public VisualBase
+#include <QImage>
+#include <QVector>
+
+class BumpScope : public ThreadedVisual
 {
 public:
     BumpScope();
     ~BumpScope() override;
 
-    void resize(const QSize &size) override; // VisualBase
-    bool process(VisualNode *node) override; // VisualBase
-    bool draw(QPainter *p, const QColor &back) override; // VisualBase
     void handleKeyPress([[maybe_unused]] const QString &action) override {}; // VisualBase
+    // the light changes colour on the beat and brightens with the music
+    bool needsAnalysis(void) override { return true; } // VisualBase
+
+protected:
+    bool renderFrame(const VisualRenderer::Samples &samples,
+                     QSize size, QImage &image) override; // ThreadedVisual
 
 private:
-    static void blur_8(unsigned char *ptr, int w, int h, ptrdiff_t bpl);
+    void resizeBuffers(QSize size);
+    void drawScope(const std::vector<short> &samples);
+    void animateLight(const AudioAnalysis *analysis);
+    static void blur_8(const unsigned char *src, unsigned char *dst, int h, ptrdiff_t bpl);
 
     void generate_cmap(unsigned int color);
     void generate_phongdat(void);
@@ -26,14 +35,13 @@ private:
                    int *angle) const;
 
     inline void draw_vert_line(unsigned char *buffer, int x, int y1, int y2) const;
-    void render_light(int lx, int ly);
+    void render_light(unsigned char *outputbuf, int lx, int ly);
 
     static void rgb_to_hsv(unsigned int color, double *h, double *s, double *v);
     static void hsv_to_rgb(double h, double s, double v, unsigned int *color);
 
-    QImage        *m_image          {nullptr};
-
-    QSize          m_size           {0,0};
+    QSize          m_renderSize     {0,0};
+    QVector<QRgb>  m_colorTable;
 
     unsigned int   m_color          {0x2050FF};
     unsigned int   m_x              {0};
@@ -48,8 +56,9 @@ private:
 
     ptrdiff_t      m_bpl            {0};
 
-    std::vector<std::vector<unsigned char> > m_phongDat;
-    unsigned char *m_rgbBuf         {nullptr};
+    std::vector<unsigned char> m_phongDat;  ///< m_phongRad * 2 square
+    std::vector<unsigned char> m_rgbBuf;
+    std::vector<unsigned char> m_blurBuf;
     std::array<double,256> m_intense1 {};
     std::array<double,256> m_intense2 {};
 
@@ -68,6 +77,7 @@ private:
     double         m_isd            {0.0};
     int            m_ihd            {0};
     unsigned int   m_icolor         {0};
+    uint32_t       m_beatCount      {0};
 };
 
 
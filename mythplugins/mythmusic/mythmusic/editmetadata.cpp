@@ -61,16 +61,7 @@ EditMetadataCommon::~EditMetadataCommon()
         s_metadata->getAlbumArtImages()->dumpToDatabase();
 
         // force a reload of the images for any tracks affected
-        MetadataPtrList *allMusic =  gMusicData->m_all_music->getAllMetadata();
-        for (int x = 0; x < allMusic->count(); x++)
-        {
-            if ((allMusic->at(x)->ID() == s_sourceMetadata->ID()) ||
-                (allMusic->at(x)->getDirectoryId() == s_sourceMetadata->getDirectoryId()))
-            {
-                allMusic->at(x)->reloadAlbumArtImages();
-                gPlayer->sendAlbumArtChangedEvent(allMusic->at(x)->ID());
-            }
-        }
+        reloadAlbumArt();
     }
 }
 
@@ -214,6 +205,7 @@ void EditMetadataCommon::saveToDatabase()
     s_metadata->dumpToDatabase();
     *s_sourceMetadata = *s_metadata;
 
+    gMusicData->m_all_music->refreshTrack(s_sourceMetadata->ID());
     gPlayer->sendMetadataChangedEvent(s_sourceMetadata->ID());
 }
 
@@ -284,6 +276,26 @@ void EditMetadataCommon::scanForImages(void)
     s_metadata->getAlbumArtImages()->scanForImages();
 }
 
+/// reload the album art of the edited track and the tracks that share its directory
+void EditMetadataCommon::reloadAlbumArt(void)
+{
+    MusicTrackIndex *index = gMusicData->m_all_music->getIndex();
+    MusicTrackIdList tracks = index->filter(index->ids(), MusicTrackIndex::kDirectoryId,
+                                            s_sourceMetadata->getDirectoryId());
+    if (!tracks.contains(s_sourceMetadata->ID()))
+        tracks.append(s_sourceMetadata->ID());
+
+    for (MusicMetadata::IdType id : std::as_const(tracks))
+    {
+        MusicMetadata *mdata = gMusicData->m_all_music->getMetadata(id);
+        if (mdata)
+        {
+            mdata->reloadAlbumArtImages();
+            gPlayer->sendAlbumArtChangedEvent(id);
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // EditMatadataDialog
 
@@ -849,16 +861,7 @@ void EditMetadataDialog::customEvent(QEvent *event)
 
                 s_metadata->getAlbumArtImages()->dumpToDatabase();
                 // force a reload of the images for any tracks affected
-                MetadataPtrList *allMusic =  gMusicData->m_all_music->getAllMetadata();
-                for (int x = 0; x < allMusic->count(); x++)
-                {
-                    if ((allMusic->at(x)->ID() == s_sourceMetadata->ID()) ||
-                        (allMusic->at(x)->getDirectoryId() == s_sourceMetadata->getDirectoryId()))
-                    {
-                        allMusic->at(x)->reloadAlbumArtImages();
-                        gPlayer->sendAlbumArtChangedEvent(allMusic->at(x)->ID());
-                    }
-                }
+                reloadAlbumArt();
             }
         }
     }
@@ -48,6 +48,7 @@ class EditMetadataCommon : public MythScreenType
     void updateMetadata(void);
     void searchForAlbumImages(void);
     static void scanForImages(void);
+    static void reloadAlbumArt(void);
 
     static bool           s_metadataOnly;
     static MusicMetadata *s_metadata;
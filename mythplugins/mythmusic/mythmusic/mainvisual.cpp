@@ -47,6 +47,8 @@ MainVisual::MainVisual(MythUIVideo *visualizer)
 
     resize(m_visualizerVideo->GetArea().size());
 
+    m_analyser = new AudioAnalyser();
+
     m_updateTimer = new QTimer(this);
     m_updateTimer->setInterval(1000 / m_fps);
     m_updateTimer->setSingleShot(true);
@@ -63,6 +65,8 @@ MainVisual::~MainVisual()
     while (!m_nodes.empty())
         delete m_nodes.takeLast();
 
+    delete m_analyser;
+
     gCoreContext->SaveSetting("MusicLastVisualizer", m_currentVisualizer);
 }
 
@@ -124,6 +128,7 @@ void MainVisual::setVisual(const QString &name)
             m_samples = m_vis->getDesiredSamples();
 
             QMutexLocker locker(mutex());
+            m_analyse = m_vis->needsAnalysis();
             prepare();
 
             break;
@@ -139,6 +144,7 @@ void MainVisual::prepare()
 {
     while (!m_nodes.empty())
         delete m_nodes.takeLast();
+    m_analyser->Reset();
 }
 
 // This is called via : mythtv/libs/libmythtv/audio/audiooutput.cpp :: AudioOutput::dispatchVisual
@@ -205,7 +211,11 @@ void MainVisual::add(const void *buffer, unsigned long b_len,
         len = 0;
     }
 
-    m_nodes.append(new VisualNode(l, r, len, timecode));
+    auto *node = new VisualNode(l, r, len, timecode);
+    // the FFT is done once for every visualiser on the analyser's thread
+    if (m_analyse)
+        node->m_analysis = m_analyser->Add(l, r, len, timecode);
+    m_nodes.append(node);
 }
 
 void MainVisual::timeout()
@@ -274,6 +284,13 @@ void MainVisual::customEvent(QEvent *event)
         m_playing = true;
         if (!m_updateTimer->isActive())
             m_updateTimer->start();
+
+        if (event->type() == AudioOutput::Event::kInfo)
+        {
+            auto *oe = dynamic_cast<AudioOutput::Event *>(event);
+            if (oe)
+                m_analyser->SetSampleRate(oe->frequency());
+        }
     }
     else if ((event->type() == AudioOutput::Event::kStopped) ||
              (event->type() == AudioOutput::Event::kError))
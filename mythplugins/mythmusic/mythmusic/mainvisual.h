@@ -23,6 +23,7 @@
 #include <QWidget>
 
 // MythTV headers
+#include <libmythtv/audio/audioanalyser.h>
 #include <libmythtv/audio/visualization.h>
 
 // MythMusic
@@ -68,6 +69,8 @@ class MainVisual :  public QObject, public Visualization
     QStringList m_visualizers;
     int m_currentVisualizer        {0};
     VisualBase *m_vis              {nullptr};
+    AudioAnalyser *m_analyser      {nullptr};
+    bool m_analyse                 {false}; ///< m_vis wants an AudioAnalysis
     QPixmap m_pixmap;
     QList<VisualNode*> m_nodes;
     bool m_playing                 {false};
@@ -18,6 +18,7 @@
 // mythmusic
 #include "musicdata.h"
 #include "musicplayer.h"
+#include "smartplaylist.h"
 
 // this is the global MusicData object shared thoughout MythMusic
 MusicData  *gMusicData = nullptr;
@@ -46,6 +47,9 @@ MusicData::~MusicData(void)
         delete m_all_streams;
         m_all_streams = nullptr;
     }
+
+    delete m_smart_playlists;
+    m_smart_playlists = nullptr;
 }
 
 void MusicData::scanMusic (void)
@@ -126,6 +130,7 @@ void MusicData::loadMusic(void) const
     gMusicData->m_all_music = all_music;
     gMusicData->m_all_streams = new AllStream();
     gMusicData->m_all_playlists = all_playlists;
+    gMusicData->m_smart_playlists = new SmartPLCache();
 
     gMusicData->m_initialized = true;
 
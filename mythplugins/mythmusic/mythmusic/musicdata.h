@@ -16,6 +16,7 @@
 class PlaylistContainer;
 class AllMusic;
 class AllStream;
+class SmartPLCache;
 
 /// send a message to the master BE without blocking the UI thread
 class SendStringListThread : public QRunnable
@@ -51,6 +52,7 @@ class MusicData : public QObject
     PlaylistContainer  *m_all_playlists {nullptr};
     AllMusic           *m_all_music     {nullptr};
     AllStream          *m_all_streams   {nullptr};
+    SmartPLCache       *m_smart_playlists {nullptr};
     bool                m_initialized   {false};
 };
 
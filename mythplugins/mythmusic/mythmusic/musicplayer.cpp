@@ -738,12 +738,9 @@ void MusicPlayer::customEvent(QEvent *event)
                 if (list.size() == 2)
                 {
                     int songID = list[1].toInt();
-                    MusicMetadata *mdata =  gMusicData->m_all_music->getMetadata(songID);
 
-                    if (mdata)
+                    if (gMusicData->m_all_music->refreshTrack(songID))
                     {
-                        mdata->reloadMetadata();
-
                         // tell any listeners the metadata has changed for this track
                         sendMetadataChangedEvent(songID);
                     }
@@ -763,6 +760,24 @@ void MusicPlayer::customEvent(QEvent *event)
                                  tr("This may take a while I'll give a shout when finished"));
             }
         }
+        else if (me->Message().startsWith("MUSIC_SCANNER_PROGRESS"))
+        {
+            QStringList list = me->Message().simplified().split(' ');
+            if (list.size() == 5)
+            {
+                const QString& host = list[1];
+                int id = getNotificationID(host);
+                int done = list[2].toInt();
+                int total = list[3].toInt();
+                const QString& rate = list[4];
+
+                sendNotification(id,
+                                 tr("A music file scan is running on %1").arg(host),
+                                 tr("Music File Scanner"),
+                                 tr("Read %1 of %2 new or changed files, %3 files/sec")
+                                     .arg(done).arg(total).arg(rate));
+            }
+        }
         else if (me->Message().startsWith("MUSIC_SCANNER_FINISHED"))
         {
             QStringList list = me->Message().simplified().split(' ');
@@ -1374,6 +1389,10 @@ void MusicPlayer::sendMetadataChangedEvent(int trackID)
 
 void MusicPlayer::sendTrackStatsChangedEvent(int trackID)
 {
+    // keep the index in step for the views that query it
+    if (gMusicData->m_all_music)
+        gMusicData->m_all_music->updateTrackStats(trackID);
+
     MusicPlayerEvent me(MusicPlayerEvent::kTrackStatsChangedEvent, trackID);
     dispatch(me);
 }
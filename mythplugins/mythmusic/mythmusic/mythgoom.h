@@ -3,23 +3,23 @@
 
 #include "mainvisual.h"
 
-class Goom : public VisualBase
+class Goom : public ThreadedVisual
 {
 public:
     Goom(void);
     ~Goom() override;
 
-    void resize(const QSize &size) override; // VisualBase
-    bool process(VisualNode *node) override; // VisualBase
-    bool draw(QPainter *p, const QColor &back) override; // VisualBase
     void handleKeyPress([[maybe_unused]] const QString &action) override {}; // VisualBase
+    // the gooms go with the analyser's beats
+    bool needsAnalysis(void) override { return true; } // VisualBase
 
-private:
-    QSize m_size;
+protected:
+    bool renderFrame(const VisualRenderer::Samples &samples,
+                     QSize size, QImage &image) override; // ThreadedVisual
 
-    unsigned int *m_buffer {nullptr};
-    int           m_scalew {2};
-    int           m_scaleh {2};
+private:
+    QSize    m_goomSize;
+    uint32_t m_beatCount {0};    // only used by the render thread
 };
 
 #endif //MYTHGOOM
@@ -905,79 +905,33 @@ int Playlist::fillSonglistFromSmartPlaylist(const QString& category, const QStri
     }
 
     // find smartplaylist
-    int ID = 0;
-    QString matchType;
-    QString orderBy;
-    int limitTo = 0;
-
-    query.prepare("SELECT smartplaylistid, matchtype, orderby, limitto "
+    query.prepare("SELECT smartplaylistid "
                   "FROM music_smartplaylists "
                   "WHERE categoryid = :CATEGORYID AND name = :NAME;");
     query.bindValue(":NAME", name);
     query.bindValue(":CATEGORYID", categoryID);
 
-    if (query.exec())
-    {
-        if (query.isActive() && query.size() > 0)
-        {
-            query.first();
-            ID = query.value(0).toInt();
-            matchType = (query.value(1).toString() == "All") ? " AND " : " OR ";
-            orderBy = query.value(2).toString();
-            limitTo = query.value(3).toInt();
-        }
-        else
-        {
-            LOG(VB_GENERAL, LOG_WARNING, LOC +
-                QString("Cannot find smartplaylist: %1").arg(name));
-            return 0;
-        }
-    }
-    else
+    if (!query.exec())
     {
         MythDB::DBError("Find SmartPlaylist", query);
         return 0;
     }
 
-    // get smartplaylist items
-    QString whereClause = "WHERE ";
-
-    query.prepare("SELECT field, operator, value1, value2 "
-                  "FROM music_smartplaylist_items "
-                  "WHERE smartplaylistid = :ID;");
-    query.bindValue(":ID", ID);
-    if (query.exec())
+    if (!query.next())
     {
-        bool bFirst = true;
-        while (query.next())
-        {
-            QString fieldName = query.value(0).toString();
-            QString operatorName = query.value(1).toString();
-            QString value1 = query.value(2).toString();
-            QString value2 = query.value(3).toString();
-            if (!bFirst)
-            {
-                whereClause += matchType + getCriteriaSQL(fieldName,
-                                           operatorName, value1, value2);
-            }
-            else
-            {
-               bFirst = false;
-               whereClause += " " + getCriteriaSQL(fieldName, operatorName,
-                                                   value1, value2);
-            }
-        }
+        LOG(VB_GENERAL, LOG_WARNING, LOC +
+            QString("Cannot find smartplaylist: %1").arg(name));
+        return 0;
     }
+    int ID = query.value(0).toInt();
 
-    // add order by clause
-    whereClause += getOrderBySQL(orderBy);
-
-    // add limit
-    if (limitTo > 0)
-        whereClause +=  " LIMIT " + QString::number(limitTo);
+    // the tracks come from the track index, kept up to date by the cache
+    QList<int> songList;
+    for (auto id : gMusicData->m_smart_playlists->getTracks(ID))
+        songList.append(static_cast<int>(id));
 
-    return fillSonglistFromQuery(whereClause, removeDuplicates,
-                                 insertOption, currentTrackID);
+    return fillSonglistFromList(songList, removeDuplicates,
+                                insertOption, currentTrackID);
 }
 
 void Playlist::changed(void)
@@ -622,13 +622,12 @@ void PlaylistEditorView::updateSonglist(MusicGenericTree *node)
     }
     else
     {
-        // fall back to getting the tracks from the MetadataPtrList
-        auto *tracks = node->GetData().value<MetadataPtrList*>();
-        for (int x = 0; x < tracks->count(); x++)
+        // fall back to getting the tracks from the MusicTrackIdList
+        auto *tracks = node->GetData().value<MusicTrackIdList*>();
+        if (tracks)
         {
-            MusicMetadata *mdata = tracks->at(x);
-            if (mdata)
-                m_songList.append((int)mdata->ID());
+            for (MusicMetadata::IdType id : std::as_const(*tracks))
+                m_songList.append(static_cast<int>(id));
         }
     }
 }
@@ -770,62 +769,61 @@ void PlaylistEditorView::createRootNode(void )
     if (!m_rootNode)
         m_rootNode = new MusicGenericTree(nullptr, "Root Music Node");
 
+    // every node below shares the one list of all the tracks
+    MusicTrackIndex *index = gMusicData->m_all_music->getIndex();
+    auto *allTracks = new MusicTrackIdList(index->ids());
+    m_deleteList.append(allTracks);
+
     auto *node = new MusicGenericTree(m_rootNode, tr("All Tracks"), "all tracks");
     node->setDrawArrow(true);
-    node->SetData(QVariant::fromValue(gMusicData->m_all_music->getAllMetadata()));
+    node->SetData(QVariant::fromValue(allTracks));
 
     node = new MusicGenericTree(m_rootNode, tr("Albums"), "albums");
     node->setDrawArrow(true);
-    node->SetData(QVariant::fromValue(gMusicData->m_all_music->getAllMetadata()));
+    node->SetData(QVariant::fromValue(allTracks));
 
     node = new MusicGenericTree(m_rootNode, tr("Artists"), "artists");
     node->setDrawArrow(true);
-    node->SetData(QVariant::fromValue(gMusicData->m_all_music->getAllMetadata()));
+    node->SetData(QVariant::fromValue(allTracks));
 
     node = new MusicGenericTree(m_rootNode, tr("Genres"), "genres");
     node->setDrawArrow(true);
-    node->SetData(QVariant::fromValue(gMusicData->m_all_music->getAllMetadata()));
+    node->SetData(QVariant::fromValue(allTracks));
 #if 0
     node = new MusicGenericTree(m_rootNode, tr("Tags"), "tags");
     node->setDrawArrow(true);
-    node->SetData(QVariant::fromValue(gMusicData->all_music->getAllMetadata()));
+    node->SetData(QVariant::fromValue(allTracks));
 #endif
     node = new MusicGenericTree(m_rootNode, tr("Ratings"), "ratings");
     node->setDrawArrow(true);
-    node->SetData(QVariant::fromValue(gMusicData->m_all_music->getAllMetadata()));
+    node->SetData(QVariant::fromValue(allTracks));
 
     node = new MusicGenericTree(m_rootNode, tr("Years"), "years");
     node->setDrawArrow(true);
-    node->SetData(QVariant::fromValue(gMusicData->m_all_music->getAllMetadata()));
+    node->SetData(QVariant::fromValue(allTracks));
 
     node = new MusicGenericTree(m_rootNode, tr("Compilations"), "compilations");
     node->setDrawArrow(true);
 
-    MetadataPtrList *alltracks = gMusicData->m_all_music->getAllMetadata();
-    auto *compTracks = new MetadataPtrList;
+    auto *compTracks = new MusicTrackIdList(index->filter(*allTracks, MusicTrackIndex::kCompilation, 1));
     m_deleteList.append(compTracks);
-
-    for (int x = 0; x < alltracks->count(); x++)
-    {
-        MusicMetadata *mdata = alltracks->at(x);
-        if (mdata)
-        {
-            if (mdata->Compilation())
-                compTracks->append(mdata);
-        }
-    }
     node->SetData(QVariant::fromValue(compTracks));
 
     if (gMusicData->m_all_music->getCDTrackCount())
     {
+        auto *cdTracks = new MusicTrackIdList;
+        m_deleteList.append(cdTracks);
+        for (const auto *mdata : std::as_const(*gMusicData->m_all_music->getAllCDMetadata()))
+            cdTracks->append(mdata->ID());
+
         node = new MusicGenericTree(m_rootNode, tr("CD - %1").arg(gMusicData->m_all_music->getCDTitle()), "cd");
         node->setDrawArrow(true);
-        node->SetData(QVariant::fromValue(gMusicData->m_all_music->getAllCDMetadata()));
+        node->SetData(QVariant::fromValue(cdTracks));
     }
 
     node = new MusicGenericTree(m_rootNode, tr("Directory"), "directory");
     node->setDrawArrow(true);
-    node->SetData(QVariant::fromValue(gMusicData->m_all_music->getAllMetadata()));
+    node->SetData(QVariant::fromValue(allTracks));
 
     node = new MusicGenericTree(m_rootNode, tr("Playlists"), "playlists");
     node->setDrawArrow(true);
@@ -895,10 +893,10 @@ void PlaylistEditorView::treeItemVisible(MythUIButtonListItem *item)
         else if (mnode->getAction() == "album")
         {
             // hunt for a coverart image for the album
-            auto *tracks = node->GetData().value<MetadataPtrList*>();
-            for (int x = 0; x < tracks->count(); x++)
+            auto *tracks = node->GetData().value<MusicTrackIdList*>();
+            for (MusicMetadata::IdType id : std::as_const(*tracks))
             {
-                MusicMetadata *mdata = tracks->at(x);
+                MusicMetadata *mdata = gMusicData->m_all_music->getMetadata(id);
                 if (mdata)
                 {
                     artFile = mdata->getAlbumArtFile();
@@ -1013,13 +1011,29 @@ void PlaylistEditorView::treeNodeChanged(MythGenericTree *node)
     }
 }
 
+/// add a child node to node for each group of tracks
+void PlaylistEditorView::addGroupNodes(MusicGenericTree *node,
+                                       const QMap<QString, MusicTrackIdList> &groups,
+                                       const QString &action)
+{
+    for (auto i = groups.constBegin(); i != groups.constEnd(); ++i)
+    {
+        auto *filteredTracks = new MusicTrackIdList(i.value());
+        m_deleteList.append(filteredTracks);
+        auto *newnode = new MusicGenericTree(node, i.key(), action);
+        newnode->SetData(QVariant::fromValue(filteredTracks));
+    }
+}
+
 void PlaylistEditorView::filterTracks(MusicGenericTree *node)
 {
-    auto *tracks = node->GetData().value<MetadataPtrList*>();
+    auto *tracks = node->GetData().value<MusicTrackIdList*>();
 
     if (!tracks)
         return;
 
+    MusicTrackIndex *index = gMusicData->m_all_music->getIndex();
+
     if (node->getAction() == "all tracks")
     {
         QMultiMap<QString, int> map;
@@ -1029,30 +1043,31 @@ void PlaylistEditorView::filterTracks(MusicGenericTree *node)
         if (parentNode)
             isAlbum = parentNode->getAction() == "album";
 
-        for (int x = 0; x < tracks->count(); x++)
+        for (MusicMetadata::IdType id : std::as_const(*tracks))
         {
-            MusicMetadata *mdata = tracks->at(x);
-            if (mdata)
+            if (!index->contains(id))
+                continue;
+
+            QString key = index->text(id, MusicTrackIndex::kTitle);
+            qint64 track = index->value(id, MusicTrackIndex::kTrack);
+
+            // Add the track number if an album is selected
+            if (isAlbum && track > 0)
             {
-                QString key = mdata->Title();
+                key.prepend(QString::number(track) + " - ");
+                if (track < 10)
+                    key.prepend("0");
 
-                // Add the track number if an album is selected
-                if (isAlbum && mdata->Track() > 0)
+                // Add the disc number if this is a multi-disc album
+                qint64 disc = index->value(id, MusicTrackIndex::kDiscNumber);
+                if (disc > 0)
                 {
-                    key.prepend(QString::number(mdata->Track()) + " - ");
-                    if (mdata->Track() < 10)
+                    key.prepend(QString::number(disc) + "/");
+                    if (disc < 10)
                         key.prepend("0");
-
-                    // Add the disc number if this is a multi-disc album
-                    if (mdata->DiscNumber() > 0)
-                    {
-                        key.prepend(QString::number(mdata->DiscNumber()) + "/");
-                        if (mdata->DiscNumber() < 10)
-                            key.prepend("0");
-                    }
                 }
-                map.insert(key, mdata->ID());
             }
+            map.insert(key, id);
         }
 
         auto i = map.constBegin();
@@ -1070,213 +1085,65 @@ void PlaylistEditorView::filterTracks(MusicGenericTree *node)
     }
     else if (node->getAction() == "artists")
     {
-        QMap<QString, MetadataPtrList*> map;
-
-        for (int x = 0; x < tracks->count(); x++)
-        {
-            MusicMetadata *mdata = tracks->at(x);
-            if (mdata)
-            {
-                if (map.contains(mdata->Artist()))
-                {
-                    MetadataPtrList *filteredTracks = map.value(mdata->Artist());
-                    filteredTracks->append(mdata);
-                }
-                else
-                {
-                    auto *filteredTracks = new MetadataPtrList;
-                    m_deleteList.append(filteredTracks);
-                    filteredTracks->append(mdata);
-                    map.insert(mdata->Artist(), filteredTracks);
-                }
-            }
-        }
-
-        QMap<QString, MetadataPtrList*>::const_iterator i = map.constBegin();
-        while (i != map.constEnd())
-        {
-            auto *newnode = new MusicGenericTree(node, i.key(), "artist");
-            newnode->SetData(QVariant::fromValue(i.value()));
-            ++i;
-        }
+        addGroupNodes(node, index->group(*tracks, MusicTrackIndex::kArtist), "artist");
 
         node->sortByString(); // Case-insensitive sort
     }
     else if (node->getAction() == "compartists")
     {
-        QMap<QString, MetadataPtrList*> map;
-
-        for (int x = 0; x < tracks->count(); x++)
+        MusicTrackIdList compTracks;
+        for (MusicMetadata::IdType id : std::as_const(*tracks))
         {
-            MusicMetadata *mdata = tracks->at(x);
-            if (mdata)
-            {
-                if (mdata->CompilationArtist() != mdata->Artist())
-                {
-                    if (map.contains(mdata->CompilationArtist()))
-                    {
-                        MetadataPtrList *filteredTracks = map.value(mdata->CompilationArtist());
-                        filteredTracks->append(mdata);
-                    }
-                    else
-                    {
-                        auto *filteredTracks = new MetadataPtrList;
-                        m_deleteList.append(filteredTracks);
-                        filteredTracks->append(mdata);
-                        map.insert(mdata->CompilationArtist(), filteredTracks);
-                    }
-                }
-            }
+            if (index->text(id, MusicTrackIndex::kCompilationArtist) !=
+                index->text(id, MusicTrackIndex::kArtist))
+                compTracks.append(id);
         }
 
-        QMap<QString, MetadataPtrList*>::const_iterator i = map.constBegin();
-        while (i != map.constEnd())
-        {
-            auto *newnode = new MusicGenericTree(node, i.key(), "compartist");
-            newnode->SetData(QVariant::fromValue(i.value()));
-            ++i;
-        }
+        addGroupNodes(node, index->group(compTracks, MusicTrackIndex::kCompilationArtist), "compartist");
 
         node->sortByString(); // Case-insensitive sort
     }
     else if (node->getAction() == "albums")
     {
-        QMap<QString, MetadataPtrList*> map;
-
-        for (int x = 0; x < tracks->count(); x++)
-        {
-            MusicMetadata *mdata = tracks->at(x);
-            if (mdata)
-            {
-                if (map.contains(mdata->Album()))
-                {
-                    MetadataPtrList *filteredTracks = map.value(mdata->Album());
-                    filteredTracks->append(mdata);
-                }
-                else
-                {
-                    auto *filteredTracks = new MetadataPtrList;
-                    m_deleteList.append(filteredTracks);
-                    filteredTracks->append(mdata);
-                    map.insert(mdata->Album(), filteredTracks);
-                }
-            }
-        }
-
-        QMap<QString, MetadataPtrList*>::const_iterator i = map.constBegin();
-        while (i != map.constEnd())
-        {
-            auto *newnode = new MusicGenericTree(node, i.key(), "album");
-            newnode->SetData(QVariant::fromValue(i.value()));
-            ++i;
-        }
+        addGroupNodes(node, index->group(*tracks, MusicTrackIndex::kAlbum), "album");
 
         node->sortByString(); // Case-insensitive sort
     }
     else if (node->getAction() == "genres")
     {
-        QMap<QString, MetadataPtrList*> map;
+        addGroupNodes(node, index->group(*tracks, MusicTrackIndex::kGenre), "genre");
 
-        for (int x = 0; x < tracks->count(); x++)
-        {
-            MusicMetadata *mdata = tracks->at(x);
-            if (mdata)
-            {
-                if (map.contains(mdata->Genre()))
-                {
-                    MetadataPtrList *filteredTracks = map.value(mdata->Genre());
-                    filteredTracks->append(mdata);
-                }
-                else
-                {
-                    auto *filteredTracks = new MetadataPtrList;
-                    m_deleteList.append(filteredTracks);
-                    filteredTracks->append(mdata);
-                    map.insert(mdata->Genre(), filteredTracks);
-                }
-            }
-        }
-
-        QMap<QString, MetadataPtrList*>::const_iterator i = map.constBegin();
-        while (i != map.constEnd())
-        {
-            auto *newnode = new MusicGenericTree(node, i.key(), "genre");
-            newnode->SetSortText(i.key()); // No manipulation of prefixes on genres
-            newnode->SetData(QVariant::fromValue(i.value()));
-            ++i;
-        }
+        // No manipulation of prefixes on genres
+        for (int x = 0; x < node->childCount(); x++)
+            node->getChildAt(x)->SetSortText(node->getChildAt(x)->GetText());
 
         node->sortByString(); // Case-insensitive sort
     }
     else if (node->getAction() == "ratings")
     {
-        QMap<QString, MetadataPtrList*> map;
-
-        for (int x = 0; x < tracks->count(); x++)
-        {
-            MusicMetadata *mdata = tracks->at(x);
-            if (mdata)
-            {
-                QString ratingStr = tr("%n Star(s)", "", mdata->Rating());
-                if (map.contains(ratingStr))
-                {
-                    MetadataPtrList *filteredTracks = map.value(ratingStr);
-                    filteredTracks->append(mdata);
-                }
-                else
-                {
-                    auto *filteredTracks = new MetadataPtrList;
-                    m_deleteList.append(filteredTracks);
-                    filteredTracks->append(mdata);
-                    map.insert(ratingStr, filteredTracks);
-                }
-            }
-        }
-
-        QMap<QString, MetadataPtrList*>::const_iterator i = map.constBegin();
-        while (i != map.constEnd())
+        auto groups = index->groupValues(*tracks, MusicTrackIndex::kRating);
+        for (auto i = groups.constBegin(); i != groups.constEnd(); ++i)
         {
-            auto *newnode = new MusicGenericTree(node, i.key(), "rating");
-            newnode->SetData(QVariant::fromValue(i.value()));
-            ++i;
+            auto *filteredTracks = new MusicTrackIdList(i.value());
+            m_deleteList.append(filteredTracks);
+            auto *newnode = new MusicGenericTree(node, tr("%n Star(s)", "", i.key()), "rating");
+            newnode->SetData(QVariant::fromValue(filteredTracks));
         }
     }
     else if (node->getAction() == "years")
     {
-        QMap<QString, MetadataPtrList*> map;
-
-        for (int x = 0; x < tracks->count(); x++)
-        {
-            MusicMetadata *mdata = tracks->at(x);
-            if (mdata)
-            {
-                QString yearStr = QString("%1").arg(mdata->Year());
-                if (map.contains(yearStr))
-                {
-                    MetadataPtrList *filteredTracks = map.value(yearStr);
-                    filteredTracks->append(mdata);
-                }
-                else
-                {
-                    auto *filteredTracks = new MetadataPtrList;
-                    m_deleteList.append(filteredTracks);
-                    filteredTracks->append(mdata);
-                    map.insert(yearStr, filteredTracks);
-                }
-            }
-        }
-
-        QMap<QString, MetadataPtrList*>::const_iterator i = map.constBegin();
-        while (i != map.constEnd())
+        auto groups = index->groupValues(*tracks, MusicTrackIndex::kYear);
+        for (auto i = groups.constBegin(); i != groups.constEnd(); ++i)
         {
-            auto *newnode = new MusicGenericTree(node, i.key(), "year");
-            newnode->SetData(QVariant::fromValue(i.value()));
-            ++i;
+            auto *filteredTracks = new MusicTrackIdList(i.value());
+            m_deleteList.append(filteredTracks);
+            auto *newnode = new MusicGenericTree(node, QString::number(i.key()), "year");
+            newnode->SetData(QVariant::fromValue(filteredTracks));
         }
     }
     else if (node->getAction() == "directory")
     {
-        QMap<QString, MetadataPtrList*> map;
+        QMap<QString, MusicTrackIdList*> map;
 
         // which directories have we already filtered by
         QString dir;
@@ -1292,36 +1159,35 @@ void PlaylistEditorView::filterTracks(MusicGenericTree *node)
         if (dir.startsWith(top2))
             dir = dir.mid(top2.length());
 
-        for (int x = 0; x < tracks->count(); x++)
+        for (MusicMetadata::IdType id : std::as_const(*tracks))
         {
-            MusicMetadata *mdata = tracks->at(x);
-            if (mdata)
-            {
-                QString filename = mdata->Filename(false);
+            if (!index->contains(id))
+                continue;
 
-                if (filename.startsWith(dir))
-                    filename = filename.mid(dir.length());
+            QString filename = index->text(id, MusicTrackIndex::kFilename);
 
-                QStringList dirs = filename.split("/");
+            if (filename.startsWith(dir))
+                filename = filename.mid(dir.length());
 
-                QString key = dirs.count() > 1 ? dirs[0] : "[TRACK]" + dirs[0];
-                if (map.contains(key))
-                {
-                    MetadataPtrList *filteredTracks = map.value(key);
-                    filteredTracks->append(mdata);
-                }
-                else
-                {
-                    auto *filteredTracks = new MetadataPtrList;
-                    m_deleteList.append(filteredTracks);
-                    filteredTracks->append(mdata);
-                    map.insert(key, filteredTracks);
-                }
+            QStringList dirs = filename.split("/");
+
+            QString key = dirs.count() > 1 ? dirs[0] : "[TRACK]" + dirs[0];
+            if (map.contains(key))
+            {
+                MusicTrackIdList *filteredTracks = map.value(key);
+                filteredTracks->append(id);
+            }
+            else
+            {
+                auto *filteredTracks = new MusicTrackIdList;
+                m_deleteList.append(filteredTracks);
+                filteredTracks->append(id);
+                map.insert(key, filteredTracks);
             }
         }
 
         // add directories first
-        QMap<QString, MetadataPtrList*>::const_iterator i = map.constBegin();
+        QMap<QString, MusicTrackIdList*>::const_iterator i = map.constBegin();
         while (i != map.constEnd())
         {
             if (!i.key().startsWith("[TRACK]"))
@@ -1339,7 +1205,7 @@ void PlaylistEditorView::filterTracks(MusicGenericTree *node)
             if (i.key().startsWith("[TRACK]"))
             {
                 auto *newnode = new MusicGenericTree(node, i.key().mid(7), "trackid");
-                newnode->setInt(i.value()->at(0)->ID());
+                newnode->setInt(i.value()->at(0));
                 newnode->setDrawArrow(false);
                 bool hasTrack = gPlayer->getCurrentPlaylist() ? gPlayer->getCurrentPlaylist()->checkTrack(newnode->getInt()) : false;
                 newnode->setCheck( hasTrack ? MythUIButtonListItem::FullChecked : MythUIButtonListItem::NotChecked);
@@ -1397,17 +1263,13 @@ void PlaylistEditorView::filterTracks(MusicGenericTree *node)
 
             // only show the Comp. Artist if it differs from the Artist
             bool found = false;
-            auto *tracks2 = node->GetData().value<MetadataPtrList*>();
-            for (int x = 0; x < tracks2->count(); x++)
+            for (MusicMetadata::IdType id : std::as_const(*tracks))
             {
-                MusicMetadata *mdata = tracks2->at(x);
-                if (mdata)
+                if (index->text(id, MusicTrackIndex::kArtist) !=
+                    index->text(id, MusicTrackIndex::kCompilationArtist))
                 {
-                    if (mdata->Artist() != mdata->CompilationArtist())
-                    {
-                        found = true;
-                        break;
-                    }
+                    found = true;
+                    break;
                 }
             }
 
@@ -1505,106 +1367,15 @@ void PlaylistEditorView::getSmartPlaylists(MusicGenericTree *node)
 
 void PlaylistEditorView::getSmartPlaylistTracks(MusicGenericTree *node, int playlistID)
 {
-    MSqlQuery query(MSqlQuery::InitCon());
-
-    // find smartplaylist
-    QString matchType;
-    QString orderBy;
-    int limitTo = 0;
-
-    query.prepare("SELECT smartplaylistid, matchtype, orderby, limitto "
-                  "FROM music_smartplaylists "
-                  "WHERE smartplaylistid = :SMARTPLAYLISTID;");
-    query.bindValue(":SMARTPLAYLISTID", playlistID);
-
-    if (query.exec())
-    {
-        if (query.isActive() && query.size() > 0)
-        {
-            query.first();
-            matchType = (query.value(1).toString() == "All") ? " AND " : " OR ";
-            orderBy = query.value(2).toString();
-            limitTo = query.value(3).toInt();
-        }
-        else
-        {
-            LOG(VB_GENERAL, LOG_WARNING,
-                LOC + QString("Cannot find smartplaylist: %1").arg(playlistID));
-            return;
-        }
-    }
-    else
-    {
-        MythDB::DBError("Find SmartPlaylist", query);
-        return;
-    }
-
-    // get smartplaylist items
-    QString whereClause = "WHERE ";
-
-    query.prepare("SELECT field, operator, value1, value2 "
-                  "FROM music_smartplaylist_items "
-                  "WHERE smartplaylistid = :ID;");
-    query.bindValue(":ID", playlistID);
-    if (query.exec())
-    {
-        bool bFirst = true;
-        while (query.next())
-        {
-            QString fieldName = query.value(0).toString();
-            QString operatorName = query.value(1).toString();
-            QString value1 = query.value(2).toString();
-            QString value2 = query.value(3).toString();
-            if (!bFirst)
-            {
-                whereClause += matchType + getCriteriaSQL(fieldName,
-                                           operatorName, value1, value2);
-            }
-            else
-            {
-               bFirst = false;
-               whereClause += " " + getCriteriaSQL(fieldName, operatorName,
-                                                   value1, value2);
-            }
-        }
-    }
-
-    // add order by clause
-    whereClause += getOrderBySQL(orderBy);
-
-    // add limit
-    if (limitTo > 0)
-        whereClause +=  " LIMIT " + QString::number(limitTo);
-
-
     // find the tracks for this smartplaylist
-    QString theQuery;
-
-    theQuery = "SELECT song_id, name FROM music_songs "
-               "LEFT JOIN music_directories ON"
-               " music_songs.directory_id=music_directories.directory_id "
-               "LEFT JOIN music_artists ON"
-               " music_songs.artist_id=music_artists.artist_id "
-               "LEFT JOIN music_albums ON"
-               " music_songs.album_id=music_albums.album_id "
-               "LEFT JOIN music_genres ON"
-               " music_songs.genre_id=music_genres.genre_id "
-               "LEFT JOIN music_artists AS music_comp_artists ON "
-               "music_albums.artist_id=music_comp_artists.artist_id ";
-    if (whereClause.length() > 0)
-      theQuery += whereClause;
-
-    if (!query.exec(theQuery))
-    {
-        MythDB::DBError("Load songlist from query", query);
-        return;
-    }
+    MusicTrackIndex *index = gMusicData->m_all_music->getIndex();
+    const QList<MusicMetadata::IdType> tracks = gMusicData->m_smart_playlists->getTracks(playlistID);
 
-    while (query.next())
+    for (auto id : tracks)
     {
         auto *newnode =
-                new MusicGenericTree(node, query.value(1).toString(), "trackid");
-        newnode->setInt(query.value(0).toInt());
+                new MusicGenericTree(node, index->text(id, MusicTrackIndex::kTitle), "trackid");
+        newnode->setInt(static_cast<int>(id));
         newnode->setDrawArrow(false);
         bool hasTrack = gPlayer->getCurrentPlaylist() ? gPlayer->getCurrentPlaylist()->checkTrack(newnode->getInt()) : false;
         newnode->setCheck( hasTrack ? MythUIButtonListItem::FullChecked : MythUIButtonListItem::NotChecked);
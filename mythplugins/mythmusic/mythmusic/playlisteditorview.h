@@ -90,6 +90,8 @@ class PlaylistEditorView : public MusicCommon
 
   private:
     void filterTracks(MusicGenericTree *node);
+    void addGroupNodes(MusicGenericTree *node, const QMap<QString, MusicTrackIdList> &groups,
+                       const QString &action);
 
     static void getPlaylists(MusicGenericTree *node);
     static void getPlaylistTracks(MusicGenericTree *node, int playlistID);
@@ -115,7 +117,7 @@ class PlaylistEditorView : public MusicCommon
     QString                 m_layout;
     bool                    m_restorePosition {false};
     MusicGenericTree       *m_rootNode        {nullptr};
-    QList<MetadataPtrList*> m_deleteList;
+    QList<MusicTrackIdList*> m_deleteList;
 
     MythUIButtonTree *m_playlistTree          {nullptr};
     MythUIText       *m_breadcrumbsText       {nullptr};
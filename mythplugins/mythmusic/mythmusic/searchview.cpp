@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <cstdlib>
 
@@ -5,7 +6,6 @@
 #include <QKeyEvent>
 
 // MythTV
-#include <libmythbase/mythdb.h>
 #include <libmythbase/mythlogging.h>
 #include <libmythui/mythdialogbox.h>
 #include <libmythui/mythuibuttonlist.h>
@@ -17,10 +17,35 @@
 #include "musicdata.h"
 #include "searchview.h"
 
+static void BindTrack(MusicMetadata *const &mdata, MythUIButtonListItem *item)
+{
+    item->SetData(QVariant::fromValue(mdata));
+    InfoMap metadataMap;
+    mdata->toMap(metadataMap);
+    item->SetTextFromMap(metadataMap);
+
+    if (gPlayer->getCurrentPlaylist() && gPlayer->getCurrentPlaylist()->checkTrack(mdata->ID()))
+        item->DisplayState("on", "selectedstate");
+    else
+        item->DisplayState("off", "selectedstate");
+
+    // TODO rating state etc
+}
+
 SearchView::SearchView(MythScreenStack *parent, MythScreenType *parentScreen)
-         :MusicCommon(parent, parentScreen,"searchview")
+         :MusicCommon(parent, parentScreen,"searchview"),
+          m_tracksModel(BindTrack)
 {
     m_currentView = MV_SEARCH;
+    m_tracksModel.SetDataKey([](MusicMetadata *const &mdata)
+                             { return QVariant::fromValue(mdata); });
+}
+
+SearchView::~SearchView(void)
+{
+    // the list must stop using the model before it goes
+    if (m_tracksList)
+        m_tracksList->Reset();
 }
 
 bool SearchView::Create(void)
@@ -91,20 +116,8 @@ void SearchView::customEvent(QEvent *event)
         if (!mpe)
             return;
 
-        int trackID = mpe->m_trackID;
-
-        for (int x = 0; x < m_tracksList->GetCount(); x++)
-        {
-            MythUIButtonListItem *item = m_tracksList->GetItemAt(x);
-            auto *mdata = item->GetData().value<MusicMetadata*>();
-            if (mdata && (mdata->ID() == (MusicMetadata::IdType) trackID || trackID == -1))
-            {
-                if (gPlayer->getCurrentPlaylist() && gPlayer->getCurrentPlaylist()->checkTrack(mdata->ID()))
-                    item->DisplayState("on", "selectedstate");
-                else
-                    item->DisplayState("off", "selectedstate");
-            }
-        }
+        // rebind the tracks on show to update their selected state
+        m_tracksList->ModelChanged();
 
         // call the default handler in MusicCommon so the playlist and UI is updated
         MusicCommon::customEvent(event);
@@ -123,12 +136,7 @@ void SearchView::customEvent(QEvent *event)
     }
     else if (event->type() == MusicPlayerEvent::kAllTracksRemovedEvent)
     {
-        for (int x = 0; x < m_tracksList->GetCount(); x++)
-        {
-            MythUIButtonListItem *item = m_tracksList->GetItemAt(x);
-            if (item)
-                item->DisplayState("off", "selectedstate");
-        }
+        m_tracksList->ModelChanged();
     }
     else if (event->type() == MusicPlayerEvent::kMetadataChangedEvent)
     {
@@ -139,17 +147,11 @@ void SearchView::customEvent(QEvent *event)
 
         uint trackID = mpe->m_trackID;
 
-        for (int x = 0; x < m_tracksList->GetCount(); x++)
-        {
-            MythUIButtonListItem *item = m_tracksList->GetItemAt(x);
-            auto *mdata = item->GetData().value<MusicMetadata*>();
-            if (mdata && mdata->ID() == trackID)
-            {
-                InfoMap metadataMap;
-                mdata->toMap(metadataMap);
-                item->SetTextFromMap(metadataMap);
-            }
-        }
+        // only rebind if the changed track is one of the matches
+        if (std::ranges::any_of(m_tracksModel.GetRecords(),
+                                [trackID](const MusicMetadata *mdata)
+                                { return mdata->ID() == trackID; }))
+            m_tracksList->ModelChanged();
 
 //        if (trackID == gPlayer->getCurrentMetadata()->ID())
 //            updateTrackInfo(gPlayer->getCurrentMetadata());
@@ -349,110 +351,45 @@ void SearchView::updateTracksList(void)
     QString searchStr = m_criteriaEdit->GetText();
     int field = item->GetData().toInt();
 
-    QString sql;
-    MSqlQuery query(MSqlQuery::InitCon());
-
-    if (searchStr.isEmpty())
-    {
-        sql = "SELECT song_id "
-              "FROM music_songs ";
-
-        query.prepare(sql);
-    }
-    else
+    QList<MusicTrackIndex::Field> fields;
+    switch(field)
     {
-        switch(field)
-        {
-            case 1: // artist
-            {
-                sql = "SELECT song_id "
-                      "FROM music_songs "
-                      "LEFT JOIN music_artists ON "
-                      "    music_songs.artist_id=music_artists.artist_id "
-                      "WHERE music_artists.artist_name LIKE '%" + searchStr + "%' ";
-                query.prepare(sql);
-                break;
-            }
-            case 2: // album
-            {
-                sql = "SELECT song_id "
-                      "FROM music_songs "
-                      "LEFT JOIN music_albums ON music_songs.album_id=music_albums.album_id "
-                      "WHERE music_albums.album_name LIKE '%" + searchStr + "%' ";
-                query.prepare(sql);
-                break;
-            }
-            case 3: // title
-            {
-                sql = "SELECT song_id "
-                      "FROM music_songs "
-                      "WHERE music_songs.name LIKE '%" + searchStr + "%' ";
-                query.prepare(sql);
-                break;
-            }
-            case 4: // genre
-            {
-                sql = "SELECT song_id "
-                      "FROM music_songs "
-                      "LEFT JOIN music_genres ON music_songs.genre_id=music_genres.genre_id "
-                      "WHERE music_genres.genre LIKE '%" + searchStr + "%' ";
-                query.prepare(sql);
-                break;
-            }
-            case 5: // tags
-            {
-                //TODO add tag query.  Remove fallthrough once added.
-                [[fallthrough]];
-            }
-            case 0: // all fields
-            default:
-            {
-                sql = "SELECT song_id "
-                      "FROM music_songs "
-                      "LEFT JOIN music_artists ON "
-                      "    music_songs.artist_id=music_artists.artist_id "
-                      "LEFT JOIN music_albums ON music_songs.album_id=music_albums.album_id "
-                      "LEFT JOIN music_artists AS music_comp_artists ON "
-                      "    music_albums.artist_id=music_comp_artists.artist_id "
-                      "LEFT JOIN music_genres ON music_songs.genre_id=music_genres.genre_id "
-                      "WHERE music_songs.name LIKE '%" + searchStr + "%' "
-                      "OR music_artists.artist_name LIKE '%" + searchStr + "%' "
-                      "OR music_albums.album_name LIKE '%" + searchStr + "%' "
-                      "OR music_genres.genre LIKE '%" + searchStr + "%' ";
-
-                query.prepare(sql);
-            }
-        }
+        case 1: // artist
+            fields = { MusicTrackIndex::kArtist };
+            break;
+        case 2: // album
+            fields = { MusicTrackIndex::kAlbum };
+            break;
+        case 3: // title
+            fields = { MusicTrackIndex::kTitle };
+            break;
+        case 4: // genre
+            fields = { MusicTrackIndex::kGenre };
+            break;
+        case 5: // tags
+            //TODO add tag query.  Remove fallthrough once added.
+            [[fallthrough]];
+        case 0: // all fields
+        default:
+            fields = { MusicTrackIndex::kTitle, MusicTrackIndex::kArtist,
+                       MusicTrackIndex::kAlbum, MusicTrackIndex::kGenre };
     }
 
-    if (!query.exec() || !query.isActive())
-    {
-        MythDB::DBError("Search music database", query);
-        return;
-    }
+    const MusicTrackIdList tracks =
+        gMusicData->m_all_music->getIndex()->search(searchStr, fields);
 
-    while (query.next())
+    std::vector<MusicMetadata*> matches;
+    matches.reserve(tracks.size());
+    for (MusicMetadata::IdType trackid : tracks)
     {
-        int trackid = query.value(0).toInt();
-
         MusicMetadata *mdata = gMusicData->m_all_music->getMetadata(trackid);
         if (mdata)
-        {
-            auto *newitem = new MythUIButtonListItem(m_tracksList, "");
-            newitem->SetData(QVariant::fromValue(mdata));
-            InfoMap metadataMap;
-            mdata->toMap(metadataMap);
-            newitem->SetTextFromMap(metadataMap);
-
-            if (gPlayer->getCurrentPlaylist() && gPlayer->getCurrentPlaylist()->checkTrack(mdata->ID()))
-                newitem->DisplayState("on", "selectedstate");
-            else
-                newitem->DisplayState("off", "selectedstate");
-
-            // TODO rating state etc
-        }
+            matches.push_back(mdata);
     }
 
+    m_tracksModel.SetRecords(std::move(matches));
+    m_tracksList->SetModel(&m_tracksModel);
+
     trackVisible(m_tracksList->GetItemCurrent());
 
     if (m_matchesText)
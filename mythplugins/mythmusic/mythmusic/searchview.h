@@ -7,6 +7,7 @@
 
 // MythTV
 #include <libmythui/mythscreentype.h>
+#include <libmythui/mythuibuttonlistmodel.h>
 
 // mythmusic
 #include "musiccommon.h"
@@ -20,7 +21,7 @@ class SearchView : public MusicCommon
     Q_OBJECT
   public:
     SearchView(MythScreenStack *parent, MythScreenType *parentScreen);
-    ~SearchView(void) override = default;
+    ~SearchView(void) override;
 
     bool Create(void) override; // MythScreenType
     bool keyPressEvent(QKeyEvent *event) override; // MusicCommon
@@ -44,6 +45,10 @@ class SearchView : public MusicCommon
     MythUITextEdit      *m_criteriaEdit {nullptr};
     MythUIText          *m_matchesText  {nullptr};
     MythUIButtonList    *m_tracksList   {nullptr};
+
+    // The matches can be the whole music library, so only the visible
+    // tracks get a button
+    MythUIButtonListRecordModel<MusicMetadata*> m_tracksModel;
 };
 
 #endif
@@ -1,4 +1,5 @@
 // c/c++
+#include <algorithm>
 #include <iostream>
 #include <unistd.h>
 #include <utility>
@@ -31,61 +32,73 @@
 
 struct SmartPLField
 {
-    QString          m_name;
-    QString          m_sqlName;
-    SmartPLFieldType m_type         { ftString };
-    int              m_minValue     { 0 };
-    int              m_maxValue     { 0 };
-    int              m_defaultValue { 0 };
+    QString                 m_name;
+    QString                 m_sqlName;
+    MusicTrackIndex::Field  m_indexField   { MusicTrackIndex::kArtist };
+    SmartPLFieldType        m_type         { ftString };
+    int                     m_minValue     { 0 };
+    int                     m_maxValue     { 0 };
+    int                     m_defaultValue { 0 };
 };
 
 static const std::array<const SmartPLField,13> SmartPLFields
 {{
     { .m_name="",              .m_sqlName=""                          },
-    { .m_name="Artist",        .m_sqlName="music_artists.artist_name" },
-    { .m_name="Album",         .m_sqlName="music_albums.album_name"   },
-    { .m_name="Title",         .m_sqlName="music_songs.name"          },
-    { .m_name="Genre",         .m_sqlName="music_genres.genre"        },
+    { .m_name="Artist",        .m_sqlName="music_artists.artist_name",
+      .m_indexField=MusicTrackIndex::kArtist },
+    { .m_name="Album",         .m_sqlName="music_albums.album_name",
+      .m_indexField=MusicTrackIndex::kAlbum },
+    { .m_name="Title",         .m_sqlName="music_songs.name",
+      .m_indexField=MusicTrackIndex::kTitle },
+    { .m_name="Genre",         .m_sqlName="music_genres.genre",
+      .m_indexField=MusicTrackIndex::kGenre },
     { .m_name="Year",          .m_sqlName="music_songs.year",
-      .m_type=ftNumeric,
+      .m_indexField=MusicTrackIndex::kYear,        .m_type=ftNumeric,
       .m_minValue=1900, .m_maxValue=2099, .m_defaultValue=2000 },
     { .m_name="Track No.",     .m_sqlName="music_songs.track",
-      .m_type=ftNumeric,       .m_maxValue=99   },
+      .m_indexField=MusicTrackIndex::kTrack,       .m_type=ftNumeric,
+      .m_maxValue=99   },
     { .m_name="Rating",        .m_sqlName="music_songs.rating",
-      .m_type=ftNumeric,       .m_maxValue=10   },
+      .m_indexField=MusicTrackIndex::kRating,      .m_type=ftNumeric,
+      .m_maxValue=10   },
     { .m_name="Play Count",    .m_sqlName="music_songs.numplays",
-      .m_type=ftNumeric,       .m_maxValue=9999 },
+      .m_indexField=MusicTrackIndex::kPlayCount,   .m_type=ftNumeric,
+      .m_maxValue=9999 },
     { .m_name="Compilation",   .m_sqlName="music_albums.compilation",
-      .m_type=ftBoolean,       .m_maxValue=0    },
+      .m_indexField=MusicTrackIndex::kCompilation, .m_type=ftBoolean,
+      .m_maxValue=0    },
     { .m_name="Comp. Artist",  .m_sqlName="music_comp_artists.artist_name",
-      .m_type=ftString, },
+      .m_indexField=MusicTrackIndex::kCompilationArtist, .m_type=ftString, },
     { .m_name="Last Play",     .m_sqlName="FROM_DAYS(TO_DAYS(music_songs.lastplay))",
-      .m_type=ftDate   },
+      .m_indexField=MusicTrackIndex::kLastPlay,    .m_type=ftDate   },
     { .m_name="Date Imported", .m_sqlName="FROM_DAYS(TO_DAYS(music_songs.date_entered))",
-      .m_type=ftDate   },
+      .m_indexField=MusicTrackIndex::kDateAdded,   .m_type=ftDate   },
 }};
 
 struct SmartPLOperator
 {
     QString m_name;
+    MusicTrackIndex::Condition::Op m_op { MusicTrackIndex::Condition::kEqual };
     int     m_noOfArguments    { 1     };
     bool    m_stringOnly       { false };
     bool    m_validForBoolean  { false };
 };
 
+using Condition = MusicTrackIndex::Condition;
+
 static const std::array<const SmartPLOperator,11> SmartPLOperators
 {{
-    { .m_name="is equal to",      .m_validForBoolean=true },
-    { .m_name="is not equal to",  .m_validForBoolean=true },
-    { .m_name="is greater than"                           },
-    { .m_name="is less than"                              },
-    { .m_name="starts with",      .m_stringOnly=true      },
-    { .m_name="ends with",        .m_stringOnly=true      },
-    { .m_name="contains",         .m_stringOnly=true      },
-    { .m_name="does not contain", .m_stringOnly=true      },
-    { .m_name="is between",       .m_noOfArguments=2      },
-    { .m_name="is set",           .m_noOfArguments=0      },
-    { .m_name="is not set",       .m_noOfArguments=0      },
+    { .m_name="is equal to",      .m_op=Condition::kEqual,       .m_validForBoolean=true },
+    { .m_name="is not equal to",  .m_op=Condition::kNotEqual,    .m_validForBoolean=true },
+    { .m_name="is greater than",  .m_op=Condition::kGreater                              },
+    { .m_name="is less than",     .m_op=Condition::kLess                                 },
+    { .m_name="starts with",      .m_op=Condition::kStartsWith,  .m_stringOnly=true      },
+    { .m_name="ends with",        .m_op=Condition::kEndsWith,    .m_stringOnly=true      },
+    { .m_name="contains",         .m_op=Condition::kContains,    .m_stringOnly=true      },
+    { .m_name="does not contain", .m_op=Condition::kNotContains, .m_stringOnly=true      },
+    { .m_name="is between",       .m_op=Condition::kBetween,     .m_noOfArguments=2      },
+    { .m_name="is set",           .m_op=Condition::kIsSet,       .m_noOfArguments=0      },
+    { .m_name="is not set",       .m_op=Condition::kIsNotSet,    .m_noOfArguments=0      },
 }};
 
 static const SmartPLOperator *lookupOperator(const QString& name)
@@ -125,11 +138,17 @@ QString formattedFieldValue(const QVariant &value)
     return result;
 }
 
-static QString evaluateDateValue(QString sDate)
+/// the date $DATE stands for
+static QDate currentDate(void)
+{
+    return MythDate::current().toLocalTime().date();
+}
+
+static QString evaluateDateValue(QString sDate, const QDate &today = currentDate())
 {
     if (sDate.startsWith("$DATE"))
     {
-        QDate date = MythDate::current().toLocalTime().date();
+        QDate date = today;
 
         if (sDate.length() > 9)
         {
@@ -296,6 +315,209 @@ QString getSQLFieldName(const QString &fieldName)
 ///////////////////////////////////////////////////////////////////////
 */
 
+bool SmartPLQuery::loadFromDatabase(int smartPlaylistID)
+{
+    MSqlQuery query(MSqlQuery::InitCon());
+    query.prepare("SELECT matchtype, orderby, limitto "
+                  "FROM music_smartplaylists "
+                  "WHERE smartplaylistid = :SMARTPLAYLISTID;");
+    query.bindValue(":SMARTPLAYLISTID", smartPlaylistID);
+
+    if (!query.exec())
+    {
+        MythDB::DBError("Find SmartPlaylist", query);
+        return false;
+    }
+
+    if (!query.next())
+    {
+        LOG(VB_GENERAL, LOG_WARNING,
+            QString("Cannot find smartplaylist: %1").arg(smartPlaylistID));
+        return false;
+    }
+
+    setMatchAll(query.value(0).toString() == "All");
+    setOrderBy(query.value(1).toString());
+    setLimit(query.value(2).toInt());
+
+    query.prepare("SELECT field, operator, value1, value2 "
+                  "FROM music_smartplaylist_items "
+                  "WHERE smartplaylistid = :ID;");
+    query.bindValue(":ID", smartPlaylistID);
+    if (!query.exec())
+    {
+        MythDB::DBError("Load smartplaylist items", query);
+        return false;
+    }
+
+    while (query.next())
+    {
+        addCriteria(query.value(0).toString(), query.value(1).toString(),
+                    query.value(2).toString(), query.value(3).toString());
+    }
+
+    return true;
+}
+
+bool SmartPLQuery::addCriteria(const QString &fieldName, const QString &operatorName,
+                               const QString &value1, const QString &value2)
+{
+    if (fieldName.isEmpty())
+        return false;
+
+    const SmartPLField *Field = lookupField(fieldName);
+    const SmartPLOperator *Operator = lookupOperator(operatorName);
+    if (!Field || !Operator)
+        return false;
+
+    // $DATE is evaluated when the criteria are compiled, see compile()
+    if (Field->m_type == ftDate &&
+        (value1.startsWith("$DATE") || value2.startsWith("$DATE")))
+    {
+        m_relative = true;
+    }
+
+    m_criteria.append({ Field, Operator, value1, value2 });
+    return true;
+}
+
+QList<Condition> SmartPLQuery::compile(const QDate &today) const
+{
+    QList<Condition> conditions;
+
+    for (const auto &criterion : std::as_const(m_criteria))
+    {
+        const SmartPLField *Field = criterion.m_field;
+        const SmartPLOperator *Operator = criterion.m_operator;
+
+        Condition condition;
+        condition.m_field = Field->m_indexField;
+        condition.m_op    = Operator->m_op;
+        condition.m_text1 = criterion.m_value1;
+        condition.m_text2 = criterion.m_value2;
+
+        if (Field->m_type == ftBoolean)
+        {
+            // compilation field uses 0 = false;  1 = true
+            condition.m_value1 = (criterion.m_value1 == "Yes") ? 1 : 0;
+            condition.m_value2 = (criterion.m_value2 == "Yes") ? 1 : 0;
+        }
+        else if (Field->m_type == ftDate)
+        {
+            // the database compares the day, so a date stands for all of it
+            static const QDate kEpoch { 1970, 1, 1 };
+            static constexpr qint64 kDay { 24LL * 60 * 60 };
+            QDate date1 = QDate::fromString(evaluateDateValue(criterion.m_value1, today),
+                                            Qt::ISODate);
+            QDate date2 = QDate::fromString(evaluateDateValue(criterion.m_value2, today),
+                                            Qt::ISODate);
+            qint64 start1 = kEpoch.daysTo(date1) * kDay;
+            qint64 start2 = kEpoch.daysTo(date2) * kDay;
+
+            switch (Operator->m_op)
+            {
+                case Condition::kEqual:
+                    condition.m_op = Condition::kBetween;
+                    condition.m_value1 = start1;
+                    condition.m_value2 = start1 + kDay - 1;
+                    break;
+                case Condition::kNotEqual:
+                    condition.m_op = Condition::kNotBetween;
+                    condition.m_value1 = start1;
+                    condition.m_value2 = start1 + kDay - 1;
+                    break;
+                case Condition::kGreater:
+                    condition.m_value1 = start1 + kDay - 1;
+                    break;
+                case Condition::kBetween:
+                    condition.m_value1 = start1;
+                    condition.m_value2 = start2 + kDay - 1;
+                    break;
+                default:
+                    condition.m_value1 = start1;
+                    break;
+            }
+        }
+        else if (Field->m_type == ftNumeric)
+        {
+            condition.m_value1 = criterion.m_value1.toLongLong();
+            condition.m_value2 = criterion.m_value2.toLongLong();
+        }
+
+        conditions.append(condition);
+    }
+
+    return conditions;
+}
+
+void SmartPLQuery::setOrderBy(const QString &orderByFields)
+{
+    m_orderBy.clear();
+
+    const QStringList list = orderByFields.split(",", Qt::SkipEmptyParts);
+    for (const auto &item : list)
+    {
+        QString fieldName = item.trimmed();
+        const SmartPLField *Field = lookupField(fieldName.left(fieldName.length() - 4));
+        if (Field && !Field->m_name.isEmpty())
+            m_orderBy.append({ Field->m_indexField, fieldName.right(3) == "(D)" });
+    }
+}
+
+QList<MusicMetadata::IdType> SmartPLQuery::select(const MusicTrackIndex *index,
+                                                  const QList<MusicMetadata::IdType> *ids) const
+{
+    return index->select(compile(currentDate()), m_matchAll, ids);
+}
+
+QList<MusicMetadata::IdType> SmartPLQuery::order(const MusicTrackIndex *index,
+                                                 QList<MusicMetadata::IdType> tracks) const
+{
+    // in the order the database would have found them before any sort
+    std::sort(tracks.begin(), tracks.end());
+    index->sort(tracks, m_orderBy);
+
+    if (m_limit > 0 && tracks.size() > m_limit)
+        tracks.resize(m_limit);
+
+    return tracks;
+}
+
+SmartPLCache::Entry::Entry(const SmartPLQuery &query)
+  : m_query(query),
+    m_selection([query](const QDate &today) { return query.compile(today); },
+                query.matchAll(), query.isRelative())
+{
+}
+
+QList<MusicMetadata::IdType> SmartPLCache::getTracks(int smartPlaylistID)
+{
+    const MusicTrackIndex *index = gMusicData->m_all_music->getIndex();
+    if (index != m_index)
+    {
+        m_playlists.clear();
+        m_index = index;
+    }
+
+    auto it = m_playlists.find(smartPlaylistID);
+    if (it == m_playlists.end())
+    {
+        SmartPLQuery query;
+        if (!query.loadFromDatabase(smartPlaylistID))
+            return {};
+
+        it = m_playlists.insert(smartPlaylistID, Entry(query));
+    }
+
+    // the selection catches up with the changes to the index, or if the
+    // playlist has dates relative to today looks at every track again
+    return it->m_query.order(index, it->m_selection.tracks(index, currentDate()));
+}
+
+/*
+///////////////////////////////////////////////////////////////////////
+*/
+
 QString SmartPLCriteriaRow::getSQL(void) const
 {
     if (m_field.isEmpty())
@@ -707,25 +929,13 @@ void SmartPlaylistEditor::titleChanged(void)
 
 void SmartPlaylistEditor::updateMatches(void)
 {
-    QString sql =
-        "SELECT count(*) "
-        "FROM music_songs "
-        "LEFT JOIN music_artists ON "
-        "    music_songs.artist_id=music_artists.artist_id "
-        "LEFT JOIN music_albums ON music_songs.album_id=music_albums.album_id "
-        "LEFT JOIN music_artists AS music_comp_artists ON "
-        "    music_albums.artist_id=music_comp_artists.artist_id "
-        "LEFT JOIN music_genres ON music_songs.genre_id=music_genres.genre_id ";
-
-    sql += getWhereClause();
-
-    m_matchesCount = 0;
+    // count them in the track index rather than asking the database
+    SmartPLQuery query;
+    query.setMatchAll(m_matchSelector->GetValue() != tr("Any"));
+    for (const auto *row : std::as_const(m_criteriaRows))
+        query.addCriteria(row->m_field, row->m_operator, row->m_value1, row->m_value2);
 
-    MSqlQuery query(MSqlQuery::InitCon());
-    if (!query.exec(sql))
-        MythDB::DBError("SmartPlaylistEditor::updateMatches", query);
-    else if (query.next())
-        m_matchesCount = query.value(0).toInt();
+    m_matchesCount = query.select(gMusicData->m_all_music->getIndex()).size();
 
     m_matchesText->SetText(QString::number(m_matchesCount));
 
@@ -799,6 +1009,9 @@ void SmartPlaylistEditor::saveClicked(void)
     for (const auto & row : std::as_const(m_criteriaRows))
         row->saveToDatabase(ID);
 
+    if (gMusicData->m_smart_playlists)
+        gMusicData->m_smart_playlists->clear();
+
     emit smartPLChanged(category, name);
 
     Close();
@@ -1144,6 +1357,9 @@ bool SmartPlaylistEditor::deleteSmartPlaylist(const QString &category, const QSt
     if (!query.exec())
         MythDB::DBError("Delete smartplaylist", query);
 
+    if (gMusicData->m_smart_playlists)
+        gMusicData->m_smart_playlists->clear();
+
     return true;
 }
 
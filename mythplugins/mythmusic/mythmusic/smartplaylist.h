@@ -9,11 +9,13 @@ class MythUIButton;
 
 // qt
 #include <QDateTime>
+#include <QHash>
 #include <QVariant>
 #include <QKeyEvent>
 #include <QCoreApplication>
 
 // MythTV
+#include <libmythmetadata/musicmetadata.h>
 #include <libmythui/mythscreentype.h>
 
 struct SmartPLOperator;
@@ -27,7 +29,7 @@ enum SmartPLFieldType : std::uint8_t
     ftBoolean
 };
 
-// used by playlist.cpp
+// used by SmartPLCriteriaRow and SmartPlaylistEditor
 QString getCriteriaSQL(const QString& fieldName, const QString &operatorName,
                        QString value1, QString value2);
 
@@ -41,6 +43,76 @@ QString formattedFieldValue(const QVariant &value);
 /////////////////////////////////////////////////////////////////////////////
 */
 
+/// A smart playlist compiled to conditions on the MusicTrackIndex, so its
+/// tracks can be found without querying the database
+class SmartPLQuery
+{
+  public:
+    bool loadFromDatabase(int smartPlaylistID);
+
+    bool addCriteria(const QString &fieldName, const QString &operatorName,
+                     const QString &value1, const QString &value2);
+    void setMatchAll(bool matchAll) { m_matchAll = matchAll; }
+    void setOrderBy(const QString &orderByFields);
+    void setLimit(int limit) { m_limit = limit; }
+
+    bool matchAll(void) const { return m_matchAll; }
+    /// whether any criterion is a date relative to $DATE
+    bool isRelative(void) const { return m_relative; }
+    /// the criteria as conditions, with $DATE being today
+    QList<MusicTrackIndex::Condition> compile(const QDate &today) const;
+
+    /// the tracks of ids, or of the whole index if it's null, that match today
+    QList<MusicMetadata::IdType> select(const MusicTrackIndex *index,
+                                        const QList<MusicMetadata::IdType> *ids = nullptr) const;
+    /// the tracks that matched in the order of the playlist and limited
+    QList<MusicMetadata::IdType> order(const MusicTrackIndex *index,
+                                       QList<MusicMetadata::IdType> tracks) const;
+
+  private:
+    struct Criterion
+    {
+        const SmartPLField    *m_field    {nullptr};
+        const SmartPLOperator *m_operator {nullptr};
+        QString                m_value1;
+        QString                m_value2;
+    };
+
+    QList<Criterion>                  m_criteria;
+    MusicTrackIndex::SortOrder        m_orderBy;
+    bool                              m_matchAll {true};
+    bool                              m_relative {false};
+    int                               m_limit    {0};
+};
+
+/// The tracks of the smart playlists that have been opened. They are kept
+/// up to date with the changes to the track index rather than looked for
+/// again each time the playlist is opened, unless the playlist has dates
+/// relative to today, see MusicTrackSelection.
+class SmartPLCache
+{
+  public:
+    QList<MusicMetadata::IdType> getTracks(int smartPlaylistID);
+    /// forget everything, for when smart playlists are saved or deleted
+    void clear(void) { m_playlists.clear(); }
+
+  private:
+    struct Entry
+    {
+        explicit Entry(const SmartPLQuery &query);
+
+        SmartPLQuery        m_query;
+        MusicTrackSelection m_selection;
+    };
+
+    const MusicTrackIndex *m_index {nullptr};
+    QHash<int, Entry>      m_playlists;
+};
+
+/*
+/////////////////////////////////////////////////////////////////////////////
+*/
+
 class SmartPLCriteriaRow
 {
     Q_DECLARE_TR_FUNCTIONS(SmartPLCriteriaRow);
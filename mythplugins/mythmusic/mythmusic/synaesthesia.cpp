@@ -15,31 +15,45 @@
 #include <iostream>
 
 // Qt
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6,5,0)
+#include <QtProcessorDetection>
+#endif
 #include <QCoreApplication>
-#include <QPainter>
 #include <QImage>
-#include <numbers>
 
 // MythTV
 #include <libmythbase/compat.h>
+#include <libmythbase/mythconfig.h>
 #include <libmythbase/mythlogging.h>
 
 // MythMusic
 #include "mainvisual.h"
 #include "synaesthesia.h"
 
+#ifdef Q_PROCESSOR_X86_64
+#   include <emmintrin.h>
+static const bool s_haveSIMD = true;
+#elif HAVE_INTRINSICS_NEON
+#   include <arm_neon.h>
+extern "C" {
+#include <libavutil/cpu.h>
+}
+static const bool s_haveSIMD = (av_get_cpu_flags() & AV_CPU_FLAG_NEON) != 0;
+#endif
+
 Synaesthesia::Synaesthesia(void)
+  : ThreadedVisual("Synaesthesia")
 {
     m_fps = 29;
 
-    coreInit();              // init cosTable, negSinTable, bitReverse
     setStarSize(m_starSize); // init scaleDown, maxStarRadius
     setupPalette();          // init palette
 }
 
 Synaesthesia::~Synaesthesia()
 {
-    delete m_outputImage;
+    stopRendering();
 }
 
 //static constexpr uint8_t sBOUND(int x)
@@ -101,35 +115,23 @@ void Synaesthesia::setupPalette(void)
         m_palette[(i * 3) + 1] = std::clamp(int(green), 0, 255);
         m_palette[(i * 3) + 2] = std::clamp(int(blue), 0, 255);
     }
+
+    m_colorTable.resize(256);
+    for (size_t i = 0; i < 256; i++)
+        m_colorTable[i] = qRgba(m_palette[i * 3], m_palette[(i * 3) + 1],
+                                m_palette[(i * 3) + 2], 255);
 }
 
-void Synaesthesia::resize(const QSize &newsize)
+// called on the render thread
+void Synaesthesia::resizeBuffers(QSize size)
 {
-    m_size = newsize;
-
-    m_size.setHeight(m_size.height() / 2);
-    m_size.setWidth((m_size.width() / 4) * 4);
-    m_outputBmp.size(m_size.width(), m_size.height());
-    m_lastOutputBmp.size(m_size.width(), m_size.height());
-    m_lastLastOutputBmp.size(m_size.width(), m_size.height());
-    m_outWidth = m_size.width();
-    m_outHeight = m_size.height();
-
-    delete m_outputImage;
+    m_renderSize = size;
 
-    m_size.setHeight(m_size.height() * 2);
-    m_outputImage = new QImage(m_size, QImage::Format_Indexed8);
-
-    if (!m_outputImage) 
-    {
-        LOG(VB_GENERAL, LOG_ERR,
-            "outputImage in Synaesthesia::resize() is NULL");
-        return;
-    }
-
-    for (size_t i = 0; i < 256; i++)
-        m_outputImage->setColor(i, qRgba(m_palette[i * 3], m_palette[(i * 3) + 1],
-                                      m_palette[(i * 3) + 2], 255));
+    m_outWidth = (size.width() / 4) * 4;
+    m_outHeight = size.height() / 2;
+    m_outputBmp.size(m_outWidth, m_outHeight);
+    m_lastOutputBmp.size(m_outWidth, m_outHeight);
+    m_lastLastOutputBmp.size(m_outWidth, m_outHeight);
 
 #if 0
     surface = SDL_SetVideoMode(size.width(), size.height(), 8, 0);
@@ -153,43 +155,6 @@ void Synaesthesia::resize(const QSize &newsize)
 #endif
 }
 
-int Synaesthesia::bitReverser(int i)
-{
-    int sum = 0;
-    for (size_t j = 0; j < LogSize; j++)
-    {
-        sum = (i & 1) + (sum * 2);
-        i >>= 1;
-    }
-    
-    return sum;
-}
-
-void Synaesthesia::fft(double *x, double *y)
-{
-    size_t n2 = NumSamples;
-    for (size_t twoToTheK = 1; twoToTheK < NumSamples; twoToTheK *= 2)
-    {
-        size_t n1 = n2;
-        n2 /= 2;
-        for (size_t j = 0; j < n2; j++)
-        {
-            double c = m_cosTable[(j * twoToTheK) & (NumSamples - 1)];
-            double s = m_negSinTable[(j * twoToTheK) & (NumSamples - 1)];
-            for (size_t i = j; i < NumSamples; i += n1)
-            {
-                size_t l = i + n2;
-                double xt = x[i] - x[l];
-                x[i] = (x[i] + x[l]);
-                double yt = y[i] - y[l];
-                y[i] = (y[i] + y[l]);
-                x[l] = (xt * c) - (yt * s);
-                y[l] = (xt * s) + (yt * c);
-            }
-        }
-    }
-}
-
 void Synaesthesia::setStarSize(double lsize)
 {
     double fadeModeFudge { 0.78 };
@@ -211,16 +176,6 @@ void Synaesthesia::setStarSize(double lsize)
         m_maxStarRadius++;
 }
 
-void Synaesthesia::coreInit(void)
-{
-    for (size_t i = 0; i < NumSamples; i++)
-    {
-        m_negSinTable[i] = -sin(std::numbers::pi * 2.0 / NumSamples * i);
-        m_cosTable[i] = cos(std::numbers::pi * 2.0 / NumSamples * i);
-        m_bitReverse[i] = bitReverser(i);
-    }
-}
-
 #define output ((unsigned char*)m_outputBmp.data)
 #define lastOutput ((unsigned char*)m_lastOutputBmp.data)
 #define lastLastOutput ((unsigned char*)m_lastLastOutputBmp.data)
@@ -262,23 +217,121 @@ unsigned char Synaesthesia::getPixel(int x, int y, int where) const
     return lastOutput[where];
 }
 
-void Synaesthesia::fadeFade(void) const
+#ifdef Q_PROCESSOR_X86_64
+template <bool Heat>
+static inline __m128i fadeLanes(__m128i left, __m128i right, __m128i up, __m128i down,
+                                __m128i last, __m128i lastLast)
+{
+    __m128i sum = _mm_add_epi16(_mm_add_epi16(left, right), _mm_add_epi16(up, down));
+    __m128i result = _mm_sub_epi16(_mm_add_epi16(_mm_srli_epi16(sum, 2), last),
+                                   _mm_add_epi16(lastLast, _mm_set1_epi16(1)));
+    if constexpr (Heat)
+        result = _mm_add_epi16(result, _mm_srai_epi16(_mm_sub_epi16(lastLast, last), 2));
+    return result;
+}
+#elif HAVE_INTRINSICS_NEON
+template <bool Heat>
+static inline int16x8_t fadeLanes(uint8x8_t left, uint8x8_t right, uint8x8_t up, uint8x8_t down,
+                                  uint8x8_t last, uint8x8_t lastLast)
 {
-    auto *ptr = (uint32_t *)output;
-    for (int i = static_cast<ptrdiff_t>(m_outWidth) * m_outHeight * 2 / sizeof(uint32_t);
-         i > 0; i--)
+    int16x8_t sum  = vreinterpretq_s16_u16(vshrq_n_u16(vaddq_u16(vaddl_u8(left, right),
+                                                                 vaddl_u8(up, down)), 2));
+    int16x8_t cur  = vreinterpretq_s16_u16(vmovl_u8(last));
+    int16x8_t prev = vreinterpretq_s16_u16(vmovl_u8(lastLast));
+    int16x8_t result = vsubq_s16(vaddq_s16(sum, cur), vaddq_s16(prev, vdupq_n_s16(1)));
+    if constexpr (Heat)
+        result = vaddq_s16(result, vshrq_n_s16(vsubq_s16(prev, cur), 2));
+    return result;
+}
+#endif
+
+/* Fades count bytes away from the edges. Each becomes the average of its
+ * neighbours in the last frame plus itself there, less itself in the frame
+ * before that, clamped to a byte. The flame also keeps a quarter of the
+ * change since the frame before. */
+template <bool Heat>
+static void fadeInterior(unsigned char *out, const unsigned char *last,
+                         const unsigned char *lastLast, int count, int step)
+{
+    int i = 0;
+#if defined(Q_PROCESSOR_X86_64) || HAVE_INTRINSICS_NEON
+    if (s_haveSIMD)
     {
-        uint32_t x = *ptr;
-        if (x)
+        for (; i + 16 <= count; i += 16)
         {
-            *(ptr++) = x - ((x & (uintptr_t)0xf0f0f0f0) >> 4) -
-                           ((x & (uintptr_t)0xe0e0e0e0) >> 5);
+#ifdef Q_PROCESSOR_X86_64
+            auto load = [](const unsigned char *p)
+                { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); };
+            const __m128i zero  = _mm_setzero_si128();
+            const __m128i left  = load(last + i - 2);
+            const __m128i right = load(last + i + 2);
+            const __m128i up    = load(last + i - step);
+            const __m128i down  = load(last + i + step);
+            const __m128i cur   = load(last + i);
+            const __m128i prev  = load(lastLast + i);
+            __m128i lo = fadeLanes<Heat>(_mm_unpacklo_epi8(left, zero), _mm_unpacklo_epi8(right, zero),
+                                         _mm_unpacklo_epi8(up, zero), _mm_unpacklo_epi8(down, zero),
+                                         _mm_unpacklo_epi8(cur, zero), _mm_unpacklo_epi8(prev, zero));
+            __m128i hi = fadeLanes<Heat>(_mm_unpackhi_epi8(left, zero), _mm_unpackhi_epi8(right, zero),
+                                         _mm_unpackhi_epi8(up, zero), _mm_unpackhi_epi8(down, zero),
+                                         _mm_unpackhi_epi8(cur, zero), _mm_unpackhi_epi8(prev, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(lo, hi));
+#else
+            const uint8x16_t left  = vld1q_u8(last + i - 2);
+            const uint8x16_t right = vld1q_u8(last + i + 2);
+            const uint8x16_t up    = vld1q_u8(last + i - step);
+            const uint8x16_t down  = vld1q_u8(last + i + step);
+            const uint8x16_t cur   = vld1q_u8(last + i);
+            const uint8x16_t prev  = vld1q_u8(lastLast + i);
+            int16x8_t lo = fadeLanes<Heat>(vget_low_u8(left), vget_low_u8(right),
+                                           vget_low_u8(up), vget_low_u8(down),
+                                           vget_low_u8(cur), vget_low_u8(prev));
+            int16x8_t hi = fadeLanes<Heat>(vget_high_u8(left), vget_high_u8(right),
+                                           vget_high_u8(up), vget_high_u8(down),
+                                           vget_high_u8(cur), vget_high_u8(prev));
+            vst1q_u8(out + i, vcombine_u8(vqmovun_s16(lo), vqmovun_s16(hi)));
+#endif
         }
-        else
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        int j = ((last[i - 2] + last[i + 2] + last[i - step] + last[i + step]) >> 2) +
+                last[i] - lastLast[i] - 1;
+        if constexpr (Heat)
+            j += (lastLast[i] - last[i]) >> 2;
+        out[i] = std::clamp(j, 0, 255);
+    }
+}
+
+void Synaesthesia::fadeFade(void) const
+{
+    // each byte loses a sixteenth and a thirty second of itself
+    unsigned char *ptr = output;
+    int count = m_outWidth * m_outHeight * 2;
+    int i = 0;
+#if defined(Q_PROCESSOR_X86_64) || HAVE_INTRINSICS_NEON
+    if (s_haveSIMD)
+    {
+        for (; i + 16 <= count; i += 16)
         {
-            ptr++;
+#ifdef Q_PROCESSOR_X86_64
+            auto *p = reinterpret_cast<__m128i*>(ptr + i);
+            __m128i x = _mm_loadu_si128(p);
+            __m128i sixteenth = _mm_srli_epi32(_mm_and_si128(x, _mm_set1_epi8(static_cast<char>(0xf0))), 4);
+            __m128i thirtysecond = _mm_srli_epi32(_mm_and_si128(x, _mm_set1_epi8(static_cast<char>(0xe0))), 5);
+            _mm_storeu_si128(p, _mm_sub_epi8(_mm_sub_epi8(x, sixteenth), thirtysecond));
+#else
+            uint8x16_t x = vld1q_u8(ptr + i);
+            vst1q_u8(ptr + i, vsubq_u8(vsubq_u8(x, vshrq_n_u8(x, 4)), vshrq_n_u8(x, 5)));
+#endif
         }
     }
+#endif
+
+    for (; i < count; i++)
+        ptr[i] = ptr[i] - (ptr[i] >> 4) - (ptr[i] >> 5);
 }
 
 void Synaesthesia::fadePixelWave(int x, int y, int where, int step)
@@ -332,28 +385,8 @@ void Synaesthesia::fadeWave(void)
     for (int y = 1, start = (m_outWidth * 2) + 2, end = (m_outWidth * 4) - 2;
          y < m_outHeight - 1; y++, start += step, end += step) 
     {
-        for (int i2 = start; i2 < end; i2++)
-        {
-            short j2 = short((int(lastOutput[i2 - 2]) +
-                              int(lastOutput[i2 + 2]) +
-                              int(lastOutput[i2 - step]) +
-                              int(lastOutput[i2 + step])) >> 2) +
-                lastOutput[i2];
-            if (!j2)
-            {
-                output[i2] = 0;
-            }
-            else
-            {
-                j2 = j2 - lastLastOutput[i2] - 1;
-                if (j2 < 0)
-                    output[i2] = 0;
-                else if (j2 & (255*256))
-                    output[i2] = 255;
-                else
-                    output[i2] = j2;
-            }
-        }
+        fadeInterior<false>(output + start, lastOutput + start,
+                            lastLastOutput + start, end - start, step);
     }
 }
 
@@ -407,29 +440,8 @@ void Synaesthesia::fadeHeat(void)
     for(int y = 1, start = (m_outWidth * 2) + 2, end = (m_outWidth * 4) - 2;
         y < m_outHeight - 1; y++, start += step, end += step) 
     {
-        for (int i2 = start; i2 < end; i2++)
-        {
-            short j2 = short((int(lastOutput[i2 - 2]) +
-                              int(lastOutput[i2 + 2]) +
-                              int(lastOutput[i2 - step]) +
-                              int(lastOutput[i2 + step])) >> 2) +
-                lastOutput[i2];
-            if (!j2)
-            {
-                output[i2] = 0;
-            }
-            else
-            {
-                j2 = j2 - lastLastOutput[i2] +
-                    ((lastLastOutput[i2] - lastOutput[i2]) >> 2) - 1;
-                if (j2 < 0)
-                    output[i2] = 0;
-                else if (j2 & (255*256))
-                    output[i2] = 255;
-                else
-                    output[i2] = j2;
-            }
-        };
+        fadeInterior<true>(output + start, lastOutput + start,
+                           lastLastOutput + start, end - start, step);
     }
 }
 
@@ -444,52 +456,98 @@ void Synaesthesia::fade(void)
     }
 }
 
-bool Synaesthesia::process(VisualNode *node)
+// called on the render thread
+bool Synaesthesia::renderFrame(const VisualRenderer::Samples &samples,
+                               QSize size, QImage &image)
 {
+    if (size != m_renderSize)
+        resizeBuffers(size);
+    if (m_outWidth <= 0 || m_outHeight <= 0)
+        return false;
+
     fade();
 
-    if (!node)
-        return false;
+    // The spectrum comes from the AudioAnalyser of MainVisual
+    if (samples.m_analysis && samples.m_analysis->IsReady())
+        addStars(*samples.m_analysis);
 
-    samp_dbl_array x {};
-    samp_dbl_array y {};
+    QSize imageSize(m_outWidth, m_outHeight * 2);
+    if (image.size() != imageSize || image.format() != QImage::Format_Indexed8)
+    {
+        image = QImage(imageSize, QImage::Format_Indexed8);
+        image.setColorTable(m_colorTable);
+    }
+
+    auto *ptrOutput = (uint32_t *)output;
+
+    for (int j = 0; j < m_outHeight * 2; j += 2) 
+    {
+        auto *ptrTop = (uint32_t *)(image.scanLine(j));
+        auto *ptrBot = (uint32_t *)(image.scanLine(j+1));
+
+        for (int i = m_outWidth / 4; i > 0; i--)
+        {
+            unsigned int const r1 = *(ptrOutput++);
+            unsigned int const r2 = *(ptrOutput++);
+
+            unsigned int const v = ((r1 & 0x000000f0UL) >> 4) |
+                                   ((r1 & 0x0000f000UL) >> 8) |
+                                   ((r1 & 0x00f00000UL) >> 12) |
+                                   ((r1 & 0xf0000000UL) >> 16);
+
+            *(ptrTop++) = v | (((r2 & 0x000000f0UL) << 12) |
+                               ((r2 & 0x0000f000UL) << 8) |
+                               ((r2 & 0x00f00000UL) << 4) |
+                               ( r2 & 0xf0000000UL));
+
+            *(ptrBot++) = v | (((r2 & 0x000000f0UL) << 12) |
+                               ((r2 & 0x0000f000UL) << 8) |
+                               ((r2 & 0x00f00000UL) << 4) |
+                               ( r2 & 0xf0000000UL));
+        }
+    }
+
+    return true;
+}
+
+void Synaesthesia::addStars(const AudioAnalysis &analysis)
+{
     samp_dbl_array a {};
     samp_dbl_array b {};
     samp_int_array clarity {};
 
     int brightFactor = int(Brightness * m_brightnessTwiddler / (m_starSize + 0.01));
 
-    size_t numSamps = NumSamples;
-    if (node->m_length < NumSamples)
-        numSamps = node->m_length;
-
-    for (size_t i = 0; i < numSamps; i++)
-    {
-        x[i] = node->m_left[i];
-        if (node->m_right)
-            y[i] = node->m_right[i];
-        else
-            y[i] = x[i];
-    }
-
-    fft(x.data(), y.data());
+    // This was written for a NumSamples point FFT of the raw samples, the
+    // analysis has kGroup times the resolution. So each bin here gathers
+    // kGroup of its bins, scaled up to what that FFT would have given.
+    static constexpr int kGroup { AudioAnalysis::kFFTSize / static_cast<int>(NumSamples) };
+    const double scale  = 32768.0 * NumSamples / analysis.m_gain;
+    const double scale2 = 4.0 * scale * scale;
+    const std::vector<float> &left  = analysis.m_left;
+    const std::vector<float> &right = analysis.m_right;
 
     double energy = 0.0;
 
     for (size_t i = 0 + 1; i < NumSamples / 2; i++)
     {
-        double x1 = x[m_bitReverse[i]];
-        double y1 = y[m_bitReverse[i]];
-        double x2 = x[m_bitReverse[NumSamples - i]];
-        double y2 = y[m_bitReverse[NumSamples - i]];
-        double aa = ((x1 + x2) * (x1 + x2)) + ((y1 - y2) * (y1 - y2));
-        double bb = ((x1 - x2) * (x1 - x2)) + ((y2 + y2) * (y1 + y2));
+        double ll = 0.0;
+        double rr = 0.0;
+        double lr = 0.0;
+        size_t first = (i * kGroup) - (kGroup / 2);
+        for (size_t j = 2 * first; j < 2 * (first + kGroup); j += 2)
+        {
+            ll += (left[j] * left[j]) + (left[j + 1] * left[j + 1]);
+            rr += (right[j] * right[j]) + (right[j + 1] * right[j + 1]);
+            lr += (left[j + 1] * right[j]) - (left[j] * right[j + 1]);
+        }
+        double aa = ll * scale2;
+        double bb = rr * scale2;
         a[i] = sqrt(aa);
         b[i] = sqrt(bb);
         if (aa + bb != 0.0)
         {
-            clarity[i] = (int)((((x1 + x2) * (x1 - x2)) + ((y1 + y2) * (y1 - y2))) /
-                         (aa + bb) * 256);
+            clarity[i] = (int)(lr * scale2 / (aa + bb) * 256);
         }
         else
         {
@@ -585,47 +643,6 @@ bool Synaesthesia::process(VisualNode *node)
             }
         }
     }
-
-    return false;
-}
-
-bool Synaesthesia::draw(QPainter *p, [[maybe_unused]] const QColor &back)
-{
-    if (!m_outputImage)
-        return true;
-
-    auto *ptrOutput = (uint32_t *)output;
-
-    for (int j = 0; j < m_outHeight * 2; j += 2) 
-    {
-        auto *ptrTop = (uint32_t *)(m_outputImage->scanLine(j));
-        auto *ptrBot = (uint32_t *)(m_outputImage->scanLine(j+1));
-
-        for (int i = m_outWidth / 4; i > 0; i--)
-        {
-            unsigned int const r1 = *(ptrOutput++);
-            unsigned int const r2 = *(ptrOutput++);
-
-            unsigned int const v = ((r1 & 0x000000f0UL) >> 4) |
-                                   ((r1 & 0x0000f000UL) >> 8) |
-                                   ((r1 & 0x00f00000UL) >> 12) |
-                                   ((r1 & 0xf0000000UL) >> 16);
-
-            *(ptrTop++) = v | (((r2 & 0x000000f0UL) << 12) |
-                               ((r2 & 0x0000f000UL) << 8) |
-                               ((r2 & 0x00f00000UL) << 4) |
-                               ( r2 & 0xf0000000UL));
-
-            *(ptrBot++) = v | (((r2 & 0x000000f0UL) << 12) |
-                               ((r2 & 0x0000f000UL) << 8) |
-                               ((r2 & 0x00f00000UL) << 4) |
-                               ( r2 & 0xf0000000UL));
-        }
-    }
-
-    p->drawImage(0, 0, *m_outputImage);
-
-    return true;
 }
 
 static class SynaesthesiaFactory : public VisFactory
@@ -8,7 +8,9 @@
 #include "mainvisual.h"
 #include "polygon.h"
 
-class QImage;
+// Qt
+#include <QImage>
+#include <QVector>
 
 static constexpr size_t  LogSize    {         10 };
 static constexpr size_t  NumSamples { 1<<LogSize };
@@ -23,22 +25,23 @@ enum Mode : std::uint8_t {
     Stars = 2
 };
 
-class Synaesthesia : public VisualBase
+class Synaesthesia : public ThreadedVisual
 {
 public:
     Synaesthesia(void);
     ~Synaesthesia() override;
 
-    void resize(const QSize &size) override; // VisualBase
-    bool process(VisualNode *node) override; // VisualBase
-    bool draw(QPainter *p, const QColor &back) override; // VisualBase
+    bool needsAnalysis(void) override { return true; } // VisualBase
     void handleKeyPress([[maybe_unused]] const QString &action) override {}; // VisualBase
 
+protected:
+    bool renderFrame(const VisualRenderer::Samples &samples,
+                     QSize size, QImage &image) override; // ThreadedVisual
+
 private:
+    void resizeBuffers(QSize size);
+    void addStars(const AudioAnalysis &analysis);
     void setupPalette(void);
-    void coreInit(void);
-    static int bitReverser(int i);
-    void fft(double *x, double *y);
     void setStarSize(double lsize);
 
     inline void addPixel(int x, int y, int br1, int br2) const;
@@ -52,11 +55,8 @@ private:
     void fadeFade(void) const;
     void fade(void);
 
-    QSize m_size                 {0,0};
+    QSize m_renderSize           {0,0};
 
-    samp_dbl_array      m_cosTable    {};
-    samp_dbl_array      m_negSinTable {};
-    samp_int_array      m_bitReverse  {};
     std::array<int,256> m_scaleDown   {};
     int    m_maxStarRadius       {1};
     int    m_fadeMode            {Stars};
@@ -70,9 +70,9 @@ private:
     Bitmap<unsigned short> m_outputBmp;
     Bitmap<unsigned short> m_lastOutputBmp;
     Bitmap<unsigned short> m_lastLastOutputBmp;
-    QImage *m_outputImage        {nullptr};
 
     std::array<uint8_t,768>  m_palette {};
+    QVector<QRgb> m_colorTable;
     double m_fgRedSlider         {0.0};
     double m_fgGreenSlider       {0.5};
     double m_bgRedSlider         {0.75};
@@ -43,13 +43,13 @@ bool VisualizationSettings::Create()
     m_changeOnSongChange->SetHelpText(tr("Change the visualizer when the song changes."));
     m_randomizeOrder->SetHelpText(tr("On changing the visualizer pick a new one at random."));
     m_scaleWidth->SetHelpText(tr("If set to \"2\", visualizations will be "
-                 "scaled in half. Currently only used by "
-                 "the goom visualization. Reduces CPU load "
-                 "on slower machines."));
+                 "scaled in half. Used by the Goom, "
+                 "Synaesthesia and BumpScope visualizations. "
+                 "Reduces CPU load on slower machines."));
     m_scaleHeight->SetHelpText(tr("If set to \"2\", visualizations will be "
-                 "scaled in half. Currently only used by "
-                 "the goom visualization. Reduces CPU load "
-                 "on slower machines."));
+                 "scaled in half. Used by the Goom, "
+                 "Synaesthesia and BumpScope visualizations. "
+                 "Reduces CPU load on slower machines."));
     m_cancelButton->SetHelpText(tr("Exit without saving settings"));
     m_saveButton->SetHelpText(tr("Save settings and Exit"));
 
@@ -45,11 +45,6 @@
 #include "musicplayer.h"
 #include "visualize.h"
 
-extern "C" {
-    #include <libavutil/mem.h>
-    #include <libavutil/tx.h>
-}
-
 VisFactory* VisFactory::g_pVisFactories = nullptr;
 
 VisualBase::VisualBase(bool screensaverenable)
@@ -108,6 +103,89 @@ void VisualBase::drawWarning(QPainter *p, const QColor &back, const QSize size,
     p->drawText(0, 0, size.width(), size.height(), Qt::AlignVCenter | Qt::AlignHCenter | Qt::TextWordWrap, warning);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// ThreadedVisual
+
+// the most pixels a frame is rendered with, larger ones are scaled down to 720p
+static constexpr int kMaxRenderPixels { 1280 * 720 };
+
+ThreadedVisual::ThreadedVisual(const QString &name)
+{
+    m_scalew = gCoreContext->GetNumSetting("VisualScaleWidth", 2);
+    m_scaleh = gCoreContext->GetNumSetting("VisualScaleHeight", 2);
+
+    // we allow 1, 2 or 4 for the scale since goom likes its resolution to be a multiple of 2
+    if (m_scaleh == 3 || m_scaleh > 4)
+        m_scaleh = 4;
+    m_scaleh = std::max(m_scaleh, 1);
+
+    if (m_scalew == 3 || m_scalew > 4)
+        m_scalew = 4;
+    m_scalew = std::max(m_scalew, 1);
+
+    m_renderer = new VisualRenderer(name,
+        [this](const VisualRenderer::Samples &samples, QSize size, QImage &image)
+            { return renderFrame(samples, size, image); });
+}
+
+ThreadedVisual::~ThreadedVisual()
+{
+    delete m_renderer;
+}
+
+void ThreadedVisual::stopRendering(void)
+{
+    m_renderer->Stop();
+}
+
+void ThreadedVisual::resize(const QSize &newsize)
+{
+    m_size = newsize;
+
+    // only scale the resolution if it is > 256
+    // this ensures the small visualisers don't look too blocky
+    QSize size = m_size;
+    if (size.width() > 256)
+        size = QSize(size.width() / m_scalew, size.height() / m_scaleh);
+    if (size.width() * size.height() > kMaxRenderPixels)
+        size.scale(1280, 720, Qt::KeepAspectRatio);
+
+    // the visualizers work on 4 pixels across and 2 rows at a time
+    size.setWidth((size.width() / 4) * 4);
+    size.setHeight((size.height() / 2) * 2);
+    m_renderer->SetSize(size);
+}
+
+bool ThreadedVisual::process(VisualNode *node)
+{
+    // post even without samples, so that fades carry on
+    VisualRenderer::Samples samples;
+    if (node && node->m_length > 0)
+    {
+        unsigned long numSamps = std::min<unsigned long>(node->m_length, 512);
+        samples.m_left.assign(node->m_left, node->m_left + numSamps);
+        if (node->m_right)
+            samples.m_right.assign(node->m_right, node->m_right + numSamps);
+        samples.m_analysis = node->m_analysis;
+    }
+    m_renderer->Post(std::move(samples));
+
+    return false;
+}
+
+bool ThreadedVisual::draw(QPainter *p, const QColor &back)
+{
+    QImage frame = m_renderer->Frame();
+    if (frame.isNull())
+    {
+        p->fillRect(0, 0, m_size.width(), m_size.height(), back);
+        return true;
+    }
+
+    p->drawImage(QRect(QPoint(0, 0), m_size), frame);
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // LogScale
 
@@ -1002,19 +1080,10 @@ Spectrogram::Spectrogram(bool hist)
         m_image->fill(Qt::black);
     }
 
-    m_dftL = static_cast<float*>(av_malloc(sizeof(float) * m_fftlen));
-    m_dftR = static_cast<float*>(av_malloc(sizeof(float) * m_fftlen));
-    m_rdftTmp = static_cast<float*>(av_malloc(sizeof(float) * (m_fftlen + 2)));
-
-    // should probably check that this succeeds
-    av_tx_init(&m_rdftContext, &m_rdft, AV_TX_FLOAT_RDFT, 0, m_fftlen, &kTxScale, 0x0);
-
     // hack!!! Should 44100 sample rate be queried or measured?
     // Likely close enough for most audio recordings...
     m_scale.setMax(m_fftlen / 2, m_history ?
                    m_sgsize.height() / 2 : m_sgsize.width(), 44100/2);
-    m_sigL.resize(m_fftlen);
-    m_sigR.resize(m_fftlen);
 
     // TODO: promote this to a separate ColorSpectrum class
 
@@ -1055,22 +1124,11 @@ Spectrogram::Spectrogram(bool hist)
     }
 }
 
-Spectrogram::~Spectrogram()
-{
-    av_freep(reinterpret_cast<void*>(&m_dftL));
-    av_freep(reinterpret_cast<void*>(&m_dftR));
-    av_freep(reinterpret_cast<void*>(&m_rdftTmp));
-    av_tx_uninit(&m_rdftContext);
-}
-
 void Spectrogram::resize(const QSize &newsize)
 {
     m_size = newsize;
 }
 
-// this moved up from Spectrum so both can use it
-template<typename T> T sq(T a) { return a*a; };
-
 unsigned long Spectrogram::getDesiredSamples(void)
 {
     // maximum samples per update, may get less
@@ -1158,48 +1216,11 @@ bool Spectrogram::processUndisplayed(VisualNode *node)
         m_image->fill(Qt::black);
         s_offset = 0;
     }
-    if (node)     // shift previous samples left, then append new node
-    {
-        // LOG(VB_PLAYBACK, LOG_DEBUG, QString("SG got %1 samples").arg(node->m_length));
-        int i = std::min((int)(node->m_length), m_fftlen);
-        int start = m_fftlen - i;
-        float mult = 0.8F;      // decay older sound by this much
-        for (int k = 0; k < start; k++)
-        {                       // prior set ramps from mult to 1.0
-            if (k > start - i && start > i)
-            {
-                mult = mult + ((1 - mult) *
-                    (1 - ((float)(start - k) / (float)(start - i))));
-            }
-            m_sigL[k] = mult * m_sigL[i + k];
-            m_sigR[k] = mult * m_sigR[i + k];
-        }
-        for (int k = 0; k < i; k++) // append current samples
-        {
-            m_sigL[start + k] = node->m_left[k] / 32768.0F; // +/- 1 peak-to-peak
-            if (node->m_right)
-                m_sigR[start + k] = node->m_right[k] / 32768.0F;
-        }
-        int end = m_fftlen / 40; // ramp window ends down to zero crossing
-        for (int k = 0; k < m_fftlen; k++)
-        {
-            if (k < end)
-                mult = (float)k / (float)end;
-            else if (k > m_fftlen - end)
-                mult = (float)(m_fftlen - k) / (float)end;
-            else
-                mult = 1;
-            m_dftL[k] = m_sigL[k] * mult;
-            m_dftR[k] = m_sigR[k] * mult;
-        }
-    }
-    // run the real FFT!
-    m_rdft(m_rdftContext, m_rdftTmp, m_dftL, sizeof(float));
-    m_rdftTmp[1] = m_rdftTmp[m_fftlen];
-    memcpy(m_dftL, m_rdftTmp, m_fftlen * sizeof(float));
-    m_rdft(m_rdftContext, m_rdftTmp, m_dftR, sizeof(float));
-    m_rdftTmp[1] = m_rdftTmp[m_fftlen];
-    memcpy(m_dftR, m_rdftTmp, m_fftlen * sizeof(float));
+    // The FFT over the decaying window is done once per node by the
+    // AudioAnalyser of MainVisual, off this thread
+    const AudioAnalysis *analysis = node ? node->analysis() : nullptr;
+    if (!analysis)
+        return false;
 
     QPainter painter(m_image);
     painter.setPen(Qt::black);  // clear prior content
@@ -1222,9 +1243,9 @@ bool Spectrogram::processUndisplayed(VisualNode *node)
         int count = 0;
         for (ptrdiff_t j = prev + 1; j <= index; j++) // log scale!
         {    // for the freqency bins of this pixel, find peak or mean
-            tmp = sq(m_dftL[2 * j]) + sq(m_dftL[(2 * j) + 1]);
+            tmp = analysis->LeftPower(j);
             left  = m_binpeak ? std::max(tmp, left) : left + tmp;
-            tmp = sq(m_dftR[2 * j]) + sq(m_dftR[(2 * j) + 1]);
+            tmp = analysis->RightPower(j);
             right = m_binpeak ? std::max(tmp, right) : right + tmp;
             count++;
         }
@@ -1413,21 +1434,6 @@ Spectrum::Spectrum()
     LOG(VB_GENERAL, LOG_INFO, QString("Spectrum : Being Initialised"));
 
     m_fps = 40;         // getting 1152 samples / 44100 = 38.28125 fps
-
-    m_dftL = static_cast<float*>(av_malloc(sizeof(float) * m_fftlen));
-    m_dftR = static_cast<float*>(av_malloc(sizeof(float) * m_fftlen));
-    m_rdftTmp = static_cast<float*>(av_malloc(sizeof(float) * (m_fftlen + 2)));
-
-    // should probably check that this succeeds
-    av_tx_init(&m_rdftContext, &m_rdft, AV_TX_FLOAT_RDFT, 0, m_fftlen, &kTxScale, 0x0);
-}
-
-Spectrum::~Spectrum()
-{
-    av_freep(reinterpret_cast<void*>(&m_dftL));
-    av_freep(reinterpret_cast<void*>(&m_dftR));
-    av_freep(reinterpret_cast<void*>(&m_rdftTmp));
-    av_tx_uninit(&m_rdftContext);
 }
 
 void Spectrum::resize(const QSize &newsize)
@@ -1445,8 +1451,6 @@ void Spectrum::resize(const QSize &newsize)
     m_analyzerBarWidth = std::max(m_analyzerBarWidth, 6);
 
     m_scale.setMax(m_fftlen/2, m_size.width() / m_analyzerBarWidth, 44100/2);
-    m_sigL.resize(m_fftlen);
-    m_sigR.resize(m_fftlen);
 
     m_rectsL.resize( m_scale.range() );
     m_rectsR.resize( m_scale.range() );
@@ -1468,9 +1472,6 @@ void Spectrum::resize(const QSize &newsize)
     m_scaleFactor = m_size.height() / 2.0F / 42.0F;
 }
 
-// this moved up to Spectrogram so both can use it
-// template<typename T> T sq(T a) { return a*a; };
-
 bool Spectrum::process(VisualNode */*node*/)
 {
     return false;
@@ -1478,50 +1479,10 @@ bool Spectrum::process(VisualNode */*node*/)
 
 bool Spectrum::processUndisplayed(VisualNode *node)
 {
-    // copied from Spectrogram for better FFT window
-
-    if (node)     // shift previous samples left, then append new node
-    {
-        // LOG(VB_PLAYBACK, LOG_DEBUG, QString("SG got %1 samples").arg(node->m_length));
-        int i = std::min((int)(node->m_length), m_fftlen);
-        int start = m_fftlen - i;
-        float mult = 0.8F;      // decay older sound by this much
-        for (int k = 0; k < start; k++)
-        {                       // prior set ramps from mult to 1.0
-            if (k > start - i && start > i)
-            {
-                mult = mult + ((1 - mult) *
-                    (1 - ((float)(start - k) / (float)(start - i))));
-            }
-            m_sigL[k] = mult * m_sigL[i + k];
-            m_sigR[k] = mult * m_sigR[i + k];
-        }
-        for (int k = 0; k < i; k++) // append current samples
-        {
-            m_sigL[start + k] = node->m_left[k] / 32768.0F; // +/- 1 peak-to-peak
-            if (node->m_right)
-                m_sigR[start + k] = node->m_right[k] / 32768.0F;
-        }
-        int end = m_fftlen / 40; // ramp window ends down to zero crossing
-        for (int k = 0; k < m_fftlen; k++)
-        {
-            if (k < end)
-                mult = static_cast<float>(k) / end;
-            else if (k > m_fftlen - end)
-                mult = static_cast<float>(m_fftlen - k) / end;
-            else
-                mult = 1;
-            m_dftL[k] = m_sigL[k] * mult;
-            m_dftR[k] = m_sigR[k] * mult;
-        }
-    }
-    // run the real FFT!
-    m_rdft(m_rdftContext, m_rdftTmp, m_dftL, sizeof(float));
-    m_rdftTmp[1] = m_rdftTmp[m_fftlen];
-    memcpy(m_dftL, m_rdftTmp, m_fftlen * sizeof(float));
-    m_rdft(m_rdftContext, m_rdftTmp, m_dftR, sizeof(float));
-    m_rdftTmp[1] = m_rdftTmp[m_fftlen];
-    memcpy(m_dftR, m_rdftTmp, m_fftlen * sizeof(float));
+    // the same decaying window as Spectrogram, from the AudioAnalyser
+    const AudioAnalysis *analysis = node ? node->analysis() : nullptr;
+    if (!analysis)
+        return false;
 
     QRect *rectspL = m_rectsL.data();
     QRect *rectspR = m_rectsR.data();
@@ -1538,9 +1499,9 @@ bool Spectrum::processUndisplayed(VisualNode *node)
         float tmp = 0;
         for (ptrdiff_t j = prev + 1; j <= index; j++) // log scale!
         {    // for the freqency bins of this pixel, find peak or mean
-            tmp = sq(m_dftL[2 * j]) + sq(m_dftL[(2 * j) + 1]);
+            tmp = analysis->LeftPower(j);
             magL  = tmp > magL  ? tmp : magL;
-            tmp = sq(m_dftR[2 * j]) + sq(m_dftR[(2 * j) + 1]);
+            tmp = analysis->RightPower(j);
             magR = tmp > magR ? tmp : magR;
         }
         magL = 10 * std::log10(magL) * m_scaleFactor;
@@ -1750,13 +1711,11 @@ static class SquaresFactory : public VisFactory
 
 Piano::Piano()
 {
-    // Setup the "magical" audio coefficients
-    // required by the Goetzel Algorithm
+    // Work out the frequency of each key, the magnitudes are
+    // picked out of the spectrum from the AudioAnalyser
 
     LOG(VB_GENERAL, LOG_DEBUG, QString("Piano : Being Initialised"));
 
-    double sample_rate = 44100.0;  // TODO : This should be obtained from gPlayer (likely candidate...)
-
     m_fps = 20; // This is the display frequency.   We're capturing all audio chunks by defining .process_undisplayed() though.
 
     double concert_A   =   440.0;
@@ -1769,16 +1728,7 @@ Piano::Piano()
     for (uint key = 0; key < kPianoNumKeys; key++)
     {
         // This is constant through time
-        m_pianoData[key].coeff = (goertzel_data)(2.0 * cos(2.0 * M_PI * current_freq / sample_rate));
-
-        // Want 20 whole cycles of the current waveform at least
-        double samples_required = sample_rate/current_freq * 20.0;
-        // For the really low notes, 4 updates a second is good enough...
-        // For the high notes, use as many samples as we need in a display_fps
-        samples_required = std::clamp(samples_required,
-                                      sample_rate/(double)m_fps * 0.75,
-                                      sample_rate/4.0);
-        m_pianoData[key].samples_process_before_display_update = (int)samples_required;
+        m_pianoData[key].frequency = (goertzel_data)current_freq;
         m_pianoData[key].is_black_note = false; // Will be put right in .resize()
 
         current_freq *= semi_tone;
@@ -1791,14 +1741,9 @@ void Piano::zero_analysis(void)
 {
     for (uint key = 0; key < kPianoNumKeys; key++)
     {
-        // These get updated continously, and must be stored between chunks of audio data
-        m_pianoData[key].q2 = 0.0F;
-        m_pianoData[key].q1 = 0.0F;
         m_pianoData[key].magnitude = 0.0F;
         m_pianoData[key].max_magnitude_seen =
             (goertzel_data)(kPianoRmsNegligible * kPianoRmsNegligible); // This is a guess - will be quickly overwritten
-
-        m_pianoData[key].samples_processed = 0;
     }
     m_offsetProcessed = 0ms;
 }
@@ -1910,128 +1855,64 @@ bool Piano::process(VisualNode */*node*/)
 
 bool Piano::process_all_types(VisualNode *node, bool /*this_will_be_displayed*/)
 {
-    // Take a bunch of data in *node and break it down into piano key spectrum values
-    // NB: Remember the state data between calls, so as to accumulate more accurate results.
+    // Take the spectrum of the audio up to *node and break it down into piano key spectrum values
+    // NB: The analysis already covers the last 16K samples, fading out the older ones.
     bool allZero = true;
-    uint n = 0;
 
-    if (node)
+    if (!node)
     {
-        piano_audio short_to_bounded = 32768.0F;
-
-        // Detect start of new song (current node more than 10s earlier than already seen)
-        if (node->m_offset + 10s < m_offsetProcessed)
-        {
-            LOG(VB_GENERAL, LOG_DEBUG, QString("Piano : Node offset=%1 too far backwards : NEW SONG").arg(node->m_offset.count()));
-            zero_analysis();
-        }
-
-        // Check whether we've seen this node (more recently than 10secs ago)
-        if (node->m_offset <= m_offsetProcessed)
-        {
-            LOG(VB_GENERAL, LOG_DEBUG, QString("Piano : Already seen node offset=%1, returning without processing").arg(node->m_offset.count()));
-            return allZero; // Nothing to see here - the server can stop if it wants to
-        }
-
-        //LOG(VB_GENERAL, LOG_DEBUG, QString("Piano : Processing node offset=%1, size=%2").arg(node->m_offset).arg(node->m_length));
-        n = node->m_length;
+        LOG(VB_GENERAL, LOG_DEBUG, QString("Hit an empty node, and returning empty-handed"));
+        return allZero; // Nothing to see here - the server can stop if it wants to
+    }
 
-        if (node->m_right) // Preprocess the data into a combined middle channel, if we have stereo data
-        {
-            for (uint i = 0; i < n; i++)
-            {
-                m_audioData[i] = ((piano_audio)node->m_left[i] + (piano_audio)node->m_right[i]) / 2.0F / short_to_bounded;
-            }
-        }
-        else // This is only one channel of data
-        {
-            for (uint i = 0; i < n; i++)
-            {
-                m_audioData[i] = (piano_audio)node->m_left[i] / short_to_bounded;
-            }
-        }
+    // Detect start of new song (current node more than 10s earlier than already seen)
+    if (node->m_offset + 10s < m_offsetProcessed)
+    {
+        LOG(VB_GENERAL, LOG_DEBUG, QString("Piano : Node offset=%1 too far backwards : NEW SONG").arg(node->m_offset.count()));
+        zero_analysis();
     }
-    else
+
+    // Check whether we've seen this node (more recently than 10secs ago)
+    if (node->m_offset <= m_offsetProcessed)
     {
-        LOG(VB_GENERAL, LOG_DEBUG, QString("Hit an empty node, and returning empty-handed"));
+        LOG(VB_GENERAL, LOG_DEBUG, QString("Piano : Already seen node offset=%1, returning without processing").arg(node->m_offset.count()));
         return allZero; // Nothing to see here - the server can stop if it wants to
     }
 
+    const AudioAnalysis *analysis = node->analysis();
+    if (!analysis)
+        return allZero;
+
+    // Divide by the square of the window's gain so that a sine of amplitude A
+    // (samples scaled to +/- 1) gives A^2/4, as the Goertzel filters used to
+    const double semi_tone = pow(2.0, 1.0/12.0);
+    const auto   norm = (goertzel_data)(1.0 / (2.0 * analysis->m_gain * analysis->m_gain));
     for (uint key = 0; key < kPianoNumKeys; key++)
     {
-        goertzel_data coeff = m_pianoData[key].coeff;
-        goertzel_data q2 = m_pianoData[key].q2;
-        goertzel_data q1 = m_pianoData[key].q1;
-
-        for (uint i = 0; i < n; i++)
+        // Peak power within half a semitone of the note
+        double freq = m_pianoData[key].frequency;
+        int first = analysis->FrequencyBin(freq / std::sqrt(semi_tone));
+        int last  = std::max(analysis->FrequencyBin(freq * std::sqrt(semi_tone)), first);
+        goertzel_data magnitude_av = 0.0F;
+        for (int bin = first; bin <= last; bin++)
         {
-            goertzel_data q0 = (coeff * q1) - q2 + m_audioData[i];
-            q2 = q1;
-            q1 = q0;
+            magnitude_av = std::max(magnitude_av,
+                                    (analysis->LeftPower(bin) + analysis->RightPower(bin)) * norm);
         }
-        m_pianoData[key].q2 = q2;
-        m_pianoData[key].q1 = q1;
-
-        m_pianoData[key].samples_processed += n;
 
-        int n_samples = m_pianoData[key].samples_processed;
-
-        // Only do this update if we've processed enough chunks for this key...
-        if (n_samples > m_pianoData[key].samples_process_before_display_update)
+        if (magnitude_av > (goertzel_data)0.01)
         {
-            goertzel_data magnitude2 = (q1*q1) + (q2*q2) - (q1*q2*coeff);
-
-#if 0
-            // This is RMS of signal
-            goertzel_data magnitude_av =
-                sqrt(magnitude2)/(goertzel_data)n_samples; // Should be 0<magnitude_av<.5
-#else
-            // This is pure magnitude of signal
-            goertzel_data magnitude_av =
-                magnitude2/(goertzel_data)n_samples/(goertzel_data)n_samples; // Should be 0<magnitude_av<.25
-#endif
-
-#if 0
-            // Take logs everywhere, and shift up to [0, ??]
-            if(magnitude_av > 0.0F)
-            {
-                magnitude_av = log(magnitude_av);
-            }
-            else
-            {
-                magnitude_av = kPianoMinVol;
-            }
-            magnitude_av -= kPianoMinVol;
-
-            if (magnitude_av < 0.0F)
-            {
-                magnitude_av = 0.0;
-            }
-#endif
-
-            if (magnitude_av > (goertzel_data)0.01)
-            {
-                allZero = false;
-            }
-
-            m_pianoData[key].magnitude = magnitude_av; // Store this for later : We'll do the colours from this...
-            m_pianoData[key].max_magnitude_seen =
-                std::max(m_pianoData[key].max_magnitude_seen, magnitude_av);
-            LOG(VB_GENERAL, LOG_DEBUG, QString("Piano : Updated Key %1 from %2 samples, magnitude=%3")
-                    .arg(key).arg(n_samples).arg(magnitude_av));
-
-            m_pianoData[key].samples_processed = 0; // Reset the counts, now that we've set the magnitude...
-            m_pianoData[key].q1 = (goertzel_data)0.0;
-            m_pianoData[key].q2 = (goertzel_data)0.0;
+            allZero = false;
         }
-    }
 
-    if (node)
-    {
-        // All done now - record that we've done this offset
-        m_offsetProcessed = node->m_offset;
+        m_pianoData[key].magnitude = magnitude_av; // Store this for later : We'll do the colours from this...
+        m_pianoData[key].max_magnitude_seen =
+            std::max(m_pianoData[key].max_magnitude_seen, magnitude_av);
     }
 
+    // All done now - record that we've done this offset
+    m_offsetProcessed = node->m_offset;
+
     return allZero;
 }
 
@@ -26,15 +26,12 @@
 #ifndef __cpp_size_t_suffix
 #include <libmythbase/sizetliteral.h>
 #endif
+#include <libmythtv/audio/audioanalyser.h>
+#include <libmythtv/visualisations/visualrenderer.h>
 
 // MythMusic headers
 #include "constants.h"
 
-#include <complex>
-extern "C" {
-    #include <libavutil/tx.h>
-}
-
 static constexpr uint16_t SAMPLES_DEFAULT_SIZE { 512 };
 
 class MainVisual;
@@ -55,10 +52,18 @@ class VisualNode
         delete [] m_right;
     }
 
+    // the spectrum and beat of these samples, if the visualizer asked for
+    // them and they have been worked out
+    const AudioAnalysis *analysis(void) const
+    {
+        return (m_analysis && m_analysis->IsReady()) ? m_analysis.get() : nullptr;
+    }
+
     short *m_left  {nullptr};
     short *m_right {nullptr};
     unsigned long m_length;
     std::chrono::milliseconds m_offset;
+    AudioAnalysisPtr m_analysis;
 };
 
 class VisualBase
@@ -84,6 +89,8 @@ class VisualBase
     virtual int getDesiredFPS(void) { return m_fps; }
     // Override this if you need the potential of capturing more data than the default
     virtual unsigned long getDesiredSamples(void) { return SAMPLES_DEFAULT_SIZE; }
+    // Override this if you use VisualNode::analysis()
+    virtual bool needsAnalysis(void) { return false; }
     static void drawWarning(QPainter *p, const QColor &back, QSize size, const QString& warning, int fontsize = 28);
 
   protected:
@@ -91,6 +98,36 @@ class VisualBase
     bool m_xscreensaverenable {true};
 };
 
+/// A visualizer that draws its frames on a thread of its own, at a fraction
+/// of the size it is shown at. The UI thread only hands over the samples and
+/// draws the last finished frame scaled up.
+class ThreadedVisual : public VisualBase
+{
+  public:
+    explicit ThreadedVisual(const QString &name);
+    ~ThreadedVisual() override;
+
+    void resize(const QSize &size) override; // VisualBase
+    bool process(VisualNode *node) override; // VisualBase
+    bool draw(QPainter *p, const QColor &back) override; // VisualBase
+
+  protected:
+    // Called on the render thread with the samples of each frame, which are
+    // empty if there were none. Returns false if nothing new was drawn.
+    virtual bool renderFrame(const VisualRenderer::Samples &samples,
+                             QSize size, QImage &image) = 0;
+    // Must be called by the destructor of a derived class, so that nothing
+    // is rendered after its members are gone
+    void stopRendering(void);
+
+    QSize           m_size;
+
+  private:
+    VisualRenderer *m_renderer {nullptr};
+    int             m_scalew   {2};
+    int             m_scaleh   {2};
+};
+
 class VisFactory
 {
   public:
@@ -234,11 +271,11 @@ class Spectrogram : public VisualBase
 
   public:
     Spectrogram(bool hist);
-    ~Spectrogram() override;
+    ~Spectrogram() override = default;
 
     unsigned long getDesiredSamples(void) override;
+    bool needsAnalysis(void) override { return true; }
     void resize(const QSize &size) override; // VisualBase
-    void FFT(VisualNode *node);
     bool processUndisplayed(VisualNode *node) override;
     bool process( VisualNode *node ) override;
     bool draw(QPainter *p, const QColor &back = Qt::black) override;
@@ -253,16 +290,8 @@ class Spectrogram : public VisualBase
     QSize          m_sgsize {1920, 1080}; // picture size
     QSize          m_size;                // displayed size
     MelScale       m_scale;               // Y-axis
-    int            m_fftlen {16 * 1024}; // window width
+    int            m_fftlen {AudioAnalysis::kFFTSize}; // window width
     int            m_color {0};          // color or grayscale
-    QVector<float> m_sigL;               // decaying signal window
-    QVector<float> m_sigR;
-    float*         m_dftL { nullptr }; // real in, complex out
-    float*         m_dftR { nullptr };
-    float*         m_rdftTmp { nullptr };
-    static constexpr float kTxScale { 1.0F };
-    AVTXContext*   m_rdftContext { nullptr };
-    av_tx_fn       m_rdft        { nullptr };
 
 #ifdef __cpp_size_t_suffix
     std::array<int,256Z*6> m_red   {0}; // continuous color spectrum
@@ -286,8 +315,9 @@ class Spectrum : public VisualBase
     
   public:
     Spectrum();
-    ~Spectrum() override;
+    ~Spectrum() override = default;
 
+    bool needsAnalysis(void) override { return true; } // VisualBase
     void resize(const QSize &size) override; // VisualBase
     bool process(VisualNode *node) override; // VisualBase
     bool processUndisplayed(VisualNode *node) override; // VisualBase
@@ -310,15 +340,7 @@ class Spectrum : public VisualBase
     float              m_falloff          {10.0};
     int                m_analyzerBarWidth {6};
 
-    int            m_fftlen {16 * 1024}; // window width
-    QVector<float> m_sigL;               // decaying signal window
-    QVector<float> m_sigR;
-    float*         m_dftL { nullptr }; // real in, complex out
-    float*         m_dftR { nullptr };
-    float*         m_rdftTmp { nullptr };
-    static constexpr float kTxScale { 1.0F };
-    AVTXContext*   m_rdftContext { nullptr };
-    av_tx_fn       m_rdft        { nullptr };
+    int            m_fftlen {AudioAnalysis::kFFTSize}; // window width
 };
 
 class Squares : public Spectrum
@@ -346,7 +368,6 @@ class Piano : public VisualBase
     static constexpr unsigned long kPianoAudioSize { 4096 };
     static constexpr unsigned int  kPianoNumKeys   { 88   };
 
-#define piano_audio float
 #define goertzel_data float
 
     static constexpr double        kPianoRmsNegligible     { .001 };
@@ -355,15 +376,9 @@ class Piano : public VisualBase
     static constexpr double        kPianoKeypressTooLight  { .2   };
 
 struct piano_key_data {
-    goertzel_data q1, q2, coeff, magnitude;
+    goertzel_data frequency, magnitude;
     goertzel_data max_magnitude_seen;
 
-    // This keeps track of the samples processed for each note
-    // Low notes require a lot of samples to be correctly identified
-    // Higher ones are displayed quicker
-    int samples_processed;
-    int samples_process_before_display_update;
-
     bool is_black_note; // These are painted on top of white notes, and have different colouring
 };
 
@@ -378,6 +393,7 @@ struct piano_key_data {
     // These functions are new, since we need to inspect all the data
     bool processUndisplayed(VisualNode *node) override; // VisualBase
     unsigned long getDesiredSamples(void) override; // VisualBase
+    bool needsAnalysis(void) override { return true; } // VisualBase
 
     bool draw(QPainter *p, const QColor &back = Qt::black) override; // VisualBase
 
@@ -397,7 +413,6 @@ struct piano_key_data {
     std::chrono::milliseconds m_offsetProcessed  {0ms};
 
     std::array<piano_key_data,kPianoNumKeys> m_pianoData {};
-    std::array<piano_audio,kPianoAudioSize> m_audioData {};
 
     std::vector<double> m_magnitude;
 };
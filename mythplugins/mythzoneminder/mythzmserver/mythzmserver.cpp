@@ -35,6 +35,9 @@
 // default port to listen on
 static constexpr uint16_t PORT { 6548 };
 
+// number of frames the live view benchmark encodes
+static constexpr int LIVE_BENCHMARK_FRAMES { 1000 };
+
 // default location of zoneminders default config file
 static constexpr const char* ZM_CONFIG { "/etc/zm/zm.conf" };
 
@@ -57,6 +60,7 @@ int main(int argc, char **argv)
 {
     fd_set master;                  // master file descriptor list
     fd_set read_fds;                // temp file descriptor list for select()
+    fd_set write_fds;               // live view sockets with output waiting
     struct sockaddr_in myaddr {};   // server address
     struct sockaddr_in remoteaddr {};// client address
     int fdmax = -1;                 // maximum file descriptor number
@@ -72,6 +76,8 @@ int main(int argc, char **argv)
     std::string logfile;               // log file
     std::string zmconfig = ZM_CONFIG;  // location of zoneminders default config file
     std::string zmoverideconfig = ZM_OVERRIDECONFIG;  // location of zoneminders override config file
+    int benchWidth = 0;             // live view benchmark frame size
+    int benchHeight = 0;
 
     //  Check command line arguments
     for (int argpos = 1; argpos < argc; ++argpos)
@@ -171,6 +177,20 @@ int main(int argc, char **argv)
         {
             debug = true;
         }
+        else if (strcmp(argv[argpos],"-b") == 0 ||
+                  strcmp(argv[argpos],"--benchmark-live") == 0)
+        {
+            if (argc > argpos + 1 &&
+                sscanf(argv[argpos+1], "%5dx%5d", &benchWidth, &benchHeight) == 2)
+            {
+                ++argpos;
+            }
+            else
+            {
+                std::cerr << "Invalid or missing argument to -b/--benchmark-live option\n";
+                return EXIT_INVALID_CMDLINE;
+            }
+        }
         else
         {
             std::cerr << "Invalid argument: " << argv[argpos] << '\n' <<
@@ -181,11 +201,15 @@ int main(int argc, char **argv)
                     "-c or --zmconfig           Location of zoneminders default config file (default is " << ZM_CONFIG << ")\n" <<
                     "-o or --zmoverrideconfig   Location of zoneminders override config file (default is " << ZM_OVERRIDECONFIG << ")\n" <<
                     "-l or --logfile filename   Writes STDERR and STDOUT messages to filename\n" <<
-                    "-v or --verbose            Prints more debug output\n";
+                    "-v or --verbose            Prints more debug output\n" <<
+                    "-b or --benchmark-live WxH Measures live view encoding of a fake monitor and exits\n";
             return EXIT_INVALID_CMDLINE;
         }
     }
 
+    if (benchWidth > 0)
+        return ZMServer::runLiveBenchmark(benchWidth, benchHeight, LIVE_BENCHMARK_FRAMES);
+
     // set up log file
     int logfd = -1;
 
@@ -309,18 +333,35 @@ int main(int argc, char **argv)
     // main loop
     while (!quit)
     {
-        // the maximum time select() should wait
+        // the maximum time select() should wait, live view needs to check
+        // for new frames more often
         struct timeval timeout {.tv_sec=DB_CHECK_TIME.count(), .tv_usec=0};
 
+        bool live = false;
+        FD_ZERO(&write_fds); // NOLINT(readability-isolate-declaration)
+        for (auto & server : serverList)
+        {
+            if (!server.second->isLive())
+                continue;
+            live = true;
+            if (server.second->hasPendingOutput())
+                FD_SET(server.first, &write_fds);
+        }
+        if (live)
+        {
+            timeout.tv_sec = 0;
+            timeout.tv_usec = std::chrono::microseconds(LIVE_POLL_TIME).count();
+        }
+
         read_fds = master; // copy it
-        int res = select(fdmax+1, &read_fds, nullptr, nullptr, &timeout);
+        int res = select(fdmax+1, &read_fds, &write_fds, nullptr, &timeout);
 
         if (res == -1)
         {
             perror("select");
             return EXIT_SOCKET_ERROR;
         }
-        if (res == 0)
+        if (res == 0 && !live)
         {
             // select timed out
             // just kick the DB connection to keep it alive
@@ -393,6 +434,16 @@ int main(int argc, char **argv)
                 }
             }
         }
+
+        // push any new frames to the live view clients
+        for (auto & server : serverList)
+        {
+            if (!server.second->isLive())
+                continue;
+            if (FD_ISSET(server.first, &write_fds))
+                server.second->flushLive();
+            server.second->pollLive();
+        }
     }
 
     // cleanly remove all the ZMServer's
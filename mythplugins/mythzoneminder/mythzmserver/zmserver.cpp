@@ -38,7 +38,7 @@ static constexpr int MSG_NOSIGNAL { 0 };  // Apple also has SO_NOSIGPIPE?
 #include "zmserver.h"
 
 // the version of the protocol we understand
-static constexpr const char* ZM_PROTOCOL_VERSION { "11" };
+static constexpr const char* ZM_PROTOCOL_VERSION { "12" };
 
 static inline void ADD_STR(std::string& list, const std::string& s)
 { list += s; list += "[]:[]"; };
@@ -55,6 +55,7 @@ static constexpr const char* ERROR_INVALID_POINTERS { "Cannot get shared memory
 static constexpr const char* ERROR_INVALID_MONITOR_FUNCTION  { "Invalid Monitor Function" };
 static constexpr const char* ERROR_INVALID_MONITOR_ENABLE_VALUE { "Invalid Monitor Enable Value" };
 static constexpr const char* ERROR_NO_FRAMES         { "No frames found for event" };
+static constexpr const char* ERROR_LIVE_SUBSCRIBED   { "Already subscribed to live frames" };
 
 // Subpixel ordering (from zm_rgb.h)
 // Based on byte order naming. For example, for ARGB (on both little endian or big endian)
@@ -220,40 +221,10 @@ void kickDatabase(bool debug)
 
 void MONITOR::initMonitor(bool debug, const std::string &mmapPath, int shmKey)
 {
-    size_t shared_data_size = 0;
-    size_t frame_size = static_cast<size_t>(m_width) * m_height * m_bytesPerPixel;
-
     if (!m_enabled)
         return;
 
-    if (checkVersion(1, 34, 0))
-    {
-        shared_data_size = sizeof(SharedData34) +
-            sizeof(TriggerData26) +
-            ((m_imageBufferCount) * (sizeof(struct timeval))) +
-            ((m_imageBufferCount) * frame_size) + 64;
-    }
-    else if (checkVersion(1, 32, 0))
-    {
-        shared_data_size = sizeof(SharedData32) +
-            sizeof(TriggerData26) +
-            ((m_imageBufferCount) * (sizeof(struct timeval))) +
-            ((m_imageBufferCount) * frame_size) + 64;
-    }
-    else if (checkVersion(1, 26, 0))
-    {
-        shared_data_size = sizeof(SharedData26) +
-            sizeof(TriggerData26) +
-            ((m_imageBufferCount) * (sizeof(struct timeval))) +
-            ((m_imageBufferCount) * frame_size) + 64;
-    }
-    else
-    {
-        shared_data_size = sizeof(SharedData) +
-            sizeof(TriggerData) +
-            ((m_imageBufferCount) * (sizeof(struct timeval))) +
-            ((m_imageBufferCount) * frame_size);
-    }
+    size_t shared_data_size = getSharedDataSize();
 
 #if _POSIX_MAPPED_FILES > 0L
     /*
@@ -335,6 +306,50 @@ void MONITOR::initMonitor(bool debug, const std::string &mmapPath, int shmKey)
         }
     }
 
+    mapSharedData();
+}
+
+// the size of the shared memory ZM creates for this monitor
+size_t MONITOR::getSharedDataSize(void) const
+{
+    size_t shared_data_size = 0;
+    size_t frame_size = static_cast<size_t>(m_width) * m_height * m_bytesPerPixel;
+
+    if (checkVersion(1, 34, 0))
+    {
+        shared_data_size = sizeof(SharedData34) +
+            sizeof(TriggerData26) +
+            ((m_imageBufferCount) * (sizeof(struct timeval))) +
+            ((m_imageBufferCount) * frame_size) + 64;
+    }
+    else if (checkVersion(1, 32, 0))
+    {
+        shared_data_size = sizeof(SharedData32) +
+            sizeof(TriggerData26) +
+            ((m_imageBufferCount) * (sizeof(struct timeval))) +
+            ((m_imageBufferCount) * frame_size) + 64;
+    }
+    else if (checkVersion(1, 26, 0))
+    {
+        shared_data_size = sizeof(SharedData26) +
+            sizeof(TriggerData26) +
+            ((m_imageBufferCount) * (sizeof(struct timeval))) +
+            ((m_imageBufferCount) * frame_size) + 64;
+    }
+    else
+    {
+        shared_data_size = sizeof(SharedData) +
+            sizeof(TriggerData) +
+            ((m_imageBufferCount) * (sizeof(struct timeval))) +
+            ((m_imageBufferCount) * frame_size);
+    }
+
+    return shared_data_size;
+}
+
+// set the shared data and image pointers from m_shmPtr
+void MONITOR::mapSharedData(void)
+{
     if (checkVersion(1, 34, 0))
     {
         m_sharedData = nullptr;
@@ -592,6 +607,13 @@ ZMServer::~ZMServer()
     m_monitors.clear();
     m_monitorMap.clear();
 
+    if (m_debug && m_liveFrames > 0)
+    {
+        std::cout << "Live view sent " << m_liveFrames << " frames ("
+                  << m_liveKeyFrames << " key), " << m_liveBytes << " bytes for "
+                  << m_liveRawBytes << " bytes of images\n";
+    }
+
     if (m_debug)
         std::cout << "ZMServer destroyed\n";
 }
@@ -621,29 +643,52 @@ void ZMServer::tokenize(const std::string &command, std::vector<std::string> &to
 // returns true if we get a QUIT command from the client
 bool ZMServer::processRequest(char* buf, int nbytes)
 {
-#if 0
-    // first 8 bytes is the length of the following data
-    char len[9];
-    memcpy(len, buf, 8);
-    len[8] = '\0';
-    int dataLen = atoi(len);
-#endif
+    // each request is preceded by 8 bytes giving the length of the data.
+    // A live view client sends its acks without waiting for a reply so
+    // several of them can arrive together, or split across reads.
+    m_inBuffer.append(buf, nbytes);
+
+    bool quit = false;
+    while (!quit && m_inBuffer.size() >= 8)
+    {
+        int dataLen = atoi(m_inBuffer.substr(0, 8).c_str());
+        if (dataLen <= 0)
+        {
+            // not a length we understand, take it all as one request
+            quit = processCommand(m_inBuffer.substr(8));
+            m_inBuffer.clear();
+            break;
+        }
+
+        if (m_inBuffer.size() < 8 + static_cast<size_t>(dataLen))
+            break;
+
+        std::string s = m_inBuffer.substr(8, dataLen);
+        m_inBuffer.erase(0, 8 + static_cast<size_t>(dataLen));
+        quit = processCommand(s);
+    }
 
-    buf[nbytes] = '\0';
-    std::string s(buf+8);
+    return quit;
+}
+
+// returns true if we get a QUIT command from the client
+bool ZMServer::processCommand(const std::string &command)
+{
     std::vector<std::string> tokens;
-    tokenize(s, tokens);
+    tokenize(command, tokens);
 
     if (tokens.empty())
         return false;
 
-    if (m_debug)
+    if (m_debug && tokens[0] != "LIVE_ACK")
         std::cout << "Processing: '" << tokens[0] << "'\n";
 
     if (tokens[0] == "HELLO")
         handleHello();
     else if (tokens[0] == "QUIT")
         return true;
+    else if (tokens[0] == "LIVE_ACK")
+        handleLiveAck(tokens);
     else if (tokens[0] == "GET_SERVER_STATUS")
         handleGetServerStatus();
     else if (tokens[0] == "GET_MONITOR_STATUS")
@@ -660,6 +705,8 @@ bool ZMServer::processRequest(char* buf, int nbytes)
         handleGetAnalysisFrame(tokens);
     else if (tokens[0] == "GET_LIVE_FRAME")
         handleGetLiveFrame(tokens);
+    else if (tokens[0] == "SUBSCRIBE_LIVE")
+        handleSubscribeLive(tokens);
     else if (tokens[0] == "GET_FRAME_LIST")
         handleGetFrameList(tokens);
     else if (tokens[0] == "GET_CAMERA_LIST")
@@ -680,8 +727,13 @@ bool ZMServer::processRequest(char* buf, int nbytes)
     return false;
 }
 
-bool ZMServer::send(const std::string &s) const
+bool ZMServer::send(const std::string &s)
 {
+    // a live view connection is non blocking, everything goes through
+    // the output buffer
+    if (m_live)
+        return queueSend(s);
+
     // send length
     std::string str = "0000000" + std::to_string(s.size());
     str.erase(0, str.size()-8);
@@ -694,8 +746,11 @@ bool ZMServer::send(const std::string &s) const
     return status != -1;
 }
 
-bool ZMServer::send(const std::string &s, const unsigned char *buffer, int dataLen) const
+bool ZMServer::send(const std::string &s, const unsigned char *buffer, int dataLen)
 {
+    if (m_live)
+        return queueSend(s, buffer, dataLen);
+
     // send length
     std::string str = "0000000" + std::to_string(s.size());
     str.erase(0, str.size()-8);
@@ -1445,6 +1500,292 @@ void ZMServer::handleGetLiveFrame(std::vector<std::string> tokens)
     send(outStr, s_buffer.data(), dataSize);
 }
 
+// SUBSCRIBE_LIVE window monitorID [monitorID ...]
+//
+// Turns this connection over to live view. From now on the client only
+// sends LIVE_ACK's and the server pushes a LIVE_FRAME whenever one of the
+// monitors has written a new frame, as long as fewer than 'window' frames
+// are waiting to be acked. A client that stops acking, or can't keep up
+// with the socket, simply misses frames: only the latest is ever sent.
+void ZMServer::handleSubscribeLive(std::vector<std::string> tokens)
+{
+    if (tokens.size() < 3)
+    {
+        sendError(ERROR_TOKEN_COUNT);
+        return;
+    }
+
+    if (m_live)
+    {
+        sendError(ERROR_LIVE_SUBSCRIBED);
+        return;
+    }
+
+    std::vector<LiveSubscription> subs;
+    for (size_t i = 2; i < tokens.size(); i++)
+    {
+        int monitorID = atoi(tokens[i].c_str());
+        if (!m_monitorMap.contains(monitorID))
+        {
+            sendError(ERROR_INVALID_MONITOR);
+            return;
+        }
+
+        MONITOR *monitor = m_monitorMap[monitorID];
+        if (!monitor->isValid())
+        {
+            sendError(ERROR_INVALID_POINTERS);
+            return;
+        }
+
+        // always start with the current frame
+        monitor->m_lastRead = -1;
+        LiveSubscription sub;
+        sub.m_monitor = monitor;
+        subs.push_back(sub);
+    }
+
+    std::string outStr;
+    ADD_STR(outStr, "OK");
+    ADD_INT(outStr, static_cast<int>(subs.size()));
+    if (!send(outStr))
+        return;
+
+    int flags = fcntl(m_sock, F_GETFL, 0);
+    if (flags == -1 || fcntl(m_sock, F_SETFL, flags | O_NONBLOCK) == -1)
+    {
+        perror("fcntl");
+        return;
+    }
+
+    m_liveSubs = subs;
+    m_liveWindow = std::max(1, atoi(tokens[1].c_str()));
+    m_liveCredits = m_liveWindow;
+    m_liveNext = 0;
+    m_live = true;
+
+    if (m_debug)
+    {
+        std::cout << "Live view of " << m_liveSubs.size() << " monitors with a window of "
+                  << m_liveWindow << " frames\n";
+    }
+}
+
+// LIVE_ACK count
+void ZMServer::handleLiveAck(std::vector<std::string> tokens)
+{
+    // there is no reply, the client isn't waiting for one
+    if (!m_live || tokens.size() != 2)
+        return;
+
+    m_liveCredits = std::min(m_liveWindow, m_liveCredits + std::max(0, atoi(tokens[1].c_str())));
+}
+
+bool ZMServer::queueSend(const std::string &s, const unsigned char *buffer, int dataLen)
+{
+    std::string str = "0000000" + std::to_string(s.size());
+    str.erase(0, str.size()-8);
+
+    m_outBuffer += str;
+    m_outBuffer += s;
+    if (buffer && dataLen > 0)
+        m_outBuffer.append(reinterpret_cast<const char*>(buffer), dataLen);
+
+    flushLive();
+    return m_live;
+}
+
+// send as much of the output buffer as the socket will take, returns true
+// if it is now empty
+bool ZMServer::flushLive(void)
+{
+    while (m_outPos < m_outBuffer.size())
+    {
+        ssize_t status = ::send(m_sock, m_outBuffer.data() + m_outPos,
+                                m_outBuffer.size() - m_outPos, MSG_NOSIGNAL);
+        if (status == -1)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                return false;
+
+            // the connection has gone, the main loop will clean up
+            m_live = false;
+            m_liveSubs.clear();
+            m_outBuffer.clear();
+            m_outPos = 0;
+            return false;
+        }
+        m_outPos += status;
+    }
+
+    m_outBuffer.clear();
+    m_outPos = 0;
+    return true;
+}
+
+void ZMServer::pollLive(void)
+{
+    static FrameData s_buffer {};
+
+    if (!m_live || m_liveSubs.empty())
+        return;
+
+    // the DB connection isn't used by live view, keep it alive anyway
+    kickDatabase(m_debug);
+
+    // start with a different monitor each time so a busy one can't starve
+    // the others of credits
+    size_t count = m_liveSubs.size();
+    for (size_t i = 0; i < count && m_liveCredits > 0; i++)
+    {
+        // don't read anything while the client is still receiving the
+        // last frame, by the time it is ready there may be a newer one
+        if (!flushLive())
+            break;
+
+        LiveSubscription &sub = m_liveSubs[(m_liveNext + i) % count];
+        MONITOR *monitor = sub.m_monitor;
+        int dataSize = getFrame(s_buffer, monitor);
+        if (dataSize == 0)
+            continue;
+
+        bool key = sub.m_encoder.encode(s_buffer.data(), monitor->m_width,
+                                        monitor->m_height, m_liveData);
+        if (!key && sub.m_encoder.changedTiles() == 0 &&
+            sub.m_lastStatus == monitor->m_status)
+        {
+            continue;
+        }
+        sub.m_lastStatus = monitor->m_status;
+
+        std::string outStr;
+        ADD_STR(outStr, "LIVE_FRAME");
+        ADD_INT(outStr, monitor->m_monId);
+        ADD_STR(outStr, monitor->m_status);
+        ADD_STR(outStr, key ? "KEY" : "DELTA");
+        ADD_INT(outStr, monitor->m_width);
+        ADD_INT(outStr, monitor->m_height);
+        ADD_INT(outStr, LIVE_TILE_SIZE);
+        ADD_INT(outStr, static_cast<int>(m_liveData.size()));
+        queueSend(outStr, m_liveData.data(), static_cast<int>(m_liveData.size()));
+
+        m_liveCredits--;
+        m_liveFrames++;
+        m_liveKeyFrames += key ? 1 : 0;
+        m_liveBytes += m_liveData.size();
+        m_liveRawBytes += dataSize;
+    }
+
+    m_liveNext = (m_liveNext + 1) % count;
+}
+
+///////////////////////////////////////////////////////////////////////
+
+// returns true if any channel of the tile at x, y differs from the reference
+// by more than the noise thresholds
+bool LiveEncoder::tileChanged(const unsigned char *frame, int x, int y) const
+{
+    int rowBytes = std::min(LIVE_TILE_SIZE, m_width - x) * 3;
+    int rows = std::min(LIVE_TILE_SIZE, m_height - y);
+    int total = 0;
+    int largest = 0;
+
+    for (int row = 0; row < rows; row++)
+    {
+        size_t offset = ((static_cast<size_t>(y + row) * m_width) + x) * 3;
+        const unsigned char *src = frame + offset;
+        const unsigned char *ref = m_reference.data() + offset;
+        for (int i = 0; i < rowBytes; i++)
+        {
+            int diff = std::abs(src[i] - ref[i]);
+            total += diff;
+            largest = std::max(largest, diff);
+        }
+        if (largest > LIVE_TILE_MAX_DIFF)
+            return true;
+    }
+
+    return total > (rowBytes * rows * LIVE_TILE_MEAN_DIFF);
+}
+
+// append the tile at x, y to out and to the reference
+void LiveEncoder::copyTile(const unsigned char *frame, int x, int y,
+                           std::vector<unsigned char> &out)
+{
+    int rowBytes = std::min(LIVE_TILE_SIZE, m_width - x) * 3;
+    int rows = std::min(LIVE_TILE_SIZE, m_height - y);
+
+    for (int row = 0; row < rows; row++)
+    {
+        size_t offset = ((static_cast<size_t>(y + row) * m_width) + x) * 3;
+        out.insert(out.end(), frame + offset, frame + offset + rowBytes);
+        memcpy(m_reference.data() + offset, frame + offset, rowBytes);
+    }
+}
+
+// returns true if out is a KEY frame, false for a DELTA
+bool LiveEncoder::encode(const unsigned char *frame, int width, int height,
+                         std::vector<unsigned char> &out)
+{
+    size_t frameSize = static_cast<size_t>(width) * height * 3;
+    out.clear();
+    m_changedTiles = 0;
+
+    bool key = m_reference.size() != frameSize || width != m_width ||
+               height != m_height || ++m_sinceKey >= LIVE_KEYFRAME_INTERVAL;
+
+    int tilesX = (width + LIVE_TILE_SIZE - 1) / LIVE_TILE_SIZE;
+    int tilesY = (height + LIVE_TILE_SIZE - 1) / LIVE_TILE_SIZE;
+    int tiles = tilesX * tilesY;
+
+    std::vector<bool> changed;
+    if (!key)
+    {
+        changed.resize(tiles);
+        for (int ty = 0; ty < tilesY; ty++)
+        {
+            for (int tx = 0; tx < tilesX; tx++)
+            {
+                if (tileChanged(frame, tx * LIVE_TILE_SIZE, ty * LIVE_TILE_SIZE))
+                {
+                    changed[(ty * tilesX) + tx] = true;
+                    m_changedTiles++;
+                }
+            }
+        }
+
+        // most of the picture has changed, it's cheaper to send all of it
+        key = m_changedTiles * 100 > tiles * LIVE_MAX_DELTA_PERCENT;
+    }
+
+    if (key)
+    {
+        m_width = width;
+        m_height = height;
+        m_sinceKey = 0;
+        m_changedTiles = tiles;
+        m_reference.assign(frame, frame + frameSize);
+        out.assign(frame, frame + frameSize);
+        return true;
+    }
+
+    out.resize((tiles + 7) / 8, 0);
+    for (int tile = 0; tile < tiles; tile++)
+        if (changed[tile])
+            out[tile / 8] |= static_cast<unsigned char>(1 << (tile % 8));
+
+    for (int tile = 0; tile < tiles; tile++)
+    {
+        if (changed[tile])
+        {
+            copyTile(frame, (tile % tilesX) * LIVE_TILE_SIZE,
+                     (tile / tilesX) * LIVE_TILE_SIZE, out);
+        }
+    }
+
+    return false;
+}
+
 void ZMServer::handleGetFrameList(std::vector<std::string> tokens)
 {
     std::string eventID;
@@ -2129,3 +2470,99 @@ void ZMServer::zmaControl(MONITOR *monitor, const std::string &mode)
                 runCommand(g_binPath + "/zmdc.pl stop zmf -m " + monitor->getIdStr());
     }
 }
+
+// Measure live view encoding against a fake 32 bit monitor whose shared
+// memory ring is filled with a noisy background and a moving box
+int ZMServer::runLiveBenchmark(int width, int height, int frames)
+{
+    static FrameData s_buffer {};
+    static constexpr int kImageBufferCount { 10 };
+    static constexpr int kBoxSize { 64 };
+
+    if (width < kBoxSize || height < kBoxSize ||
+        static_cast<size_t>(width) * height * 3 > MAX_IMAGE_SIZE || frames < 1)
+    {
+        std::cout << "Invalid live benchmark size\n";
+        return 1;
+    }
+
+    if (g_majorVersion == 0)
+    {
+        g_majorVersion = 1;
+        g_minorVersion = 34;
+        g_revisionVersion = 16;
+    }
+
+    MONITOR monitor;
+    monitor.m_enabled = 1;
+    monitor.m_width = width;
+    monitor.m_height = height;
+    monitor.m_bytesPerPixel = 4;
+    monitor.m_imageBufferCount = kImageBufferCount;
+
+    // room for the VideoStoreData and alignment ZM adds in front of the images
+    size_t sharedSize = monitor.getSharedDataSize() + sizeof(VideoStoreData) + 64;
+    std::vector<uint64_t> shared((sharedSize / sizeof(uint64_t)) + 1, 0);
+    monitor.m_shmPtr = shared.data();
+    monitor.mapSharedData();
+
+    int imageSize = width * height * 4;
+    auto *sharedData = reinterpret_cast<SharedData34*>(shared.data());
+    sharedData->format = ZM_SUBPIX_ORDER_RGBA;
+    sharedData->imagesize = imageSize;
+    sharedData->state = IDLE;
+
+    // ZM never reports the last slot (see getFrame) so only fill the others
+    unsigned int seed = 1;
+    for (int slot = 0; slot < kImageBufferCount - 1; slot++)
+    {
+        unsigned char *image = monitor.m_sharedImages + (static_cast<ptrdiff_t>(imageSize) * slot);
+        int boxX = (slot * (width - kBoxSize)) / (kImageBufferCount - 2);
+        int boxY = height / 2 - kBoxSize / 2;
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                bool box = x >= boxX && x < boxX + kBoxSize && y >= boxY && y < boxY + kBoxSize;
+                seed = (seed * 1103515245) + 12345;
+                int noise = static_cast<int>((seed >> 16) % 5) - 2;
+                unsigned char *pixel = image + (((static_cast<ptrdiff_t>(y) * width) + x) * 4);
+                pixel[0] = box ? 240 : static_cast<unsigned char>(std::clamp((x * 255 / width) + noise, 0, 255));
+                pixel[1] = box ? 32  : static_cast<unsigned char>(std::clamp((y * 255 / height) + noise, 0, 255));
+                pixel[2] = box ? 32  : static_cast<unsigned char>(std::clamp(128 + noise, 0, 255));
+                pixel[3] = 255;
+            }
+        }
+    }
+
+    LiveEncoder encoder;
+    std::vector<unsigned char> out;
+    uint64_t bytes = 0;
+    uint64_t rawBytes = 0;
+    int keyFrames = 0;
+
+    monitor.m_lastRead = -1;
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++)
+    {
+        sharedData->last_write_index = frame % (kImageBufferCount - 1);
+        int dataSize = getFrame(s_buffer, &monitor);
+        if (dataSize == 0)
+            continue;
+        if (encoder.encode(s_buffer.data(), width, height, out))
+            keyFrames++;
+        bytes += out.size();
+        rawBytes += dataSize;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Live view benchmark " << width << "x" << height << ", "
+              << frames << " frames (" << keyFrames << " key) in "
+              << elapsed.count() << "s: "
+              << (frames / elapsed.count()) << " frames/s, "
+              << (bytes / frames) << " bytes/frame for "
+              << (rawBytes / frames) << " raw bytes/frame\n";
+
+    return 0;
+}
+
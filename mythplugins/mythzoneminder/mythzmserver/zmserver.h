@@ -54,6 +54,9 @@ extern int     g_revisionVersion;
 static constexpr std::chrono::seconds DB_CHECK_TIME { 60s };
 extern TimePoint g_lastDBKick;
 
+// how often subscribed monitors are checked for a new frame
+static constexpr std::chrono::milliseconds LIVE_POLL_TIME { 20ms };
+
 const std::string FUNCTION_MONITOR = "Monitor";
 const std::string FUNCTION_MODECT  = "Modect";
 const std::string FUNCTION_NODECT  = "Nodect";
@@ -263,6 +266,8 @@ class MONITOR
     MONITOR() = default;
 
     void initMonitor(bool debug, const std::string &mmapPath, int shmKey);
+    void mapSharedData(void);
+    size_t getSharedDataSize(void) const;
 
     bool isValid(void);
 
@@ -299,6 +304,50 @@ class MONITOR
     std::string    m_id;
 };
 
+/*
+ * Encodes the live frames of one monitor for one client as deltas against
+ * the image that client already has.
+ *
+ * A KEY frame is the whole RGB24 image. A DELTA frame is a bitmap with one
+ * bit per LIVE_TILE_SIZE square tile (raster order, LSB first) followed by
+ * the RGB24 rows of each tile whose bit is set, clipped at the right and
+ * bottom edges. Tiles that are within the noise thresholds are not sent, the
+ * difference that leaves is flushed by a KEY frame every
+ * LIVE_KEYFRAME_INTERVAL frames.
+ */
+static constexpr int LIVE_TILE_SIZE         { 16 };
+static constexpr int LIVE_TILE_MEAN_DIFF    { 4 };   // average difference per channel
+static constexpr int LIVE_TILE_MAX_DIFF     { 48 };  // largest difference of any channel
+static constexpr int LIVE_KEYFRAME_INTERVAL { 100 };
+static constexpr int LIVE_MAX_DELTA_PERCENT { 60 };  // send a KEY frame instead above this
+
+class LiveEncoder
+{
+  public:
+    bool encode(const unsigned char *frame, int width, int height,
+                std::vector<unsigned char> &out);
+    void forceKeyFrame(void) { m_reference.clear(); }
+    int  changedTiles(void) const { return m_changedTiles; }
+
+  private:
+    bool tileChanged(const unsigned char *frame, int x, int y) const;
+    void copyTile(const unsigned char *frame, int x, int y,
+                  std::vector<unsigned char> &out);
+
+    std::vector<unsigned char> m_reference;
+    int            m_width              {0};
+    int            m_height             {0};
+    int            m_sinceKey           {0};
+    int            m_changedTiles       {0};
+};
+
+struct LiveSubscription
+{
+    MONITOR       *m_monitor            {nullptr};
+    LiveEncoder    m_encoder;
+    std::string    m_lastStatus;
+};
+
 class ZMServer
 {
   public:
@@ -307,10 +356,20 @@ class ZMServer
 
     bool processRequest(char* buf, int nbytes);
 
+    // live view subscriptions
+    bool isLive(void) const { return m_live; }
+    bool hasPendingOutput(void) const { return m_outPos < m_outBuffer.size(); }
+    void pollLive(void);
+    bool flushLive(void);
+
+    static int runLiveBenchmark(int width, int height, int frames);
+
   private:
+    bool processCommand(const std::string &command);
+    bool queueSend(const std::string &s, const unsigned char *buffer = nullptr, int dataLen = 0);
     std::string getZMSetting(const std::string &setting) const;
-    bool send(const std::string &s) const;
-    bool send(const std::string &s, const unsigned char *buffer, int dataLen) const;
+    bool send(const std::string &s);
+    bool send(const std::string &s, const unsigned char *buffer, int dataLen);
     void sendError(const std::string &error);
     void getMonitorList(void);
     static int  getFrame(FrameData &buffer, MONITOR *monitor);
@@ -331,6 +390,8 @@ class ZMServer
     void handleGetEventFrame(std::vector<std::string> tokens);
     void handleGetAnalysisFrame(std::vector<std::string> tokens);
     void handleGetLiveFrame(std::vector<std::string> tokens);
+    void handleSubscribeLive(std::vector<std::string> tokens);
+    void handleLiveAck(std::vector<std::string> tokens);
     void handleGetFrameList(std::vector<std::string> tokens);
     void handleDeleteEvent(std::vector<std::string> tokens);
     void handleDeleteEventList(std::vector<std::string> tokens);
@@ -350,6 +411,20 @@ class ZMServer
     std::string          m_analysisFileFormat;
     key_t                m_shmKey;
     std::string          m_mmapPath;
+
+    std::string          m_inBuffer;
+    bool                 m_live               {false};
+    std::vector<LiveSubscription> m_liveSubs;
+    int                  m_liveWindow         {0};
+    int                  m_liveCredits        {0};
+    size_t               m_liveNext           {0};
+    std::vector<unsigned char> m_liveData;
+    std::string          m_outBuffer;
+    size_t               m_outPos             {0};
+    uint64_t             m_liveFrames         {0};
+    uint64_t             m_liveKeyFrames      {0};
+    uint64_t             m_liveBytes          {0};
+    uint64_t             m_liveRawBytes       {0};
 };
 
 
@@ -17,10 +17,11 @@
 
 //zoneminder
 #include "zmclient.h"
+#include "zmlivestream.h"
 #include "zmminiplayer.h"
 
 // the protocol version we understand
-static constexpr const char* ZM_PROTOCOL_VERSION { "11" };
+static constexpr const char* ZM_PROTOCOL_VERSION { "12" };
 
 ZMClient::ZMClient()
     : QObject(nullptr),
@@ -801,6 +802,17 @@ int ZMClient::getLiveFrame(int monitorID, QString &status, FrameData& buffer)
     return imageSize;
 }
 
+// start pushing the live frames of monitors over a connection of their own
+ZMLiveStream *ZMClient::startLiveStream(const QList<int> &monitors)
+{
+    if (!m_bConnected || monitors.isEmpty())
+        return nullptr;
+
+    auto *stream = new ZMLiveStream(m_hostname, m_port, monitors);
+    stream->start();
+    return stream;
+}
+
 void ZMClient::getCameraList(QStringList &cameraList)
 {
     QMutexLocker locker(&m_commandLock);
@@ -16,6 +16,8 @@
 static constexpr size_t MAX_IMAGE_SIZE { 2048ULL * 1536 * 3 };
 using FrameData = std::array<uint8_t,MAX_IMAGE_SIZE>;
 
+class ZMLiveStream;
+
 class MPLUGIN_PUBLIC ZMClient : public QObject
 {
     Q_OBJECT
@@ -48,6 +50,7 @@ class MPLUGIN_PUBLIC ZMClient : public QObject
     void getEventFrame(Event *event, int frameNo, MythImage **image);
     void getAnalyseFrame(Event *event, int frameNo, QImage &image);
     int  getLiveFrame(int monitorID, QString &status, FrameData& buffer);
+    ZMLiveStream *startLiveStream(const QList<int> &monitors);
     void getFrameList(int eventID, std::vector<Frame*> *frameList);
     void deleteEvent(int eventID);
     void deleteEventList(std::vector<Event*> *eventList);
@@ -28,8 +28,10 @@
 // zoneminder
 #include "zmliveplayer.h"
 #include "zmclient.h"
+#include "zmlivestream.h"
 
 static constexpr std::chrono::milliseconds FRAME_UPDATE_TIME { 100ms };  // try to update the frame 10 times a second
+static constexpr std::chrono::milliseconds STREAM_UPDATE_TIME { 40ms };  // frames are pushed, just draw them
 
 ZMLivePlayer::ZMLivePlayer(MythScreenStack *parent, bool isMiniPlayer)
              :MythScreenType(parent, "zmliveview"),
@@ -184,6 +186,8 @@ ZMLivePlayer::~ZMLivePlayer()
 
     delete m_frameTimer;
 
+    stopStream();
+
     ZMClient::get()->setIsMiniPlayerEnabled(true);
 }
 
@@ -346,14 +350,64 @@ void ZMLivePlayer::changePlayerMonitor(int playerNo)
     m_players->at(playerNo - 1)->setMonitor(mon);
     m_players->at(playerNo - 1)->updateCamera();
 
+    startStream();
     m_frameTimer->start(FRAME_UPDATE_TIME);
 }
 
+// ask mythzmserver to push the frames of the monitors on show
+void ZMLivePlayer::startStream(void)
+{
+    stopStream();
+
+    QList<int> monList;
+    for (auto *p : *m_players)
+    {
+        if (!monList.contains(p->getMonitor()->id))
+            monList.append(p->getMonitor()->id);
+    }
+
+    m_stream = ZMClient::get()->startLiveStream(monList);
+}
+
+void ZMLivePlayer::stopStream(void)
+{
+    delete m_stream;
+    m_stream = nullptr;
+}
+
 void ZMLivePlayer::updateFrame()
 {
     static std::array<uint8_t,MAX_IMAGE_SIZE> s_buffer {};
     m_frameTimer->stop();
 
+    // draw whatever has been pushed since last time, if the stream has
+    // failed (an older server?) fall back to asking for each frame
+    if (m_stream && !m_stream->failed())
+    {
+        m_stream->getFrames([this](int monitorID, const QString &status,
+                                   const uchar *buffer, int width, int height)
+        {
+            for (auto *p : *m_players)
+            {
+                Monitor *monitor = p->getMonitor();
+                if (monitor->id != monitorID || monitor->width != width ||
+                    monitor->height != height)
+                {
+                    continue;
+                }
+                if (monitor->status != status)
+                {
+                    monitor->status = status;
+                    p->updateStatus();
+                }
+                p->updateFrame(buffer);
+            }
+        });
+
+        m_frameTimer->start(STREAM_UPDATE_TIME);
+        return;
+    }
+
     // get a list of monitor id's that need updating
     QList<int> monList;
     for (auto *p : *m_players)
@@ -462,6 +516,7 @@ void ZMLivePlayer::setMonitorLayout(int layout, bool restore)
             monitorNo = 1;
     }
 
+    startStream();
     updateFrame();
 }
 
@@ -492,8 +547,9 @@ void Player::updateFrame(const unsigned char* buffer)
 {
     QImage image(buffer, m_monitor.width, m_monitor.height, QImage::Format_RGB888);
 
+    // the buffer is reused for the next frame, possibly by another thread
     MythImage *img = GetMythMainWindow()->GetPainter()->GetFormatImage();
-    img->Assign(image);
+    img->Assign(image.copy());
     m_frameImage->SetImage(img);
     img->DecrRef();
 }
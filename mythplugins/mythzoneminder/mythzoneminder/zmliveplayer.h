@@ -31,6 +31,8 @@
 // mythzoneminder
 #include "zmdefines.h"
 
+class ZMLiveStream;
+
 class Player
 {
   public:
@@ -81,8 +83,11 @@ class ZMLivePlayer : public MythScreenType
     void stopPlayers(void);
     void changePlayerMonitor(int playerNo);
     void changeView(void);
+    void startStream(void);
+    void stopStream(void);
 
     QTimer               *m_frameTimer    {nullptr};
+    ZMLiveStream         *m_stream        {nullptr};
     bool                  m_paused        {false};
     int                   m_monitorLayout {1};
     int                   m_monitorCount  {0};
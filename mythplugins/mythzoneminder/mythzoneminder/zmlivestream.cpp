@@ -0,0 +1,231 @@
+// C++
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <utility>
+
+// MythTV
+#include <libmythbase/mythlogging.h>
+#include <libmythbase/mythsocket.h>
+#include <libmythbase/mythtimer.h>
+
+// zoneminder
+#include "zmclient.h"
+#include "zmlivestream.h"
+
+#define LOC QString("ZMLiveStream: ")
+
+// how long to wait for more frames before sending the acks we have
+static constexpr std::chrono::milliseconds LIVE_IDLE_TIME { 5ms };
+
+ZMLiveStream::ZMLiveStream(QString hostname, uint port, const QList<int> &monitors)
+  : MThread("ZMLiveStream"),
+    m_hostname(std::move(hostname)),
+    m_port(port),
+    m_monitors(monitors),
+    // allow each monitor a frame in flight while the last is drawn
+    m_window(std::max(4, static_cast<int>(monitors.size()) * 2))
+{
+}
+
+ZMLiveStream::~ZMLiveStream(void)
+{
+    stop();
+}
+
+void ZMLiveStream::stop(void)
+{
+    if (isRunning())
+    {
+        m_stop = true;
+        wait();
+    }
+}
+
+bool ZMLiveStream::subscribe(void)
+{
+    m_socket = new MythSocket();
+    if (!m_socket->ConnectToHost(m_hostname, m_port))
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Failed to connect to mythzmserver");
+        return false;
+    }
+
+    QStringList strList("SUBSCRIBE_LIVE");
+    strList << QString::number(m_window);
+    for (int monitorID : std::as_const(m_monitors))
+        strList << QString::number(monitorID);
+
+    if (!m_socket->SendReceiveStringList(strList) || strList.empty() || strList[0] != "OK")
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Server refused live view: %1")
+            .arg(strList.empty() ? QString() : strList[0]));
+        return false;
+    }
+
+    LOG(VB_GENERAL, LOG_INFO, LOC + QString("Streaming %1 monitors").arg(m_monitors.size()));
+    return true;
+}
+
+void ZMLiveStream::run(void)
+{
+    RunProlog();
+
+    if (!subscribe())
+        m_failed = true;
+
+    while (!m_stop && !m_failed)
+    {
+        int acks = 0;
+        {
+            QMutexLocker locker(&m_lock);
+            std::swap(acks, m_acks);
+        }
+
+        if (acks > 0 && !m_socket->WriteStringList({ "LIVE_ACK", QString::number(acks) }))
+        {
+            m_failed = true;
+            break;
+        }
+
+        if (!m_socket->IsDataAvailable())
+        {
+            if (!m_socket->IsConnected())
+            {
+                m_failed = true;
+                break;
+            }
+            std::this_thread::sleep_for(LIVE_IDLE_TIME);
+            continue;
+        }
+
+        if (!readFrame())
+            m_failed = true;
+    }
+
+    if (m_failed)
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Live view stream lost");
+
+    if (m_socket)
+    {
+        m_socket->DisconnectFromHost();
+        m_socket->DecrRef();
+        m_socket = nullptr;
+    }
+
+    RunEpilog();
+}
+
+// LIVE_FRAME monitorID status encoding width height tileSize dataSize
+bool ZMLiveStream::readFrame(void)
+{
+    QStringList strList;
+    if (!m_socket->ReadStringList(strList) || strList.size() < 8 || strList[0] != "LIVE_FRAME")
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Unexpected message from mythzmserver");
+        return false;
+    }
+
+    int monitorID = strList[1].toInt();
+    bool key      = strList[3] == "KEY";
+    int width     = strList[4].toInt();
+    int height    = strList[5].toInt();
+    int tileSize  = strList[6].toInt();
+    int dataSize  = strList[7].toInt();
+
+    if (width < 1 || height < 1 || tileSize < 1 || dataSize < 0 ||
+        static_cast<size_t>(width) * height * 3 > MAX_IMAGE_SIZE)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Invalid live frame");
+        return false;
+    }
+
+    std::vector<unsigned char> data(dataSize);
+    if (!readData(data.data(), dataSize))
+        return false;
+
+    QMutexLocker locker(&m_lock);
+    m_received++;
+
+    LiveImage &image = m_images[monitorID];
+    if (key)
+    {
+        if (static_cast<size_t>(dataSize) != static_cast<size_t>(width) * height * 3)
+        {
+            LOG(VB_GENERAL, LOG_ERR, LOC + "Invalid live key frame");
+            return false;
+        }
+        image.m_rgb = std::move(data);
+        image.m_width = width;
+        image.m_height = height;
+    }
+    else if (image.m_width != width || image.m_height != height ||
+             !applyDelta(image, data, tileSize))
+    {
+        // nothing to apply it to, wait for the next key frame
+        image.m_width = 0;
+        LOG(VB_GENERAL, LOG_WARNING, LOC + QString("Dropped delta frame for monitor %1")
+            .arg(monitorID));
+        return true;
+    }
+
+    image.m_status = strList[2];
+    image.m_new = true;
+    return true;
+}
+
+bool ZMLiveStream::readData(unsigned char *data, int dataSize)
+{
+    MythTimer timer;
+    timer.start();
+
+    while (dataSize > 0)
+    {
+        int sret = m_socket->Read(reinterpret_cast<char*>(data), dataSize, 100ms);
+        if (sret > 0)
+        {
+            data += sret;
+            dataSize -= sret;
+            timer.start();
+        }
+        else if (sret < 0 || !m_socket->IsConnected() || timer.elapsed() > 10s || m_stop)
+        {
+            LOG(VB_GENERAL, LOG_ERR, LOC + "Failed to read live frame data");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// copy the tiles a DELTA frame carries into the image
+bool ZMLiveStream::applyDelta(LiveImage &image, const std::vector<unsigned char> &data, int tileSize)
+{
+    int tilesX = (image.m_width + tileSize - 1) / tileSize;
+    int tilesY = (image.m_height + tileSize - 1) / tileSize;
+    int tiles  = tilesX * tilesY;
+    size_t pos = (static_cast<size_t>(tiles) + 7) / 8;
+    if (data.size() < pos)
+        return false;
+
+    for (int tile = 0; tile < tiles; tile++)
+    {
+        if (!(data[tile / 8] & (1 << (tile % 8))))
+            continue;
+
+        int x = (tile % tilesX) * tileSize;
+        int y = (tile / tilesX) * tileSize;
+        size_t rowBytes = static_cast<size_t>(std::min(tileSize, image.m_width - x)) * 3;
+        int rows = std::min(tileSize, image.m_height - y);
+        if (data.size() < pos + (rowBytes * rows))
+            return false;
+
+        for (int row = 0; row < rows; row++, pos += rowBytes)
+        {
+            size_t offset = ((static_cast<size_t>(y + row) * image.m_width) + x) * 3;
+            memcpy(image.m_rgb.data() + offset, data.data() + pos, rowBytes);
+        }
+    }
+
+    return pos == data.size();
+}
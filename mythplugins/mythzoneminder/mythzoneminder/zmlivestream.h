@@ -0,0 +1,85 @@
+#ifndef ZMLIVESTREAM_H
+#define ZMLIVESTREAM_H
+
+// C++
+#include <vector>
+
+// Qt
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+
+// MythTV
+#include <libmythbase/mthread.h>
+
+class MythSocket;
+
+/*
+ * Receives the live frames of a set of monitors over a connection of its
+ * own, which mythzmserver pushes frames down as the monitors write them
+ * (see SUBSCRIBE_LIVE in zmserver.cpp).
+ *
+ * The server stops sending once 'window' frames are unacknowledged. They are
+ * acknowledged by getFrames(), so a player that stops asking for frames stops
+ * the stream, and one that can't keep up only ever sees the latest frame.
+ */
+class ZMLiveStream : public MThread
+{
+  public:
+    ZMLiveStream(QString hostname, uint port, const QList<int> &monitors);
+    ~ZMLiveStream(void) override;
+
+    void stop(void);
+    bool failed(void) const { return m_failed; }
+
+    // calls back with every monitor that has a new frame since the last
+    // call, the image is RGB24 and only valid during the call
+    template <typename Callback>
+    void getFrames(Callback callback)
+    {
+        QMutexLocker locker(&m_lock);
+        for (auto it = m_images.begin(); it != m_images.end(); ++it)
+        {
+            if (!it->m_new)
+                continue;
+            it->m_new = false;
+            callback(it.key(), it->m_status, it->m_rgb.data(), it->m_width, it->m_height);
+        }
+        m_acks += m_received;
+        m_received = 0;
+    }
+
+  protected:
+    void run(void) override; // MThread
+
+  private:
+    struct LiveImage
+    {
+        std::vector<unsigned char> m_rgb;
+        int     m_width  {0};
+        int     m_height {0};
+        QString m_status;
+        bool    m_new    {false};
+    };
+
+    bool subscribe(void);
+    bool readFrame(void);
+    bool readData(unsigned char *data, int dataSize);
+    static bool applyDelta(LiveImage &image, const std::vector<unsigned char> &data, int tileSize);
+
+    QString             m_hostname;
+    uint                m_port;
+    QList<int>          m_monitors;
+    int                 m_window          {0};
+    MythSocket         *m_socket          {nullptr};
+    volatile bool       m_stop            {false};
+    volatile bool       m_failed          {false};
+
+    QMutex              m_lock;
+    QMap<int, LiveImage> m_images;        // protected by m_lock
+    int                 m_received        {0}; // protected by m_lock
+    int                 m_acks            {0}; // protected by m_lock
+};
+
+#endif // ZMLIVESTREAM_H
@@ -95,6 +95,7 @@ void ZMMiniPlayer::customEvent (QEvent* event)
                 {
                     m_players->at(0)->setMonitor(mon);
                     m_players->at(0)->updateCamera();
+                    startStream();
                 }
 
                 m_frameTimer->start(FRAME_UPDATE_TIME);
@@ -12,7 +12,7 @@
 #-----------------------
 __title__ = "TheMovieDB.org V3"
 __author__ = "Raymond Wagner, Roland Ernst"
-__version__ = "0.3.12"
+__version__ = "0.3.13"
 # 0.1.0 Initial version
 # 0.2.0 Add language support, move cache to home directory
 # 0.3.0 Enable version detection to allow use in MythTV
@@ -33,6 +33,7 @@ __version__ = "0.3.12"
 # 0.3.10 Use new API for release dates for movies
 # 0.3.11 Allow queries for specials in series in TV lookup
 # 0.3.12 `buildMovieList` searches now for movies with year
+# 0.3.13 Add --session mode answering several lookups per process
 
 # ~ from optparse import OptionParser
 import sys
@@ -46,6 +47,35 @@ def print_etree(etostr):
 def timeouthandler(signal, frame):
     raise RuntimeError("Timed out")
 
+def runSession(lookup, idletime=300):
+    """Answer lookups read from stdin until it is closed, or until nothing
+    has arrived for idletime seconds. Each lookup is one line holding the
+    command line arguments separated by tabs. The output of each lookup is
+    followed by a line '#END <exit status>'.
+    MythTV sends one lookup at a time and waits for the answer, so a line
+    is never left behind in the stdin buffer when select() is called.
+    """
+    import select
+    while True:
+        ready, _, _ = select.select([sys.stdin], [], [], idletime)
+        if not ready:
+            return 0
+        line = sys.stdin.readline()
+        if not line:
+            return 0
+        try:
+            status = lookup(line.rstrip('\n').split('\t'))
+        except SystemExit as exc:
+            # raised by OptionParser on bad arguments
+            status = exc.code if isinstance(exc.code, int) else 1
+        except Exception:
+            import traceback
+            traceback.print_exc()
+            status = 1
+        signal.alarm(0)
+        sys.stdout.write('\n#END %d\n' % (status or 0))
+        sys.stdout.flush()
+
 def buildSingle(inetref, opts):
     from MythTV.tmdb3.tmdb_exceptions import TMDBRequestInvalid
     from MythTV.tmdb3 import Movie, ReleaseType, get_locale
@@ -503,5 +533,6 @@ def buildVersion(showType, command):
     etree.SubElement(version, "version").text = __version__
     etree.SubElement(version, "accepts").text = 'tmdb.py'
     etree.SubElement(version, "accepts").text = 'tmdb.pl'
+    etree.SubElement(version, "session").text = 'true'
     return etree.tostring(version, encoding='UTF-8', pretty_print=True,
                                     xml_declaration=True)
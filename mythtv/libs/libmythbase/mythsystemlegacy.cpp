@@ -29,6 +29,7 @@
 #include <cerrno>
 #include <csignal> // for kill() and SIGXXX
 #include <cstdlib>
+#include <algorithm>
 #include <cstring>
 #include <fcntl.h>
 #include <unistd.h>
@@ -39,6 +40,7 @@
 #include <QtSystemDetection>
 #endif
 #include <QCoreApplication>
+#include <QMutex>
 
 // libmythbase headers
 #include "referencecounter.h"
@@ -52,6 +54,31 @@
 #include "mythsystemunix.h"
 #endif
 
+static QMutex                     spawnStatsLock;
+static MythSystemLegacySpawnStats spawnStats;
+
+void RecordMythSystemLegacySpawn(std::chrono::microseconds latency,
+                                 bool spawned, bool failed)
+{
+    QMutexLocker locker(&spawnStatsLock);
+    if (failed)
+    {
+        spawnStats.m_failed++;
+        return;
+    }
+    spawnStats.m_launched++;
+    if (spawned)
+        spawnStats.m_spawned++;
+    spawnStats.m_total += latency;
+    spawnStats.m_last = latency;
+    spawnStats.m_max = std::max(spawnStats.m_max, latency);
+}
+
+MythSystemLegacySpawnStats GetMythSystemLegacySpawnStats(void)
+{
+    QMutexLocker locker(&spawnStatsLock);
+    return spawnStats;
+}
 
 /*******************************
  * MythSystemLegacy method defines
@@ -295,6 +322,13 @@ void MythSystemLegacy::Term(bool force)
     d->Term(force);
 }
 
+qint64 MythSystemLegacy::GetPid(void) const
+{
+    if (!d || (m_status != GENERIC_EXIT_RUNNING))
+        return 0;
+    return d->GetPid();
+}
+
 void MythSystemLegacy::Signal(MythSignal sig)
 {
     if (!d)
@@ -59,6 +59,23 @@ using Setting = QMap<QString, bool>;
 
 void MBASE_PUBLIC ShutdownMythSystemLegacy(void);
 
+/// How long launching child processes has taken since startup, from the
+/// call to Run() until the child is running.
+struct MythSystemLegacySpawnStats
+{
+    uint64_t                  m_launched {0}; ///< children started
+    uint64_t                  m_spawned  {0}; ///< of those, by posix_spawn()
+    uint64_t                  m_failed   {0}; ///< launches that failed
+    std::chrono::microseconds m_total    {0us};
+    std::chrono::microseconds m_max      {0us};
+    std::chrono::microseconds m_last     {0us};
+
+    std::chrono::microseconds Average(void) const
+        { return m_launched ? m_total / m_launched : 0us; }
+};
+
+MythSystemLegacySpawnStats MBASE_PUBLIC GetMythSystemLegacySpawnStats(void);
+
 // FIXME: Does MythSystemLegacy really need to inherit from QObject?
 //        we can probably create a private class that inherits
 //        from QObject to avoid exposing lots of thread-unsafe
@@ -103,6 +120,9 @@ class MBASE_PUBLIC MythSystemLegacy : public QObject
     // FIXME: Can Term be wrapped into Signal?
     void Term(bool force = false);
     void Signal(MythSignal sig);
+    /// The process ID of the running command, or 0. With kMSRunShell this
+    /// is the shell, which usually execs the command in its place.
+    qint64 GetPid(void) const;
 
     // FIXME: Should be IsBackground() + documented
     bool isBackground(void)   { return GetSetting("RunInBackground"); }
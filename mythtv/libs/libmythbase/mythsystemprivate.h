@@ -35,6 +35,9 @@ class MythSystemLegacyPrivate : public QObject, public ReferenceCounter
     virtual bool ParseShell(const QString &cmd, QString &abscmd,
                             QStringList &args) = 0;
 
+    /// The process ID of the child, or 0 if it isn't running
+    virtual qint64 GetPid(void) const = 0;
+
   protected:
     // FIXME: QPointer uses global hash & is deprecated for good reason
     QPointer<MythSystemLegacy> m_parent;
@@ -74,4 +77,8 @@ class MythSystemLegacyPrivate : public QObject, public ReferenceCounter
     void readDataReady(int fd);
 };
 
+/// Add a launch taking \a latency to the spawn statistics.
+void RecordMythSystemLegacySpawn(std::chrono::microseconds latency,
+                                 bool spawned, bool failed);
+
 #endif // MYTHSYSTEMPRIVATE_H_
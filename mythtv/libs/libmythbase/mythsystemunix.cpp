@@ -14,12 +14,15 @@
 #include <cstring> // for strerror()
 #include <fcntl.h>
 #include <iostream> // for cerr()
-#include <sys/select.h>
 #include <sys/wait.h>
 #include <thread>
 #include <unistd.h>
 
 // QT headers
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6,5,0)
+#include <QtSystemDetection>
+#endif
 #include <QCoreApplication>
 #include <QMutex>
 #include <QMap>
@@ -33,10 +36,25 @@
 #include "mythlogging.h"
 #include "mythchrono.h"
 
-// Run the IO handler ~100x per second (every 10ms), for ~3MBps throughput
-static constexpr std::chrono::milliseconds kIOHandlerInterval {10ms};
-// Run the Signal handler ~20x per second (every 50ms).
-static constexpr std::chrono::milliseconds kSignalHandlerInterval {50ms};
+#ifdef Q_OS_LINUX
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#else
+#include <poll.h>
+#endif
+
+// posix_spawn() can do all the forked child does but set the priorities
+// from glibc 2.34, without copying the page tables of a large process
+#ifdef __GLIBC__
+#if __GLIBC_PREREQ(2,34)
+#define MYTHSYSTEM_POSIX_SPAWN 1
+#include <spawn.h>
+#endif
+#endif
+
+// Without a pidfd for each child, look for exited children this often
+static constexpr std::chrono::milliseconds kManagerPollInterval {20ms};
 
 struct FDType_t
 {
@@ -70,17 +88,191 @@ static inline void CLOSE(int& fd)
     fd = -1;
 }
 
+/// A descriptor that becomes readable when \a pid exits, or -1 if the
+/// kernel can't make one (before Linux 5.3).
+static int open_pidfd([[maybe_unused]] pid_t pid)
+{
+#if defined(Q_OS_LINUX) && defined(SYS_pidfd_open)
+    int fd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+    if (fd >= 0)
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return fd;
+#else
+    return -1;
+#endif
+}
+
 void ShutdownMythSystemLegacy(void)
 {
     run_system = false;
     if (manager)
+    {
+        manager->wake();
         manager->wait();
+    }
     if (smanager)
+    {
+        smanager->wake();
         smanager->wait();
+    }
     if (readThread)
+    {
+        readThread->wake();
         readThread->wait();
+    }
     if (writeThread)
+    {
+        writeThread->wake();
         writeThread->wait();
+    }
+
+    MythSystemLegacySpawnStats stats = GetMythSystemLegacySpawnStats();
+    LOG(VB_SYSTEM, LOG_INFO,
+        QString("Launched %1 children (%2 spawned, %3 failed), "
+                "average %4 us, longest %5 us")
+        .arg(stats.m_launched).arg(stats.m_spawned).arg(stats.m_failed)
+        .arg(stats.Average().count()).arg(stats.m_max.count()));
+}
+
+MythSystemLegacyPoller::MythSystemLegacyPoller(bool write)
+  : m_write(write)
+{
+#ifdef Q_OS_LINUX
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd[0] = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_epoll < 0 || m_wakeFd[0] < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, "MythSystemLegacyPoller: Failed to create "
+            "epoll instance: " + ENO);
+        return;
+    }
+    epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.fd = m_wakeFd[0];
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeFd[0], &event);
+#else
+    if (pipe(m_wakeFd.data()) == -1)
+    {
+        LOG(VB_GENERAL, LOG_ERR, "MythSystemLegacyPoller: Failed to create "
+            "wake pipe: " + ENO);
+        return;
+    }
+    for (int fd : m_wakeFd)
+    {
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+#endif
+}
+
+MythSystemLegacyPoller::~MythSystemLegacyPoller()
+{
+    for (int fd : m_wakeFd)
+        if (fd >= 0)
+            close(fd);
+    if (m_epoll >= 0)
+        close(m_epoll);
+}
+
+void MythSystemLegacyPoller::add(int fd)
+{
+#ifdef Q_OS_LINUX
+    epoll_event event {};
+    event.events = m_write ? EPOLLOUT : EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) == -1)
+    {
+        LOG(VB_SYSTEM, LOG_ERR,
+            QString("MythSystemLegacyPoller: Failed to watch fd %1: ")
+            .arg(fd) + ENO);
+    }
+#else
+    m_fdLock.lock();
+    m_fds.append(fd);
+    m_fdLock.unlock();
+    wake();
+#endif
+}
+
+void MythSystemLegacyPoller::remove(int fd)
+{
+#ifdef Q_OS_LINUX
+    // Fails harmlessly if the descriptor was closed, that removes it too
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+#else
+    m_fdLock.lock();
+    m_fds.removeAll(fd);
+    m_fdLock.unlock();
+    wake();
+#endif
+}
+
+/// Wait until a descriptor is ready, wake() is called or \a timeout passes,
+/// which is never if it is negative. Returns the ready descriptors.
+QList<int> MythSystemLegacyPoller::wait(std::chrono::milliseconds timeout)
+{
+    QList<int> ready;
+    bool woken = false;
+    int msecs = (timeout < 0ms) ? -1 : static_cast<int>(timeout.count());
+
+#ifdef Q_OS_LINUX
+    std::array<epoll_event,32> events {};
+    int count = epoll_wait(m_epoll, events.data(),
+                           static_cast<int>(events.size()), msecs);
+    for (int i = 0; i < count; ++i)
+    {
+        if (events[i].data.fd == m_wakeFd[0])
+            woken = true;
+        else
+            ready.append(events[i].data.fd);
+    }
+#else
+    std::vector<pollfd> fds;
+    fds.push_back({ m_wakeFd[0], POLLIN, 0 });
+    m_fdLock.lock();
+    for (int fd : std::as_const(m_fds))
+        fds.push_back({ fd, static_cast<short>(m_write ? POLLOUT : POLLIN), 0 });
+    m_fdLock.unlock();
+
+    int count = poll(fds.data(), fds.size(), msecs);
+    for (size_t i = 0; count > 0 && i < fds.size(); ++i)
+    {
+        if (fds[i].revents == 0)
+            continue;
+        if (i == 0)
+            woken = true;
+        else
+            ready.append(fds[i].fd);
+    }
+#endif
+
+    if (count < 0 && errno != EINTR)
+    {
+        LOG(VB_SYSTEM, LOG_ERR, "MythSystemLegacyPoller: wait failed: " + ENO);
+        // Don't spin on a persistent error
+        std::this_thread::sleep_for(kManagerPollInterval);
+    }
+
+    if (woken)
+    {
+        std::array<char,64> drain {};
+        while (read(m_wakeFd[0], drain.data(), drain.size()) > 0) {}
+    }
+    return ready;
+}
+
+void MythSystemLegacyPoller::wake()
+{
+#ifdef Q_OS_LINUX
+    uint64_t one = 1;
+    int fd = m_wakeFd[0];
+#else
+    char one = 1;
+    int fd = m_wakeFd[1];
+#endif
+    // If it is full the waiter is already due to wake
+    if (fd >= 0 && write(fd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+        LOG(VB_SYSTEM, LOG_ERR, "MythSystemLegacyPoller: wake failed: " + ENO);
 }
 
 void MythSystemLegacyIOHandler::run(void)
@@ -89,105 +281,62 @@ void MythSystemLegacyIOHandler::run(void)
     LOG(VB_GENERAL, LOG_INFO, QString("Starting IO manager (%1)")
                 .arg(m_read ? "read" : "write"));
 
-    m_pLock.lock();
-    BuildFDs();
-    m_pLock.unlock();
-
+    // Sleeps until a pipe is ready, new pipes don't need to wake it
     while( run_system )
     {
-        {
-            QMutexLocker locker(&m_pWaitLock);
-            m_pWait.wait(&m_pWaitLock);
-        }
+        QList<int> ready = m_poller.wait();
 
-        while( run_system )
+        QMutexLocker locker(&m_pLock);
+        for (int fd : std::as_const(ready))
         {
-            std::this_thread::sleep_for(kIOHandlerInterval);
-            m_pLock.lock();
-            if( m_pMap.isEmpty() )
-            {
-                m_pLock.unlock();
-                break;
-            }
-
-            timeval tv {.tv_sec=0, .tv_usec=0};
-
-            int retval = -1;
-            fd_set fds = m_fds;
-
+            QBuffer *buffer = m_pMap.value(fd);
+            if (buffer == nullptr)
+                continue;
             if( m_read )
-                retval = select(m_maxfd+1, &fds, nullptr, nullptr, &tv);
+                HandleRead(fd, buffer);
             else
-                retval = select(m_maxfd+1, nullptr, &fds, nullptr, &tv);
-
-            if( retval == -1 )
-            {
-                LOG(VB_SYSTEM, LOG_ERR,
-                    QString("MythSystemLegacyIOHandler: select(%1, %2) failed: %3")
-                        .arg(m_maxfd+1).arg(m_read).arg(strerror(errno)));
-
-            }
-            else if( retval > 0 )
-            {
-                auto it = m_pMap.keyValueBegin();
-                while (it != m_pMap.keyValueEnd())
-                {
-                    auto [fd, buffer] = *it;
-                    ++it;
-                    if( FD_ISSET(fd, &fds) )
-                    {
-                        if( m_read )
-                            HandleRead(fd, buffer);
-                        else
-                            HandleWrite(fd, buffer);
-                    }
-                }
-            }
-            m_pLock.unlock();
+                HandleWrite(fd, buffer);
         }
     }
 
     RunEpilog();
 }
 
-void MythSystemLegacyIOHandler::HandleRead(int fd, QBuffer *buff)
+/// Read what is waiting in pipe \a fd, returns true if there was anything.
+bool MythSystemLegacyIOHandler::HandleRead(int fd, QBuffer *buff)
 {
     errno = 0;
     int len = read(fd, m_readbuf.data(), m_readbuf.size());
     if( len <= 0 )
     {
         if( errno != EAGAIN )
-        {
-            m_pMap.remove(fd);
-            BuildFDs();
-        }
+            Drop(fd);
+        return false;
     }
-    else
-    {
-        buff->buffer().append(m_readbuf.data(), len);
 
-        // Get the corresponding MythSystemLegacy instance, and the stdout/stderr
-        // type
-        fdLock.lock();
-        FDType_t *fdType = fdMap.value(fd);
-        fdLock.unlock();
-        if (fdType == nullptr)
-            return;
-
-        // Emit the data ready signal (1 = stdout, 2 = stderr)
-        MythSystemLegacyUnix *ms = fdType->m_ms;
-        if (ms == nullptr)
-            return;
-        emit ms->readDataReady(fdType->m_type);
-    }
+    buff->buffer().append(m_readbuf.data(), len);
+
+    // Get the corresponding MythSystemLegacy instance, and the stdout/stderr
+    // type
+    fdLock.lock();
+    FDType_t *fdType = fdMap.value(fd);
+    fdLock.unlock();
+    if (fdType == nullptr)
+        return true;
+
+    // Emit the data ready signal (1 = stdout, 2 = stderr)
+    MythSystemLegacyUnix *ms = fdType->m_ms;
+    if (ms == nullptr)
+        return true;
+    emit ms->readDataReady(fdType->m_type);
+    return true;
 }
 
 void MythSystemLegacyIOHandler::HandleWrite(int fd, QBuffer *buff)
 {
     if( buff->atEnd() )
     {
-        m_pMap.remove(fd);
-        BuildFDs();
+        Drop(fd);
         return;
     }
 
@@ -199,14 +348,9 @@ void MythSystemLegacyIOHandler::HandleWrite(int fd, QBuffer *buff)
     if( rlen < 0 )
     {
         if( errno != EAGAIN )
-        {
-            m_pMap.remove(fd);
-            BuildFDs();
-        }
+            Drop(fd);
         else
-        {
             buff->seek(pos);
-        }
     }
     else if( rlen != len )
     {
@@ -218,20 +362,15 @@ void MythSystemLegacyIOHandler::insert(int fd, QBuffer *buff)
 {
     m_pLock.lock();
     m_pMap.insert(fd, buff);
-    BuildFDs();
+    m_poller.add(fd);
     m_pLock.unlock();
-    wake();
 }
 
 void MythSystemLegacyIOHandler::Wait(int fd)
 {
     QMutexLocker locker(&m_pLock);
-    while (m_pMap.contains(fd))
-    {
-        locker.unlock();
-        std::this_thread::sleep_for(10ms);
-        locker.relock();
-    }
+    while (run_system && m_pMap.contains(fd))
+        m_pDropped.wait(&m_pLock);
 }
 
 void MythSystemLegacyIOHandler::remove(int fd)
@@ -239,34 +378,61 @@ void MythSystemLegacyIOHandler::remove(int fd)
     m_pLock.lock();
     if (m_read)
     {
-        PMap_t::iterator i;
-        i = m_pMap.find(fd);
-        if ( i != m_pMap.end() )
-            HandleRead(i.key(), i.value());
+        // Collect everything the child wrote before it exited
+        QBuffer *buffer = m_pMap.value(fd);
+        while (buffer && HandleRead(fd, buffer))
+            buffer = m_pMap.value(fd);
     }
-    m_pMap.remove(fd);
-    BuildFDs();
+    Drop(fd);
     m_pLock.unlock();
 }
 
 void MythSystemLegacyIOHandler::wake()
 {
-    QMutexLocker locker(&m_pWaitLock);
-    m_pWait.wakeAll();
+    m_poller.wake();
+    QMutexLocker locker(&m_pLock);
+    m_pDropped.wakeAll();
 }
 
-void MythSystemLegacyIOHandler::BuildFDs()
+/// Stop watching pipe \a fd. Call with m_pLock held.
+void MythSystemLegacyIOHandler::Drop(int fd)
 {
-    // build descriptor list
-    FD_ZERO(&m_fds); //NOLINT(readability-isolate-declaration)
-    m_maxfd = -1;
+    if (m_pMap.remove(fd))
+        m_poller.remove(fd);
+    m_pDropped.wakeAll();
+}
+
+/// How long until the earliest child timeout, -1 if there is none.
+/// Call with m_mapLock held.
+std::chrono::milliseconds MythSystemLegacyManager::NextTimeout(void)
+{
+    auto wait = -1ms;
+
+    // A child without a pidfd can only be found by polling
+    if (m_pMap.size() > m_pidFds.size())
+        wait = kManagerPollInterval;
 
-    PMap_t::iterator i;
-    for( i = m_pMap.begin(); i != m_pMap.end(); ++i )
+    auto now = SystemClock::now();
+    for (const auto &ms : std::as_const(m_pMap))
     {
-        FD_SET(i.key(), &m_fds);
-        m_maxfd = (i.key() > m_maxfd ? i.key() : m_maxfd);
+        if (!ms || ms->m_timeout.time_since_epoch() <= 0s)
+            continue;
+        auto left = std::max(0ms, duration_cast<std::chrono::milliseconds>(
+                                      ms->m_timeout - now) + 1ms);
+        if (wait < 0ms || left < wait)
+            wait = left;
     }
+    return wait;
+}
+
+/// Call with m_mapLock held.
+void MythSystemLegacyManager::ClosePidFd(pid_t pid)
+{
+    int fd = m_pidFds.take(pid);
+    if (fd <= 0)
+        return;
+    m_poller.remove(fd);
+    close(fd);
 }
 
 void MythSystemLegacyManager::run(void)
@@ -278,11 +444,14 @@ void MythSystemLegacyManager::run(void)
     // exit during shutdown.
     while( run_system )
     {
+        // Sleep until a child exits, a timeout is due, or there is a new
+        // child or abort to look at
         m_mapLock.lock();
-        m_wait.wait(&m_mapLock, m_pMap.isEmpty() ? 100 : 20);
-
-        // check for any running processes
+        auto wait = NextTimeout();
+        m_mapLock.unlock();
+        QList<int> ready = m_poller.wait(wait);
 
+        m_mapLock.lock();
         if( m_pMap.isEmpty() )
         {
             m_mapLock.unlock();
@@ -292,6 +461,7 @@ void MythSystemLegacyManager::run(void)
 
         pid_t pid = 0;
         int   status = 0;
+        bool  reaped = false;
 
         // check for any newly exited processes
         listLock.lock();
@@ -309,7 +479,9 @@ void MythSystemLegacyManager::run(void)
 
             // pop exited process off managed list, add to cleanup list
             MythSystemLegacyUnix *ms = m_pMap.take(pid);
+            ClosePidFd(pid);
             m_mapLock.unlock();
+            reaped = true;
 
             // Occasionally, the caller has deleted the structure from under
             // our feet.  If so, just log and move on.
@@ -435,6 +607,20 @@ void MythSystemLegacyManager::run(void)
         // give the buffer handling a chance to run before
         // being closed down by signal thread
         listLock.unlock();
+
+        if (reaped && smanager)
+            smanager->wake();
+
+        // A pidfd still ready means someone else reaped the child, poll
+        // for it instead of spinning
+        m_mapLock.lock();
+        for (int fd : std::as_const(ready))
+        {
+            pid_t pid = m_pidFds.key(fd, 0);
+            if (pid > 0 && m_pMap.contains(pid))
+                ClosePidFd(pid);
+        }
+        m_mapLock.unlock();
     }
 
     // kick to allow them to close themselves cleanly
@@ -451,8 +637,15 @@ void MythSystemLegacyManager::append(MythSystemLegacyUnix *ms)
     m_mapLock.lock();
     ms->IncrRef();
     m_pMap.insert(ms->m_pid, ms);
-    m_wait.wakeAll();
+    // Called with listLock held, so the child can't have been reaped yet
+    int pidfd = open_pidfd(ms->m_pid);
+    if (pidfd >= 0)
+    {
+        m_pidFds.insert(ms->m_pid, pidfd);
+        m_poller.add(pidfd);
+    }
     m_mapLock.unlock();
+    m_poller.wake();
 
     if (ms->m_stdpipe[0] >= 0)
     {
@@ -493,6 +686,13 @@ void MythSystemLegacyManager::jumpAbort(void)
     m_jumpLock.lock();
     m_jumpAbort = true;
     m_jumpLock.unlock();
+    m_poller.wake();
+}
+
+void MythSystemLegacySignalManager::wake(void)
+{
+    QMutexLocker locker(&listLock);
+    m_wait.wakeAll();
 }
 
 void MythSystemLegacySignalManager::run(void)
@@ -501,7 +701,11 @@ void MythSystemLegacySignalManager::run(void)
     LOG(VB_GENERAL, LOG_INFO, "Starting process signal handler");
     while (run_system)
     {
-        std::this_thread::sleep_for(kSignalHandlerInterval);
+        // Sleep until the process manager has reaped a child
+        listLock.lock();
+        while (run_system && msList.isEmpty())
+            m_wait.wait(&listLock);
+        listLock.unlock();
 
         while (run_system)
         {
@@ -918,13 +1122,23 @@ void MythSystemLegacyUnix::Fork(std::chrono::seconds timeout)
         : SystemClock::time_point();
 
     listLock.lock();
-    pid_t child = fork();
+    auto launch = std::chrono::steady_clock::now();
+    pid_t child = -1;
+    bool spawned = false;
+    if (niceval == 0 && ioprioval == 0)
+    {
+        child = Spawn(cmdUTF8, cmdargs, p_stdin, p_stdout, p_stderr);
+        spawned = (child > 0);
+    }
+    if (!spawned)
+        child = fork();
 
     if (child < 0)
     {
         /* Fork failed, still in parent */
         LOG(VB_SYSTEM, LOG_ERR, "fork() failed: " + ENO);
         SetStatus( GENERIC_EXIT_NOT_OK );
+        RecordMythSystemLegacySpawn(0us, false, true);
         listLock.unlock();
     }
     else if( child > 0 )
@@ -933,14 +1147,20 @@ void MythSystemLegacyUnix::Fork(std::chrono::seconds timeout)
         m_pid = child;
         SetStatus( GENERIC_EXIT_RUNNING );
 
+        auto latency = duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - launch);
+        RecordMythSystemLegacySpawn(latency, spawned, false);
+
         LOG(VB_SYSTEM, LOG_INFO,
                     QString("Managed child (PID: %1) has started! "
-                            "%2%3 command=%4, timeout=%5")
+                            "%2%3 command=%4, timeout=%5, %6 in %7 us")
                         .arg(QString::number(m_pid),
                              GetSetting("UseShell") ? "*" : "",
                              GetSetting("RunInBackground") ? "&" : "",
                              GetLogCmd(),
-                             QString::number(timeout.count())));
+                             QString::number(timeout.count()),
+                             spawned ? "spawned" : "forked",
+                             QString::number(latency.count())));
 
         /* close unused pipe ends */
         if (p_stdin[0] >= 0)
@@ -1154,6 +1374,54 @@ void MythSystemLegacyUnix::Fork(std::chrono::seconds timeout)
     }
 }
 
+/// Launch the child with posix_spawn(), which unlike fork() doesn't copy
+/// our page tables. Returns its PID, or -1 to fork() instead. That includes
+/// a command that can't be run, so it fails just as it always has.
+pid_t MythSystemLegacyUnix::Spawn([[maybe_unused]] const QByteArray &cmd,
+                                  [[maybe_unused]] const std::vector<char*> &args,
+                                  [[maybe_unused]] const std::array<int,2> &p_stdin,
+                                  [[maybe_unused]] const std::array<int,2> &p_stdout,
+                                  [[maybe_unused]] const std::array<int,2> &p_stderr)
+{
+#ifdef MYTHSYSTEM_POSIX_SPAWN
+    posix_spawn_file_actions_t actions {};
+    if (posix_spawn_file_actions_init(&actions) != 0)
+        return -1;
+
+    // The child's end of each pipe, or /dev/null
+    std::array<int,3> ends { p_stdin[0], p_stdout[1], p_stderr[1] };
+    int ret = 0;
+    for (int fd = 0; (fd < 3) && (ret == 0); ++fd)
+    {
+        if (ends[fd] >= 0)
+            ret = posix_spawn_file_actions_adddup2(&actions, ends[fd], fd);
+        else
+            ret = posix_spawn_file_actions_addopen(&actions, fd, "/dev/null",
+                                                   fd ? O_WRONLY : O_RDONLY, 0);
+    }
+    if (ret == 0)
+        ret = posix_spawn_file_actions_addclosefrom_np(&actions, 3);
+
+    QByteArray directory;
+    if (GetSetting("SetDirectory"))
+        directory = GetDirectory().toUtf8();
+    if ((ret == 0) && !directory.isEmpty())
+        ret = posix_spawn_file_actions_addchdir_np(&actions, directory.constData());
+
+    pid_t pid = -1;
+    if (ret == 0)
+        ret = posix_spawn(&pid, cmd.constData(), &actions, nullptr,
+                          args.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (ret == 0)
+        return pid;
+
+    LOG(VB_SYSTEM, LOG_DEBUG, QString("posix_spawn() failed, forking: %1")
+        .arg(strerror(ret)));
+#endif
+    return -1;
+}
+
 void MythSystemLegacyUnix::Manage(void)
 {
 }
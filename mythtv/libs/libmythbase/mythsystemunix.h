@@ -5,8 +5,9 @@
 
 #include <array>
 #include <csignal>
-#include <sys/select.h>
+#include <vector>
 
+#include <QByteArray>
 #include <QObject>
 #include <QString>
 #include <QStringList>
@@ -29,12 +30,36 @@ using MSMap_t  = QMap<pid_t, QPointer<MythSystemLegacyUnix> >;
 using PMap_t   = QMap<int, QBuffer *>;
 using MSList_t = QList<QPointer<MythSystemLegacyUnix> >;
 
+/// Sleeps until one of a set of file descriptors is ready or it is woken,
+/// with epoll on Linux and poll() elsewhere. Descriptors may be added and
+/// removed from any thread while another one waits.
+class MythSystemLegacyPoller
+{
+    public:
+        explicit MythSystemLegacyPoller(bool write = false);
+        ~MythSystemLegacyPoller();
+
+        void       add(int fd);
+        void       remove(int fd);
+        QList<int> wait(std::chrono::milliseconds timeout = -1ms);
+        void       wake();
+
+    private:
+        Q_DISABLE_COPY(MythSystemLegacyPoller)
+
+        bool              m_write  {false};
+        int               m_epoll  {-1};
+        std::array<int,2> m_wakeFd {-1, -1};
+        QMutex            m_fdLock;
+        QList<int>        m_fds;
+};
+
 class MythSystemLegacyIOHandler: public MThread
 {
     public:
         explicit MythSystemLegacyIOHandler(bool read)
             : MThread(QString("SystemIOHandler%1").arg(read ? "R" : "W")),
-              m_read(read) {};
+              m_poller(!read), m_read(read) {};
         ~MythSystemLegacyIOHandler() override { wait(); }
 
         void   insert(int fd, QBuffer *buff);
@@ -46,17 +71,15 @@ class MythSystemLegacyIOHandler: public MThread
         void   run(void) override; // MThread
 
     private:
-        void   HandleRead(int fd, QBuffer *buff);
+        bool   HandleRead(int fd, QBuffer *buff);
         void   HandleWrite(int fd, QBuffer *buff);
-        void   BuildFDs();
+        void   Drop(int fd);
 
-        QMutex          m_pWaitLock;
-        QWaitCondition  m_pWait;
+        MythSystemLegacyPoller m_poller;
         QMutex          m_pLock;
+        QWaitCondition  m_pDropped;
         PMap_t          m_pMap;
 
-        fd_set m_fds   {};
-        int    m_maxfd {-1};
         bool   m_read  {true};
         std::array<char,65536> m_readbuf {};
 };
@@ -71,14 +94,19 @@ class MythSystemLegacyManager : public MThread
         ~MythSystemLegacyManager() override { wait(); }
         void append(MythSystemLegacyUnix *ms);
         void jumpAbort(void);
+        void wake(void) { m_poller.wake(); }
     protected:
         void run(void) override; // MThread
     private:
+        std::chrono::milliseconds NextTimeout(void);
+        void ClosePidFd(pid_t pid);
+
         MSMap_t    m_pMap;
+        QMap<pid_t, int> m_pidFds;
         QMutex     m_mapLock;
         bool       m_jumpAbort {false};
         QMutex     m_jumpLock;
-        QWaitCondition m_wait;
+        MythSystemLegacyPoller m_poller;
 };
 
 class MythSystemLegacySignalManager : public MThread
@@ -87,9 +115,11 @@ class MythSystemLegacySignalManager : public MThread
         MythSystemLegacySignalManager()
             : MThread("SystemSignalManager") {}
         ~MythSystemLegacySignalManager() override { wait(); }
+        void wake(void);
     protected:
         void run(void) override; // MThread
     private:
+        QWaitCondition m_wait;
 };
 
 
@@ -111,11 +141,18 @@ class MBASE_PUBLIC MythSystemLegacyUnix : public MythSystemLegacyPrivate
         bool ParseShell(const QString &cmd, QString &abscmd,
                         QStringList &args) override; // MythSystemLegacyPrivate
 
+        qint64 GetPid(void) const override { return m_pid; } // MythSystemLegacyPrivate
+
         friend class MythSystemLegacyManager;
         friend class MythSystemLegacySignalManager;
         friend class MythSystemLegacyIOHandler;
 
     private:
+        pid_t Spawn(const QByteArray &cmd, const std::vector<char*> &args,
+                    const std::array<int,2> &p_stdin,
+                    const std::array<int,2> &p_stdout,
+                    const std::array<int,2> &p_stderr);
+
         pid_t       m_pid     {0};
         SystemTime  m_timeout {0s};
 
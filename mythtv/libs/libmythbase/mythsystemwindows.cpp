@@ -712,6 +712,7 @@ void MythSystemLegacyWindows::Fork(std::chrono::seconds timeout)
     char pDirChar[256];
     sprintf(pDirChar, "%ls", pDir);
 
+    auto launch = std::chrono::steady_clock::now();
     bool success = CreateProcess( nullptr,
                           sCmdChar,       // command line
                           nullptr,       // process security attributes
@@ -731,12 +732,15 @@ void MythSystemLegacyWindows::Fork(std::chrono::seconds timeout)
                     .arg( LOC_ERR )
                     .arg( dwErr ));
         SetStatus( GENERIC_EXIT_NOT_OK );
+        RecordMythSystemLegacySpawn(0us, false, true);
     }
     else
     {
         /* parent */
         m_child = pi.hProcess;
         SetStatus( GENERIC_EXIT_RUNNING );
+        RecordMythSystemLegacySpawn(duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - launch), false, false);
 
         LOG(VB_SYSTEM, LOG_INFO,
                 QString("Managed child (Handle: %1) has started! "
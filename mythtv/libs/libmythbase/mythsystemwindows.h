@@ -102,6 +102,9 @@ class MBASE_PUBLIC MythSystemLegacyWindows : public MythSystemLegacyPrivate
         bool ParseShell(const QString &cmd, QString &abscmd,
                         QStringList &args) override; // MythSystemLegacyPrivate
 
+        qint64 GetPid(void) const override // MythSystemLegacyPrivate
+            { return m_child ? GetProcessId(m_child) : 0; }
+
         friend class MythSystemLegacyManager;
         friend class MythSystemLegacySignalManager;
         friend class MythSystemLegacyIOHandler;
@@ -190,6 +190,45 @@ class TestMythSystemLegacy: public QObject
 #endif
     }
 
+    static void getpid_while_running(void)
+    {
+        MythSystemLegacy cmd("sleep 1", kMSNone);
+        cmd.Run();
+        QVERIFY(cmd.GetPid() > 0);
+        cmd.Wait();
+        QCOMPARE(cmd.GetPid(), Q_INT64_C(0));
+    }
+
+    static void missing_command_fails(void)
+    {
+        MythSystemLegacy cmd("/nonexistent/mythsystemlegacy_test", kMSNone);
+        Go(cmd);
+        QCOMPARE(cmd.GetStatus(),
+                 static_cast<uint>(GENERIC_EXIT_DAEMONIZING_ERROR));
+    }
+
+    // The manager sleeps until the timeout, rather than polling for it
+    void timeout_kills_child(void)
+    {
+        MythSystemLegacy cmd("sleep 30", kMSNone);
+        cmd.Run(1s);
+        QCOMPARE(cmd.Wait(), static_cast<uint>(GENERIC_EXIT_TIMEOUT));
+        QVERIFY(m_before.msecsTo(QDateTime::currentDateTime()) < 5000);
+    }
+
+    static void spawn_stats_count_launches(void)
+    {
+        MythSystemLegacySpawnStats before = GetMythSystemLegacySpawnStats();
+        MythSystemLegacy cmd("true", kMSNone);
+        Go(cmd);
+        MythSystemLegacySpawnStats after = GetMythSystemLegacySpawnStats();
+        QCOMPARE(after.m_launched, before.m_launched + 1);
+        QVERIFY(after.m_last >= 0us);
+        QVERIFY(after.m_max >= after.m_last);
+        QVERIFY(after.m_total >= before.m_total + after.m_last);
+        QVERIFY(after.Average() <= after.m_max);
+    }
+
     // TODO flags to test
     // TODO kMSAutoCleanup        -- automatically delete if backgrounded
     // TODO kMSDisableUDPListener -- disable MythMessage UDP listener
@@ -1,6 +1,11 @@
+#include <algorithm>
 #include <map>
 
+#include <QDataStream>
+#include <QDateTime>
 #include <QDir>
+#include <QFile>
+#include <QSaveFile>
 #include <QUrl>
 
 #include "libmythbase/mythcorecontext.h"
@@ -11,6 +16,10 @@
 #include "dirscan.h"
 #include "videoutils.h"
 
+static constexpr quint32 kSnapshotMagic   { 0x4d565344 }; // "MVSD"
+static constexpr quint32 kSnapshotVersion { 1 };
+static constexpr qint64  kSnapshotSettle  { 5000 };        // ms
+
 namespace
 {
     class ext_lookup
@@ -41,41 +50,70 @@ namespace
         }
     };
 
-    bool scan_dir(const QString &start_path, DirectoryHandler *handler,
-                  const ext_lookup &ext_settings)
+    /// List a directory, or take its entries from the snapshot if it has
+    /// not been modified since.
+    bool list_dir(const QString &path, DirectorySnapshot *snapshot,
+                  DirectorySnapshot::Entries &entries)
     {
-        QDir d(start_path);
+        QFileInfo info(path);
 
         // Return a fail if directory doesn't exist.
-        if (!d.exists())
+        if (!info.isDir())
             return false;
-        
+
+        qint64 mtime = info.lastModified().toMSecsSinceEpoch();
+        if (snapshot && snapshot->Find(path, mtime, entries))
+            return true;
+
+        QDir d(path);
         d.setFilter(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
         QFileInfoList list = d.entryInfoList();
+
+        entries.clear();
+        entries.reserve(list.size());
+        for (const auto& entry : std::as_const(list))
+            entries.push_back({entry.fileName(), entry.suffix(), entry.isDir()});
+
+        if (snapshot)
+            snapshot->Insert(path, mtime, entries);
+        return true;
+    }
+
+    bool scan_dir(const QString &start_path,
+                  const DirectorySnapshot::Entries &list,
+                  DirectoryHandler *handler, const ext_lookup &ext_settings,
+                  DirectorySnapshot *snapshot)
+    {
         // An empty directory is fine
         if (list.isEmpty())
             return true;
 
-        QDir dir_tester;
+        QDir d(start_path);
 
         for (const auto& entry : std::as_const(list))
         {
-            if (entry.fileName() == "Thumbs.db")
+            if (entry.m_name == "Thumbs.db")
                 continue;
 
-            if (!entry.isDir() &&
-                ext_settings.extension_ignored(entry.suffix())) continue;
+            if (!entry.m_isDir &&
+                ext_settings.extension_ignored(entry.m_suffix)) continue;
 
             bool add_as_file = true;
+            QString fq_name = d.absoluteFilePath(entry.m_name);
 
-            if (entry.isDir())
+            if (entry.m_isDir)
             {
                 add_as_file = false;
 
-                dir_tester.setPath(entry.absoluteFilePath() + "/VIDEO_TS");
-                QDir bd_dir_tester;
-                bd_dir_tester.setPath(entry.absoluteFilePath() + "/BDMV");
-                if (dir_tester.exists() || bd_dir_tester.exists())
+                // Since we are dealing with a subdirectory failure is fine,
+                // so we'll just ignore the failue and continue
+                DirectorySnapshot::Entries sub_list;
+                bool listed = list_dir(fq_name, snapshot, sub_list);
+
+                auto is_disc = [](const DirectorySnapshot::Entry &sub)
+                    { return sub.m_isDir &&
+                             (sub.m_name == "VIDEO_TS" || sub.m_name == "BDMV"); };
+                if (listed && std::any_of(sub_list.cbegin(), sub_list.cend(), is_disc))
                 {
                     add_as_file = true;
                 }
@@ -83,15 +121,13 @@ namespace
                 {
 #if 0
                     LOG(VB_GENERAL, LOG_DEBUG, 
-                        QString(" -- Dir : %1").arg(entry.!absoluteFilePath()));
+                        QString(" -- Dir : %1").arg(fq_name));
 #endif
                     DirectoryHandler *dh =
-                            handler->newDir(entry.fileName(),
-                                            entry.absoluteFilePath());
+                            handler->newDir(entry.m_name, fq_name);
 
-                    // Since we are dealing with a subdirectory failure is fine,
-                    // so we'll just ignore the failue and continue
-                    (void) scan_dir(entry.absoluteFilePath(), dh, ext_settings);
+                    if (listed)
+                        (void) scan_dir(fq_name, sub_list, dh, ext_settings, snapshot);
                 }
             }
 
@@ -99,10 +135,9 @@ namespace
             {
 #if 0
                 LOG(VB_GENERAL, LOG_DEBUG,
-                    QString(" -- File : %1").arg(entry.fileName()));
+                    QString(" -- File : %1").arg(entry.m_name));
 #endif
-                handler->handleFile(entry.fileName(), entry.absoluteFilePath(),
-                                    entry.suffix(), "");
+                handler->handleFile(entry.m_name, fq_name, entry.m_suffix, "");
             }
         }
 
@@ -224,9 +259,113 @@ namespace
     }
 }
 
+bool DirectorySnapshot::Load(const QString &filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != kSnapshotMagic || version != kSnapshotVersion)
+        return false;
+
+    QMutexLocker locker(&m_lock);
+    m_dirs.clear();
+    m_seen.clear();
+    m_reused = 0;
+
+    quint32 count = 0;
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        QString path;
+        Directory dir;
+        quint32 entries = 0;
+        in >> path >> dir.m_mtime >> entries;
+        dir.m_entries.reserve(static_cast<int>(std::min(entries, 100000U)));
+        for (quint32 j = 0; j < entries && in.status() == QDataStream::Ok; ++j)
+        {
+            Entry entry;
+            in >> entry.m_name >> entry.m_suffix >> entry.m_isDir;
+            dir.m_entries.push_back(entry);
+        }
+        m_dirs.insert(path, dir);
+    }
+
+    if (in.status() != QDataStream::Ok)
+    {
+        LOG(VB_GENERAL, LOG_WARNING,
+            QString("Ignoring damaged video directory snapshot %1")
+                .arg(filename));
+        m_dirs.clear();
+        return false;
+    }
+
+    return true;
+}
+
+/// Write the directories seen since Load(), so removed directories are
+/// dropped from the snapshot.
+bool DirectorySnapshot::Save(const QString &filename)
+{
+    QMutexLocker locker(&m_lock);
+
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out << kSnapshotMagic << kSnapshotVersion;
+    out << static_cast<quint32>(m_seen.size());
+    for (const auto &path : std::as_const(m_seen))
+    {
+        const Directory &dir = m_dirs[path];
+        out << path << dir.m_mtime << static_cast<quint32>(dir.m_entries.size());
+        for (const auto &entry : dir.m_entries)
+            out << entry.m_name << entry.m_suffix << entry.m_isDir;
+    }
+
+    return file.commit();
+}
+
+bool DirectorySnapshot::Find(const QString &path, qint64 mtime, Entries &entries)
+{
+    QMutexLocker locker(&m_lock);
+
+    auto dir = m_dirs.constFind(path);
+    if (dir == m_dirs.constEnd() || dir->m_mtime != mtime)
+        return false;
+
+    entries = dir->m_entries;
+    m_seen.insert(path);
+    ++m_reused;
+    return true;
+}
+
+void DirectorySnapshot::Insert(const QString &path, qint64 mtime,
+                               const Entries &entries)
+{
+    QMutexLocker locker(&m_lock);
+
+    // A directory changed within the resolution of the file system time
+    // stamps could change again without its time stamp changing
+    if (mtime > QDateTime::currentMSecsSinceEpoch() - kSnapshotSettle)
+    {
+        m_dirs.remove(path);
+        m_seen.remove(path);
+        return;
+    }
+
+    m_dirs.insert(path, {mtime, entries});
+    m_seen.insert(path);
+}
+
 bool ScanVideoDirectory(const QString &start_path, DirectoryHandler *handler,
         const FileAssociations::ext_ignore_list &ext_disposition,
-        bool list_unknown_extensions)
+        bool list_unknown_extensions, DirectorySnapshot *snapshot)
 {
     ext_lookup extlookup(ext_disposition, list_unknown_extensions);
 
@@ -238,7 +377,9 @@ bool ScanVideoDirectory(const QString &start_path, DirectoryHandler *handler,
             QString("MythVideo::ScanVideoDirectory Scanning (%1)")
                 .arg(start_path));
 
-        if (!scan_dir(start_path, handler, extlookup))
+        DirectorySnapshot::Entries list;
+        if (!list_dir(start_path, snapshot, list) ||
+            !scan_dir(start_path, list, handler, extlookup, snapshot))
         {
             LOG(VB_GENERAL, LOG_ERR,
                 QString("MythVideo::ScanVideoDirectory failed to scan %1")
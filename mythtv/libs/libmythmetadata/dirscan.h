@@ -1,6 +1,12 @@
 #ifndef DIRSCAN_H_
 #define DIRSCAN_H_
 
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
 #include "mythmetaexp.h"
 
 class META_PUBLIC DirectoryHandler
@@ -15,8 +21,47 @@ class META_PUBLIC DirectoryHandler
                             const QString &host) = 0;
 };
 
+/// \brief The entries of the local directories seen by ScanVideoDirectory().
+///
+/// A directory whose modification time has not changed since it was last
+/// listed still has the same entries, so they are taken from the snapshot
+/// instead of listing the directory again. Only the subdirectories are
+/// still looked at, which on a network file system saves most of the
+/// round trips of a rescan. It may be shared by several scans at once.
+class META_PUBLIC DirectorySnapshot
+{
+  public:
+    struct Entry
+    {
+        QString m_name;
+        QString m_suffix;
+        bool    m_isDir {false};
+    };
+    using Entries = QList<Entry>;
+
+    bool Load(const QString &filename);
+    bool Save(const QString &filename);
+
+    bool Find(const QString &path, qint64 mtime, Entries &entries);
+    void Insert(const QString &path, qint64 mtime, const Entries &entries);
+
+    int  GetReusedCount(void) const { return m_reused; }
+
+  private:
+    struct Directory
+    {
+        qint64  m_mtime {0};
+        Entries m_entries;
+    };
+
+    QMutex                     m_lock;
+    QHash<QString, Directory>  m_dirs;
+    QSet<QString>              m_seen;   ///< directories seen since Load()
+    int                        m_reused {0};
+};
+
 META_PUBLIC bool ScanVideoDirectory(const QString &start_path, DirectoryHandler *handler,
         const FileAssociations::ext_ignore_list &ext_disposition,
-        bool list_unknown_extensions);
+        bool list_unknown_extensions, DirectorySnapshot *snapshot = nullptr);
 
 #endif // DIRSCAN_H_
@@ -19,11 +19,11 @@ HEADERS += videoscan.h  videoutils.h  videometadata.h  videometadatalistmanager.
 HEADERS += quicksp.h metadatacommon.h metadatadownload.h metadataimagedownload.h
 HEADERS += bluraymetadata.h mythmetaexp.h metadatafactory.h mythuimetadataresults.h
 HEADERS += mythuiimageresults.h
-HEADERS += musicmetadata.h musicutils.h metaio.h metaiotaglib.h
+HEADERS += musicmetadata.h musictrackindex.h musicutils.h metaio.h metaiotaglib.h
 HEADERS += metaioflacvorbis.h metaioavfcomment.h metaiomp4.h
 HEADERS += metaiowavpack.h metaioid3.h metaiooggopus.h metaiooggvorbis.h
 HEADERS += imagetypes.h imagemetadata.h imagethumbs.h imagescanner.h imagemanager.h
-HEADERS += musicfilescanner.h metadatagrabber.h lyricsdata.h
+HEADERS += musicfilescanner.h metadatagrabber.h metadatagrabbersession.h lyricsdata.h
 
 SOURCES += cleanup.cpp  dbaccess.cpp  dirscan.cpp  globals.cpp
 SOURCES += parentalcontrols.cpp  videoscan.cpp  videoutils.cpp
@@ -31,11 +31,12 @@ SOURCES += videometadata.cpp  videometadatalistmanager.cpp
 SOURCES += metadatacommon.cpp metadatadownload.cpp metadataimagedownload.cpp
 SOURCES += bluraymetadata.cpp metadatafactory.cpp mythuimetadataresults.cpp
 SOURCES += mythuiimageresults.cpp
-SOURCES += musicmetadata.cpp musicutils.cpp metaio.cpp metaiotaglib.cpp
+SOURCES += musicmetadata.cpp musictrackindex.cpp musicutils.cpp metaio.cpp metaiotaglib.cpp
 SOURCES += metaioflacvorbis.cpp metaioavfcomment.cpp metaiomp4.cpp
 SOURCES += metaiowavpack.cpp metaioid3.cpp metaiooggopus.cpp metaiooggvorbis.cpp
 SOURCES += imagemetadata.cpp imagethumbs.cpp imagescanner.cpp imagemanager.cpp
-SOURCES += musicfilescanner.cpp metadatagrabber.cpp lyricsdata.cpp
+SOURCES += musicfilescanner.cpp metadatagrabber.cpp metadatagrabbersession.cpp
+SOURCES += lyricsdata.cpp
 
 INCLUDEPATH += .. ../../external/FFmpeg
 
@@ -86,12 +87,13 @@ inc.files += videoscan.h  videoutils.h  videometadata.h  videometadatalistmanage
 inc.files += quicksp.h metadatacommon.h metadatadownload.h metadataimagedownload.h
 inc.files += bluraymetadata.h mythmetaexp.h metadatafactory.h mythuimetadataresults.h
 inc.files += mythuiimageresults.h metadataimagehelper.h
-inc.files += musicmetadata.h musicutils.h
+inc.files += musicmetadata.h musictrackindex.h musicutils.h
 inc.files += metaio.h metaiotaglib.h
 inc.files += metaioflacvorbis.h metaioavfcomment.h metaiomp4.h
 inc.files += metaiowavpack.h metaioid3.h metaiooggopus.h metaiooggvorbis.h
 inc.files += imagetypes.h imagemetadata.h imagemanager.h
-inc.files += musicfilescanner.h metadatagrabber.h lyricsdata.h
+inc.files += musicfilescanner.h metadatagrabber.h metadatagrabbersession.h
+inc.files += lyricsdata.h
 
 INSTALLS += inc
 
@@ -1,5 +1,7 @@
 // C/C++
+#include <algorithm>
 #include <cstdlib>
+#include <utility>
 
 // qt
 #include <QCoreApplication>
@@ -9,6 +11,7 @@
 #include <QRegularExpression>
 
 // myth
+#include "libmythbase/mythcorecontext.h"
 #include "libmythbase/mythdirs.h"
 #include "libmythbase/mythlogging.h"
 #include "libmythbase/mythmiscutil.h"
@@ -19,6 +22,7 @@
 
 #include "metadatadownload.h"
 #include "metadatafactory.h"
+#include "metadatagrabbersession.h"
 
 const QEvent::Type MetadataLookupEvent::kEventType =
     (QEvent::Type) QEvent::registerEventType();
@@ -43,6 +47,7 @@ void MetadataDownload::addLookup(MetadataLookup *lookup)
 
     m_lookupList.append(lookup);
     lookup->DecrRef();
+    m_lookupDone.wakeAll();
     if (!isRunning())
         start();
 }
@@ -58,6 +63,7 @@ void MetadataDownload::prependLookup(MetadataLookup *lookup)
 
     m_lookupList.prepend(lookup);
     lookup->DecrRef();
+    m_lookupDone.wakeAll();
     if (!isRunning())
         start();
 }
@@ -70,180 +76,241 @@ void MetadataDownload::cancel()
     m_parent = nullptr;
 }
 
+/**
+ * MetadataLookupJob: Runs one queued lookup on the lookup thread pool.
+ */
+class MetadataLookupJob : public QRunnable
+{
+  public:
+    MetadataLookupJob(MetadataDownload *parent,
+                      RefCountHandler<MetadataLookup> lookup)
+      : m_parent(parent), m_lookup(std::move(lookup)) {}
+
+    void run() override // QRunnable
+    {
+        m_parent->processLookup(m_lookup);
+        m_parent->lookupDone();
+    }
+
+  private:
+    MetadataDownload               *m_parent {nullptr};
+    // Owns the MetadataLookup object for the duration of the job
+    RefCountHandler<MetadataLookup> m_lookup;
+};
+
 void MetadataDownload::run()
 {
     RunProlog();
 
-    while (true)
+    // A lookup spends most of its time waiting for a grabber and the site
+    // behind it, so several are run at once.
+    int limit = std::max(1, gCoreContext->GetNumSetting("MetadataLookupThreads", 4));
+    m_pool.setMaxThreadCount(limit);
+
+    m_mutex.lock();
+    while (!m_lookupList.isEmpty() || m_running > 0)
     {
-        m_mutex.lock();
-        if (m_lookupList.isEmpty())
+        if (m_lookupList.isEmpty() || m_running >= limit)
         {
-            // no more to process, we're done
-            m_mutex.unlock();
-            break;
+            // wait for a lookup to be added or to complete
+            m_lookupDone.wait(&m_mutex);
+            continue;
         }
-        // Ref owns the MetadataLookup object for the duration of the loop
-        // and it will be deleted automatically when the loop completes
-        RefCountHandler<MetadataLookup> ref = m_lookupList.takeFirstAndDecr();
-        m_mutex.unlock();
-        MetadataLookup *lookup = ref;
-        MetadataLookupList list;
-
-        // Go go gadget Metadata Lookup
-        if (lookup->GetType() == kMetadataVideo ||
-            lookup->GetType() == kMetadataRecording)
+        m_running++;
+        m_pool.start(new MetadataLookupJob(this, m_lookupList.takeFirstAndDecr()),
+                     "MetadataLookup");
+    }
+    m_mutex.unlock();
+
+    MetaGrabberSession::ExpireIdle();
+
+    RunEpilog();
+}
+
+void MetadataDownload::lookupDone(void)
+{
+    QMutexLocker lock(&m_mutex);
+    m_running--;
+    m_lookupDone.wakeAll();
+}
+
+/**
+ * hasParent: False once the lookups have been cancelled.
+ * Lookups run on the pool, so m_parent is only read under m_mutex.
+ */
+bool MetadataDownload::hasParent(void)
+{
+    QMutexLocker lock(&m_mutex);
+    return m_parent != nullptr;
+}
+
+/**
+ * postToParent: Post an event to the parent, unless the lookups
+ * have been cancelled. Takes ownership of the event.
+ */
+void MetadataDownload::postToParent(QEvent *event)
+{
+    QMutexLocker lock(&m_mutex);
+    if (m_parent)
+        QCoreApplication::postEvent(m_parent, event);
+    else
+        delete event;
+}
+
+void MetadataDownload::processLookup(MetadataLookup *lookup)
+{
+    MetadataLookupList list;
+
+    // Go go gadget Metadata Lookup
+    if (lookup->GetType() == kMetadataVideo ||
+        lookup->GetType() == kMetadataRecording)
+    {
+        // First, look for mxml and nfo files in video storage groups
+        if (lookup->GetType() == kMetadataVideo &&
+            !lookup->GetFilename().isEmpty())
         {
-            // First, look for mxml and nfo files in video storage groups
-            if (lookup->GetType() == kMetadataVideo &&
-                !lookup->GetFilename().isEmpty())
-            {
-                QString mxml = getMXMLPath(lookup->GetFilename());
-                QString nfo = getNFOPath(lookup->GetFilename());
+            QString mxml = getMXMLPath(lookup->GetFilename());
+            QString nfo = getNFOPath(lookup->GetFilename());
 
-                if (!mxml.isEmpty())
-                    list = readMXML(mxml, lookup);
-                else if (!nfo.isEmpty())
-                    list = readNFO(nfo, lookup);
-            }
+            if (!mxml.isEmpty())
+                list = readMXML(mxml, lookup);
+            else if (!nfo.isEmpty())
+                list = readNFO(nfo, lookup);
+        }
 
-            // If nothing found, create lookups based on filename
-            if (list.isEmpty())
+        // If nothing found, create lookups based on filename
+        if (list.isEmpty())
+        {
+            if (lookup->GetSubtype() == kProbableTelevision)
             {
-                if (lookup->GetSubtype() == kProbableTelevision)
+                list = handleTelevision(lookup);
+                if ((findExactMatchCount(list, lookup->GetBaseTitle(), true) == 0) ||
+                    (list.size() > 1 && !lookup->GetAutomatic()))
                 {
-                    list = handleTelevision(lookup);
-                    if ((findExactMatchCount(list, lookup->GetBaseTitle(), true) == 0) ||
-                        (list.size() > 1 && !lookup->GetAutomatic()))
-                    {
-                        // There are no exact match prospects with artwork from TV search,
-                        // so add in movies, where we might find a better match.
-                        // In case of manual mode and ambiguous result, add it as well.
-                        list.append(handleMovie(lookup));
-                    }
+                    // There are no exact match prospects with artwork from TV search,
+                    // so add in movies, where we might find a better match.
+                    // In case of manual mode and ambiguous result, add it as well.
+                    list.append(handleMovie(lookup));
                 }
-                else if (lookup->GetSubtype() == kProbableMovie)
-                {
-                    list = handleMovie(lookup);
-                    if ((findExactMatchCount(list, lookup->GetBaseTitle(), true) == 0) ||
-                        (list.size() > 1 && !lookup->GetAutomatic()))
-                    {
-                        // There are no exact match prospects with artwork from Movie search
-                        // so add in television, where we might find a better match.
-                        // In case of manual mode and ambiguous result, add it as well.
-                        list.append(handleTelevision(lookup));
-                    }
-                }
-                else
+            }
+            else if (lookup->GetSubtype() == kProbableMovie)
+            {
+                list = handleMovie(lookup);
+                if ((findExactMatchCount(list, lookup->GetBaseTitle(), true) == 0) ||
+                    (list.size() > 1 && !lookup->GetAutomatic()))
                 {
-                    // will try both movie and TV
-                    list = handleVideoUndetermined(lookup);
+                    // There are no exact match prospects with artwork from Movie search
+                    // so add in television, where we might find a better match.
+                    // In case of manual mode and ambiguous result, add it as well.
+                    list.append(handleTelevision(lookup));
                 }
             }
+            else
+            {
+                // will try both movie and TV
+                list = handleVideoUndetermined(lookup);
+            }
         }
-        else if (lookup->GetType() == kMetadataGame)
+    }
+    else if (lookup->GetType() == kMetadataGame)
+    {
+        list = handleGame(lookup);
+    }
+
+    // inform parent we have lookup ready for it
+    if (!list.isEmpty() && hasParent())
+    {
+        // If there's only one result, don't bother asking
+        // our parent about it, just add it to the back of
+        // the queue in kLookupData mode.
+        if (list.count() == 1 && list[0]->GetStep() == kLookupSearch)
         {
-            list = handleGame(lookup);
+            MetadataLookup *newlookup = list.takeFirst();
+
+            newlookup->SetStep(kLookupData);
+            // Type may have changed
+            LookupType ret = GuessLookupType(newlookup);
+            if (ret != kUnknownVideo)
+            {
+                newlookup->SetSubtype(ret);
+            }
+            // Queued last, another lookup thread may take it straight away
+            prependLookup(newlookup);
+            return;
         }
 
-        // inform parent we have lookup ready for it
-        if (m_parent && !list.isEmpty())
+        // If we're in automatic mode, we need to make
+        // these decisions on our own.  Pass to title match.
+        if (list[0]->GetAutomatic() && list.count() > 1
+            && list[0]->GetStep() == kLookupSearch)
         {
-            // If there's only one result, don't bother asking
-            // our parent about it, just add it to the back of
-            // the queue in kLookupData mode.
-            if (list.count() == 1 && list[0]->GetStep() == kLookupSearch)
+            MetadataLookup *bestLookup = findBestMatch(list, lookup->GetBaseTitle());
+            if (bestLookup)
             {
-                MetadataLookup *newlookup = list.takeFirst();
+                MetadataLookup *newlookup = bestLookup;
 
+                // pass through automatic type
+                newlookup->SetAutomatic(true);
+                // bestlookup is owned by list, we need an extra reference
+                newlookup->IncrRef();
                 newlookup->SetStep(kLookupData);
-                prependLookup(newlookup);
                 // Type may have changed
                 LookupType ret = GuessLookupType(newlookup);
                 if (ret != kUnknownVideo)
                 {
                     newlookup->SetSubtype(ret);
                 }
-                continue;
+                prependLookup(newlookup);
+                return;
             }
 
-            // If we're in automatic mode, we need to make
-            // these decisions on our own.  Pass to title match.
-            if (list[0]->GetAutomatic() && list.count() > 1
-                && list[0]->GetStep() == kLookupSearch)
+            // Experimental:
+            // If nothing matches, always return the first found item
+            if (qEnvironmentVariableIsSet("EXPERIMENTAL_METADATA_GRAB"))
             {
-                MetadataLookup *bestLookup = findBestMatch(list, lookup->GetBaseTitle());
-                if (bestLookup)
-                {
-                    MetadataLookup *newlookup = bestLookup;
-
-                    // pass through automatic type
-                    newlookup->SetAutomatic(true);
-                    // bestlookup is owned by list, we need an extra reference
-                    newlookup->IncrRef();
-                    newlookup->SetStep(kLookupData);
-                    // Type may have changed
-                    LookupType ret = GuessLookupType(newlookup);
-                    if (ret != kUnknownVideo)
-                    {
-                        newlookup->SetSubtype(ret);
-                    }
-                    prependLookup(newlookup);
-                    continue;
-                }
+                MetadataLookup *newlookup = list.takeFirst();
 
-                // Experimental:
-                // If nothing matches, always return the first found item
-                if (qEnvironmentVariableIsSet("EXPERIMENTAL_METADATA_GRAB"))
+                // pass through automatic type
+                newlookup->SetAutomatic(true);
+                newlookup->SetStep(kLookupData);
+                // Type may have changed
+                LookupType ret = GuessLookupType(newlookup);
+                if (ret != kUnknownVideo)
                 {
-                    MetadataLookup *newlookup = list.takeFirst();
-
-                    // pass through automatic type
-                    newlookup->SetAutomatic(true);
-                    newlookup->SetStep(kLookupData);
-                    // Type may have changed
-                    LookupType ret = GuessLookupType(newlookup);
-                    if (ret != kUnknownVideo)
-                    {
-                        newlookup->SetSubtype(ret);
-                    }
-                    prependLookup(newlookup);
-                    continue;
+                    newlookup->SetSubtype(ret);
                 }
-
-                // nothing more we can do in automatic mode
-                QCoreApplication::postEvent(m_parent,
-                    new MetadataLookupFailure(MetadataLookupList() << lookup));
-                continue;
+                prependLookup(newlookup);
+                return;
             }
 
+            // nothing more we can do in automatic mode
+            postToParent(
+                new MetadataLookupFailure(MetadataLookupList() << lookup));
+            return;
+        }
+
+        LOG(VB_GENERAL, LOG_INFO,
+            QString("Returning Metadata Results: %1 %2 %3")
+                .arg(lookup->GetBaseTitle()).arg(lookup->GetSeason())
+                .arg(lookup->GetEpisode()));
+        postToParent(new MetadataLookupEvent(list));
+    }
+    else
+    {
+        if (list.isEmpty())
+        {
             LOG(VB_GENERAL, LOG_INFO,
-                QString("Returning Metadata Results: %1 %2 %3")
+                QString("Metadata Lookup Failed: No Results %1 %2 %3")
                     .arg(lookup->GetBaseTitle()).arg(lookup->GetSeason())
                     .arg(lookup->GetEpisode()));
-            QCoreApplication::postEvent(m_parent,
-                new MetadataLookupEvent(list));
         }
-        else
+        if (hasParent())
         {
-            if (list.isEmpty())
-            {
-                LOG(VB_GENERAL, LOG_INFO,
-                    QString("Metadata Lookup Failed: No Results %1 %2 %3")
-                        .arg(lookup->GetBaseTitle()).arg(lookup->GetSeason())
-                        .arg(lookup->GetEpisode()));
-            }
-            if (m_parent)
-            {
-                // list is always empty here
-                list.append(lookup);
-                QCoreApplication::postEvent(m_parent,
-                    new MetadataLookupFailure(list));
-            }
+            // list is always empty here
+            list.append(lookup);
+            postToParent(new MetadataLookupFailure(list));
         }
     }
-
-    RunEpilog();
 }
 
 unsigned int MetadataDownload::findExactMatchCount(MetadataLookupList list,
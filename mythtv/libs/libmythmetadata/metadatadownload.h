@@ -4,8 +4,10 @@
 #include <QStringList>
 #include <QMutex>
 #include <QEvent>
+#include <QWaitCondition>
 
 #include "libmythbase/mthread.h"
+#include "libmythbase/mthreadpool.h"
 #include "libmythmetadata/metadatacommon.h"
 
 class META_PUBLIC MetadataLookupEvent : public QEvent
@@ -59,7 +61,15 @@ class META_PUBLIC MetadataDownload : public MThread
     static QString getMXMLPath(const QString& filename);
     static QString getNFOPath(const QString& filename);
 
+    // Runs on the lookup thread pool, at most MetadataLookupThreads at once
+    virtual void processLookup(MetadataLookup *lookup);
+
   private:
+    friend class MetadataLookupJob;
+    void lookupDone(void);
+    bool hasParent(void);
+    void postToParent(QEvent *event);
+
     // Video handling
     static MetadataLookupList  handleMovie(MetadataLookup* lookup);
     static MetadataLookupList  handleTelevision(MetadataLookup* lookup);
@@ -86,6 +96,9 @@ class META_PUBLIC MetadataDownload : public MThread
     QObject            *m_parent {nullptr};
     MetadataLookupList  m_lookupList;
     QMutex              m_mutex;
+    QWaitCondition      m_lookupDone;
+    int                 m_running {0};  ///< lookups being processed
+    MThreadPool         m_pool {"MetadataLookup"};
 };
 
 #endif /* METADATADOWNLOAD_H */
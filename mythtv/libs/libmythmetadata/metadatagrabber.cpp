@@ -18,9 +18,12 @@
 
 #include "metadatacommon.h"
 #include "metadatagrabber.h"
+#include "metadatagrabbersession.h"
 
 #define LOC QString("Metadata Grabber: ")
 static constexpr std::chrono::seconds kGrabberRefresh { 60s };
+static constexpr std::chrono::seconds kGrabberTimeout { 180s };
+static constexpr std::chrono::minutes kResultCacheAge { 60min };
 
 static const QRegularExpression kRetagRef { R"(^([a-zA-Z0-9_\-\.]+\.[a-zA-Z0-9]{1,3})[:_](.*))" };
 
@@ -28,6 +31,8 @@ static GrabberList     s_grabberList;
 static QMutex          s_grabberLock;
 static QDateTime       s_grabberAge;
 
+static GrabberResultCache s_resultCache { kResultCacheAge, 8 * 1024 };
+
 struct GrabberOpts {
     QString     m_path;
     QString     m_setting;
@@ -339,6 +344,7 @@ MetaGrabberScript& MetaGrabberScript::operator=(const MetaGrabberScript &other)
         m_description = other.m_description;
         m_accepts = other.m_accepts;
         m_version = other.m_version;
+        m_session = other.m_session;
         m_valid = other.m_valid;
     }
 
@@ -355,6 +361,8 @@ void MetaGrabberScript::ParseGrabberVersion(const QDomElement &item)
     m_description   = item.firstChildElement("description").text();
     m_version       = item.firstChildElement("version").text().toFloat();
     m_typestring    = item.firstChildElement("type").text().toLower();
+    m_session       = item.firstChildElement("session").text().trimmed()
+                          .compare("true", Qt::CaseInsensitive) == 0;
 
     if (!m_typestring.isEmpty() && grabberTypeStrings.contains(m_typestring))
         m_type = grabberTypeStrings[m_typestring];
@@ -392,17 +400,22 @@ bool MetaGrabberScript::Test(void)
 MetadataLookupList MetaGrabberScript::RunGrabber(const QStringList &args,
                         MetadataLookup *lookup, bool passseas)
 {
-    MythSystemLegacy grabber(m_fullcommand, args, kMSStdOut);
     MetadataLookupList list;
 
-    LOG(VB_GENERAL, LOG_INFO, QString("Running Grabber: %1 %2")
-        .arg(m_fullcommand, args.join(" ")));
-
-    grabber.Run();
-    if (grabber.Wait(180s) != GENERIC_EXIT_OK)
-        return list;
+    QString key = m_fullcommand + '\t' + args.join('\t');
+    QByteArray result;
+    if (s_resultCache.Find(key, result))
+    {
+        LOG(VB_GENERAL, LOG_INFO, QString("Cached Grabber: %1 %2")
+            .arg(m_fullcommand, args.join(" ")));
+    }
+    else
+    {
+        if (!RunCommand(args, result))
+            return list;
+        s_resultCache.Insert(key, result);
+    }
 
-    QByteArray result = grabber.ReadAll();
     if (!result.isEmpty())
     {
         QDomDocument doc;
@@ -432,6 +445,82 @@ MetadataLookupList MetaGrabberScript::RunGrabber(const QStringList &args,
     return list;
 }
 
+/// Run the grabber with \a args, in its session if it has one, and
+/// return its output in \a result. Returns false if the grabber failed.
+bool MetaGrabberScript::RunCommand(const QStringList &args, QByteArray &result)
+{
+    if (m_session)
+    {
+        MetaGrabberSession *session = MetaGrabberSession::Acquire(m_fullcommand);
+        if (session)
+        {
+            LOG(VB_GENERAL, LOG_INFO, QString("Running Grabber Session: %1 %2")
+                .arg(m_fullcommand, args.join(" ")));
+
+            int status = GENERIC_EXIT_NOT_OK;
+            bool ok = session->Run(args, result, status, kGrabberTimeout);
+            MetaGrabberSession::Release(session);
+            if (ok)
+                return status == GENERIC_EXIT_OK;
+
+            // The session broke down, so try this lookup the usual way
+            LOG(VB_GENERAL, LOG_WARNING, QString("Grabber session %1 failed")
+                .arg(m_fullcommand));
+            result.clear();
+        }
+    }
+
+    MythSystemLegacy grabber(m_fullcommand, args, kMSStdOut);
+
+    LOG(VB_GENERAL, LOG_INFO, QString("Running Grabber: %1 %2")
+        .arg(m_fullcommand, args.join(" ")));
+
+    grabber.Run();
+    if (grabber.Wait(kGrabberTimeout) != GENERIC_EXIT_OK)
+        return false;
+
+    result = grabber.ReadAll();
+    return true;
+}
+
+/// Forget the results of earlier lookups, e.g. after the grabber settings
+/// have been changed.
+void MetaGrabberScript::ClearCache(void)
+{
+    s_resultCache.Clear();
+}
+
+/// Find the output cached for \a key, if it is not too old.
+bool GrabberResultCache::Find(const QString &key, QByteArray &result)
+{
+    QMutexLocker locker(&m_lock);
+    Entry *entry = m_cache.object(key);
+    if (!entry)
+        return false;
+    if (entry->m_age.hasExpired(m_maxAge.count()))
+    {
+        m_cache.remove(key);
+        return false;
+    }
+    result = entry->m_data;
+    return true;
+}
+
+void GrabberResultCache::Insert(const QString &key, const QByteArray &result)
+{
+    auto *entry = new Entry;
+    entry->m_data = result;
+    entry->m_age.start();
+    QMutexLocker locker(&m_lock);
+    m_cache.insert(key, entry, (result.size() / 1024) + 1);
+}
+
+void GrabberResultCache::Clear(void)
+{
+    QMutexLocker locker(&m_lock);
+    m_cache.clear();
+}
+
 QString MetaGrabberScript::GetRelPath(void) const
 {
     QString share = GetShareDir();
@@ -1,7 +1,15 @@
 #ifndef METADATAGRABBER_H_
 #define METADATAGRABBER_H_
 
+// C++ headers
+#include <chrono>
+
+// Qt headers
+#include <QByteArray>
+#include <QCache>
+#include <QElapsedTimer>
 #include <QList>
+#include <QMutex>
 #include <QString>
 #include <QVariant>
 #include <QStringList>
@@ -26,6 +34,37 @@ enum GrabberType : std::uint8_t {
     kGrabberInvalid
 };
 
+/** \class GrabberResultCache
+ *  \brief Grabber output for recent lookups, keyed by the grabber and its
+ *         arguments.
+ *
+ *  Repeated lookups of the same title or episode, e.g. every episode of a
+ *  series asking for the series, are answered from here instead of going
+ *  back to the grabber. An entry older than the maximum age is not used,
+ *  and the least recently used entries are dropped once the cache holds
+ *  more than its size in KiB.
+ */
+class META_PUBLIC GrabberResultCache
+{
+  public:
+    GrabberResultCache(std::chrono::milliseconds maxAge, int maxKiB)
+      : m_maxAge(maxAge), m_cache(maxKiB) {}
+
+    bool Find(const QString &key, QByteArray &result);
+    void Insert(const QString &key, const QByteArray &result);
+    void Clear(void);
+
+  private:
+    struct Entry {
+        QByteArray    m_data;
+        QElapsedTimer m_age;
+    };
+
+    std::chrono::milliseconds m_maxAge;
+    QMutex                    m_lock;
+    QCache<QString, Entry>    m_cache;
+};
+
 class META_PUBLIC MetaGrabberScript
 {
   public:
@@ -77,6 +116,8 @@ class META_PUBLIC MetaGrabberScript
     MetadataLookupList  LookupData(const QString &inetref, int season, int episode, MetadataLookup *lookup, bool passseas=true);
     MetadataLookupList  LookupCollection(const QString &collectionref, MetadataLookup *lookup, bool passseas=true);
 
+    static void         ClearCache(void);
+
   private:
     QString m_name;
     QString m_author;
@@ -88,10 +129,12 @@ class META_PUBLIC MetaGrabberScript
     QString m_description;
     QStringList m_accepts;
     float m_version       {0.0};
+    bool  m_session       {false};
     bool  m_valid         {false};
 
     void ParseGrabberVersion(const QDomElement &item);
     MetadataLookupList RunGrabber(const QStringList &args, MetadataLookup *lookup, bool passseas);
+    bool RunCommand(const QStringList &args, QByteArray &result);
     static void SetDefaultArgs(QStringList &args);
 };
 
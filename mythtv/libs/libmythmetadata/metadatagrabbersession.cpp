@@ -0,0 +1,383 @@
+// C++ headers
+#include <array>
+#include <cerrno>
+#include <thread>
+#include <utility>
+
+#ifndef _WIN32
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// Qt headers
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+
+// MythTV headers
+#include "libmythbase/exitcodes.h"
+#include "libmythbase/mythchrono.h"
+#include "libmythbase/mythconfig.h"
+#include "libmythbase/mythlogging.h"
+
+#include "metadatagrabbersession.h"
+
+#define LOC QString("Grabber Session: ")
+
+static QMutex                      s_sessionLock;
+static QList<MetaGrabberSession *> s_idleSessions;
+
+MetaGrabberSession::MetaGrabberSession(QString command)
+  : m_command(std::move(command))
+{
+}
+
+MetaGrabberSession::~MetaGrabberSession()
+{
+    Stop();
+}
+
+#ifndef _WIN32
+
+bool MetaGrabberSession::Start(void)
+{
+    if (IsRunning())
+        return true;
+
+    std::array<int,2> input  { -1, -1 };
+    std::array<int,2> output { -1, -1 };
+    if (pipe(input.data()) < 0 || pipe(output.data()) < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Failed to create pipes" + ENO);
+        for (int fd : input)
+            if (fd >= 0)
+                close(fd);
+        return false;
+    }
+    // Keep our ends out of any other child started meanwhile
+    fcntl(input[1],  F_SETFD, FD_CLOEXEC);
+    fcntl(output[0], F_SETFD, FD_CLOEXEC);
+
+    // Everything the child needs is prepared before the fork, as only
+    // async-signal-safe calls may be made between fork and exec.
+    QByteArray command = m_command.toUtf8();
+    std::array<const char *,3> argv { command.constData(), "--session", nullptr };
+    int devnull = open("/dev/null", O_WRONLY | O_CLOEXEC);
+
+    pid_t child = fork();
+    if (child < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "fork() failed" + ENO);
+        close(input[0]);
+        close(input[1]);
+        close(output[0]);
+        close(output[1]);
+        if (devnull >= 0)
+            close(devnull);
+        return false;
+    }
+
+    if (child == 0)
+    {
+        if (dup2(input[0], 0) < 0 || dup2(output[1], 1) < 0)
+            _exit(GENERIC_EXIT_PIPE_FAILURE);
+        if (devnull >= 0)
+            dup2(devnull, 2);
+#if HAVE_CLOSE_RANGE
+        close_range(3, sysconf(_SC_OPEN_MAX) - 1, 0);
+#else
+        for (int fd = sysconf(_SC_OPEN_MAX) - 1; fd > 2; fd--)
+            close(fd);
+#endif
+        execv(argv[0], const_cast<char * const *>(argv.data()));
+        _exit(GENERIC_EXIT_DAEMONIZING_ERROR);
+    }
+
+    close(input[0]);
+    close(output[1]);
+    if (devnull >= 0)
+        close(devnull);
+
+    m_pid    = child;
+    m_input  = input[1];
+    m_output = output[0];
+    m_buffer.clear();
+    m_idle.start();
+
+    LOG(VB_GENERAL, LOG_INFO, LOC + QString("Started %1 (PID %2)")
+        .arg(m_command).arg(m_pid));
+    return true;
+}
+
+void MetaGrabberSession::Stop(void)
+{
+    // Closing stdin asks the grabber to exit
+    if (m_input >= 0)
+    {
+        close(m_input);
+        m_input = -1;
+    }
+
+    if (m_pid > 0)
+    {
+        // The MythSystemLegacy manager reaps every child, so the grabber
+        // may already have been collected there, and its PID may even have
+        // gone to another child since. Its stdout only closes once it has
+        // exited though, so while that is still open the PID is its own.
+        bool gone = false;
+        for (int i = 0; i < 50 && !gone; ++i)
+        {
+            pid_t ret = waitpid(m_pid, nullptr, WNOHANG);
+            gone = (ret == m_pid) || (ret < 0 && errno == ECHILD) || OutputClosed();
+            if (!gone)
+                std::this_thread::sleep_for(10ms);
+        }
+        if (!gone && !OutputClosed())
+        {
+            LOG(VB_GENERAL, LOG_WARNING, LOC +
+                QString("Killing %1 (PID %2)").arg(m_command).arg(m_pid));
+            kill(m_pid, SIGKILL);
+            waitpid(m_pid, nullptr, 0);
+        }
+        m_pid = -1;
+    }
+
+    if (m_output >= 0)
+    {
+        close(m_output);
+        m_output = -1;
+    }
+    m_buffer.clear();
+}
+
+/** \fn MetaGrabberSession::Run(const QStringList&,QByteArray&,int&,std::chrono::milliseconds)
+ *  \brief Send one lookup to the grabber and wait for the answer.
+ *
+ *  On return \a result holds the grabber's output and \a status its exit
+ *  status for the lookup. Returns false, after stopping the session, if
+ *  the grabber could not be reached or did not answer within \a timeout.
+ */
+bool MetaGrabberSession::Run(const QStringList &args, QByteArray &result,
+                             int &status, std::chrono::milliseconds timeout)
+{
+    if (!IsRunning() && !Start())
+        return false;
+
+    // Tabs and newlines delimit the request, so they can't be passed on
+    QStringList fields;
+    for (QString arg : args)
+        fields << arg.replace('\t', ' ').replace('\n', ' ');
+    QByteArray request = fields.join('\t').toUtf8() + '\n';
+
+    const char *data = request.constData();
+    qsizetype left = request.size();
+    while (left > 0)
+    {
+        ssize_t written = write(m_input, data, static_cast<size_t>(left));
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+        {
+            LOG(VB_GENERAL, LOG_ERR, LOC +
+                QString("Failed to write to %1").arg(m_command) + ENO);
+            Stop();
+            return false;
+        }
+        data += written;
+        left -= written;
+    }
+
+    if (!ReadReply(result, status, timeout))
+    {
+        Stop();
+        return false;
+    }
+
+    m_idle.start();
+    return true;
+}
+
+bool MetaGrabberSession::ReadReply(QByteArray &result, int &status,
+                                   std::chrono::milliseconds timeout)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (true)
+    {
+        // The reply ends with a line "#END <status>"
+        qsizetype end = m_buffer.startsWith("#END ") ? 0 : m_buffer.indexOf("\n#END ");
+        if (end >= 0)
+        {
+            qsizetype marker = (end == 0) ? 0 : end + 1;
+            qsizetype eol = m_buffer.indexOf('\n', marker);
+            if (eol >= 0)
+            {
+                status = m_buffer.mid(marker + 5, eol - marker - 5).trimmed().toInt();
+                result = m_buffer.left(end);
+                m_buffer.remove(0, eol + 1);
+                return true;
+            }
+        }
+
+        auto remaining = timeout - std::chrono::milliseconds(timer.elapsed());
+        if (remaining <= 0ms)
+        {
+            LOG(VB_GENERAL, LOG_ERR, LOC +
+                QString("Timed out waiting for %1").arg(m_command));
+            return false;
+        }
+
+        pollfd pfd { m_output, POLLIN, 0 };
+        int ret = poll(&pfd, 1, static_cast<int>(remaining.count()));
+        if (ret == 0 || (ret < 0 && errno == EINTR))
+            continue;
+        if (ret < 0)
+        {
+            LOG(VB_GENERAL, LOG_ERR, LOC + "poll() failed" + ENO);
+            return false;
+        }
+
+        std::array<char,65536> chunk {};
+        ssize_t count = read(m_output, chunk.data(), chunk.size());
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+        {
+            LOG(VB_GENERAL, LOG_ERR, LOC +
+                QString("%1 exited during a lookup").arg(m_command));
+            return false;
+        }
+        m_buffer.append(chunk.data(), count);
+    }
+}
+
+/// True once the grabber has closed its stdout, normally by exiting.
+/// Anything it still had to say is thrown away.
+bool MetaGrabberSession::OutputClosed(void)
+{
+    if (m_output < 0)
+        return true;
+
+    // A grabber still writing is clearly running, so don't read forever
+    for (int i = 0; i < 16; ++i)
+    {
+        pollfd pfd { m_output, POLLIN, 0 };
+        int ret = poll(&pfd, 1, 0);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            return false;
+        if ((pfd.revents & POLLIN) == 0)
+            return (pfd.revents & (POLLHUP | POLLERR | POLLNVAL)) != 0;
+
+        std::array<char,4096> chunk {};
+        ssize_t count = read(m_output, chunk.data(), chunk.size());
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0)
+            return count == 0;
+    }
+    return false;
+}
+
+#else // _WIN32
+
+bool MetaGrabberSession::Start(void)
+{
+    return false;
+}
+
+void MetaGrabberSession::Stop(void)
+{
+}
+
+bool MetaGrabberSession::Run(const QStringList &/*args*/, QByteArray &/*result*/,
+                             int &/*status*/, std::chrono::milliseconds /*timeout*/)
+{
+    return false;
+}
+
+bool MetaGrabberSession::ReadReply(QByteArray &/*result*/, int &/*status*/,
+                                   std::chrono::milliseconds /*timeout*/)
+{
+    return false;
+}
+
+bool MetaGrabberSession::OutputClosed(void)
+{
+    return true;
+}
+
+#endif // _WIN32
+
+MetaGrabberSession *MetaGrabberSession::Acquire(const QString &command)
+{
+    ExpireIdle();
+
+    {
+        QMutexLocker locker(&s_sessionLock);
+        for (auto it = s_idleSessions.begin(); it != s_idleSessions.end(); ++it)
+        {
+            if ((*it)->m_command == command)
+            {
+                MetaGrabberSession *session = *it;
+                s_idleSessions.erase(it);
+                return session;
+            }
+        }
+    }
+
+    auto *session = new MetaGrabberSession(command);
+    if (session->Start())
+        return session;
+
+    delete session;
+    return nullptr;
+}
+
+void MetaGrabberSession::Release(MetaGrabberSession *session)
+{
+    if (!session)
+        return;
+
+    if (!session->IsRunning())
+    {
+        delete session;
+        return;
+    }
+
+    QMutexLocker locker(&s_sessionLock);
+    s_idleSessions.append(session);
+}
+
+/// Close the sessions idle for longer than kIdleTimeout, or all idle
+/// sessions if \a all is set.
+void MetaGrabberSession::ExpireIdle(bool all)
+{
+    QList<MetaGrabberSession *> expired;
+    {
+        QMutexLocker locker(&s_sessionLock);
+        auto it = s_idleSessions.begin();
+        while (it != s_idleSessions.end())
+        {
+            if (all || (*it)->m_idle.hasExpired(
+                    std::chrono::milliseconds(kIdleTimeout).count()))
+            {
+                expired.append(*it);
+                it = s_idleSessions.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    // Stopping may wait for the grabber, so do it without the lock held
+    for (auto *session : std::as_const(expired))
+        delete session;
+}
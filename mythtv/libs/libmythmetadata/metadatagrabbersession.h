@@ -0,0 +1,72 @@
+#ifndef METADATAGRABBERSESSION_H_
+#define METADATAGRABBERSESSION_H_
+
+// C++ headers
+#include <chrono>
+
+// Qt headers
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <QStringList>
+
+// MythTV headers
+#include "libmythmetadata/mythmetaexp.h"
+
+/** \class MetaGrabberSession
+ *  \brief A grabber script kept running to answer several lookups.
+ *
+ *  A grabber that lists \<session\>true\</session\> in its version output
+ *  is started once with the single argument --session. Each lookup is then
+ *  written to its stdin as one line holding the usual command line
+ *  arguments separated by tabs, and the grabber answers on stdout with the
+ *  XML it would have printed when run with those arguments, followed by a
+ *  line "#END <exit status>". This saves starting the interpreter and
+ *  loading the grabber's modules and caches for every lookup.
+ *
+ *  A session answers one lookup at a time. Acquire() hands out an idle
+ *  session for a grabber, starting a new one if there is none, and
+ *  Release() returns it for reuse. Sessions left idle for longer than
+ *  kIdleTimeout are closed; the grabber should also exit by itself when
+ *  its stdin is closed or it has been idle for a while.
+ *
+ *  Sessions are only available on POSIX systems. Elsewhere Acquire()
+ *  always returns nullptr and the caller runs the grabber once per lookup.
+ */
+class META_PUBLIC MetaGrabberSession
+{
+  public:
+    explicit MetaGrabberSession(QString command);
+    ~MetaGrabberSession();
+
+    MetaGrabberSession(const MetaGrabberSession &) = delete;
+    MetaGrabberSession &operator=(const MetaGrabberSession &) = delete;
+
+    bool Start(void);
+    void Stop(void);
+    bool IsRunning(void) const { return m_pid > 0; }
+    bool Run(const QStringList &args, QByteArray &result, int &status,
+             std::chrono::milliseconds timeout);
+
+    const QString &GetCommand(void) const { return m_command; }
+
+    static MetaGrabberSession *Acquire(const QString &command);
+    static void Release(MetaGrabberSession *session);
+    static void ExpireIdle(bool all = false);
+
+    static constexpr std::chrono::seconds kIdleTimeout { 60 };
+
+  private:
+    bool ReadReply(QByteArray &result, int &status,
+                   std::chrono::milliseconds timeout);
+    bool OutputClosed(void);
+
+    QString       m_command;
+    QByteArray    m_buffer;
+    QElapsedTimer m_idle;
+    int           m_pid    { -1 };
+    int           m_input  { -1 };  ///< the grabber's stdin
+    int           m_output { -1 };  ///< the grabber's stdout
+};
+
+#endif // METADATAGRABBERSESSION_H_
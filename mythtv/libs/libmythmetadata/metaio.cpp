@@ -62,7 +62,7 @@ MetaIO* MetaIO::createTagger(const QString& filename)
 }
 
 // static
-MusicMetadata* MetaIO::readMetadata(const QString &filename)
+MusicMetadata* MetaIO::readMetadata(const QString &filename, AlbumArtList *artList)
 {
     MusicMetadata *mdata = nullptr;
     MetaIO *tagger = MetaIO::createTagger(filename);
@@ -76,6 +76,9 @@ MusicMetadata* MetaIO::readMetadata(const QString &filename)
         if (ignoreID3 || !mdata)
             mdata = tagger->readFromFilename(filename);
 
+        if (mdata && artList && tagger->supportsEmbeddedImages())
+            *artList = tagger->getAlbumArtList(filename);
+
         delete tagger;
     }
 
@@ -142,9 +142,13 @@ class META_PUBLIC MetaIO
     * Creates a \p MetaIO object using \p MetaIO::createTagger and uses
     * the MetaIO object to read the metadata.
     * \param filename The filename to read metadata from.
+    * \param artList If not null, filled with the embedded images found
+    *                using the same MetaIO object. Only their types and
+    *                descriptions are read, the images stay in the file.
     * \returns an instance of \p MusicMetadata owned by the caller
     */
-    static MusicMetadata *readMetadata(const QString &filename);
+    static MusicMetadata *readMetadata(const QString &filename,
+                                       AlbumArtList *artList = nullptr);
 
     /*!
     * \brief Get the metadata for \p filename
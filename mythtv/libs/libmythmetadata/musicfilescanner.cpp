@@ -1,18 +1,158 @@
+#include <algorithm>
+#include <functional>
 #include <thread>
+#include <utility>
+#include <vector>
 
 // Qt headers
 #include <QDir>
+#include <QMutex>
+#include <QRunnable>
+#include <QThread>
+#include <QWaitCondition>
 
 // MythTV headers
+#include "libmythbase/mthreadpool.h"
 #include "libmythbase/mythcorecontext.h"
 #include "libmythbase/mythdate.h"
 #include "libmythbase/mythdb.h"
 #include "libmythbase/mythlogging.h"
+#include "libmythbase/mythtimer.h"
 
 #include "musicmetadata.h"
 #include "metaio.h"
 #include "musicfilescanner.h"
 
+// tracks written to the database between commits
+static constexpr int kCommitBatch { 200 };
+// how often the progress of a scan is logged and sent to the frontends
+static constexpr std::chrono::seconds kProgressInterval { 10s };
+
+namespace
+{
+    class MusicTagWorker : public QRunnable
+    {
+      public:
+        explicit MusicTagWorker(std::function<void()> work) :
+            m_work(std::move(work)) {}
+
+        void run(void) override { m_work(); } // QRunnable
+
+      private:
+        std::function<void()> m_work;
+    };
+
+    /// Reads the tags of a list of files on a pool of threads and hands them
+    /// back in the order of the list. The readers only get kReadAhead files
+    /// ahead of take(), so a large import doesn't hold every track in memory.
+    class MusicTagReader
+    {
+      public:
+        struct Tags
+        {
+            MusicMetadata *m_data {nullptr};
+            AlbumArtList   m_art;
+        };
+
+        /// listArt says which files also need their embedded images listed
+        MusicTagReader(QStringList files, std::vector<bool> listArt)
+          : m_files(std::move(files)),
+            m_listArt(std::move(listArt)),
+            m_tags(m_files.size()),
+            m_ready(m_files.size(), false),
+            m_pool("MusicTagReader")
+        {
+            // reading tags is mostly waiting for the disk, more threads than
+            // this only make them wait on each other
+            int threads = std::clamp(QThread::idealThreadCount(), 2, kMaxReaders);
+            threads = std::min(threads, static_cast<int>(m_files.size()));
+            m_pool.setMaxThreadCount(std::max(threads, 1));
+            for (int i = 0; i < threads; ++i)
+                m_pool.start(new MusicTagWorker([this]() { readFiles(); }), "MusicTagReader");
+        }
+
+        ~MusicTagReader()
+        {
+            {
+                QMutexLocker locker(&m_lock);
+                m_stop = true;
+                m_wait.wakeAll();
+            }
+            m_pool.waitForDone();
+
+            for (auto &tags : m_tags)
+            {
+                delete tags.m_data;
+                qDeleteAll(tags.m_art);
+            }
+        }
+
+        MusicTagReader(const MusicTagReader &) = delete;
+        MusicTagReader &operator=(const MusicTagReader &) = delete;
+
+        /// wait for the tags of file index, the caller owns what is returned
+        Tags take(int index)
+        {
+            QMutexLocker locker(&m_lock);
+            while (!m_ready[index])
+                m_wait.wait(&m_lock);
+            m_taken = index + 1;
+            m_wait.wakeAll();
+            return std::exchange(m_tags[index], Tags());
+        }
+
+      private:
+        static constexpr int kMaxReaders { 8 };
+        static constexpr int kReadAhead  { 256 };
+
+        void readFiles(void)
+        {
+            QMutexLocker locker(&m_lock);
+            while (!m_stop && m_next < m_files.size())
+            {
+                if (m_next >= m_taken + kReadAhead)
+                {
+                    m_wait.wait(&m_lock);
+                    continue;
+                }
+                int index = m_next++;
+                locker.unlock();
+
+                Tags tags;
+                LOG(VB_FILE, LOG_INFO, QString("Reading metadata from %1").arg(m_files[index]));
+                tags.m_data = MetaIO::readMetadata(m_files[index],
+                                                   m_listArt[index] ? &tags.m_art : nullptr);
+
+                locker.relock();
+                m_tags[index] = std::move(tags);
+                m_ready[index] = true;
+                m_wait.wakeAll();
+            }
+        }
+
+        const QStringList       m_files;
+        const std::vector<bool> m_listArt;
+
+        QMutex            m_lock;
+        QWaitCondition    m_wait;
+        std::vector<Tags> m_tags;       // protected by m_lock
+        std::vector<bool> m_ready;      // protected by m_lock
+        int               m_next  {0};  // protected by m_lock
+        int               m_taken {0};  // protected by m_lock
+        bool              m_stop  {false}; // protected by m_lock
+
+        MThreadPool       m_pool;
+    };
+
+    void commit_batch(MSqlQuery &transaction, bool restart)
+    {
+        if (!transaction.exec("COMMIT"))
+            MythDB::DBError("MusicFileScanner - commit", transaction);
+        if (restart && !transaction.exec("START TRANSACTION"))
+            MythDB::DBError("MusicFileScanner - start transaction", transaction);
+    }
+}
+
 MusicFileScanner::MusicFileScanner(bool force) : m_forceupdate{force}
 {
     MSqlQuery query(MSqlQuery::InitCon());
@@ -126,9 +266,13 @@ void MusicFileScanner::BuildFileList(QString &directory, MusicLoadedMap &music_f
             }
             else if (IsMusicFile(filename))
             {
+                // keep what the directory listing already knows so the file
+                // doesn't have to be looked at again to see if it changed
                 MusicFileData fdata;
                 fdata.startDir = m_startDirs.last();
                 fdata.location = MusicFileScanner::kFileSystem;
+                fdata.size     = fi.size();
+                fdata.modified = fi.lastModified();
                 music_files[filename] = fdata;
             }
             else
@@ -210,20 +354,25 @@ int MusicFileScanner::GetDirectoryId(const QString &directory, int parentid)
 }
 
 /*!
- * \brief Check if file has been modified since given date/time
+ * \brief Check if file has been modified since it was last written to the
+ *        database
  *
  * \param filename File to examine
+ * \param fdata The size and modification time found by BuildFileList
  * \param date_modified Date to use in comparison
+ * \param size The size in the database, 0 if it isn't known
  *
  * \returns True if file has been modified, otherwise false
  */
 bool MusicFileScanner::HasFileChanged(
-    const QString &filename, const QString &date_modified)
+    const QString &filename, const MusicFileData &fdata,
+    const QString &date_modified, quint64 size)
 {
-    QFileInfo fi(filename);
-    QDateTime dt = fi.lastModified();
+    const QDateTime &dt = fdata.modified;
     if (dt.isValid())
     {
+        if (size > 0 && size != static_cast<quint64>(fdata.size))
+            return true;
         QDateTime old_dt = MythDate::fromString(date_modified);
         return !old_dt.isValid() || (dt > old_dt);
     }
@@ -233,27 +382,30 @@ bool MusicFileScanner::HasFileChanged(
 }
 
 /*!
- * \brief Insert music file details into database. Read the metadata
- *        and insert that information at the same time.
+ * \brief Insert music file details into database, along with the metadata
+ *        read from it.
  *
  * \param filename Full path to file.
- * \param startDir The starting directory for the search. This will be
- *                 removed making the stored name relative to the
- *                 storage directory where it was found.
+ * \param fdata The starting directory for the search, which will be
+ *              removed making the stored name relative to the storage
+ *              directory where it was found, and the size of the file.
+ * \param data The metadata read from the file, this takes ownership.
+ * \param artList The images embedded in the file. The track keeps copies
+ *                of them, the originals are deleted and the list is
+ *                left empty.
  *
  * \returns Nothing.
  */
-void MusicFileScanner::AddMusicToDB(const QString &filename, const QString &startDir)
+void MusicFileScanner::AddMusicToDB(const QString &filename, const MusicFileData &fdata,
+                                    MusicMetadata *data, AlbumArtList &artList)
 {
     QString directory = filename;
-    directory.remove(0, startDir.length());
+    directory.remove(0, fdata.startDir.length());
     directory = directory.section( '/', 0, -2);
 
-    LOG(VB_FILE, LOG_INFO, QString("Reading metadata from %1").arg(filename));
-    MusicMetadata *data = MetaIO::readMetadata(filename);
     if (data)
     {
-        data->setFileSize((quint64)QFileInfo(filename).size());
+        data->setFileSize(static_cast<quint64>(fdata.size));
         data->setHostname(gCoreContext->GetHostName());
 
         QString album_cache_string;
@@ -301,24 +453,21 @@ void MusicFileScanner::AddMusicToDB(const QString &filename, const QString &star
             + data->Album().toLower();
         m_albumid[album_cache_string] = data->getAlbumId();
 
-        // read any embedded images from the tag
-        MetaIO *tagger = MetaIO::createTagger(filename);
-
-        if (tagger)
+        // the images embedded in the tag were listed when it was read, they
+        // are only extracted from the file when they are shown
+        if (!artList.isEmpty())
         {
-            if (tagger->supportsEmbeddedImages())
-            {
-                AlbumArtList artList = tagger->getAlbumArtList(data->Filename());
-                data->setEmbeddedAlbumArt(artList);
-                data->getAlbumArtImages()->dumpToDatabase();
-            }
-            delete tagger;
+            data->setEmbeddedAlbumArt(artList);
+            data->getAlbumArtImages()->dumpToDatabase();
         }
 
         delete data;
 
         ++m_tracksAdded;
     }
+
+    qDeleteAll(artList);
+    artList.clear();
 }
 
 /*!
@@ -548,23 +697,24 @@ void MusicFileScanner::RemoveArtworkFromDB(int albumartid)
  * \brief Updates a music file in the database.
  *
  * \param filename Full path to file.
- * \param startDir The starting directory for the search. This will be
- *                 removed making the stored name relative to the
- *                 storage directory where it was found.
+ * \param fdata The starting directory for the search, which will be
+ *              removed making the stored name relative to the storage
+ *              directory where it was found, and the size of the file.
+ * \param disk_meta The metadata read from the file, this takes ownership.
  *
  * \returns Nothing.
  */
-void MusicFileScanner::UpdateMusicInDB(const QString &filename, const QString &startDir)
+void MusicFileScanner::UpdateMusicInDB(const QString &filename, const MusicFileData &fdata,
+                                       MusicMetadata *disk_meta)
 {
     QString dbFilename = filename;
-    dbFilename.remove(0, startDir.length());
+    dbFilename.remove(0, fdata.startDir.length());
 
     QString directory = filename;
-    directory.remove(0, startDir.length());
+    directory.remove(0, fdata.startDir.length());
     directory = directory.section( '/', 0, -2);
 
     MusicMetadata *db_meta   = MetaIO::getMetadata(dbFilename);
-    MusicMetadata *disk_meta = MetaIO::readMetadata(filename);
 
     if (db_meta && disk_meta)
     {
@@ -611,7 +761,7 @@ void MusicFileScanner::UpdateMusicInDB(const QString &filename, const QString &s
         if (gid > 0)
             disk_meta->setGenreId(gid);
 
-        disk_meta->setFileSize((quint64)QFileInfo(filename).size());
+        disk_meta->setFileSize(static_cast<quint64>(fdata.size));
 
         disk_meta->setHostname(gCoreContext->GetHostName());
 
@@ -712,35 +862,16 @@ void MusicFileScanner::SearchDirs(const QStringList &dirList)
 
     LOG(VB_GENERAL, LOG_INFO, "Updating database");
 
-        /*
-        This can be optimised quite a bit by consolidating all commands
-        via a lot of refactoring.
-
-        1) group all files of the same decoder type, and don't
-        create/delete a Decoder pr. AddMusicToDB. Or make Decoders be
-        singletons, it should be a fairly simple change.
-
-        2) RemoveMusicFromDB and RemoveArtworkFromDB should group the
-        remove into one big SQL.
-
-        3) UpdateMusicInDB, same as 1.
-        */
+    // All the queries below reuse this connection, so the changes are
+    // committed a batch at a time rather than a row at a time.
+    MSqlQuery transaction(MSqlQuery::InitCon());
+    if (!transaction.exec("START TRANSACTION"))
+        MythDB::DBError("MusicFileScanner - start transaction", transaction);
 
     for (int songid : std::as_const(songidsToDelete))
         RemoveMusicFromDB(songid);
 
-    for (iter = music_files.begin(); iter != music_files.end(); iter++)
-    {
-        if ((*iter).location == MusicFileScanner::kFileSystem)
-        {
-            AddMusicToDB(iter.key(), (*iter).startDir);
-        }
-        else if ((*iter).location == MusicFileScanner::kNeedUpdate)
-        {
-            UpdateMusicInDB(iter.key(), (*iter).startDir);
-            ++m_tracksUpdated;
-        }
-    }
+    ImportMusic(music_files, transaction);
 
     for (int albumartid : std::as_const(albumartidsToDelete))
         RemoveArtworkFromDB(albumartid);
@@ -751,6 +882,8 @@ void MusicFileScanner::SearchDirs(const QStringList &dirList)
             AddArtworkToDB(iter.key(), (*iter).startDir);
     }
 
+    commit_batch(transaction, false);
+
     // Cleanup orphaned entries from the database
     cleanDB();
 
@@ -775,6 +908,68 @@ void MusicFileScanner::SearchDirs(const QStringList &dirList)
     updateLastRunStatus(status);
 }
 
+/*!
+ * \brief Add the new music files to the database and update the changed ones.
+ *        The tags are read on a pool of threads while this one writes them
+ *        to the database, committing every kCommitBatch tracks.
+ *
+ * \param music_files The files left to add or update by ScanMusic
+ * \param transaction The open transaction the changes are written in
+ *
+ * \returns Nothing.
+ */
+void MusicFileScanner::ImportMusic(const MusicLoadedMap &music_files, MSqlQuery &transaction)
+{
+    QStringList files;
+    std::vector<bool> listArt;
+    for (auto iter = music_files.cbegin(); iter != music_files.cend(); ++iter)
+    {
+        files.append(iter.key());
+        listArt.push_back((*iter).location == MusicFileScanner::kFileSystem);
+    }
+
+    if (files.isEmpty())
+        return;
+
+    QString host = gCoreContext->GetHostName();
+    auto total = static_cast<uint>(files.size());
+    MythTimer timer(MythTimer::kStartRunning);
+    std::chrono::milliseconds lastProgress = 0ms;
+
+    MusicTagReader reader(files, std::move(listArt));
+
+    auto iter = music_files.cbegin();
+    for (uint done = 1; done <= total; ++done, ++iter)
+    {
+        MusicTagReader::Tags tags = reader.take(static_cast<int>(done - 1));
+
+        if ((*iter).location == MusicFileScanner::kFileSystem)
+        {
+            AddMusicToDB(iter.key(), *iter, tags.m_data, tags.m_art);
+        }
+        else if ((*iter).location == MusicFileScanner::kNeedUpdate)
+        {
+            UpdateMusicInDB(iter.key(), *iter, tags.m_data);
+            ++m_tracksUpdated;
+        }
+
+        if (done % kCommitBatch == 0)
+            commit_batch(transaction, true);
+
+        std::chrono::milliseconds elapsed = timer.elapsed();
+        if (elapsed - lastProgress >= kProgressInterval || done == total)
+        {
+            lastProgress = elapsed;
+            double rate = done * 1000.0 / std::max<int64_t>(elapsed.count(), 1);
+            LOG(VB_GENERAL, LOG_INFO,
+                QString("Read %1 of %2 music files, %3 files/sec")
+                    .arg(done).arg(total).arg(rate, 0, 'f', 1));
+            gCoreContext->SendMessage(QString("MUSIC_SCANNER_PROGRESS %1 %2 %3 %4")
+                                      .arg(host).arg(done).arg(total).arg(rate, 0, 'f', 1));
+        }
+    }
+}
+
 /*!
  * \brief Check a list of files against music files already in the database
  *
@@ -791,7 +986,7 @@ void MusicFileScanner::ScanMusic(MusicLoadedMap &music_files, QList<int> &songid
     songidsToDelete.clear();
 
     MSqlQuery query(MSqlQuery::InitCon());
-    query.prepare("SELECT CONCAT_WS('/', path, filename), date_modified, song_id "
+    query.prepare("SELECT CONCAT_WS('/', path, filename), date_modified, song_id, size "
                   "FROM music_songs LEFT JOIN music_directories ON "
                   "music_songs.directory_id=music_directories.directory_id "
                   "WHERE filename NOT LIKE BINARY ('%://%') "
@@ -820,7 +1015,8 @@ void MusicFileScanner::ScanMusic(MusicLoadedMap &music_files, QList<int> &songid
 
             if (iter != music_files.end())
             {
-                if (m_forceupdate || HasFileChanged(name, query.value(1).toString()))
+                if (m_forceupdate || HasFileChanged(name, *iter, query.value(1).toString(),
+                                                    query.value(3).toULongLong()))
                 {
                     music_files[name].location = MusicFileScanner::kNeedUpdate;
                 }
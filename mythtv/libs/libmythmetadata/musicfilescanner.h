@@ -6,6 +6,12 @@
 
 // Qt headers
 #include <QCoreApplication>
+#include <QDateTime>
+#include <QList>
+
+class AlbumArtImage;
+class MSqlQuery;
+class MusicMetadata;
 
 using IdCache = QMap<QString, int>;
 
@@ -24,6 +30,8 @@ class META_PUBLIC MusicFileScanner
     {
         QString startDir;
         MusicFileLocation location {kFileSystem};
+        qint64    size {0};     ///< as found by BuildFileList
+        QDateTime modified;     ///< as found by BuildFileList
     };
 
     using MusicLoadedMap = QMap <QString, MusicFileData>;
@@ -38,12 +46,16 @@ class META_PUBLIC MusicFileScanner
     private:
         void BuildFileList(QString &directory, MusicLoadedMap &music_files, MusicLoadedMap &art_files, int parentid);
         static int  GetDirectoryId(const QString &directory, int parentid);
-        static bool HasFileChanged(const QString &filename, const QString &date_modified);
-        void AddMusicToDB(const QString &filename, const QString &startDir);
+        static bool HasFileChanged(const QString &filename, const MusicFileData &fdata,
+                                   const QString &date_modified, quint64 size);
+        void ImportMusic(const MusicLoadedMap &music_files, MSqlQuery &transaction);
+        void AddMusicToDB(const QString &filename, const MusicFileData &fdata,
+                          MusicMetadata *data, QList<AlbumArtImage*> &artList);
         void AddArtworkToDB(const QString &filename, const QString &startDir);
         void RemoveMusicFromDB(int songid);
         void RemoveArtworkFromDB(int albumartid);
-        void UpdateMusicInDB(const QString &filename, const QString &startDir);
+        void UpdateMusicInDB(const QString &filename, const MusicFileData &fdata,
+                             MusicMetadata *disk_meta);
         void ScanMusic(MusicLoadedMap &music_files, QList<int> &songidsToDelete);
         void ScanArtwork(MusicLoadedMap &art_files, QList<int> &albumartidsToDelete);
         static void cleanDB();
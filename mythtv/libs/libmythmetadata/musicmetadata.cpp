@@ -1,6 +1,7 @@
 
 #include "musicmetadata.h"
 
+#include <algorithm>
 #include <thread>
 #include <utility>
 
@@ -10,6 +11,7 @@
 #include <QDir>
 #include <QDomDocument>
 #include <QScopedPointer>
+#include <QSet>
 
 // mythtv
 #include "libmythbase/mythcorecontext.h"
@@ -1502,6 +1504,69 @@ bool AllMusic::startLoading(void)
     return true;
 }
 
+// the columns track_from_query() expects
+static const QString kTrackQuery =
+    "SELECT music_songs.song_id, music_artists.artist_id, music_artists.artist_name, "
+    "music_comp_artists.artist_name AS compilation_artist, "
+    "music_albums.album_id, music_albums.album_name, music_songs.name, music_genres.genre, music_songs.year, "
+    "music_songs.track, music_songs.length, music_songs.directory_id, "
+    "CONCAT_WS('/', music_directories.path, music_songs.filename) AS filename, "
+    "music_songs.rating, music_songs.numplays, music_songs.lastplay, music_songs.date_entered, "
+    "music_albums.compilation, music_songs.format, music_songs.track_count, "
+    "music_songs.size, music_songs.hostname, music_songs.disc_number, music_songs.disc_count, "
+    "music_albums.artist_id "
+    "FROM music_songs "
+    "LEFT JOIN music_directories ON music_songs.directory_id=music_directories.directory_id "
+    "LEFT JOIN music_artists ON music_songs.artist_id=music_artists.artist_id "
+    "LEFT JOIN music_albums ON music_songs.album_id=music_albums.album_id "
+    "LEFT JOIN music_artists AS music_comp_artists ON music_albums.artist_id=music_comp_artists.artist_id "
+    "LEFT JOIN music_genres ON music_songs.genre_id=music_genres.genre_id ";
+
+static MusicTrackIndex::Track track_from_query(const MSqlQuery &query)
+{
+    MusicTrackIndex::Track track;
+    track.m_id                  = query.value(0).toUInt();
+    track.m_artistId            = query.value(1).toInt();
+    track.m_artist              = query.value(2).toString();
+    track.m_compilationArtist   = query.value(3).toString();
+    track.m_albumId             = query.value(4).toInt();
+    track.m_album               = query.value(5).toString();
+    track.m_title               = query.value(6).toString();
+    track.m_genre               = query.value(7).toString();
+    track.m_year                = query.value(8).toInt();
+    track.m_track               = query.value(9).toInt();
+    track.m_length              = query.value(10).toInt();
+    track.m_directoryId         = query.value(11).toInt();
+    track.m_filename            = query.value(12).toString();
+    track.m_rating              = query.value(13).toInt();
+    track.m_playCount           = query.value(14).toInt();
+    track.m_lastPlay            = query.value(15).toDateTime();
+    track.m_dateAdded           = query.value(16).toDateTime();
+    track.m_compilation         = (query.value(17).toInt() > 0);
+    track.m_format              = query.value(18).toString();
+    track.m_trackCount          = query.value(19).toInt();
+    track.m_fileSize            = query.value(20).toULongLong();
+    track.m_hostname            = query.value(21).toString();
+    track.m_discNumber          = query.value(22).toInt();
+    track.m_discCount           = query.value(23).toInt();
+    track.m_compilationArtistId = query.value(24).toInt();
+
+    // fill in the blanks the same way MusicMetadata does so that views
+    // grouping on the index see what they would see in the MusicMetadata
+    if (track.m_artist.isEmpty())
+        track.m_artist = MusicMetadata::tr("Unknown Artist", "Default artist if no artist");
+    if (!track.m_compilation || track.m_compilationArtist.isEmpty())
+        track.m_compilationArtist = track.m_artist;
+    if (track.m_album.isEmpty())
+        track.m_album = MusicMetadata::tr("Unknown Album", "Default album if no album");
+    if (track.m_title.isEmpty())
+        track.m_title = track.m_filename;
+    if (track.m_genre.isEmpty())
+        track.m_genre = MusicMetadata::tr("Unknown Genre", "Default genre if no genre");
+
+    return track;
+}
+
 /// resync our cache with the database
 void AllMusic::resync()
 {
@@ -1511,106 +1576,52 @@ void AllMusic::resync()
 
     m_doneLoading = false;
 
-    QString aquery = "SELECT music_songs.song_id, music_artists.artist_id, music_artists.artist_name, "
-                     "music_comp_artists.artist_name AS compilation_artist, "
-                     "music_albums.album_id, music_albums.album_name, music_songs.name, music_genres.genre, music_songs.year, "
-                     "music_songs.track, music_songs.length, music_songs.directory_id, "
-                     "CONCAT_WS('/', music_directories.path, music_songs.filename) AS filename, "
-                     "music_songs.rating, music_songs.numplays, music_songs.lastplay, music_songs.date_entered, "
-                     "music_albums.compilation, music_songs.format, music_songs.track_count, "
-                     "music_songs.size, music_songs.hostname, music_songs.disc_number, music_songs.disc_count "
-                     "FROM music_songs "
-                     "LEFT JOIN music_directories ON music_songs.directory_id=music_directories.directory_id "
-                     "LEFT JOIN music_artists ON music_songs.artist_id=music_artists.artist_id "
-                     "LEFT JOIN music_albums ON music_songs.album_id=music_albums.album_id "
-                     "LEFT JOIN music_artists AS music_comp_artists ON music_albums.artist_id=music_comp_artists.artist_id "
-                     "LEFT JOIN music_genres ON music_songs.genre_id=music_genres.genre_id "
-                     "ORDER BY music_songs.song_id;";
-
     MSqlQuery query(MSqlQuery::InitCon());
-    if (!query.exec(aquery))
+    if (!query.exec(kTrackQuery + "ORDER BY music_songs.song_id;"))
         MythDB::DBError("AllMusic::resync", query);
 
-    m_numPcs = query.size() * 2;
+    m_numPcs = query.size();
     m_numLoaded = 0;
-    QList<MusicMetadata::IdType> idList;
+
+    // only the rows that differ from the index are applied, tracks that
+    // someone has created MusicMetadata for are reloaded if they changed
+    QSet<MusicMetadata::IdType> idList;
+    QList<MusicMetadata::IdType> changedList;
 
     if (query.isActive() && query.size() > 0)
     {
+        idList.reserve(query.size());
+        m_index.reserve(query.size());
+
         while (query.next())
         {
-            MusicMetadata::IdType id = query.value(0).toInt();
-
-            idList.append(id);
-
-            auto *dbMeta = new MusicMetadata(
-                query.value(12).toString(),    // filename
-                query.value(2).toString(),     // artist
-                query.value(3).toString(),     // compilation artist
-                query.value(5).toString(),     // album
-                query.value(6).toString(),     // title
-                query.value(7).toString(),     // genre
-                query.value(8).toInt(),        // year
-                query.value(9).toInt(),        // track no.
-                std::chrono::milliseconds(query.value(10).toInt()),       // length
-                query.value(0).toInt(),        // id
-                query.value(13).toInt(),       // rating
-                query.value(14).toInt(),       // playcount
-                query.value(15).toDateTime(),  // lastplay
-                query.value(16).toDateTime(),  // date_entered
-                (query.value(17).toInt() > 0), // compilation
-                query.value(18).toString());   // format
-
-            dbMeta->setDirectoryId(query.value(11).toInt());
-            dbMeta->setArtistId(query.value(1).toInt());
-            dbMeta->setCompilationArtistId(query.value(3).toInt());
-            dbMeta->setAlbumId(query.value(4).toInt());
-            dbMeta->setTrackCount(query.value(19).toInt());
-            dbMeta->setFileSize(query.value(20).toULongLong());
-            dbMeta->setHostname(query.value(21).toString());
-            dbMeta->setDiscNumber(query.value(22).toInt());
-            dbMeta->setDiscCount(query.value(23).toInt());
+            MusicTrackIndex::Track track = track_from_query(query);
+            idList.insert(track.m_id);
 
-            if (!m_musicMap.contains(id))
+            switch (m_index.update(track))
             {
-                // new track
-
-                //  Don't delete dbMeta, as the MetadataPtrList now owns it
-                m_allMusic.append(dbMeta);
-
-                m_musicMap[id] = dbMeta;
-
-                added++;
-            }
-            else
-            {
-                // existing track, check for any changes
-                MusicMetadata *cacheMeta = m_musicMap[id];
-
-                if (cacheMeta && !cacheMeta->compare(dbMeta))
-                {
-                    cacheMeta->reloadMetadata();
-                    changed++;
-                }
-
-                // we already have this track in the cache so don't need dbMeta anymore
-                delete dbMeta;
+                case MusicTrackIndex::kAdded:
+                    added++;
+                    break;
+                case MusicTrackIndex::kChanged:
+                    changedList.append(track.m_id);
+                    break;
+                case MusicTrackIndex::kUnchanged:
+                    break;
             }
 
             // compute max/min playcount,lastplay for all music
+            qint64 lastPlay = track.m_lastPlay.toSecsSinceEpoch();
             if (query.at() == 0)
             {
                 // first song
-                m_playCountMin = m_playCountMax = query.value(13).toInt();
-                m_lastPlayMin  = m_lastPlayMax  = query.value(14).toDateTime().toSecsSinceEpoch();
+                m_playCountMin = m_playCountMax = track.m_playCount;
+                m_lastPlayMin  = m_lastPlayMax  = lastPlay;
             }
             else
             {
-                int playCount = query.value(13).toInt();
-                qint64 lastPlay = query.value(14).toDateTime().toSecsSinceEpoch();
-
-                m_playCountMin = std::min(playCount, m_playCountMin);
-                m_playCountMax = std::max(playCount, m_playCountMax);
+                m_playCountMin = std::min(track.m_playCount, m_playCountMin);
+                m_playCountMax = std::max(track.m_playCount, m_playCountMax);
                 m_lastPlayMin  = std::min(lastPlay,  m_lastPlayMin);
                 m_lastPlayMax  = std::max(lastPlay,  m_lastPlayMax);
             }
@@ -1622,25 +1633,39 @@ void AllMusic::resync()
          LOG(VB_GENERAL, LOG_ERR, "MythMusic hasn't found any tracks!");
     }
 
-    // get a list of tracks in our cache that's now not in the database
-    QList<MusicMetadata::IdType> deleteList;
-    for (const auto *track : std::as_const(m_allMusic))
+    // remove the tracks that are no longer in the database
+    const QList<MusicMetadata::IdType> indexIds = m_index.ids();
+    for (MusicMetadata::IdType id : indexIds)
     {
-        if (!idList.contains(track->ID()))
+        if (idList.contains(id))
+            continue;
+
+        m_index.remove(id);
+        removed++;
+
+        QMutexLocker locker(&m_musicLock);
+        MusicMetadata *mdata = m_musicMap.take(id);
+        if (mdata)
         {
-            deleteList.append(track->ID());
+            m_allMusic.removeAll(mdata);
+            delete mdata;
         }
     }
 
-    // remove the no longer available tracks
-    for (uint id : deleteList)
+    // reload the changed tracks we have handed out
     {
-        MusicMetadata *mdata = m_musicMap[id];
-        m_allMusic.removeAll(mdata);
-        m_musicMap.remove(id);
-        removed++;
-        delete mdata;
+        QMutexLocker locker(&m_musicLock);
+        for (MusicMetadata::IdType id : std::as_const(changedList))
+        {
+            MusicMetadata *cacheMeta = m_musicMap.value(id);
+            if (cacheMeta)
+                cacheMeta->reloadMetadata();
+        }
     }
+    changed = changedList.size();
+
+    LOG(VB_GENERAL, LOG_INFO, QString("AllMusic::resync indexed %1 tracks in about %2 KiB")
+                                     .arg(m_index.count()).arg(m_index.memoryUsage() / 1024));
 
     // tell any listeners a resync has just finished and they may need to reload/resync
     LOG(VB_GENERAL, LOG_DEBUG, QString("AllMusic::resync sending MUSIC_RESYNC_FINISHED added: %1, removed: %2, changed: %3")
@@ -1650,17 +1675,128 @@ void AllMusic::resync()
     m_doneLoading = true;
 }
 
+/// re-read a single track from the database, after its tags were edited for example
+bool AllMusic::refreshTrack(int an_id)
+{
+    MSqlQuery query(MSqlQuery::InitCon());
+    query.prepare(kTrackQuery + "WHERE music_songs.song_id = :ID ;");
+    query.bindValue(":ID", an_id);
+
+    if (!query.exec())
+    {
+        MythDB::DBError("AllMusic::refreshTrack", query);
+        return false;
+    }
+
+    if (!query.next())
+        return false;
+
+    m_index.update(track_from_query(query));
+
+    QMutexLocker locker(&m_musicLock);
+    MusicMetadata *mdata = m_musicMap.value(an_id);
+    if (mdata)
+        mdata->reloadMetadata();
+
+    return true;
+}
+
+/// copy the rating and play count of a track to the index after they changed
+void AllMusic::updateTrackStats(int an_id)
+{
+    QMutexLocker locker(&m_musicLock);
+    MusicMetadata *mdata = m_musicMap.value(an_id);
+    if (mdata && mdata->isDBTrack())
+        m_index.updateStats(mdata->ID(), mdata->Rating(), mdata->PlayCount(), mdata->LastPlay());
+}
+
+/// \note call with m_musicLock held
+MusicMetadata *AllMusic::createMetadata(MusicMetadata::IdType an_id)
+{
+    MusicTrackIndex::Track track;
+    if (!m_index.getTrack(an_id, track))
+        return nullptr;
+
+    auto *mdata = new MusicMetadata(
+        track.m_filename,
+        track.m_artist,
+        track.m_compilationArtist,
+        track.m_album,
+        track.m_title,
+        track.m_genre,
+        track.m_year,
+        track.m_track,
+        std::chrono::milliseconds(track.m_length),
+        static_cast<int>(track.m_id),
+        track.m_rating,
+        track.m_playCount,
+        track.m_lastPlay,
+        track.m_dateAdded,
+        track.m_compilation,
+        track.m_format);
+
+    mdata->setDirectoryId(track.m_directoryId);
+    mdata->setArtistId(track.m_artistId);
+    mdata->setCompilationArtistId(track.m_compilationArtistId);
+    mdata->setAlbumId(track.m_albumId);
+    mdata->setTrackCount(track.m_trackCount);
+    mdata->setFileSize(track.m_fileSize);
+    mdata->setHostname(track.m_hostname);
+    mdata->setDiscNumber(track.m_discNumber);
+    mdata->setDiscCount(track.m_discCount);
+
+    m_musicMap[an_id] = mdata;
+    m_allMusic.append(mdata);
+    m_allMusicSorted = false;
+
+    return mdata;
+}
+
 MusicMetadata* AllMusic::getMetadata(int an_id)
 {
-    if (m_musicMap.contains(an_id))
-        return m_musicMap[an_id];
+    QMutexLocker locker(&m_musicLock);
 
-    return nullptr;
+    MusicMetadata *mdata = m_musicMap.value(an_id);
+    if (mdata)
+        return mdata;
+
+    return createMetadata(an_id);
 }
 
 bool AllMusic::isValidID(int an_id)
 {
-    return m_musicMap.contains(an_id);
+    QMutexLocker locker(&m_musicLock);
+    return m_musicMap.contains(an_id) || m_index.contains(an_id);
+}
+
+/** \brief Get MusicMetadata for every track in the library.
+ *
+ *  This creates MusicMetadata for every track that doesn't have it yet so
+ *  where possible query getIndex() for the tracks needed instead.
+ */
+MetadataPtrList *AllMusic::getAllMetadata(void)
+{
+    QMutexLocker locker(&m_musicLock);
+
+    if (m_allMusic.size() < m_index.count())
+    {
+        const QList<MusicMetadata::IdType> ids = m_index.ids();
+        for (MusicMetadata::IdType id : ids)
+        {
+            if (!m_musicMap.contains(id))
+                createMetadata(id);
+        }
+    }
+
+    if (!m_allMusicSorted)
+    {
+        std::sort(m_allMusic.begin(), m_allMusic.end(),
+                  [](const MusicMetadata *a, const MusicMetadata *b)
+                  { return a->ID() < b->ID(); });
+        m_allMusicSorted = true;
+    }
+
+    return &m_allMusic;
 }
 
 bool AllMusic::updateMetadata(int an_id, MusicMetadata *the_track)
@@ -1671,6 +1807,7 @@ bool AllMusic::updateMetadata(int an_id, MusicMetadata *the_track)
         if (mdata)
         {
             *mdata = *the_track;
+            updateTrackStats(an_id);
             return true;
         }
     }
@@ -1680,16 +1817,23 @@ bool AllMusic::updateMetadata(int an_id, MusicMetadata *the_track)
 /// \brief Check each MusicMetadata entry and save those that have changed (ratings, etc.)
 void AllMusic::save(void)
 {
+    QMutexLocker locker(&m_musicLock);
+
     for (auto *item : std::as_const(m_allMusic))
     {
         if (item->hasChanged())
+        {
             item->persist();
+            m_index.updateStats(item->ID(), item->Rating(), item->PlayCount(), item->LastPlay());
+        }
     }
 }
 
 // cd stuff
 void AllMusic::clearCDData(void)
 {
+    QMutexLocker locker(&m_musicLock);
+
     while (!m_cdData.empty())
     {
         MusicMetadata *mdata = m_cdData.back();
@@ -1705,6 +1849,8 @@ void AllMusic::clearCDData(void)
 
 void AllMusic::addCDTrack(const MusicMetadata &the_track)
 {
+    QMutexLocker locker(&m_musicLock);
+
     auto *mdata = new MusicMetadata(the_track);
     mdata->setID(m_cdData.count() + 1);
     mdata->setRepo(RT_CD);
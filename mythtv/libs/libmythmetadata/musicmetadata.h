@@ -6,6 +6,7 @@
 // C/C++
 #include <array>
 #include <cstdint>
+#include <type_traits>
 #include <utility>
 
 // qt
@@ -14,12 +15,14 @@
 #include <QImage>
 #include <QMap>
 #include <QMetaType>
+#include <QMutex>
 #include <QStringList>
 #include <QTimeZone>
 
 // MythTV
 #include "libmythbase/mthread.h"
 #include "libmythbase/mythtypes.h"
+#include "libmythmetadata/musictrackindex.h"
 #include "libmythmetadata/mythmetaexp.h"
 
 class AllMusic;
@@ -401,6 +404,9 @@ Q_DECLARE_METATYPE(MusicMetadata)
 
 using MetadataPtrList = QList<MusicMetadata*>;
 Q_DECLARE_METATYPE(MetadataPtrList *)
+static_assert(std::is_same_v<MusicMetadata::IdType, MusicTrackIndex::IdType>);
+using MusicTrackIdList = QList<MusicMetadata::IdType>;
+Q_DECLARE_METATYPE(MusicTrackIdList *)
 Q_DECLARE_METATYPE(ImageType);
 
 //---------------------------------------------------------------------------
@@ -439,6 +445,8 @@ class META_PUBLIC AllMusic
     void        save();
     bool        startLoading(void);
     void        resync();   //  After a CD rip, for example
+    bool        refreshTrack(int an_id);
+    void        updateTrackStats(int an_id);
 
     // cd stuff
     void        clearCDData(void);
@@ -452,19 +460,27 @@ class META_PUBLIC AllMusic
     bool        doneLoading() const { return m_doneLoading; }
     bool        cleanOutThreads();
 
-    MetadataPtrList *getAllMetadata(void) { return &m_allMusic; }
+    MetadataPtrList *getAllMetadata(void);
     MetadataPtrList *getAllCDMetadata(void) { return &m_cdData; }
+    MusicTrackIndex *getIndex(void) { return &m_index; }
 
     bool isValidID(int an_id);
 
   private:
+    MusicMetadata *createMetadata(MusicMetadata::IdType an_id);
+
+    // the tracks are kept in the index, MusicMetadata for a track is only
+    // created the first time someone asks for it
+    MusicTrackIndex     m_index;
     MetadataPtrList     m_allMusic;
+    bool                m_allMusicSorted        {true};
 
     int m_numPcs                               {0};
     int m_numLoaded                            {0};
 
     using MusicMap = QMap<int, MusicMetadata*>;
     MusicMap m_musicMap;
+    QMutex   m_musicLock;   ///< protects m_musicMap and m_allMusic
 
     // cd stuff
     MetadataPtrList m_cdData; //  More than one cd player?
@@ -0,0 +1,797 @@
+#include "musictrackindex.h"
+
+// C/C++
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+// MythTV
+#include "libmythbase/mythdate.h"
+
+uint32_t MusicStringPool::intern(const QString &value)
+{
+    auto it = m_index.constFind(value);
+    if (it != m_index.constEnd())
+        return it.value();
+
+    auto index = static_cast<uint32_t>(m_values.size());
+    m_values.append(value);
+    m_index.insert(value, index);
+    return index;
+}
+
+void MusicStringPool::clear(void)
+{
+    m_values.clear();
+    m_index.clear();
+}
+
+std::vector<bool> MusicStringPool::match(const QString &text) const
+{
+    std::vector<bool> result(m_values.size(), false);
+    for (int x = 0; x < m_values.size(); x++)
+        result[x] = m_values.at(x).contains(text, Qt::CaseInsensitive);
+    return result;
+}
+
+size_t MusicStringPool::memoryUsage(void) const
+{
+    size_t size = (m_values.size() * sizeof(QString)) +
+                  (m_index.size() * (sizeof(QString) + sizeof(uint32_t) + sizeof(void*)));
+    for (const auto &value : std::as_const(m_values))
+        size += value.capacity() * sizeof(QChar);
+    return size;
+}
+
+//--------------------------------------------------------------------------
+
+template <typename T>
+static T clamp_to(qint64 value)
+{
+    return static_cast<T>(std::clamp<qint64>(value, std::numeric_limits<T>::min(),
+                                             std::numeric_limits<T>::max()));
+}
+
+static uint32_t to_secs(const QDateTime &datetime)
+{
+    return datetime.isValid() ? clamp_to<uint32_t>(datetime.toSecsSinceEpoch()) : 0;
+}
+
+static QDateTime from_secs(uint32_t secs)
+{
+    return secs ? MythDate::fromSecsSinceEpoch(secs) : QDateTime();
+}
+
+MusicTrackIndex::UpdateResult MusicTrackIndex::update(const Track &track)
+{
+    QMutexLocker locker(&m_lock);
+
+    Strings strings;
+    strings.m_artist            = m_artists.intern(track.m_artist);
+    strings.m_compilationArtist = m_artists.intern(track.m_compilationArtist);
+    strings.m_album             = m_albums.intern(track.m_album);
+    strings.m_title             = m_titles.intern(track.m_title);
+    strings.m_genre             = m_genres.intern(track.m_genre);
+    // the directory is shared by the tracks in it so only the name is kept
+    // per track, split so that joining the two gives the filename back
+    qsizetype slash = track.m_filename.lastIndexOf('/');
+    QString name = slash < 0 ? track.m_filename : track.m_filename.mid(slash);
+    strings.m_directory         = m_directories.intern(slash < 0 ? QString() : track.m_filename.left(slash));
+    strings.m_hostname          = m_hostnames.intern(track.m_hostname);
+    strings.m_format            = m_formats.intern(track.m_format);
+
+    Numbers numbers;
+    numbers.m_length      = clamp_to<uint32_t>(track.m_length);
+    numbers.m_playCount   = clamp_to<uint32_t>(track.m_playCount);
+    numbers.m_lastPlay    = to_secs(track.m_lastPlay);
+    numbers.m_dateAdded   = to_secs(track.m_dateAdded);
+    numbers.m_year        = clamp_to<int16_t>(track.m_year);
+    numbers.m_track       = clamp_to<uint16_t>(track.m_track);
+    numbers.m_trackCount  = clamp_to<uint16_t>(track.m_trackCount);
+    numbers.m_discNumber  = clamp_to<uint8_t>(track.m_discNumber);
+    numbers.m_discCount   = clamp_to<uint8_t>(track.m_discCount);
+    numbers.m_rating      = clamp_to<uint8_t>(track.m_rating);
+    numbers.m_compilation = track.m_compilation;
+
+    DBIds dbIds { track.m_artistId, track.m_compilationArtistId, track.m_albumId, track.m_directoryId };
+
+    int index = row(track.m_id);
+    if (index < 0)
+    {
+        m_rows.insert(track.m_id, static_cast<int>(m_ids.size()));
+        m_ids.push_back(track.m_id);
+        m_strings.push_back(strings);
+        m_numbers.push_back(numbers);
+        m_dbIds.push_back(dbIds);
+        m_filenames.push_back(name);
+        m_fileSizes.push_back(track.m_fileSize);
+        m_changes.push_back(0);
+        touch(static_cast<int>(m_ids.size()) - 1);
+        return kAdded;
+    }
+
+    if (m_strings[index] == strings && m_numbers[index] == numbers &&
+        m_dbIds[index] == dbIds && m_filenames[index] == name &&
+        m_fileSizes[index] == track.m_fileSize)
+        return kUnchanged;
+
+    m_strings[index]   = strings;
+    m_numbers[index]   = numbers;
+    m_dbIds[index]     = dbIds;
+    m_filenames[index] = name;
+    m_fileSizes[index] = track.m_fileSize;
+    touch(index);
+    return kChanged;
+}
+
+/// update the fields that change as a track is played and rated
+bool MusicTrackIndex::updateStats(IdType id, int rating, int playCount, const QDateTime &lastPlay)
+{
+    QMutexLocker locker(&m_lock);
+
+    int index = row(id);
+    if (index < 0)
+        return false;
+
+    Numbers numbers = m_numbers[index];
+    numbers.m_rating    = clamp_to<uint8_t>(rating);
+    numbers.m_playCount = clamp_to<uint32_t>(playCount);
+    numbers.m_lastPlay  = to_secs(lastPlay);
+    if (!(numbers == m_numbers[index]))
+    {
+        m_numbers[index] = numbers;
+        touch(index);
+    }
+    return true;
+}
+
+bool MusicTrackIndex::remove(IdType id)
+{
+    QMutexLocker locker(&m_lock);
+
+    int index = row(id);
+    if (index < 0)
+        return false;
+
+    // move the last row into the hole
+    int last = static_cast<int>(m_ids.size()) - 1;
+    if (index != last)
+    {
+        m_ids[index]       = m_ids[last];
+        m_strings[index]   = m_strings[last];
+        m_numbers[index]   = m_numbers[last];
+        m_dbIds[index]     = m_dbIds[last];
+        m_filenames[index] = std::move(m_filenames[last]);
+        m_fileSizes[index] = m_fileSizes[last];
+        m_changes[index]   = m_changes[last];
+        m_rows[m_ids[index]] = index;
+    }
+
+    m_ids.pop_back();
+    m_strings.pop_back();
+    m_numbers.pop_back();
+    m_dbIds.pop_back();
+    m_filenames.pop_back();
+    m_fileSizes.pop_back();
+    m_changes.pop_back();
+    m_rows.remove(id);
+
+    // only the recent removals are kept, anything older has to start again
+    m_removals.emplace_back(++m_generation, id);
+    if (m_removals.size() > kMaxRemovals)
+    {
+        auto keep = m_removals.end() - (kMaxRemovals / 2);
+        m_removedFloor = (keep - 1)->first;
+        m_removals.erase(m_removals.begin(), keep);
+    }
+    return true;
+}
+
+void MusicTrackIndex::clear(void)
+{
+    QMutexLocker locker(&m_lock);
+
+    m_rows.clear();
+    m_ids.clear();
+    m_strings.clear();
+    m_numbers.clear();
+    m_dbIds.clear();
+    m_filenames.clear();
+    m_fileSizes.clear();
+    m_changes.clear();
+    m_removals.clear();
+    m_removedFloor = ++m_generation;
+
+    m_artists.clear();
+    m_albums.clear();
+    m_titles.clear();
+    m_genres.clear();
+    m_directories.clear();
+    m_hostnames.clear();
+    m_formats.clear();
+}
+
+void MusicTrackIndex::reserve(int count)
+{
+    QMutexLocker locker(&m_lock);
+
+    m_rows.reserve(count);
+    m_ids.reserve(count);
+    m_strings.reserve(count);
+    m_numbers.reserve(count);
+    m_dbIds.reserve(count);
+    m_filenames.reserve(count);
+    m_fileSizes.reserve(count);
+    m_changes.reserve(count);
+}
+
+int MusicTrackIndex::count(void) const
+{
+    QMutexLocker locker(&m_lock);
+    return static_cast<int>(m_ids.size());
+}
+
+bool MusicTrackIndex::contains(IdType id) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_rows.contains(id);
+}
+
+bool MusicTrackIndex::getTrack(IdType id, Track &track) const
+{
+    QMutexLocker locker(&m_lock);
+
+    int index = row(id);
+    if (index < 0)
+        return false;
+
+    const Strings &strings = m_strings[index];
+    const Numbers &numbers = m_numbers[index];
+
+    track.m_id                = id;
+    track.m_artist            = m_artists.at(strings.m_artist);
+    track.m_compilationArtist = m_artists.at(strings.m_compilationArtist);
+    track.m_album             = m_albums.at(strings.m_album);
+    track.m_title             = m_titles.at(strings.m_title);
+    track.m_genre             = m_genres.at(strings.m_genre);
+    track.m_filename          = m_directories.at(strings.m_directory) + m_filenames[index];
+    track.m_hostname          = m_hostnames.at(strings.m_hostname);
+    track.m_format            = m_formats.at(strings.m_format);
+    track.m_year              = numbers.m_year;
+    track.m_track             = numbers.m_track;
+    track.m_trackCount        = numbers.m_trackCount;
+    track.m_discNumber        = numbers.m_discNumber;
+    track.m_discCount         = numbers.m_discCount;
+    track.m_length            = static_cast<int>(std::min<uint32_t>(numbers.m_length, std::numeric_limits<int>::max()));
+    track.m_rating            = numbers.m_rating;
+    track.m_playCount         = static_cast<int>(std::min<uint32_t>(numbers.m_playCount, std::numeric_limits<int>::max()));
+    track.m_lastPlay          = from_secs(numbers.m_lastPlay);
+    track.m_dateAdded         = from_secs(numbers.m_dateAdded);
+    track.m_fileSize          = m_fileSizes[index];
+    track.m_compilation       = numbers.m_compilation;
+    track.m_artistId          = m_dbIds[index].m_artist;
+    track.m_compilationArtistId = m_dbIds[index].m_compilationArtist;
+    track.m_albumId           = m_dbIds[index].m_album;
+    track.m_directoryId       = m_dbIds[index].m_directory;
+    return true;
+}
+
+/// every track id, lowest first
+QList<MusicTrackIndex::IdType> MusicTrackIndex::ids(void) const
+{
+    QMutexLocker locker(&m_lock);
+
+    QList<IdType> result(m_ids.cbegin(), m_ids.cend());
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+QString MusicTrackIndex::text(IdType id, Field field) const
+{
+    QMutexLocker locker(&m_lock);
+
+    int index = row(id);
+    return index < 0 ? QString() : rowText(index, field);
+}
+
+qint64 MusicTrackIndex::value(IdType id, Field field) const
+{
+    QMutexLocker locker(&m_lock);
+
+    int index = row(id);
+    return index < 0 ? 0 : rowValue(index, field);
+}
+
+QList<MusicTrackIndex::IdType> MusicTrackIndex::search(const QString &text,
+                                                       const QList<Field> &fields) const
+{
+    QMutexLocker locker(&m_lock);
+
+    std::vector<bool> found(m_ids.size(), text.isEmpty());
+
+    if (!text.isEmpty())
+    {
+        for (Field field : fields)
+        {
+            if (field == kFilename)
+            {
+                for (size_t x = 0; x < m_filenames.size(); x++)
+                {
+                    if (!found[x])
+                        found[x] = rowText(static_cast<int>(x), kFilename).contains(text, Qt::CaseInsensitive);
+                }
+                continue;
+            }
+
+            const MusicStringPool *strings = pool(field);
+            if (!strings)
+                continue;
+
+            // match each distinct string once rather than once per track
+            std::vector<bool> matches = strings->match(text);
+            for (size_t x = 0; x < m_strings.size(); x++)
+            {
+                if (!found[x])
+                    found[x] = matches[stringOf(m_strings[x], field)];
+            }
+        }
+    }
+
+    QList<IdType> result;
+    for (size_t x = 0; x < found.size(); x++)
+    {
+        if (found[x])
+            result.append(m_ids[x]);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+QList<MusicTrackIndex::IdType> MusicTrackIndex::filter(const QList<IdType> &ids,
+                                                       Field field, qint64 value) const
+{
+    QMutexLocker locker(&m_lock);
+
+    QList<IdType> result;
+    for (IdType id : ids)
+    {
+        int index = row(id);
+        if (index >= 0 && rowValue(index, field) == value)
+            result.append(id);
+    }
+    return result;
+}
+
+QMap<QString, QList<MusicTrackIndex::IdType>> MusicTrackIndex::group(const QList<IdType> &ids,
+                                                                     Field field) const
+{
+    QMutexLocker locker(&m_lock);
+
+    QMap<QString, QList<IdType>> result;
+    const MusicStringPool *strings = pool(field);
+
+    if (!strings)
+    {
+        for (IdType id : ids)
+        {
+            int index = row(id);
+            if (index >= 0)
+                result[rowText(index, field)].append(id);
+        }
+        return result;
+    }
+
+    // group on the interned index and only look up each string once
+    QHash<uint32_t, QList<IdType>> groups;
+    for (IdType id : ids)
+    {
+        int index = row(id);
+        if (index >= 0)
+            groups[stringOf(m_strings[index], field)].append(id);
+    }
+
+    for (auto it = groups.cbegin(); it != groups.cend(); ++it)
+        result[strings->at(it.key())].append(it.value());
+    return result;
+}
+
+QMap<qint64, QList<MusicTrackIndex::IdType>> MusicTrackIndex::groupValues(const QList<IdType> &ids,
+                                                                          Field field) const
+{
+    QMutexLocker locker(&m_lock);
+
+    QMap<qint64, QList<IdType>> result;
+    for (IdType id : ids)
+    {
+        int index = row(id);
+        if (index >= 0)
+            result[rowValue(index, field)].append(id);
+    }
+    return result;
+}
+
+static bool test_text(const QString &text, const MusicTrackIndex::Condition &condition)
+{
+    using Condition = MusicTrackIndex::Condition;
+
+    switch (condition.m_op)
+    {
+        case Condition::kEqual:
+            return text.compare(condition.m_text1, Qt::CaseInsensitive) == 0;
+        case Condition::kNotEqual:
+            return text.compare(condition.m_text1, Qt::CaseInsensitive) != 0;
+        case Condition::kGreater:
+            return text.compare(condition.m_text1, Qt::CaseInsensitive) > 0;
+        case Condition::kLess:
+            return text.compare(condition.m_text1, Qt::CaseInsensitive) < 0;
+        case Condition::kStartsWith:
+            return text.startsWith(condition.m_text1, Qt::CaseInsensitive);
+        case Condition::kEndsWith:
+            return text.endsWith(condition.m_text1, Qt::CaseInsensitive);
+        case Condition::kContains:
+            return text.contains(condition.m_text1, Qt::CaseInsensitive);
+        case Condition::kNotContains:
+            return !text.contains(condition.m_text1, Qt::CaseInsensitive);
+        case Condition::kBetween:
+        case Condition::kNotBetween:
+        {
+            bool between = text.compare(condition.m_text1, Qt::CaseInsensitive) >= 0 &&
+                           text.compare(condition.m_text2, Qt::CaseInsensitive) <= 0;
+            return between == (condition.m_op == Condition::kBetween);
+        }
+        case Condition::kIsSet:
+            return !text.isEmpty();
+        case Condition::kIsNotSet:
+            return text.isEmpty();
+    }
+    return false;
+}
+
+static bool test_value(qint64 value, bool isNull, const MusicTrackIndex::Condition &condition)
+{
+    using Condition = MusicTrackIndex::Condition;
+
+    if (condition.m_op == Condition::kIsSet)
+        return !isNull;
+    if (condition.m_op == Condition::kIsNotSet)
+        return isNull;
+    // as in SQL nothing else matches a NULL
+    if (isNull)
+        return false;
+
+    switch (condition.m_op)
+    {
+        case Condition::kEqual:      return value == condition.m_value1;
+        case Condition::kNotEqual:   return value != condition.m_value1;
+        case Condition::kGreater:    return value > condition.m_value1;
+        case Condition::kLess:       return value < condition.m_value1;
+        case Condition::kBetween:
+            return value >= condition.m_value1 && value <= condition.m_value2;
+        case Condition::kNotBetween:
+            return value < condition.m_value1 || value > condition.m_value2;
+        default:
+            // a text test of a number tests the digits
+            return test_text(QString::number(value), condition);
+    }
+}
+
+QList<MusicTrackIndex::IdType> MusicTrackIndex::select(const QList<Condition> &conditions,
+                                                       bool matchAll,
+                                                       const QList<IdType> *ids) const
+{
+    QMutexLocker locker(&m_lock);
+
+    // test each distinct string of a text field once rather than once per track
+    std::vector<std::vector<bool>> textMatches(conditions.size());
+    for (int x = 0; x < conditions.size(); x++)
+    {
+        const MusicStringPool *strings = pool(conditions[x].m_field);
+        if (!strings)
+            continue;
+
+        textMatches[x].resize(strings->count());
+        for (uint32_t y = 0; y < strings->count(); y++)
+            textMatches[x][y] = test_text(strings->at(y), conditions[x]);
+    }
+
+    auto matches = [&](int rowIndex)
+    {
+        for (int x = 0; x < conditions.size(); x++)
+        {
+            const Condition &condition = conditions[x];
+            bool match = false;
+            if (!textMatches[x].empty())
+            {
+                match = textMatches[x][stringOf(m_strings[rowIndex], condition.m_field)];
+            }
+            else if (condition.m_field == kFilename)
+            {
+                match = test_text(rowText(rowIndex, kFilename), condition);
+            }
+            else
+            {
+                qint64 value = rowValue(rowIndex, condition.m_field);
+                bool isNull = (condition.m_field == kLastPlay ||
+                               condition.m_field == kDateAdded) && value == 0;
+                match = test_value(value, isNull, condition);
+            }
+
+            if (match != matchAll)
+                return match;
+        }
+        return matchAll || conditions.isEmpty();
+    };
+
+    QList<IdType> result;
+    if (ids)
+    {
+        for (IdType id : *ids)
+        {
+            int index = row(id);
+            if (index >= 0 && matches(index))
+                result.append(id);
+        }
+    }
+    else
+    {
+        for (size_t x = 0; x < m_ids.size(); x++)
+        {
+            if (matches(static_cast<int>(x)))
+                result.append(m_ids[x]);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void MusicTrackIndex::sort(QList<IdType> &ids, const SortOrder &order) const
+{
+    if (order.isEmpty() || ids.size() < 2)
+        return;
+
+    QMutexLocker locker(&m_lock);
+
+    // reduce every field to a number that sorts the same way, text by its
+    // rank amongst the distinct strings of the field
+    std::vector<std::vector<qint64>> keys(order.size(), std::vector<qint64>(ids.size(), 0));
+    for (int x = 0; x < order.size(); x++)
+    {
+        Field field = order[x].first;
+        std::vector<qint64> &key = keys[x];
+
+        if (isText(field))
+        {
+            QStringList texts;
+            std::vector<uint32_t> textOf(ids.size(), 0);
+            const MusicStringPool *strings = pool(field);
+            if (strings)
+            {
+                for (uint32_t y = 0; y < strings->count(); y++)
+                    texts.append(strings->at(y));
+            }
+            for (int y = 0; y < ids.size(); y++)
+            {
+                int index = row(ids[y]);
+                if (index < 0)
+                    continue;
+                if (strings)
+                {
+                    textOf[y] = stringOf(m_strings[index], field);
+                }
+                else
+                {
+                    textOf[y] = static_cast<uint32_t>(texts.size());
+                    texts.append(rowText(index, field));
+                }
+            }
+
+            std::vector<uint32_t> sorted(texts.size());
+            std::iota(sorted.begin(), sorted.end(), 0);
+            std::sort(sorted.begin(), sorted.end(), [&texts](uint32_t a, uint32_t b)
+                { return texts[a].compare(texts[b], Qt::CaseInsensitive) < 0; });
+
+            std::vector<qint64> rank(texts.size(), 0);
+            for (size_t y = 1; y < sorted.size(); y++)
+            {
+                bool same = texts[sorted[y]].compare(texts[sorted[y - 1]], Qt::CaseInsensitive) == 0;
+                rank[sorted[y]] = rank[sorted[y - 1]] + (same ? 0 : 1);
+            }
+
+            for (int y = 0; y < ids.size(); y++)
+                key[y] = rank[textOf[y]];
+        }
+        else
+        {
+            for (int y = 0; y < ids.size(); y++)
+            {
+                int index = row(ids[y]);
+                key[y] = index < 0 ? 0 : rowValue(index, field);
+            }
+        }
+    }
+
+    std::vector<int> positions(ids.size());
+    std::iota(positions.begin(), positions.end(), 0);
+    std::stable_sort(positions.begin(), positions.end(), [&](int a, int b)
+    {
+        for (int x = 0; x < order.size(); x++)
+        {
+            if (keys[x][a] != keys[x][b])
+                return order[x].second ? keys[x][a] > keys[x][b] : keys[x][a] < keys[x][b];
+        }
+        return false;
+    });
+
+    QList<IdType> sorted;
+    sorted.reserve(ids.size());
+    for (int position : positions)
+        sorted.append(ids[position]);
+    ids = sorted;
+}
+
+uint32_t MusicTrackIndex::generation(void) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_generation;
+}
+
+bool MusicTrackIndex::changesSince(uint32_t generation, QList<IdType> &changed,
+                                   QList<IdType> &removed) const
+{
+    QMutexLocker locker(&m_lock);
+
+    changed.clear();
+    removed.clear();
+
+    if (generation < m_removedFloor)
+        return false;
+
+    for (size_t x = 0; x < m_changes.size(); x++)
+    {
+        if (m_changes[x] > generation)
+            changed.append(m_ids[x]);
+    }
+
+    for (const auto &[removedAt, id] : m_removals)
+    {
+        if (removedAt > generation)
+            removed.append(id);
+    }
+    return true;
+}
+
+/// an estimate of the memory the index is using
+size_t MusicTrackIndex::memoryUsage(void) const
+{
+    QMutexLocker locker(&m_lock);
+
+    size_t size = m_rows.size() * (sizeof(IdType) + sizeof(int) + sizeof(void*));
+    size += m_ids.capacity() * sizeof(IdType);
+    size += m_strings.capacity() * sizeof(Strings);
+    size += m_numbers.capacity() * sizeof(Numbers);
+    size += m_dbIds.capacity() * sizeof(DBIds);
+    size += m_fileSizes.capacity() * sizeof(uint64_t);
+    size += m_changes.capacity() * sizeof(uint32_t);
+    size += m_removals.capacity() * sizeof(std::pair<uint32_t, IdType>);
+    size += m_filenames.capacity() * sizeof(QString);
+    for (const auto &filename : m_filenames)
+        size += filename.capacity() * sizeof(QChar);
+
+    for (const auto *strings : { &m_artists, &m_albums, &m_titles, &m_genres,
+                                 &m_directories, &m_hostnames, &m_formats })
+        size += strings->memoryUsage();
+    return size;
+}
+
+QString MusicTrackIndex::rowText(int row, Field field) const
+{
+    if (field == kFilename)
+        return m_directories.at(m_strings[row].m_directory) + m_filenames[row];
+
+    const MusicStringPool *strings = pool(field);
+    if (strings)
+        return strings->at(stringOf(m_strings[row], field));
+
+    return QString::number(rowValue(row, field));
+}
+
+qint64 MusicTrackIndex::rowValue(int row, Field field) const
+{
+    const Numbers &numbers = m_numbers[row];
+
+    switch (field)
+    {
+        case kYear:        return numbers.m_year;
+        case kTrack:       return numbers.m_track;
+        case kTrackCount:  return numbers.m_trackCount;
+        case kDiscNumber:  return numbers.m_discNumber;
+        case kDiscCount:   return numbers.m_discCount;
+        case kLength:      return numbers.m_length;
+        case kRating:      return numbers.m_rating;
+        case kPlayCount:   return numbers.m_playCount;
+        case kLastPlay:    return numbers.m_lastPlay;
+        case kDateAdded:   return numbers.m_dateAdded;
+        case kFileSize:    return static_cast<qint64>(m_fileSizes[row]);
+        case kCompilation: return numbers.m_compilation ? 1 : 0;
+        case kArtistId:    return m_dbIds[row].m_artist;
+        case kAlbumId:     return m_dbIds[row].m_album;
+        case kDirectoryId: return m_dbIds[row].m_directory;
+        default:           return 0;
+    }
+}
+
+const MusicStringPool *MusicTrackIndex::pool(Field field) const
+{
+    switch (field)
+    {
+        case kArtist:
+        case kCompilationArtist: return &m_artists;
+        case kAlbum:             return &m_albums;
+        case kTitle:             return &m_titles;
+        case kGenre:             return &m_genres;
+        case kDirectory:         return &m_directories;
+        case kHostname:          return &m_hostnames;
+        case kFormat:            return &m_formats;
+        default:                 return nullptr;
+    }
+}
+
+void MusicTrackIndex::touch(int row)
+{
+    m_changes[row] = ++m_generation;
+}
+
+uint32_t MusicTrackIndex::stringOf(const Strings &strings, Field field)
+{
+    switch (field)
+    {
+        case kArtist:            return strings.m_artist;
+        case kCompilationArtist: return strings.m_compilationArtist;
+        case kAlbum:             return strings.m_album;
+        case kTitle:             return strings.m_title;
+        case kGenre:             return strings.m_genre;
+        case kDirectory:         return strings.m_directory;
+        case kHostname:          return strings.m_hostname;
+        case kFormat:            return strings.m_format;
+        default:                 return 0;
+    }
+}
+
+//--------------------------------------------------------------------------
+
+QList<MusicTrackSelection::IdType> MusicTrackSelection::tracks(const MusicTrackIndex *index,
+                                                              const QDate &today)
+{
+    bool compile = !m_compiledFor.isValid() || (m_relative && m_compiledFor != today);
+    if (compile)
+    {
+        m_conditions = m_compile(today);
+        m_compiledFor = today;
+    }
+
+    // only look at the tracks that changed since the selection was last used
+    QList<IdType> changed;
+    QList<IdType> removed;
+    uint32_t generation = index->generation();
+
+    if (compile || m_relative || index != m_index ||
+        !index->changesSince(m_generation, changed, removed))
+    {
+        QList<IdType> ids = index->select(m_conditions, m_matchAll);
+        m_tracks = QSet<IdType>(ids.cbegin(), ids.cend());
+    }
+    else if (!changed.isEmpty() || !removed.isEmpty())
+    {
+        for (auto id : std::as_const(removed))
+            m_tracks.remove(id);
+        for (auto id : std::as_const(changed))
+            m_tracks.remove(id);
+        for (auto id : index->select(m_conditions, m_matchAll, &changed))
+            m_tracks.insert(id);
+    }
+
+    m_index = index;
+    m_generation = generation;
+    return m_tracks.values();
+}
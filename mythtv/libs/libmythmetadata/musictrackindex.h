@@ -0,0 +1,320 @@
+#ifndef MUSICTRACKINDEX_H_
+#define MUSICTRACKINDEX_H_
+
+// C/C++
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// qt
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QPair>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+// MythTV
+#include "libmythmetadata/mythmetaexp.h"
+
+/** \class MusicStringPool
+ *  \brief Keeps one copy of each distinct string and hands out its index.
+ *
+ *  Entries are never removed, a pool only shrinks when it is cleared.
+ */
+class META_PUBLIC MusicStringPool
+{
+  public:
+    uint32_t intern(const QString &value);
+    const QString &at(uint32_t index) const { return m_values.at(index); }
+    uint32_t count(void) const { return m_values.size(); }
+    void clear(void);
+
+    /// which entries contain text, ignoring case
+    std::vector<bool> match(const QString &text) const;
+
+    size_t memoryUsage(void) const;
+
+  private:
+    QStringList              m_values;
+    QHash<QString, uint32_t> m_index;
+};
+
+/** \class MusicTrackIndex
+ *  \brief A compact in memory index of every track in the music library.
+ *
+ *  The tracks are kept as columns, the strings interned in pools and the
+ *  numbers packed into the smallest type that holds them, so the index of
+ *  a large collection costs a fraction of the MusicMetadata objects that
+ *  would otherwise be needed. Views query it for the ids they want and only
+ *  create MusicMetadata for the tracks they show.
+ *
+ *  Every change to a track bumps the generation of the index, so that
+ *  anything kept from it can catch up with changesSince() rather than
+ *  starting again.
+ *
+ *  It is safe to use from any thread.
+ */
+class META_PUBLIC MusicTrackIndex
+{
+  public:
+    using IdType = uint32_t;
+
+    enum Field : std::uint8_t
+    {
+        // text
+        kArtist = 0,
+        kCompilationArtist,
+        kAlbum,
+        kTitle,
+        kGenre,
+        kDirectory,     ///< the directory part of kFilename
+        kFilename,
+        kHostname,
+        kFormat,
+        // numbers
+        kYear,
+        kTrack,
+        kTrackCount,
+        kDiscNumber,
+        kDiscCount,
+        kLength,        ///< milliseconds
+        kRating,
+        kPlayCount,
+        kLastPlay,      ///< seconds since the epoch, 0 if never
+        kDateAdded,     ///< seconds since the epoch
+        kFileSize,
+        kCompilation,
+        kArtistId,
+        kAlbumId,
+        kDirectoryId
+    };
+
+    static bool isText(Field field) { return field <= kFormat; }
+
+    /// one track, as it is read from or materialised into MusicMetadata
+    struct Track
+    {
+        IdType    m_id                {0};
+        QString   m_artist;
+        QString   m_compilationArtist;
+        QString   m_album;
+        QString   m_title;
+        QString   m_genre;
+        QString   m_filename;
+        QString   m_hostname;
+        QString   m_format;
+        int       m_year              {0};
+        int       m_track             {0};
+        int       m_trackCount        {0};
+        int       m_discNumber        {0};
+        int       m_discCount         {0};
+        int       m_length            {0};
+        int       m_rating            {0};
+        int       m_playCount         {0};
+        QDateTime m_lastPlay;
+        QDateTime m_dateAdded;
+        uint64_t  m_fileSize          {0};
+        bool      m_compilation       {false};
+        int       m_artistId          {0};
+        int       m_compilationArtistId {0};
+        int       m_albumId           {0};
+        int       m_directoryId       {0};
+    };
+
+    enum UpdateResult : std::uint8_t
+    {
+        kUnchanged = 0,
+        kAdded,
+        kChanged
+    };
+
+    /// a test of one field, which is what a smart playlist criterion
+    /// compiles to. Text is compared ignoring case as the database does,
+    /// and a kLastPlay or kDateAdded of 0 is treated like a NULL in SQL.
+    struct Condition
+    {
+        enum Op : std::uint8_t
+        {
+            kEqual = 0,
+            kNotEqual,
+            kGreater,
+            kLess,
+            kStartsWith,
+            kEndsWith,
+            kContains,
+            kNotContains,
+            kBetween,       ///< inclusive
+            kNotBetween,
+            kIsSet,
+            kIsNotSet
+        };
+
+        Field   m_field  {kArtist};
+        Op      m_op     {kEqual};
+        QString m_text1;            ///< for text fields
+        QString m_text2;
+        qint64  m_value1 {0};       ///< for numeric fields
+        qint64  m_value2 {0};
+    };
+
+    /// fields to sort on, true to sort that field descending
+    using SortOrder = QList<QPair<Field, bool>>;
+
+    UpdateResult update(const Track &track);
+    bool         updateStats(IdType id, int rating, int playCount, const QDateTime &lastPlay);
+    bool         remove(IdType id);
+    void         clear(void);
+    void         reserve(int count);
+
+    int           count(void) const;
+    bool          contains(IdType id) const;
+    bool          getTrack(IdType id, Track &track) const;
+    QList<IdType> ids(void) const;
+
+    QString text(IdType id, Field field) const;
+    qint64  value(IdType id, Field field) const;
+
+    /// tracks where any of the fields contains text, ignoring case
+    QList<IdType> search(const QString &text, const QList<Field> &fields) const;
+    /// the tracks of ids that have value in field
+    QList<IdType> filter(const QList<IdType> &ids, Field field, qint64 value) const;
+    /// ids grouped by the text of a field
+    QMap<QString, QList<IdType>> group(const QList<IdType> &ids, Field field) const;
+    /// ids grouped by the value of a field
+    QMap<qint64, QList<IdType>> groupValues(const QList<IdType> &ids, Field field) const;
+
+    /// the tracks, of ids or of the whole index if it's null, that match all
+    /// or any of the conditions. Every track matches no conditions.
+    QList<IdType> select(const QList<Condition> &conditions, bool matchAll,
+                         const QList<IdType> *ids = nullptr) const;
+    /// stable sort of ids by the fields of order
+    void sort(QList<IdType> &ids, const SortOrder &order) const;
+
+    uint32_t generation(void) const;
+    /// the tracks added or changed and those removed after generation.
+    /// False if that is no longer known and everything has to be looked
+    /// at again.
+    bool changesSince(uint32_t generation, QList<IdType> &changed,
+                      QList<IdType> &removed) const;
+
+    size_t memoryUsage(void) const;
+
+  private:
+    struct Numbers
+    {
+        uint32_t m_length     {0};
+        uint32_t m_playCount  {0};
+        uint32_t m_lastPlay   {0};
+        uint32_t m_dateAdded  {0};
+        int16_t  m_year       {0};
+        uint16_t m_track      {0};
+        uint16_t m_trackCount {0};
+        uint8_t  m_discNumber {0};
+        uint8_t  m_discCount  {0};
+        uint8_t  m_rating     {0};
+        bool     m_compilation{false};
+
+        bool operator==(const Numbers &other) const = default;
+    };
+
+    struct Strings
+    {
+        uint32_t m_artist            {0};
+        uint32_t m_compilationArtist {0};
+        uint32_t m_album             {0};
+        uint32_t m_title             {0};
+        uint32_t m_genre             {0};
+        uint32_t m_directory         {0};
+        uint32_t m_hostname          {0};
+        uint32_t m_format            {0};
+
+        bool operator==(const Strings &other) const = default;
+    };
+
+    struct DBIds
+    {
+        int32_t m_artist            {0};
+        int32_t m_compilationArtist {0};
+        int32_t m_album             {0};
+        int32_t m_directory         {0};
+
+        bool operator==(const DBIds &other) const = default;
+    };
+
+    int      row(IdType id) const { return m_rows.value(id, -1); }
+    QString  rowText(int row, Field field) const;
+    qint64   rowValue(int row, Field field) const;
+    const MusicStringPool *pool(Field field) const;
+    static uint32_t stringOf(const Strings &strings, Field field);
+    void touch(int row);
+
+    // how many removals changesSince() can report
+    static constexpr size_t kMaxRemovals { 4096 };
+
+    mutable QMutex           m_lock;
+
+    QHash<IdType, int>       m_rows;
+    std::vector<IdType>      m_ids;
+    std::vector<Strings>     m_strings;
+    std::vector<Numbers>     m_numbers;
+    std::vector<DBIds>       m_dbIds;
+    std::vector<QString>     m_filenames; ///< the part after m_directory
+    std::vector<uint64_t>    m_fileSizes;
+    std::vector<uint32_t>    m_changes;   ///< the generation of the last change
+
+    uint32_t                 m_generation   {0};
+    /// changesSince() can't answer for generations before this
+    uint32_t                 m_removedFloor {0};
+    std::vector<std::pair<uint32_t, IdType>> m_removals;
+
+    MusicStringPool          m_artists;   ///< artists and compilation artists
+    MusicStringPool          m_albums;
+    MusicStringPool          m_titles;
+    MusicStringPool          m_genres;
+    MusicStringPool          m_directories;
+    MusicStringPool          m_hostnames;
+    MusicStringPool          m_formats;
+};
+
+/** \class MusicTrackSelection
+ *  \brief The tracks of a MusicTrackIndex that match some conditions, kept
+ *  up to date with changesSince() rather than selected again each time.
+ *
+ *  Conditions on dates relative to today, like the "$DATE - 30 days" of a
+ *  smart playlist, match other tracks once the day changes although no
+ *  track did. A relative selection compiles its conditions again whenever
+ *  it is used on another day, and always selects all of its tracks again.
+ */
+class META_PUBLIC MusicTrackSelection
+{
+  public:
+    using IdType    = MusicTrackIndex::IdType;
+    /// the conditions, with any relative dates evaluated for today
+    using Compiler  = std::function<QList<MusicTrackIndex::Condition>(const QDate &today)>;
+
+    MusicTrackSelection(Compiler compile, bool matchAll, bool relative)
+      : m_compile(std::move(compile)), m_matchAll(matchAll), m_relative(relative) {}
+
+    bool isRelative(void) const { return m_relative; }
+
+    /// the tracks of index that match today, in no particular order
+    QList<IdType> tracks(const MusicTrackIndex *index, const QDate &today);
+
+  private:
+    Compiler                          m_compile;
+    bool                              m_matchAll   {true};
+    bool                              m_relative   {false};
+
+    QList<MusicTrackIndex::Condition> m_conditions;
+    QDate                             m_compiledFor;
+    const MusicTrackIndex            *m_index      {nullptr};
+    uint32_t                          m_generation {0};
+    QSet<IdType>                      m_tracks;
+};
+
+#endif
@@ -0,0 +1,160 @@
+/*
+ *  Class TestDirScan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#include <utime.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+
+#include "libmythmetadata/dbaccess.h"
+#include "libmythmetadata/dirscan.h"
+
+#include "test_dirscan.h"
+
+namespace
+{
+    class FileCollector : public DirectoryHandler
+    {
+      public:
+        DirectoryHandler *newDir(const QString &/*dir_name*/,
+                                 const QString &/*fq_dir_name*/) override
+        {
+            return this;
+        }
+
+        void handleFile(const QString &/*file_name*/,
+                        const QString &fq_file_name,
+                        const QString &/*extension*/,
+                        const QString &/*host*/) override
+        {
+            m_files << fq_file_name;
+        }
+
+        QStringList m_files;
+    };
+}
+
+void TestDirScan::MakeFile(const QString &path)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("x");
+}
+
+// Snapshots only keep directories that have settled for a while
+void TestDirScan::Backdate(const QString &path)
+{
+    utimbuf times {};
+    times.actime = times.modtime =
+        QDateTime::currentSecsSinceEpoch() - 3600;
+    QCOMPARE(utime(path.toLocal8Bit().constData(), &times), 0);
+}
+
+QStringList TestDirScan::Scan(const QString &path, DirectorySnapshot *snapshot)
+{
+    FileAssociations::ext_ignore_list extensions { {"mkv", false},
+                                                   {"txt", true} };
+    FileCollector collector;
+    if (!ScanVideoDirectory(path, &collector, extensions, false, snapshot))
+        return {};
+    collector.m_files.sort();
+    return collector.m_files;
+}
+
+void TestDirScan::initTestCase(void)
+{
+    QVERIFY(m_dir.isValid());
+
+    QString root = m_dir.path();
+    MakeFile(root + "/Movies/a.mkv");
+    MakeFile(root + "/Movies/notes.txt");
+    MakeFile(root + "/Movies/Thumbs.db");
+    MakeFile(root + "/Disc/VIDEO_TS/VTS_01_1.VOB");
+    MakeFile(root + "/Shows/Season 1/e1.mkv");
+
+    QDirIterator it(root, QDir::Dirs | QDir::NoDotAndDotDot,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext())
+        Backdate(it.next());
+    Backdate(root);
+}
+
+void TestDirScan::test_scan(void)
+{
+    QString root = m_dir.path();
+    QStringList expected { root + "/Disc",
+                           root + "/Movies/a.mkv",
+                           root + "/Shows/Season 1/e1.mkv" };
+    QCOMPARE(Scan(root, nullptr), expected);
+    QVERIFY(Scan(root + "/missing", nullptr).isEmpty());
+}
+
+void TestDirScan::test_snapshot(void)
+{
+    // Not below root, saving would change its time stamp
+    QTemporaryDir dir;
+    QString root = m_dir.path();
+    QString file = dir.path() + "/snapshot";
+    QStringList expected = Scan(root, nullptr);
+
+    DirectorySnapshot first;
+    QCOMPARE(Scan(root, &first), expected);
+    QCOMPARE(first.GetReusedCount(), 0);
+    QVERIFY(first.Save(file));
+
+    // The root, Movies, Disc, Shows and Season 1 are not listed again
+    DirectorySnapshot second;
+    QVERIFY(second.Load(file));
+    QCOMPARE(Scan(root, &second), expected);
+    QCOMPARE(second.GetReusedCount(), 5);
+}
+
+void TestDirScan::test_snapshot_change(void)
+{
+    QString root = m_dir.path();
+    DirectorySnapshot snapshot;
+    (void) Scan(root, &snapshot);
+
+    MakeFile(root + "/Shows/Season 1/e2.mkv");
+    QStringList expected { root + "/Disc",
+                           root + "/Movies/a.mkv",
+                           root + "/Shows/Season 1/e1.mkv",
+                           root + "/Shows/Season 1/e2.mkv" };
+    QCOMPARE(Scan(root, &snapshot), expected);
+}
+
+void TestDirScan::test_snapshot_damaged(void)
+{
+    QTemporaryDir dir;
+    QString file = dir.path() + "/snapshot";
+
+    DirectorySnapshot snapshot;
+    QVERIFY(!snapshot.Load(file));
+
+    QFile damaged(file);
+    QVERIFY(damaged.open(QIODevice::WriteOnly));
+    damaged.write("not a snapshot");
+    damaged.close();
+    QVERIFY(!snapshot.Load(file));
+}
+
+QTEST_APPLESS_MAIN(TestDirScan)
+
+#include "moc_test_dirscan.cpp"
@@ -0,0 +1,45 @@
+/*
+ *  Class TestDirScan
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#ifndef LIBMYTHMETADATA_TEST_DIRSCAN_H
+#define LIBMYTHMETADATA_TEST_DIRSCAN_H
+
+#include <QTemporaryDir>
+#include <QTest>
+
+class DirectorySnapshot;
+
+class TestDirScan : public QObject
+{
+    Q_OBJECT
+
+  private:
+    static void MakeFile(const QString &path);
+    static void Backdate(const QString &path);
+    static QStringList Scan(const QString &path, DirectorySnapshot *snapshot);
+
+    QTemporaryDir m_dir;
+
+  private slots:
+    void initTestCase(void);
+    void test_scan(void);
+    void test_snapshot(void);
+    void test_snapshot_change(void);
+    static void test_snapshot_damaged(void);
+};
+
+#endif
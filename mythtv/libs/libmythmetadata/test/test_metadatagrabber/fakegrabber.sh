@@ -0,0 +1,41 @@
+#!/bin/sh
+#
+# Stand-in for a metadata grabber, used by test_metadatagrabber.
+#
+# With --session it answers one lookup per line read from stdin, as a
+# grabber in session mode does, otherwise it answers the lookup given on
+# the command line. The answer echoes the lookup, the process ID and the
+# number of lookups answered so far. A lookup starting with "fail" exits
+# with status 1, and "sleep N" takes N seconds to answer.
+#
+# FAKEGRABBER_STARTUP adds a delay at start up, to stand in for loading
+# an interpreter and its modules when comparing the two modes.
+
+sleep "${FAKEGRABBER_STARTUP:-0}"
+
+count=0
+
+answer() {
+    count=$((count + 1))
+    case "$1" in
+        fail*)
+            echo "<metadata/>"
+            return 1 ;;
+        sleep*)
+            sleep "${1#sleep}" ;;
+    esac
+    printf '<metadata><item><title>%s</title><pid>%s</pid><count>%s</count></item></metadata>\n' \
+        "$1" "$$" "$count"
+    return 0
+}
+
+if [ "$1" != "--session" ]; then
+    answer "$*"
+    exit $?
+fi
+
+while IFS= read -r line; do
+    answer "$line"
+    printf '#END %s\n' "$?"
+done
+exit 0
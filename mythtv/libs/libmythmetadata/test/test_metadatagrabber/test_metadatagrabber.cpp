@@ -20,10 +20,19 @@
 
 #include "test_metadatagrabber.h"
 
+#include <atomic>
+#include <thread>
+
+#include "libmythbase/mythchrono.h"
 #include "libmythbase/mythcorecontext.h"
+#include "libmythmetadata/metadatadownload.h"
+
+static QString s_fakeGrabber;
 
 void TestMetadataGrabber::initTestCase()
 {
+    s_fakeGrabber = QFINDTESTDATA("fakegrabber.sh");
+
     gCoreContext = new MythCoreContext("test_mythmetadatagrabber_1.0", nullptr);
 
     if (QDir::currentPath().endsWith("test_metadatagrabber"))
@@ -57,10 +66,185 @@ void TestMetadataGrabber::test_fromInetref(void)
 #endif
 }
 
+// Pull the value of element \a name out of the fake grabber's answer
+static QString answer(const QByteArray &result, const QString &name)
+{
+    QDomDocument doc;
+    doc.setContent(result);
+    return doc.documentElement().firstChildElement("item")
+        .firstChildElement(name).text();
+}
+
+void TestMetadataGrabber::test_session(void)
+{
+#ifdef _WIN32
+    QSKIP("Grabber sessions are not available on Windows");
+#endif
+    QVERIFY(!s_fakeGrabber.isEmpty());
+
+    MetaGrabberSession session(s_fakeGrabber);
+    QVERIFY(session.Start());
+
+    QByteArray result;
+    int status = -1;
+    QVERIFY(session.Run({"-D", "1234"}, result, status, 5s));
+    QCOMPARE(status, 0);
+    QCOMPARE(answer(result, "title"), QString("-D\t1234"));
+    QCOMPARE(answer(result, "count"), QString("1"));
+    QString pid = answer(result, "pid");
+
+    // The second lookup is answered by the same process
+    QVERIFY(session.Run({"-M", "A\tTitle\nWith breaks"}, result, status, 5s));
+    QCOMPARE(status, 0);
+    QCOMPARE(answer(result, "title"), QString("-M\tA Title With breaks"));
+    QCOMPARE(answer(result, "count"), QString("2"));
+    QCOMPARE(answer(result, "pid"), pid);
+
+    session.Stop();
+    QVERIFY(!session.IsRunning());
+}
+
+void TestMetadataGrabber::test_sessionStatus(void)
+{
+#ifdef _WIN32
+    QSKIP("Grabber sessions are not available on Windows");
+#endif
+    MetaGrabberSession session(s_fakeGrabber);
+
+    // A failed lookup is reported, and doesn't end the session
+    QByteArray result;
+    int status = -1;
+    QVERIFY(session.Run({"fail"}, result, status, 5s));
+    QCOMPARE(status, 1);
+    QVERIFY(session.IsRunning());
+
+    QVERIFY(session.Run({"-D", "1"}, result, status, 5s));
+    QCOMPARE(status, 0);
+    QCOMPARE(answer(result, "count"), QString("2"));
+}
+
+void TestMetadataGrabber::test_sessionTimeout(void)
+{
+#ifdef _WIN32
+    QSKIP("Grabber sessions are not available on Windows");
+#endif
+    MetaGrabberSession session(s_fakeGrabber);
+
+    QByteArray result;
+    int status = -1;
+    QVERIFY(!session.Run({"sleep 5"}, result, status, 200ms));
+    QVERIFY(!session.IsRunning());
+
+    // The next lookup starts a new grabber
+    QVERIFY(session.Run({"-D", "1"}, result, status, 5s));
+    QCOMPARE(status, 0);
+    QCOMPARE(answer(result, "count"), QString("1"));
+}
+
+void TestMetadataGrabber::test_sessionPool(void)
+{
+#ifdef _WIN32
+    QSKIP("Grabber sessions are not available on Windows");
+#endif
+    MetaGrabberSession *first = MetaGrabberSession::Acquire(s_fakeGrabber);
+    QVERIFY(first != nullptr);
+    MetaGrabberSession *second = MetaGrabberSession::Acquire(s_fakeGrabber);
+    QVERIFY(second != nullptr);
+    QVERIFY(first != second);
+
+    QByteArray result;
+    int status = -1;
+    QVERIFY(first->Run({"-D", "1"}, result, status, 5s));
+    MetaGrabberSession::Release(first);
+    MetaGrabberSession::Release(second);
+
+    // An idle session is handed out again; which one is not specified
+    MetaGrabberSession *again = MetaGrabberSession::Acquire(s_fakeGrabber);
+    QVERIFY(again == first || again == second);
+    MetaGrabberSession::Release(again);
+
+    MetaGrabberSession::ExpireIdle(true);
+    MetaGrabberSession *fresh = MetaGrabberSession::Acquire(s_fakeGrabber);
+    QVERIFY(fresh != nullptr);
+    QVERIFY(fresh->Run({"-D", "1"}, result, status, 5s));
+    QCOMPARE(answer(result, "count"), QString("1"));
+    MetaGrabberSession::Release(fresh);
+    MetaGrabberSession::ExpireIdle(true);
+}
+
+void TestMetadataGrabber::test_resultCache(void)
+{
+    GrabberResultCache cache(300ms, 2);
+    QByteArray result;
+    QVERIFY(!cache.Find("a", result));
+
+    cache.Insert("a", "first");
+    QVERIFY(cache.Find("a", result));
+    QCOMPARE(result, QByteArray("first"));
+
+    // Each entry costs at least 1 KiB, so the least recently used goes
+    cache.Insert("b", "second");
+    QVERIFY(cache.Find("a", result));
+    cache.Insert("c", "third");
+    QVERIFY(!cache.Find("b", result));
+    QVERIFY(cache.Find("a", result));
+    QVERIFY(cache.Find("c", result));
+    QCOMPARE(result, QByteArray("third"));
+
+    // Too old to use
+    std::this_thread::sleep_for(400ms);
+    QVERIFY(!cache.Find("a", result));
+    cache.Insert("a", "again");
+    QVERIFY(cache.Find("a", result));
+    QCOMPARE(result, QByteArray("again"));
+
+    cache.Clear();
+    QVERIFY(!cache.Find("a", result));
+}
+
+// Counts how many lookups run at once, rather than looking anything up
+class CountingDownload : public MetadataDownload
+{
+  public:
+    CountingDownload() : MetadataDownload(nullptr) {}
+    ~CountingDownload() override { wait(); }
+
+    std::atomic<int> m_running {0};
+    std::atomic<int> m_most    {0};
+    std::atomic<int> m_done    {0};
+
+  protected:
+    void processLookup(MetadataLookup */*lookup*/) override
+    {
+        int now = ++m_running;
+        int most = m_most;
+        while (now > most && !m_most.compare_exchange_weak(most, now))
+        {
+        }
+        std::this_thread::sleep_for(50ms);
+        --m_running;
+        ++m_done;
+    }
+};
+
+void TestMetadataGrabber::test_lookupThreads(void)
+{
+    gCoreContext->OverrideSettingForSession("MetadataLookupThreads", "3");
+    {
+        CountingDownload download;
+        for (int i = 0; i < 12; i++)
+            download.addLookup(new MetadataLookup());
+        QVERIFY(download.wait(10s));
+        QCOMPARE(download.m_done.load(), 12);
+        QCOMPARE(download.m_most.load(), 3);
+    }
+    gCoreContext->ClearOverrideSettingForSession("MetadataLookupThreads");
+}
+
 void TestMetadataGrabber::cleanupTestCase()
 {
 }
 
-QTEST_APPLESS_MAIN(TestMetadataGrabber)
+QTEST_GUILESS_MAIN(TestMetadataGrabber)
 
 #include "moc_test_metadatagrabber.cpp"
@@ -26,6 +26,7 @@
 
 #include "libmythmetadata/musicmetadata.h"
 #include "libmythmetadata/metadatagrabber.h"
+#include "libmythmetadata/metadatagrabbersession.h"
 
 class TestMetadataGrabber : public QObject
 {
@@ -37,6 +38,12 @@ private slots:
     static void initTestCase();
     static void test_inetref(void);
     static void test_fromInetref(void);
+    static void test_session(void);
+    static void test_sessionStatus(void);
+    static void test_sessionTimeout(void);
+    static void test_sessionPool(void);
+    static void test_resultCache(void);
+    static void test_lookupThreads(void);
     static void cleanupTestCase();
 };
 
@@ -0,0 +1,359 @@
+/*
+ *  Class TestMusicTrackIndex
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include "test_musictrackindex.h"
+
+#include "libmythbase/mythdate.h"
+
+using IdList = QList<MusicTrackIndex::IdType>;
+
+static MusicTrackIndex::Track make_track(MusicTrackIndex::IdType id, const QString &artist,
+                                         const QString &album, const QString &title,
+                                         const QString &genre, int year, int rating)
+{
+    MusicTrackIndex::Track track;
+    track.m_id                = id;
+    track.m_artist            = artist;
+    track.m_compilationArtist = artist;
+    track.m_album             = album;
+    track.m_title             = title;
+    track.m_genre             = genre;
+    track.m_filename          = QString("%1/%2/%3.flac").arg(artist, album, title);
+    track.m_hostname          = "myth";
+    track.m_format            = "flac";
+    track.m_year              = year;
+    track.m_track             = static_cast<int>(id);
+    track.m_length            = 180000;
+    track.m_rating            = rating;
+    track.m_dateAdded         = MythDate::fromSecsSinceEpoch(1700000000);
+    return track;
+}
+
+static MusicTrackIndex *make_index(void)
+{
+    auto *index = new MusicTrackIndex;
+    index->update(make_track(1, "Miles Davis", "Kind of Blue", "So What", "Jazz", 1959, 10));
+    index->update(make_track(2, "Miles Davis", "Kind of Blue", "Blue in Green", "Jazz", 1959, 8));
+    index->update(make_track(3, "John Coltrane", "Blue Train", "Blue Train", "Jazz", 1957, 8));
+    index->update(make_track(4, "Kraftwerk", "Autobahn", "Autobahn", "Electronic", 1974, 6));
+    return index;
+}
+
+void TestMusicTrackIndex::test_update(void)
+{
+    MusicTrackIndex index;
+    auto track = make_track(7, "Artist", "Album", "Title", "Genre", 2001, 5);
+
+    QCOMPARE(index.update(track), MusicTrackIndex::kAdded);
+    QCOMPARE(index.update(track), MusicTrackIndex::kUnchanged);
+    QCOMPARE(index.count(), 1);
+    QVERIFY(index.contains(7));
+    QVERIFY(!index.contains(8));
+
+    track.m_playCount = 3;
+    QCOMPARE(index.update(track), MusicTrackIndex::kChanged);
+    QCOMPARE(index.value(7, MusicTrackIndex::kPlayCount), qint64(3));
+
+    track.m_filename = "Artist/Other/Title.flac";
+    QCOMPARE(index.update(track), MusicTrackIndex::kChanged);
+    QCOMPARE(index.text(7, MusicTrackIndex::kDirectory), QString("Artist/Other"));
+
+    QVERIFY(index.updateStats(7, 9, 4, MythDate::fromSecsSinceEpoch(1800000000)));
+    QCOMPARE(index.value(7, MusicTrackIndex::kRating), qint64(9));
+    QCOMPARE(index.value(7, MusicTrackIndex::kPlayCount), qint64(4));
+    QCOMPARE(index.value(7, MusicTrackIndex::kLastPlay), qint64(1800000000));
+    QVERIFY(!index.updateStats(8, 9, 4, QDateTime()));
+}
+
+void TestMusicTrackIndex::test_roundtrip(void)
+{
+    MusicTrackIndex index;
+    auto track = make_track(42, "Artist", "Album", "Title", "Genre", 1999, 7);
+    track.m_compilationArtist   = "Various Artists";
+    track.m_compilation         = true;
+    track.m_trackCount          = 12;
+    track.m_discNumber          = 2;
+    track.m_discCount           = 3;
+    track.m_playCount           = 11;
+    track.m_lastPlay            = MythDate::fromSecsSinceEpoch(1710000000);
+    track.m_fileSize            = 123456789012ULL;
+    track.m_artistId            = 5;
+    track.m_compilationArtistId = 6;
+    track.m_albumId             = 7;
+    track.m_directoryId         = 8;
+    index.update(track);
+
+    // filenames without a directory, or with an empty one, come back as they went in
+    auto bare = make_track(43, "A", "B", "C", "D", 2000, 0);
+    bare.m_filename = "bare.mp3";
+    index.update(bare);
+    auto root = make_track(44, "A", "B", "C", "D", 2000, 0);
+    root.m_filename = "/root.mp3";
+    index.update(root);
+
+    MusicTrackIndex::Track result;
+    QVERIFY(index.getTrack(42, result));
+    QCOMPARE(result.m_id, 42U);
+    QCOMPARE(result.m_artist, track.m_artist);
+    QCOMPARE(result.m_compilationArtist, track.m_compilationArtist);
+    QCOMPARE(result.m_album, track.m_album);
+    QCOMPARE(result.m_title, track.m_title);
+    QCOMPARE(result.m_genre, track.m_genre);
+    QCOMPARE(result.m_filename, track.m_filename);
+    QCOMPARE(result.m_hostname, track.m_hostname);
+    QCOMPARE(result.m_format, track.m_format);
+    QCOMPARE(result.m_year, track.m_year);
+    QCOMPARE(result.m_track, track.m_track);
+    QCOMPARE(result.m_trackCount, track.m_trackCount);
+    QCOMPARE(result.m_discNumber, track.m_discNumber);
+    QCOMPARE(result.m_discCount, track.m_discCount);
+    QCOMPARE(result.m_length, track.m_length);
+    QCOMPARE(result.m_rating, track.m_rating);
+    QCOMPARE(result.m_playCount, track.m_playCount);
+    QCOMPARE(result.m_lastPlay, track.m_lastPlay);
+    QCOMPARE(result.m_dateAdded, track.m_dateAdded);
+    QCOMPARE(result.m_fileSize, track.m_fileSize);
+    QCOMPARE(result.m_compilation, track.m_compilation);
+    QCOMPARE(result.m_artistId, track.m_artistId);
+    QCOMPARE(result.m_compilationArtistId, track.m_compilationArtistId);
+    QCOMPARE(result.m_albumId, track.m_albumId);
+    QCOMPARE(result.m_directoryId, track.m_directoryId);
+
+    QVERIFY(index.getTrack(43, result));
+    QCOMPARE(result.m_filename, QString("bare.mp3"));
+    QVERIFY(!result.m_lastPlay.isValid());
+    QVERIFY(index.getTrack(44, result));
+    QCOMPARE(result.m_filename, QString("/root.mp3"));
+    QVERIFY(!index.getTrack(45, result));
+}
+
+void TestMusicTrackIndex::test_remove(void)
+{
+    QScopedPointer<MusicTrackIndex> index(make_index());
+
+    QVERIFY(index->remove(2));
+    QVERIFY(!index->remove(2));
+    QCOMPARE(index->count(), 3);
+    QCOMPARE(index->ids(), IdList({ 1, 3, 4 }));
+
+    // the row moved into the hole still answers for its own id
+    QCOMPARE(index->text(4, MusicTrackIndex::kTitle), QString("Autobahn"));
+    QCOMPARE(index->text(3, MusicTrackIndex::kTitle), QString("Blue Train"));
+    QCOMPARE(index->text(2, MusicTrackIndex::kTitle), QString());
+
+    QVERIFY(index->remove(4));
+    QVERIFY(index->remove(1));
+    QVERIFY(index->remove(3));
+    QCOMPARE(index->count(), 0);
+}
+
+void TestMusicTrackIndex::test_search(void)
+{
+    QScopedPointer<MusicTrackIndex> index(make_index());
+
+    QCOMPARE(index->search("blue", { MusicTrackIndex::kTitle }), IdList({ 2, 3 }));
+    QCOMPARE(index->search("BLUE", { MusicTrackIndex::kAlbum }), IdList({ 1, 2, 3 }));
+    QCOMPARE(index->search("blue", { MusicTrackIndex::kArtist }), IdList());
+    QCOMPARE(index->search("a", { MusicTrackIndex::kGenre, MusicTrackIndex::kArtist }),
+             IdList({ 1, 2, 3, 4 }));
+    QCOMPARE(index->search("autobahn/auto", { MusicTrackIndex::kFilename }), IdList({ 4 }));
+    QCOMPARE(index->search("", { MusicTrackIndex::kTitle }), IdList({ 1, 2, 3, 4 }));
+
+    QCOMPARE(index->filter(index->ids(), MusicTrackIndex::kRating, 8), IdList({ 2, 3 }));
+    QCOMPARE(index->filter({ 4, 3 }, MusicTrackIndex::kYear, 1957), IdList({ 3 }));
+}
+
+void TestMusicTrackIndex::test_group(void)
+{
+    QScopedPointer<MusicTrackIndex> index(make_index());
+
+    auto artists = index->group(index->ids(), MusicTrackIndex::kArtist);
+    QCOMPARE(artists.keys(), QStringList({ "John Coltrane", "Kraftwerk", "Miles Davis" }));
+    QCOMPARE(artists.value("Miles Davis"), IdList({ 1, 2 }));
+
+    auto genres = index->group({ 4, 1 }, MusicTrackIndex::kGenre);
+    QCOMPARE(genres.keys(), QStringList({ "Electronic", "Jazz" }));
+
+    auto years = index->groupValues(index->ids(), MusicTrackIndex::kYear);
+    QCOMPARE(years.keys(), QList<qint64>({ 1957, 1959, 1974 }));
+    QCOMPARE(years.value(1959), IdList({ 1, 2 }));
+
+    QVERIFY(index->memoryUsage() > 0);
+}
+
+void TestMusicTrackIndex::test_select(void)
+{
+    QScopedPointer<MusicTrackIndex> index(make_index());
+    index->updateStats(4, 6, 1, MythDate::fromSecsSinceEpoch(1710000000));
+
+    using Condition = MusicTrackIndex::Condition;
+    Condition miles { MusicTrackIndex::kArtist, Condition::kEqual, "MILES DAVIS" };
+    Condition blue { MusicTrackIndex::kTitle, Condition::kStartsWith, "blue" };
+    Condition rated { .m_field=MusicTrackIndex::kRating, .m_op=Condition::kGreater, .m_value1=7 };
+    Condition fifties { .m_field=MusicTrackIndex::kYear, .m_op=Condition::kBetween,
+                        .m_value1=1950, .m_value2=1959 };
+    Condition played { .m_field=MusicTrackIndex::kLastPlay, .m_op=Condition::kIsSet };
+    Condition before { .m_field=MusicTrackIndex::kLastPlay, .m_op=Condition::kLess,
+                       .m_value1=1800000000 };
+
+    QCOMPARE(index->select({}, true), IdList({ 1, 2, 3, 4 }));
+    QCOMPARE(index->select({ miles }, true), IdList({ 1, 2 }));
+    QCOMPARE(index->select({ miles, blue }, true), IdList({ 2 }));
+    QCOMPARE(index->select({ miles, blue }, false), IdList({ 1, 2, 3 }));
+    QCOMPARE(index->select({ rated, fifties }, true), IdList({ 1, 2, 3 }));
+    QCOMPARE(index->select({ played }, true), IdList({ 4 }));
+    // tracks that were never played don't match a comparison, like a NULL
+    QCOMPARE(index->select({ before }, true), IdList({ 4 }));
+
+    IdList some { 4, 2 };
+    QCOMPARE(index->select({ rated }, true, &some), IdList({ 2 }));
+}
+
+void TestMusicTrackIndex::test_sort(void)
+{
+    QScopedPointer<MusicTrackIndex> index(make_index());
+    IdList ids = index->ids();
+
+    index->sort(ids, { { MusicTrackIndex::kArtist, false }, { MusicTrackIndex::kTitle, false } });
+    QCOMPARE(ids, IdList({ 3, 4, 2, 1 }));
+
+    index->sort(ids, { { MusicTrackIndex::kYear, true } });
+    QCOMPARE(ids, IdList({ 4, 2, 1, 3 }));
+
+    // equal keys keep their order
+    ids = { 2, 1, 3 };
+    index->sort(ids, { { MusicTrackIndex::kGenre, false } });
+    QCOMPARE(ids, IdList({ 2, 1, 3 }));
+}
+
+void TestMusicTrackIndex::test_changes(void)
+{
+    QScopedPointer<MusicTrackIndex> index(make_index());
+    IdList changed;
+    IdList removed;
+
+    uint32_t generation = index->generation();
+    QVERIFY(index->changesSince(generation, changed, removed));
+    QVERIFY(changed.isEmpty());
+    QVERIFY(removed.isEmpty());
+
+    index->update(make_track(1, "Miles Davis", "Kind of Blue", "So What", "Jazz", 1959, 10));
+    QCOMPARE(index->generation(), generation);
+
+    index->updateStats(3, 2, 0, QDateTime());
+    index->remove(2);
+    index->update(make_track(5, "Can", "Tago Mago", "Halleluhwah", "Krautrock", 1971, 9));
+    QVERIFY(index->changesSince(generation, changed, removed));
+    std::sort(changed.begin(), changed.end());
+    QCOMPARE(changed, IdList({ 3, 5 }));
+    QCOMPARE(removed, IdList({ 2 }));
+
+    // after a clear everything has to be looked at again
+    generation = index->generation();
+    index->clear();
+    QVERIFY(!index->changesSince(generation, changed, removed));
+    QVERIFY(index->changesSince(index->generation(), changed, removed));
+}
+
+/// the start of day as seconds since the epoch, as smart playlists compile dates
+static qint64 day_start(const QDate &day)
+{
+    return QDate(1970, 1, 1).daysTo(day) * 24 * 60 * 60;
+}
+
+static void play(MusicTrackIndex *index, MusicTrackIndex::IdType id, const QDate &day)
+{
+    index->updateStats(id, 5, 1, MythDate::fromSecsSinceEpoch(day_start(day) + (12 * 60 * 60)));
+}
+
+static IdList sorted(IdList ids)
+{
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+void TestMusicTrackIndex::test_selection(void)
+{
+    QScopedPointer<MusicTrackIndex> index(make_index());
+    const QDate today { 2024, 3, 10 };
+    play(index.data(), 3, today.addDays(-1));
+    play(index.data(), 4, today.addDays(-5));
+
+    // played since the 3rd of March
+    using Condition = MusicTrackIndex::Condition;
+    int compiled = 0;
+    MusicTrackSelection selection(
+        [&compiled](const QDate &/*today*/) {
+            compiled++;
+            return QList<Condition>({ { .m_field=MusicTrackIndex::kLastPlay,
+                                        .m_op=Condition::kGreater,
+                                        .m_value1=day_start({ 2024, 3, 3 }) } });
+        }, true, false);
+
+    QCOMPARE(sorted(selection.tracks(index.data(), today)), IdList({ 3, 4 }));
+
+    // changes are caught up with
+    play(index.data(), 1, today.addDays(-2));
+    index->remove(4);
+    QCOMPARE(sorted(selection.tracks(index.data(), today)), IdList({ 1, 3 }));
+
+    // absolute dates stay as they were compiled
+    QCOMPARE(sorted(selection.tracks(index.data(), today.addDays(3))), IdList({ 1, 3 }));
+    QCOMPARE(compiled, 1);
+
+    // a new index is looked at from the start
+    QScopedPointer<MusicTrackIndex> other(make_index());
+    play(other.data(), 2, today);
+    QCOMPARE(sorted(selection.tracks(other.data(), today)), IdList({ 2 }));
+}
+
+void TestMusicTrackIndex::test_selection_relative(void)
+{
+    QScopedPointer<MusicTrackIndex> index(make_index());
+    const QDate today { 2024, 3, 10 };
+    play(index.data(), 3, today.addDays(-1));
+    play(index.data(), 4, today.addDays(-5));
+
+    // played in the last week, $DATE - 7 days
+    using Condition = MusicTrackIndex::Condition;
+    QList<QDate> compiled;
+    MusicTrackSelection selection(
+        [&compiled](const QDate &day) {
+            compiled.append(day);
+            return QList<Condition>({ { .m_field=MusicTrackIndex::kLastPlay,
+                                        .m_op=Condition::kGreater,
+                                        .m_value1=day_start(day.addDays(-7)) } });
+        }, true, true);
+    QVERIFY(selection.isRelative());
+
+    QCOMPARE(sorted(selection.tracks(index.data(), today)), IdList({ 3, 4 }));
+    QCOMPARE(sorted(selection.tracks(index.data(), today)), IdList({ 3, 4 }));
+    QCOMPARE(compiled, QList<QDate>({ today }));
+
+    // a track falls out of the week although nothing changed in the index
+    uint32_t generation = index->generation();
+    QCOMPARE(sorted(selection.tracks(index.data(), today.addDays(3))), IdList({ 3 }));
+    QCOMPARE(index->generation(), generation);
+    QCOMPARE(compiled, QList<QDate>({ today, today.addDays(3) }));
+
+    play(index.data(), 2, today.addDays(3));
+    QCOMPARE(sorted(selection.tracks(index.data(), today.addDays(3))), IdList({ 2, 3 }));
+    QCOMPARE(sorted(selection.tracks(index.data(), today.addDays(10))), IdList({ 2 }));
+}
+
+QTEST_APPLESS_MAIN(TestMusicTrackIndex)
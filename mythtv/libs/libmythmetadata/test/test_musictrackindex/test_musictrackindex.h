@@ -0,0 +1,44 @@
+/*
+ *  Class TestMusicTrackIndex
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#ifndef LIBMYTHMETADATA_TEST_MUSICTRACKINDEX_H
+#define LIBMYTHMETADATA_TEST_MUSICTRACKINDEX_H
+
+#include <QChar>     // Fix Qt6 GCC SFINAE warning
+#include <QBitArray> // Fix Qt6 GCC SFINAE warning
+#include <QTest>
+
+#include "libmythmetadata/musictrackindex.h"
+
+class TestMusicTrackIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    static void test_update(void);
+    static void test_roundtrip(void);
+    static void test_remove(void);
+    static void test_search(void);
+    static void test_group(void);
+    static void test_select(void);
+    static void test_sort(void);
+    static void test_changes(void);
+    static void test_selection(void);
+    static void test_selection_relative(void);
+};
+
+#endif // LIBMYTHMETADATA_TEST_MUSICTRACKINDEX_H
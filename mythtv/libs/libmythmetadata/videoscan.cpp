@@ -1,14 +1,25 @@
 
 #include "videoscan.h"
 
+#include <algorithm>
+#include <functional>
+#include <utility>
+
 #include <QApplication>
 #include <QImageReader>
+#include <QMap>
+#include <QMutex>
+#include <QRunnable>
+#include <QStorageInfo>
 #include <QUrl>
-#include <utility>
 
 // mythtv
+#include "libmythbase/mthreadpool.h"
 #include "libmythbase/mythcorecontext.h"
 #include "libmythbase/mythdate.h"
+#include "libmythbase/mythdb.h"
+#include "libmythbase/mythdbcon.h"
+#include "libmythbase/mythdirs.h"
 #include "libmythbase/mythevent.h"
 #include "libmythbase/mythlogging.h"
 #include "libmythui/mythdialogbox.h"
@@ -68,6 +79,27 @@ namespace
         image_ext    m_imageExt;
         DirListType &m_videoFiles;
     };
+
+    class VideoScanWalker : public QRunnable
+    {
+      public:
+        explicit VideoScanWalker(std::function<void()> walk) :
+            m_walk(std::move(walk)) {}
+
+        void run(void) override { m_walk(); } // QRunnable
+
+      private:
+        std::function<void()> m_walk;
+    };
+
+    /// Directories on the same host or local file system are walked by
+    /// the same thread, so each device only sees one walk at a time.
+    QString walk_group(const QString &dir)
+    {
+        if (dir.startsWith("myth://"))
+            return QUrl(dir).host().toLower();
+        return QStorageInfo(dir).rootPath();
+    }
 }
 
 class VideoMetadataListManager;
@@ -169,30 +201,8 @@ void VideoScannerThread::run()
 
     LOG(VB_GENERAL, LOG_INFO, QString("Beginning Video Scan."));
 
-    uint counter = 0;
     FileCheckList fs_files;
-
-    if (m_hasGUI)
-        SendProgressEvent(counter, (uint)m_directories.size(),
-                          tr("Searching for video files"));
-    for (const auto & dir : std::as_const(m_directories))
-    {
-        if (!buildFileList(dir, imageExtensions, fs_files))
-        {
-            if (dir.startsWith("myth://"))
-            {
-                QUrl sgurl { dir };
-                QString host = sgurl.host().toLower();
-
-                m_liveSGHosts.removeAll(host);
-
-                LOG(VB_GENERAL, LOG_ERR,
-                    QString("Failed to scan :%1:").arg(dir));
-            }
-        }
-        if (m_hasGUI)
-            SendProgressEvent(++counter);
-    }
+    buildFileLists(imageExtensions, fs_files);
 
     PurgeList db_remove;
     verifyFiles(fs_files, db_remove);
@@ -308,60 +318,73 @@ bool VideoScannerThread::updateDB(const FileCheckList &add, const PurgeList &rem
         SendProgressEvent(counter, (uint)(add.size() + remove.size()),
                           tr("Updating video database"));
 
+    // Hash the files not already in the DB first, reading them can take a
+    // while and should not hold the transaction open.
+    std::vector<std::pair<FileCheckList::const_iterator, QString> > added;
     for (auto p = add.cbegin(); p != add.cend(); ++p)
     {
-        // add files not already in the DB
         if (!p->second.check)
         {
-            int id = -1;
+            added.emplace_back(p, VideoMetadata::VideoFileHash(p->first,
+                                                               p->second.host));
+        }
+        if (m_hasGUI)
+            SendProgressEvent(++counter);
+    }
 
-            // Are we sure this needs adding?  Let's check our Hash list.
-            QString hash = VideoMetadata::VideoFileHash(p->first, p->second.host);
-            if (hash != "NULL" && !hash.isEmpty())
-            {
-                id = VideoMetadata::UpdateHashedDBRecord(hash, p->first, p->second.host);
-                if (id != -1)
-                {
-                    // Whew, that was close.  Let's remove that thing from
-                    // our purge list, too.
-                    LOG(VB_GENERAL, LOG_ERR,
-                        QString("Hash %1 already exists in the "
-                                "database, updating record %2 "
-                                "with new filename %3")
-                            .arg(hash).arg(id).arg(p->first));
-                    m_movList.append(id);
-                }
-            }
-            if (id == -1)
+    // All the queries below reuse this connection, so the additions, moves
+    // and removals are committed together rather than a row at a time.
+    MSqlQuery transaction(MSqlQuery::InitCon());
+    if (!transaction.exec("START TRANSACTION"))
+        MythDB::DBError("VideoScannerThread::updateDB", transaction);
+
+    for (const auto & [p, hash] : added)
+    {
+        int id = -1;
+
+        // Are we sure this needs adding?  Let's check our Hash list.
+        if (hash != "NULL" && !hash.isEmpty())
+        {
+            id = VideoMetadata::UpdateHashedDBRecord(hash, p->first, p->second.host);
+            if (id != -1)
             {
-                VideoMetadata newFile(
-                    p->first, QString(), hash,
-                    VIDEO_TRAILER_DEFAULT,
-                    VIDEO_COVERFILE_DEFAULT,
-                    VIDEO_SCREENSHOT_DEFAULT,
-                    VIDEO_BANNER_DEFAULT,
-                    VIDEO_FANART_DEFAULT,
-                    QString(), QString(), QString(), QString(),
-                    QString(),
-                    VIDEO_YEAR_DEFAULT,
-                    QDate::fromString("0000-00-00","YYYY-MM-DD"),
-                    VIDEO_INETREF_DEFAULT, 0, QString(),
-                    VIDEO_DIRECTOR_DEFAULT, QString(), VIDEO_PLOT_DEFAULT,
-                    0.0, VIDEO_RATING_DEFAULT, 0, 0,
-                    0, 0,
-                    MythDate::current().date(),
-                    0, ParentalLevel::plLowest);
-
-                LOG(VB_GENERAL, LOG_INFO, QString("Adding : %1 : %2 : %3")
-                    .arg(newFile.GetHost(), newFile.GetFilename(), hash));
-                newFile.SetHost(p->second.host);
-                newFile.SaveToDatabase();
-                m_addList << newFile.GetID();
+                // Whew, that was close.  Let's remove that thing from
+                // our purge list, too.
+                LOG(VB_GENERAL, LOG_ERR,
+                    QString("Hash %1 already exists in the "
+                            "database, updating record %2 "
+                            "with new filename %3")
+                        .arg(hash).arg(id).arg(p->first));
+                m_movList.append(id);
             }
-            ret += 1;
         }
-        if (m_hasGUI)
-            SendProgressEvent(++counter);
+        if (id == -1)
+        {
+            VideoMetadata newFile(
+                p->first, QString(), hash,
+                VIDEO_TRAILER_DEFAULT,
+                VIDEO_COVERFILE_DEFAULT,
+                VIDEO_SCREENSHOT_DEFAULT,
+                VIDEO_BANNER_DEFAULT,
+                VIDEO_FANART_DEFAULT,
+                QString(), QString(), QString(), QString(),
+                QString(),
+                VIDEO_YEAR_DEFAULT,
+                QDate::fromString("0000-00-00","YYYY-MM-DD"),
+                VIDEO_INETREF_DEFAULT, 0, QString(),
+                VIDEO_DIRECTOR_DEFAULT, QString(), VIDEO_PLOT_DEFAULT,
+                0.0, VIDEO_RATING_DEFAULT, 0, 0,
+                0, 0,
+                MythDate::current().date(),
+                0, ParentalLevel::plLowest);
+
+            LOG(VB_GENERAL, LOG_INFO, QString("Adding : %1 : %2 : %3")
+                .arg(newFile.GetHost(), newFile.GetFilename(), hash));
+            newFile.SetHost(p->second.host);
+            newFile.SaveToDatabase();
+            m_addList << newFile.GetID();
+        }
+        ret += 1;
     }
 
     // When prompting is restored, account for the answer here.
@@ -377,12 +400,94 @@ bool VideoScannerThread::updateDB(const FileCheckList &add, const PurgeList &rem
             SendProgressEvent(++counter);
     }
 
+    if (!transaction.exec("COMMIT"))
+        MythDB::DBError("VideoScannerThread::updateDB", transaction);
+
     return ret > 0;
 }
 
+/// Walk the directories of each host or local file system on a thread of
+/// its own, as most of the time is spent waiting for (network) storage.
+void VideoScannerThread::buildFileLists(const QStringList &imageExtensions,
+                                        FileCheckList &filelist)
+{
+    QString snapshot_file = GetCacheDir() + "/videoscan.snapshot";
+    DirectorySnapshot snapshot;
+    snapshot.Load(snapshot_file);
+
+    QMap<QString, QList<int> > groups;
+    for (int i = 0; i < m_directories.size(); ++i)
+        groups[walk_group(m_directories[i])].append(i);
+
+    std::vector<FileCheckList> found(m_directories.size());
+    std::vector<int> scanned(m_directories.size(), 0);
+    QMutex progress_lock;
+    uint counter = 0;
+
+    if (m_hasGUI)
+        SendProgressEvent(counter, (uint)m_directories.size(),
+                          tr("Searching for video files"));
+
+    MThreadPool pool("VideoScanWalk");
+    pool.setMaxThreadCount(std::max(static_cast<int>(groups.size()), 1));
+    for (const auto & group : std::as_const(groups))
+    {
+        auto walk = [&, group]()
+        {
+            for (int i : group)
+            {
+                scanned[i] = static_cast<int>(
+                    buildFileList(m_directories[i], imageExtensions,
+                                  found[i], &snapshot));
+                if (m_hasGUI)
+                {
+                    QMutexLocker locker(&progress_lock);
+                    SendProgressEvent(++counter);
+                }
+            }
+        };
+        pool.start(new VideoScanWalker(walk), "VideoScanWalk");
+    }
+    pool.waitForDone();
+
+    // Merge in the order of the directories, a file found in more than one
+    // keeps the host of the last one as before
+    for (int i = 0; i < m_directories.size(); ++i)
+    {
+        const QString &dir = m_directories[i];
+        if (!scanned[i] && dir.startsWith("myth://"))
+        {
+            QUrl sgurl { dir };
+            QString host = sgurl.host().toLower();
+
+            m_liveSGHosts.removeAll(host);
+
+            LOG(VB_GENERAL, LOG_ERR,
+                QString("Failed to scan :%1:").arg(dir));
+        }
+
+        for (auto & file : found[i])
+            filelist[file.first] = file.second;
+    }
+
+    LOG(VB_GENERAL, LOG_INFO,
+        QString("Searched %1 video directories with %2 walkers, %3 "
+                "unchanged directories were not listed again")
+            .arg(m_directories.size()).arg(groups.size())
+            .arg(snapshot.GetReusedCount()));
+
+    if (!snapshot.Save(snapshot_file))
+    {
+        LOG(VB_GENERAL, LOG_WARNING,
+            QString("Unable to save video directory snapshot %1")
+                .arg(snapshot_file));
+    }
+}
+
 bool VideoScannerThread::buildFileList(const QString &directory,
                                        const QStringList &imageExtensions,
-                                       FileCheckList &filelist) const
+                                       FileCheckList &filelist,
+                                       DirectorySnapshot *snapshot) const
 {
     // TODO: FileCheckList is a std::map, keyed off the filename. In the event
     // multiple backends have access to shared storage, the potential exists
@@ -396,7 +501,8 @@ bool VideoScannerThread::buildFileList(const QString &directory,
     FileAssociations::getFileAssociation().getExtensionIgnoreList(ext_list);
 
     dirhandler<FileCheckList> dh(filelist, imageExtensions);
-    return ScanVideoDirectory(directory, &dh, ext_list, m_listUnknown);
+    return ScanVideoDirectory(directory, &dh, ext_list, m_listUnknown,
+                              snapshot);
 }
 
 void VideoScannerThread::SendProgressEvent(uint progress, uint total,
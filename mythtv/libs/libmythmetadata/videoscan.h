@@ -17,6 +17,7 @@
 #include "libmythmetadata/mythmetaexp.h"
 #include "libmythui/mythprogressdialog.h"
 
+class DirectorySnapshot;
 class VideoMetadataListManager;
 
 class META_PUBLIC VideoScanner : public QObject
@@ -91,9 +92,12 @@ class META_PUBLIC VideoScannerThread : public MThread
 
     void verifyFiles(FileCheckList &files, PurgeList &remove);
     bool updateDB(const FileCheckList &add, const PurgeList &remove);
+    void buildFileLists(const QStringList &imageExtensions,
+                        FileCheckList &filelist);
     bool buildFileList(const QString &directory,
-                                        const QStringList &imageExtensions,
-                                        FileCheckList &filelist) const;
+                       const QStringList &imageExtensions,
+                       FileCheckList &filelist,
+                       DirectorySnapshot *snapshot) const;
 
     void SendProgressEvent(uint progress, uint total = 0,
             QString messsage = QString());
@@ -1,15 +1,107 @@
+// Qt
+#include <QRunnable>
+
 // MythTV
 #include "libmythbase/mythcorecontext.h"
 #include "libmythbase/mythlogging.h"
+#include "libmythbase/mthreadpool.h"
 #include "DetectLetterbox.h"
 
 #define LOC QString("DetectLetterbox: ")
 
-static constexpr int8_t NUMBER_OF_DETECTION_LINES { 3 }; // How many lines are we looking at
-static constexpr int8_t THRESHOLD                 { 5 }; // Y component has to not vary more than this in the bars
-static constexpr int8_t HORIZONTAL_THRESHOLD      { 4 }; // How tolerant are we that the image has horizontal edges
+/// Border scan handed to the thread pool, shared so a scan still running
+/// when the player goes away has somewhere to write.
+class DetectLetterboxScan
+{
+  public:
+    QMutex           m_lock;
+    bool             m_busy   { false };
+    bool             m_ready  { false };
+    int              m_height { 0 };
+    float            m_aspect { 0.0F };
+    BorderScanResult m_result;
+};
+
+class DetectLetterboxRunnable : public QRunnable
+{
+  public:
+    DetectLetterboxRunnable(std::shared_ptr<DetectLetterboxScan> Scan, BorderSample Sample)
+      : m_scan(std::move(Scan)),
+        m_sample(std::move(Sample))
+    {
+    }
+
+    void run() override
+    {
+        BorderScanResult result = BorderScanner::FindLetterbox(m_sample);
+        QMutexLocker locker(&m_scan->m_lock);
+        m_scan->m_result = result;
+        m_scan->m_busy   = false;
+        m_scan->m_ready  = true;
+    }
+
+  private:
+    std::shared_ptr<DetectLetterboxScan> m_scan;
+    BorderSample m_sample;
+};
+
+void LetterboxHysteresis::Reset(AdjustFillMode Default, AdjustFillMode Current)
+{
+    m_defaultMode = Default;
+    m_mode        = Current;
+    m_pending     = Current;
+    m_count       = 0;
+}
+
+AdjustFillMode LetterboxHysteresis::Classify(const BorderScanResult& Result, int Height,
+                                             float VideoAspect, int Limit) const
+{
+    // If the black bars are larger than this limit we switch to Half or Full Mode
+    const int fullLimit = static_cast<int>((Height * (1 - (VideoAspect * 9 / 16)) / 2) * Limit / 100);
+    const int halfLimit = static_cast<int>((Height * (1 - (VideoAspect * 9 / 14)) / 2) * Limit / 100);
+
+    // Both bars have to be there, but once in a mode they may shrink a little
+    // (dark scenes, subtitles in the bar) before we leave it
+    const int bar = std::min(Result.m_top, Result.m_bottom);
+    if ((bar > fullLimit) || ((m_mode == kAdjustFill_Full) && (bar > fullLimit * 3 / 4)))
+        return kAdjustFill_Full;
+    if ((bar > halfLimit) || ((m_mode == kAdjustFill_Half) && (bar > halfLimit * 3 / 4)))
+        return kAdjustFill_Half;
+    return m_defaultMode;
+}
+
+/*! \brief Add a scan, returning true if the detected mode changed.
+ *
+ * Scans that found nothing but bar (black frames, fades) are ignored.
+*/
+bool LetterboxHysteresis::Add(const BorderScanResult& Result, int Height, float VideoAspect, int Limit)
+{
+    if (!Result.m_valid)
+        return false;
+
+    AdjustFillMode mode = Classify(Result, Height, VideoAspect, Limit);
+    if (mode == m_mode)
+    {
+        m_count = 0;
+        return false;
+    }
+
+    if (mode != m_pending || m_count == 0)
+    {
+        m_pending = mode;
+        m_count = 0;
+    }
+
+    if (++m_count < kConfirmSamples)
+        return false;
+
+    m_mode  = m_pending;
+    m_count = 0;
+    return true;
+}
 
 DetectLetterbox::DetectLetterbox()
+  : m_scan(std::make_shared<DetectLetterboxScan>())
 {
     int dbAdjustFill = gCoreContext->GetNumSetting("AdjustFill", 0);
     m_isDetectLetterbox = dbAdjustFill >= kAdjustFill_AutoDetect_DefaultOff;
@@ -17,46 +109,24 @@ DetectLetterbox::DetectLetterbox()
             static_cast<AdjustFillMode>(std::max(static_cast<int>(kAdjustFill_Off),
                                         dbAdjustFill - kAdjustFill_AutoDetect_DefaultOff));
     m_detectLetterboxLimit = gCoreContext->GetNumSetting("DetectLeterboxLimit", 75);
+    m_hysteresis.Reset(m_detectLetterboxDefaultMode, m_detectLetterboxDefaultMode);
 }
 
-/** \fn DetectLetterbox::Detect(VideoFrame*)
- *  \brief Detects if this frame is or is not letterboxed
+DetectLetterbox::~DetectLetterbox() = default;
+
+/** \fn DetectLetterbox::Detect(MythVideoFrame*, float, AdjustFillMode&)
+ *  \brief Detects if the video is or is not letterboxed
  *
- *  If a change is detected detectLetterboxSwitchFrame and
- *  detectLetterboxDetectedMode are set.
+ *  Every kSampleInterval frames the rows BorderScanner needs are copied from
+ *  the frame and scanned on the thread pool. The result is picked up by a
+ *  later call and, once LetterboxHysteresis is sure, Current is set and true
+ *  returned.
  */
 bool DetectLetterbox::Detect(MythVideoFrame *Frame, float VideoAspect, AdjustFillMode& Current)
 {
-    if (!Frame || !m_isDetectLetterbox)
-        return false;
-
-    unsigned char *buf = Frame->m_buffer;
-    if (!buf)
+    if (!Frame || !m_isDetectLetterbox || !Frame->m_buffer)
         return false;
 
-    const FramePitches pitches = Frame->m_pitches;
-    const FrameOffsets offsets = Frame->m_offsets;
-    const int height = Frame->m_height;
-
-    // If the black bars is larger than this limit we switch to Half or Full Mode
-    //    const int fullLimit = static_cast<int>(((height - width * 9 / 16) / 2) * m_detectLetterboxLimit / 100);
-    //    const int halfLimit = (static_cast<int>(((height - width * 9 / 14) / 2) * m_detectLetterboxLimit / 100);
-
-    // If the black bars is larger than this limit we switch to Half or Full Mode
-    const int fullLimit = static_cast<int>((height * (1 - (VideoAspect * 9 / 16)) / 2) * m_detectLetterboxLimit / 100);
-    const int halfLimit = static_cast<int>((height * (1 - (VideoAspect * 9 / 14)) / 2) * m_detectLetterboxLimit / 100);
-
-    // Lines to scan for black letterbox edge
-    const std::array<int,3> xPos { Frame->m_width / 4, Frame->m_width / 2, Frame->m_width * 3 / 4} ;
-    int topHits     = 0;
-    int bottomHits  = 0;
-    int minTop      = 0;
-    int minBottom   = 0;
-    int maxTop      = 0;
-    int maxBottom   = 0;
-    std::array<int,3> topHit    = { 0, 0, 0 };
-    std::array<int,3> bottomHit = { 0, 0, 0 };
-
     switch (Frame->m_type)
     {
         case FMT_YV12:
@@ -68,9 +138,8 @@ bool DetectLetterbox::Detect(MythVideoFrame *Frame, float VideoAspect, AdjustFil
         case FMT_NV12:
         case FMT_P010:
         case FMT_P016:
-            if (!m_firstFrameChecked || m_frameType != Frame->m_type)
+            if (m_frameType != Frame->m_type)
             {
-                m_firstFrameChecked = Frame->m_frameNumber;
                 LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("'%1' frame format detected")
                     .arg(MythVideoFrame::FormatDescription(Frame->m_type)));
             }
@@ -83,247 +152,68 @@ bool DetectLetterbox::Detect(MythVideoFrame *Frame, float VideoAspect, AdjustFil
             return false;
     }
 
-    if (Frame->m_frameNumber < 0)
-    {
-        LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("Strange frame number %1").arg(Frame->m_frameNumber));
-        return false;
-    }
-
     if (VideoAspect > 1.5F)
     {
-        if (m_detectLetterboxDetectedMode != m_detectLetterboxDefaultMode)
-        {
-            LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("The source is already in widescreen (aspect: %1)")
-                .arg(static_cast<double>(VideoAspect)));
-            m_detectLetterboxConsecutiveCounter = 0;
-            m_detectLetterboxDetectedMode = m_detectLetterboxDefaultMode;
-            m_detectLetterboxSwitchFrame = Frame->m_frameNumber;
-        }
-        else
-        {
-            m_detectLetterboxConsecutiveCounter++;
-        }
         LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("The source is already in widescreen (aspect: %1)")
             .arg(static_cast<double>(VideoAspect)));
         m_isDetectLetterbox = false;
         return false;
     }
 
-    // Establish the level of light in the edge
-    int averageY = 0;
-    for (int pos : xPos)
+    bool switched = false;
+    bool busy = false;
     {
-        averageY += buf[offsets[0] + (5 * pitches[0])            + pos];
-        averageY += buf[offsets[0] + ((height - 6) * pitches[0]) + pos];
-    }
-
-    averageY /= NUMBER_OF_DETECTION_LINES * 2;
-    if (averageY > 64) // Too bright to be a letterbox border
-        averageY = 0;
-
-    // Note - for 10/12 bit etc we only sample the most significant byte
-    bool triplanar = MythVideoFrame::FormatIs420(m_frameType);
-    int depth = MythVideoFrame::ColorDepth(m_frameType);
-    int leftshift = depth > 8 ? 1 : 0;
-    int rightshift = depth > 8 ? 0 : 1;
-
-    // Scan the detection lines
-    for (int y = 5; y < height / 4; y++) // skip first pixels incase of noise in the edge
-    {
-        for (int detectionLine = 0; detectionLine < NUMBER_OF_DETECTION_LINES; detectionLine++)
+        QMutexLocker locker(&m_scan->m_lock);
+        busy = m_scan->m_busy;
+        if (m_scan->m_ready)
         {
-            int Y = buf[offsets[0] + (y * pitches[0]) + (xPos[detectionLine] << leftshift)];
-            int U = 0;
-            int V = 0;
-            if (triplanar)
-            {
-                U = buf[offsets[1] + ((y>>1) * pitches[1]) + (xPos[detectionLine] >> rightshift)];
-                V = buf[offsets[2] + ((y>>1) * pitches[2]) + (xPos[detectionLine] >> rightshift)];
-            }
-            else
+            m_scan->m_ready = false;
+            const BorderScanResult& result = m_scan->m_result;
+            if (m_hysteresis.Add(result, m_scan->m_height, m_scan->m_aspect, m_detectLetterboxLimit))
             {
-                int offset = offsets[1] + ((y >> 1) * pitches[1]) + (xPos[detectionLine & ~0x1] << leftshift);
-                U = buf[offset];
-                V = buf[offset + (1 << leftshift)];
-            }
-
-            if ((!topHit[detectionLine]) &&
-                ( Y > averageY + THRESHOLD || Y < averageY - THRESHOLD ||
-                  U < 128 - 32 || U > 128 + 32 ||
-                  V < 128 - 32 || V > 128 + 32 ))
-            {
-                topHit[detectionLine] = y;
-                topHits++;
-                if (!minTop)
-                    minTop = y;
-                maxTop = y;
-            }
-
-            Y = buf[offsets[0] + ((height-y-1) * pitches[0]) + (xPos[detectionLine] << leftshift)];
-            if (triplanar)
-            {
-                U = buf[offsets[1] + (((height-y-1) >> 1) * pitches[1]) + (xPos[detectionLine] >> rightshift)];
-                V = buf[offsets[2] + (((height-y-1) >> 1) * pitches[2]) + (xPos[detectionLine] >> rightshift)];
-            }
-            else
-            {
-                int offset = offsets[1] + (((height - y -1) >> 1) * pitches[1]) + (xPos[detectionLine & ~0x1] << leftshift);
-                U = buf[offset];
-                V = buf[offset + (1 << leftshift)];
-            }
-
-            if ((!bottomHit[detectionLine]) &&
-                ( Y > averageY + THRESHOLD || Y < averageY - THRESHOLD ||
-                  U < 128 - 32 || U > 128 + 32 ||
-                  V < 128 - 32 || V > 128 + 32 ))
-            {
-                bottomHit[detectionLine] = y;
-                bottomHits++;
-                if (!minBottom)
-                    minBottom = y;
-                maxBottom = y;
+                LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("Detected '%1' (top: %2 bottom: %3 height: %4)")
+                    .arg(toString(m_hysteresis.GetMode())).arg(result.m_top)
+                    .arg(result.m_bottom).arg(m_scan->m_height));
+                switched = true;
             }
         }
-
-        if (topHits == NUMBER_OF_DETECTION_LINES && bottomHits == NUMBER_OF_DETECTION_LINES)
-            break;
     }
 
-    if (topHits != NUMBER_OF_DETECTION_LINES)
-        maxTop = height / 4;
-    if (!minTop)
-        minTop = height / 4;
-    if (bottomHits != NUMBER_OF_DETECTION_LINES)
-        maxBottom = height / 4;
-    if (!minBottom)
-        minBottom = height / 4;
-
-    bool horizontal = (((minTop != 0) && (maxTop - minTop < HORIZONTAL_THRESHOLD)) &&
-                       ((minBottom != 0) && (maxBottom - minBottom < HORIZONTAL_THRESHOLD)));
-
-    if (m_detectLetterboxSwitchFrame > Frame->m_frameNumber) // user is reversing
+    if (switched && (Current != m_hysteresis.GetMode()))
     {
-        m_detectLetterboxDetectedMode = Current;
-        m_detectLetterboxSwitchFrame = -1;
-        m_detectLetterboxPossibleHalfFrame = -1;
-        m_detectLetterboxPossibleFullFrame = -1;
+        LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("Switched to '%1' on frame %2")
+            .arg(toString(m_hysteresis.GetMode())).arg(Frame->m_frameNumber));
+        Current = m_hysteresis.GetMode();
+        return true;
     }
 
-    if (minTop < halfLimit || minBottom < halfLimit)
-        m_detectLetterboxPossibleHalfFrame = -1;
-    if (minTop < fullLimit || minBottom < fullLimit)
-        m_detectLetterboxPossibleFullFrame = -1;
-
-    if (m_detectLetterboxDetectedMode != kAdjustFill_Full)
-    {
-        if (m_detectLetterboxPossibleHalfFrame == -1 && minTop > halfLimit && minBottom > halfLimit)
-            m_detectLetterboxPossibleHalfFrame = Frame->m_frameNumber;
-    }
-    else
-    {
-        if (m_detectLetterboxPossibleHalfFrame == -1 && minTop < fullLimit && minBottom < fullLimit)
-            m_detectLetterboxPossibleHalfFrame = Frame->m_frameNumber;
-    }
-
-    if (m_detectLetterboxPossibleFullFrame == -1 && minTop > fullLimit && minBottom > fullLimit)
-        m_detectLetterboxPossibleFullFrame = Frame->m_frameNumber;
-
-    if (maxTop < halfLimit || maxBottom < halfLimit) // Not too restrictive when switching to off
-    {
-        // No Letterbox
-        if (m_detectLetterboxDetectedMode != m_detectLetterboxDefaultMode)
-        {
-            LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("Non Letterbox detected on line: %1 (limit: %2)")
-                .arg(std::min(maxTop, maxBottom)).arg(halfLimit));
-            m_detectLetterboxConsecutiveCounter = 0;
-            m_detectLetterboxDetectedMode = m_detectLetterboxDefaultMode;
-            m_detectLetterboxSwitchFrame = Frame->m_frameNumber;
-        }
-        else
-        {
-            m_detectLetterboxConsecutiveCounter++;
-        }
-    }
-    else if (horizontal && minTop > halfLimit && minBottom > halfLimit &&
-             maxTop < fullLimit && maxBottom < fullLimit)
-    {
-        // Letterbox (with narrow bars)
-        if (m_detectLetterboxDetectedMode != kAdjustFill_Half)
-        {
-            LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("Narrow Letterbox detected on line: %1 (limit: %2) frame: %3")
-                .arg(minTop).arg(halfLimit).arg(m_detectLetterboxPossibleHalfFrame));
-            m_detectLetterboxConsecutiveCounter = 0;
-            if (m_detectLetterboxDetectedMode == kAdjustFill_Full && m_detectLetterboxSwitchFrame != -1)
-            {
-                // Do not change switch frame if switch to Full mode has not been executed yet
-            }
-            else
-            {
-                m_detectLetterboxSwitchFrame = m_detectLetterboxPossibleHalfFrame;
-            }
-            m_detectLetterboxDetectedMode = kAdjustFill_Half;
-        }
-        else
-        {
-            m_detectLetterboxConsecutiveCounter++;
-        }
-    }
-    else if (horizontal && minTop > fullLimit && minBottom > fullLimit)
-    {
-        // Letterbox
-        m_detectLetterboxPossibleHalfFrame = -1;
-        if (m_detectLetterboxDetectedMode != kAdjustFill_Full)
-        {
-            LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("Detected Letterbox on line: %1 (limit: %2) frame: %3")
-                .arg(minTop).arg(fullLimit).arg(m_detectLetterboxPossibleFullFrame));
-            m_detectLetterboxConsecutiveCounter = 0;
-            m_detectLetterboxDetectedMode = kAdjustFill_Full;
-            m_detectLetterboxSwitchFrame = m_detectLetterboxPossibleFullFrame;
-        }
-        else
-        {
-            m_detectLetterboxConsecutiveCounter++;
-        }
-    }
-    else
-    {
-        if (m_detectLetterboxConsecutiveCounter <= 3)
-            m_detectLetterboxConsecutiveCounter = 0;
-    }
+    if (busy || (--m_framesToSample > 0))
+        return false;
+    m_framesToSample = kSampleInterval;
 
-    if (m_detectLetterboxSwitchFrame == -1)
+    BorderSample sample = BorderScanner::Sample(Frame);
+    if (!sample.IsValid())
         return false;
 
-    if (m_detectLetterboxSwitchFrame <= Frame->m_frameNumber && m_detectLetterboxConsecutiveCounter > 3)
-    {
-        if (Current != m_detectLetterboxDetectedMode)
-        {
-            LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("Switched to '%1' on frame %2 (%3)")
-                .arg(toString(m_detectLetterboxDetectedMode))
-                .arg(Frame->m_frameNumber).arg(m_detectLetterboxSwitchFrame));
-            Current = m_detectLetterboxDetectedMode;
-            return true;
-        }
-        m_detectLetterboxSwitchFrame = -1;
-    }
-    else if (m_detectLetterboxSwitchFrame <= Frame->m_frameNumber)
     {
-        LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("Not Switched to '%1' on frame %2 "
-                    "(%3) Not enough consecutive detections (%4)")
-            .arg(toString(m_detectLetterboxDetectedMode))
-            .arg(Frame->m_frameNumber).arg(m_detectLetterboxSwitchFrame)
-            .arg(m_detectLetterboxConsecutiveCounter));
+        QMutexLocker locker(&m_scan->m_lock);
+        m_scan->m_busy   = true;
+        m_scan->m_height = Frame->m_height;
+        m_scan->m_aspect = VideoAspect;
     }
-
+    MThreadPool::globalInstance()->start(new DetectLetterboxRunnable(m_scan, std::move(sample)),
+                                         "DetectLetterbox");
     return false;
 }
 
 void DetectLetterbox::SetDetectLetterbox(bool Detect, AdjustFillMode Mode)
 {
     m_isDetectLetterbox = Detect;
-    m_detectLetterboxSwitchFrame = -1;
-    m_detectLetterboxDetectedMode = Mode;
-    m_firstFrameChecked = 0;
+    m_hysteresis.Reset(m_detectLetterboxDefaultMode, Mode);
+    m_framesToSample = 0;
+    m_frameType = FMT_NONE;
+    QMutexLocker locker(&m_scan->m_lock);
+    m_scan->m_ready = false;
 }
 
 bool DetectLetterbox::GetDetectLetterbox() const
@@ -1,33 +1,66 @@
 #ifndef MYTHDETECTLETTERBOX_H
 #define MYTHDETECTLETTERBOX_H
 
+// Std
+#include <memory>
+
 // Qt
 #include <QMutex>
 
 // MythTV
 #include "mythframe.h"
 #include "videoouttypes.h"
+#include "borderscanner.h"
+
+/** \class LetterboxHysteresis
+ *  \brief Turns a stream of border scans into fill mode switches.
+ *
+ *  A scan has to exceed the limit of a mode to enter it, but only 3/4 of the
+ *  limit of the current mode to stay, and kConfirmSamples scans in a row have
+ *  to agree before the mode changes.
+ */
+class MTV_PUBLIC LetterboxHysteresis
+{
+  public:
+    static constexpr int kConfirmSamples { 4 };
+
+    void Reset(AdjustFillMode Default, AdjustFillMode Current);
+    bool Add(const BorderScanResult& Result, int Height, float VideoAspect, int Limit);
+    AdjustFillMode GetMode() const { return m_mode; }
+
+  private:
+    AdjustFillMode Classify(const BorderScanResult& Result, int Height,
+                            float VideoAspect, int Limit) const;
+
+    AdjustFillMode m_defaultMode { kAdjustFill_Off };
+    AdjustFillMode m_mode        { kAdjustFill_Off };
+    AdjustFillMode m_pending     { kAdjustFill_Off };
+    int            m_count       { 0 };
+};
+
+class DetectLetterboxScan;
 
 class MTV_PUBLIC DetectLetterbox
 {
   public:
+    static constexpr int kSampleInterval { 5 }; ///< frames between scans
+
     DetectLetterbox();
-   ~DetectLetterbox() = default;
+   ~DetectLetterbox();
     void SetDetectLetterbox(bool Detect, AdjustFillMode Mode);
     bool GetDetectLetterbox() const;
     bool Detect(MythVideoFrame* Frame, float VideoAspect, AdjustFillMode& Current);
 
   private:
+    Q_DISABLE_COPY(DetectLetterbox)
+
     bool           m_isDetectLetterbox                 { false };
-    long long      m_firstFrameChecked                 { 0 };
     VideoFrameType m_frameType                         { FMT_NONE };
     AdjustFillMode m_detectLetterboxDefaultMode        { kAdjustFill_Off };
-    AdjustFillMode m_detectLetterboxDetectedMode       { kAdjustFill_Off }; /// Which mode was last detected
-    long long      m_detectLetterboxSwitchFrame        { -1 }; /// On which frame was the mode switch detected
-    long long      m_detectLetterboxPossibleHalfFrame  { -1 };
-    long long      m_detectLetterboxPossibleFullFrame  { -1 };
-    int            m_detectLetterboxConsecutiveCounter { 0 };
     int            m_detectLetterboxLimit              { 75 };
+    int            m_framesToSample                    { 0 };
+    LetterboxHysteresis m_hysteresis;
+    std::shared_ptr<DetectLetterboxScan> m_scan;
 };
 
 #endif
@@ -0,0 +1,276 @@
+// C++
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <utility>
+
+// MythTV
+#include "libmythbase/mythlogging.h"
+#include "audioanalyser.h"
+
+extern "C" {
+#include "libavutil/mem.h"
+}
+
+#define LOC QString("AudioAnalyser: ")
+
+// the edges of the bands in Hz
+static constexpr std::array<double,AudioAnalysis::kBandCount + 1> kBandEdges
+    { 20, 60, 250, 500, 2000, 4000, 6000, 20000 };
+
+int AudioAnalysis::FrequencyBin(double Frequency) const
+{
+    auto bin = std::lround(Frequency * kFFTSize / std::max(m_sampleRate, 1));
+    return static_cast<int>(std::clamp<long>(bin, 0, kBins - 1));
+}
+
+AudioAnalyser::AudioAnalyser()
+  : MThread("AudioAnalyser"),
+    m_sigL(AudioAnalysis::kFFTSize),
+    m_sigR(AudioAnalysis::kFFTSize),
+    m_weight(AudioAnalysis::kFFTSize),
+    m_window(AudioAnalysis::kFFTSize)
+{
+    m_dftIn  = static_cast<float*>(av_malloc(sizeof(float) * AudioAnalysis::kFFTSize));
+    m_dftOut = static_cast<float*>(av_malloc(sizeof(float) * AudioAnalysis::kBins * 2));
+    if (!m_dftIn || !m_dftOut ||
+        av_tx_init(&m_rdftContext, &m_rdft, AV_TX_FLOAT_RDFT, 0,
+                   AudioAnalysis::kFFTSize, &kTxScale, 0x0) < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Failed to set up the FFT, nothing will be analysed");
+        m_rdft = nullptr;
+    }
+
+    // ramp the ends of the window down to a zero crossing
+    const int end = AudioAnalysis::kFFTSize / 40;
+    for (int k = 0; k < AudioAnalysis::kFFTSize; k++)
+    {
+        if (k < end)
+            m_window[k] = static_cast<float>(k) / end;
+        else if (k > AudioAnalysis::kFFTSize - end)
+            m_window[k] = static_cast<float>(AudioAnalysis::kFFTSize - k) / end;
+        else
+            m_window[k] = 1.0F;
+    }
+
+    start();
+}
+
+AudioAnalyser::~AudioAnalyser()
+{
+    {
+        QMutexLocker locker(&m_lock);
+        m_stop = true;
+        m_wait.wakeAll();
+    }
+    wait();
+
+    av_freep(reinterpret_cast<void*>(&m_dftIn));
+    av_freep(reinterpret_cast<void*>(&m_dftOut));
+    av_tx_uninit(&m_rdftContext);
+}
+
+void AudioAnalyser::SetSampleRate(int SampleRate)
+{
+    if (SampleRate <= 0)
+        return;
+    QMutexLocker locker(&m_lock);
+    m_sampleRate = SampleRate;
+}
+
+/*! \brief Queue a block of audio, returning the analysis it will get.
+ *
+ * Right is null for mono. This only copies the samples so it is cheap enough
+ * for the audio thread.
+*/
+AudioAnalysisPtr AudioAnalyser::Add(const short *Left, const short *Right,
+                                    unsigned long Length,
+                                    std::chrono::milliseconds Timecode)
+{
+    if (!Left || Length == 0)
+        return nullptr;
+
+    auto result = std::make_shared<AudioAnalysis>();
+    Block block { .m_result   = result,
+                  .m_left     = std::vector<short>(Left, Left + Length),
+                  .m_right    = Right ? std::vector<short>(Right, Right + Length)
+                                      : std::vector<short>(),
+                  .m_timecode = Timecode };
+
+    QMutexLocker locker(&m_lock);
+    block.m_sampleRate = m_sampleRate;
+    if (m_blocks.size() >= kMaxBlocks)
+    {
+        if (!m_dropping)
+        {
+            LOG(VB_PLAYBACK, LOG_WARNING, LOC +
+                QString("Over %1 blocks waiting, dropping the oldest").arg(kMaxBlocks));
+        }
+        m_dropping = true;
+        m_blocks.pop_front();
+    }
+    m_blocks.push_back(std::move(block));
+    m_wait.wakeAll();
+    return result;
+}
+
+void AudioAnalyser::Reset(void)
+{
+    QMutexLocker locker(&m_lock);
+    m_blocks.clear();
+    m_reset = true;
+}
+
+void AudioAnalyser::run(void)
+{
+    RunProlog();
+
+    QMutexLocker locker(&m_lock);
+    while (!m_stop)
+    {
+        if (m_blocks.empty())
+        {
+            m_dropping = false;
+            m_wait.wait(&m_lock);
+            continue;
+        }
+
+        Block block = std::move(m_blocks.front());
+        m_blocks.pop_front();
+        bool reset = std::exchange(m_reset, false);
+        locker.unlock();
+
+        if (reset)
+            Clear();
+        Analyse(block);
+
+        locker.relock();
+    }
+
+    RunEpilog();
+}
+
+void AudioAnalyser::Clear(void)
+{
+    std::ranges::fill(m_sigL, 0.0F);
+    std::ranges::fill(m_sigR, 0.0F);
+    std::ranges::fill(m_weight, 0.0F);
+    m_bassHistory.fill(0.0F);
+    m_historyPos   = 0;
+    m_historyCount = 0;
+    m_sinceBeat    = 0;
+    // m_beatCount carries on, it only has to change with each beat
+}
+
+void AudioAnalyser::Analyse(const Block &Input)
+{
+    // Shift the previous samples left, fading them so that only recent sound
+    // is loud while the whole window still resolves low frequencies, then
+    // append the block
+    const int fftlen = AudioAnalysis::kFFTSize;
+    const int i = std::min(static_cast<int>(Input.m_left.size()), fftlen);
+    const int start = fftlen - i;
+    float mult = 0.8F;      // decay older sound by this much
+    for (int k = 0; k < start; k++)
+    {                       // prior set ramps from mult to 1.0
+        if (k > start - i && start > i)
+        {
+            mult = mult + ((1 - mult) *
+                (1 - (static_cast<float>(start - k) / static_cast<float>(start - i))));
+        }
+        m_sigL[k]   = mult * m_sigL[i + k];
+        m_sigR[k]   = mult * m_sigR[i + k];
+        m_weight[k] = mult * m_weight[i + k];
+    }
+    const std::vector<short> &right = Input.m_right.empty() ? Input.m_left : Input.m_right;
+    for (int k = 0; k < i; k++)
+    {
+        m_sigL[start + k]   = Input.m_left[k] / 32768.0F; // +/- 1 peak-to-peak
+        m_sigR[start + k]   = right[k] / 32768.0F;
+        m_weight[start + k] = 1.0F;
+    }
+
+    // Nobody is waiting for this one
+    AudioAnalysisPtr result = Input.m_result.lock();
+    if (!result || !m_rdft)
+        return;
+
+    result->m_timecode   = Input.m_timecode;
+    result->m_sampleRate = Input.m_sampleRate;
+    result->m_gain = std::max(1.0F, std::inner_product(m_weight.cbegin(), m_weight.cend(),
+                                                       m_window.cbegin(), 0.0F));
+
+    Transform(m_sigL, result->m_left);
+    if (!Input.m_right.empty())
+        Transform(m_sigR, result->m_right);
+
+    const float norm = 1.0F / (result->m_gain * result->m_gain * 2);
+    result->m_energy = 0.0F;
+    for (size_t band = 0; band < AudioAnalysis::kBandCount; band++)
+    {
+        int first = std::max(result->FrequencyBin(kBandEdges[band]), 1);
+        int last  = result->FrequencyBin(kBandEdges[band + 1]);
+        float power = 0.0F;
+        for (int bin = first; bin < last; bin++)
+            power += result->LeftPower(bin) + result->RightPower(bin);
+        result->m_bands[band] = power * norm;
+        result->m_energy += result->m_bands[band];
+    }
+
+    Beat(*result, Input.m_left.size());
+
+    result->m_ready.store(true, std::memory_order_release);
+}
+
+void AudioAnalyser::Transform(const std::vector<float> &Signal, std::vector<float> &Spectrum)
+{
+    std::transform(Signal.cbegin(), Signal.cend(), m_window.cbegin(), m_dftIn,
+                   std::multiplies<>());
+    m_rdft(m_rdftContext, m_dftOut, m_dftIn, sizeof(float));
+
+    // Only the power is kept, which halves what each block holds on to
+    Spectrum.resize(AudioAnalysis::kBins);
+    for (size_t k = 0; k < Spectrum.size(); k++)
+    {
+        float re = m_dftOut[2 * k];
+        float im = m_dftOut[(2 * k) + 1];
+        Spectrum[k] = (re * re) + (im * im);
+    }
+}
+
+/*! \brief Decide whether the block is a beat.
+ *
+ * A beat is bass at least kThreshold times its average over the last
+ * kBeatHistory blocks, and no sooner than a quarter of a second (240 bpm)
+ * after the last one.
+*/
+void AudioAnalyser::Beat(AudioAnalysis &Result, size_t Length)
+{
+    static constexpr float kThreshold { 1.5F };
+    static constexpr float kSilence   { 1.0E-6F };
+
+    float bass = Result.m_bands[AudioAnalysis::kSubBass] + Result.m_bands[AudioAnalysis::kBass];
+    float average = 0.0F;
+    if (m_historyCount > 0)
+    {
+        average = std::accumulate(m_bassHistory.cbegin(),
+                                  m_bassHistory.cbegin() + m_historyCount, 0.0F) / m_historyCount;
+    }
+
+    m_sinceBeat += Length;
+    Result.m_beatStrength = (average > 0.0F) ? bass / average : 0.0F;
+    Result.m_beat = (m_historyCount >= kBeatHistory / 2) && (bass > kSilence) &&
+                    (Result.m_beatStrength > kThreshold) &&
+                    (m_sinceBeat >= static_cast<size_t>(Result.m_sampleRate / 4));
+    if (Result.m_beat)
+    {
+        m_sinceBeat = 0;
+        m_beatCount++;
+    }
+    Result.m_beatCount = m_beatCount;
+
+    m_bassHistory[m_historyPos] = bass;
+    m_historyPos = (m_historyPos + 1) % kBeatHistory;
+    m_historyCount = std::min(m_historyCount + 1, kBeatHistory);
+}
@@ -0,0 +1,154 @@
+#ifndef LIBMYTHTV_AUDIO_AUDIOANALYSER_H
+#define LIBMYTHTV_AUDIO_AUDIOANALYSER_H
+
+// C++
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+// Qt
+#include <QMutex>
+#include <QWaitCondition>
+
+// MythTV
+#include "libmythbase/mthread.h"
+#include "libmythtv/mythtvexp.h"
+
+extern "C" {
+#include "libavutil/tx.h"
+}
+
+/** \class AudioAnalysis
+ *  \brief The spectrum, band energies and beat of one block of audio.
+ *
+ *  It is filled in by AudioAnalyser on its own thread. Nothing in it may be
+ *  read before IsReady() returns true, and nothing changes after that.
+ */
+class MTV_PUBLIC AudioAnalysis
+{
+  public:
+    static constexpr int kFFTSize { 16 * 1024 };
+    static constexpr int kBins    { (kFFTSize / 2) + 1 };
+
+    enum Band : std::uint8_t
+    {
+        kSubBass = 0,   ///<    20 -    60 Hz
+        kBass,          ///<    60 -   250 Hz
+        kLowMid,        ///<   250 -   500 Hz
+        kMid,           ///<   500 -  2000 Hz
+        kHighMid,       ///<  2000 -  4000 Hz
+        kPresence,      ///<  4000 -  6000 Hz
+        kBrilliance,    ///<  6000 - 20000 Hz
+        kBandCount
+    };
+
+    bool IsReady(void) const { return m_ready.load(std::memory_order_acquire); }
+
+    float LeftPower(int Bin) const  { return m_left[static_cast<size_t>(Bin)]; }
+    float RightPower(int Bin) const
+        { return (m_right.empty() ? m_left : m_right)[static_cast<size_t>(Bin)]; }
+    float BinFrequency(int Bin) const
+        { return static_cast<float>(Bin) * static_cast<float>(m_sampleRate) / kFFTSize; }
+    int   FrequencyBin(double Frequency) const;
+
+    std::chrono::milliseconds m_timecode { 0 };
+    int                m_sampleRate   { 44100 };
+    /// power spectrum of each channel from DC to Nyquist, kBins of them, of
+    /// samples scaled to +/- 1; m_right is empty for mono
+    std::vector<float> m_left;
+    std::vector<float> m_right;
+    /// sum of the window, the power of a sine of amplitude A peaks at
+    /// (A * m_gain / 2)^2
+    float              m_gain         { 1.0F };
+    /// power of each band, the mean of both channels divided by m_gain^2,
+    /// so a full scale sine in a band gives about 0.25
+    std::array<float,kBandCount> m_bands {};
+    float              m_energy       { 0.0F };   ///< of all the bands
+    bool               m_beat         { false };
+    float              m_beatStrength { 0.0F };   ///< bass over its recent average
+    /// beats so far, so that one in a block that was never drawn is not lost
+    uint32_t           m_beatCount    { 0 };
+
+  private:
+    friend class AudioAnalyser;
+
+    std::atomic<bool>  m_ready        { false };
+};
+
+using AudioAnalysisPtr = std::shared_ptr<AudioAnalysis>;
+
+/** \class AudioAnalyser
+ *  \brief Works out an AudioAnalysis of every block of audio given to a
+ *         visualiser, once, on a thread of its own.
+ *
+ *  The blocks are fed from Visualization::add() and the AudioAnalysis handed
+ *  back is kept with the block until it is drawn. The spectrum is taken over
+ *  a window of the last kFFTSize samples in which older audio is faded out,
+ *  so low frequencies are resolved without smearing quick sounds. Analyses
+ *  nobody holds any more only update that window.
+ */
+class MTV_PUBLIC AudioAnalyser : public MThread
+{
+  public:
+    AudioAnalyser();
+   ~AudioAnalyser() override;
+
+    void SetSampleRate(int SampleRate);
+    AudioAnalysisPtr Add(const short *Left, const short *Right, unsigned long Length,
+                         std::chrono::milliseconds Timecode);
+    /// forget the audio so far, after a seek or a change of track
+    void Reset(void);
+
+  protected:
+    void run(void) override; // MThread
+
+  private:
+    struct Block
+    {
+        std::weak_ptr<AudioAnalysis> m_result;
+        std::vector<short>           m_left;
+        std::vector<short>           m_right;
+        std::chrono::milliseconds    m_timecode   { 0 };
+        int                          m_sampleRate { 44100 };
+    };
+
+    // blocks waiting before the oldest are dropped
+    static constexpr size_t kMaxBlocks   { 256 };
+    // about a second of blocks
+    static constexpr int    kBeatHistory { 43 };
+
+    void Clear(void);
+    void Analyse(const Block &Input);
+    void Transform(const std::vector<float> &Signal, std::vector<float> &Spectrum);
+    void Beat(AudioAnalysis &Result, size_t Length);
+
+    QMutex                m_lock;
+    QWaitCondition        m_wait;
+    std::deque<Block>     m_blocks;
+    int                   m_sampleRate { 44100 };
+    bool                  m_reset      { false };
+    bool                  m_stop       { false };
+    bool                  m_dropping   { false };
+
+    // only used by the analyser thread
+    std::vector<float>    m_sigL;
+    std::vector<float>    m_sigR;
+    std::vector<float>    m_weight;       ///< what the fading did to each sample
+    std::vector<float>    m_window;
+    float                *m_dftIn       { nullptr };
+    float                *m_dftOut      { nullptr };
+    static constexpr float kTxScale     { 1.0F };
+    AVTXContext          *m_rdftContext { nullptr };
+    av_tx_fn              m_rdft        { nullptr };
+    std::array<float,kBeatHistory> m_bassHistory {};
+    int                   m_historyPos   { 0 };
+    int                   m_historyCount { 0 };
+    size_t                m_sinceBeat    { 0 };
+    uint32_t              m_beatCount    { 0 };
+};
+
+#endif // LIBMYTHTV_AUDIO_AUDIOANALYSER_H
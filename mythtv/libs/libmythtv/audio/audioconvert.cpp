@@ -23,12 +23,15 @@
 #include "audioconvert.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdint>
+#include <numbers>
 
 // FFmpeg
 extern "C" {
 #include "libavcodec/avcodec.h"
+#include "libavutil/cpu.h"
 #include "libswresample/swresample.h"
 }
 
@@ -37,12 +40,29 @@ extern "C" {
 #include <QtProcessorDetection>
 #endif
 
+#include "libmythbase/mythconfig.h"
 #include "libmythbase/mythlogging.h"
 
 #include "libmythtv/mythaverror.h"
 
 #define LOC QString("AudioConvert: ")
 
+// The (de)interleave and downmix kernels use intrinsics, the sample format
+// conversions below have their own SSE2 assembly. Where the CPU has AVX2 they
+// all use eight wide kernels, compiled for AVX2 whatever the build targets.
+#ifdef Q_PROCESSOR_X86_64
+#   include <immintrin.h>
+static const bool s_haveSIMD = true;
+#   if defined(__GNUC__) || defined(__clang__)
+#       define AVX2_KERNELS 1
+#       define AVX2_TARGET __attribute__((target("avx2")))
+static const bool s_haveAVX2 = av_get_cpu_flags() & AV_CPU_FLAG_AVX2;
+#   endif
+#elif HAVE_INTRINSICS_NEON
+#   include <arm_neon.h>
+static const bool s_haveSIMD = av_get_cpu_flags() & AV_CPU_FLAG_NEON;
+#endif
+
 #ifdef Q_PROCESSOR_X86
 // Check cpuid for SSE2 support on x86 / x86_64
 static inline bool sse2_check()
@@ -81,6 +101,100 @@ static inline float clipcheck(float f)
     return std::clamp(f, -1.0F, 1.0F);
 }
 
+#ifdef AVX2_KERNELS
+/*
+ AVX2 versions of the SSE2 conversions below, rounding and clipping the same
+ way. They process 16 samples at a time and return the samples done.
+ */
+AVX2_TARGET
+static int toFloat16AVX2(float* out, const short* in, int len)
+{
+    __m256 f = _mm256_set1_ps(1.0F / (1<<15));
+    int i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i s1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i s2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 8));
+        __m256 f1 = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(s1));
+        __m256 f2 = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(s2));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(f1, f));
+        _mm256_storeu_ps(out + i + 8, _mm256_mul_ps(f2, f));
+    }
+    return i;
+}
+
+AVX2_TARGET
+static int fromFloat16AVX2(short* out, const float* in, int len)
+{
+    __m256 f = _mm256_set1_ps(1<<15);
+    int i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+        __m256i s1 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(in + i), f));
+        __m256i s2 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(in + i + 8), f));
+        // the pack works within each 128 bit lane, so put the quarters in order
+        __m256i s = _mm256_permute4x64_epi64(_mm256_packs_epi32(s1, s2),
+                                             _MM_SHUFFLE(3,1,2,0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), s);
+    }
+    return i;
+}
+
+AVX2_TARGET
+static int toFloat32AVX2(float* out, const int* in, int len, float f, int shift)
+{
+    __m256 mul = _mm256_set1_ps(f);
+    __m128i count = _mm_cvtsi32_si128(shift);
+    int i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+        __m256i s1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i s2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 8));
+        __m256 f1 = _mm256_cvtepi32_ps(_mm256_sra_epi32(s1, count));
+        __m256 f2 = _mm256_cvtepi32_ps(_mm256_sra_epi32(s2, count));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(f1, mul));
+        _mm256_storeu_ps(out + i + 8, _mm256_mul_ps(f2, mul));
+    }
+    return i;
+}
+
+AVX2_TARGET
+static int fromFloat32AVX2(int* out, const float* in, int len, float f, int shift)
+{
+    __m256 mul = _mm256_set1_ps(f);
+    __m256 o   = _mm256_set1_ps(0.99999995F);
+    __m256 mo  = _mm256_set1_ps(-1.0F);
+    __m128i count = _mm_cvtsi32_si128(shift);
+    int i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+        __m256 f1 = _mm256_max_ps(_mm256_min_ps(_mm256_loadu_ps(in + i), o), mo);
+        __m256 f2 = _mm256_max_ps(_mm256_min_ps(_mm256_loadu_ps(in + i + 8), o), mo);
+        __m256i s1 = _mm256_sll_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(f1, mul)), count);
+        __m256i s2 = _mm256_sll_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(f2, mul)), count);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), s1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 8), s2);
+    }
+    return i;
+}
+
+AVX2_TARGET
+static int fromFloatFLTAVX2(float* out, const float* in, int len)
+{
+    __m256 o  = _mm256_set1_ps(1.0F);
+    __m256 mo = _mm256_set1_ps(-1.0F);
+    int i = 0;
+    for (; i + 16 <= len; i += 16)
+    {
+        __m256 f1 = _mm256_max_ps(_mm256_min_ps(_mm256_loadu_ps(in + i), o), mo);
+        __m256 f2 = _mm256_max_ps(_mm256_min_ps(_mm256_loadu_ps(in + i + 8), o), mo);
+        _mm256_storeu_ps(out + i, f1);
+        _mm256_storeu_ps(out + i + 8, f2);
+    }
+    return i;
+}
+#endif // AVX2_KERNELS
+
 /*
  The SSE code processes 16 bytes at a time and leaves any remainder for the C
  */
@@ -217,6 +331,15 @@ static int toFloat16(float* out, const short* in, int len)
     int i = 0;
     float f = 1.0F / (1<<15);
 
+#ifdef AVX2_KERNELS
+    if (s_haveAVX2)
+    {
+        i = toFloat16AVX2(out, in, len);
+        out += i;
+        in  += i;
+    }
+    else
+#endif
 #ifdef Q_PROCESSOR_X86
     if (sse2_check() && len >= 16)
     {
@@ -279,6 +402,15 @@ static int fromFloat16(short* out, const float* in, int len)
     int i = 0;
     float f = (1<<15);
 
+#ifdef AVX2_KERNELS
+    if (s_haveAVX2)
+    {
+        i = fromFloat16AVX2(out, in, len);
+        out += i;
+        in  += i;
+    }
+    else
+#endif
 #ifdef Q_PROCESSOR_X86
     if (sse2_check() && len >= 16)
     {
@@ -331,6 +463,15 @@ static int toFloat32(AudioFormat format, float* out, const int* in, int len)
     if (format == FORMAT_S24LSB)
         shift = 0;
 
+#ifdef AVX2_KERNELS
+    if (s_haveAVX2)
+    {
+        i = toFloat32AVX2(out, in, len, f, shift);
+        out += i;
+        in  += i;
+    }
+    else
+#endif
 #ifdef Q_PROCESSOR_X86
     if (sse2_check() && len >= 16)
     {
@@ -388,6 +529,15 @@ static int fromFloat32(AudioFormat format, int* out, const float* in, int len)
     if (format == FORMAT_S24LSB)
         shift = 0;
 
+#ifdef AVX2_KERNELS
+    if (s_haveAVX2)
+    {
+        i = fromFloat32AVX2(out, in, len, f, shift);
+        out += i;
+        in  += i;
+    }
+    else
+#endif
 #ifdef Q_PROCESSOR_X86
     if (sse2_check() && len >= 16)
     {
@@ -470,6 +620,15 @@ static int fromFloatFLT(float* out, const float* in, int len)
 {
     int i = 0;
 
+#ifdef AVX2_KERNELS
+    if (s_haveAVX2)
+    {
+        i = fromFloatFLTAVX2(out, in, len);
+        out += i;
+        in  += i;
+    }
+    else
+#endif
 #ifdef Q_PROCESSOR_X86
     if (sse2_check() && len >= 16)
     {
@@ -739,9 +898,142 @@ void AudioConvert::MonoToStereo(void* dst, const void* src, int samples)
     }
 }
 
+#ifdef AVX2_KERNELS
+/// Stereo 32 bit samples, eight frames at a time. Returns the frames done.
+AVX2_TARGET
+static int DeinterleaveStereo32AVX2(int* out, const int* in, int frames)
+{
+    int* left  = out;
+    int* right = out + frames;
+    int i = 0;
+    for (; i + 8 <= frames; i += 8)
+    {
+        __m256 a = _mm256_loadu_ps(reinterpret_cast<const float*>(in + (i * 2)));
+        __m256 b = _mm256_loadu_ps(reinterpret_cast<const float*>(in + (i * 2) + 8));
+        // the shuffle works within each 128 bit lane, so put the pairs in order
+        __m256i l = _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0)));
+        __m256i r = _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(left + i),
+                            _mm256_permute4x64_epi64(l, _MM_SHUFFLE(3,1,2,0)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(right + i),
+                            _mm256_permute4x64_epi64(r, _MM_SHUFFLE(3,1,2,0)));
+    }
+    return i;
+}
+
+/// Stereo 32 bit samples, eight frames at a time. Returns the frames done.
+AVX2_TARGET
+static int InterleaveStereo32AVX2(int* out, const int* left, const int* right, int frames)
+{
+    int i = 0;
+    for (; i + 8 <= frames; i += 8)
+    {
+        __m256 l = _mm256_loadu_ps(reinterpret_cast<const float*>(left + i));
+        __m256 r = _mm256_loadu_ps(reinterpret_cast<const float*>(right + i));
+        __m256 lo = _mm256_unpacklo_ps(l, r);
+        __m256 hi = _mm256_unpackhi_ps(l, r);
+        _mm256_storeu_ps(reinterpret_cast<float*>(out + (i * 2)),
+                         _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(reinterpret_cast<float*>(out + (i * 2) + 8),
+                         _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+    return i;
+}
+#endif // AVX2_KERNELS
+
+#if defined(Q_PROCESSOR_X86_64) || HAVE_INTRINSICS_NEON
+/// Stereo 32 bit samples, four frames at a time. Returns the frames done.
+static int DeinterleaveStereo32(int* out, const int* in, int frames)
+{
+    int* left  = out;
+    int* right = out + frames;
+    int i = 0;
+#ifdef AVX2_KERNELS
+    if (s_haveAVX2)
+        i = DeinterleaveStereo32AVX2(out, in, frames);
+#endif
+    for (; i + 4 <= frames; i += 4)
+    {
+#ifdef Q_PROCESSOR_X86_64
+        // the samples are only moved around, so any 32 bit format will do
+        __m128 a = _mm_loadu_ps(reinterpret_cast<const float*>(in + (i * 2)));
+        __m128 b = _mm_loadu_ps(reinterpret_cast<const float*>(in + (i * 2) + 4));
+        _mm_storeu_ps(reinterpret_cast<float*>(left + i), _mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0)));
+        _mm_storeu_ps(reinterpret_cast<float*>(right + i), _mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1)));
+#else
+        int32x4x2_t lr = vld2q_s32(in + (i * 2));
+        vst1q_s32(left + i, lr.val[0]);
+        vst1q_s32(right + i, lr.val[1]);
+#endif
+    }
+    return i;
+}
+
+/// Stereo 32 bit samples, four frames at a time. Returns the frames done.
+static int InterleaveStereo32(int* out, const int* left, const int* right, int frames)
+{
+    int i = 0;
+#ifdef AVX2_KERNELS
+    if (s_haveAVX2)
+        i = InterleaveStereo32AVX2(out, left, right, frames);
+#endif
+    for (; i + 4 <= frames; i += 4)
+    {
+#ifdef Q_PROCESSOR_X86_64
+        __m128 l = _mm_loadu_ps(reinterpret_cast<const float*>(left + i));
+        __m128 r = _mm_loadu_ps(reinterpret_cast<const float*>(right + i));
+        _mm_storeu_ps(reinterpret_cast<float*>(out + (i * 2)), _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(reinterpret_cast<float*>(out + (i * 2) + 4), _mm_unpackhi_ps(l, r));
+#else
+        int32x4x2_t lr { vld1q_s32(left + i), vld1q_s32(right + i) };
+        vst2q_s32(out + (i * 2), lr);
+#endif
+    }
+    return i;
+}
+#endif
+
+// With the channel count known at compile time the inner loop is fully
+// unrolled, which is what the common layouts without a SIMD kernel get.
+template <class AudioDataType, int Channels>
+static void tDeinterleaveFixed(AudioDataType* out, const AudioDataType* in, int frames)
+{
+    for (int i = 0; i < frames; i++)
+    {
+        for (int j = 0; j < Channels; j++)
+            out[(j * frames) + i] = in[j];
+        in += Channels;
+    }
+}
+
 template <class AudioDataType>
 void tDeinterleaveSample(AudioDataType* out, const AudioDataType* in, int channels, int frames)
 {
+#if defined(Q_PROCESSOR_X86_64) || HAVE_INTRINSICS_NEON
+    if constexpr (sizeof(AudioDataType) == sizeof(int))
+    {
+        if (s_haveSIMD && channels == 2)
+        {
+            int done = DeinterleaveStereo32(reinterpret_cast<int*>(out),
+                                            reinterpret_cast<const int*>(in), frames);
+            for (int i = done; i < frames; i++)
+            {
+                out[i]          = in[(i * 2)];
+                out[frames + i] = in[(i * 2) + 1];
+            }
+            return;
+        }
+    }
+#endif
+
+    switch (channels)
+    {
+        case 2: tDeinterleaveFixed<AudioDataType,2>(out, in, frames); return;
+        case 6: tDeinterleaveFixed<AudioDataType,6>(out, in, frames); return;
+        case 8: tDeinterleaveFixed<AudioDataType,8>(out, in, frames); return;
+        default: break;
+    }
+
     std::array<AudioDataType*,8> outp {};
 
     for (int i = 0; i < channels; i++)
@@ -788,6 +1080,19 @@ void AudioConvert::DeinterleaveSamples(AudioFormat format, int channels,
     }
 }
 
+template <class AudioDataType, int Channels>
+static void tInterleaveFixed(AudioDataType* out,
+                             const std::array<const AudioDataType*,8> &inp,
+                             int frames)
+{
+    for (int i = 0; i < frames; i++)
+    {
+        for (int j = 0; j < Channels; j++)
+            out[j] = inp[j][i];
+        out += Channels;
+    }
+}
+
 template <class AudioDataType>
 void tInterleaveSample(AudioDataType* out, const AudioDataType* in, int channels, int frames,
                        const AudioDataType*  const* inp = nullptr)
@@ -817,6 +1122,32 @@ void tInterleaveSample(AudioDataType* out, const AudioDataType* in, int channels
         }
     }
 
+#if defined(Q_PROCESSOR_X86_64) || HAVE_INTRINSICS_NEON
+    if constexpr (sizeof(AudioDataType) == sizeof(int))
+    {
+        if (s_haveSIMD && channels == 2)
+        {
+            int done = InterleaveStereo32(reinterpret_cast<int*>(out),
+                                          reinterpret_cast<const int*>(my_inp[0]),
+                                          reinterpret_cast<const int*>(my_inp[1]), frames);
+            for (int i = done; i < frames; i++)
+            {
+                out[(i * 2)]     = my_inp[0][i];
+                out[(i * 2) + 1] = my_inp[1][i];
+            }
+            return;
+        }
+    }
+#endif
+
+    switch (channels)
+    {
+        case 2: tInterleaveFixed<AudioDataType,2>(out, my_inp, frames); return;
+        case 6: tInterleaveFixed<AudioDataType,6>(out, my_inp, frames); return;
+        case 8: tInterleaveFixed<AudioDataType,8>(out, my_inp, frames); return;
+        default: break;
+    }
+
     for (int i = 0; i < frames; i++)
     {
         for (int j = 0; j < channels; j++)
@@ -876,6 +1207,400 @@ void AudioConvert::InterleaveSamples(AudioFormat format, int channels,
     }
 }
 
+/*
+ SMPTE channel layout
+ DUAL-MONO      L   R
+ DUAL-MONO-LFE  L   R   LFE
+ MONO           M
+ MONO-LFE       M   LFE
+ STEREO         L   R
+ STEREO-LFE     L   R   LFE
+ 3F             L   R   C
+ 3F-LFE         L   R   C    LFE
+ 2F1            L   R   S
+ 2F1-LFE        L   R   LFE  S
+ 3F1            L   R   C    S
+ 3F1-LFE        L   R   C    LFE S
+ 2F2            L   R   LS   RS
+ 2F2-LFE        L   R   LFE  LS   RS
+ 3F2            L   R   C    LS   RS
+ 3F2-LFE        L   R   C    LFE  LS   RS
+ 3F3R-LFE       L   R   C    LFE  BC   LS   RS
+ 3F4-LFE        L   R   C    LFE  Rls  Rrs  LS   RS
+ */
+
+static const float m6db = 0.5;
+static const float m3db =       1.0F / std::numbers::sqrt2_v<float>; //  3dB = SQRT(1/2)
+static const float mm3db =     -1.0F / std::numbers::sqrt2_v<float>; // -3dB = SQRT(1/2)
+static const float msqrt_1_3 = -std::numbers::inv_sqrt3_v<float>;    // -SQRT(1/3)
+static const float sqrt_2_3  =  std::numbers::sqrt2_v<float> /
+                                std::numbers::sqrt3_v<float>;        // SQRT(2/3)
+static const float sqrt_2_3by3db = std::numbers::inv_sqrt3_v<float>; // SQRT(2/3)*-3dB = SQRT(2/3)*SQRT(1/2)=SQRT(1/3)
+static const float msqrt_1_3bym3db = 1.0F / (std::numbers::sqrt2_v<float> *
+                                             std::numbers::sqrt3_v<float>); // -SQRT(1/3)*-3dB = -SQRT(1/3)*SQRT(1/2) = -SQRT(1/6)
+
+using two_speaker_ratio = std::array<float,2>;
+using two_speaker_set   = std::array<two_speaker_ratio,8>;
+static const std::array<two_speaker_set,8> stereo_matrix
+{{
+//1F      L                R
+    {{
+        { 1,               1 },                 // M
+    }},
+
+//2F      L                R
+    {{
+        { 1,               0 },                 // L
+        { 0,               1 },                 // R
+    }},
+
+//3F      L                R
+    {{
+        { 1,               0 },                 // L
+        { 0,               1 },                 // R
+        { 1,               1 },                 // C
+    }},
+
+//3F1R    L                R
+    {{
+        { 1,               0 },                 // L
+        { 0,               1 },                 // R
+        { m3db,            m3db },              // C
+        { mm3db,           m3db },              // S
+    }},
+
+//3F2R    L                R
+    {{
+        { 1,               0 },                 // L
+        { 0,               1 },                 // R
+        { m3db,            m3db },              // C
+        { sqrt_2_3,        msqrt_1_3 },         // LS
+        { msqrt_1_3,       sqrt_2_3 },          // RS
+    }},
+
+//3F2R.1  L                R
+    {{
+        { 1,               0 },                 // L
+        { 0,               1 },                 // R
+        { m3db,            m3db },              // C
+        { 0,               0 },                 // LFE
+        { sqrt_2_3,        msqrt_1_3 },         // LS
+        { msqrt_1_3,       sqrt_2_3 },          // RS
+    }},
+
+// 3F3R.1 L                R
+    {{
+        { 1,               0 },                 // L
+        { 0,               1 },                 // R
+        { m3db,            m3db },              // C
+        { 0,               0 },                 // LFE
+        { m6db,            m6db },              // Cs
+        { sqrt_2_3,        msqrt_1_3 },         // LS
+        { msqrt_1_3,       sqrt_2_3 },          // RS
+    }},
+
+// 3F4R.1 L                R
+    {{
+        { 1,               0 },                 // L
+        { 0,               1 },                 // R
+        { m3db,            m3db },              // C
+        { 0,               0 },                 // LFE
+        { sqrt_2_3by3db,   msqrt_1_3bym3db },   // Rls
+        { msqrt_1_3bym3db, sqrt_2_3by3db },     // Rrs
+        { sqrt_2_3by3db,   msqrt_1_3bym3db },   // LS
+        { msqrt_1_3bym3db, sqrt_2_3by3db },     // RS
+    }}
+}};
+
+using six_speaker_ratio = std::array<float,6>;
+using six_speaker_set   = std::array<six_speaker_ratio,8>;
+static const std::array<six_speaker_set,3> s51_matrix
+{{
+    // 3F2R.1 in -> 3F2R.1 out
+    // L  R  C  LFE         LS       RS
+    {{
+        { 1, 0, 0, 0,       0,       0 },     // L
+        { 0, 1, 0, 0,       0,       0 },     // R
+        { 0, 0, 1, 0,       0,       0 },     // C
+        { 0, 0, 0, 1,       0,       0 },     // LFE
+        { 0, 0, 0, 0,       1,       0 },     // LS
+        { 0, 0, 0, 0,       0,       1 },     // RS
+    }},
+    // 3F3R.1 in -> 3F2R.1 out
+    // Used coefficient found at http://www.yamahaproaudio.com/training/self_training/data/smqr_en.pdf
+    // L  R  C  LFE         LS       RS
+    {{
+        { 1, 0, 0, 0,       0,       0 },     // L
+        { 0, 1, 0, 0,       0,       0 },     // R
+        { 0, 0, 1, 0,       0,       0 },     // C
+        { 0, 0, 0, 1,       0,       0 },     // LFE
+        { 0, 0, 0, 0,       m3db,    m3db },  // Cs
+        { 0, 0, 0, 0,       1,       0 },     // LS
+        { 0, 0, 0, 0,       0,       1 },     // RS
+    }},
+    // 3F4R.1 -> 3F2R.1 out
+    // L  R  C  LFE         LS       RS
+    {{
+        { 1, 0, 0, 0,       0,       0 },     // L
+        { 0, 1, 0, 0,       0,       0 },     // R
+        { 0, 0, 1, 0,       0,       0 },     // C
+        { 0, 0, 0, 1,       0,       0 },     // LFE
+        { 0, 0, 0, 0,       m3db,    0 },     // Rls
+        { 0, 0, 0, 0,       0,       m3db },  // Rrs
+        { 0, 0, 0, 0,       m3db,    0 },     // LS
+        { 0, 0, 0, 0,       0,       m3db },  // RS
+    }}
+}};
+
+// The channel counts are template parameters so that the matrix multiply
+// is fully unrolled. This does the frames the SIMD kernels leave.
+template <int ChannelsIn, size_t ChannelsOut>
+static void tDownmixFrames(float *dst, const float *src, int frames,
+                           const std::array<std::array<float,ChannelsOut>,8> &matrix)
+{
+    for (int n=0; n < frames; n++)
+    {
+        for (size_t i=0; i < ChannelsOut; i++)
+        {
+            float tmp = 0.0F;
+            for (int j=0; j < ChannelsIn; j++)
+                tmp += src[j] * matrix[j][i];
+            dst[i] = tmp;
+        }
+        src += ChannelsIn;
+        dst += ChannelsOut;
+    }
+}
+
+#ifdef AVX2_KERNELS
+/// Down to stereo, four frames at a time, as DownmixStereo(). Returns the
+/// frames done.
+template <int ChannelsIn>
+AVX2_TARGET
+static int DownmixStereoAVX2(float *dst, const float *src, int frames,
+                             const two_speaker_set &matrix)
+{
+    // the left and right ratios of each channel, four times
+    alignas(32) std::array<float,ChannelsIn * 8> ratios {};
+    for (int j = 0; j < ChannelsIn; j++)
+    {
+        for (int k = 0; k < 8; k += 2)
+        {
+            ratios[(j * 8) + k]     = matrix[j][0];
+            ratios[(j * 8) + k + 1] = matrix[j][1];
+        }
+    }
+
+    // each of the four samples twice
+    const __m256i pairs = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+
+    int n = 0;
+    for (; n + 4 <= frames; n += 4)
+    {
+        __m256 sum = _mm256_setzero_ps();
+        for (int j = 0; j < ChannelsIn; j++)
+        {
+            __m128 four = _mm_setr_ps(src[j], src[ChannelsIn + j],
+                                      src[(ChannelsIn * 2) + j], src[(ChannelsIn * 3) + j]);
+            __m256 samples = _mm256_permutevar8x32_ps(_mm256_castps128_ps256(four), pairs);
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(samples, _mm256_load_ps(&ratios[j * 8])));
+        }
+        _mm256_storeu_ps(dst, sum);
+        src += ChannelsIn * 4;
+        dst += 8;
+    }
+    return n;
+}
+
+/// Down to 5.1, a frame at a time, with the ratios padded to eight.
+template <int ChannelsIn>
+AVX2_TARGET
+static int Downmix51AVX2(float *dst, const float *src, int frames,
+                         const std::array<float,ChannelsIn * 8> &ratios)
+{
+    for (int n = 0; n < frames; n++)
+    {
+        __m256 sum = _mm256_setzero_ps();
+        for (int j = 0; j < ChannelsIn; j++)
+        {
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(src[j]),
+                                                   _mm256_load_ps(&ratios[j * 8])));
+        }
+        _mm_storeu_ps(dst, _mm256_castps256_ps128(sum));
+        _mm_storel_pi(reinterpret_cast<__m64*>(dst + 4), _mm256_extractf128_ps(sum, 1));
+        src += ChannelsIn;
+        dst += 6;
+    }
+    return frames;
+}
+#endif // AVX2_KERNELS
+
+#if defined(Q_PROCESSOR_X86_64) || HAVE_INTRINSICS_NEON
+/// Down to stereo, two frames at a time. Each input channel adds its left
+/// and right ratios times its sample in both frames. The sums are made in the
+/// same order as tDownmixFrames(). Returns the frames done.
+template <int ChannelsIn>
+static int DownmixStereo(float *dst, const float *src, int frames,
+                         const two_speaker_set &matrix)
+{
+    // the left and right ratios of each channel, twice
+    alignas(16) std::array<float,ChannelsIn * 4> ratios {};
+    for (int j = 0; j < ChannelsIn; j++)
+    {
+        ratios[(j * 4) + 0] = ratios[(j * 4) + 2] = matrix[j][0];
+        ratios[(j * 4) + 1] = ratios[(j * 4) + 3] = matrix[j][1];
+    }
+
+    // in place the two output frames never reach input that is still to be read
+    int n = 0;
+#ifdef AVX2_KERNELS
+    if (s_haveAVX2)
+    {
+        n = DownmixStereoAVX2<ChannelsIn>(dst, src, frames, matrix);
+        src += n * ChannelsIn;
+        dst += n * 2;
+    }
+#endif
+    for (; n + 2 <= frames; n += 2)
+    {
+        const float *next = src + ChannelsIn;
+#ifdef Q_PROCESSOR_X86_64
+        __m128 sum = _mm_setzero_ps();
+        for (int j = 0; j < ChannelsIn; j++)
+        {
+            __m128 samples = _mm_shuffle_ps(_mm_load_ss(src + j), _mm_load_ss(next + j),
+                                            _MM_SHUFFLE(0,0,0,0));
+            sum = _mm_add_ps(sum, _mm_mul_ps(samples, _mm_load_ps(&ratios[j * 4])));
+        }
+        _mm_storeu_ps(dst, sum);
+#else
+        float32x4_t sum = vdupq_n_f32(0.0F);
+        for (int j = 0; j < ChannelsIn; j++)
+        {
+            float32x4_t samples = vcombine_f32(vdup_n_f32(src[j]), vdup_n_f32(next[j]));
+            sum = vaddq_f32(sum, vmulq_f32(samples, vld1q_f32(&ratios[j * 4])));
+        }
+        vst1q_f32(dst, sum);
+#endif
+        src += ChannelsIn * 2;
+        dst += 4;
+    }
+    return n;
+}
+
+/// Down to 5.1, a frame at a time, as DownmixStereo(). Returns the frames done.
+template <int ChannelsIn>
+static int Downmix51(float *dst, const float *src, int frames,
+                     const six_speaker_set &matrix)
+{
+    // the ratios of each channel, padded to eight
+    alignas(32) std::array<float,ChannelsIn * 8> ratios {};
+    for (int j = 0; j < ChannelsIn; j++)
+        std::copy(matrix[j].cbegin(), matrix[j].cend(), &ratios[j * 8]);
+
+#ifdef AVX2_KERNELS
+    if (s_haveAVX2)
+        return Downmix51AVX2<ChannelsIn>(dst, src, frames, ratios);
+#endif
+
+    for (int n = 0; n < frames; n++)
+    {
+#ifdef Q_PROCESSOR_X86_64
+        __m128 sum1 = _mm_setzero_ps();
+        __m128 sum2 = _mm_setzero_ps();
+        for (int j = 0; j < ChannelsIn; j++)
+        {
+            __m128 sample = _mm_set1_ps(src[j]);
+            sum1 = _mm_add_ps(sum1, _mm_mul_ps(sample, _mm_load_ps(&ratios[j * 8])));
+            sum2 = _mm_add_ps(sum2, _mm_mul_ps(sample, _mm_load_ps(&ratios[(j * 8) + 4])));
+        }
+        _mm_storeu_ps(dst, sum1);
+        _mm_storel_pi(reinterpret_cast<__m64*>(dst + 4), sum2);
+#else
+        float32x4_t sum1 = vdupq_n_f32(0.0F);
+        float32x2_t sum2 = vdup_n_f32(0.0F);
+        for (int j = 0; j < ChannelsIn; j++)
+        {
+            sum1 = vaddq_f32(sum1, vmulq_n_f32(vld1q_f32(&ratios[j * 8]), src[j]));
+            sum2 = vadd_f32(sum2, vmul_n_f32(vld1_f32(&ratios[(j * 8) + 4]), src[j]));
+        }
+        vst1q_f32(dst, sum1);
+        vst1_f32(dst + 4, sum2);
+#endif
+        src += ChannelsIn;
+        dst += 6;
+    }
+    return frames;
+}
+#endif
+
+template <int ChannelsIn, size_t ChannelsOut>
+static void tDownmix(float *dst, const float *src, int frames,
+                     const std::array<std::array<float,ChannelsOut>,8> &matrix,
+                     [[maybe_unused]] bool useSIMD)
+{
+    int done = 0;
+#if defined(Q_PROCESSOR_X86_64) || HAVE_INTRINSICS_NEON
+    if (useSIMD && s_haveSIMD)
+    {
+        if constexpr (ChannelsOut == 2)
+            done = DownmixStereo<ChannelsIn>(dst, src, frames, matrix);
+        else
+            done = Downmix51<ChannelsIn>(dst, src, frames, matrix);
+    }
+#endif
+    tDownmixFrames<ChannelsIn>(dst + (done * ChannelsOut), src + (done * ChannelsIn),
+                               frames - done, matrix);
+}
+
+/**
+ * Downmix to stereo or 5.1
+ * The mix may be done in place, dst being src. Returns the number of
+ * frames mixed, or -1 if there is no mix for the channels.
+ * useSIMD is for testing the C code on hardware with SIMD.
+ */
+int AudioConvert::DownmixFrames(int channels_in, int channels_out,
+                                float *dst, const float *src, int frames,
+                                bool useSIMD)
+{
+    if (channels_in < channels_out || channels_in > 8)
+        return -1;
+
+    if (channels_out == 2)
+    {
+        const two_speaker_set &matrix = stereo_matrix[channels_in - 1];
+        switch (channels_in)
+        {
+            case 1: tDownmix<1>(dst, src, frames, matrix, useSIMD); break;
+            case 2: tDownmix<2>(dst, src, frames, matrix, useSIMD); break;
+            case 3: tDownmix<3>(dst, src, frames, matrix, useSIMD); break;
+            case 4: tDownmix<4>(dst, src, frames, matrix, useSIMD); break;
+            case 5: tDownmix<5>(dst, src, frames, matrix, useSIMD); break;
+            case 6: tDownmix<6>(dst, src, frames, matrix, useSIMD); break;
+            case 7: tDownmix<7>(dst, src, frames, matrix, useSIMD); break;
+            case 8: tDownmix<8>(dst, src, frames, matrix, useSIMD); break;
+            default: return -1;
+        }
+    }
+    else if (channels_out == 6)
+    {
+        const six_speaker_set &matrix = s51_matrix[channels_in - 6];
+        switch (channels_in)
+        {
+            case 6: tDownmix<6>(dst, src, frames, matrix, useSIMD); break;
+            case 7: tDownmix<7>(dst, src, frames, matrix, useSIMD); break;
+            case 8: tDownmix<8>(dst, src, frames, matrix, useSIMD); break;
+            default: return -1;
+        }
+    }
+    else
+    {
+        return -1;
+    }
+
+    return frames;
+}
+
 void AudioConvert::DeinterleaveSamples(int channels,
                                        uint8_t* output, const uint8_t* input,
                                        int data_size)
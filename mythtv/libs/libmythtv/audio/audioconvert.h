@@ -77,6 +77,9 @@ public:
     static void InterleaveSamples(AudioFormat format, int channels,
                                   uint8_t* output, const uint8_t* input,
                                   int data_size);
+    static int  DownmixFrames(int channels_in, int channels_out,
+                              float* dst, const float* src, int frames,
+                              bool useSIMD = true);
 private:
     AudioConvertInternal* m_ctx {nullptr};
     AudioFormat m_in, m_out;
@@ -41,6 +41,51 @@ static const float center_level = 0.5F*sqrtf(0.5F);
 template <class T>
 T sqr(T x) { return x*x; }
 
+// Taylor series of sin, cos and asin, to stand in for the libm functions in
+// the steering, which is evaluated for every bin of every block.
+static constexpr std::array<double,7> kSinTerms {
+    1.0, -1.0/6, 1.0/120, -1.0/5040, 1.0/362880, -1.0/39916800, 1.0/6227020800 };
+static constexpr std::array<double,8> kCosTerms {
+    1.0, -1.0/2, 1.0/24, -1.0/720, 1.0/40320, -1.0/3628800, 1.0/479001600,
+    -1.0/87178291200 };
+// (2k)! / (4^k (k!)^2 (2k+1))
+static constexpr std::array<double,16> kAsinTerms {
+    1.0, 0.16666666666666666, 0.075, 0.044642857142857144,
+    0.030381944444444444, 0.022372159090909092, 0.017352764423076924,
+    0.01396484375, 0.011551800896139705, 0.009761609529194078,
+    0.008390335809616815, 0.0073125258735988454, 0.006447210311889649,
+    0.005740037670841924, 0.005153309682319905, 0.004660143486915096 };
+
+template <size_t N>
+static double poly(const std::array<double,N> &terms, double x)
+{
+    double result = terms[N - 1];
+    for (size_t i = N - 1; i-- > 0; )
+        result = (result * x) + terms[i];
+    return result;
+}
+
+// sin and cos of |x| <= 1.1, to within 3e-12
+static void sin_cos(double x, double &sinX, double &cosX)
+{
+    double x2 = x * x;
+    sinX = x * poly(kSinTerms, x2);
+    cosX = poly(kCosTerms, x2);
+}
+
+// asin of |x| <= 1, to within 2e-12. Past 0.5 the series converges too
+// slowly, so use asin(x) = pi/2 - 2 asin(sqrt((1 - x) / 2)) instead.
+static double fast_asin(double x)
+{
+    double z = std::abs(x);
+    bool outer = z > 0.5;
+    double w = outer ? std::sqrt((1 - z) / 2) : z;
+    double result = w * poly(kAsinTerms, w * w);
+    if (outer)
+        result = (std::numbers::pi / 2) - (2 * result);
+    return std::copysign(result, x);
+}
+
 // private implementation of the surround decoder
 class fsurround_decoder::Impl {
 public:
@@ -49,15 +94,20 @@ public:
     explicit Impl(unsigned blocksize=8192)
       : m_n(blocksize),
         m_halfN(blocksize/2),
-        // create lavc fft buffers
-        m_dftL((AVComplexFloat*)av_malloc(sizeof(AVComplexFloat) * m_n * 2)),
-        m_dftR((AVComplexFloat*)av_malloc(sizeof(AVComplexFloat) * m_n * 2)),
-        m_src ((AVComplexFloat*)av_malloc(sizeof(AVComplexFloat) * m_n * 2))
+        // create lavc fft buffers, only the non-redundant half of the
+        // spectrum of a real signal is stored
+        m_dftL((AVComplexFloat*)av_malloc(sizeof(AVComplexFloat) * (m_halfN + 1))),
+        m_dftR((AVComplexFloat*)av_malloc(sizeof(AVComplexFloat) * (m_halfN + 1))),
+        m_src ((AVComplexFloat*)av_malloc(sizeof(AVComplexFloat) * (m_halfN + 1))),
+        m_time((float*)av_malloc(sizeof(float) * (m_n + 2)))
     {
         // If av_tx_init() fails (returns < 0), the contexts will be nullptr and will crash later,
         // but av_malloc() is not checked to succeed either.
-        av_tx_init(&m_fftContext , &m_fft , AV_TX_FLOAT_FFT, 0, m_n, &kScale, AV_TX_INPLACE);
-        av_tx_init(&m_ifftContext, &m_ifft, AV_TX_FLOAT_FFT, 1, m_n, &kScale, AV_TX_INPLACE);
+        // Both the input and the output are real, so use real<->complex
+        // transforms; they are about twice as fast as the complex ones and
+        // do away with rebuilding the conjugate symmetric half spectrum.
+        av_tx_init(&m_fftContext , &m_fft , AV_TX_FLOAT_RDFT, 0, m_n, &kScale, 0);
+        av_tx_init(&m_ifftContext, &m_ifft, AV_TX_FLOAT_RDFT, 1, m_n, &kScale, 0);
         // resize our own buffers
         m_frontR.resize(m_n);
         m_frontL.resize(m_n);
@@ -93,6 +143,7 @@ public:
     ~Impl() {
         av_tx_uninit(&m_fftContext);
         av_tx_uninit(&m_ifftContext);
+        av_free(m_time);
         av_free(m_src);
         av_free(m_dftR);
         av_free(m_dftL);
@@ -175,6 +226,8 @@ public:
         const std::array<std::array<float,2>,4> modes {{ {0,0}, {0,PI}, {PI,0}, {-PI/2,PI/2} }};
         m_phaseOffsetL = modes[mode][0];
         m_phaseOffsetR = modes[mode][1];
+        m_phaseRotL = std::polar(1.0F, m_phaseOffsetL);
+        m_phaseRotR = std::polar(1.0F, m_phaseOffsetR);
     }
 
     // what steering mode should be chosen
@@ -187,10 +240,16 @@ public:
     }
 
 private:
-    // polar <-> cartesian coodinates conversion
-    static cfloat polar(float a, float p) { return {a*std::cos(p), a*std::sin(p)}; }
-    static float amplitude(AVComplexFloat z) { return std::hypot(z.re, z.im); }
-    static float phase(AVComplexFloat z) { return std::atan2(z.im, z.re); }
+    static float amplitude(AVComplexFloat z) { return std::sqrt((z.re * z.re) + (z.im * z.im)); }
+
+    /// Unit vector with the phase of z. Equivalent to polar(1, atan2(z)),
+    /// including a phase of 0 for silent bins, without the trig.
+    static cfloat unit_phasor(AVComplexFloat z, float amp)
+    {
+        if (amp <= 0.0F)
+            return {1.0F, 0.0F};
+        return {z.re / amp, z.im / amp};
+    }
 
     /// Clamp the input to the interval [-1, 1], i.e. clamp the magnitude to the unit interval [0, 1]
     static float clamp_unit_mag(float x) { return std::clamp(x, -1.0F, 1.0F); }
@@ -212,36 +271,33 @@ private:
         // concatenate copies of input1 and input2 for some undetermined reason
         // input1 is in the rising half of the window
         // input2 is in the falling half of the window
-        for (unsigned k = 0; k < m_halfN; k++)
+        // ... and tranform it into the frequency domain
+        for (unsigned c = 0; c < 2; c++)
         {
-            m_dftL[k]           = (AVComplexFloat){ .re = input1[0][k] * m_wnd[k], .im = 0 };
-            m_dftR[k]           = (AVComplexFloat){ .re = input1[1][k] * m_wnd[k], .im = 0 };
-
-            m_dftL[k + m_halfN] = (AVComplexFloat){ .re = input2[0][k] * m_wnd[k + m_halfN], .im = 0 };
-            m_dftR[k + m_halfN] = (AVComplexFloat){ .re = input2[1][k] * m_wnd[k + m_halfN], .im = 0 };
+            for (unsigned k = 0; k < m_halfN; k++)
+            {
+                m_time[k]           = input1[c][k] * m_wnd[k];
+                m_time[k + m_halfN] = input2[c][k] * m_wnd[k + m_halfN];
+            }
+            m_fft(m_fftContext, (c == 0) ? m_dftL : m_dftR, m_time, sizeof(float));
         }
 
-        // ... and tranform it into the frequency domain
-        m_fft(m_fftContext, m_dftL, m_dftL, sizeof(AVComplexFloat));
-        m_fft(m_fftContext, m_dftR, m_dftR, sizeof(AVComplexFloat));
-
         // 2. compare amplitude and phase of each DFT bin and produce the X/Y coordinates in the sound field
         //    but dont do DC or N/2 component
         for (unsigned f=0;f<m_halfN;f++) {
-            // get left/right amplitudes/phases
-            float ampL = amplitude(m_dftL[f]);
-            float ampR = amplitude(m_dftR[f]);
-            float phaseL = phase(m_dftL[f]);
-            float phaseR = phase(m_dftR[f]);
-//          if (ampL+ampR < epsilon)
-//              continue;       
+            // get left/right amplitudes
+            AVComplexFloat dftL = m_dftL[f];
+            AVComplexFloat dftR = m_dftR[f];
+            float ampL = amplitude(dftL);
+            float ampR = amplitude(dftR);
+            float ampSum = ampL + ampR;
 
             // calculate the amplitude/phase difference
-            float ampDiff = clamp_unit_mag((ampL+ampR < epsilon) ? 0 : (ampR-ampL) / (ampR+ampL));
-            float phaseDiff = phaseL - phaseR;
-            if (phaseDiff < -PI) phaseDiff += 2*PI;
-            if (phaseDiff > PI) phaseDiff -= 2*PI;
-            phaseDiff = std::abs(phaseDiff);
+            // arg(L * conj(R)) is the phase difference already wrapped to
+            // [-PI,PI], so only one atan2 per bin is needed
+            float ampDiff = clamp_unit_mag((ampSum < epsilon) ? 0 : (ampR-ampL) / ampSum);
+            float phaseDiff = std::abs(std::atan2((dftL.im * dftR.re) - (dftL.re * dftR.im),
+                                                  (dftL.re * dftR.re) + (dftL.im * dftR.im)));
 
             if (m_linearSteering) {
                 // --- this is the fancy new linear mode ---
@@ -317,12 +373,13 @@ private:
             }
 
             // ... and build the signal which we want to position
-            m_frontL[f] = polar(ampL+ampR,phaseL);
-            m_frontR[f] = polar(ampL+ampR,phaseR);
+            // (the surround phase offsets are constant rotations)
+            m_frontL[f] = unit_phasor(dftL, ampL) * ampSum;
+            m_frontR[f] = unit_phasor(dftR, ampR) * ampSum;
             m_avg[f] = m_frontL[f] + m_frontR[f];
-            m_surL[f] = polar(ampL+ampR,phaseL+m_phaseOffsetL);
-            m_surR[f] = polar(ampL+ampR,phaseR+m_phaseOffsetR);
-            m_trueavg[f] = cfloat(m_dftL[f].re + m_dftR[f].re, m_dftL[f].im + m_dftR[f].im);
+            m_surL[f] = m_frontL[f] * m_phaseRotL;
+            m_surR[f] = m_frontR[f] * m_phaseRotR;
+            m_trueavg[f] = cfloat(dftL.re + dftR.re, dftL.im + dftR.im);
         }
 
         // 4. distribute the unfiltered reference signals over the channels
@@ -334,30 +391,32 @@ private:
         apply_filter((m_trueavg).data(),m_filter[5].data(),&output[5][0]);  // lfe
     }
 
-#define FASTER_CALC
     // map from amplitude difference and phase difference to yfs
     static double get_yfs(double ampDiff, double phaseDiff) {
         double x = 1-(((1-sqr(ampDiff))*phaseDiff)/M_PI*2);
-#ifdef FASTER_CALC
-        double tanX = tan(x);
+        double sinX = 0;
+        double cosX = 0;
+        sin_cos(x, sinX, cosX);
+        double tanX = sinX / cosX;
         return 0.16468622925824683 + (0.5009268347818189*x) - (0.06462757726992101*x*x)
             + (0.09170680403453149*x*x*x) + (0.2617754892323973*tanX) - (0.04180413533856156*sqr(tanX));
-#else
-        return 0.16468622925824683 + (0.5009268347818189*x) - (0.06462757726992101*x*x)
-            + (0.09170680403453149*x*x*x) + (0.2617754892323973*tan(x)) - (0.04180413533856156*sqr(tan(x)));
-#endif
     }
 
     // map from amplitude difference and yfs to xfs
+    //  The fit is a small difference of terms in the thousands, so the
+    //  approximations of the trig functions have to be good to about 1e-11.
     static double get_xfs(double ampDiff, double yfs) {
         double x=ampDiff;
         double y=yfs;
-#ifdef FASTER_CALC
-        double tanX = tan(x);
-        double tanY = tan(y);
-        double asinX = asin(x);
-        double sinX = sin(x);
-        double sinY = sin(y);
+        double sinX = 0;
+        double cosX = 0;
+        double sinY = 0;
+        double cosY = 0;
+        sin_cos(x, sinX, cosX);
+        sin_cos(y, sinY, cosY);
+        double tanX = sinX / cosX;
+        double tanY = sinY / cosY;
+        double asinX = fast_asin(x);
         double x3 = x*x*x;
         double y2 = y*y;
         double y3 = y*y2;
@@ -370,17 +429,6 @@ private:
             (1288.6463247741938*y2*tanX) + (1384.372969378453*y3*tanX) +
             (12699.231471126128*sinY*tanX) + (95.37131275594336*sinX*tanY) -
             (91.21223198407546*tanX*tanY);
-#else
-        return (2.464833559224702*x) - (423.52131153259404*x*y) +
-            (67.8557858606918*x*x*x*y) + (788.2429425544392*x*y*y) -
-            (79.97650354902909*x*x*x*y*y) - (513.8966153850349*x*y*y*y) +
-            (35.68117670186306*x*x*x*y*y*y) + (13867.406173420834*y*asin(x)) -
-            (2075.8237075786396*y*y*asin(x)) - (908.2722068360281*y*y*y*asin(x)) -
-            (12934.654772878019*asin(x)*sin(y)) - (13216.736529661162*y*tan(x)) +
-            (1288.6463247741938*y*y*tan(x)) + (1384.372969378453*y*y*y*tan(x)) +
-            (12699.231471126128*sin(y)*tan(x)) + (95.37131275594336*sin(x)*tan(y)) -
-            (91.21223198407546*tan(x)*tan(y));
-#endif
     }
 
     /**
@@ -399,21 +447,17 @@ private:
             m_src[f].re = signal[f].real() * flt[f];
             m_src[f].im = signal[f].imag() * flt[f];
         }
-        // enforce odd symmetry
-        for (unsigned f = 1; f < m_halfN; f++)
-        {
-            m_src[m_n - f].re =  m_src[f].re;
-            m_src[m_n - f].im = -m_src[f].im;   // complex conjugate
-        }
-        m_ifft(m_ifftContext, m_src, m_src, sizeof(AVComplexFloat));
+        // the complex to real transform implies the conjugate symmetric
+        // upper half of the spectrum (and overwrites m_src)
+        m_ifft(m_ifftContext, m_time, m_src, sizeof(AVComplexFloat));
 
         // add the result to target, windowed
         for (unsigned int k = 0; k < m_halfN; k++)
         {
             // 1st part is overlap add
-            target[(m_currentBuf * m_halfN) + k]      += m_src[k].re * m_wnd[k];
+            target[(m_currentBuf * m_halfN) + k]      += m_time[k] * m_wnd[k];
             // 2nd part is set as has no history
-            target[((m_currentBuf ^ 1) * m_halfN) + k] = m_src[m_halfN + k].re * m_wnd[m_halfN + k];
+            target[((m_currentBuf ^ 1) * m_halfN) + k] = m_time[m_halfN + k] * m_wnd[m_halfN + k];
         }
     }
 
@@ -424,10 +468,11 @@ private:
     av_tx_fn     m_fft         {nullptr};
     AVTXContext *m_ifftContext {nullptr};
     av_tx_fn     m_ifft        {nullptr};
-    // FFTs are computed in-place in these buffers on copies of the input
+    // half spectra (m_halfN + 1 bins) of the windowed input
     AVComplexFloat *m_dftL {nullptr};
     AVComplexFloat *m_dftR {nullptr};
     AVComplexFloat *m_src  {nullptr}; ///< Used only in apply_filter
+    float          *m_time {nullptr}; ///< Real FFT input/inverse FFT output
     // buffers
     std::vector<cfloat> m_frontL,m_frontR,m_avg,m_surL,m_surR; // the signal (phase-corrected) in the frequency domain
     std::vector<cfloat> m_trueavg;       // for lfe generation
@@ -443,6 +488,8 @@ private:
     float m_surroundLevel   {0.0F};      // gain for the surround channels (follows from the coeffs
     float m_phaseOffsetL    {0.0F};      // phase shifts to be applied to the rear channels
     float m_phaseOffsetR    {0.0F};      // phase shifts to be applied to the rear channels
+    cfloat m_phaseRotL      {1.0F};      // the phase shifts as unit rotations
+    cfloat m_phaseRotR      {1.0F};
     float m_frontSeparation {0.0F};      // front stereo separation
     float m_rearSeparation  {0.0F};      // rear stereo separation
     bool  m_linearSteering  {false};     // whether the steering should be linear or not
@@ -19,8 +19,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #ifndef FREESURROUND_DECODER_H
 #define FREESURROUND_DECODER_H
 
+#include "libmythtv/mythtvexp.h"
+
 // the Free Surround decoder
-class fsurround_decoder {
+class MTV_PUBLIC fsurround_decoder {
 public:
     // create an instance of the decoder
     //  blocksize is fixed over the lifetime of this object for performance reasons
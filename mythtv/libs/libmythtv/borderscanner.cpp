@@ -0,0 +1,276 @@
+// C++ headers
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+// Qt headers
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6,5,0)
+#include <QtProcessorDetection>
+#endif
+
+// MythTV headers
+#include "libmythbase/mythconfig.h"
+
+#include "borderscanner.h"
+#include "mythframe.h"
+
+#ifdef Q_PROCESSOR_X86_64
+#   include <emmintrin.h>
+#elif HAVE_INTRINSICS_NEON
+#   include <arm_neon.h>
+#endif
+
+double BorderLineStats::Mean(void) const
+{
+    return (m_count > 0) ? static_cast<double>(m_sum) / m_count : 0.0;
+}
+
+double BorderLineStats::Variance(void) const
+{
+    if (m_count < 1)
+        return 0.0;
+    double mean = Mean();
+    return std::max(0.0, (static_cast<double>(m_sumSq) / m_count) - (mean * mean));
+}
+
+/// Minimum, maximum, sum and sum of squares of Count samples.
+BorderLineStats BorderScanner::LineStats(const uint8_t *Data, int Count)
+{
+    BorderLineStats stats;
+    stats.m_count = std::max(0, Count);
+    int index = 0;
+
+#if defined(Q_PROCESSOR_X86_64) || HAVE_INTRINSICS_NEON
+    // The 32 bit square sums can take 4096 blocks of 16 before they wrap
+    static constexpr int kBlock = 4096 * 16;
+    std::array<uint8_t,16>  mins {};
+    std::array<uint8_t,16>  maxs {};
+    std::array<uint32_t,4>  squares {};
+    int simd = Count & ~15;
+    if (simd > 0)
+    {
+#ifdef Q_PROCESSOR_X86_64
+        __m128i zero = _mm_setzero_si128();
+        __m128i vmin = _mm_set1_epi8(static_cast<char>(UINT8_MAX));
+        __m128i vmax = zero;
+        for (int block = 0; block < simd; block += kBlock)
+        {
+            __m128i vsum = zero;
+            __m128i vsq  = zero;
+            int end = std::min(simd, block + kBlock);
+            for (index = block; index < end; index += 16)
+            {
+                __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Data + index));
+                vmin = _mm_min_epu8(vmin, data);
+                vmax = _mm_max_epu8(vmax, data);
+                vsum = _mm_add_epi64(vsum, _mm_sad_epu8(data, zero));
+                __m128i low  = _mm_unpacklo_epi8(data, zero);
+                __m128i high = _mm_unpackhi_epi8(data, zero);
+                vsq = _mm_add_epi32(vsq, _mm_add_epi32(_mm_madd_epi16(low, low), _mm_madd_epi16(high, high)));
+            }
+            std::array<uint64_t,2> sum64 {};
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sum64.data()), vsum);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(squares.data()), vsq);
+            stats.m_sum += sum64[0] + sum64[1];
+            for (auto square : squares)
+                stats.m_sumSq += square;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(mins.data()), vmin);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(maxs.data()), vmax);
+#endif
+#if HAVE_INTRINSICS_NEON
+        uint8x16_t vmin = vdupq_n_u8(UINT8_MAX);
+        uint8x16_t vmax = vdupq_n_u8(0);
+        std::array<uint32_t,4> sums {};
+        for (int block = 0; block < simd; block += kBlock)
+        {
+            uint32x4_t vsum = vdupq_n_u32(0);
+            uint32x4_t vsq  = vdupq_n_u32(0);
+            int end = std::min(simd, block + kBlock);
+            for (index = block; index < end; index += 16)
+            {
+                uint8x16_t data = vld1q_u8(Data + index);
+                vmin = vminq_u8(vmin, data);
+                vmax = vmaxq_u8(vmax, data);
+                vsum = vpadalq_u16(vsum, vpaddlq_u8(data));
+                vsq  = vpadalq_u16(vsq, vmull_u8(vget_low_u8(data), vget_low_u8(data)));
+                vsq  = vpadalq_u16(vsq, vmull_u8(vget_high_u8(data), vget_high_u8(data)));
+            }
+            vst1q_u32(sums.data(), vsum);
+            vst1q_u32(squares.data(), vsq);
+            for (size_t i = 0; i < sums.size(); ++i)
+            {
+                stats.m_sum   += sums[i];
+                stats.m_sumSq += squares[i];
+            }
+        }
+        vst1q_u8(mins.data(), vmin);
+        vst1q_u8(maxs.data(), vmax);
+#endif
+        stats.m_min = *std::min_element(mins.cbegin(), mins.cend());
+        stats.m_max = *std::max_element(maxs.cbegin(), maxs.cend());
+        index = simd;
+    }
+#endif
+
+    for ( ; index < Count; ++index)
+    {
+        int value = Data[index];
+        stats.m_min    = std::min(stats.m_min, value);
+        stats.m_max    = std::max(stats.m_max, value);
+        stats.m_sum   += static_cast<uint64_t>(value);
+        stats.m_sumSq += static_cast<uint64_t>(value * value);
+    }
+    return stats;
+}
+
+/// Minimum and maximum of each of Columns columns over Rows rows.
+void BorderScanner::ColumnMinMax(const uint8_t *Data, int Pitch, int Rows, int Columns,
+                                 uint8_t *Min, uint8_t *Max)
+{
+    int column = 0;
+#if defined(Q_PROCESSOR_X86_64) || HAVE_INTRINSICS_NEON
+    for ( ; column + 16 <= Columns; column += 16)
+    {
+        const uint8_t *data = Data + column;
+#ifdef Q_PROCESSOR_X86_64
+        __m128i vmin = _mm_set1_epi8(static_cast<char>(UINT8_MAX));
+        __m128i vmax = _mm_setzero_si128();
+        for (int row = 0; row < Rows; ++row, data += Pitch)
+        {
+            __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+            vmin = _mm_min_epu8(vmin, value);
+            vmax = _mm_max_epu8(vmax, value);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Min + column), vmin);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Max + column), vmax);
+#endif
+#if HAVE_INTRINSICS_NEON
+        uint8x16_t vmin = vdupq_n_u8(UINT8_MAX);
+        uint8x16_t vmax = vdupq_n_u8(0);
+        for (int row = 0; row < Rows; ++row, data += Pitch)
+        {
+            uint8x16_t value = vld1q_u8(data);
+            vmin = vminq_u8(vmin, value);
+            vmax = vmaxq_u8(vmax, value);
+        }
+        vst1q_u8(Min + column, vmin);
+        vst1q_u8(Max + column, vmax);
+#endif
+    }
+#endif
+
+    for ( ; column < Columns; ++column)
+    {
+        uint8_t minval = UINT8_MAX;
+        uint8_t maxval = 0;
+        const uint8_t *data = Data + column;
+        for (int row = 0; row < Rows; ++row, data += Pitch)
+        {
+            minval = std::min(minval, *data);
+            maxval = std::max(maxval, *data);
+        }
+        Min[column] = minval;
+        Max[column] = maxval;
+    }
+}
+
+/// Copy the luma lines FindLetterbox looks at, as 8 bit samples.
+BorderSample BorderScanner::Sample(const MythVideoFrame *Frame)
+{
+    BorderSample sample;
+    if (!Frame || !Frame->m_buffer || (Frame->m_width < 16) || (Frame->m_height < 16))
+        return sample;
+
+    VideoFrameType type = Frame->m_type;
+    if (!(MythVideoFrame::FormatIs420(type) || MythVideoFrame::FormatIs422(type) ||
+          MythVideoFrame::FormatIs444(type) || MythVideoFrame::FormatIsNV12(type)))
+        return sample;
+
+    // P010 and P016 keep their samples in the high bits
+    int depth = MythVideoFrame::ColorDepth(type);
+    int shift = 0;
+    if (depth > 8)
+        shift = MythVideoFrame::FormatIsNV12(type) ? 8 : depth - 8;
+
+    int first = Frame->m_width / 5;
+    int quarter = Frame->m_height / 4;
+    sample.m_frameWidth  = Frame->m_width;
+    sample.m_frameHeight = Frame->m_height;
+    sample.m_width       = Frame->m_width - (2 * first);
+    for (int row = kEdgeRows; row < quarter; row += kRowStep)
+        sample.m_rows.push_back(row);
+    sample.m_topLines = static_cast<int>(sample.m_rows.size());
+    for (int row = Frame->m_height - 1 - kEdgeRows; row >= Frame->m_height - quarter; row -= kRowStep)
+        sample.m_rows.push_back(row);
+    sample.m_data.resize(sample.m_rows.size() * static_cast<size_t>(sample.m_width));
+
+    const uint8_t *luma = Frame->m_buffer + Frame->m_offsets[0];
+    auto *dest = sample.m_data.data();
+    for (int row : sample.m_rows)
+    {
+        const uint8_t *source = luma + (row * static_cast<ptrdiff_t>(Frame->m_pitches[0]));
+        if (shift)
+        {
+            const auto *source16 = reinterpret_cast<const uint16_t*>(source) + first;
+            for (int i = 0; i < sample.m_width; ++i)
+                dest[i] = static_cast<uint8_t>(source16[i] >> shift);
+        }
+        else
+        {
+            memcpy(dest, source + first, static_cast<size_t>(sample.m_width));
+        }
+        dest += sample.m_width;
+    }
+    return sample;
+}
+
+/// How many of the Count lines from First are bar.
+int BorderScanner::BarLines(const BorderSample &Sample, int First, int Count)
+{
+    double bar = 0.0;
+    for (int line = 0; line < Count; ++line)
+    {
+        BorderLineStats stats = LineStats(Sample.Line(static_cast<size_t>(First + line)), Sample.m_width);
+        if ((stats.Range() > kMaxRange) || (stats.Variance() > kMaxVariance))
+            return line;
+        double mean = stats.Mean();
+        if (line == 0)
+        {
+            if (mean > kMaxBarLuma)
+                return 0;
+            bar = mean;
+        }
+        else if (std::abs(mean - bar) > kMaxRange / 2.0)
+        {
+            return line;
+        }
+    }
+    return Count;
+}
+
+BorderScanResult BorderScanner::FindLetterbox(const BorderSample &Sample)
+{
+    BorderScanResult result;
+    if (!Sample.IsValid())
+        return result;
+
+    int toplines    = Sample.m_topLines;
+    int bottomlines = static_cast<int>(Sample.m_rows.size()) - toplines;
+    int top         = BarLines(Sample, 0, toplines);
+    int bottom      = BarLines(Sample, toplines, bottomlines);
+
+    // A black (or any flat) frame is no evidence either way
+    if ((top == toplines) && (bottom == bottomlines))
+        return result;
+
+    // Count up to the last line that was bar, the bar may end anywhere
+    // before the next sampled line
+    result.m_valid  = true;
+    result.m_top    = (top > 0) ? Sample.m_rows[static_cast<size_t>(top - 1)] + 1 : 0;
+    result.m_bottom = (bottom > 0) ?
+        Sample.m_frameHeight - Sample.m_rows[static_cast<size_t>(toplines + bottom - 1)] : 0;
+    return result;
+}
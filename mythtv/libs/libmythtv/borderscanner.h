@@ -0,0 +1,83 @@
+// -*- Mode: c++ -*-
+#ifndef BORDER_SCANNER_H
+#define BORDER_SCANNER_H
+
+// C++ headers
+#include <cstdint>
+#include <vector>
+
+// MythTV headers
+#include "mythtvexp.h"
+
+class MythVideoFrame;
+
+/// Statistics of a run of 8 bit luma samples.
+struct BorderLineStats
+{
+    int      m_min   { UINT8_MAX };
+    int      m_max   { 0 };
+    int      m_count { 0 };
+    uint64_t m_sum   { 0 };
+    uint64_t m_sumSq { 0 };
+
+    int    Range(void) const { return (m_count > 0) ? m_max - m_min : 0; }
+    double Mean(void) const;
+    double Variance(void) const;
+};
+
+/// Lines of 8 bit luma copied from the top and bottom quarters of a frame,
+/// top lines first working down, then bottom lines working up.
+struct BorderSample
+{
+    int                  m_frameWidth  { 0 };
+    int                  m_frameHeight { 0 };
+    int                  m_width       { 0 }; ///< samples in each line
+    int                  m_topLines    { 0 };
+    std::vector<int>     m_rows;              ///< frame row of each line
+    std::vector<uint8_t> m_data;
+
+    bool IsValid(void) const { return !m_rows.empty(); }
+    const uint8_t* Line(size_t Index) const { return m_data.data() + (Index * static_cast<size_t>(m_width)); }
+};
+
+/// Rows of uniform dark bar at the top and bottom of a frame.
+struct BorderScanResult
+{
+    bool m_valid  { false }; ///< false if the frame was all bar, or not sampled
+    int  m_top    { 0 };
+    int  m_bottom { 0 };
+};
+
+/** \class BorderScanner
+ *  \brief Finds the bars around the picture from sparse luma samples.
+ *
+ *  Sample() copies every kRowStep'th row of the top and bottom quarters of
+ *  a frame, limited to the middle of the picture where channel logos and
+ *  pillarbox edges don't reach, so FindLetterbox() can run on any thread
+ *  once the frame is gone. A line is part of a bar while its samples are
+ *  within kMaxRange and kMaxVariance of each other and of the first line.
+ *
+ *  LineStats() and ColumnMinMax() are the SSE2 and NEON kernels under it,
+ *  public for detectors with rules of their own.
+ */
+class MTV_PUBLIC BorderScanner
+{
+  public:
+    static constexpr int    kRowStep     { 4 };
+    static constexpr int    kEdgeRows    { 4 };    ///< skipped, they may be noisy
+    static constexpr int    kMaxRange    { 24 };
+    static constexpr double kMaxVariance { 16.0 };
+    static constexpr int    kMaxBarLuma  { 64 };   ///< brightest a bar may be
+
+    static BorderLineStats LineStats(const uint8_t *Data, int Count);
+    static void ColumnMinMax(const uint8_t *Data, int Pitch, int Rows, int Columns,
+                             uint8_t *Min, uint8_t *Max);
+
+    static BorderSample     Sample(const MythVideoFrame *Frame);
+    static BorderScanResult FindLetterbox(const BorderSample &Sample);
+
+  private:
+    static int BarLines(const BorderSample &Sample, int First, int Count);
+};
+
+#endif // BORDER_SCANNER_H
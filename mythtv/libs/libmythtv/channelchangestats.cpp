@@ -0,0 +1,51 @@
+// C++ headers
+#include <algorithm>
+
+// Qt headers
+#include <QStringList>
+
+// MythTV headers
+#include "channelchangestats.h"
+
+void ChannelChangeStats::Add(std::chrono::milliseconds elapsed, bool standby)
+{
+    // The first bucket whose limit isn't below the time taken
+    auto limit = std::ranges::lower_bound(kLimits, elapsed);
+    m_buckets[std::distance(kLimits.begin(), limit)]++;
+
+    m_count++;
+    m_total += elapsed;
+    m_max = std::max(m_max, elapsed);
+    if (standby)
+    {
+        m_standbyCount++;
+        m_standbyTotal += elapsed;
+    }
+}
+
+std::chrono::milliseconds ChannelChangeStats::GetAverage(void) const
+{
+    return m_count ? m_total / m_count : std::chrono::milliseconds(0);
+}
+
+std::chrono::milliseconds ChannelChangeStats::GetStandbyAverage(void) const
+{
+    return m_standbyCount ? m_standbyTotal / m_standbyCount
+                          : std::chrono::milliseconds(0);
+}
+
+/// Returns the histogram as "<=250ms:3 <=500ms:7 ... >16000ms:0".
+QString ChannelChangeStats::toString(void) const
+{
+    QStringList buckets;
+    for (size_t i = 0; i < kLimits.size(); ++i)
+        buckets << QString("<=%1ms:%2").arg(kLimits[i].count()).arg(m_buckets[i]);
+    buckets << QString(">%1ms:%2").arg(kLimits.back().count())
+        .arg(m_buckets.back());
+
+    return QString("%1 changes, avg %2ms (%3 from standby, avg %4ms), "
+                   "max %5ms: %6")
+        .arg(m_count).arg(GetAverage().count())
+        .arg(m_standbyCount).arg(GetStandbyAverage().count())
+        .arg(m_max.count()).arg(buckets.join(' '));
+}
@@ -0,0 +1,57 @@
+// -*- Mode: c++ -*-
+#ifndef CHANNEL_CHANGE_STATS_H
+#define CHANNEL_CHANGE_STATS_H
+
+// C++ headers
+#include <array>
+#include <chrono>
+
+// Qt headers
+#include <QString>
+
+// MythTV headers
+#include "mythtvexp.h"
+
+/** \class ChannelChangeStats
+ *  \brief Histogram of the time a recorder took to change channel in LiveTV.
+ *
+ *  A channel change is timed from the moment TVRec starts handling the
+ *  tuning request to the moment the recorder is writing the new channel.
+ *  Changes to a channel an input was holding in standby are counted
+ *  separately, so the effect of the standby inputs can be seen.
+ */
+class MTV_PUBLIC ChannelChangeStats
+{
+  public:
+    static constexpr size_t kBuckets { 8 };
+    /// Upper limits of all but the last bucket, the last one has no limit.
+    static constexpr std::array<std::chrono::milliseconds, kBuckets - 1> kLimits
+    {
+        std::chrono::milliseconds(250),  std::chrono::milliseconds(500),
+        std::chrono::milliseconds(1000), std::chrono::milliseconds(2000),
+        std::chrono::milliseconds(4000), std::chrono::milliseconds(8000),
+        std::chrono::milliseconds(16000)
+    };
+    using Buckets = std::array<uint, kBuckets>;
+
+    void Add(std::chrono::milliseconds elapsed, bool standby);
+
+    uint GetCount(void) const { return m_count; }
+    uint GetStandbyCount(void) const { return m_standbyCount; }
+    std::chrono::milliseconds GetAverage(void) const;
+    std::chrono::milliseconds GetStandbyAverage(void) const;
+    std::chrono::milliseconds GetMax(void) const { return m_max; }
+    const Buckets &GetBuckets(void) const { return m_buckets; }
+
+    QString toString(void) const;
+
+  private:
+    Buckets                   m_buckets      {};
+    uint                      m_count        {0};
+    uint                      m_standbyCount {0};
+    std::chrono::milliseconds m_total        {0};
+    std::chrono::milliseconds m_standbyTotal {0};
+    std::chrono::milliseconds m_max          {0};
+};
+
+#endif // CHANNEL_CHANGE_STATS_H
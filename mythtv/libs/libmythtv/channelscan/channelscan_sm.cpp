@@ -29,6 +29,7 @@
 
 // C++ includes
 #include <algorithm>
+#include <iterator>
 #include <thread>
 #include <utility>
 
@@ -224,6 +225,10 @@ ChannelScanSM::~ChannelScanSM(void)
     StopScanner();
     LOG(VB_CHANSCAN, LOG_INFO, LOC + "ChannelScanSM Stopped");
 
+    for (auto *helper : m_helpers)
+        delete helper;
+    m_helpers.clear();
+
     ScanStreamData *sd = nullptr;
     if (GetDTVSignalMonitor())
     {
@@ -1154,6 +1159,11 @@ bool ChannelScanSM::UpdateChannelInfo(bool wait_until_complete)
         if (m_scanning)
         {
             ++m_transportsScanned;
+            if (m_coordinator)
+            {
+                QMutexLocker share(&m_coordinator->m_shareLock);
+                ++m_coordinator->m_shareScanned;
+            }
             UpdateScanPercentCompleted();
             m_waitingForTables = false;
             m_nextIt = m_current.nextTransport();
@@ -1924,6 +1934,13 @@ ScanDTVTransportList ChannelScanSM::GetChannelList(bool addFullTS) const
         }
     }
 
+    // The transports found on the other inputs go to the same import
+    for (const auto *helper : m_helpers)
+    {
+        ScanDTVTransportList found = helper->GetChannelList(addFullTS);
+        list.insert(list.end(), found.begin(), found.end());
+    }
+
     return list;
 }
 
@@ -2009,6 +2026,130 @@ void ChannelScanSM::StartScanner(void)
     m_threadExit = false;
     m_scannerThread = new MThread("Scanner", this);
     m_scannerThread->start();
+
+    for (auto *helper : m_helpers)
+        helper->StartScanner();
+}
+
+/** \fn ChannelScanSM::AddHelper(ChannelScanSM*)
+ *  \brief Scans the transport list on another input of the same source too.
+ *
+ *   The helper is started, stopped and deleted with this scanner. When a
+ *   transport list scan starts the list is moved to a shared list, from
+ *   which every scanner takes the next transport once it is done with its
+ *   current one, so each input tunes a different transport at the same
+ *   time. Only this scanner reports the progress and the end of the scan,
+ *   and GetChannelList() returns the channels found by all of them.
+ */
+void ChannelScanSM::AddHelper(ChannelScanSM *helper)
+{
+    helper->m_coordinator = this;
+    m_coordinator = this;
+    m_helpers.push_back(helper);
+}
+
+/** \fn ChannelScanSM::ShareTransports(void)
+ *  \brief Moves the transport list to the shared list and starts the helpers.
+ */
+void ChannelScanSM::ShareTransports(void)
+{
+    int total = 0;
+    {
+        QMutexLocker share(&m_shareLock);
+        m_sharePending.clear();
+        m_sharePending.splice(m_sharePending.end(), m_scanTransports);
+        m_shareSeen.clear();
+        m_shareBusy    = static_cast<int>(m_helpers.size()) + 1;
+        m_shareScanned = 0;
+        m_shareTotal   = total = static_cast<int>(m_sharePending.size());
+    }
+    m_current = m_nextIt = m_scanTransports.end();
+    m_shareIdle = false;
+
+    LOG(VB_CHANSCAN, LOG_INFO, LOC +
+        QString("Scanning %1 transports on %2 inputs")
+            .arg(total).arg(m_helpers.size() + 1));
+
+    for (auto *helper : m_helpers)
+    {
+        QMutexLocker locker(&helper->m_lock);
+        helper->m_channelList.clear();
+        helper->m_channelsFound     = 0;
+        helper->m_scanTransports.clear();
+        helper->m_current = helper->m_nextIt = helper->m_scanTransports.end();
+        helper->m_extendTransports.clear();
+        helper->m_tsScanned.clear();
+        helper->m_extendScanList    = m_extendScanList;
+        helper->m_scanDTVTunerType  = m_scanDTVTunerType;
+        helper->m_signalTimeout     = m_signalTimeout;
+        helper->m_transportsScanned = 0;
+        helper->m_waitingForTables  = false;
+        helper->m_dvbt2Tried        = true;
+        helper->m_shareIdle         = false;
+        helper->m_scanning          = true;
+    }
+}
+
+/** \fn ChannelScanSM::ClaimTransport(void)
+ *  \brief Takes the next transport to scan from the shared list.
+ *
+ *   The transports found in the NIT of the transports we scanned are added
+ *   to the shared list first, unless one of the inputs already has them.
+ *   Returns the end of our list if there is nothing left to scan for now.
+ */
+transport_scan_items_it_t ChannelScanSM::ClaimTransport(void)
+{
+    ChannelScanSM *share = m_coordinator;
+    QMutexLocker locker(&share->m_shareLock);
+
+    share->m_shareSeen.unite(m_tsScanned);
+    for (auto it = m_extendTransports.cbegin(); it != m_extendTransports.cend(); ++it)
+    {
+        if (share->m_shareSeen.contains(it.key()))
+            continue;
+
+        QString name = QString("TransportID %1").arg(it.key() & 0xffff);
+        TransportScanItem item(m_sourceID, name, *it, m_signalTimeout);
+        LOG(VB_CHANSCAN, LOG_INFO, LOC + "Adding " + name + ' ' + item.m_tuning.toString());
+        share->m_sharePending.push_back(item);
+        share->m_shareSeen.insert(it.key());
+        share->m_shareTotal++;
+    }
+    m_extendTransports.clear();
+
+    if (share->m_sharePending.empty())
+    {
+        if (!m_shareIdle)
+        {
+            m_shareIdle = true;
+            share->m_shareBusy--;
+        }
+        return m_scanTransports.end();
+    }
+
+    if (m_shareIdle)
+    {
+        m_shareIdle = false;
+        share->m_shareBusy++;
+    }
+    m_scanTransports.splice(m_scanTransports.end(), share->m_sharePending,
+                            share->m_sharePending.begin());
+    return {std::prev(m_scanTransports.end())};
+}
+
+/// True once no input is scanning and the shared list is empty.
+bool ChannelScanSM::IsSharedScanDone(void)
+{
+    QMutexLocker share(&m_shareLock);
+    return m_shareBusy <= 0 && m_sharePending.empty();
+}
+
+int ChannelScanSM::GetSharedPercentComplete(void)
+{
+    QMutexLocker share(&m_shareLock);
+    if (m_shareTotal <= 0)
+        return 0;
+    return std::min(100, (m_shareScanned * 100) / m_shareTotal);
 }
 
 /** \fn ChannelScanSM::run(void)
@@ -2126,6 +2267,9 @@ void ChannelScanSM::HandleActiveScan(void)
         m_channelList.clear();
         m_channelsFound = 0;
         m_dvbt2Tried = true;
+
+        if (!m_helpers.empty() && !m_scanTransports.empty())
+            ShareTransports();
     }
 
     if ((m_scanDTVTunerType == DTVTunerType::kTunerTypeDVBT2) && ! m_dvbt2Tried)
@@ -2136,7 +2280,8 @@ void ChannelScanSM::HandleActiveScan(void)
         return;
     }
 
-    if (0 == m_nextIt.offset() && m_nextIt != m_scanTransports.begin())
+    if (0 == m_nextIt.offset() && m_nextIt != m_scanTransports.begin() &&
+        !m_shareIdle)
     {
         // Add channel to scanned list and potentially check decryption
         if (do_post_insertion && !UpdateChannelInfo(false))
@@ -2151,6 +2296,10 @@ void ChannelScanSM::HandleActiveScan(void)
     m_current = m_nextIt; // Increment current
     m_dvbt2Tried = false;
 
+    // When scanning on several inputs take the next one from the shared list
+    if (m_coordinator && m_current == m_scanTransports.end())
+        m_current = ClaimTransport();
+
     if (m_current != m_scanTransports.end())
     {
         ScanTransport(m_current);
@@ -2179,9 +2328,15 @@ void ChannelScanSM::HandleActiveScan(void)
         m_nextIt = m_current;
         ++m_nextIt;
     }
+    else if (m_coordinator && !m_coordinator->IsSharedScanDone())
+    {
+        // Wait, the other inputs may still find transports in a NIT
+        m_dvbt2Tried = true;
+    }
     else
     {
-        m_scanMonitor->ScanComplete();
+        if (!m_coordinator || m_coordinator == this)
+            m_scanMonitor->ScanComplete();
         m_scanning = false;
         m_current = m_nextIt = m_scanTransports.end();
     }
@@ -2297,6 +2452,9 @@ void ChannelScanSM::StopScanner(void)
 {
     LOG(VB_CHANSCAN, LOG_INFO, LOC + "StopScanner");
 
+    for (auto *helper : m_helpers)
+        helper->StopScanner();
+
     while (m_scannerThread)
     {
         m_threadExit = true;
@@ -106,6 +106,8 @@ class ChannelScanSM : public MPEGStreamListener,
     void StartScanner(void);
     void StopScanner(void);
 
+    void AddHelper(ChannelScanSM *helper);
+
     bool ScanTransports(
         int SourceID, const QString &std, const QString &mod, const QString &country,
         const QString &table_start = QString(),
@@ -181,6 +183,12 @@ class ChannelScanSM : public MPEGStreamListener,
     // Updates Transport Scan progress bar
     inline void UpdateScanPercentCompleted(void);
 
+    // Sharing the transport list with the helpers
+    void ShareTransports(void);
+    transport_scan_items_it_t ClaimTransport(void);
+    bool IsSharedScanDone(void);
+    int  GetSharedPercentComplete(void);
+
     bool CheckImportedList(const DTVChannelInfoList &channels,
                            uint mpeg_program_num,
                            QString &service_name,
@@ -266,10 +274,28 @@ class ChannelScanSM : public MPEGStreamListener,
 
     // Protect UpdateChannelInfo
     QMutex               m_mutex;
+
+    /// Scanners on the other inputs of the source, owned by the first one.
+    /// They all take their transports from the first scanner's list.
+    std::vector<ChannelScanSM*>  m_helpers;
+    ChannelScanSM               *m_coordinator  {nullptr};
+    bool                         m_shareIdle    {false};
+    QMutex                       m_shareLock;
+    std::list<TransportScanItem> m_sharePending;
+    QSet<uint32_t>               m_shareSeen;
+    int                          m_shareBusy    {0};
+    int                          m_shareScanned {0};
+    int                          m_shareTotal   {0};
 };
 
 inline void ChannelScanSM::UpdateScanPercentCompleted(void)
 {
+    if (m_coordinator)
+    {
+        m_scanMonitor->ScanPercentComplete(
+            m_coordinator->GetSharedPercentComplete());
+        return;
+    }
 #ifdef __cpp_size_t_suffix
     int tmp = (m_transportsScanned * 100Z) /
               (m_scanTransports.size() + m_extendTransports.size());
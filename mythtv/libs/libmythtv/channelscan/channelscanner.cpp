@@ -40,6 +40,7 @@
 #include "cardutil.h"
 #include "channelscan_sm.h"
 #include "channelscanner.h"
+#include "inputinfo.h"
 #include "iptvchannelfetcher.h"
 #include "recorders/ExternalChannel.h"
 #include "recorders/analogsignalmonitor.h"
@@ -54,6 +55,7 @@
 #include "recorders/v4lchannel.h"
 #include "scanmonitor.h"
 #include "scanwizardconfig.h"
+#include "tvremoteutil.h"
 
 #define LOC QString("ChScan: ")
 
@@ -82,6 +84,10 @@ void ChannelScanner::Teardown(void)
         m_channel = nullptr;
     }
 
+    for (auto *channel : m_helperChannels)
+        delete channel;
+    m_helperChannels.clear();
+
     if (m_iptvScanner)
     {
         m_iptvScanner->Stop();
@@ -456,6 +462,103 @@ bool ChannelScanner::ImportHDHR([[maybe_unused]] uint cardid,
 #endif
 }
 
+/** \brief Scans a transport list on all free tuners connected to the source.
+ *
+ *   Each other input of the source with its own tuner of the same type gets
+ *   a ChannelScanSM that shares the transport list of the first one, see
+ *   ChannelScanSM::AddHelper(). A DVB input is free if its channel can be
+ *   opened, the device is opened exclusively. Network tuners open fine while
+ *   a backend records on them, so those are only used if the backend says
+ *   that neither the input nor one sharing its tuner is busy.
+ */
+void ChannelScanner::AddHelperScanners(
+    int scantype, uint cardid, const QString &card_type,
+    const QString &inputname, uint sourceid,
+    std::chrono::milliseconds signal_timeout,
+    std::chrono::milliseconds channel_timeout,
+    bool do_test_decryption)
+{
+    // Only the scans of a transport list, there is nothing to share otherwise
+    if ((ScanTypeSetting::FullScan_ATSC     != scantype) &&
+        (ScanTypeSetting::FullScan_DVBC     != scantype) &&
+        (ScanTypeSetting::FullScan_DVBT     != scantype) &&
+        (ScanTypeSetting::FullScan_DVBT2    != scantype) &&
+        (ScanTypeSetting::NITAddScan_DVBT   != scantype) &&
+        (ScanTypeSetting::NITAddScan_DVBT2  != scantype) &&
+        (ScanTypeSetting::NITAddScan_DVBS   != scantype) &&
+        (ScanTypeSetting::NITAddScan_DVBS2  != scantype) &&
+        (ScanTypeSetting::NITAddScan_DVBC   != scantype) &&
+        (ScanTypeSetting::FullTransportScan != scantype) &&
+        (ScanTypeSetting::DVBUtilsImport    != scantype))
+    {
+        return;
+    }
+
+    QStringList devices(CardUtil::GetVideoDevice(cardid));
+    for (uint inputid : CardUtil::GetInputIDs(sourceid))
+    {
+        if (inputid == cardid || CardUtil::GetRawInputType(inputid) != card_type)
+            continue;
+
+        // Skip the virtual inputs sharing a tuner already in use
+        QString device = CardUtil::GetVideoDevice(inputid);
+        if (device.isEmpty() || devices.contains(device))
+            continue;
+
+        if ("DVB" != card_type)
+        {
+            std::vector<uint> inputids = CardUtil::GetConflictingInputs(inputid);
+            inputids.push_back(inputid);
+            InputInfo info;
+            if (std::any_of(inputids.cbegin(), inputids.cend(),
+                            [&info](uint id) { return RemoteIsBusy(id, info); }))
+            {
+                LOG(VB_CHANSCAN, LOG_INFO, LOC +
+                    QString("Input %1 (%2) is busy, not scanning on it")
+                        .arg(inputid).arg(device));
+                continue;
+            }
+        }
+
+        ChannelBase *channel = nullptr;
+#if CONFIG_DVB
+        if ("DVB" == card_type)
+            channel = new DVBChannel(device);
+#endif
+#if CONFIG_HDHOMERUN
+        if ("HDHOMERUN" == card_type)
+            channel = new HDHRChannel(nullptr, device);
+#endif
+#if CONFIG_SATIP
+        if ("SATIP" == card_type)
+            channel = new SatIPChannel(nullptr, device);
+#endif
+        if (!channel)
+            return;
+
+        channel->SetInputID(inputid);
+        if (!channel->Open())
+        {
+            LOG(VB_CHANSCAN, LOG_INFO, LOC +
+                QString("Input %1 (%2) is busy, not scanning on it")
+                    .arg(inputid).arg(device));
+            delete channel;
+            continue;
+        }
+
+        LOG(VB_CHANSCAN, LOG_INFO, LOC +
+            QString("Also scanning on input %1 (%2)").arg(inputid).arg(device));
+
+        devices << device;
+        m_helperChannels.push_back(channel);
+        auto *helper = new ChannelScanSM(m_scanMonitor, card_type, channel,
+                                         sourceid, signal_timeout,
+                                         channel_timeout, inputname,
+                                         do_test_decryption);
+        m_sigmonScanner->AddHelper(helper);
+    }
+}
+
 void ChannelScanner::PreScanCommon(
     int scantype,
     uint cardid,
@@ -619,6 +722,9 @@ void ChannelScanner::PreScanCommon(
             break;
     }
 
+    AddHelperScanners(scantype, cardid, card_type, inputname, sourceid,
+                      signal_timeout, channel_timeout, do_test_decryption);
+
     // Signal Meters are connected here
     SignalMonitor *mon = m_sigmonScanner->GetSignalMonitor();
     if (mon)
@@ -30,6 +30,10 @@
 #ifndef CHANNEL_SCANNER_H
 #define CHANNEL_SCANNER_H
 
+// C++ headers
+#include <chrono>
+#include <vector>
+
 // Qt headers
 #include <QtGlobal>
 #if QT_VERSION >= QT_VERSION_CHECK(6,5,0)
@@ -124,6 +128,13 @@ class MTV_PUBLIC ChannelScanner
         uint sourceid, bool do_ignore_signal_timeout,
         bool do_test_decryption);
 
+    void AddHelperScanners(
+        int scantype, uint cardid, const QString &card_type,
+        const QString &inputname, uint sourceid,
+        std::chrono::milliseconds signal_timeout,
+        std::chrono::milliseconds channel_timeout,
+        bool do_test_decryption);
+
     virtual void MonitorProgress(
         bool /*lock*/, bool /*strength*/, bool /*snr*/, bool /*rotor*/) { }
 
@@ -133,6 +144,8 @@ class MTV_PUBLIC ChannelScanner
   protected:
     ScanMonitor             *m_scanMonitor         {nullptr};
     ChannelBase             *m_channel             {nullptr};
+    /// Channels of the other free inputs scanning the same source
+    std::vector<ChannelBase*> m_helperChannels;
 
     // Low level channel scanners
     ChannelScanSM           *m_sigmonScanner       {nullptr};
@@ -73,8 +73,12 @@ target_sources(
           programdata.cpp
           # TVRec stuff
           tv_rec.h
+          channelchangestats.h
+          channelchangestats.cpp
           recordingquality.h
           recordingquality.cpp
+          standbytuner.h
+          standbytuner.cpp
           tv_rec.cpp
           # Recorder base and util classes
           recorders/recorderbase.h
@@ -127,6 +127,7 @@ target_sources(
           visualisations/videovisual.h
           visualisations/videovisualdefs.h
           visualisations/videovisualspectrum.h
+          visualisations/visualrenderer.h
           mythdeinterlacer.h
           mythinteropgpu.h
           mythvideoout.cpp
@@ -142,6 +143,7 @@ target_sources(
           visualisations/audiooutputgraph.cpp
           visualisations/videovisual.cpp
           visualisations/videovisualspectrum.cpp
+          visualisations/visualrenderer.cpp
           mythdeinterlacer.cpp
           mythinteropgpu.cpp
           decoders/mythdrmprimecontext.h
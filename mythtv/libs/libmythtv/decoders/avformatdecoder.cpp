@@ -4675,8 +4675,10 @@ bool AvFormatDecoder::GetFrame(DecodeType decodetype, bool &Retry)
                 pkt = av_packet_alloc();
 
             int retval = 0;
+            auto demuxStart = std::chrono::steady_clock::now();
             if (m_ic != nullptr)
                 retval = ReadPacket(m_ic, pkt, storevideoframes);
+            AddStageTime(m_stageTimings.m_demux, demuxStart);
             if ((m_ic == nullptr) || (retval < 0))
             {
                 if (retval == -EAGAIN)
@@ -4807,10 +4809,12 @@ bool AvFormatDecoder::GetFrame(DecodeType decodetype, bool &Retry)
         {
             case AVMEDIA_TYPE_AUDIO:
             {
+                auto audioStart = std::chrono::steady_clock::now();
                 if (!ProcessAudioPacket(context, curstream, pkt, decodetype))
                     have_err = true;
                 else
                     GenerateDummyVideoFrames();
+                AddStageTime(m_stageTimings.m_audio, audioStart);
                 break;
             }
 
@@ -4821,7 +4825,10 @@ bool AvFormatDecoder::GetFrame(DecodeType decodetype, bool &Retry)
                     break;
                 }
 
-                if (!PreProcessVideoPacket(context, curstream, pkt))
+                auto preProcessStart = std::chrono::steady_clock::now();
+                bool preProcessed = PreProcessVideoPacket(context, curstream, pkt);
+                AddStageTime(m_stageTimings.m_preProcess, preProcessStart);
+                if (!preProcessed)
                     continue;
 
                 // If the resolution changed in XXXPreProcessPkt, we may
@@ -4845,8 +4852,14 @@ bool AvFormatDecoder::GetFrame(DecodeType decodetype, bool &Retry)
                     break;
                 }
 
+                auto videoStart = std::chrono::steady_clock::now();
                 if (!ProcessVideoPacket(context, curstream, pkt, Retry))
                     have_err = true;
+                AddStageTime(m_stageTimings.m_video, videoStart);
+                {
+                    QMutexLocker locker(&m_stageTimingsLock);
+                    m_stageTimings.m_packets++;
+                }
                 break;
             }
 
@@ -4879,6 +4892,38 @@ bool AvFormatDecoder::GetFrame(DecodeType decodetype, bool &Retry)
     return true;
 }
 
+void AvFormatDecoder::AddStageTime(std::chrono::microseconds &Stage,
+                                   std::chrono::steady_clock::time_point Start)
+{
+    auto elapsed = std::chrono::steady_clock::now() - Start;
+    QMutexLocker locker(&m_stageTimingsLock);
+    Stage += duration_cast<std::chrono::microseconds>(elapsed);
+}
+
+/** \brief Average time spent per video packet in each decode stage since
+ *         the last call, as "demux/preprocess/video/audio" milliseconds.
+ */
+QString AvFormatDecoder::GetStageTimings(void)
+{
+    QMutexLocker locker(&m_stageTimingsLock);
+    DecodeStageTimings timings = m_stageTimings;
+    m_stageTimings = DecodeStageTimings();
+    locker.unlock();
+
+    if (timings.m_packets == 0)
+        return {};
+
+    auto average = [&timings](std::chrono::microseconds Time)
+    {
+        return QString::number(static_cast<double>(Time.count()) /
+                               (1000.0 * timings.m_packets), 'f', 1);
+    };
+
+    return QString("%1/%2/%3/%4ms")
+        .arg(average(timings.m_demux), average(timings.m_preProcess),
+             average(timings.m_video), average(timings.m_audio));
+}
+
 void AvFormatDecoder::StreamChangeCheck(void)
 {
     if (m_streamsChanged)
@@ -3,6 +3,7 @@
 #define AVFORMATDECODER_H_
 
 #include <array>
+#include <chrono>
 #include <cstdint>
 
 extern "C" {
@@ -12,6 +13,7 @@ extern "C" {
 
 #include <QList>
 #include <QMap>
+#include <QMutex>
 #include <QString>
 
 #include "audio/audiooutputsettings.h"
@@ -107,6 +109,7 @@ class AvFormatDecoder : public DecoderBase
 
     QString      GetCodecDecoderName(void) const override; // DecoderBase
     QString      GetRawEncodingType(void) override; // DecoderBase
+    QString      GetStageTimings(void) override; // DecoderBase
     MythCodecID  GetVideoCodecID(void) const override { return m_videoCodecId; } // DecoderBase
 
     void SetDisablePassThrough(bool disable) override; // DecoderBase
@@ -318,6 +321,22 @@ class AvFormatDecoder : public DecoderBase
     std::chrono::milliseconds  m_audioReadAhead       {100ms};
 
     QRecursiveMutex    m_avCodecLock;
+
+    // Time spent in each stage of GetFrame, for the playback debug OSD
+    struct DecodeStageTimings
+    {
+        std::chrono::microseconds m_demux      {0us};
+        std::chrono::microseconds m_preProcess {0us};
+        std::chrono::microseconds m_video      {0us};
+        std::chrono::microseconds m_audio      {0us};
+        uint                      m_packets    {0};
+    };
+
+    void AddStageTime(std::chrono::microseconds &Stage,
+                      std::chrono::steady_clock::time_point Start);
+
+    QMutex             m_stageTimingsLock;
+    DecodeStageTimings m_stageTimings;
 };
 
 #endif
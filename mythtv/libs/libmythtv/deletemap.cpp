@@ -223,6 +223,7 @@ void DeleteMap::UpdateOSD(uint64_t frame, double frame_rate, OSD *osd)
     posMap.insert("position", (float)((double)frame/(double)total));
     osd->SetValues(OSD_WIN_PROGEDIT, posMap, kOSDTimeout_None);
     osd->SetText(OSD_WIN_PROGEDIT, infoMap,  kOSDTimeout_None);
+    osd->SetSeekPreview(frame);
     if (m_changed || total != m_cachedTotalForOSD)
         osd->SetRegions(OSD_WIN_PROGEDIT, m_deleteMap, total);
     m_changed = false;
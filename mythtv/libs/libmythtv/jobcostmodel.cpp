@@ -0,0 +1,309 @@
+// C++ headers
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <unistd.h>
+
+// Qt headers
+#include <QtGlobal>
+#if QT_VERSION >= QT_VERSION_CHECK(6,5,0)
+#include <QtSystemDetection>
+#endif
+#include <QFile>
+#include <QStringList>
+#include <QThread>
+
+// MythTV headers
+#include "libmythbase/mythlogging.h"
+#include "libmythbase/mythmiscutil.h"
+
+#include "jobcostmodel.h"
+#include "jobqueue.h"
+
+#define LOC QString("JobCostModel: ")
+
+[[maybe_unused]] static QByteArray read_proc(const QString &Filename)
+{
+    QFile file(Filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    return file.readAll();
+}
+
+/// The value of the "Key: value" line \a Key, in the units it is given in.
+static double proc_value(const QByteArray &Data, const QByteArray &Key)
+{
+    for (const auto &line : Data.split('\n'))
+    {
+        if (!line.startsWith(Key))
+            continue;
+        QList<QByteArray> fields = line.mid(Key.size()).simplified().split(' ');
+        bool ok = false;
+        double value = fields.value(0).toDouble(&ok);
+        return ok ? value : -1.0;
+    }
+    return -1.0;
+}
+
+JobCostModel::JobCostModel()
+{
+    for (int type : { JOB_TRANSCODE, JOB_COMMFLAG, JOB_METADATA, JOB_PREVIEW,
+                      JOB_USERJOB1, JOB_USERJOB2, JOB_USERJOB3, JOB_USERJOB4 })
+        m_costs[type] = DefaultCost(type);
+}
+
+/// A first guess, until the job type has run here.
+JobCost JobCostModel::DefaultCost(int JobType)
+{
+    switch (JobType)
+    {
+        case JOB_TRANSCODE: return { 2.0, 20.0, 400.0, 30min, 0 };
+        case JOB_COMMFLAG:  return { 1.0, 10.0, 200.0, 10min, 0 };
+        case JOB_METADATA:  return { 0.1,  0.0, 100.0, 30s,   0 };
+        case JOB_PREVIEW:   return { 1.0, 20.0, 150.0, 1min,  0 };
+        default:            return { 1.0, 10.0, 200.0, 10min, 0 };
+    }
+}
+
+JobCost JobCostModel::GetCost(int JobType) const
+{
+    return m_costs.value(JobType, DefaultCost(JobType));
+}
+
+/// Fold a finished run into the job type's cost. \a Usage is the last
+/// sample of its processes, and is ignored if the job ended before the
+/// first sample; \a Duration is always learned.
+void JobCostModel::Learn(int JobType, const JobUsage &Usage,
+                         std::chrono::seconds Duration)
+{
+    if (!m_costs.contains(JobType))
+        m_costs[JobType] = DefaultCost(JobType);
+    JobCost &cost = m_costs[JobType];
+
+    // The first run replaces the guess
+    double weight = (cost.m_samples == 0) ? 1.0 : kWeight;
+    auto blend = [weight](double old, double now)
+        { return (old * (1.0 - weight)) + (now * weight); };
+
+    cost.m_duration = std::chrono::seconds(std::llround(
+        blend(cost.m_duration.count(), Duration.count())));
+    if (Usage.IsValid())
+    {
+        double seconds = Usage.m_elapsed.count() / 1000.0;
+        cost.m_cores    = blend(cost.m_cores, Usage.m_cpu.count() / 1000.0 / seconds);
+        cost.m_ioMBps   = blend(cost.m_ioMBps, Usage.m_ioBytes / 1048576.0 / seconds);
+        cost.m_memoryMB = blend(cost.m_memoryMB, Usage.m_peakMB);
+    }
+    cost.m_samples++;
+
+    LOG(VB_JOBQUEUE, LOG_INFO, LOC +
+        QString("%1 now costs %2 cores, %3 MB/s, %4 MB, %5 s (%6 runs)")
+        .arg(JobQueue::JobText(JobType))
+        .arg(cost.m_cores, 0, 'f', 2).arg(cost.m_ioMBps, 0, 'f', 1)
+        .arg(cost.m_memoryMB, 0, 'f', 0).arg(cost.m_duration.count())
+        .arg(cost.m_samples));
+}
+
+/// True if a \a JobType job can start next to the \a Running job types
+/// under \a Load.
+bool JobCostModel::Admit(int JobType, const QList<int> &Running,
+                         const JobHostLoad &Load) const
+{
+    if (Running.isEmpty())
+        return true;
+
+    double committedCores = 0.0;
+    double committedIO = 0.0;
+    for (int type : Running)
+    {
+        JobCost running = GetCost(type);
+        committedCores += running.m_cores;
+        committedIO    += running.m_ioMBps;
+    }
+
+    // Jobs just started may not show in the load yet, so count at least
+    // what they are expected to use. A job that wants more cores than the
+    // host has needs the whole host.
+    JobCost cost = GetCost(JobType);
+    double busy = std::max(committedCores, Load.m_busyCores);
+    if (busy + std::min(cost.m_cores, Load.m_cores) > Load.m_cores + kCoreSlack)
+        return false;
+
+    if (committedIO + cost.m_ioMBps > kIOBudgetMBps)
+        return false;
+
+    return (Load.m_availableMB < 0) ||
+           (cost.m_memoryMB + kMemoryMargin <= Load.m_availableMB);
+}
+
+/// Sort key of a queued job, lowest first: its expected run time less the
+/// time it has already waited.
+std::chrono::seconds JobCostModel::Priority(int JobType,
+                                            std::chrono::seconds Waited) const
+{
+    return GetCost(JobType).m_duration - Waited;
+}
+
+/// The learned costs, as "type:cores,MB/s,MB,seconds,runs;..."
+QString JobCostModel::ToString(void) const
+{
+    QStringList types;
+    for (auto it = m_costs.cbegin(); it != m_costs.cend(); ++it)
+    {
+        if (it->m_samples == 0)
+            continue;
+        types << QString("%1:%2,%3,%4,%5,%6").arg(it.key())
+            .arg(it->m_cores, 0, 'f', 3).arg(it->m_ioMBps, 0, 'f', 3)
+            .arg(it->m_memoryMB, 0, 'f', 1).arg(it->m_duration.count())
+            .arg(it->m_samples);
+    }
+    return types.join(';');
+}
+
+bool JobCostModel::FromString(const QString &Model)
+{
+    QMap<int, JobCost> costs;
+    for (const auto &type : Model.split(';', Qt::SkipEmptyParts))
+    {
+        QStringList keyValue = type.split(':');
+        QStringList fields = keyValue.value(1).split(',');
+        if (keyValue.size() != 2 || fields.size() != 5)
+            return false;
+
+        std::array<bool,6> ok {};
+        int jobType = keyValue[0].toInt(ok.data());
+        JobCost cost { fields[0].toDouble(&ok[1]), fields[1].toDouble(&ok[2]),
+                       fields[2].toDouble(&ok[3]),
+                       std::chrono::seconds(fields[3].toLongLong(&ok[4])),
+                       fields[4].toInt(&ok[5]) };
+        if (std::find(ok.cbegin(), ok.cend(), false) != ok.cend() ||
+            cost.m_cores < 0 || cost.m_ioMBps < 0 || cost.m_memoryMB < 0 ||
+            cost.m_samples <= 0)
+            return false;
+        costs[jobType] = cost;
+    }
+
+    for (auto it = costs.cbegin(); it != costs.cend(); ++it)
+        m_costs[it.key()] = it.value();
+    return true;
+}
+
+/// Busy and total jiffies from the "cpu" line of /proc/stat. iowait counts
+/// as idle, a core waiting on the disk could still run a job.
+bool JobCostModel::ParseProcStat(const QByteArray &Stat, uint64_t &Busy,
+                                 uint64_t &Total)
+{
+    QByteArray line = Stat.split('\n').value(0).simplified();
+    QList<QByteArray> fields = line.split(' ');
+    if (fields.size() < 5 || fields[0] != "cpu")
+        return false;
+
+    uint64_t total = 0;
+    uint64_t idle = 0;
+    // user nice system idle iowait irq softirq steal, guest is in user
+    for (qsizetype i = 1; i < std::min<qsizetype>(fields.size(), 9); ++i)
+    {
+        bool ok = false;
+        uint64_t value = fields[i].toULongLong(&ok);
+        if (!ok)
+            return false;
+        total += value;
+        if (i == 4 || i == 5)
+            idle += value;
+    }
+    Busy  = total - idle;
+    Total = total;
+    return true;
+}
+
+/// MemAvailable from /proc/meminfo in MB, or -1 if it isn't there.
+double JobCostModel::ParseMemAvailable(const QByteArray &MemInfo)
+{
+    double kB = proc_value(MemInfo, "MemAvailable:");
+    return (kB < 0) ? -1.0 : kB / 1024.0;
+}
+
+/// The host's load since the last call.
+JobHostLoad JobCostModel::SampleHost(void)
+{
+    JobHostLoad load;
+    load.m_cores = std::max(1, QThread::idealThreadCount());
+
+#ifdef Q_OS_LINUX
+    uint64_t busy = 0;
+    uint64_t total = 0;
+    load.m_availableMB = ParseMemAvailable(read_proc("/proc/meminfo"));
+    if (ParseProcStat(read_proc("/proc/stat"), busy, total))
+    {
+        bool sampled = (m_lastTotal > 0) && (total > m_lastTotal);
+        if (sampled)
+        {
+            load.m_busyCores = load.m_cores *
+                static_cast<double>(busy - m_lastBusy) / (total - m_lastTotal);
+        }
+        m_lastBusy  = busy;
+        m_lastTotal = total;
+        if (sampled)
+            return load;
+    }
+#else
+    int totalMB = 0;
+    int freeMB = 0;
+    int totalVM = 0;
+    int freeVM = 0;
+    if (getMemStats(totalMB, freeMB, totalVM, freeVM))
+        load.m_availableMB = freeMB;
+#endif
+
+    // No earlier sample to compare to, so go by the run queue
+    double loadavg = getLoadAvgs()[0];
+    if (loadavg >= 0)
+        load.m_busyCores = std::min(loadavg, load.m_cores);
+    return load;
+}
+
+/// The usage so far of process \a Pid and its descendants. Processes that
+/// have already exited are counted through their parents' child times.
+JobUsage JobCostModel::SampleProcess([[maybe_unused]] qint64 Pid,
+                                     std::chrono::milliseconds Elapsed)
+{
+    JobUsage usage;
+#ifdef Q_OS_LINUX
+    static const long kTicks = std::max(1L, sysconf(_SC_CLK_TCK));
+
+    QList<qint64> pids { Pid };
+    while (Pid > 0 && !pids.isEmpty())
+    {
+        qint64 pid = pids.takeFirst();
+        QString dir = QString("/proc/%1/").arg(pid);
+
+        // Skip past the command name, it may hold spaces
+        QByteArray stat = read_proc(dir + "stat");
+        QList<QByteArray> fields =
+            stat.mid(stat.lastIndexOf(')') + 2).simplified().split(' ');
+        if (fields.size() < 15)
+            continue;
+        // utime stime cutime cstime are fields 14-17 of the whole line
+        uint64_t ticks = 0;
+        for (int i = 11; i <= 14; ++i)
+            ticks += fields[i].toULongLong();
+        usage.m_cpu += std::chrono::milliseconds(ticks * 1000 / kTicks);
+
+        QByteArray io = read_proc(dir + "io");
+        usage.m_ioBytes += static_cast<uint64_t>(
+            std::max(0.0, proc_value(io, "read_bytes:")) +
+            std::max(0.0, proc_value(io, "write_bytes:")));
+        usage.m_peakMB += std::max(0.0,
+            proc_value(read_proc(dir + "status"), "VmHWM:")) / 1024.0;
+
+        // Needs CONFIG_PROC_CHILDREN, without it only Pid is counted
+        QByteArray children = read_proc(dir + QString("task/%1/children").arg(pid));
+        for (const auto &child : children.simplified().split(' '))
+            if (!child.isEmpty())
+                pids << child.toLongLong();
+    }
+    if (usage.m_cpu > 0ms || usage.m_peakMB > 0.0)
+        usage.m_elapsed = Elapsed;
+#endif
+    return usage;
+}
@@ -0,0 +1,101 @@
+// -*- Mode: c++ -*-
+#ifndef JOB_COST_MODEL_H
+#define JOB_COST_MODEL_H
+
+// C++ headers
+#include <cstdint>
+
+// Qt headers
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QString>
+
+// MythTV headers
+#include "libmythbase/mythchrono.h"
+
+#include "mythtvexp.h"
+
+/// What one run of a job type costs the host.
+struct JobCost
+{
+    double               m_cores    {1.0}; ///< average CPU cores busy
+    double               m_ioMBps   {0.0}; ///< disk read + write rate
+    double               m_memoryMB {0.0}; ///< peak resident memory
+    std::chrono::seconds m_duration {0s};  ///< wall clock time
+    int                  m_samples  {0};   ///< runs learned from
+};
+
+/// The host's capacity and how much of it is in use right now.
+struct JobHostLoad
+{
+    double m_cores       {1.0};  ///< CPU cores
+    double m_busyCores   {0.0};  ///< cores busy with anything, jobs included
+    double m_availableMB {-1.0}; ///< memory available, or -1 if unknown
+};
+
+/// Cumulative usage of a job's processes, as sampled while it runs.
+struct JobUsage
+{
+    std::chrono::milliseconds m_elapsed {0ms}; ///< job age when sampled
+    std::chrono::milliseconds m_cpu     {0ms}; ///< user + system time
+    uint64_t                  m_ioBytes {0};   ///< disk bytes read + written
+    double                    m_peakMB  {0.0}; ///< largest resident set
+
+    bool IsValid(void) const { return m_elapsed > 0ms; }
+};
+
+/** \class JobCostModel
+ *  \brief Decides which queued jobs fit on this host and in what order.
+ *
+ *  Every job type has a JobCost, starting from a rough guess and then
+ *  learned from the CPU time, disk traffic and peak memory of the type's
+ *  recent runs as an exponentially weighted average. A job is admitted
+ *  when its cost, added to that of the jobs already running here, fits the
+ *  host's cores, its free memory and the disk budget. The cores are
+ *  checked against the live load as well, so jobs back off while the host
+ *  is busy recording or playing back. A job is always admitted when
+ *  nothing else is running, so no job can be deferred forever.
+ *
+ *  Queued jobs are ordered shortest expected run first, less the time they
+ *  have waited, so quick preview and metadata jobs don't queue behind a
+ *  night of transcodes, and long jobs still get their turn.
+ */
+class MTV_PUBLIC JobCostModel
+{
+  public:
+    static constexpr double kWeight       { 0.3 };   ///< of the newest run
+    static constexpr double kIOBudgetMBps { 150.0 };
+    static constexpr double kMemoryMargin { 256.0 }; ///< MB left for the rest
+    static constexpr double kCoreSlack    { 0.25 };
+
+    JobCostModel();
+
+    JobCost GetCost(int JobType) const;
+    void    Learn(int JobType, const JobUsage &Usage,
+                  std::chrono::seconds Duration);
+    bool    Admit(int JobType, const QList<int> &Running,
+                  const JobHostLoad &Load) const;
+    std::chrono::seconds Priority(int JobType,
+                                  std::chrono::seconds Waited) const;
+
+    QString ToString(void) const;
+    bool    FromString(const QString &Model);
+
+    JobHostLoad SampleHost(void);
+    static JobUsage SampleProcess(qint64 Pid, std::chrono::milliseconds Elapsed);
+
+    // Exposed for testing
+    static bool ParseProcStat(const QByteArray &Stat, uint64_t &Busy,
+                              uint64_t &Total);
+    static double ParseMemAvailable(const QByteArray &MemInfo);
+
+  private:
+    static JobCost DefaultCost(int JobType);
+
+    QMap<int, JobCost> m_costs;
+    uint64_t           m_lastBusy  {0};
+    uint64_t           m_lastTotal {0};
+};
+
+#endif // JOB_COST_MODEL_H
@@ -2,6 +2,7 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <algorithm>
 #include <iostream>
 #include <cstdlib>
 #include <thread>
@@ -23,6 +24,7 @@ static constexpr int PTHREAD_NULL { 0 };
 #include <QEvent>
 #include <QCoreApplication>
 #include <QTimeZone>
+#include <QVector>
 
 #include "libmythbase/compat.h"
 #include "libmythbase/exitcodes.h"
@@ -48,6 +50,12 @@ static constexpr int PTHREAD_NULL { 0 };
 // Consider anything less than 4 hours as a "recent" job.
 static constexpr int64_t kRecentInterval {4LL * 60 * 60};
 
+// Look for the next job soon after starting one, the queue may be long
+static constexpr std::chrono::seconds kJobStartedWait   {1s};
+// Look again for room for deferred jobs, the host's load may have dropped
+static constexpr std::chrono::seconds kJobDeferredWait  {10s};
+static constexpr std::chrono::seconds kJobSampleInterval {5s};
+
 JobQueue::JobQueue(bool master) :
     m_hostname(gCoreContext->GetHostName()),
     m_runningJobsLock(new QRecursiveMutex()),
@@ -56,6 +64,13 @@ JobQueue::JobQueue(bool master) :
 {
     m_jobQueueCPU = gCoreContext->GetNumSetting("JobQueueCPU", 0);
 
+    QString costModel = gCoreContext->GetSetting("JobQueueCostModel");
+    if (!m_costModel.FromString(costModel))
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC +
+            QString("Ignoring bad JobQueueCostModel '%1'").arg(costModel));
+    }
+
 #if !CONFIG_VALGRIND
     QMutexLocker locker(&m_queueThreadCondLock);
     //NOLINTNEXTLINE(cppcoreguidelines-prefer-member-initializer)
@@ -105,6 +120,15 @@ void JobQueue::customEvent(QEvent *e)
             const QString& action = tokens[1];
             int jobID = -1;
 
+            // A job to start, or room to start one
+            if ((action == "QUEUED") || (action == "DONE"))
+            {
+                LOG(VB_JOBQUEUE, LOG_DEBUG, LOC +
+                    QString("Received message '%1'").arg(message));
+                WakeQueue();
+                return;
+            }
+
             if (tokens[2] == "ID")
             {
                 jobID = tokens[3].toInt();
@@ -189,6 +213,8 @@ void JobQueue::ProcessQueue(void)
         locker.unlock();
 
         bool startedJobAlready = false;
+        bool deferredJob = false;
+        QDateTime nextScheduledJob;
         auto sleepTime = gCoreContext->GetDurSetting<std::chrono::seconds>("JobQueueCheckFrequency", 30s);
         int maxJobs = gCoreContext->GetNumSetting("JobQueueMaxSimultaneousJobs", 3);
         LOG(VB_JOBQUEUE, LOG_INFO, LOC +
@@ -197,18 +223,45 @@ void JobQueue::ProcessQueue(void)
 
         jobStatus.clear();
 
+        QList<int> runningTypes;
         m_runningJobsLock->lock();
         for (rjiter = m_runningJobs.begin(); rjiter != m_runningJobs.end();
             ++rjiter)
         {
             if ((*rjiter).pginfo)
                 (*rjiter).pginfo->UpdateInUseMark();
+            runningTypes << (*rjiter).type;
         }
         m_runningJobsLock->unlock();
 
+        m_costModelLock.lock();
+        JobHostLoad load = m_costModel.SampleHost();
+        m_costModelLock.unlock();
+
         m_jobsRunning = 0;
         GetJobsInQueue(jobs);
 
+        // Look at the jobs already under way first, then the queued ones
+        // shortest first, less the time they have waited
+        QDateTime now = MythDate::current();
+        QVector<std::pair<std::chrono::seconds, int>> order;
+        m_costModelLock.lock();
+        for (int x = 0; x < jobs.size(); x++)
+        {
+            auto key = std::chrono::seconds::min();
+            if (jobs[x].status == JOB_QUEUED)
+            {
+                auto waited = std::chrono::seconds(
+                    std::max(0LL, jobs[x].inserttime.secsTo(now)));
+                key = m_costModel.Priority(jobs[x].type, waited);
+            }
+            order.push_back({ key, x });
+        }
+        m_costModelLock.unlock();
+        std::stable_sort(order.begin(), order.end(),
+                         [](const auto &a, const auto &b)
+                         { return a.first < b.first; });
+
         if (!jobs.empty())
         {
             bool inTimeWindow = InJobRunWindow();
@@ -250,9 +303,10 @@ void JobQueue::ProcessQueue(void)
             }
 
 
-            for ( int x = 0;
-                 (x < jobs.size()) && (m_jobsRunning < maxJobs); x++)
+            for ( int i = 0;
+                 (i < order.size()) && (m_jobsRunning < maxJobs); i++)
             {
+                int x = order[i].second;
                 int jobID = jobs[x].id;
                 int cmds = jobs[x].cmds;
                 //flags = jobs[x].flags;
@@ -316,8 +370,11 @@ void JobQueue::ProcessQueue(void)
                 }
 
                 // Is this job scheduled for the future
-                if (jobs[x].schedruntime > MythDate::current())
+                if (jobs[x].schedruntime > now)
                 {
+                    if (!nextScheduledJob.isValid() ||
+                        (jobs[x].schedruntime < nextScheduledJob))
+                        nextScheduledJob = jobs[x].schedruntime;
                     message = QString("Skipping '%1' job for %2, this job is "
                                       "not scheduled to run until %3.")
                                       .arg(JobText(jobs[x].type), logInfo,
@@ -431,6 +488,20 @@ void JobQueue::ProcessQueue(void)
                 if (startedJobAlready)
                     continue;
 
+                // Does this backend have room for it now?
+                m_costModelLock.lock();
+                bool fits = m_costModel.Admit(jobs[x].type, runningTypes, load);
+                m_costModelLock.unlock();
+                if (inTimeWindow && !fits)
+                {
+                    message = QString("Deferring '%1' job for %2, this "
+                                      "backend is too busy to run it now.")
+                                      .arg(JobText(jobs[x].type), logInfo);
+                    LOG(VB_JOBQUEUE, LOG_INFO, LOC + message);
+                    deferredJob = true;
+                    continue;
+                }
+
                 if (inTimeWindow &&
                     (hostname.isEmpty()) &&
                     (!ChangeJobHost(jobID, m_hostname)))
@@ -489,7 +560,17 @@ void JobQueue::ProcessQueue(void)
         locker.relock();
         if (m_processQueue)
         {
-            std::chrono::milliseconds st = startedJobAlready ? 5s : sleepTime;
+            // Queued and finished jobs wake us up, this is a fallback
+            std::chrono::milliseconds st =
+                startedJobAlready ? kJobStartedWait : sleepTime;
+            if (deferredJob)
+                st = std::min<std::chrono::milliseconds>(st, kJobDeferredWait);
+            if (nextScheduledJob.isValid())
+            {
+                auto due = std::chrono::milliseconds(
+                    MythDate::current().msecsTo(nextScheduledJob)) + 1s;
+                st = std::min(st, std::max<std::chrono::milliseconds>(due, 1s));
+            }
             if (st > 0ms)
                 m_queueThreadCond.wait(locker.mutex(), st.count());
         }
@@ -599,6 +680,10 @@ bool JobQueue::QueueJob(int jobType, uint chanid, const QDateTime &recstartts,
         return false;
     }
 
+    // Let every job queue look at it now, rather than at its next check
+    gCoreContext->SendMessage(QString("GLOBAL_JOB QUEUED ID %1")
+                              .arg(query.lastInsertId().toInt()));
+
     return true;
 }
 
@@ -642,6 +727,9 @@ bool JobQueue::QueueJobs(int jobTypes, uint chanid, const QDateTime &recstartts,
         }
     }
 
+    if (jobTypes & JOB_PREVIEW)
+        QueueJob(JOB_PREVIEW, chanid, recstartts, args, comment, host);
+
     if (jobTypes & JOB_USERJOB1)
         QueueJob(JOB_USERJOB1, chanid, recstartts, args, comment, host);
     if (jobTypes & JOB_USERJOB2)
@@ -1774,6 +1862,10 @@ void JobQueue::ProcessJob(const JobQueueEntry& job)
     {
         StartChildJob(MetadataLookupThread, jobID);
     }
+    else if (job.type == JOB_PREVIEW)
+    {
+        StartChildJob(PreviewStripThread, jobID);
+    }
     else if (job.type & JOB_USERJOB)
     {
         StartChildJob(UserJobThread, jobID);
@@ -1884,6 +1976,62 @@ void JobQueue::RemoveRunningJob(int id)
     }
 
     m_runningJobsLock->unlock();
+
+    // There may be room for another job here, and jobs elsewhere may have
+    // been waiting for this one to finish with the recording
+    WakeQueue();
+    gCoreContext->SendMessage(QString("GLOBAL_JOB DONE ID %1").arg(id));
+}
+
+void JobQueue::WakeQueue(void)
+{
+    m_queueThreadCondLock.lock();
+    m_queueThreadCond.wakeAll();
+    m_queueThreadCondLock.unlock();
+}
+
+/// Run a job's command the way myth_system() does, sampling the CPU time,
+/// disk traffic and memory of its processes while it runs, so the cost
+/// model learns what jobs of its type need.
+uint JobQueue::RunJobCommand(int jobID, const QString &command, uint flags)
+{
+    m_runningJobsLock->lock();
+    int jobType = m_runningJobs.contains(jobID) ? m_runningJobs[jobID].type
+                                                : static_cast<int>(JOB_NONE);
+    m_runningJobsLock->unlock();
+
+    auto start = nowAsDuration<std::chrono::milliseconds>();
+    auto *ms = new MythSystemLegacy(command, flags | kMSRunShell | kMSAutoCleanup);
+    ms->Run();
+    qint64 pid = ms->GetPid();
+
+    JobUsage usage;
+    uint result = ms->Wait(kJobSampleInterval);
+    while (result == GENERIC_EXIT_RUNNING)
+    {
+        JobUsage sample = JobCostModel::SampleProcess(
+            pid, nowAsDuration<std::chrono::milliseconds>() - start);
+        if (sample.IsValid())
+        {
+            sample.m_peakMB = std::max(sample.m_peakMB, usage.m_peakMB);
+            usage = sample;
+        }
+        result = ms->Wait(kJobSampleInterval);
+    }
+    delete ms;
+
+    // Failed runs say little about what a good one costs
+    bool stopped = (GetJobCmd(jobID) & JOB_STOP) != 0;
+    if ((jobType == JOB_NONE) || stopped || (result >= GENERIC_EXIT_NOT_OK))
+        return result;
+
+    auto duration = std::chrono::duration_cast<std::chrono::seconds>(
+        nowAsDuration<std::chrono::milliseconds>() - start);
+    QMutexLocker locker(&m_costModelLock);
+    m_costModel.Learn(jobType, usage, duration);
+    gCoreContext->SaveSettingOnHost("JobQueueCostModel",
+                                    m_costModel.ToString(), m_hostname);
+    return result;
 }
 
 QString JobQueue::PrettyPrint(off_t bytes)
@@ -2042,7 +2190,7 @@ void JobQueue::DoTranscodeThread(int jobID)
                                            .arg(command));
 
         GetMythDB()->GetDBManager()->CloseDatabases();
-        uint result = myth_system(command);
+        uint result = RunJobCommand(jobID, command);
         int status = GetJobStatus(jobID);
 
         if ((result == GENERIC_EXIT_DAEMONIZING_ERROR) ||
@@ -2213,7 +2361,7 @@ void JobQueue::DoMetadataLookupThread(int jobID)
             .arg(command));
 
     GetMythDB()->GetDBManager()->CloseDatabases();
-    retVal = myth_system(command);
+    retVal = RunJobCommand(jobID, command);
     int priority = LOG_NOTICE;
     QString comment;
 
@@ -2265,6 +2413,105 @@ void JobQueue::DoMetadataLookupThread(int jobID)
     m_runningJobsLock->unlock();
 }
 
+void *JobQueue::PreviewStripThread(void *param)
+{
+    auto *jts = (JobThreadStruct *)param;
+    JobQueue *jq = jts->jq;
+
+    MThread::ThreadSetup(QString("Preview_%1").arg(jts->jobID));
+    jq->DoPreviewStripThread(jts->jobID);
+    MThread::ThreadCleanup();
+
+    delete jts;
+
+    return nullptr;
+}
+
+void JobQueue::DoPreviewStripThread(int jobID)
+{
+    // The strip is indexed by the recording's position map
+    m_runningJobsLock->lock();
+    if (!m_runningJobs[jobID].pginfo)
+    {
+        LOG(VB_JOBQUEUE, LOG_ERR, LOC +
+            "The JobQueue cannot currently make preview strips for files "
+            "that do not have a chanid/starttime in the recorded table.");
+        ChangeJobStatus(jobID, JOB_ERRORED, "ProgramInfo data not found");
+        RemoveRunningJob(jobID);
+        m_runningJobsLock->unlock();
+        return;
+    }
+
+    ProgramInfo *program_info = m_runningJobs[jobID].pginfo;
+    m_runningJobsLock->unlock();
+
+    QString details = QString("%1 recorded from channel %3")
+        .arg(program_info->toString(ProgramInfo::kTitleSubtitle),
+             program_info->toString(ProgramInfo::kRecordingKey));
+
+    LOG(VB_GENERAL, LOG_INFO,
+        LOC + "Preview Strip Starting for " + details);
+
+    QString command = QString("%1 --strip --chanid %2 --starttime %3")
+        .arg(GetAppBinDir() + "mythpreviewgen")
+        .arg(program_info->GetChanID())
+        .arg(program_info->GetRecordingStartTime(MythDate::kFilename));
+    command += logPropagateArgs;
+
+    LOG(VB_JOBQUEUE, LOG_INFO, LOC + QString("Running command: '%1'")
+            .arg(command));
+
+    GetMythDB()->GetDBManager()->CloseDatabases();
+    uint retVal = RunJobCommand(jobID, command);
+    int priority = LOG_NOTICE;
+    QString comment;
+
+    m_runningJobsLock->lock();
+
+    if ((retVal == GENERIC_EXIT_DAEMONIZING_ERROR) ||
+        (retVal == GENERIC_EXIT_CMD_NOT_FOUND))
+    {
+        comment = tr("Unable to find mythpreviewgen");
+        ChangeJobStatus(jobID, JOB_ERRORED, comment);
+        priority = LOG_WARNING;
+    }
+    else if (m_runningJobs[jobID].flag == JOB_STOP)
+    {
+        comment = tr("Aborted by user");
+        ChangeJobStatus(jobID, JOB_ABORTED, comment);
+        priority = LOG_WARNING;
+    }
+    else if (retVal == GENERIC_EXIT_NO_RECORDING_DATA)
+    {
+        comment = tr("Unable to open file or init decoder");
+        ChangeJobStatus(jobID, JOB_ERRORED, comment);
+        priority = LOG_WARNING;
+    }
+    else if (retVal >= GENERIC_EXIT_NOT_OK) // 256 or above - error
+    {
+        comment = tr("Failed with exit status %1").arg(retVal);
+        ChangeJobStatus(jobID, JOB_ERRORED, comment);
+        priority = LOG_WARNING;
+    }
+    else
+    {
+        comment = tr("Preview Strip Complete.");
+        ChangeJobStatus(jobID, JOB_FINISHED, comment);
+    }
+
+    QString msg = tr("Preview Strip %1", "Job ID")
+        .arg(StatusText(GetJobStatus(jobID)));
+
+    if (!comment.isEmpty())
+        details += QString(" (%1)").arg(comment);
+
+    if (priority <= LOG_WARNING)
+        LOG(VB_GENERAL, LOG_ERR, LOC + msg + ": " + details);
+
+    RemoveRunningJob(jobID);
+    m_runningJobsLock->unlock();
+}
+
 void *JobQueue::FlagCommercialsThread(void *param)
 {
     auto *jts = (JobThreadStruct *)param;
@@ -2345,7 +2592,7 @@ void JobQueue::DoFlagCommercialsThread(int jobID)
             .arg(command));
 
     GetMythDB()->GetDBManager()->CloseDatabases();
-    breaksFound = myth_system(command, kMSLowExitVal);
+    breaksFound = RunJobCommand(jobID, command, kMSLowExitVal);
     int priority = LOG_NOTICE;
     QString comment;
 
@@ -2462,7 +2709,7 @@ void JobQueue::DoUserJobThread(int jobID)
     LOG(VB_JOBQUEUE, LOG_INFO, LOC + QString("Running command: '%1'")
                                        .arg(command));
     GetMythDB()->GetDBManager()->CloseDatabases();
-    uint result = myth_system(command);
+    uint result = RunJobCommand(jobID, command);
 
     if ((result == GENERIC_EXIT_DAEMONIZING_ERROR) ||
         (result == GENERIC_EXIT_CMD_NOT_FOUND))
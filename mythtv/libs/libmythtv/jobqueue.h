@@ -14,6 +14,7 @@
 
 #include "mythtvexp.h"
 #include "libmythbase/mythchrono.h"
+#include "jobcostmodel.h"
 
 class MThread;
 class ProgramInfo;
@@ -94,6 +95,7 @@ static QMap< QString, int > JobNameToType {
     { "Transcode", JOB_TRANSCODE },
     { "Commflag",  JOB_COMMFLAG },
     { "Metadata",  JOB_METADATA },
+    { "Preview",   JOB_PREVIEW },
     { "UserJob1",  JOB_USERJOB1 },
     { "UserJob2",  JOB_USERJOB2 },
     { "UserJob3",  JOB_USERJOB3 },
@@ -238,6 +240,8 @@ class MTV_PUBLIC JobQueue : public QObject, public QRunnable
     static bool InJobRunWindow(std::chrono::minutes orStartsWithinMins = 0min);
 
     void StartChildJob(void *(*ChildThreadRoutine)(void *), int jobID);
+    uint RunJobCommand(int jobID, const QString &command, uint flags = 0);
+    void WakeQueue(void);
 
     static QString GetJobDescription(int jobType);
     static QString GetJobCommand(int id, int jobType, ProgramInfo *tmpInfo);
@@ -251,6 +255,9 @@ class MTV_PUBLIC JobQueue : public QObject, public QRunnable
     static void *MetadataLookupThread(void *param);
     void DoMetadataLookupThread(int jobID);
 
+    static void *PreviewStripThread(void *param);
+    void DoPreviewStripThread(int jobID);
+
     static void *FlagCommercialsThread(void *param);
     void DoFlagCommercialsThread(int jobID);
 
@@ -270,6 +277,9 @@ class MTV_PUBLIC JobQueue : public QObject, public QRunnable
     QRecursiveMutex           *m_runningJobsLock     {nullptr};
     QMap<int, RunningJobInfo>  m_runningJobs;
 
+    QMutex                     m_costModelLock;
+    JobCostModel               m_costModel;
+
     bool                       m_isMaster;
 
     MThread                   *m_queueThread         {nullptr};
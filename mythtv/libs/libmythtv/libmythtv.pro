@@ -80,12 +80,13 @@ HEADERS += mythframe.h
 # Misc. needed by backend/frontend
 HEADERS += mythtvexp.h
 HEADERS += bitreader.h
+HEADERS += borderscanner.h
 HEADERS += bytereader.h
 HEADERS += recordinginfo.h
 HEADERS += dbcheck.h
 HEADERS += videodbcheck.h
 HEADERS += tvremoteutil.h           tv.h
-HEADERS += jobqueue.h
+HEADERS += jobqueue.h               jobcostmodel.h
 HEADERS += recordingprofile.h
 HEADERS += remoteencoder.h          videosource.h
 HEADERS += cardutil.h               sourceutil.h
@@ -101,6 +102,7 @@ HEADERS += signalmonitorvalue.h     signalmonitorlistener.h
 HEADERS += livetvchain.h            playgroup.h
 HEADERS += channelsettings.h
 HEADERS += previewgenerator.h       previewgeneratorqueue.h
+HEADERS += previewstrip.h          previewstripbuilder.h
 HEADERS += transporteditor.h        listingsources.h
 HEADERS += restoredata.h
 HEADERS += channelgroup.h
@@ -131,12 +133,13 @@ HEADERS += mythhdrvideometadata.h
 HEADERS += mythhdrtracker.h
 HEADERS += scantype.h
 
+SOURCES += borderscanner.cpp
 SOURCES += bytereader.cpp
 SOURCES += recordinginfo.cpp
 SOURCES += dbcheck.cpp
 SOURCES += videodbcheck.cpp
 SOURCES += tvremoteutil.cpp         tv.cpp
-SOURCES += jobqueue.cpp
+SOURCES += jobqueue.cpp             jobcostmodel.cpp
 SOURCES += recordingprofile.cpp
 SOURCES += remoteencoder.cpp        videosource.cpp
 SOURCES += cardutil.cpp             sourceutil.cpp
@@ -152,6 +155,7 @@ SOURCES += signalmonitorvalue.cpp
 SOURCES += livetvchain.cpp          playgroup.cpp
 SOURCES += channelsettings.cpp
 SOURCES += previewgenerator.cpp     previewgeneratorqueue.cpp
+SOURCES += previewstrip.cpp        previewstripbuilder.cpp
 SOURCES += transporteditor.cpp
 SOURCES += restoredata.cpp
 SOURCES += channelgroup.cpp
@@ -261,6 +265,7 @@ HEADERS += captions/srtwriter.h
 SOURCES += captions/srtwriter.cpp
 
 # audio
+HEADERS += audio/audioanalyser.h
 HEADERS += audio/audioconvert.h
 HEADERS += audio/audiooutput.h
 HEADERS += audio/audiooutputbase.h
@@ -276,6 +281,7 @@ HEADERS += audio/spdifencoder.h
 HEADERS += audio/visualization.h
 HEADERS += audio/volumebase.h
 
+SOURCES += audio/audioanalyser.cpp
 SOURCES += audio/audioconvert.cpp
 SOURCES += audio/audiooutput.cpp
 SOURCES += audio/audiooutputbase.cpp
@@ -376,7 +382,13 @@ inc2.files += visualisations/goom/v3d.h
 
 INSTALLS += inc2
 
+inc4.path = $${PREFIX}/include/mythtv/libmythtv/visualisations
+inc4.files = visualisations/visualrenderer.h
+
+INSTALLS += inc4
+
 inc3.path = $${PREFIX}/include/mythtv/libmythtv/audio
+inc3.files += audio/audioanalyser.h
 #inc3.files += audio/audioconvert.h
 inc3.files += audio/audiooutput.h
 inc3.files += audio/audiooutputsettings.h
@@ -563,6 +575,7 @@ using_frontend {
     HEADERS += visualisations/videovisual.h
     HEADERS += visualisations/videovisualdefs.h
     HEADERS += visualisations/videovisualspectrum.h
+    HEADERS += visualisations/visualrenderer.h
     HEADERS += mythdeinterlacer.h
     HEADERS += mythinteropgpu.h
     SOURCES += mythvideoout.cpp
@@ -577,6 +590,7 @@ using_frontend {
     SOURCES += visualisations/audiooutputgraph.cpp
     SOURCES += visualisations/videovisual.cpp
     SOURCES += visualisations/videovisualspectrum.cpp
+    SOURCES += visualisations/visualrenderer.cpp
     SOURCES += mythdeinterlacer.cpp
     SOURCES += mythinteropgpu.cpp
 
@@ -874,7 +888,9 @@ using_backend {
 
     # TVRec stuff
     HEADERS += tv_rec.h                    recordingquality.h
+    HEADERS += channelchangestats.h        standbytuner.h
     SOURCES += tv_rec.cpp                  recordingquality.cpp
+    SOURCES += channelchangestats.cpp      standbytuner.cpp
 
     # Recorder base and util classes
     HEADERS += recorders/recorderbase.h
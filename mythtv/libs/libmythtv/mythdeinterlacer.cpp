@@ -1,13 +1,17 @@
 // MythTV
 #include "libmythbase/mythconfig.h"
 #include "libmythbase/mythlogging.h"
+#include "libmythbase/mthread.h"
 
 #include "mythavutil.h"
 #include "mythdeinterlacer.h"
 #include "mythvideoprofile.h"
 
 #include <algorithm>
+#include <cstdlib>
+#include <functional>
 #include <thread>
+#include <vector>
 
 extern "C" {
 #include "libavfilter/buffersrc.h"
@@ -15,6 +19,8 @@ extern "C" {
 #include "libavutil/cpu.h"
 }
 
+#include <QMutex>
+#include <QWaitCondition>
 #include <QtGlobal>
 #if QT_VERSION >= QT_VERSION_CHECK(6,5,0)
 #include <QtProcessorDetection>
@@ -30,6 +36,121 @@ static const bool s_haveSIMD = av_get_cpu_flags() & AV_CPU_FLAG_NEON;
 
 #define LOC QString("MythDeint: ")
 
+/*! \class MythDeintSlices
+ * \brief A small pool of threads that deinterlace a frame in horizontal slices.
+ *
+ * The calling thread takes the first slice, so a pool of N slices has N - 1
+ * workers. Run() returns once every slice is done.
+*/
+class MythDeintSlices
+{
+  public:
+    using Job = std::function<void(uint Slice, uint Slices)>;
+
+    explicit MythDeintSlices(uint Slices);
+   ~MythDeintSlices();
+    void Run(const Job &Work);
+
+  private:
+    Q_DISABLE_COPY(MythDeintSlices)
+
+    class Worker : public MThread
+    {
+      public:
+        Worker(MythDeintSlices *Parent, uint Slice)
+          : MThread(QString("DeintSlice%1").arg(Slice)),
+            m_parent(Parent),
+            m_slice(Slice)
+        {
+        }
+
+      protected:
+        void run() override
+        {
+            RunProlog();
+            m_parent->Work(m_slice);
+            RunEpilog();
+        }
+
+      private:
+        MythDeintSlices *m_parent;
+        uint             m_slice;
+    };
+
+    void Work(uint Slice);
+
+    uint                 m_count;
+    QMutex               m_lock;
+    QWaitCondition       m_start;
+    QWaitCondition       m_done;
+    Job                  m_job;
+    uint64_t             m_generation { 0 };
+    uint                 m_pending    { 0 };
+    bool                 m_quit       { false };
+    std::vector<Worker*> m_workers;
+};
+
+MythDeintSlices::MythDeintSlices(uint Slices)
+  : m_count(std::max(1U, Slices))
+{
+    for (uint slice = 1; slice < m_count; ++slice)
+    {
+        m_workers.push_back(new Worker(this, slice));
+        m_workers.back()->start();
+    }
+}
+
+MythDeintSlices::~MythDeintSlices()
+{
+    m_lock.lock();
+    m_quit = true;
+    m_start.wakeAll();
+    m_lock.unlock();
+    for (auto * worker : m_workers)
+    {
+        worker->wait();
+        delete worker;
+    }
+}
+
+void MythDeintSlices::Run(const Job &Work)
+{
+    m_lock.lock();
+    m_job = Work;
+    m_pending = static_cast<uint>(m_workers.size());
+    m_generation++;
+    m_start.wakeAll();
+    m_lock.unlock();
+
+    Work(0, m_count);
+
+    QMutexLocker locker(&m_lock);
+    while (m_pending)
+        m_done.wait(&m_lock);
+}
+
+void MythDeintSlices::Work(uint Slice)
+{
+    QMutexLocker locker(&m_lock);
+    uint64_t done = 0;
+    while (true)
+    {
+        while (!m_quit && (m_generation == done))
+            m_start.wait(&m_lock);
+        if (m_quit)
+            return;
+        done = m_generation;
+
+        // m_job is left alone until every slice is done
+        locker.unlock();
+        m_job(Slice, m_count);
+        locker.relock();
+
+        if (--m_pending == 0)
+            m_done.wakeAll();
+    }
+}
+
 /*! \class MythDeinterlacer
  * \brief Handles software based deinterlacing of video frames.
  *
@@ -38,10 +159,14 @@ static const bool s_haveSIMD = av_get_cpu_flags() & AV_CPU_FLAG_NEON;
  * quality and using single or double frame rate.
  *
  * The following deinterlacers are used:
- * Basic - onefield/bob using libswcale
- * Medium - linearblend with custom code (SSE2 and Neon assisted where available)
+ * Basic - onefield/bob line doubling
+ * Medium - motion adaptive linearblend with custom code (SSE2 and Neon assisted
+ * where available)
  * High - libavfilter's yadif (with multithreading)
  *
+ * Basic and Medium split each frame into horizontal slices, run on a small
+ * pool of threads sized from MythVideoProfile::GetMaxCPUs.
+ *
  * \note libavfilter frame doubling filters expect frames to be presented
  * in the correct order and will break if they do not receive a frame followed
  * by the retrieval of 2 'fields'.
@@ -114,7 +239,7 @@ void MythDeinterlacer::Filter(MythVideoFrame *Frame, FrameScanType Scan,
     }
 
     // libavfilter will not deinterlace NV12 frames. Allow shaders in this case.
-    // libswscale (for bob/onefield) is fine, as is our linearblend.
+    // Our onefield/bob and linearblend are fine.
     if ((deinterlacer == DEINT_HIGH) && MythVideoFrame::FormatIsNV12(Frame->m_type))
     {
         Cleanup();
@@ -273,14 +398,32 @@ void MythDeinterlacer::Filter(MythVideoFrame *Frame, FrameScanType Scan,
     av_frame_unref(m_frame);
 }
 
+
+/// Deinterlace Frames with at most Threads threads. 0, the default, uses
+/// MythVideoProfile::GetMaxCPUs. Takes effect when the deinterlacer is next
+/// (re)initialised.
+void MythDeinterlacer::SetMaxThreads(uint Threads)
+{
+    m_maxThreads = Threads;
+}
+
+uint MythDeinterlacer::GetThreads(MythVideoProfile *Profile) const
+{
+    uint threads = m_maxThreads;
+    if (!threads && Profile)
+        threads = std::min(Profile->GetMaxCPUs(), std::max(1U, std::thread::hardware_concurrency()));
+    auto maxthreads = static_cast<uint>(std::max(1, m_height / kMinSliceRows));
+    return std::clamp(threads, 1U, maxthreads);
+}
+
 void MythDeinterlacer::Cleanup()
 {
-    if (m_graph || m_swsContext)
+    if (m_deintType != DEINT_NONE)
         LOG(VB_PLAYBACK, LOG_INFO, LOC + "Removing CPU deinterlacer");
 
     avfilter_graph_free(&m_graph);
-    sws_freeContext(m_swsContext);
-    m_swsContext = nullptr;
+    delete m_slices;
+    m_slices = nullptr;
     m_discontinuityCounter = 0;
     m_autoFieldOrder = false;
     m_lastFieldChange = 0;
@@ -291,6 +434,10 @@ void MythDeinterlacer::Cleanup()
         delete m_bobFrame;
         m_bobFrame = nullptr;
     }
+    delete m_lastFrame;
+    m_lastFrame = nullptr;
+    m_cached    = false;
+    m_haveLast  = false;
 
     m_deintType = DEINT_NONE;
 }
@@ -320,15 +467,11 @@ bool MythDeinterlacer::Initialise(MythVideoFrame *Frame, MythDeintType Deinterla
         m_deintType  = Deinterlacer;
         m_doubleRate = DoubleRate;
         m_topFirst   = TopFieldFirst;
-        if (Deinterlacer == DEINT_BASIC)
-        {
-            m_swsContext = sws_getCachedContext(m_swsContext, m_width, m_height >> 1, m_inputFmt,
-                                                m_width, m_height, m_inputFmt, SWS_FAST_BILINEAR,
-                                                nullptr, nullptr, nullptr);
-            if (m_swsContext == nullptr)
-                return false;
-        }
-        LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("Using deinterlacer '%1'").arg(name));
+        uint threads = GetThreads(Profile);
+        if (threads > 1)
+            m_slices = new MythDeintSlices(threads);
+        LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("Using deinterlacer '%1' (%2 threads)")
+            .arg(name).arg(threads));
         return true;
     }
 
@@ -344,7 +487,11 @@ bool MythDeinterlacer::Initialise(MythVideoFrame *Frame, MythDeintType Deinterla
         return false;
 
     uint threads = 1;
-    if (Profile)
+    if (m_maxThreads)
+    {
+        threads = m_maxThreads;
+    }
+    else if (Profile)
     {
         threads = std::clamp(Profile->GetMaxCPUs(), 1U, std::max(8U, std::thread::hardware_concurrency()));
     }
@@ -393,85 +540,162 @@ bool MythDeinterlacer::Initialise(MythVideoFrame *Frame, MythDeintType Deinterla
     return false;
 }
 
-bool MythDeinterlacer::SetUpCache(MythVideoFrame *Frame)
+/// Make sure Cache is a frame the size and layout of Frame.
+bool MythDeinterlacer::SetUpCache(MythVideoFrame *Frame, MythVideoFrame *&Cache)
 {
     if (!Frame)
         return false;
 
-    if (m_bobFrame && !(m_bobFrame->m_bufferSize == Frame->m_bufferSize) && (m_bobFrame->m_width == Frame->m_width) &&
-                        (m_bobFrame->m_height == Frame->m_height) && (m_bobFrame->m_type == Frame->m_type))
+    if (Cache && ((Cache->m_bufferSize != Frame->m_bufferSize) || (Cache->m_width != Frame->m_width) ||
+                  (Cache->m_height != Frame->m_height) || (Cache->m_type != Frame->m_type)))
     {
-        delete m_bobFrame;
-        m_bobFrame = nullptr;
+        delete Cache;
+        Cache = nullptr;
+        m_cached   = false;
+        m_haveLast = false;
     }
 
-    if (!m_bobFrame)
+    if (!Cache)
     {
-        m_bobFrame = new MythVideoFrame(Frame->m_type, MythVideoFrame::GetAlignedBuffer(Frame->m_bufferSize),
-                                        Frame->m_bufferSize, Frame->m_width, Frame->m_height);
+        Cache = new MythVideoFrame(Frame->m_type, MythVideoFrame::GetAlignedBuffer(Frame->m_bufferSize),
+                                   Frame->m_bufferSize, Frame->m_width, Frame->m_height);
         LOG(VB_PLAYBACK, LOG_INFO, "Created new 'bob' cache frame");
     }
 
-    return m_bobFrame && m_bobFrame->m_buffer != nullptr;
+    // The whole buffer is copied, so the planes must be where Frame has them
+    Cache->m_pitches = Frame->m_pitches;
+    Cache->m_offsets = Frame->m_offsets;
+    return Cache->m_buffer != nullptr;
 }
 
-void MythDeinterlacer::OneField(MythVideoFrame *Frame, FrameScanType Scan)
+/// Run Job(Slice, Slices) for every slice of the frame, on the worker pool if
+/// there is one.
+template <typename F>
+void MythDeinterlacer::RunSlices(F Job)
 {
-    if (!m_swsContext)
-        return;
-
-    // we need a frame for caching - both to preserve the second field if
-    // needed and ensure we are not filtering in place (i.e. from src to src).
-    if (!SetUpCache(Frame))
-        return;
+    if (m_slices)
+        m_slices->Run(Job);
+    else
+        Job(0, 1);
+}
 
-    // copy/cache on first pass
-    if (kScan_Interlaced == Scan)
-        memcpy(m_bobFrame->m_buffer, Frame->m_buffer, m_bobFrame->m_bufferSize);
+/// The [first, last) range of Slice when Count items are shared between Slices.
+static inline std::pair<int,int> SliceRange(int Count, uint Slice, uint Slices)
+{
+    return { static_cast<int>((static_cast<int64_t>(Count) * Slice) / Slices),
+             static_cast<int>((static_cast<int64_t>(Count) * (Slice + 1)) / Slices) };
+}
 
-    // Convert VideoFrame to AVFrame - no copy
-    AVFrame dstframe;
-    if ((MythAVUtil::FillAVFrame(m_frame, m_bobFrame, m_inputFmt) < 1) ||
-        (MythAVUtil::FillAVFrame(&dstframe, Frame, m_inputFmt) < 1))
+/// One plane of the source, the frame before it and the destination.
+struct DeintPlane
+{
+    const unsigned char *m_src;
+    const unsigned char *m_last;
+    unsigned char       *m_dst;
+    int                  m_bytes;  ///< of one row
+    int                  m_height;
+    int                  m_pitch;  ///< of both m_src and m_last
+    int                  m_dstPitch;
+
+    const unsigned char* Src (int Row) const { return m_src  + (Row * static_cast<ptrdiff_t>(m_pitch)); }
+    const unsigned char* Last(int Row) const { return m_last + (Row * static_cast<ptrdiff_t>(m_pitch)); }
+    unsigned char*       Dst (int Row) const { return m_dst  + (Row * static_cast<ptrdiff_t>(m_dstPitch)); }
+};
+
+/*! \brief Bob line doubling of rows [2*FirstPair, 2*LastPair).
+ *
+ * Each row of the missing field becomes a copy of its neighbour in the kept
+ * field. memcpy is as fast a vectorised copy as we could write. Copy also
+ * restores the kept field, which the first field of a double rate frame
+ * wrote over.
+*/
+static void Double(const DeintPlane &Plane, int FirstPair, int LastPair, bool Top, bool Copy)
+{
+    auto bytes = static_cast<size_t>(Plane.m_bytes);
+    for (int pair = FirstPair; pair < LastPair; ++pair)
     {
-        LOG(VB_GENERAL, LOG_ERR, LOC + "Error converting frame");
-        return;
+        int kept    = (2 * pair) + (Top ? 0 : 1);
+        int missing = (2 * pair) + (Top ? 1 : 0);
+        if (Copy && kept < Plane.m_height)
+            memcpy(Plane.Dst(kept), Plane.Src(kept), bytes);
+        if (missing >= Plane.m_height)
+            continue;
+        // the last row of an odd height plane has no kept row below it
+        if (kept >= Plane.m_height)
+            kept = missing - 1;
+        memcpy(Plane.Dst(missing), Plane.Src(kept), bytes);
     }
+}
 
-    bool topfield   = Scan == kScan_Interlaced ? m_topFirst : !m_topFirst;
-    dstframe.width  = Frame->m_width;
-    dstframe.height = Frame->m_height;
-    dstframe.format = Frame->m_pixFmt;
-
-    m_frame->width  = m_bobFrame->m_width;
-    m_frame->format = m_bobFrame->m_pixFmt;
-
-    // Fake the frame height and stride to simulate a single field
-    m_frame->height = Frame->m_height >> 1;
-    m_frame->flags &= ~AV_FRAME_FLAG_INTERLACED;
-    uint nbplanes = MythVideoFrame::GetNumPlanes(m_inputType);
-    for (uint i = 0; i < nbplanes; i++)
+/// The rows around one missing row, in this frame and the one before it.
+struct DeintRows
+{
+    const unsigned char *m_above;
+    const unsigned char *m_current;
+    const unsigned char *m_below;
+    const unsigned char *m_lastAbove;
+    const unsigned char *m_lastCurrent;
+    const unsigned char *m_lastBelow;
+};
+
+using MotionRow = void(*)(const DeintRows &Rows, unsigned char *Dst, int Bytes, int Threshold);
+
+/// Weave the pixels of a missing row that are still, interpolate those that moved.
+template <typename T>
+static void MotionRowC(const DeintRows &Rows, unsigned char *Dst, int Bytes, int Threshold)
+{
+    auto sample = [](const unsigned char *Row, int Index)
+        { return static_cast<int>(reinterpret_cast<const T*>(Row)[Index]); };
+    auto *dst = reinterpret_cast<T*>(Dst);
+    int samples = Bytes / static_cast<int>(sizeof(T));
+    for (int i = 0; i < samples; ++i)
     {
-        if (!topfield)
-            m_frame->data[i] = m_frame->data[i] + m_frame->linesize[i];
-        m_frame->linesize[i] = m_frame->linesize[i] << 1;
+        int above   = sample(Rows.m_above, i);
+        int current = sample(Rows.m_current, i);
+        int below   = sample(Rows.m_below, i);
+        bool still  = (std::abs(above   - sample(Rows.m_lastAbove, i))   <= Threshold) &&
+                      (std::abs(current - sample(Rows.m_lastCurrent, i)) <= Threshold) &&
+                      (std::abs(below   - sample(Rows.m_lastBelow, i))   <= Threshold);
+        dst[i] = static_cast<T>(still ? current : (above + below + 1) >> 1);
     }
+}
 
-    // and scale to full height
-    int result = sws_scale(m_swsContext, m_frame->data, m_frame->linesize, 0, m_frame->height,
-                           dstframe.data, dstframe.linesize);
-
-    if (result != Frame->m_height)
+/*! \brief Motion adaptive deinterlacing of rows [2*FirstPair, 2*LastPair).
+ *
+ * A pixel of the missing field is kept (woven) if neither it nor the kept
+ * pixels above and below it have changed by more than Threshold since the
+ * last frame, and otherwise interpolated from those above and below. Still
+ * areas keep their full vertical resolution, moving ones don't comb.
+*/
+static void Motion(MotionRow Row, const DeintPlane &Plane, int FirstPair, int LastPair,
+                   bool Top, bool Copy, int Threshold)
+{
+    auto bytes = static_cast<size_t>(Plane.m_bytes);
+    for (int pair = FirstPair; pair < LastPair; ++pair)
     {
-        LOG(VB_GENERAL, LOG_INFO, LOC + QString("Error scaling frame: height %1 expected %2")
-            .arg(result).arg(Frame->m_height));
+        int kept    = (2 * pair) + (Top ? 0 : 1);
+        int missing = (2 * pair) + (Top ? 1 : 0);
+        if (Copy && kept < Plane.m_height)
+            memcpy(Plane.Dst(kept), Plane.Src(kept), bytes);
+        if (missing >= Plane.m_height)
+            continue;
+        // weave the edge rows, they only have a neighbour on one side
+        if ((missing < 1) || (missing + 1 >= Plane.m_height))
+        {
+            if (Copy)
+                memcpy(Plane.Dst(missing), Plane.Src(missing), bytes);
+            continue;
+        }
+        DeintRows rows { Plane.Src(missing - 1),  Plane.Src(missing),  Plane.Src(missing + 1),
+                         Plane.Last(missing - 1), Plane.Last(missing), Plane.Last(missing + 1) };
+        Row(rows, Plane.Dst(missing), Plane.m_bytes, Threshold);
     }
-    Frame->m_alreadyDeinterlaced = true;
 }
 
+/// Average of 4 packed bytes, rounded up as _mm_avg_epu8 and vrhaddq_u8 do
 inline static uint32_t avg(uint32_t A, uint32_t B)
 {
-    return (((A ^ B) & 0xFEFEFEFEUL) >> 1) + (A & B);
+    return (A | B) - (((A ^ B) & 0xFEFEFEFEUL) >> 1);
 }
 
 // Optimised version with 4x4 alignment
@@ -519,6 +743,55 @@ static inline void BlendC4x4(unsigned char *Src, int Width, int FirstRow, int La
     }
 }
 
+// 10/12/16bit version of BlendC4x4
+static inline void BlendC16x4(unsigned char *Src, int Width, int FirstRow, int LastRow, int Pitch,
+                              unsigned char *Dst, int DstPitch, bool Second)
+{
+    int srcpitch = Pitch << 1;
+    int dstpitch = DstPitch << 1;
+    int maxrows  = LastRow - 3;
+
+    unsigned char *above   = Src + ((FirstRow - 1) * static_cast<ptrdiff_t>(Pitch));
+    unsigned char *dest1   = Dst + (FirstRow * static_cast<ptrdiff_t>(DstPitch));
+    unsigned char *middle  = above + srcpitch;
+    unsigned char *dest2   = dest1 + dstpitch;
+    unsigned char *below   = middle + srcpitch;
+    unsigned char *dstcpy1 = Dst + ((FirstRow - 1) * static_cast<ptrdiff_t>(DstPitch));
+    unsigned char *dstcpy2 = dstcpy1 + dstpitch;
+
+    srcpitch <<= 1;
+    dstpitch <<= 1;
+
+    auto blend = [](unsigned char *Dest, const unsigned char *A, const unsigned char *B, int Samples)
+    {
+        auto *dest = reinterpret_cast<uint16_t*>(Dest);
+        const auto *a = reinterpret_cast<const uint16_t*>(A);
+        const auto *b = reinterpret_cast<const uint16_t*>(B);
+        for (int i = 0; i < Samples; ++i)
+            dest[i] = static_cast<uint16_t>((a[i] + b[i] + 1) >> 1);
+    };
+
+    // 4 rows per pass
+    for (int row = FirstRow; row < maxrows; row += 4)
+    {
+        if (Second)
+        {
+            // On second pass, copy over the original, current field
+            memcpy(dstcpy1, above,  static_cast<size_t>(DstPitch));
+            memcpy(dstcpy2, middle, static_cast<size_t>(DstPitch));
+            dstcpy1 += dstpitch;
+            dstcpy2 += dstpitch;
+        }
+        blend(dest1, above, middle, Width >> 1);
+        blend(dest2, middle, below, Width >> 1);
+        above  += srcpitch;
+        middle += srcpitch;
+        below  += srcpitch;
+        dest1  += dstpitch;
+        dest2  += dstpitch;
+    }
+}
+
 #if defined(Q_PROCESSOR_X86_64) || HAVE_INTRINSICS_NEON
 // SIMD optimised version with 16x4 alignment
 static inline void BlendSIMD16x4(unsigned char *Src, int Width, int FirstRow, int LastRow, int Pitch,
@@ -629,74 +902,249 @@ static inline void BlendSIMD8x4(unsigned char *Src, int Width, int FirstRow, int
         dest2  += dstpitch;
     }
 }
+
+// SIMD version of MotionRowC<uint8_t>, 16 pixels at a time
+static void MotionRowSIMD16(const DeintRows &Rows, unsigned char *Dst, int Bytes, int Threshold)
+{
+#ifdef Q_PROCESSOR_X86_64
+    __m128i zero      = _mm_setzero_si128();
+    __m128i threshold = _mm_set1_epi8(static_cast<char>(Threshold));
+    auto still = [&](__m128i A, __m128i B)
+    {
+        __m128i diff = _mm_or_si128(_mm_subs_epu8(A, B), _mm_subs_epu8(B, A));
+        return _mm_cmpeq_epi8(_mm_subs_epu8(diff, threshold), zero);
+    };
+#endif
+#if HAVE_INTRINSICS_NEON
+    uint8x16_t threshold = vdupq_n_u8(static_cast<uint8_t>(Threshold));
+#endif
+    for (int col = 0; col < Bytes; col += 16)
+    {
+#ifdef Q_PROCESSOR_X86_64
+        __m128i above   = *reinterpret_cast<const __m128i*>(&Rows.m_above[col]);
+        __m128i current = *reinterpret_cast<const __m128i*>(&Rows.m_current[col]);
+        __m128i below   = *reinterpret_cast<const __m128i*>(&Rows.m_below[col]);
+        __m128i mask = _mm_and_si128(still(above, *reinterpret_cast<const __m128i*>(&Rows.m_lastAbove[col])),
+                       _mm_and_si128(still(current, *reinterpret_cast<const __m128i*>(&Rows.m_lastCurrent[col])),
+                                     still(below, *reinterpret_cast<const __m128i*>(&Rows.m_lastBelow[col]))));
+        *reinterpret_cast<__m128i*>(&Dst[col]) =
+                _mm_or_si128(_mm_and_si128(mask, current), _mm_andnot_si128(mask, _mm_avg_epu8(above, below)));
+#endif
+#if HAVE_INTRINSICS_NEON
+        uint8x16_t above   = *reinterpret_cast<const uint8x16_t*>(&Rows.m_above[col]);
+        uint8x16_t current = *reinterpret_cast<const uint8x16_t*>(&Rows.m_current[col]);
+        uint8x16_t below   = *reinterpret_cast<const uint8x16_t*>(&Rows.m_below[col]);
+        uint8x16_t mask = vandq_u8(vcleq_u8(vabdq_u8(above, *reinterpret_cast<const uint8x16_t*>(&Rows.m_lastAbove[col])), threshold),
+                          vandq_u8(vcleq_u8(vabdq_u8(current, *reinterpret_cast<const uint8x16_t*>(&Rows.m_lastCurrent[col])), threshold),
+                                   vcleq_u8(vabdq_u8(below, *reinterpret_cast<const uint8x16_t*>(&Rows.m_lastBelow[col])), threshold)));
+        *reinterpret_cast<uint8x16_t*>(&Dst[col]) = vbslq_u8(mask, current, vrhaddq_u8(above, below));
 #endif
+    }
+}
 
-void MythDeinterlacer::Blend(MythVideoFrame *Frame, FrameScanType Scan)
+// SIMD version of MotionRowC<uint16_t>, 8 pixels at a time
+static void MotionRowSIMD8(const DeintRows &Rows, unsigned char *Dst, int Bytes, int Threshold)
 {
-    if (Frame->m_height < 16 || Frame->m_width < 16)
-        return;
+#ifdef Q_PROCESSOR_X86_64
+    __m128i zero      = _mm_setzero_si128();
+    __m128i threshold = _mm_set1_epi16(static_cast<int16_t>(Threshold));
+    auto still = [&](__m128i A, __m128i B)
+    {
+        __m128i diff = _mm_or_si128(_mm_subs_epu16(A, B), _mm_subs_epu16(B, A));
+        return _mm_cmpeq_epi16(_mm_subs_epu16(diff, threshold), zero);
+    };
+#endif
+#if HAVE_INTRINSICS_NEON
+    uint16x8_t threshold = vdupq_n_u16(static_cast<uint16_t>(Threshold));
+#endif
+    for (int col = 0; col < Bytes; col += 16)
+    {
+#ifdef Q_PROCESSOR_X86_64
+        __m128i above   = *reinterpret_cast<const __m128i*>(&Rows.m_above[col]);
+        __m128i current = *reinterpret_cast<const __m128i*>(&Rows.m_current[col]);
+        __m128i below   = *reinterpret_cast<const __m128i*>(&Rows.m_below[col]);
+        __m128i mask = _mm_and_si128(still(above, *reinterpret_cast<const __m128i*>(&Rows.m_lastAbove[col])),
+                       _mm_and_si128(still(current, *reinterpret_cast<const __m128i*>(&Rows.m_lastCurrent[col])),
+                                     still(below, *reinterpret_cast<const __m128i*>(&Rows.m_lastBelow[col]))));
+        *reinterpret_cast<__m128i*>(&Dst[col]) =
+                _mm_or_si128(_mm_and_si128(mask, current), _mm_andnot_si128(mask, _mm_avg_epu16(above, below)));
+#endif
+#if HAVE_INTRINSICS_NEON
+        uint16x8_t above   = *reinterpret_cast<const uint16x8_t*>(&Rows.m_above[col]);
+        uint16x8_t current = *reinterpret_cast<const uint16x8_t*>(&Rows.m_current[col]);
+        uint16x8_t below   = *reinterpret_cast<const uint16x8_t*>(&Rows.m_below[col]);
+        uint16x8_t mask = vandq_u16(vcleq_u16(vabdq_u16(above, *reinterpret_cast<const uint16x8_t*>(&Rows.m_lastAbove[col])), threshold),
+                          vandq_u16(vcleq_u16(vabdq_u16(current, *reinterpret_cast<const uint16x8_t*>(&Rows.m_lastCurrent[col])), threshold),
+                                    vcleq_u16(vabdq_u16(below, *reinterpret_cast<const uint16x8_t*>(&Rows.m_lastBelow[col])), threshold)));
+        *reinterpret_cast<uint16x8_t*>(&Dst[col]) = vbslq_u16(mask, current, vrhaddq_u16(above, below));
+#endif
+    }
+}
+#endif
 
+void MythDeinterlacer::OneField(MythVideoFrame *Frame, FrameScanType Scan)
+{
+    // Both fields of a double rate frame come from the same input, so cache
+    // it on the first pass - which writes over the field the second wants.
     bool second = false;
     MythVideoFrame *src = Frame;
-
     if (m_doubleRate)
     {
-        if (!SetUpCache(Frame))
+        if (!SetUpCache(Frame, m_bobFrame))
             return;
-        // copy/cache on first pass.
         if (kScan_Interlaced == Scan)
+        {
             memcpy(m_bobFrame->m_buffer, Frame->m_buffer, m_bobFrame->m_bufferSize);
-        else
+            m_cached = true;
+        }
+        else if (m_cached)
+        {
             second = true;
-        src = m_bobFrame;
+            src = m_bobFrame;
+        }
+        else
+        {
+            return;
+        }
     }
 
-    bool hidepth = MythVideoFrame::ColorDepth(src->m_type) > 8;
+    bool top = second ? !m_topFirst : m_topFirst;
+    uint count = MythVideoFrame::GetNumPlanes(Frame->m_type);
+    RunSlices([&](uint Slice, uint Slices)
+    {
+        for (uint plane = 0; plane < count; plane++)
+        {
+            DeintPlane deint { src->m_buffer + src->m_offsets[plane], nullptr,
+                               Frame->m_buffer + Frame->m_offsets[plane],
+                               MythVideoFrame::GetPitchForPlane(Frame->m_type, Frame->m_width, plane),
+                               MythVideoFrame::GetHeightForPlane(Frame->m_type, Frame->m_height, plane),
+                               src->m_pitches[plane], Frame->m_pitches[plane] };
+            auto [first, last] = SliceRange((deint.m_height + 1) / 2, Slice, Slices);
+            Double(deint, first, last, top, second);
+        }
+    });
+    Frame->m_alreadyDeinterlaced = true;
+}
+
+/*! \brief Motion adaptive linear blend
+ *
+ * The input is cached on the first pass. It is the source for both fields,
+ * so each can be written straight into Frame, and then becomes the history
+ * the next frame is compared to. Without a history (the first frame, or after
+ * a seek) every pixel is blended.
+*/
+void MythDeinterlacer::Blend(MythVideoFrame *Frame, FrameScanType Scan)
+{
+    if (Frame->m_height < 16 || Frame->m_width < 16)
+        return;
+
+    if (!SetUpCache(Frame, m_bobFrame) || !SetUpCache(Frame, m_lastFrame))
+        return;
+
+    bool second = kScan_Interlaced != Scan;
+    if (!second)
+    {
+        std::swap(m_bobFrame, m_lastFrame);
+        m_haveLast = m_cached && (Frame->m_frameCounter == m_lastFrame->m_frameCounter + 1);
+        memcpy(m_bobFrame->m_buffer, Frame->m_buffer, m_bobFrame->m_bufferSize);
+        m_bobFrame->m_frameCounter = Frame->m_frameCounter;
+        m_cached = true;
+    }
+    else if (!m_cached)
+    {
+        return;
+    }
+
+    MythVideoFrame *src = m_bobFrame;
+    int depth = MythVideoFrame::ColorDepth(src->m_type);
+    bool hidepth = depth > 8;
+    // P010 and P016 keep their samples in the high bits
+    int threshold = kMotionThreshold << (hidepth ? (MythVideoFrame::FormatIsNV12(src->m_type) ? 8 : depth - 8) : 0);
     bool top = second ? !m_topFirst : m_topFirst;
     uint count = MythVideoFrame::GetNumPlanes(src->m_type);
-    for (uint plane = 0; plane < count; plane++)
-    {
-        int  height  = MythVideoFrame::GetHeightForPlane(src->m_type, src->m_height, plane);
-        int firstrow = top ? 1 : 2;
-        bool height4 = (height % 4) == 0;
-        bool width4  = (src->m_pitches[plane] % 4) == 0;
-        // N.B. all frames allocated by MythTV should have 16 byte alignment
-        // for all planes
-#if defined(Q_PROCESSOR_X86_64) || HAVE_INTRINSICS_NEON
-        bool width16 = (src->m_pitches[plane] % 16) == 0;
-        // profiling SSE2 suggests it is usually 4x faster - as expected
-        if (s_haveSIMD && height4 && width16)
+
+    RunSlices([&](uint Slice, uint Slices)
+    {
+        for (uint plane = 0; plane < count; plane++)
         {
-            if (hidepth)
+            DeintPlane deint { src->m_buffer + src->m_offsets[plane],
+                               m_lastFrame->m_buffer + m_lastFrame->m_offsets[plane],
+                               Frame->m_buffer + Frame->m_offsets[plane],
+                               MythVideoFrame::GetPitchForPlane(src->m_type, src->m_width, plane),
+                               MythVideoFrame::GetHeightForPlane(src->m_type, src->m_height, plane),
+                               src->m_pitches[plane], Frame->m_pitches[plane] };
+            // N.B. all frames allocated by MythTV should have 16 byte alignment
+            // for all planes
+#if defined(Q_PROCESSOR_X86_64) || HAVE_INTRINSICS_NEON
+            bool width16 = ((deint.m_pitch % 16) == 0) && ((deint.m_dstPitch % 16) == 0);
+            bool simd    = s_haveSIMD && width16;
+#else
+            [[maybe_unused]] bool simd = false;
+#endif
+
+            if (m_haveLast)
+            {
+                MotionRow row = hidepth ? MotionRowC<uint16_t> : MotionRowC<uint8_t>;
+#if defined(Q_PROCESSOR_X86_64) || HAVE_INTRINSICS_NEON
+                if (simd)
+                    row = hidepth ? MotionRowSIMD8 : MotionRowSIMD16;
+#endif
+                auto [first, last] = SliceRange((deint.m_height + 1) / 2, Slice, Slices);
+                Motion(row, deint, first, last, top, second, threshold);
+                continue;
+            }
+
+            // The blend kernels work 4 rows at a time, so slice in groups of 4
+            int firstrow = top ? 1 : 2;
+            int groups   = (deint.m_height - firstrow) / 4;
+            bool height4 = (deint.m_height % 4) == 0;
+            bool width4  = (deint.m_pitch % 4) == 0;
+            bool blended = false;
+            auto [first, last] = SliceRange(groups, Slice, Slices);
+            int fromrow  = firstrow + (first * 4);
+            int torow    = firstrow + (last * 4) + 3;
+            auto *source = const_cast<unsigned char*>(deint.m_src);
+#if defined(Q_PROCESSOR_X86_64) || HAVE_INTRINSICS_NEON
+            // profiling SSE2 suggests it is usually 4x faster - as expected
+            if (simd && height4)
             {
-                BlendSIMD8x4(src->m_buffer + src->m_offsets[plane],
-                             MythVideoFrame::GetPitchForPlane(src->m_type, src->m_width, plane),
-                             firstrow, height, src->m_pitches[plane],
-                             Frame->m_buffer + Frame->m_offsets[plane], Frame->m_pitches[plane],
-                             second);
+                if (hidepth)
+                {
+                    BlendSIMD8x4(source, deint.m_bytes, fromrow, torow, deint.m_pitch,
+                                 deint.m_dst, deint.m_dstPitch, second);
+                }
+                else
+                {
+                    BlendSIMD16x4(source, deint.m_bytes, fromrow, torow, deint.m_pitch,
+                                  deint.m_dst, deint.m_dstPitch, second);
+                }
+                blended = true;
             }
             else
+#endif
+            if (width4 && height4)
             {
-                BlendSIMD16x4(src->m_buffer + src->m_offsets[plane],
-                              MythVideoFrame::GetWidthForPlane(src->m_type, src->m_width, plane),
-                              firstrow, height, src->m_pitches[plane],
-                              Frame->m_buffer + Frame->m_offsets[plane], Frame->m_pitches[plane],
-                              second);
+                if (hidepth)
+                {
+                    BlendC16x4(source, deint.m_bytes, fromrow, torow, deint.m_pitch,
+                               deint.m_dst, deint.m_dstPitch, second);
+                }
+                else
+                {
+                    BlendC4x4(source, deint.m_bytes, fromrow, torow, deint.m_pitch,
+                              deint.m_dst, deint.m_dstPitch, second);
+                }
+                blended = true;
             }
+
+            // Blend the rows the 4 row kernels don't reach, or all of them if
+            // the plane doesn't suit the kernels. A threshold of -1 never weaves.
+            int pairs = (deint.m_height + 1) / 2;
+            int tail  = blended ? (firstrow + (groups * 4) - 1) / 2 : 0;
+            auto [firsttail, lasttail] = SliceRange(pairs - tail, Slice, Slices);
+            Motion(hidepth ? MotionRowC<uint16_t> : MotionRowC<uint8_t>, deint,
+                   tail + firsttail, tail + lasttail, top, second, -1);
         }
-        else
-#endif
-        // N.B. There is no 10bit support here - but it shouldn't be necessary
-        // as everything should be 16byte aligned and 10/12bit interlaced video
-        // is virtually unheard of.
-        if (width4 && height4 && !hidepth)
-        {
-            BlendC4x4(src->m_buffer + src->m_offsets[plane],
-                      MythVideoFrame::GetWidthForPlane(src->m_type, src->m_width, plane),
-                      firstrow, height, src->m_pitches[plane],
-                      Frame->m_buffer + Frame->m_offsets[plane], Frame->m_pitches[plane],
-                      second);
-        }
-    }
+    });
     Frame->m_alreadyDeinterlaced = true;
 }
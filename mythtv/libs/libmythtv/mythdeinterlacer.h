@@ -4,6 +4,7 @@
 // MythTV
 #include "mythavframe.h"
 
+#include "mythtvexp.h"
 #include "videoouttypes.h"
 #include "mythavutil.h"
 
@@ -13,15 +14,22 @@ extern "C" {
 }
 
 class MythVideoProfile;
+class MythDeintSlices;
 
-class MythDeinterlacer
+class MTV_PUBLIC MythDeinterlacer
 {
   public:
+    /// Rows below which a slice isn't worth another thread
+    static constexpr int kMinSliceRows { 64 };
+    /// Largest change, in 8bit levels, of a pixel that is woven
+    static constexpr int kMotionThreshold { 10 };
+
     MythDeinterlacer() = default;
    ~MythDeinterlacer();
 
     void             Filter       (MythVideoFrame *Frame, FrameScanType Scan,
                                    MythVideoProfile *Profile, bool Force = false);
+    void             SetMaxThreads(uint Threads);
 
   private:
     Q_DISABLE_COPY(MythDeinterlacer)
@@ -31,7 +39,9 @@ class MythDeinterlacer
     inline void      Cleanup      ();
     void             OneField     (MythVideoFrame *Frame, FrameScanType Scan);
     void             Blend        (MythVideoFrame *Frame, FrameScanType Scan);
-    bool             SetUpCache   (MythVideoFrame *Frame);
+    bool             SetUpCache   (MythVideoFrame *Frame, MythVideoFrame *&Cache);
+    uint             GetThreads   (MythVideoProfile *Profile) const;
+    template <typename F> void RunSlices(F Job);
 
     VideoFrameType   m_inputType  { FMT_NONE };
     AVPixelFormat    m_inputFmt   { AV_PIX_FMT_NONE };
@@ -45,7 +55,11 @@ class MythDeinterlacer
     AVFilterContext* m_source     { nullptr };
     AVFilterContext* m_sink       { nullptr };
     MythVideoFrame*  m_bobFrame   { nullptr };
-    SwsContext*      m_swsContext { nullptr };
+    MythVideoFrame*  m_lastFrame  { nullptr };
+    bool             m_cached     { false };
+    bool             m_haveLast   { false };
+    MythDeintSlices* m_slices     { nullptr };
+    uint             m_maxThreads { 0 };
     uint64_t         m_discontinuityCounter { 0 };
     bool             m_autoFieldOrder  { false };
     uint64_t         m_lastFieldChange { 0 };
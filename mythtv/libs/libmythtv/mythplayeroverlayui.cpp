@@ -1,6 +1,13 @@
+#include <algorithm>
 #include <chrono>
+#include <memory>
+#include <utility>
+
+// Qt
+#include <QRunnable>
 
 // MythTV
+#include "libmythbase/mthreadpool.h"
 #include "libmythbase/mythcorecontext.h"
 #include "libmythbase/mythdate.h"
 #include "libmythbase/mythlogging.h"
@@ -8,9 +15,30 @@
 #include "tv_play.h"
 #include "livetvchain.h"
 #include "mythplayeroverlayui.h"
+#include "previewstrip.h"
 
 #define LOC QString("PlayerOverlay: ")
 
+/// Loads a preview strip, which may be on another backend, off the UI thread.
+class PreviewStripLoader : public QRunnable
+{
+  public:
+    PreviewStripLoader(std::shared_ptr<PreviewStrip> Strip, QString Pathname)
+      : m_strip(std::move(Strip)),
+        m_pathname(std::move(Pathname))
+    {
+    }
+
+    void run() override
+    {
+        m_strip->Load(m_pathname);
+    }
+
+  private:
+    std::shared_ptr<PreviewStrip> m_strip;
+    QString m_pathname;
+};
+
 // N.B. Overlay is initialised without a player - it must be set before it can be used
 MythPlayerOverlayUI::MythPlayerOverlayUI(MythMainWindow* MainWindow, TV* Tv, PlayerContext* Context, PlayerFlags Flags)
   : MythPlayerUIBase(MainWindow, Tv, Context, Flags),
@@ -67,6 +95,7 @@ void MythPlayerOverlayUI::UpdateOSDPosition()
         UpdateSliderInfo(info);
         m_osd.SetText(OSD_WIN_STATUS, info.text, kOSDTimeout_Ignore);
         m_osd.SetValues(OSD_WIN_STATUS, info.values, kOSDTimeout_Ignore);
+        UpdateSeekPreview();
     }
     else
     {
@@ -75,6 +104,48 @@ void MythPlayerOverlayUI::UpdateOSDPosition()
     m_osdLock.unlock();
 }
 
+/*! \brief Show the thumbnail of where playback is going in the status window.
+ *
+ * A seek that hasn't been done yet is included, so the thumbnail shows where
+ * a run of skips will land before the decoder gets there.
+*/
+void MythPlayerOverlayUI::UpdateSeekPreview()
+{
+    auto target = static_cast<long long>(m_framesPlayed) + m_ffTime - m_rewindTime;
+    m_osd.SetSeekPreview(static_cast<uint64_t>(std::max(0LL, target)));
+}
+
+/*! \brief The thumbnail from the recording's preview strip nearest to \a Frame.
+ *
+ * The strip is loaded on a pool thread the first time a thumbnail is asked
+ * for, so this returns a null image until it has arrived, or if the
+ * recording has no strip.
+*/
+QImage MythPlayerOverlayUI::GetThumbnail(uint64_t Frame)
+{
+    if (!m_previewStrip)
+    {
+        m_previewStrip = std::make_shared<PreviewStrip>();
+
+        // A Live TV recording is still being written, so it has no strip
+        QString pathname;
+        m_playerCtx->LockPlayingInfo(__FILE__, __LINE__);
+        if (m_playerCtx->m_playingInfo &&
+            m_playerCtx->GetState() != kState_WatchingLiveTV)
+        {
+            pathname = m_playerCtx->m_playingInfo->GetPathname();
+        }
+        m_playerCtx->UnlockPlayingInfo(__FILE__, __LINE__);
+
+        if (!pathname.isEmpty())
+        {
+            MThreadPool::globalInstance()->start(
+                new PreviewStripLoader(m_previewStrip, pathname), "PreviewStripLoad");
+        }
+    }
+    return m_previewStrip->GetThumbnail(Frame);
+}
+
 void MythPlayerOverlayUI::UpdateOSDMessage(const QString& Message)
 {
     UpdateOSDMessage(Message, kOSDTimeout_Med);
@@ -97,6 +168,7 @@ void MythPlayerOverlayUI::SetOSDStatus(const QString& title, OSDTimeout timeout)
     info.text.insert("title", title);
     m_osd.SetText(OSD_WIN_STATUS, info.text, timeout);
     m_osd.SetValues(OSD_WIN_STATUS, info.values, timeout);
+    UpdateSeekPreview();
     m_osdLock.unlock();
 }
 
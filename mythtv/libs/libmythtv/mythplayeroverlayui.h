@@ -1,9 +1,14 @@
 #ifndef MYTHPLAYEROVERLAYUI_H
 #define MYTHPLAYEROVERLAYUI_H
 
+// Std
+#include <memory>
+
 // MythTV
 #include "mythplayeruibase.h"
 
+class PreviewStrip;
+
 class MTV_PUBLIC MythPlayerOverlayUI : public MythPlayerUIBase
 {
     Q_OBJECT
@@ -24,6 +29,7 @@ class MTV_PUBLIC MythPlayerOverlayUI : public MythPlayerUIBase
     OSD* GetOSD()    { return &m_osd; }
     void LockOSD()   { m_osdLock.lock(); }
     void UnlockOSD() { m_osdLock.unlock(); }
+    QImage GetThumbnail(uint64_t Frame);
 
   protected slots:
     void UpdateOSDMessage (const QString& Message);
@@ -41,6 +47,7 @@ class MTV_PUBLIC MythPlayerOverlayUI : public MythPlayerUIBase
     virtual std::chrono::milliseconds GetTotalMilliseconds(bool HonorCutList) const;
     std::chrono::seconds GetSecondsPlayed(bool HonorCutList);
     std::chrono::seconds GetTotalSeconds(bool HonorCutList) const;
+    void UpdateSeekPreview();
 
     OSD    m_osd;
     QRecursiveMutex m_osdLock;
@@ -52,6 +59,7 @@ class MTV_PUBLIC MythPlayerOverlayUI : public MythPlayerUIBase
   private:
     Q_DISABLE_COPY(MythPlayerOverlayUI)
     QTimer m_positionUpdateTimer;
+    std::shared_ptr<PreviewStrip> m_previewStrip;
 };
 
 #endif
@@ -843,7 +843,10 @@ void MythPlayerUI::GetPlaybackData(InfoMap& Map)
         Map.insert("videoframes", frames);
     }
     if (m_decoder)
+    {
         Map["videodecoder"] = m_decoder->GetCodecDecoderName();
+        Map["decodetimings"] = m_decoder->GetStageTimings();
+    }
 
     Map["framerate"] = QString::fromUtf8("%1±%2")
             .arg(static_cast<double>(m_outputJmeter.GetLastFPS()), 0, 'f', 2)
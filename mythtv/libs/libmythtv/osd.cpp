@@ -119,9 +119,9 @@ void OSD::HideAll(bool KeepSubs, MythScreenType* Except, bool DropNotification)
 
 void OSD::LoadWindows()
 {
-    static const std::array<const QString,7> s_defaultWindows {
+    static const std::array<const QString,8> s_defaultWindows {
         OSD_WIN_MESSAGE, OSD_WIN_INPUT, OSD_WIN_PROGINFO, OSD_WIN_BROWSE,
-        OSD_WIN_STATUS, OSD_WIN_PROGEDIT, OSD_WIN_DEBUG };
+        OSD_WIN_STATUS, OSD_WIN_PROGEDIT, OSD_WIN_DEBUG, OSD_WIN_SEEKPREVIEW };
 
     for (const auto & window : s_defaultWindows)
     {
@@ -451,6 +451,35 @@ void OSD::SetGraph(const QString &Window, const QString &Graph, std::chrono::mil
         image->SetImage(mi);
 }
 
+/*! \brief Show the thumbnail of \a Frame from the recording's preview strip.
+ *
+ * The thumbnail has a window of its own, which is only shown while there is
+ * a strip to take it from. It goes with the status or editor window it is
+ * shown for, see HideWindow().
+*/
+void OSD::SetSeekPreview(uint64_t Frame)
+{
+    // Not every theme has one, so don't try to create it each time
+    MythScreenType *win = m_children.value(OSD_WIN_SEEKPREVIEW);
+    if (!win || !m_player)
+        return;
+
+    auto *widget = dynamic_cast<MythUIImage* >(win->GetChild("seekpreview"));
+    QImage thumbnail = m_player->GetThumbnail(Frame);
+    if (!widget || thumbnail.isNull())
+    {
+        if (win->IsVisible())
+            HideWindow(OSD_WIN_SEEKPREVIEW);
+        return;
+    }
+
+    MythImage *image = m_painter->GetFormatImage();
+    image->Assign(thumbnail);
+    widget->SetImage(image);
+    image->DecrRef();
+    win->SetVisible(true);
+}
+
 void OSD::Draw()
 {
     if (m_embedded)
@@ -696,6 +725,9 @@ void OSD::HideWindow(const QString &Window)
 
     SetExpiry(Window, kOSDTimeout_None);
 
+    if (Window == OSD_WIN_STATUS || Window == OSD_WIN_PROGEDIT)
+        HideWindow(OSD_WIN_SEEKPREVIEW);
+
     MythScreenType* screen = m_children.value(Window);
     if ((m_functionalType != kOSDFunctionalType_Default) && screen)
     {
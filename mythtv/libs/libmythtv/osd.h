@@ -33,6 +33,7 @@ static constexpr const char* OSD_WIN_STATUS   { "osd_status"         };
 static constexpr const char* OSD_WIN_DEBUG    { "osd_debug"          };
 static constexpr const char* OSD_WIN_BROWSE   { "browse_info"        };
 static constexpr const char* OSD_WIN_PROGEDIT { "osd_program_editor" };
+static constexpr const char* OSD_WIN_SEEKPREVIEW { "osd_seek_preview" };
 
 static constexpr std::chrono::milliseconds kOSDFadeTime { 1s };
 
@@ -123,6 +124,7 @@ class OSD : public MythMediaOverlay
     void SetValues(const QString &Window, const QHash<QString,float> &Map, OSDTimeout Timeout);
     void SetRegions(const QString &Window, frm_dir_map_t &Map, long long Total);
     void SetGraph(const QString &Window, const QString &Graph, std::chrono::milliseconds Timecode);
+    void SetSeekPreview(uint64_t Frame);
     bool IsWindowVisible(const QString &Window);
 
     bool DialogVisible(const QString& Window = QString());
@@ -0,0 +1,255 @@
+// C++ headers
+#include <algorithm>
+#include <utility>
+
+// Qt headers
+#include <QFile>
+#include <QList>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+// MythTV headers
+#include "libmythbase/mythchrono.h"
+#include "libmythbase/mythlogging.h"
+#include "libmythbase/remotefile.h"
+
+#include "previewstrip.h"
+
+#define LOC QString("PreviewStrip: ")
+
+static bool read_file(const QString &Filename, QByteArray &Data)
+{
+    if (Filename.startsWith("myth://"))
+    {
+        // Don't make the backend complain about strips never made
+        if (!RemoteFile::Exists(Filename))
+            return false;
+        RemoteFile file(Filename, false, false, 0ms);
+        return file.SaveAs(Data);
+    }
+
+    QFile file(Filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    Data = file.readAll();
+    return true;
+}
+
+QString PreviewStrip::IndexFilename(const QString &Pathname)
+{
+    return Pathname + ".strip";
+}
+
+QString PreviewStrip::ImageFilename(const QString &Pathname)
+{
+    return Pathname + ".strip.jpg";
+}
+
+PreviewStrip::PreviewStrip(QSize TileSize, int Columns)
+  : m_tileSize(TileSize),
+    m_columns(std::max(1, Columns))
+{
+}
+
+/// Load the strip of the recording \a Pathname, a local file or a myth:// URL.
+bool PreviewStrip::Load(const QString &Pathname)
+{
+    QByteArray index;
+    QByteArray image;
+    if (!read_file(IndexFilename(Pathname), index) ||
+        !read_file(ImageFilename(Pathname), image))
+    {
+        LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("No preview strip for %1")
+            .arg(Pathname));
+        return false;
+    }
+
+    if (!FromIndex(index))
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC + QString("Bad index %1")
+            .arg(IndexFilename(Pathname)));
+        return false;
+    }
+
+    QImage sprite;
+    if (!sprite.loadFromData(image, "JPG"))
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC + QString("Bad image %1")
+            .arg(ImageFilename(Pathname)));
+        return false;
+    }
+    SetImage(sprite);
+
+    LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("Loaded %1 thumbnails for %2")
+        .arg(GetCount()).arg(Pathname));
+    return IsValid();
+}
+
+/// Write the strip of the local recording \a Pathname. The index is written
+/// last, so the strip is never seen without its image.
+bool PreviewStrip::Save(const QString &Pathname) const
+{
+    QMutexLocker locker(&m_lock);
+
+    QSaveFile image(ImageFilename(Pathname));
+    if (!image.open(QIODevice::WriteOnly) ||
+        !m_image.save(&image, "JPG", 75) || !image.commit())
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Failed to write %1")
+            .arg(image.fileName()));
+        return false;
+    }
+    locker.unlock();
+
+    QSaveFile index(IndexFilename(Pathname));
+    if (!index.open(QIODevice::WriteOnly) ||
+        index.write(ToIndex()) < 0 || !index.commit())
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Failed to write %1")
+            .arg(index.fileName()));
+        return false;
+    }
+    return true;
+}
+
+bool PreviewStrip::FromIndex(const QByteArray &Index)
+{
+    QList<QByteArray> lines = Index.split('\n');
+    if (lines.size() < 3 ||
+        lines[0].trimmed() != QByteArray("MythPreviewStrip ") + QByteArray::number(kVersion))
+        return false;
+
+    QList<QByteArray> tile = lines[1].simplified().split(' ');
+    QList<QByteArray> columns = lines[2].simplified().split(' ');
+    if (tile.size() != 3 || tile[0] != "tile" ||
+        columns.size() != 2 || columns[0] != "columns")
+        return false;
+
+    QSize tileSize(tile[1].toInt(), tile[2].toInt());
+    int cols = columns[1].toInt();
+    if (tileSize.isEmpty() || cols <= 0)
+        return false;
+
+    QVector<Tile> tiles;
+    tiles.reserve(lines.size() - 3);
+    for (qsizetype i = 3; i < lines.size(); ++i)
+    {
+        QList<QByteArray> fields = lines[i].simplified().split(' ');
+        if (fields.size() == 1 && fields[0].isEmpty())
+            continue;
+
+        bool frameOk = false;
+        bool timeOk = false;
+        Tile entry { fields[0].toULongLong(&frameOk),
+                     std::chrono::milliseconds(fields.value(1).toLongLong(&timeOk)) };
+        // The lookup is a binary search, so the frames must be in order
+        if (fields.size() != 2 || !frameOk || !timeOk ||
+            (!tiles.isEmpty() && entry.m_frame <= tiles.back().m_frame))
+            return false;
+        tiles.push_back(entry);
+    }
+
+    QMutexLocker locker(&m_lock);
+    m_tileSize = tileSize;
+    m_columns  = cols;
+    m_tiles    = tiles;
+    return true;
+}
+
+QByteArray PreviewStrip::ToIndex(void) const
+{
+    QMutexLocker locker(&m_lock);
+
+    QByteArray index = QString("MythPreviewStrip %1\ntile %2 %3\ncolumns %4\n")
+        .arg(kVersion).arg(m_tileSize.width()).arg(m_tileSize.height())
+        .arg(m_columns).toLatin1();
+    for (const auto &tile : std::as_const(m_tiles))
+    {
+        index += QByteArray::number(static_cast<qulonglong>(tile.m_frame)) + ' ' +
+                 QByteArray::number(static_cast<qlonglong>(tile.m_time.count())) + '\n';
+    }
+    return index;
+}
+
+void PreviewStrip::SetImage(const QImage &Image)
+{
+    QMutexLocker locker(&m_lock);
+    m_image = Image;
+}
+
+void PreviewStrip::AddTile(uint64_t Frame, std::chrono::milliseconds Time)
+{
+    QMutexLocker locker(&m_lock);
+    m_tiles.push_back({ Frame, Time });
+}
+
+/// True if there are thumbnails and the image holds all of them.
+bool PreviewStrip::IsValid(void) const
+{
+    QMutexLocker locker(&m_lock);
+    if (m_tiles.isEmpty() || m_tileSize.isEmpty() || m_image.isNull())
+        return false;
+    auto rows = (m_tiles.size() + m_columns - 1) / m_columns;
+    return m_image.width()  >= m_columns * m_tileSize.width() &&
+           m_image.height() >= rows * m_tileSize.height();
+}
+
+int PreviewStrip::GetCount(void) const
+{
+    QMutexLocker locker(&m_lock);
+    return static_cast<int>(m_tiles.size());
+}
+
+QSize PreviewStrip::GetTileSize(void) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_tileSize;
+}
+
+int PreviewStrip::GetColumns(void) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_columns;
+}
+
+PreviewStrip::Tile PreviewStrip::GetTile(int Index) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_tiles.value(Index);
+}
+
+/// The last thumbnail at or before \a Frame, the first one if there is none
+/// before it, or -1 if there are no thumbnails.
+int PreviewStrip::FindTile(uint64_t Frame) const
+{
+    QMutexLocker locker(&m_lock);
+    if (m_tiles.isEmpty())
+        return -1;
+
+    auto after = std::upper_bound(m_tiles.cbegin(), m_tiles.cend(), Frame,
+                                  [](uint64_t frame, const Tile &tile)
+                                  { return frame < tile.m_frame; });
+    if (after == m_tiles.cbegin())
+        return 0;
+    return static_cast<int>(std::distance(m_tiles.cbegin(), after) - 1);
+}
+
+QRect PreviewStrip::TileRect(int Index) const
+{
+    QMutexLocker locker(&m_lock);
+    return { (Index % m_columns) * m_tileSize.width(),
+             (Index / m_columns) * m_tileSize.height(),
+             m_tileSize.width(), m_tileSize.height() };
+}
+
+/// The thumbnail for \a Frame, or a null image until a strip is loaded.
+QImage PreviewStrip::GetThumbnail(uint64_t Frame) const
+{
+    if (!IsValid())
+        return {};
+    int index = FindTile(Frame);
+    QRect rect = TileRect(index);
+
+    QMutexLocker locker(&m_lock);
+    return m_image.copy(rect);
+}
@@ -0,0 +1,85 @@
+// -*- Mode: c++ -*-
+#ifndef PREVIEW_STRIP_H
+#define PREVIEW_STRIP_H
+
+// C++ headers
+#include <chrono>
+#include <cstdint>
+
+// Qt headers
+#include <QByteArray>
+#include <QImage>
+#include <QMutex>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+// MythTV headers
+#include "mythtvexp.h"
+
+/** \class PreviewStrip
+ *  \brief Thumbnails of a recording's keyframes, tiled into one image.
+ *
+ *  The strip is made by the preview job (mythpreviewgen --strip) next to
+ *  the recording, as \<recording\>.strip.jpg holding the thumbnails left to
+ *  right, top to bottom, and \<recording\>.strip, a small text index giving
+ *  the frame number and time of each thumbnail:
+ *  \verbatim
+MythPreviewStrip 1
+tile 160 90
+columns 10
+0 0
+300 10010
+...
+\endverbatim
+ *  The player loads both once, after which the thumbnail nearest to any
+ *  frame is just a copy out of the tiled image.
+ */
+class MTV_PUBLIC PreviewStrip
+{
+  public:
+    struct Tile
+    {
+        uint64_t                  m_frame {0};
+        std::chrono::milliseconds m_time  {0};
+    };
+
+    static constexpr int kVersion { 1 };
+    static constexpr int kColumns { 10 };
+
+    static QString IndexFilename(const QString &Pathname);
+    static QString ImageFilename(const QString &Pathname);
+
+    PreviewStrip() = default;
+    PreviewStrip(QSize TileSize, int Columns = kColumns);
+
+    bool Load(const QString &Pathname);
+    bool Save(const QString &Pathname) const;
+
+    bool       FromIndex(const QByteArray &Index);
+    QByteArray ToIndex(void) const;
+
+    void   SetImage(const QImage &Image);
+    void   AddTile(uint64_t Frame, std::chrono::milliseconds Time);
+    bool   IsValid(void) const;
+    int    GetCount(void) const;
+    QSize  GetTileSize(void) const;
+    int    GetColumns(void) const;
+    Tile   GetTile(int Index) const;
+    int    FindTile(uint64_t Frame) const;
+    QRect  TileRect(int Index) const;
+    QImage GetThumbnail(uint64_t Frame) const;
+
+  private:
+    Q_DISABLE_COPY(PreviewStrip)
+
+    /// Load() may run on a pool thread while the player asks for thumbnails
+    mutable QMutex m_lock;
+    QSize          m_tileSize;
+    int            m_columns { kColumns };
+    QVector<Tile>  m_tiles;
+    QImage         m_image;
+};
+
+#endif // PREVIEW_STRIP_H
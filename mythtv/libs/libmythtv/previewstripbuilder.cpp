@@ -0,0 +1,365 @@
+// C++ headers
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+// Qt headers
+#include <QElapsedTimer>
+#include <QFileInfo>
+
+// MythTV headers
+#include "libmythbase/mythlogging.h"
+
+#include "mythavframe.h"
+#include "mythaverror.h"
+#include "previewstrip.h"
+#include "previewstripbuilder.h"
+
+extern "C" {
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+#include "libswscale/swscale.h"
+}
+
+#define LOC QString("PreviewStripBuilder: ")
+
+/// Packets read after a seek before giving up on finding a keyframe
+static constexpr int kMaxPackets { 2000 };
+
+PreviewStripBuilder::PreviewStripBuilder(const ProgramInfo &Program,
+                                         QString Filename)
+  : m_program(Program),
+    m_filename(std::move(Filename))
+{
+}
+
+PreviewStripBuilder::~PreviewStripBuilder()
+{
+    Close();
+}
+
+bool PreviewStripBuilder::Open(void)
+{
+    QByteArray filename = m_filename.toLocal8Bit();
+    int ret = avformat_open_input(&m_format, filename.constData(), nullptr, nullptr);
+    if (ret < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Failed to open %1: %2")
+            .arg(m_filename, av_make_error_stdstring(ret).c_str()));
+        return false;
+    }
+
+    if (avformat_find_stream_info(m_format, nullptr) < 0)
+        LOG(VB_GENERAL, LOG_WARNING, LOC + "Failed to read stream info");
+
+    const AVCodec *codec = nullptr;
+    m_stream = av_find_best_stream(m_format, AVMEDIA_TYPE_VIDEO, -1, -1, &codec, 0);
+    if (m_stream < 0 || !codec)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("No video in %1").arg(m_filename));
+        return false;
+    }
+
+    AVStream *stream = m_format->streams[m_stream];
+    m_codec = avcodec_alloc_context3(codec);
+    if (!m_codec || avcodec_parameters_to_context(m_codec, stream->codecpar) < 0)
+        return false;
+
+    // Only keyframes are wanted, and a thumbnail doesn't need deblocking.
+    // Frame threads would hold each keyframe back for several packets.
+    m_codec->skip_frame       = AVDISCARD_NONKEY;
+    m_codec->skip_loop_filter = AVDISCARD_ALL;
+    m_codec->thread_type      = FF_THREAD_SLICE;
+    m_codec->thread_count     = 0;
+    ret = avcodec_open2(m_codec, codec, nullptr);
+    if (ret < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Failed to open decoder: %1")
+            .arg(av_make_error_stdstring(ret).c_str()));
+        return false;
+    }
+
+    m_fps = m_program.QueryAverageFrameRate() / 1000.0;
+    if (m_fps <= 0.0)
+        m_fps = av_q2d(stream->avg_frame_rate);
+    if (!std::isfinite(m_fps) || m_fps <= 0.0)
+        m_fps = 25.0;
+
+    m_byteSeek = (m_format->iformat->flags & AVFMT_NO_BYTE_SEEK) == 0;
+    return true;
+}
+
+void PreviewStripBuilder::Close(void)
+{
+    sws_freeContext(m_scaler);
+    m_scaler = nullptr;
+    avcodec_free_context(&m_codec);
+    if (m_format)
+        avformat_close_input(&m_format);
+    m_stream = -1;
+}
+
+/// The keyframes to show, from the recording's position map if it has one.
+QVector<PreviewStripBuilder::KeyFrame> PreviewStripBuilder::ChooseKeyFrames(void) const
+{
+    // The same preference as DecoderBase::PosMapFromDb()
+    frm_pos_map_t posMap;
+    uint64_t keyframeDist = 1;
+    m_program.QueryPositionMap(posMap, MARK_GOP_BYFRAME);
+    if (posMap.isEmpty())
+    {
+        m_program.QueryPositionMap(posMap, MARK_GOP_START);
+        keyframeDist = (m_fps > 24 && m_fps < 26) ? 12 : 15;
+    }
+    if (posMap.isEmpty())
+    {
+        m_program.QueryPositionMap(posMap, MARK_KEYFRAME);
+        keyframeDist = 1;
+    }
+
+    uint64_t total = 0;
+    if (!posMap.isEmpty())
+        total = static_cast<uint64_t>(posMap.lastKey()) * keyframeDist;
+    else if (m_format->duration > 0)
+        total = static_cast<uint64_t>(m_format->duration * m_fps / AV_TIME_BASE);
+
+    return SelectKeyFrames(posMap, keyframeDist, total, m_fps, m_byteSeek);
+}
+
+/*! \brief Pick the keyframes for a strip, no closer than kMinInterval and no
+ *         more than kMaxTiles of them.
+ *
+ * \param PosMap       keyframe byte offsets, keyed by frame / \a KeyFrameDist
+ * \param Total        the length of the recording in frames
+ * \param Fps          the frame rate, to space the keyframes in time
+ * \param ByteSeek     false to seek by time even with a position map
+ */
+QVector<PreviewStripBuilder::KeyFrame> PreviewStripBuilder::SelectKeyFrames(
+    const frm_pos_map_t &PosMap, uint64_t KeyFrameDist, uint64_t Total,
+    double Fps, bool ByteSeek)
+{
+    auto interval = std::max(static_cast<uint64_t>(kMinInterval.count() * Fps),
+                             Total / kMaxTiles);
+    interval = std::max<uint64_t>(interval, 1);
+
+    QVector<KeyFrame> keys;
+    if (PosMap.isEmpty() || !ByteSeek)
+    {
+        for (uint64_t frame = 0; frame <= Total && keys.size() < kMaxTiles; frame += interval)
+            keys.push_back({ frame, -1 });
+        return keys;
+    }
+
+    uint64_t next = 0;
+    for (auto it = PosMap.cbegin(); it != PosMap.cend() && keys.size() < kMaxTiles; ++it)
+    {
+        auto frame = static_cast<uint64_t>(it.key()) * KeyFrameDist;
+        if (frame < next)
+            continue;
+        keys.push_back({ frame, it.value() });
+        next = frame + interval;
+    }
+    return keys;
+}
+
+bool PreviewStripBuilder::Seek(const KeyFrame &Key)
+{
+    int ret = 0;
+    if (Key.m_offset >= 0)
+    {
+        ret = av_seek_frame(m_format, -1, Key.m_offset, AVSEEK_FLAG_BYTE);
+    }
+    else
+    {
+        AVStream *stream = m_format->streams[m_stream];
+        int64_t start = (stream->start_time == AV_NOPTS_VALUE) ? 0 : stream->start_time;
+        auto seconds = static_cast<double>(Key.m_frame) / m_fps;
+        int64_t pts = start + static_cast<int64_t>(seconds / av_q2d(stream->time_base));
+        ret = av_seek_frame(m_format, m_stream, pts, AVSEEK_FLAG_BACKWARD);
+    }
+    avcodec_flush_buffers(m_codec);
+
+    if (ret < 0)
+    {
+        LOG(VB_GENERAL, LOG_DEBUG, LOC + QString("Seek to frame %1 failed: %2")
+            .arg(Key.m_frame).arg(av_make_error_stdstring(ret).c_str()));
+        return false;
+    }
+    return true;
+}
+
+/// Decode the first keyframe after the last seek. Everything before it is
+/// dropped unread by the decoder, as is everything after it.
+bool PreviewStripBuilder::DecodeKeyFrame(AVFrame *Frame)
+{
+    AVPacket *packet = av_packet_alloc();
+    if (!packet)
+        return false;
+
+    bool sent = false;
+    bool decoded = false;
+    for (int i = 0; i < kMaxPackets && !decoded; ++i)
+    {
+        if (av_read_frame(m_format, packet) < 0)
+            break;
+        if (packet->stream_index == m_stream &&
+            (sent || (packet->flags & AV_PKT_FLAG_KEY)))
+        {
+            sent |= avcodec_send_packet(m_codec, packet) >= 0;
+            decoded = avcodec_receive_frame(m_codec, Frame) == 0;
+        }
+        av_packet_unref(packet);
+    }
+    av_packet_free(&packet);
+
+    // Drain a decoder still holding the keyframe back for reordering
+    if (sent && !decoded)
+    {
+        avcodec_send_packet(m_codec, nullptr);
+        decoded = avcodec_receive_frame(m_codec, Frame) == 0;
+    }
+    return decoded;
+}
+
+/// Scale \a Frame straight into its place \a Tile in the strip \a Image.
+bool PreviewStripBuilder::Scale(const AVFrame *Frame, QImage &Image, QRect Tile)
+{
+    m_scaler = sws_getCachedContext(m_scaler, Frame->width, Frame->height,
+                                    static_cast<AVPixelFormat>(Frame->format),
+                                    Tile.width(), Tile.height(), AV_PIX_FMT_RGB32,
+                                    SWS_BILINEAR, nullptr, nullptr, nullptr);
+    if (!m_scaler)
+        return false;
+
+    std::array<uint8_t*,4> data
+        { Image.bits() + (Tile.y() * Image.bytesPerLine()) + (Tile.x() * 4),
+          nullptr, nullptr, nullptr };
+    std::array<int,4> linesize { static_cast<int>(Image.bytesPerLine()), 0, 0, 0 };
+    sws_scale(m_scaler, Frame->data, Frame->linesize, 0, Frame->height,
+              data.data(), linesize.data());
+    return true;
+}
+
+/// kTileWidth wide, at the display aspect ratio of a \a Width x \a Height
+/// video with pixels \a SampleAspect wide, or 0 if that isn't known.
+QSize PreviewStripBuilder::TileSize(int Width, int Height, double SampleAspect)
+{
+    if (Width <= 0 || Height <= 0)
+        return { kTileWidth, (kTileWidth * 9) / 16 };
+
+    double aspect = static_cast<double>(Width) / Height;
+    if (SampleAspect > 0.0)
+        aspect *= SampleAspect;
+
+    int tileHeight = static_cast<int>(std::lround(kTileWidth / aspect)) & ~1;
+    return { kTileWidth, std::clamp(tileHeight, 2, kTileWidth * 2) };
+}
+
+/// The size of a strip of \a Count tiles in rows of \a Columns.
+QSize PreviewStripBuilder::ImageSize(QSize TileSize, int Columns, int Count)
+{
+    int rows = (Count + Columns - 1) / Columns;
+    return { Columns * TileSize.width(), rows * TileSize.height() };
+}
+
+/// Build the strip and save it next to the recording.
+bool PreviewStripBuilder::Run(void)
+{
+    if (!QFileInfo(m_filename).isReadable())
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Cannot read %1, the strip must be "
+                                               "made where the recording is stored")
+            .arg(m_filename));
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!Open())
+        return false;
+
+    QVector<KeyFrame> keys = ChooseKeyFrames();
+    if (keys.isEmpty())
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Nothing to show in %1")
+            .arg(m_filename));
+        return false;
+    }
+
+    frm_pos_map_t durMap;
+    m_program.QueryPositionMap(durMap, MARK_DURATION_MS);
+
+    AVStream *stream = m_format->streams[m_stream];
+    AVRational sar = av_guess_sample_aspect_ratio(m_format, stream, nullptr);
+    QSize tileSize = TileSize(stream->codecpar->width, stream->codecpar->height,
+                              (sar.num > 0 && sar.den > 0) ? av_q2d(sar) : 0.0);
+    PreviewStrip strip(tileSize);
+    int columns = strip.GetColumns();
+    QImage image(ImageSize(tileSize, columns, static_cast<int>(keys.size())),
+                 QImage::Format_RGB32);
+    image.fill(Qt::black);
+
+    MythAVFrame frame;
+    if (!frame)
+        return false;
+
+    int64_t start = (stream->start_time == AV_NOPTS_VALUE) ? 0 : stream->start_time;
+    uint64_t last = 0;
+    std::chrono::milliseconds lastTime { 0 };
+    for (const auto &key : std::as_const(keys))
+    {
+        if (!Seek(key) || !DecodeKeyFrame(frame))
+            continue;
+
+        // A seek by time lands on whichever keyframe is before the target
+        uint64_t number = key.m_frame;
+        std::chrono::milliseconds time { 0 };
+        int64_t pts = frame->best_effort_timestamp;
+        if (pts != AV_NOPTS_VALUE)
+        {
+            double seconds = (pts - start) * av_q2d(stream->time_base);
+            time = std::chrono::milliseconds(std::llround(std::max(0.0, seconds) * 1000));
+            if (key.m_offset < 0)
+                number = static_cast<uint64_t>(std::llround(std::max(0.0, seconds) * m_fps));
+        }
+        if (key.m_offset >= 0 || pts == AV_NOPTS_VALUE)
+        {
+            auto fallback = static_cast<int64_t>(number * 1000 / m_fps);
+            time = std::chrono::milliseconds(
+                durMap.value(static_cast<long long>(number), fallback));
+        }
+
+        if (strip.GetCount() > 0 && number <= last)
+            continue;
+        if (!Scale(frame, image, strip.TileRect(strip.GetCount())))
+            continue;
+
+        strip.AddTile(number, time);
+        last = number;
+        lastTime = time;
+        av_frame_unref(frame);
+    }
+    Close();
+
+    if (strip.GetCount() == 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("No keyframes decoded from %1")
+            .arg(m_filename));
+        return false;
+    }
+
+    // Drop the rows left empty by keyframes that couldn't be decoded
+    strip.SetImage(image.copy(QRect(QPoint(0, 0),
+                                    ImageSize(tileSize, columns, strip.GetCount()))));
+    if (!strip.Save(m_filename))
+        return false;
+
+    auto elapsed = std::max<qint64>(timer.elapsed(), 1);
+    LOG(VB_GENERAL, LOG_INFO, LOC +
+        QString("%1 thumbnails of %2 in %3 ms (%4x real time)")
+        .arg(strip.GetCount()).arg(m_filename).arg(elapsed)
+        .arg(static_cast<double>(lastTime.count()) / elapsed, 0, 'f', 1));
+    return true;
+}
@@ -0,0 +1,79 @@
+// -*- Mode: c++ -*-
+#ifndef PREVIEW_STRIP_BUILDER_H
+#define PREVIEW_STRIP_BUILDER_H
+
+// C++ headers
+#include <chrono>
+#include <cstdint>
+
+// Qt headers
+#include <QImage>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QVector>
+
+// MythTV headers
+#include "mythtvexp.h"
+#include "programinfo.h"
+
+struct AVCodecContext;
+struct AVFormatContext;
+struct AVFrame;
+struct SwsContext;
+
+/** \class PreviewStripBuilder
+ *  \brief Makes the PreviewStrip of a recording by decoding only keyframes.
+ *
+ *  Keyframes at least kMinInterval apart are picked from the recording's
+ *  position map, so each thumbnail is found with a single byte seek and
+ *  one keyframe decoded without its loop filter. Recordings without a
+ *  position map fall back to seeking by time. The decoder never sees the
+ *  frames in between, so a strip is made many times faster than real time
+ *  on the CPU alone.
+ */
+class MTV_PUBLIC PreviewStripBuilder
+{
+  public:
+    static constexpr int kTileWidth { 160 };
+    static constexpr int kMaxTiles  { 1000 };
+    static constexpr std::chrono::seconds kMinInterval { 10 };
+
+    struct KeyFrame
+    {
+        uint64_t m_frame  {0};
+        int64_t  m_offset {-1}; ///< byte offset, or -1 to seek by time
+    };
+
+    PreviewStripBuilder(const ProgramInfo &Program, QString Filename);
+   ~PreviewStripBuilder();
+
+    bool Run(void);
+
+    static QVector<KeyFrame> SelectKeyFrames(const frm_pos_map_t &PosMap,
+                                             uint64_t KeyFrameDist, uint64_t Total,
+                                             double Fps, bool ByteSeek);
+    static QSize TileSize(int Width, int Height, double SampleAspect);
+    static QSize ImageSize(QSize TileSize, int Columns, int Count);
+
+  private:
+    Q_DISABLE_COPY(PreviewStripBuilder)
+
+    bool   Open(void);
+    void   Close(void);
+    QVector<KeyFrame> ChooseKeyFrames(void) const;
+    bool   Seek(const KeyFrame &Key);
+    bool   DecodeKeyFrame(AVFrame *Frame);
+    bool   Scale(const AVFrame *Frame, QImage &Image, QRect Tile);
+
+    const ProgramInfo &m_program;
+    QString            m_filename;
+    AVFormatContext   *m_format   { nullptr };
+    AVCodecContext    *m_codec    { nullptr };
+    SwsContext        *m_scaler   { nullptr };
+    int                m_stream   { -1 };
+    double             m_fps      { 0.0 };
+    bool               m_byteSeek { true };
+};
+
+#endif // PREVIEW_STRIP_BUILDER_H
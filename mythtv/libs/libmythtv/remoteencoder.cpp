@@ -620,6 +620,26 @@ bool RemoteEncoder::CheckChannel(const QString& channel)
     return false;
 }
 
+/** \brief Keeps this input on standby on \a channel for the LiveTV
+ *         session on input \a owner, which is about to switch to it.
+ *
+ *  \return true if the input was on standby on the channel for \a owner
+ *  \sa TVRec::ClaimStandby(uint,const QString&),
+ *      EncoderLink::ClaimStandby(uint,const QString&)
+ */
+bool RemoteEncoder::ClaimStandby(uint owner, const QString& channel)
+{
+    QStringList strlist( QString("QUERY_RECORDER %1").arg(m_recordernum) );
+    strlist << "CLAIM_STANDBY";
+    strlist << QString::number(owner);
+    strlist << channel;
+
+    if (SendReceiveStringList(strlist, 1))
+        return strlist[0].toInt() != 0;
+
+    return false;
+}
+
 /** \fn RemoteEncoder::ShouldSwitchToAnotherCard(QString)
  *  \brief Checks if named channel exists on current tuner, or
  *         another tuner.
@@ -67,6 +67,7 @@ class MTV_PUBLIC RemoteEncoder
     std::chrono::milliseconds SetSignalMonitoringRate(std::chrono::milliseconds rate, int notifyFrontend = 1);
     uint GetSignalLockTimeout(const QString& input);
     bool CheckChannel(const QString& channel);
+    bool ClaimStandby(uint owner, const QString& channel);
     bool ShouldSwitchToAnotherCard(const QString& channelid);
     bool CheckChannelPrefix(const QString &prefix, uint &complete_valid_channel_on_rec,
                             bool &is_extra_char_useful, QString &needed_spacer);
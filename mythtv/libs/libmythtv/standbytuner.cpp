@@ -0,0 +1,102 @@
+// MythTV headers
+#include "standbytuner.h"
+
+/// Puts the input on standby on \a channum for input \a owner, or renews
+/// the standby it already holds for it.
+StandbyTuner::Hold StandbyTuner::Set(uint owner, ChannelChangeDirection dir,
+                                     const QString &channum,
+                                     const QDateTime &now)
+{
+    QMutexLocker locker(&m_lock);
+    if (!owner || m_claimed || (m_owner && m_owner != owner))
+        return Hold::kRefused;
+
+    Hold hold = Hold::kKept;
+    if (m_channel != channum)
+        hold = Hold::kRetune;
+    else if (m_direction != dir)
+        hold = Hold::kMoved;
+
+    m_owner     = owner;
+    m_channel   = channum;
+    m_direction = dir;
+    m_release   = false;
+    m_expire    = now.addSecs(kTimeout.count());
+    return hold;
+}
+
+/// Whether the input is on standby for \a owner on channel \a channum.
+bool StandbyTuner::IsHeld(uint owner, const QString &channum) const
+{
+    QMutexLocker locker(&m_lock);
+    return owner && (m_owner == owner) && (m_channel == channum);
+}
+
+/// Keeps the standby for the LiveTV session on \a owner, which is about
+/// to switch to this input and channel \a channum.
+bool StandbyTuner::Claim(uint owner, const QString &channum,
+                         const QDateTime &now)
+{
+    QMutexLocker locker(&m_lock);
+    if (!owner || m_owner != owner || m_channel != channum)
+        return false;
+
+    m_claimed = true;
+    m_release = false;
+    m_expire  = now.addSecs(kClaimTimeout.count());
+    return true;
+}
+
+/// Asks for the standby held for \a owner to end, unless it was claimed.
+/// \return true if the standby is to end
+bool StandbyTuner::Release(uint owner)
+{
+    QMutexLocker locker(&m_lock);
+    if (!owner || m_owner != owner || m_claimed)
+        return false;
+
+    m_release = true;
+    return true;
+}
+
+/// Whether the standby has been released, or has not been renewed in time.
+bool StandbyTuner::IsExpired(const QDateTime &now) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_owner && (m_release || now > m_expire);
+}
+
+void StandbyTuner::Clear(void)
+{
+    QMutexLocker locker(&m_lock);
+    m_owner     = 0;
+    m_channel.clear();
+    m_direction = CHANNEL_DIRECTION_SAME;
+    m_release   = false;
+    m_claimed   = false;
+    m_expire    = QDateTime();
+}
+
+uint StandbyTuner::GetOwner(void) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_owner;
+}
+
+QString StandbyTuner::GetChannel(void) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_channel;
+}
+
+ChannelChangeDirection StandbyTuner::GetDirection(void) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_direction;
+}
+
+bool StandbyTuner::IsClaimed(void) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_claimed;
+}
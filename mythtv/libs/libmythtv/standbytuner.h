@@ -0,0 +1,71 @@
+// -*- Mode: c++ -*-
+#ifndef STANDBY_TUNER_H
+#define STANDBY_TUNER_H
+
+// C++ headers
+#include <cstdint>
+
+// Qt headers
+#include <QDateTime>
+#include <QMutex>
+#include <QString>
+
+// MythTV headers
+#include "libmythbase/mythchrono.h"
+
+#include "mythtvexp.h"
+#include "tv.h"
+
+/** \class StandbyTuner
+ *  \brief The standby an idle input holds for the LiveTV session on
+ *         another input, see TVRec::SetStandbyChannel().
+ *
+ *  The owner is the input the LiveTV session is on. When the frontend
+ *  switches to the standby input it claims it first, so that stopping
+ *  the LiveTV session on the owner, which releases all its standby
+ *  inputs, doesn't retune the input it is about to use. A claim lasts
+ *  until the input is tuned for LiveTV, or kClaimTimeout if that never
+ *  happens.
+ *
+ *  The times are passed in, so that the class can be tested.
+ */
+class MTV_PUBLIC StandbyTuner
+{
+  public:
+    /// How long an input stays on standby unless the LiveTV session renews it
+    static constexpr std::chrono::seconds kTimeout { 2min };
+    /// How long a claimed input waits for the LiveTV session to move to it
+    static constexpr std::chrono::seconds kClaimTimeout { 20s };
+
+    enum class Hold : std::uint8_t
+    {
+        kRefused,   ///< on standby for another input, or claimed
+        kKept,      ///< already on the channel
+        kMoved,     ///< already on the channel, in another direction
+        kRetune,    ///< the channel needs to be tuned
+    };
+
+    Hold Set(uint owner, ChannelChangeDirection dir, const QString &channum,
+             const QDateTime &now);
+    bool IsHeld(uint owner, const QString &channum) const;
+    bool Claim(uint owner, const QString &channum, const QDateTime &now);
+    bool Release(uint owner);
+    bool IsExpired(const QDateTime &now) const;
+    void Clear(void);
+
+    uint GetOwner(void) const;
+    QString GetChannel(void) const;
+    ChannelChangeDirection GetDirection(void) const;
+    bool IsClaimed(void) const;
+
+  private:
+    mutable QMutex         m_lock;
+    uint                   m_owner     {0};
+    QString                m_channel;
+    ChannelChangeDirection m_direction {CHANNEL_DIRECTION_SAME};
+    bool                   m_release   {false};
+    bool                   m_claimed   {false};
+    QDateTime              m_expire;
+};
+
+#endif // STANDBY_TUNER_H
@@ -0,0 +1,157 @@
+#include "test_audioanalyser.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <QThread>
+
+#include "libmythtv/audio/audioanalyser.h"
+
+using namespace std::chrono_literals;
+
+static constexpr int kRate  { 44100 };
+static constexpr int kBlock { 1152 };
+
+/// Block number Block of a sine of Frequency at Amplitude (0 - 1), added to Samples.
+static void AddSine(std::vector<short>& Samples, double Frequency, double Amplitude, int Block)
+{
+    Samples.resize(kBlock);
+    for (int i = 0; i < kBlock; i++)
+    {
+        double t = static_cast<double>((Block * kBlock) + i) / kRate;
+        Samples[i] = static_cast<short>(Samples[i] + std::lround(Amplitude * 32767 * std::sin(2 * M_PI * Frequency * t)));
+    }
+}
+
+static AudioAnalysisPtr Add(AudioAnalyser& Analyser, std::vector<short>& Samples, int Block)
+{
+    auto timecode = std::chrono::milliseconds(static_cast<int64_t>(Block) * kBlock * 1000 / kRate);
+    return Analyser.Add(Samples.data(), Samples.data(), Samples.size(), timecode);
+}
+
+static bool WaitFor(const AudioAnalysisPtr& Analysis)
+{
+    for (int i = 0; Analysis && !Analysis->IsReady() && (i < 500); i++)
+        QThread::msleep(10);
+    return Analysis && Analysis->IsReady();
+}
+
+void TestAudioAnalyser::TestSine_data()
+{
+    QTest::addColumn<double>("Frequency");
+    QTest::addColumn<int>("Band");
+
+    QTest::newRow("40Hz")    <<    40.0 << static_cast<int>(AudioAnalysis::kSubBass);
+    QTest::newRow("100Hz")   <<   100.0 << static_cast<int>(AudioAnalysis::kBass);
+    QTest::newRow("1kHz")    <<  1000.0 << static_cast<int>(AudioAnalysis::kMid);
+    QTest::newRow("3kHz")    <<  3000.0 << static_cast<int>(AudioAnalysis::kHighMid);
+    QTest::newRow("10kHz")   << 10000.0 << static_cast<int>(AudioAnalysis::kBrilliance);
+}
+
+void TestAudioAnalyser::TestSine()
+{
+    QFETCH(double, Frequency);
+    QFETCH(int, Band);
+
+    AudioAnalyser analyser;
+    analyser.SetSampleRate(kRate);
+
+    // Only the last is kept, the others just fill the window
+    AudioAnalysisPtr analysis;
+    for (int block = 0; block < 20; block++)
+    {
+        std::vector<short> samples;
+        AddSine(samples, Frequency, 0.5, block);
+        analysis = Add(analyser, samples, block);
+    }
+    QVERIFY(WaitFor(analysis));
+    QCOMPARE(analysis->m_sampleRate, kRate);
+
+    int peak = 1;
+    for (int bin = 1; bin < AudioAnalysis::kBins; bin++)
+        if (analysis->LeftPower(bin) > analysis->LeftPower(peak))
+            peak = bin;
+    QVERIFY(std::abs(analysis->BinFrequency(peak) - Frequency) < 2.0 * kRate / AudioAnalysis::kFFTSize);
+    QCOMPARE(analysis->RightPower(peak), analysis->LeftPower(peak));
+
+    // Allow for the sine falling between bins
+    double amplitude = 2 * std::sqrt(analysis->LeftPower(peak)) / analysis->m_gain;
+    QVERIFY2(amplitude > 0.3 && amplitude < 0.55, qPrintable(QString::number(amplitude)));
+
+    const auto &bands = analysis->m_bands;
+    QCOMPARE(static_cast<int>(std::distance(bands.cbegin(), std::ranges::max_element(bands))), Band);
+    QVERIFY(bands[Band] > analysis->m_energy * 0.9F);
+}
+
+void TestAudioAnalyser::TestMono()
+{
+    AudioAnalyser analyser;
+    std::vector<short> samples;
+    AddSine(samples, 440.0, 0.5, 0);
+    auto analysis = analyser.Add(samples.data(), nullptr, samples.size(), 0ms);
+    QVERIFY(WaitFor(analysis));
+    QCOMPARE(analysis->m_left.size(), static_cast<size_t>(AudioAnalysis::kBins));
+    QVERIFY(analysis->m_right.empty());
+    for (int bin = 0; bin < AudioAnalysis::kBins; bin++)
+        QCOMPARE(analysis->RightPower(bin), analysis->LeftPower(bin));
+
+    QVERIFY(analyser.Add(nullptr, nullptr, 0, 0ms) == nullptr);
+}
+
+void TestAudioAnalyser::TestBeat()
+{
+    AudioAnalyser analyser;
+    analyser.SetSampleRate(kRate);
+
+    // A steady tone, then two blocks with a kick drum on top of it
+    std::vector<AudioAnalysisPtr> analyses;
+    for (int block = 0; block < 42; block++)
+    {
+        std::vector<short> samples;
+        AddSine(samples, 1000.0, 0.2, block);
+        if (block >= 40)
+            AddSine(samples, 80.0, 0.6, block);
+        analyses.push_back(Add(analyser, samples, block));
+    }
+    for (const auto &analysis : analyses)
+        QVERIFY(WaitFor(analysis));
+
+    for (int block = 0; block < 40; block++)
+        QVERIFY2(!analyses[block]->m_beat, qPrintable(QString("block %1").arg(block)));
+    QVERIFY(analyses[40]->m_beat);
+    QVERIFY(analyses[40]->m_beatStrength > 10.0F);
+    QCOMPARE(analyses[40]->m_beatCount, analyses[39]->m_beatCount + 1);
+    // too soon after the last
+    QVERIFY(!analyses[41]->m_beat);
+    QCOMPARE(analyses[41]->m_beatCount, analyses[40]->m_beatCount);
+}
+
+void TestAudioAnalyser::TestReset()
+{
+    AudioAnalyser analyser;
+    AudioAnalysisPtr analysis;
+    for (int block = 0; block < 20; block++)
+    {
+        std::vector<short> samples;
+        AddSine(samples, 100.0, 0.8, block);
+        analysis = Add(analyser, samples, block);
+    }
+    QVERIFY(WaitFor(analysis));
+
+    // Silence still holds the faded tone
+    std::vector<short> silence(kBlock, 0);
+    analysis = Add(analyser, silence, 20);
+    QVERIFY(WaitFor(analysis));
+    QVERIFY(analysis->m_energy > 0.0F);
+
+    analyser.Reset();
+    analysis = Add(analyser, silence, 0);
+    QVERIFY(WaitFor(analysis));
+    QCOMPARE(analysis->m_energy, 0.0F);
+    QVERIFY(!analysis->m_beat);
+}
+
+QTEST_GUILESS_MAIN(TestAudioAnalyser)
+
+#include "moc_test_audioanalyser.cpp"
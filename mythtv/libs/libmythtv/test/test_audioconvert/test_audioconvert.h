@@ -20,6 +20,11 @@
 #ifndef LIBMYTHTV_TEST_AUDIOCONVERT_H
 #define LIBMYTHTV_TEST_AUDIOCONVERT_H
 
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
 #include <QChar>     // Fix Qt6 GCC SFINAE warning
 #include <QBitArray> // Fix Qt6 GCC SFINAE warning
 #include <QTest>
@@ -1443,6 +1448,262 @@ class TestAudioConvert: public QObject
         av_free(arrayf2);
         av_free(arrayf3);
     }
+
+    static void InterleaveRoundTrip_data(void)
+    {
+        QTest::addColumn<int>("format");
+        QTest::addColumn<int>("channels");
+        for (int channels = 1; channels <= 8; channels++)
+        {
+            QTest::newRow(qPrintable(QString("S16 %1 channels").arg(channels)))
+                << static_cast<int>(FORMAT_S16) << channels;
+            QTest::newRow(qPrintable(QString("FLT %1 channels").arg(channels)))
+                << static_cast<int>(FORMAT_FLT) << channels;
+        }
+    }
+
+    // test planar <-> interleaved conversion against a plain C reference
+    static void InterleaveRoundTrip(void)
+    {
+        QFETCH(int, format);
+        QFETCH(int, channels);
+
+        // 32 bit stereo has a SIMD kernel, the samples are only moved
+        // around so they are compared as integers
+        int frames = 1031; // deliberately not a multiple of the vector width
+        int samples = frames * channels;
+        int bytes = AudioOutputSettings::SampleSize(static_cast<AudioFormat>(format));
+        std::vector<int32_t> interleaved(samples);
+        std::vector<int32_t> planar(samples);
+        std::vector<int32_t> result(samples);
+
+        for (int i = 0; i < samples; i++)
+            interleaved[i] = (i * 7919) & (bytes == 2 ? 0x7fff : 0x7fffffff);
+        if (bytes == 2)
+        {
+            std::vector<int16_t> shorts(interleaved.cbegin(), interleaved.cend());
+            std::memcpy(interleaved.data(), shorts.data(), samples * ISIZEOF(int16_t));
+        }
+
+        AudioConvert::DeinterleaveSamples(static_cast<AudioFormat>(format), channels,
+                                          (uint8_t*)planar.data(),
+                                          (const uint8_t*)interleaved.data(),
+                                          samples * bytes);
+        for (int i = 0; i < frames; i++)
+        {
+            for (int c = 0; c < channels; c++)
+            {
+                int p = (c * frames) + i;
+                int q = (i * channels) + c;
+                if (bytes == 2)
+                    QCOMPARE(((int16_t*)planar.data())[p], ((int16_t*)interleaved.data())[q]);
+                else
+                    QCOMPARE(planar[p], interleaved[q]);
+            }
+        }
+
+        AudioConvert::InterleaveSamples(static_cast<AudioFormat>(format), channels,
+                                        (uint8_t*)result.data(),
+                                        (const uint8_t*)planar.data(),
+                                        samples * bytes);
+        QVERIFY(std::memcmp(result.data(), interleaved.data(), samples * bytes) == 0);
+    }
+
+    static void DeinterleaveSpeed_data(void)
+    {
+        QTest::addColumn<int>("channels");
+        QTest::addColumn<bool>("useReference");
+        QTest::newRow("Stereo AudioConvert") << 2 << false;
+        QTest::newRow("Stereo C reference")  << 2 << true;
+        QTest::newRow("5.1 AudioConvert")    << 6 << false;
+        QTest::newRow("5.1 C reference")     << 6 << true;
+    }
+
+    // float is what the AC-3/E-AC-3 and AAC decoders give
+    static void DeinterleaveSpeed(void)
+    {
+        QFETCH(int, channels);
+        QFETCH(bool, useReference);
+
+        int frames = 48000;
+        int samples = frames * channels;
+        std::vector<float> interleaved(samples, 0.5F);
+        std::vector<float> planar(samples);
+
+        if (useReference)
+        {
+            QBENCHMARK
+            {
+                const float *in = interleaved.data();
+                for (int i = 0; i < frames; i++)
+                    for (int c = 0; c < channels; c++)
+                        planar[(c * frames) + i] = *in++;
+            }
+        }
+        else
+        {
+            QBENCHMARK
+            {
+                AudioConvert::DeinterleaveSamples(FORMAT_FLT, channels,
+                                                  (uint8_t*)planar.data(),
+                                                  (const uint8_t*)interleaved.data(),
+                                                  samples * ISIZEOF(float));
+            }
+        }
+    }
+
+    static void InterleaveSpeed_data(void)
+    {
+        QTest::addColumn<int>("channels");
+        QTest::addColumn<bool>("useReference");
+        QTest::newRow("Stereo AudioConvert") << 2 << false;
+        QTest::newRow("Stereo C reference")  << 2 << true;
+        QTest::newRow("5.1 AudioConvert")    << 6 << false;
+        QTest::newRow("5.1 C reference")     << 6 << true;
+    }
+
+    static void InterleaveSpeed(void)
+    {
+        QFETCH(int, channels);
+        QFETCH(bool, useReference);
+
+        int frames = 48000;
+        int samples = frames * channels;
+        std::vector<float> planar(samples, 0.5F);
+        std::vector<float> interleaved(samples);
+
+        if (useReference)
+        {
+            QBENCHMARK
+            {
+                float *out = interleaved.data();
+                for (int i = 0; i < frames; i++)
+                    for (int c = 0; c < channels; c++)
+                        *out++ = planar[(c * frames) + i];
+            }
+        }
+        else
+        {
+            QBENCHMARK
+            {
+                AudioConvert::InterleaveSamples(FORMAT_FLT, channels,
+                                                (uint8_t*)interleaved.data(),
+                                                (const uint8_t*)planar.data(),
+                                                samples * ISIZEOF(float));
+            }
+        }
+    }
+
+    static void Downmix_data(void)
+    {
+        QTest::addColumn<int>("channelsIn");
+        QTest::addColumn<int>("channelsOut");
+        for (int in = 2; in <= 8; in++)
+            QTest::newRow(qPrintable(QString("%1 to stereo").arg(in))) << in << 2;
+        for (int in = 6; in <= 8; in++)
+            QTest::newRow(qPrintable(QString("%1 to 5.1").arg(in))) << in << 6;
+    }
+
+    // the SIMD kernels, in place or not, against the C code
+    static void Downmix(void)
+    {
+        QFETCH(int, channelsIn);
+        QFETCH(int, channelsOut);
+
+        int frames = 1031; // an odd number leaves a frame to the C code
+        std::vector<float> src(frames * channelsIn);
+        for (size_t i = 0; i < src.size(); i++)
+            src[i] = std::sin(static_cast<float>(i) * 0.37F);
+
+        std::vector<float> expected(frames * channelsOut);
+        std::vector<float> simd(frames * channelsOut);
+        std::vector<float> inplace(src);
+        QCOMPARE(AudioConvert::DownmixFrames(channelsIn, channelsOut, expected.data(),
+                                             src.data(), frames, false), frames);
+        QCOMPARE(AudioConvert::DownmixFrames(channelsIn, channelsOut, simd.data(),
+                                             src.data(), frames), frames);
+        QCOMPARE(AudioConvert::DownmixFrames(channelsIn, channelsOut, inplace.data(),
+                                             inplace.data(), frames), frames);
+
+        // the sums are made in the same order, only a fused multiply-add
+        // in the C code could make them differ
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            QVERIFY(std::abs(simd[i] - expected[i]) <= 1e-6F);
+            QVERIFY(std::abs(inplace[i] - expected[i]) <= 1e-6F);
+        }
+    }
+
+    // 5.1 to stereo, one channel at a time
+    static void DownmixMatrix(void)
+    {
+        static constexpr float kM3db { 0.70710677F };
+        static constexpr float kSqrt23 { 0.81649658F };
+        static constexpr float kMSqrt13 { -0.57735027F };
+        const std::array<std::array<float,2>,6> expected
+        {{
+            { 1.0F,     0.0F     },     // L
+            { 0.0F,     1.0F     },     // R
+            { kM3db,    kM3db    },     // C
+            { 0.0F,     0.0F     },     // LFE
+            { kSqrt23,  kMSqrt13 },     // LS
+            { kMSqrt13, kSqrt23  },     // RS
+        }};
+
+        for (bool useSIMD : { false, true })
+        {
+            for (int c = 0; c < 6; c++)
+            {
+                // four frames, so the SIMD kernel does them all
+                std::array<float,6 * 4> src {};
+                std::array<float,2 * 4> dst {};
+                for (int i = 0; i < 4; i++)
+                    src[(i * 6) + c] = 0.5F;
+                QCOMPARE(AudioConvert::DownmixFrames(6, 2, dst.data(), src.data(), 4, useSIMD), 4);
+                for (int i = 0; i < 4; i++)
+                {
+                    QVERIFY(std::abs(dst[(i * 2) + 0] - (expected[c][0] * 0.5F)) <= 1e-6F);
+                    QVERIFY(std::abs(dst[(i * 2) + 1] - (expected[c][1] * 0.5F)) <= 1e-6F);
+                }
+            }
+        }
+
+        // there is no mix up, or from more than 7.1
+        std::array<float,18> buffer {};
+        QCOMPARE(AudioConvert::DownmixFrames(2, 6, buffer.data(), buffer.data(), 1), -1);
+        QCOMPARE(AudioConvert::DownmixFrames(9, 2, buffer.data(), buffer.data(), 1), -1);
+        QCOMPARE(AudioConvert::DownmixFrames(6, 4, buffer.data(), buffer.data(), 1), -1);
+    }
+
+    static void DownmixSpeed_data(void)
+    {
+        QTest::addColumn<int>("channelsIn");
+        QTest::addColumn<int>("channelsOut");
+        QTest::addColumn<bool>("useSIMD");
+        QTest::newRow("5.1 to stereo SIMD") << 6 << 2 << true;
+        QTest::newRow("5.1 to stereo C")    << 6 << 2 << false;
+        QTest::newRow("7.1 to stereo SIMD") << 8 << 2 << true;
+        QTest::newRow("7.1 to stereo C")    << 8 << 2 << false;
+        QTest::newRow("7.1 to 5.1 SIMD")    << 8 << 6 << true;
+        QTest::newRow("7.1 to 5.1 C")       << 8 << 6 << false;
+    }
+
+    static void DownmixSpeed(void)
+    {
+        QFETCH(int, channelsIn);
+        QFETCH(int, channelsOut);
+        QFETCH(bool, useSIMD);
+
+        int frames = 48000;
+        std::vector<float> src(frames * channelsIn, 0.5F);
+        std::vector<float> dst(frames * channelsOut);
+
+        QBENCHMARK
+        {
+            AudioConvert::DownmixFrames(channelsIn, channelsOut, dst.data(),
+                                        src.data(), frames, useSIMD);
+        }
+    }
 };
 
 #endif // LIBMYTHTV_TEST_AUDIOCONVERT_H
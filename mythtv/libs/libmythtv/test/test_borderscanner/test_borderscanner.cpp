@@ -0,0 +1,238 @@
+#include "test_borderscanner.h"
+
+#include <climits>
+#include <vector>
+
+#include "libmythbase/mythrandom.h"
+#include "libmythtv/borderscanner.h"
+#include "libmythtv/DetectLetterbox.h"
+#include "libmythtv/mythframe.h"
+
+static constexpr int kWidth  { 720 };
+static constexpr int kHeight { 576 };
+static constexpr int kBar    { 72 };  // 16:9 in 4:3
+
+static void AddFormats()
+{
+    QTest::addColumn<int>("Format");
+    for (auto format : { FMT_YV12, FMT_YUV420P10, FMT_YUV422P, FMT_NV12, FMT_P010, FMT_P016 })
+        QTest::newRow(qPrintable(MythVideoFrame::FormatDescription(format))) << static_cast<int>(format);
+}
+
+/// Store an 8 bit luma Value where the format keeps it.
+static void SetLuma(MythVideoFrame* Frame, int Row, int Column, int Value)
+{
+    uint8_t* row = Frame->m_buffer + Frame->m_offsets[0] + (Row * static_cast<ptrdiff_t>(Frame->m_pitches[0]));
+    int depth = MythVideoFrame::ColorDepth(Frame->m_type);
+    if (depth > 8)
+    {
+        int shift = MythVideoFrame::FormatIsNV12(Frame->m_type) ? 8 : depth - 8;
+        reinterpret_cast<uint16_t*>(row)[Column] = static_cast<uint16_t>(Value << shift);
+    }
+    else
+    {
+        row[Column] = static_cast<uint8_t>(Value);
+    }
+}
+
+/// Noisy black bars of Bar rows above and below random picture.
+static void FillLetterbox(MythVideoFrame* Frame, int Bar)
+{
+    for (int row = 0; row < Frame->m_height; ++row)
+    {
+        bool bar = (row < Bar) || (row >= Frame->m_height - Bar);
+        for (int column = 0; column < Frame->m_width; ++column)
+            SetLuma(Frame, row, column, bar ? MythRandom(16, 19) : MythRandom(0, UCHAR_MAX));
+    }
+}
+
+void TestBorderScanner::TestLineStats()
+{
+    std::vector<uint8_t> data(2000);
+    for (int count : { 0, 1, 15, 16, 17, 100, 720, 1999 })
+    {
+        for (auto & value : data)
+            value = static_cast<uint8_t>(MythRandom(0, UCHAR_MAX));
+
+        int minval = UINT8_MAX;
+        int maxval = 0;
+        uint64_t sum = 0;
+        uint64_t squares = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            minval = std::min(minval, static_cast<int>(data[i]));
+            maxval = std::max(maxval, static_cast<int>(data[i]));
+            sum += data[i];
+            squares += static_cast<uint64_t>(data[i]) * data[i];
+        }
+
+        BorderLineStats stats = BorderScanner::LineStats(data.data(), count);
+        QCOMPARE(stats.m_count, count);
+        QCOMPARE(stats.m_sum, sum);
+        QCOMPARE(stats.m_sumSq, squares);
+        if (count > 0)
+        {
+            QCOMPARE(stats.m_min, minval);
+            QCOMPARE(stats.m_max, maxval);
+        }
+    }
+
+    // Long enough to overflow 32 bit square sums
+    std::vector<uint8_t> white(100000, UINT8_MAX);
+    BorderLineStats stats = BorderScanner::LineStats(white.data(), static_cast<int>(white.size()));
+    QCOMPARE(stats.m_sumSq, static_cast<uint64_t>(UINT64_C(100000) * 255 * 255));
+    QCOMPARE(stats.Range(), 0);
+    QCOMPARE(stats.Variance(), 0.0);
+}
+
+void TestBorderScanner::TestColumnMinMax()
+{
+    static constexpr int kPitch   { 64 };
+    static constexpr int kRows    { 9 };
+    std::vector<uint8_t> data(kPitch * kRows);
+    for (auto & value : data)
+        value = static_cast<uint8_t>(MythRandom(0, UCHAR_MAX));
+
+    for (int columns : { 1, 16, 21, 64 })
+    {
+        std::vector<uint8_t> minvals(columns);
+        std::vector<uint8_t> maxvals(columns);
+        BorderScanner::ColumnMinMax(data.data(), kPitch, kRows, columns, minvals.data(), maxvals.data());
+        for (int column = 0; column < columns; ++column)
+        {
+            uint8_t minval = UINT8_MAX;
+            uint8_t maxval = 0;
+            for (int row = 0; row < kRows; ++row)
+            {
+                minval = std::min(minval, data[(row * kPitch) + column]);
+                maxval = std::max(maxval, data[(row * kPitch) + column]);
+            }
+            QCOMPARE(minvals[column], minval);
+            QCOMPARE(maxvals[column], maxval);
+        }
+    }
+}
+
+void TestBorderScanner::TestLetterbox_data()
+{
+    AddFormats();
+}
+
+void TestBorderScanner::TestLetterbox()
+{
+    QFETCH(int, Format);
+    MythVideoFrame frame(static_cast<VideoFrameType>(Format), kWidth, kHeight);
+    QVERIFY(frame.m_buffer);
+    FillLetterbox(&frame, kBar);
+
+    BorderScanResult result = BorderScanner::FindLetterbox(BorderScanner::Sample(&frame));
+    QVERIFY(result.m_valid);
+    // Only every kRowStep'th row is looked at
+    QVERIFY(result.m_top    <= kBar && result.m_top    > kBar - BorderScanner::kRowStep);
+    QVERIFY(result.m_bottom <= kBar && result.m_bottom > kBar - BorderScanner::kRowStep);
+}
+
+void TestBorderScanner::TestNoBars_data()
+{
+    AddFormats();
+}
+
+void TestBorderScanner::TestNoBars()
+{
+    QFETCH(int, Format);
+    MythVideoFrame frame(static_cast<VideoFrameType>(Format), kWidth, kHeight);
+    QVERIFY(frame.m_buffer);
+    FillLetterbox(&frame, 0);
+
+    BorderScanResult result = BorderScanner::FindLetterbox(BorderScanner::Sample(&frame));
+    QVERIFY(result.m_valid);
+    QCOMPARE(result.m_top, 0);
+    QCOMPARE(result.m_bottom, 0);
+}
+
+void TestBorderScanner::TestBlackFrame()
+{
+    MythVideoFrame frame(FMT_YV12, kWidth, kHeight);
+    QVERIFY(frame.m_buffer);
+    FillLetterbox(&frame, kHeight / 2);
+
+    BorderScanResult result = BorderScanner::FindLetterbox(BorderScanner::Sample(&frame));
+    QVERIFY(!result.m_valid);
+}
+
+void TestBorderScanner::TestUnsupported()
+{
+    MythVideoFrame frame(FMT_YUY2, kWidth, kHeight);
+    QVERIFY(!BorderScanner::Sample(&frame).IsValid());
+    QVERIFY(!BorderScanner::Sample(nullptr).IsValid());
+    QVERIFY(!BorderScanner::FindLetterbox(BorderSample()).m_valid);
+}
+
+// 4:3 at the default 75% limit: full above 54 rows, half above 30
+static constexpr float kAspect { 4.0F / 3.0F };
+static constexpr int   kLimit  { 75 };
+
+static bool AddBars(LetterboxHysteresis& Hysteresis, int Bar)
+{
+    BorderScanResult result;
+    result.m_valid  = true;
+    result.m_top    = Bar;
+    result.m_bottom = Bar;
+    return Hysteresis.Add(result, kHeight, kAspect, kLimit);
+}
+
+void TestBorderScanner::TestHysteresisSwitch()
+{
+    LetterboxHysteresis hysteresis;
+    hysteresis.Reset(kAdjustFill_Off, kAdjustFill_Off);
+
+    for (int i = 1; i < LetterboxHysteresis::kConfirmSamples; ++i)
+        QVERIFY(!AddBars(hysteresis, kBar));
+    QCOMPARE(hysteresis.GetMode(), kAdjustFill_Off);
+    QVERIFY(AddBars(hysteresis, kBar));
+    QCOMPARE(hysteresis.GetMode(), kAdjustFill_Full);
+
+    // Narrower bars
+    for (int i = 1; i < LetterboxHysteresis::kConfirmSamples; ++i)
+        QVERIFY(!AddBars(hysteresis, 36));
+    QVERIFY(AddBars(hysteresis, 36));
+    QCOMPARE(hysteresis.GetMode(), kAdjustFill_Half);
+
+    // Black frames are no evidence, and don't break the count
+    hysteresis.Reset(kAdjustFill_Off, kAdjustFill_Off);
+    QVERIFY(!AddBars(hysteresis, kBar));
+    QVERIFY(!hysteresis.Add(BorderScanResult(), kHeight, kAspect, kLimit));
+    for (int i = 2; i < LetterboxHysteresis::kConfirmSamples; ++i)
+        QVERIFY(!AddBars(hysteresis, kBar));
+    QVERIFY(AddBars(hysteresis, kBar));
+}
+
+void TestBorderScanner::TestHysteresisHold()
+{
+    LetterboxHysteresis hysteresis;
+    hysteresis.Reset(kAdjustFill_Off, kAdjustFill_Full);
+
+    // Too narrow to enter full, wide enough to stay
+    for (int i = 0; i < LetterboxHysteresis::kConfirmSamples * 2; ++i)
+        QVERIFY(!AddBars(hysteresis, 45));
+    QCOMPARE(hysteresis.GetMode(), kAdjustFill_Full);
+
+    for (int i = 1; i < LetterboxHysteresis::kConfirmSamples; ++i)
+        QVERIFY(!AddBars(hysteresis, 0));
+    QVERIFY(AddBars(hysteresis, 0));
+    QCOMPARE(hysteresis.GetMode(), kAdjustFill_Off);
+}
+
+void TestBorderScanner::TestHysteresisFlicker()
+{
+    LetterboxHysteresis hysteresis;
+    hysteresis.Reset(kAdjustFill_Off, kAdjustFill_Off);
+
+    for (int i = 0; i < LetterboxHysteresis::kConfirmSamples * 4; ++i)
+        QVERIFY(!AddBars(hysteresis, (i & 1) ? kBar : 0));
+    QCOMPARE(hysteresis.GetMode(), kAdjustFill_Off);
+}
+
+QTEST_APPLESS_MAIN(TestBorderScanner)
+
+#include "moc_test_borderscanner.cpp"
@@ -0,0 +1,287 @@
+#include "test_deinterlacer.h"
+
+#include <climits>
+#include <vector>
+
+#include "libmythbase/mythrandom.h"
+#include "libmythtv/mythdeinterlacer.h"
+#include "libmythtv/mythframe.h"
+
+// Every format MythDeinterlacer accepts
+static const std::vector<VideoFrameType> s_formats =
+{
+    FMT_YV12,    FMT_YUV420P9, FMT_YUV420P10, FMT_YUV420P12, FMT_YUV420P14, FMT_YUV420P16,
+    FMT_YUV422P, FMT_YUV422P9, FMT_YUV422P10, FMT_YUV422P12, FMT_YUV422P14, FMT_YUV422P16,
+    FMT_YUV444P, FMT_YUV444P9, FMT_YUV444P10, FMT_YUV444P12, FMT_YUV444P14, FMT_YUV444P16,
+    FMT_NV12,    FMT_P010,     FMT_P016,      FMT_YUY2
+};
+
+static constexpr int kWidth  { 720 };
+static constexpr int kHeight { 576 };
+
+static void AddFormats()
+{
+    QTest::addColumn<int>("Format");
+    for (auto format : s_formats)
+        QTest::newRow(qPrintable(MythVideoFrame::FormatDescription(format))) << static_cast<int>(format);
+}
+
+static void FillRandom(MythVideoFrame* Frame)
+{
+    for (size_t i = 0; i < Frame->m_bufferSize; ++i)
+        Frame->m_buffer[i] = static_cast<uint8_t>(MythRandom(0, UCHAR_MAX));
+}
+
+static void Prepare(MythVideoFrame* Frame, MythDeintType Deinterlacer, bool DoubleRate, uint64_t Counter)
+{
+    Frame->m_deinterlaceAllowed  = DEINT_ALL;
+    Frame->m_deinterlaceSingle   = DoubleRate ? DEINT_NONE : (Deinterlacer | DEINT_CPU);
+    Frame->m_deinterlaceDouble   = DoubleRate ? (Deinterlacer | DEINT_CPU) : DEINT_NONE;
+    Frame->m_topFieldFirst       = true;
+    Frame->m_interlacedReverse   = false;
+    Frame->m_alreadyDeinterlaced = false;
+    Frame->m_frameCounter        = Counter;
+}
+
+/// Sample Index of Row in Plane, 8 or 16 bits wide.
+static int Sample(const MythVideoFrame* Frame, const uint8_t* Buffer, uint Plane, int Row, int Index)
+{
+    const uint8_t* row = Buffer + Frame->m_offsets[Plane] + (Row * static_cast<ptrdiff_t>(Frame->m_pitches[Plane]));
+    if (MythVideoFrame::ColorDepth(Frame->m_type) > 8)
+        return reinterpret_cast<const uint16_t*>(row)[Index];
+    return row[Index];
+}
+
+static int Samples(const MythVideoFrame* Frame, uint Plane)
+{
+    int bytes = MythVideoFrame::GetPitchForPlane(Frame->m_type, Frame->m_width, Plane);
+    return MythVideoFrame::ColorDepth(Frame->m_type) > 8 ? bytes / 2 : bytes;
+}
+
+static bool SameRow(const MythVideoFrame* Frame, const uint8_t* Original, uint Plane, int Row, int OriginalRow)
+{
+    for (int i = 0; i < Samples(Frame, Plane); ++i)
+        if (Sample(Frame, Frame->m_buffer, Plane, Row, i) != Sample(Frame, Original, Plane, OriginalRow, i))
+            return false;
+    return true;
+}
+
+/// True if the odd rows between the first and last are blended from the even
+/// rows of Original, and the even rows are untouched.
+static bool Blended(const MythVideoFrame* Frame, const uint8_t* Original)
+{
+    for (uint plane = 0; plane < MythVideoFrame::GetNumPlanes(Frame->m_type); ++plane)
+    {
+        int height = MythVideoFrame::GetHeightForPlane(Frame->m_type, Frame->m_height, plane);
+        for (int row = 0; row < height - 1; row += 2)
+            if (!SameRow(Frame, Original, plane, row, row))
+                return false;
+        for (int row = 1; row < height - 1; row += 2)
+        {
+            for (int i = 0; i < Samples(Frame, plane); ++i)
+            {
+                int above = Sample(Frame, Original, plane, row - 1, i);
+                int below = Sample(Frame, Original, plane, row + 1, i);
+                if (Sample(Frame, Frame->m_buffer, plane, row, i) != ((above + below + 1) >> 1))
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+void TestDeinterlacer::TestOneField_data()
+{
+    AddFormats();
+}
+
+void TestDeinterlacer::TestOneField()
+{
+    QFETCH(int, Format);
+    auto format = static_cast<VideoFrameType>(Format);
+    MythVideoFrame frame(format, kWidth, kHeight);
+    QVERIFY(frame.m_buffer);
+    FillRandom(&frame);
+    std::vector<uint8_t> original(frame.m_buffer, frame.m_buffer + frame.m_bufferSize);
+    uint planes = MythVideoFrame::GetNumPlanes(format);
+
+    // Top field first - the bottom field is replaced by the top
+    MythDeinterlacer deinterlacer;
+    Prepare(&frame, DEINT_BASIC, true, 1);
+    deinterlacer.Filter(&frame, kScan_Interlaced, nullptr);
+    QVERIFY(frame.m_alreadyDeinterlaced);
+    for (uint plane = 0; plane < planes; ++plane)
+        for (int row = 0; row < MythVideoFrame::GetHeightForPlane(format, kHeight, plane); ++row)
+            QVERIFY(SameRow(&frame, original.data(), plane, row, row & ~1));
+
+    // and then the top by the bottom, from the original frame
+    frame.m_alreadyDeinterlaced = false;
+    deinterlacer.Filter(&frame, kScan_Intr2ndField, nullptr);
+    QVERIFY(frame.m_alreadyDeinterlaced);
+    for (uint plane = 0; plane < planes; ++plane)
+        for (int row = 0; row < MythVideoFrame::GetHeightForPlane(format, kHeight, plane); ++row)
+            QVERIFY(SameRow(&frame, original.data(), plane, row, row | 1));
+}
+
+void TestDeinterlacer::TestBlend_data()
+{
+    AddFormats();
+}
+
+void TestDeinterlacer::TestBlend()
+{
+    QFETCH(int, Format);
+    auto format = static_cast<VideoFrameType>(Format);
+    MythVideoFrame frame(format, kWidth, kHeight);
+    QVERIFY(frame.m_buffer);
+    FillRandom(&frame);
+    std::vector<uint8_t> original(frame.m_buffer, frame.m_buffer + frame.m_bufferSize);
+
+    // Without an earlier frame everything is blended
+    MythDeinterlacer deinterlacer;
+    Prepare(&frame, DEINT_MEDIUM, false, 1);
+    deinterlacer.Filter(&frame, kScan_Interlaced, nullptr);
+    QVERIFY(frame.m_alreadyDeinterlaced);
+    QVERIFY(Blended(&frame, original.data()));
+}
+
+void TestDeinterlacer::TestMotionStill_data()
+{
+    AddFormats();
+}
+
+void TestDeinterlacer::TestMotionStill()
+{
+    QFETCH(int, Format);
+    auto format = static_cast<VideoFrameType>(Format);
+    MythVideoFrame frame(format, kWidth, kHeight);
+    QVERIFY(frame.m_buffer);
+    FillRandom(&frame);
+    std::vector<uint8_t> original(frame.m_buffer, frame.m_buffer + frame.m_bufferSize);
+
+    MythDeinterlacer deinterlacer;
+    Prepare(&frame, DEINT_MEDIUM, false, 1);
+    deinterlacer.Filter(&frame, kScan_Interlaced, nullptr);
+
+    // Nothing moved, so both fields are woven back together
+    std::copy(original.cbegin(), original.cend(), frame.m_buffer);
+    Prepare(&frame, DEINT_MEDIUM, false, 2);
+    deinterlacer.Filter(&frame, kScan_Interlaced, nullptr);
+    QVERIFY(frame.m_alreadyDeinterlaced);
+    QVERIFY(std::equal(original.cbegin(), original.cend(), frame.m_buffer));
+}
+
+void TestDeinterlacer::TestMotionMoving_data()
+{
+    AddFormats();
+}
+
+void TestDeinterlacer::TestMotionMoving()
+{
+    QFETCH(int, Format);
+    auto format = static_cast<VideoFrameType>(Format);
+    MythVideoFrame frame(format, kWidth, kHeight);
+    QVERIFY(frame.m_buffer);
+    FillRandom(&frame);
+
+    MythDeinterlacer deinterlacer;
+    Prepare(&frame, DEINT_MEDIUM, false, 1);
+    deinterlacer.Filter(&frame, kScan_Interlaced, nullptr);
+
+    // Every pixel moves by half the range, so all are blended
+    FillRandom(&frame);
+    std::vector<uint8_t> original(frame.m_buffer, frame.m_buffer + frame.m_bufferSize);
+    for (size_t i = 0; i < frame.m_bufferSize; ++i)
+        frame.m_buffer[i] ^= 0x80;
+    for (auto & byte : original)
+        byte ^= 0x80;
+    Prepare(&frame, DEINT_MEDIUM, false, 2);
+    deinterlacer.Filter(&frame, kScan_Interlaced, nullptr);
+    QVERIFY(frame.m_alreadyDeinterlaced);
+    QVERIFY(Blended(&frame, original.data()));
+}
+
+void TestDeinterlacer::TestSlices_data()
+{
+    AddFormats();
+}
+
+void TestDeinterlacer::TestSlices()
+{
+    QFETCH(int, Format);
+    auto format = static_cast<VideoFrameType>(Format);
+
+    // Slicing must not change the result
+    for (auto deint : { DEINT_BASIC, DEINT_MEDIUM })
+    {
+        MythVideoFrame previous(format, kWidth, kHeight);
+        MythVideoFrame current(format, kWidth, kHeight);
+        FillRandom(&previous);
+        FillRandom(&current);
+        // Leave some pixels still
+        for (size_t i = 0; i < current.m_bufferSize; i += 3)
+            current.m_buffer[i] = previous.m_buffer[i];
+        std::vector<uint8_t> first(previous.m_buffer, previous.m_buffer + previous.m_bufferSize);
+        std::vector<uint8_t> second(current.m_buffer, current.m_buffer + current.m_bufferSize);
+
+        std::vector<std::vector<uint8_t>> results;
+        for (uint threads : { 1U, 4U })
+        {
+            MythDeinterlacer deinterlacer;
+            deinterlacer.SetMaxThreads(threads);
+            std::copy(first.cbegin(), first.cend(), previous.m_buffer);
+            std::copy(second.cbegin(), second.cend(), current.m_buffer);
+            Prepare(&previous, deint, true, 1);
+            deinterlacer.Filter(&previous, kScan_Interlaced, nullptr);
+            Prepare(&current, deint, true, 2);
+            deinterlacer.Filter(&current, kScan_Interlaced, nullptr);
+            results.emplace_back(current.m_buffer, current.m_buffer + current.m_bufferSize);
+            current.m_alreadyDeinterlaced = false;
+            deinterlacer.Filter(&current, kScan_Intr2ndField, nullptr);
+            results.emplace_back(current.m_buffer, current.m_buffer + current.m_bufferSize);
+        }
+        QVERIFY(results[0] == results[2]);
+        QVERIFY(results[1] == results[3]);
+    }
+}
+
+void TestDeinterlacer::TestThroughput_data()
+{
+    QTest::addColumn<int>("Format");
+    QTest::addColumn<int>("Deinterlacer");
+    for (auto format : s_formats)
+    {
+        for (auto deint : { DEINT_BASIC, DEINT_MEDIUM })
+        {
+            QString name = MythVideoFrame::FormatDescription(format) + " " +
+                MythVideoFrame::DeinterlacerName(deint | DEINT_CPU, true);
+            QTest::newRow(qPrintable(name)) << static_cast<int>(format) << static_cast<int>(deint);
+        }
+    }
+}
+
+void TestDeinterlacer::TestThroughput()
+{
+    QFETCH(int, Format);
+    QFETCH(int, Deinterlacer);
+    auto format = static_cast<VideoFrameType>(Format);
+    auto deint  = static_cast<MythDeintType>(Deinterlacer);
+    MythVideoFrame frame(format, 1920, 1088);
+    QVERIFY(frame.m_buffer);
+    FillRandom(&frame);
+
+    MythDeinterlacer deinterlacer;
+    uint64_t counter = 0;
+    QBENCHMARK
+    {
+        Prepare(&frame, deint, true, ++counter);
+        deinterlacer.Filter(&frame, kScan_Interlaced, nullptr);
+        frame.m_alreadyDeinterlaced = false;
+        deinterlacer.Filter(&frame, kScan_Intr2ndField, nullptr);
+    }
+    QVERIFY(frame.m_alreadyDeinterlaced);
+}
+
+QTEST_APPLESS_MAIN(TestDeinterlacer)
+
+#include "moc_test_deinterlacer.cpp"
@@ -0,0 +1,44 @@
+/*
+ *  Class TestDeinterlacer
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#ifndef LIBMYTHTV_TEST_DEINTERLACER_H
+#define LIBMYTHTV_TEST_DEINTERLACER_H
+
+#include <QChar>     // Fix Qt6 GCC SFINAE warning
+#include <QBitArray> // Fix Qt6 GCC SFINAE warning
+#include <QTest>
+
+class TestDeinterlacer : public QObject
+{
+    Q_OBJECT
+
+  private slots:
+    static void TestOneField_data();
+    static void TestOneField();
+    static void TestBlend_data();
+    static void TestBlend();
+    static void TestMotionStill_data();
+    static void TestMotionStill();
+    static void TestMotionMoving_data();
+    static void TestMotionMoving();
+    static void TestSlices_data();
+    static void TestSlices();
+    static void TestThroughput_data();
+    static void TestThroughput();
+};
+
+#endif // LIBMYTHTV_TEST_DEINTERLACER_H
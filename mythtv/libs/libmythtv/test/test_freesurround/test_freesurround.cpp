@@ -0,0 +1,5 @@
+#include "test_freesurround.h"
+
+QTEST_APPLESS_MAIN(TestFreeSurround)
+
+#include "moc_test_freesurround.cpp"
@@ -0,0 +1,398 @@
+/*
+ *  Class TestFreeSurround
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#ifndef LIBMYTHTV_TEST_FREESURROUND_H
+#define LIBMYTHTV_TEST_FREESURROUND_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <numbers>
+#include <vector>
+
+#include <QChar>     // Fix Qt6 GCC SFINAE warning
+#include <QBitArray> // Fix Qt6 GCC SFINAE warning
+#include <QTest>
+#if defined(Q_PROCESSOR_X86) && __has_include(<x86intrin.h>)
+#include <x86intrin.h>
+#endif
+
+#include "libmythtv/audio/freesurround_decoder.h"
+
+/** \class ReferenceSurround
+ *  \brief A plain double precision copy of the FreeSurround decoder.
+ *
+ *  This follows the original decoder step by step, a windowed complex
+ *  FFT, an amplitude and phase per bin, the linear steering with its
+ *  polynomial fits, and an overlap-add of the filtered signals, with
+ *  the default coefficients and phase mode.  It is slow, but it is
+ *  what fsurround_decoder is supposed to produce.
+ */
+class ReferenceSurround
+{
+    using Complex  = std::complex<double>;
+    using Spectrum = std::vector<Complex>;
+
+  public:
+    static constexpr int kChannels { 6 };
+
+    explicit ReferenceSurround(unsigned BlockSize, unsigned SampleRate = 48000)
+      : m_n(BlockSize),
+        m_halfN(BlockSize / 2),
+        m_wnd(BlockSize)
+    {
+        for (unsigned k = 0; k < m_n; ++k)
+            m_wnd[k] = std::sqrt(0.5 * (1 - std::cos(2 * std::numbers::pi * k / m_n)) / m_n);
+        for (auto & channel : m_input)
+            channel.assign(m_n, 0.0);
+        for (auto & filter : m_filter)
+            filter.assign(m_halfN + 1, 0.0);
+        for (auto & tail : m_tail)
+            tail.assign(m_halfN, 0.0);
+        unsigned cutoff = (30 * m_n) / SampleRate;
+        for (unsigned f = 0; f < cutoff && f <= m_halfN; ++f)
+            m_filter[5][f] = 0.5 * std::sqrt(0.5);
+    }
+
+    /// Decode the next half block of stereo input into six half blocks
+    /// of output, in the same order as fsurround_decoder.
+    void Decode(const float *Left, const float *Right,
+                std::array<std::vector<double>, kChannels> &Output,
+                double CenterWidth, double Dimension, double AdaptionRate)
+    {
+        static constexpr double kCenterLevel  { 0.5 * std::numbers::sqrt2 / 2 };
+        static constexpr double kSurroundA    { std::numbers::sqrt2 / std::numbers::sqrt3 };
+        static constexpr double kSurroundB    { std::numbers::inv_sqrt3 };
+        static constexpr double kSurroundLevel { 1 / (kSurroundA + kSurroundB) };
+
+        // The previous half block is in the rising half of the window
+        for (int c = 0; c < 2; ++c)
+        {
+            std::copy(m_input[c].begin() + m_halfN, m_input[c].end(), m_input[c].begin());
+            const float *in = c ? Right : Left;
+            std::copy(in, in + m_halfN, m_input[c].begin() + m_halfN);
+        }
+
+        Spectrum left(m_n);
+        Spectrum right(m_n);
+        for (unsigned k = 0; k < m_n; ++k)
+        {
+            left[k]  = m_input[0][k] * m_wnd[k];
+            right[k] = m_input[1][k] * m_wnd[k];
+        }
+        FFT(left, false);
+        FFT(right, false);
+
+        std::array<Spectrum, kChannels> signal;
+        for (auto & s : signal)
+            s.assign(m_halfN + 1, 0.0);
+
+        for (unsigned f = 0; f < m_halfN; ++f)
+        {
+            double ampL   = std::abs(left[f]);
+            double ampR   = std::abs(right[f]);
+            double phaseL = std::arg(left[f]);
+            double phaseR = std::arg(right[f]);
+
+            double ampDiff = (ampL + ampR < 0.000001) ? 0 : (ampR - ampL) / (ampR + ampL);
+            ampDiff = std::clamp(ampDiff, -1.0, 1.0);
+            double phaseDiff = phaseL - phaseR;
+            if (phaseDiff < -std::numbers::pi)
+                phaseDiff += 2 * std::numbers::pi;
+            if (phaseDiff > std::numbers::pi)
+                phaseDiff -= 2 * std::numbers::pi;
+            phaseDiff = std::abs(phaseDiff);
+
+            double yfs = YFs(ampDiff, phaseDiff);
+            double xfs = XFs(ampDiff, yfs);
+            yfs = std::clamp(yfs - Dimension, -1.0, 1.0);
+            xfs = std::clamp(xfs, -1.0, 1.0);
+
+            double l     = (1 - xfs) / 2;
+            double r     = (1 + xfs) / 2;
+            double front = (1 + yfs) / 2;
+            double back  = (1 - yfs) / 2;
+            std::array<double, 5> volume
+            {
+                front * ((l * CenterWidth) + (std::max(0.0, -xfs) * (1 - CenterWidth))),
+                front * kCenterLevel * ((1 - std::abs(xfs)) * (1 - CenterWidth)),
+                front * ((r * CenterWidth) + (std::max(0.0,  xfs) * (1 - CenterWidth))),
+                back * kSurroundLevel * l,
+                back * kSurroundLevel * r
+            };
+            for (unsigned c = 0; c < 5; ++c)
+                m_filter[c][f] = ((1 - AdaptionRate) * m_filter[c][f]) + (AdaptionRate * volume[c]);
+
+            signal[0][f] = std::polar(ampL + ampR, phaseL);
+            signal[2][f] = std::polar(ampL + ampR, phaseR);
+            signal[1][f] = signal[0][f] + signal[2][f];
+            signal[3][f] = signal[0][f];
+            signal[4][f] = signal[2][f];
+            signal[5][f] = left[f] + right[f];
+        }
+
+        for (int c = 0; c < kChannels; ++c)
+        {
+            Spectrum spectrum(m_n);
+            for (unsigned f = 0; f <= m_halfN; ++f)
+                spectrum[f] = signal[c][f] * m_filter[c][f];
+            for (unsigned f = 1; f < m_halfN; ++f)
+                spectrum[m_n - f] = std::conj(spectrum[f]);
+            FFT(spectrum, true);
+
+            Output[c].resize(m_halfN);
+            for (unsigned k = 0; k < m_halfN; ++k)
+            {
+                Output[c][k] = m_tail[c][k] + (spectrum[k].real() * m_wnd[k]);
+                m_tail[c][k] = spectrum[m_halfN + k].real() * m_wnd[m_halfN + k];
+            }
+        }
+    }
+
+  private:
+    // An unscaled radix-2 FFT, in place
+    void FFT(Spectrum &Data, bool Inverse) const
+    {
+        for (unsigned i = 1, j = 0; i < m_n; ++i)
+        {
+            unsigned bit = m_n >> 1;
+            for (; j & bit; bit >>= 1)
+                j ^= bit;
+            j ^= bit;
+            if (i < j)
+                std::swap(Data[i], Data[j]);
+        }
+        for (unsigned len = 2; len <= m_n; len <<= 1)
+        {
+            double angle = 2 * std::numbers::pi / len * (Inverse ? 1 : -1);
+            for (unsigned i = 0; i < m_n; i += len)
+            {
+                for (unsigned k = 0; k < len / 2; ++k)
+                {
+                    Complex w = std::polar(1.0, angle * k);
+                    Complex u = Data[i + k];
+                    Complex v = Data[i + k + (len / 2)] * w;
+                    Data[i + k]             = u + v;
+                    Data[i + k + (len / 2)] = u - v;
+                }
+            }
+        }
+    }
+
+    static double YFs(double AmpDiff, double PhaseDiff)
+    {
+        double x = 1 - (((1 - (AmpDiff * AmpDiff)) * PhaseDiff) / std::numbers::pi * 2);
+        double tanX = std::tan(x);
+        return 0.16468622925824683 + (0.5009268347818189 * x) - (0.06462757726992101 * x * x)
+            + (0.09170680403453149 * x * x * x) + (0.2617754892323973 * tanX)
+            - (0.04180413533856156 * tanX * tanX);
+    }
+
+    static double XFs(double AmpDiff, double YFs)
+    {
+        double x = AmpDiff;
+        double y = YFs;
+        return (2.464833559224702*x) - (423.52131153259404*x*y) +
+            (67.8557858606918*x*x*x*y) + (788.2429425544392*x*y*y) -
+            (79.97650354902909*x*x*x*y*y) - (513.8966153850349*x*y*y*y) +
+            (35.68117670186306*x*x*x*y*y*y) + (13867.406173420834*y*std::asin(x)) -
+            (2075.8237075786396*y*y*std::asin(x)) - (908.2722068360281*y*y*y*std::asin(x)) -
+            (12934.654772878019*std::asin(x)*std::sin(y)) - (13216.736529661162*y*std::tan(x)) +
+            (1288.6463247741938*y*y*std::tan(x)) + (1384.372969378453*y*y*y*std::tan(x)) +
+            (12699.231471126128*std::sin(y)*std::tan(x)) + (95.37131275594336*std::sin(x)*std::tan(y)) -
+            (91.21223198407546*std::tan(x)*std::tan(y));
+    }
+
+    unsigned                                   m_n;
+    unsigned                                   m_halfN;
+    std::vector<double>                        m_wnd;
+    std::array<std::vector<double>, 2>         m_input;
+    std::array<std::vector<double>, kChannels> m_filter;
+    std::array<std::vector<double>, kChannels> m_tail;
+};
+
+class TestFreeSurround: public QObject
+{
+    Q_OBJECT
+
+    static constexpr unsigned kBlockSize  { 1024 };
+    static constexpr unsigned kHalfBlock  { kBlockSize / 2 };
+    static constexpr int      kBlocks     { 40 };
+    // Output channel order used by fsurround_decoder
+    enum : std::uint8_t { kFL, kC, kFR, kSL, kSR, kLFE, kChannels };
+
+    using Energy = std::array<double, kChannels>;
+
+    // Feed kBlocks blocks of a tone through the decoder, with the right
+    // channel scaled by rightGain, and return the energy of each output
+    // channel.  The first couple of blocks are skipped while the
+    // steering settles.
+    static Energy Decode(float rightGain)
+    {
+        fsurround_decoder decoder(kBlockSize);
+        decoder.sample_rate(48000);
+        Energy energy {};
+
+        for (int block = 0; block < kBlocks; ++block)
+        {
+            float **in = decoder.getInputBuffers();
+            for (unsigned i = 0; i < kHalfBlock; ++i)
+            {
+                auto n = static_cast<float>((block * kHalfBlock) + i);
+                float sample = 0.5F * std::sin(n * 0.05F);
+                in[0][i] = sample;
+                in[1][i] = sample * rightGain;
+            }
+            decoder.decode(0.5F, 0.0F, 1.0F);
+            if (block < 2)
+                continue;
+            float **out = decoder.getOutputBuffers();
+            for (int c = 0; c < kChannels; ++c)
+                for (unsigned i = 0; i < kHalfBlock; ++i)
+                    energy[c] += static_cast<double>(out[c][i]) * out[c][i];
+        }
+        return energy;
+    }
+
+  private slots:
+    // A signal that is identical in both channels is steered to the
+    // front, with nothing left over for the surrounds.
+    static void InPhaseGoesFront(void)
+    {
+        Energy e = Decode(1.0F);
+        double front    = e[kFL] + e[kC] + e[kFR];
+        double surround = e[kSL] + e[kSR];
+        QVERIFY(front > 1.0);
+        QVERIFY(surround < front * 0.01);
+        QVERIFY(e[kC] > e[kFL]);
+        QVERIFY(e[kC] > e[kFR]);
+    }
+
+    // A signal in anti-phase between the channels is steered to the
+    // surrounds, evenly between left and right.
+    static void AntiPhaseGoesSurround(void)
+    {
+        Energy e = Decode(-1.0F);
+        double front    = e[kFL] + e[kC] + e[kFR];
+        double surround = e[kSL] + e[kSR];
+        QVERIFY(surround > 1.0);
+        QVERIFY(front < surround * 0.01);
+        QVERIFY(std::abs(e[kSL] - e[kSR]) < surround * 0.01);
+    }
+
+    // A signal only in the left channel stays on the left.
+    static void HardLeftStaysLeft(void)
+    {
+        Energy e = Decode(0.0F);
+        QVERIFY(e[kFL] > 1.0);
+        QVERIFY(e[kFR] < e[kFL] * 0.01);
+        QVERIFY(e[kSR] < e[kFL] * 0.01);
+    }
+
+    static void MatchesReference_data(void)
+    {
+        QTest::addColumn<float>("centerWidth");
+        QTest::addColumn<float>("dimension");
+        QTest::addColumn<float>("adaptionRate");
+        QTest::newRow("default")  << 1.0F << 0.0F << 1.0F;
+        QTest::newRow("center")   << 0.5F << 0.0F << 1.0F;
+        QTest::newRow("adapting") << 0.7F << 0.2F << 0.3F;
+    }
+
+    // The decoder output matches the reference implementation, for a
+    // mix that puts different bins in different places in the sound
+    // field.  A block size with a few LFE bins is used.
+    static void MatchesReference(void)
+    {
+        QFETCH(float, centerWidth);
+        QFETCH(float, dimension);
+        QFETCH(float, adaptionRate);
+
+        static constexpr unsigned kSize { 4096 };
+        static constexpr unsigned kHalf { kSize / 2 };
+        fsurround_decoder decoder(kSize);
+        decoder.sample_rate(48000);
+        ReferenceSurround reference(kSize, 48000);
+        std::array<std::vector<double>, kChannels> expected;
+
+        double worst = 0.0;
+        double peak  = 0.0;
+        uint32_t seed = 12345;
+        for (int block = 0; block < 8; ++block)
+        {
+            float **in = decoder.getInputBuffers();
+            for (unsigned i = 0; i < kHalf; ++i)
+            {
+                auto n = static_cast<double>((block * kHalf) + i);
+                seed = (seed * 1664525) + 1013904223;
+                double noise = ((seed >> 8) / static_cast<double>(1 << 24)) - 0.5;
+                double centre   = 0.3 * std::sin(n * 0.031);
+                double left     = 0.2 * std::sin(n * 0.107);
+                double surround = 0.2 * std::sin(n * 0.211);
+                double bass     = 0.2 * std::sin(n * 0.003);
+                in[0][i] = static_cast<float>(centre + left + surround + bass + (0.05 * noise));
+                in[1][i] = static_cast<float>(centre - surround + bass + (0.03 * noise));
+            }
+            reference.Decode(in[0], in[1], expected, centerWidth, dimension, adaptionRate);
+            decoder.decode(centerWidth, dimension, adaptionRate);
+
+            float **out = decoder.getOutputBuffers();
+            for (int c = 0; c < kChannels; ++c)
+            {
+                for (unsigned i = 0; i < kHalf; ++i)
+                {
+                    worst = std::max(worst, std::abs(out[c][i] - expected[c][i]));
+                    peak  = std::max(peak, std::abs(expected[c][i]));
+                }
+            }
+        }
+        QVERIFY(peak > 0.1);
+        QVERIFY2(worst < 1e-4, qPrintable(QString("difference %1").arg(worst)));
+    }
+
+    static void DecodeSpeed(void)
+    {
+        fsurround_decoder decoder(kBlockSize);
+        decoder.sample_rate(48000);
+        float **in = decoder.getInputBuffers();
+        for (unsigned i = 0; i < kHalfBlock; ++i)
+        {
+            in[0][i] = std::sin(static_cast<float>(i) * 0.05F);
+            in[1][i] = std::sin(static_cast<float>(i) * 0.03F);
+        }
+#if defined(Q_PROCESSOR_X86) && __has_include(<x86intrin.h>)
+        // Report the time stamp counter cycles taken by one block.
+        static constexpr int kRuns { 200 };
+        decoder.decode(0.5F, 0.2F, 0.7F);
+        uint64_t start = __rdtsc();
+        for (int i = 0; i < kRuns; ++i)
+            decoder.decode(0.5F, 0.2F, 0.7F);
+        uint64_t cycles = __rdtsc() - start;
+        QTest::setBenchmarkResult(static_cast<qreal>(cycles) / kRuns,
+                                  QTest::CPUTicks);
+#else
+        QBENCHMARK
+        {
+            decoder.decode(0.5F, 0.2F, 0.7F);
+        }
+#endif
+    }
+};
+
+#endif // LIBMYTHTV_TEST_FREESURROUND_H
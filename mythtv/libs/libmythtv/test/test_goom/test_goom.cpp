@@ -0,0 +1,175 @@
+/*
+ *  Class TestGoom
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#include "test_goom.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#include "libmythtv/visualisations/goom/goom_core.h"
+#include "libmythtv/visualisations/visualrenderer.h"
+
+// frames rendered for each frame rate
+static constexpr int kFrames { 200 };
+
+/// The samples of frame Frame of a beating chord.
+static void FillAudio(GoomDualData& Data, int Frame)
+{
+    const double beat = (Frame % 10 < 2) ? 1.0 : 0.3;
+    for (size_t i = 0; i < Data[0].size(); i++)
+    {
+        double t = static_cast<double>((Frame * Data[0].size()) + i) / 44100.0;
+        double sample = (std::sin(2 * M_PI * 110.0 * t) + std::sin(2 * M_PI * 440.0 * t) +
+                         std::sin(2 * M_PI * 1760.0 * t)) / 3.0;
+        Data[0][i] = static_cast<int16_t>(std::lround(beat * 30000 * sample));
+        Data[1][i] = static_cast<int16_t>(std::lround(beat * 30000 * sample * 0.8));
+    }
+}
+
+static uint32_t* RenderFrames(int Count)
+{
+    GoomDualData data {};
+    uint32_t* buffer = nullptr;
+    for (int frame = 0; frame < Count; frame++)
+    {
+        FillAudio(data, frame);
+        buffer = goom_update(data, 0);
+    }
+    return buffer;
+}
+
+static bool IsBlank(const uint32_t* Buffer, int Width, int Height)
+{
+    return std::all_of(Buffer, Buffer + (static_cast<ptrdiff_t>(Width) * Height),
+                       [](uint32_t Pixel) { return (Pixel & 0xffffff) == 0; });
+}
+
+void TestGoom::TestRender()
+{
+    goom_init(320, 180, 0);
+    uint32_t* buffer = RenderFrames(50);
+    QVERIFY(buffer != nullptr);
+    QVERIFY(!IsBlank(buffer, 320, 180));
+    goom_close();
+}
+
+void TestGoom::TestResolution()
+{
+    goom_init(320, 180, 0);
+    RenderFrames(10);
+    goom_set_resolution(640, 360, 0);
+    uint32_t* buffer = RenderFrames(50);
+    QVERIFY(buffer != nullptr);
+    QVERIFY(!IsBlank(buffer, 640, 360));
+    goom_close();
+}
+
+void TestGoom::TestRenderer()
+{
+    const QSize size(320, 180);
+    goom_init(static_cast<uint32_t>(size.width()), static_cast<uint32_t>(size.height()), 0);
+    {
+        VisualRenderer renderer("TestGoom", [](const VisualRenderer::Samples& Input,
+                                               QSize Size, QImage& Image)
+        {
+            GoomDualData data {};
+            std::copy(Input.m_left.cbegin(), Input.m_left.cend(), data[0].begin());
+            std::copy(Input.m_right.cbegin(), Input.m_right.cend(), data[1].begin());
+            uint32_t* buffer = goom_update(data, 0);
+            if (Image.size() != Size)
+                Image = QImage(Size, QImage::Format_RGB32);
+            memcpy(Image.bits(), buffer, static_cast<size_t>(Image.sizeInBytes()));
+            return true;
+        });
+
+        // nothing is drawn until there is a size and samples
+        QVERIFY(renderer.Frame().isNull());
+        renderer.SetSize(size);
+
+        GoomDualData data {};
+        for (int frame = 0; frame < 50; frame++)
+        {
+            FillAudio(data, frame);
+            VisualRenderer::Samples input;
+            input.m_left.assign(data[0].cbegin(), data[0].cend());
+            input.m_right.assign(data[1].cbegin(), data[1].cend());
+            renderer.Post(std::move(input));
+            QThread::msleep(2);
+        }
+
+        // frames that could not be drawn in time are dropped, the last is not
+        uint64_t serial = 0;
+        QImage frame;
+        for (int i = 0; i < 500; i++)
+        {
+            uint64_t last = serial;
+            frame = renderer.Frame(&serial);
+            if (serial > 0 && serial == last)
+                break;
+            QThread::msleep(10);
+        }
+        QVERIFY(serial > 0);
+        QVERIFY(serial <= 50);
+        QCOMPARE(frame.size(), size);
+        QVERIFY(!IsBlank(reinterpret_cast<const uint32_t*>(frame.constBits()),
+                         size.width(), size.height()));
+    }
+    goom_close();
+}
+
+void TestGoom::TestFrameRate_data()
+{
+    QTest::addColumn<int>("Width");
+    QTest::addColumn<int>("Height");
+    QTest::newRow("320x180")   << 320  << 180;
+    QTest::newRow("640x360")   << 640  << 360;
+    QTest::newRow("1280x720")  << 1280 << 720;
+    QTest::newRow("1920x1080") << 1920 << 1080;
+}
+
+/// Renders kFrames frames of goom and reports the frame rate.
+void TestGoom::TestFrameRate()
+{
+    QFETCH(int, Width);
+    QFETCH(int, Height);
+    goom_init(static_cast<uint32_t>(Width), static_cast<uint32_t>(Height), 0);
+
+    QElapsedTimer timer;
+    timer.start();
+    uint32_t* buffer = RenderFrames(kFrames);
+    qint64 elapsed = std::max<qint64>(timer.nsecsElapsed(), 1);
+    QVERIFY(buffer != nullptr);
+    qInfo() << Width << "x" << Height << ":" << kFrames << "frames at"
+            << (kFrames * 1.0E9 / static_cast<double>(elapsed)) << "fps";
+
+    GoomDualData data {};
+    int frame = 0;
+    QBENCHMARK
+    {
+        FillAudio(data, frame++);
+        goom_update(data, 0);
+    }
+    goom_close();
+}
+
+QTEST_APPLESS_MAIN(TestGoom)
+
+#include "moc_test_goom.cpp"
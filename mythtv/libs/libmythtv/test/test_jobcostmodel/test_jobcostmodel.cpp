@@ -0,0 +1,5 @@
+#include "test_jobcostmodel.h"
+
+QTEST_APPLESS_MAIN(TestJobCostModel)
+
+#include "moc_test_jobcostmodel.cpp"
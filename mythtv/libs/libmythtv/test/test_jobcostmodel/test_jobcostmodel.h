@@ -0,0 +1,162 @@
+/*
+ *  Class TestJobCostModel
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#ifndef LIBMYTHTV_TEST_JOBCOSTMODEL_H
+#define LIBMYTHTV_TEST_JOBCOSTMODEL_H
+
+#include <cmath>
+
+#include <QChar>     // Fix Qt6 GCC SFINAE warning
+#include <QBitArray> // Fix Qt6 GCC SFINAE warning
+#include <QTest>
+
+#include "libmythtv/jobcostmodel.h"
+#include "libmythtv/jobqueue.h"
+
+class TestJobCostModel: public QObject
+{
+    Q_OBJECT
+
+    /// A run of \a Seconds using \a Cores on average
+    static JobUsage Usage(double Cores, int Seconds, double PeakMB = 100.0)
+    {
+        JobUsage usage;
+        usage.m_elapsed = std::chrono::seconds(Seconds);
+        usage.m_cpu     = std::chrono::milliseconds(std::llround(Cores * Seconds * 1000));
+        usage.m_ioBytes = static_cast<uint64_t>(Seconds) * 1048576;
+        usage.m_peakMB  = PeakMB;
+        return usage;
+    }
+
+  private slots:
+    static void ParseProcStat(void)
+    {
+        uint64_t busy = 0;
+        uint64_t total = 0;
+        QVERIFY(JobCostModel::ParseProcStat(
+            "cpu  100 20 30 400 50 5 5 0 0 0\ncpu0 50 10 15 200 25 2 3 0 0 0\n",
+            busy, total));
+        QCOMPARE(total, UINT64_C(610));
+        QCOMPARE(busy, UINT64_C(160));
+        QVERIFY(!JobCostModel::ParseProcStat("intr 1 2 3 4 5\n", busy, total));
+        QVERIFY(!JobCostModel::ParseProcStat("cpu 1 x 3 4 5\n", busy, total));
+    }
+
+    static void ParseMemAvailable(void)
+    {
+        QCOMPARE(JobCostModel::ParseMemAvailable(
+                     "MemTotal:        8000000 kB\nMemFree:  100 kB\n"
+                     "MemAvailable:    2097152 kB\n"), 2048.0);
+        QCOMPARE(JobCostModel::ParseMemAvailable("MemTotal: 8000000 kB\n"), -1.0);
+    }
+
+    static void Learn(void)
+    {
+        JobCostModel model;
+        QCOMPARE(model.GetCost(JOB_TRANSCODE).m_cores, 2.0);
+
+        // The first run replaces the guess
+        model.Learn(JOB_TRANSCODE, Usage(1.5, 100, 500.0), 600s);
+        JobCost cost = model.GetCost(JOB_TRANSCODE);
+        QCOMPARE(cost.m_cores, 1.5);
+        QCOMPARE(cost.m_ioMBps, 1.0);
+        QCOMPARE(cost.m_memoryMB, 500.0);
+        QCOMPARE(cost.m_duration.count(), INT64_C(600));
+        QCOMPARE(cost.m_samples, 1);
+
+        model.Learn(JOB_TRANSCODE, Usage(2.5, 100, 500.0), 1200s);
+        cost = model.GetCost(JOB_TRANSCODE);
+        QVERIFY(qFuzzyCompare(cost.m_cores, 1.8));
+        QCOMPARE(cost.m_duration.count(), INT64_C(780));
+        QCOMPARE(cost.m_samples, 2);
+
+        // Too short to sample, only the duration is learned
+        model.Learn(JOB_TRANSCODE, JobUsage(), 780s);
+        QVERIFY(qFuzzyCompare(model.GetCost(JOB_TRANSCODE).m_cores, 1.8));
+        QCOMPARE(model.GetCost(JOB_TRANSCODE).m_samples, 3);
+    }
+
+    static void Admit(void)
+    {
+        JobCostModel model;
+        JobHostLoad load { 4.0, 0.0, 4096.0 };
+
+        // Nothing running, anything goes
+        QVERIFY(model.Admit(JOB_TRANSCODE, {}, { 1.0, 1.0, 0.0 }));
+
+        QVERIFY(model.Admit(JOB_COMMFLAG, { JOB_TRANSCODE }, load));
+        QVERIFY(!model.Admit(JOB_TRANSCODE, { JOB_TRANSCODE, JOB_TRANSCODE }, load));
+
+        // Busy with something other than jobs
+        load.m_busyCores = 3.5;
+        QVERIFY(!model.Admit(JOB_COMMFLAG, { JOB_METADATA }, load));
+        QVERIFY(model.Admit(JOB_METADATA, { JOB_METADATA }, load));
+
+        // Short of memory, unless that is unknown
+        load = { 4.0, 0.0, 300.0 };
+        QVERIFY(!model.Admit(JOB_COMMFLAG, { JOB_METADATA }, load));
+        load.m_availableMB = -1.0;
+        QVERIFY(model.Admit(JOB_COMMFLAG, { JOB_METADATA }, load));
+
+        // Plenty of cores, but not of disk bandwidth
+        load = { 16.0, 0.0, 16384.0 };
+        QList<int> previews(7, JOB_PREVIEW);
+        QVERIFY(!model.Admit(JOB_PREVIEW, previews, load));
+        previews.removeLast();
+        QVERIFY(model.Admit(JOB_PREVIEW, previews, load));
+    }
+
+    static void Priority(void)
+    {
+        JobCostModel model;
+        QVERIFY(model.Priority(JOB_METADATA, 0s) < model.Priority(JOB_COMMFLAG, 0s));
+        QVERIFY(model.Priority(JOB_PREVIEW, 0s) < model.Priority(JOB_TRANSCODE, 0s));
+        // Waiting long enough gets any job to the front
+        QVERIFY(model.Priority(JOB_TRANSCODE, 30min) < model.Priority(JOB_METADATA, 0s));
+    }
+
+    static void RoundTrip(void)
+    {
+        JobCostModel model;
+        QCOMPARE(model.ToString(), QString());
+        QVERIFY(model.FromString(""));
+
+        model.Learn(JOB_METADATA, JobUsage(), 20s);
+        model.Learn(JOB_USERJOB2, Usage(0.5, 10, 64.0), 10s);
+        QString saved = model.ToString();
+        QCOMPARE(saved, QString("4:0.100,0.000,100.0,20,1;512:0.500,1.000,64.0,10,1"));
+
+        JobCostModel copy;
+        QVERIFY(copy.FromString(saved));
+        QCOMPARE(copy.ToString(), saved);
+        QCOMPARE(copy.GetCost(JOB_USERJOB2).m_cores, 0.5);
+    }
+
+    static void BadString(void)
+    {
+        JobCostModel model;
+        QVERIFY(!model.FromString("4:1,2,3"));
+        QVERIFY(!model.FromString("x:1,2,3,4,5"));
+        QVERIFY(!model.FromString("4:1,2,3,4,0"));
+        QVERIFY(!model.FromString("4:-1,2,3,4,5"));
+        // Nothing is taken from a bad string
+        QVERIFY(!model.FromString("4:1,2,3,4,5;8:1,2"));
+        QCOMPARE(model.GetCost(JOB_METADATA).m_samples, 0);
+    }
+};
+
+#endif // LIBMYTHTV_TEST_JOBCOSTMODEL_H
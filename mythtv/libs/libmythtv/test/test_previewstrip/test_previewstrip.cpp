@@ -0,0 +1,5 @@
+#include "test_previewstrip.h"
+
+QTEST_APPLESS_MAIN(TestPreviewStrip)
+
+#include "moc_test_previewstrip.cpp"
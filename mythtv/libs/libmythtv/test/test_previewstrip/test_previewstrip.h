@@ -0,0 +1,211 @@
+/*
+ *  Class TestPreviewStrip
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#ifndef LIBMYTHTV_TEST_PREVIEWSTRIP_H
+#define LIBMYTHTV_TEST_PREVIEWSTRIP_H
+
+#include <chrono>
+
+#include <QChar>     // Fix Qt6 GCC SFINAE warning
+#include <QBitArray> // Fix Qt6 GCC SFINAE warning
+#include <QColor>
+#include <QImage>
+#include <QTest>
+
+#include "libmythtv/previewstrip.h"
+#include "libmythtv/previewstripbuilder.h"
+
+class TestPreviewStrip: public QObject
+{
+    Q_OBJECT
+
+    static constexpr int kTiles { 25 };
+
+    /// A strip of kTiles 16x9 tiles, 300 frames apart, each filled with the
+    /// grey level of its index.
+    static void MakeStrip(PreviewStrip &Strip)
+    {
+        QSize tile = Strip.GetTileSize();
+        int rows = (kTiles + Strip.GetColumns() - 1) / Strip.GetColumns();
+        QImage image(Strip.GetColumns() * tile.width(), rows * tile.height(),
+                     QImage::Format_RGB32);
+        image.fill(Qt::black);
+        for (int i = 0; i < kTiles; ++i)
+        {
+            Strip.AddTile(static_cast<uint64_t>(i) * 300,
+                          std::chrono::milliseconds(i * 10000));
+            QRect rect = Strip.TileRect(i);
+            for (int y = rect.top(); y <= rect.bottom(); ++y)
+                for (int x = rect.left(); x <= rect.right(); ++x)
+                    image.setPixel(x, y, qRgb(i * 10, i * 10, i * 10));
+        }
+        Strip.SetImage(image);
+    }
+
+  private slots:
+    static void Filenames(void)
+    {
+        QCOMPARE(PreviewStrip::IndexFilename("/rec/1001_20260101.ts"),
+                 QString("/rec/1001_20260101.ts.strip"));
+        QCOMPARE(PreviewStrip::ImageFilename("myth://Default@be/1001_20260101.ts"),
+                 QString("myth://Default@be/1001_20260101.ts.strip.jpg"));
+    }
+
+    static void TileLayout(void)
+    {
+        PreviewStrip strip(QSize(16, 9), 10);
+        QCOMPARE(strip.TileRect(0),  QRect(0, 0, 16, 9));
+        QCOMPARE(strip.TileRect(9),  QRect(144, 0, 16, 9));
+        QCOMPARE(strip.TileRect(10), QRect(0, 9, 16, 9));
+        QCOMPARE(strip.TileRect(23), QRect(48, 18, 16, 9));
+    }
+
+    static void FindTile(void)
+    {
+        PreviewStrip strip(QSize(16, 9));
+        QCOMPARE(strip.FindTile(0), -1);
+
+        MakeStrip(strip);
+        QCOMPARE(strip.GetCount(), kTiles);
+        QCOMPARE(strip.FindTile(0), 0);
+        QCOMPARE(strip.FindTile(299), 0);
+        QCOMPARE(strip.FindTile(300), 1);
+        QCOMPARE(strip.FindTile(4000), 13);
+        QCOMPARE(strip.FindTile(1000000), kTiles - 1);
+    }
+
+    static void Thumbnail(void)
+    {
+        PreviewStrip strip(QSize(16, 9));
+        QVERIFY(strip.GetThumbnail(0).isNull());
+
+        MakeStrip(strip);
+        QVERIFY(strip.IsValid());
+        QImage thumbnail = strip.GetThumbnail(3700);
+        QCOMPARE(thumbnail.size(), QSize(16, 9));
+        QCOMPARE(thumbnail.pixel(0, 0), qRgb(120, 120, 120));
+        QCOMPARE(thumbnail.pixel(15, 8), qRgb(120, 120, 120));
+    }
+
+    static void ImageTooSmall(void)
+    {
+        PreviewStrip strip(QSize(16, 9));
+        MakeStrip(strip);
+        strip.SetImage(QImage(160, 18, QImage::Format_RGB32));
+        QVERIFY(!strip.IsValid());
+        QVERIFY(strip.GetThumbnail(0).isNull());
+    }
+
+    static void IndexRoundTrip(void)
+    {
+        PreviewStrip strip(QSize(16, 9), 8);
+        MakeStrip(strip);
+        QByteArray index = strip.ToIndex();
+        QVERIFY(index.startsWith("MythPreviewStrip 1\ntile 16 9\ncolumns 8\n0 0\n300 10000\n"));
+
+        PreviewStrip copy;
+        QVERIFY(copy.FromIndex(index));
+        QCOMPARE(copy.GetTileSize(), QSize(16, 9));
+        QCOMPARE(copy.GetColumns(), 8);
+        QCOMPARE(copy.GetCount(), kTiles);
+        QCOMPARE(copy.GetTile(24).m_frame, UINT64_C(7200));
+        QCOMPARE(copy.GetTile(24).m_time.count(), INT64_C(240000));
+        QCOMPARE(copy.ToIndex(), index);
+    }
+
+    static void BadIndex(void)
+    {
+        PreviewStrip strip;
+        QVERIFY(!strip.FromIndex(""));
+        QVERIFY(!strip.FromIndex("MythPreviewStrip 2\ntile 16 9\ncolumns 10\n0 0\n"));
+        QVERIFY(!strip.FromIndex("MythPreviewStrip 1\ntile 0 9\ncolumns 10\n0 0\n"));
+        QVERIFY(!strip.FromIndex("MythPreviewStrip 1\ntile 16 9\ncolumns 10\n0\n"));
+        // Out of order frames would break the lookup
+        QVERIFY(!strip.FromIndex("MythPreviewStrip 1\ntile 16 9\ncolumns 10\n300 10000\n0 0\n"));
+        QVERIFY(strip.FromIndex("MythPreviewStrip 1\ntile 16 9\ncolumns 10\n0 0\n300 10000"));
+        QCOMPARE(strip.GetCount(), 2);
+    }
+
+    static void SelectFromPositionMap(void)
+    {
+        // A GOP every 12 frames at 25fps, so one tile every 21st GOP
+        frm_pos_map_t posMap;
+        for (long long gop = 0; gop <= 1000; ++gop)
+            posMap[gop] = gop * 100000;
+        auto keys = PreviewStripBuilder::SelectKeyFrames(posMap, 12, 12000, 25.0, true);
+        QCOMPARE(keys.size(), static_cast<qsizetype>(48));
+        QCOMPARE(keys[0].m_frame, UINT64_C(0));
+        QCOMPARE(keys[0].m_offset, INT64_C(0));
+        QCOMPARE(keys[1].m_frame, UINT64_C(252));
+        QCOMPARE(keys[1].m_offset, INT64_C(2100000));
+        QCOMPARE(keys[2].m_frame, UINT64_C(504));
+        for (int i = 1; i < keys.size(); ++i)
+            QVERIFY(keys[i].m_frame - keys[i - 1].m_frame >= 250);
+    }
+
+    static void SelectByTime(void)
+    {
+        // No position map, or one that can't be used for byte seeks
+        frm_pos_map_t posMap;
+        auto keys = PreviewStripBuilder::SelectKeyFrames(posMap, 1, 1000, 25.0, true);
+        QCOMPARE(keys.size(), static_cast<qsizetype>(5));
+        QCOMPARE(keys[3].m_frame, UINT64_C(750));
+        QCOMPARE(keys[3].m_offset, INT64_C(-1));
+
+        posMap[0] = 0;
+        posMap[1000] = 1000000;
+        keys = PreviewStripBuilder::SelectKeyFrames(posMap, 1, 1000, 25.0, false);
+        QCOMPARE(keys.size(), static_cast<qsizetype>(5));
+        QCOMPARE(keys[1].m_offset, INT64_C(-1));
+    }
+
+    static void SelectLongRecording(void)
+    {
+        // Ten hours spreads the tiles out instead of exceeding the limit
+        frm_pos_map_t posMap;
+        uint64_t total = UINT64_C(25) * 3600 * 10;
+        for (uint64_t frame = 0; frame <= total; frame += 12)
+            posMap[static_cast<long long>(frame)] = static_cast<long long>(frame) * 1000;
+        auto keys = PreviewStripBuilder::SelectKeyFrames(posMap, 1, total, 25.0, true);
+        QCOMPARE(keys.size(), static_cast<qsizetype>(PreviewStripBuilder::kMaxTiles));
+        QCOMPARE(keys[1].m_frame, UINT64_C(900));
+
+        keys = PreviewStripBuilder::SelectKeyFrames({}, 1, total * 10, 25.0, true);
+        QCOMPARE(keys.size(), static_cast<qsizetype>(PreviewStripBuilder::kMaxTiles));
+    }
+
+    static void Tiling(void)
+    {
+        QCOMPARE(PreviewStripBuilder::TileSize(1920, 1080, 1.0), QSize(160, 90));
+        QCOMPARE(PreviewStripBuilder::TileSize(1920, 1080, 0.0), QSize(160, 90));
+        QCOMPARE(PreviewStripBuilder::TileSize(720, 576, 16.0 / 15.0), QSize(160, 120));
+        QCOMPARE(PreviewStripBuilder::TileSize(720, 576, 64.0 / 45.0), QSize(160, 90));
+        QCOMPARE(PreviewStripBuilder::TileSize(0, 0, 1.0), QSize(160, 90));
+
+        QCOMPARE(PreviewStripBuilder::ImageSize(QSize(16, 9), 10, 25), QSize(160, 27));
+        QCOMPARE(PreviewStripBuilder::ImageSize(QSize(16, 9), 10, 20), QSize(160, 18));
+        QCOMPARE(PreviewStripBuilder::ImageSize(QSize(16, 9), 10, 1), QSize(160, 9));
+
+        // Every tile of the builder's image is inside it
+        PreviewStrip strip(QSize(16, 9));
+        QRect image(QPoint(0, 0), PreviewStripBuilder::ImageSize(QSize(16, 9), 10, 25));
+        QVERIFY(image.contains(strip.TileRect(24)));
+        QVERIFY(!image.contains(strip.TileRect(30)));
+    }
+};
+
+#endif // LIBMYTHTV_TEST_PREVIEWSTRIP_H
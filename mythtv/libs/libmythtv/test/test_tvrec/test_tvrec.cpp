@@ -0,0 +1,125 @@
+/*
+ *  Class TestTVRec
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#include "test_tvrec.h"
+
+#include "libmythtv/standbytuner.h"
+#include "libmythtv/tv_rec.h"
+
+/// A tuning request must not carry the bits of a group it is not part of,
+/// or it is handled as a request of that group as well.
+void TestTVRec::TestTuningFlags()
+{
+    QCOMPARE(TVRec::kFlagNoRec & TVRec::kFlagStandby, 0U);
+    QCOMPARE(TVRec::kFlagRec & TVRec::kFlagStandby, 0U);
+    QCOMPARE(TVRec::kFlagKillRingBuffer & TVRec::kFlagStandby, 0U);
+    QCOMPARE(TVRec::kFlagPendingActions & TVRec::kFlagStandby, 0U);
+    QCOMPARE(TVRec::kFlagAnyRunning & TVRec::kFlagStandby, 0U);
+    QCOMPARE(TVRec::kFlagNoRec & TVRec::kFlagRec, 0U);
+}
+
+/// An input is on standby for one LiveTV session at a time, and only
+/// needs to be tuned when the channel changes.
+void TestTVRec::TestStandbyHold()
+{
+    QDateTime now = QDateTime::currentDateTimeUtc();
+    StandbyTuner standby;
+
+    QVERIFY(!standby.IsExpired(now));
+    QCOMPARE(standby.Set(0, CHANNEL_DIRECTION_UP, "5", now),
+             StandbyTuner::Hold::kRefused);
+    QCOMPARE(standby.Set(1, CHANNEL_DIRECTION_UP, "5", now),
+             StandbyTuner::Hold::kRetune);
+    QCOMPARE(standby.Set(1, CHANNEL_DIRECTION_UP, "5", now),
+             StandbyTuner::Hold::kKept);
+    QCOMPARE(standby.Set(1, CHANNEL_DIRECTION_DOWN, "5", now),
+             StandbyTuner::Hold::kMoved);
+    QCOMPARE(standby.Set(2, CHANNEL_DIRECTION_UP, "7", now),
+             StandbyTuner::Hold::kRefused);
+    QVERIFY(standby.IsHeld(1, "5"));
+    QVERIFY(!standby.IsHeld(2, "5"));
+    QVERIFY(!standby.IsHeld(1, "7"));
+
+    // Not renewed in time
+    QVERIFY(!standby.IsExpired(now.addSecs(StandbyTuner::kTimeout.count())));
+    QVERIFY(standby.IsExpired(now.addSecs(StandbyTuner::kTimeout.count() + 1)));
+
+    // Released by another session, and then by its own
+    QVERIFY(!standby.Release(2));
+    QVERIFY(!standby.IsExpired(now));
+    QVERIFY(standby.Release(1));
+    QVERIFY(standby.IsExpired(now));
+
+    // Renewing it takes back the release
+    QCOMPARE(standby.Set(1, CHANNEL_DIRECTION_DOWN, "5", now),
+             StandbyTuner::Hold::kKept);
+    QVERIFY(!standby.IsExpired(now));
+
+    standby.Clear();
+    QCOMPARE(standby.GetOwner(), 0U);
+    QVERIFY(standby.GetChannel().isEmpty());
+    QVERIFY(!standby.IsExpired(now));
+    QCOMPARE(standby.Set(2, CHANNEL_DIRECTION_UP, "7", now),
+             StandbyTuner::Hold::kRetune);
+}
+
+/// Switching LiveTV to an input on standby: the frontend claims the
+/// input, then stops LiveTV on the old input, which releases all its
+/// standby inputs. Only the one that was not claimed is let go.
+void TestTVRec::TestStandbySwitch()
+{
+    static constexpr uint kOwner { 1 };
+    QDateTime now = QDateTime::currentDateTimeUtc();
+    StandbyTuner up;
+    StandbyTuner down;
+    QCOMPARE(up.Set(kOwner, CHANNEL_DIRECTION_UP, "6", now),
+             StandbyTuner::Hold::kRetune);
+    QCOMPARE(down.Set(kOwner, CHANNEL_DIRECTION_DOWN, "4", now),
+             StandbyTuner::Hold::kRetune);
+
+    // Only the session it is on standby for can claim it, on its channel
+    QVERIFY(!up.Claim(2, "6", now));
+    QVERIFY(!up.Claim(kOwner, "4", now));
+    QVERIFY(up.Claim(kOwner, "6", now));
+    QVERIFY(up.IsClaimed());
+
+    // StopLiveTV on the owner, TVRec::ReleaseStandbyInputs()
+    QVERIFY(!up.Release(kOwner));
+    QVERIFY(down.Release(kOwner));
+    QVERIFY(!up.IsExpired(now));
+    QVERIFY(down.IsExpired(now));
+
+    // A claimed input isn't put on standby for anything else meanwhile
+    QCOMPARE(up.Set(2, CHANNEL_DIRECTION_UP, "8", now),
+             StandbyTuner::Hold::kRefused);
+    QCOMPARE(up.Set(kOwner, CHANNEL_DIRECTION_UP, "7", now),
+             StandbyTuner::Hold::kRefused);
+    QVERIFY(up.IsHeld(kOwner, "6"));
+
+    // The claim ends if LiveTV never arrives
+    QVERIFY(!up.IsExpired(now.addSecs(StandbyTuner::kClaimTimeout.count())));
+    QVERIFY(up.IsExpired(now.addSecs(StandbyTuner::kClaimTimeout.count() + 1)));
+
+    // LiveTV tuning the channel ends the standby
+    up.Clear();
+    QVERIFY(!up.IsClaimed());
+    QVERIFY(!up.IsHeld(kOwner, "6"));
+}
+
+QTEST_APPLESS_MAIN(TestTVRec)
+
+#include "moc_test_tvrec.cpp"
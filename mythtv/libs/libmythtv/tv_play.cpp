@@ -6041,6 +6041,20 @@ void TV::ChangeChannel(ChannelChangeDirection Direction)
         }
     }
 
+    // The backend may have the next channel tuned on another input
+    if (Direction == CHANNEL_DIRECTION_UP || Direction == CHANNEL_DIRECTION_DOWN)
+    {
+        uint cardid = m_playerContext.GetCardID();
+        for (auto it = m_standbyInputs.cbegin(); it != m_standbyInputs.cend(); ++it)
+        {
+            if (it->m_owner == cardid && it->m_direction == Direction)
+            {
+                ChangeChannel(it->m_chanId, it->m_chanNum);
+                return;
+            }
+        }
+    }
+
     if (Direction == CHANNEL_DIRECTION_FAVORITE)
         Direction = CHANNEL_DIRECTION_UP;
 
@@ -6100,6 +6114,18 @@ static uint get_chanid(const PlayerContext *ctx,
     return chanid;
 }
 
+/// Returns an input on standby on channel \a Chanid, or 0 if there is none.
+uint TV::GetStandbyInput(uint Chanid) const
+{
+    uint cardid = m_playerContext.GetCardID();
+    for (auto it = m_standbyInputs.cbegin(); it != m_standbyInputs.cend(); ++it)
+    {
+        if (Chanid && it->m_chanId == Chanid && it.key() != cardid)
+            return it.key();
+    }
+    return 0;
+}
+
 void TV::ChangeChannel(uint Chanid, const QString &Channum)
 {
     LOG(VB_CHANNEL, LOG_INFO, LOC + QString("(%1, '%2')").arg(Chanid).arg(Channum));
@@ -6211,6 +6237,45 @@ void TV::ChangeChannel(uint Chanid, const QString &Channum)
     if (getit || !m_playerContext.m_recorder || !m_playerContext.m_recorder->CheckChannel(channum))
         return;
 
+    // Switching to an input that is already tuned to the channel is
+    // faster than tuning this one, if it is still free.
+    if (kPseudoNormalLiveTV == m_playerContext.m_pseudoLiveTVState)
+    {
+        if (!Chanid)
+            Chanid = get_chanid(&m_playerContext, m_playerContext.GetCardID(), channum);
+        uint standby = GetStandbyInput(Chanid);
+        if (standby)
+        {
+            RemoteEncoder *testrec = RemoteRequestFreeRecorderFromList(
+                QStringList(QString::number(standby)), m_playerContext.GetCardID());
+            bool free = testrec && testrec->IsValidRecorder();
+            // Stopping LiveTV here releases the inputs on standby for it,
+            // so keep the one being switched to first.
+            if (free && !testrec->ClaimStandby(m_playerContext.GetCardID(), channum))
+            {
+                LOG(VB_CHANNEL, LOG_INFO, LOC +
+                    QString("Input %1 is no longer on standby for %2")
+                        .arg(standby).arg(channum));
+            }
+            delete testrec;
+            if (free)
+            {
+                LOG(VB_CHANNEL, LOG_INFO, LOC +
+                    QString("Switching to input %1 on standby for %2")
+                        .arg(standby).arg(channum));
+                if (!m_playerContext.m_prevChan.empty() &&
+                    m_playerContext.m_prevChan.back() == channum)
+                {
+                    m_playerContext.m_prevChan.pop_back();
+                }
+                if (m_playerContext.m_prevChan.empty())
+                    m_playerContext.PushPreviousChannel();
+                SwitchInputs(Chanid, channum, standby);
+                return;
+            }
+        }
+    }
+
     if (ContextIsPaused(__FILE__, __LINE__))
     {
         HideOSDWindow(OSD_WIN_STATUS);
@@ -7559,6 +7624,26 @@ void TV::customEvent(QEvent *Event)
         ReturnPlayerLock();
     }
 
+    if (message.startsWith("LIVETV_STANDBY") && (tokens.size() >= 2))
+    {
+        // "LIVETV_STANDBY <input> <owner> <direction> <chanid> <channum>"
+        // when an input is ready on a channel, "LIVETV_STANDBY <input>"
+        // when it is no longer on standby.
+        uint inputid = tokens[1].toUInt();
+        if (tokens.size() >= 6)
+        {
+            StandbyInput &standby = m_standbyInputs[inputid];
+            standby.m_owner     = tokens[2].toUInt();
+            standby.m_direction = static_cast<ChannelChangeDirection>(tokens[3].toInt());
+            standby.m_chanId    = tokens[4].toUInt();
+            standby.m_chanNum   = tokens[5];
+        }
+        else
+        {
+            m_standbyInputs.remove(inputid);
+        }
+    }
+
     if (message.startsWith("LIVETV_CHAIN"))
     {
         QString id;
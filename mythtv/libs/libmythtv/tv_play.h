@@ -331,6 +331,7 @@ class MTV_PUBLIC TV : public TVPlaybackState, public MythTVMenuItemDisplayer, pu
     void ToggleChannelFavorite(const QString &ChangroupName) const;
     void ChangeChannel(ChannelChangeDirection Direction);
     void ChangeChannel(uint Chanid, const QString& Channum);
+    uint GetStandbyInput(uint Chanid) const;
 
     void ShowPreviousChannel();
     void PopPreviousChannel(bool ImmediateChange);
@@ -620,6 +621,16 @@ class MTV_PUBLIC TV : public TVPlaybackState, public MythTVMenuItemDisplayer, pu
     uint                   m_queuedChanID {0};
     /// Initial chanid override for Live TV
     uint                   m_initialChanID {0};
+    /// Inputs the backends keep tuned to the channels next to the one
+    /// being watched, by input id, from the LIVETV_STANDBY events.
+    struct StandbyInput
+    {
+        uint                   m_owner     {0};
+        ChannelChangeDirection m_direction {CHANNEL_DIRECTION_SAME};
+        uint                   m_chanId    {0};
+        QString                m_chanNum;
+    };
+    QMap<uint,StandbyInput> m_standbyInputs;
 
     /// screen area to keypress translation
     /// region is now 0..11
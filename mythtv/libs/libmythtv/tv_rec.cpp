@@ -1,4 +1,5 @@
 // C headers
+#include <algorithm>
 #include <chrono> // for milliseconds
 #include <cstdio>
 #include <cstdlib>
@@ -188,6 +189,7 @@ bool TVRec::Init(void)
     m_transcodeFirst    = gCoreContext->GetBoolSetting("AutoTranscodeBeforeAutoCommflag", false);
     m_earlyCommFlag     = gCoreContext->GetBoolSetting("AutoCommflagWhileRecording", false);
     m_runJobOnHostOnly  = gCoreContext->GetBoolSetting("JobsRunOnRecordHost", false);
+    m_useStandbyInputs  = gCoreContext->GetBoolSetting("LiveTVStandbyInputs", false);
     m_eitTransportTimeout = gCoreContext->GetDurSetting<std::chrono::minutes>("EITTransportTimeout", 5min);
     if (m_eitTransportTimeout < 15s)
         m_eitTransportTimeout = 15s;
@@ -1030,6 +1032,7 @@ void TVRec::FinishedRecording(RecordingInfo *curRec, RecordingQuality *recq)
     {
         JobQueue::RemoveJobsFromMask(JOB_COMMFLAG,  *autoJob);
         JobQueue::RemoveJobsFromMask(JOB_TRANSCODE, *autoJob);
+        JobQueue::RemoveJobsFromMask(JOB_PREVIEW,   *autoJob);
     }
     if (*autoJob != JOB_NONE)
         JobQueue::QueueRecordingJobs(*curRec, *autoJob);
@@ -1116,6 +1119,7 @@ void TVRec::HandleStateChange(void)
     else if (TRANSITION(kState_WatchingLiveTV, kState_None))
     {
         m_tuningRequests.enqueue(TuningRequest(kFlagKillRec|kFlagKillRingBuffer));
+        ReleaseStandbyInputs();
         SET_NEXT();
     }
     else if (TRANSITION(kState_WatchingLiveTV, kState_RecordingOnly))
@@ -1507,9 +1511,37 @@ void TVRec::run(void)
             ClearFlags(kFlagExitPlayer, __FILE__, __LINE__);
         }
 
+        // Keep the standby inputs on the channels next to the one watched
+        if (m_useStandbyInputs && (m_internalState == kState_WatchingLiveTV) &&
+            HasFlags(kFlagRecorderRunning) && m_tuningRequests.empty() &&
+            MythDate::current() > m_standbyUpdateTime &&
+            s_inputsLock.tryLockForRead())
+        {
+            UpdateStandbyInputs();
+            s_inputsLock.unlock();
+        }
+
+        // Give up a standby channel when its LiveTV session no longer
+        // wants it, or when the tuner is needed for something else.
+        if (m_standby.GetOwner() && (m_internalState == kState_None) &&
+            m_tuningRequests.empty())
+        {
+            bool release = m_standby.IsExpired(MythDate::current());
+            if (!release && s_inputsLock.tryLockForRead())
+            {
+                release = IsStandbyTunerBusy();
+                s_inputsLock.unlock();
+            }
+            if (release)
+            {
+                ClearStandby();
+                TuningShutdowns(TuningRequest(kFlagNoRec));
+            }
+        }
+
         // Start active EIT scan
         bool conflicting_input = false;
-        if (m_scanner && m_channel &&
+        if (m_scanner && m_channel && !m_standby.GetOwner() &&
             MythDate::current() > m_eitScanStartTime)
         {
             if (!m_dvbOpt.m_dvbEitScan)
@@ -3216,6 +3248,100 @@ bool TVRec::QueueEITChannelChange(const QString &name)
     return ok;
 }
 
+/**
+ *  \brief Tunes this idle input to \a channum, so that LiveTV on input
+ *         \a owner can switch to it without waiting for a tuner lock.
+ *
+ *   This is called from the owner's event thread, so like
+ *   QueueEITChannelChange() it does not block, and it gives up if this
+ *   input is in use, about to be, or on standby for another input.
+ *
+ *  \return true if the input holds, or is tuning, \a channum for \a owner
+ */
+bool TVRec::SetStandbyChannel(uint owner, ChannelChangeDirection dir,
+                              const QString &channum)
+{
+    bool ok = false;
+    if (m_setChannelLock.tryLock())
+    {
+        if (m_stateChangeLock.tryLock())
+        {
+            m_pendingRecLock.lock();
+            bool pending = !m_pendingRecordings.empty();
+            m_pendingRecLock.unlock();
+
+            if ((m_internalState == kState_None) && !m_changeState &&
+                m_tuningRequests.empty() && !pending)
+            {
+                StandbyTuner::Hold hold =
+                    m_standby.Set(owner, dir, channum, MythDate::current());
+                if (hold == StandbyTuner::Hold::kRetune)
+                {
+                    LOG(VB_CHANNEL, LOG_INFO, LOC +
+                        QString("Standby on channel %1 for input %2")
+                            .arg(channum).arg(owner));
+                    m_tuningRequests.enqueue(
+                        TuningRequest(kFlagStandby, channum));
+                }
+                else if (hold == StandbyTuner::Hold::kMoved &&
+                         HasFlags(kFlagSignalMonitorRunning) &&
+                         !HasFlags(kFlagWaitingForSignal))
+                {
+                    AnnounceStandby();
+                }
+                ok = (hold != StandbyTuner::Hold::kRefused);
+            }
+            m_stateChangeLock.unlock();
+        }
+        m_setChannelLock.unlock();
+    }
+
+    if (ok)
+        WakeEventLoop();
+
+    return ok;
+}
+
+/// Whether this input is on standby for \a owner on channel \a channum.
+bool TVRec::IsStandby(uint owner, const QString &channum)
+{
+    return m_standby.IsHeld(owner, channum);
+}
+
+/** \brief Keeps the standby this input holds for \a owner on \a channum,
+ *         for the LiveTV session that is about to switch to it.
+ *
+ *   The frontend calls this before it stops LiveTV on \a owner, which
+ *   releases every input on standby for it, including this one.
+ *
+ *  \return true if the input is on standby on \a channum for \a owner
+ */
+bool TVRec::ClaimStandby(uint owner, const QString &channum)
+{
+    bool ok = m_standby.Claim(owner, channum, MythDate::current());
+    if (ok)
+    {
+        LOG(VB_CHANNEL, LOG_INFO, LOC +
+            QString("Standby on channel %1 claimed by input %2")
+                .arg(channum).arg(owner));
+    }
+    return ok;
+}
+
+/// Asks the event thread to end the standby held for input \a owner.
+void TVRec::ReleaseStandby(uint owner)
+{
+    if (m_standby.Release(owner))
+        WakeEventLoop();
+}
+
+/// Returns the times taken by LiveTV channel changes on this input.
+ChannelChangeStats TVRec::GetChannelChangeStats(void) const
+{
+    QMutexLocker locker(&m_channelChangeStatsLock);
+    return m_channelChangeStats;
+}
+
 void TVRec::GetNextProgram(BrowseDirection direction,
                            QString &title,       QString &subtitle,
                            QString &desc,        QString &category,
@@ -3565,18 +3691,30 @@ void TVRec::HandleTuning(void)
         request.m_channel = TuningGetChanNum(request, input);
         request.m_input   = input;
 
+        if (request.m_flags & kFlagLiveTV)
+        {
+            // Time how long it takes until the recorder is on the channel
+            QString standby = m_standby.GetChannel();
+            m_channelChangeStandby = !standby.isEmpty() &&
+                (request.m_channel == standby);
+            m_channelChangeTimer.start();
+        }
+
         if (TuningOnSameMultiplex(request))
             LOG(VB_CHANNEL, LOG_INFO, LOC + "On same multiplex");
 
         TuningShutdowns(request);
 
+        if (!(request.m_flags & kFlagStandby))
+            ClearStandby();
+
         // The dequeue isn't safe to do until now because we
         // release the stateChangeLock to teardown a recorder
         m_tuningRequests.dequeue();
 
         // Now we start new stuff
-        if (request.m_flags & (kFlagRecording|kFlagLiveTV|
-                               kFlagEITScan|kFlagAntennaAdjust))
+        if (request.m_flags & (kFlagRecording|kFlagLiveTV|kFlagEITScan|
+                               kFlagAntennaAdjust|kFlagStandby))
         {
             if (!m_recorder)
             {
@@ -3610,6 +3748,9 @@ void TVRec::HandleTuning(void)
         streamData = TuningSignalCheck();
         if (streamData == nullptr)
             return;
+
+        if ((m_lastTuningRequest.m_flags & kFlagStandby) && m_signalMonitor)
+            AnnounceStandby();
     }
 
     if (HasFlags(kFlagNeedToStartRecorder))
@@ -3622,9 +3763,207 @@ void TVRec::HandleTuning(void)
         // If we got this far it is safe to set a new starting channel...
         if (m_channel)
             m_channel->StoreInputChannels();
+
+        if (m_lastTuningRequest.m_flags & kFlagLiveTV)
+            TuningFinished();
     }
 }
 
+/** \fn TVRec::TuningFinished(void)
+ *  \brief Records how long a LiveTV channel change took, once the
+ *         recorder is on the new channel.
+ */
+void TVRec::TuningFinished(void)
+{
+    if (!m_channelChangeTimer.isRunning())
+        return;
+
+    std::chrono::milliseconds elapsed = m_channelChangeTimer.elapsed();
+    m_channelChangeTimer.stop();
+    if (!HasFlags(kFlagRecorderRunning))
+        return;
+
+    QString stats;
+    {
+        QMutexLocker locker(&m_channelChangeStatsLock);
+        m_channelChangeStats.Add(elapsed, m_channelChangeStandby);
+        stats = m_channelChangeStats.toString();
+    }
+    LOG(VB_CHANNEL, LOG_INFO, LOC +
+        QString("Channel change to %1 took %2 ms%3")
+            .arg(m_lastTuningRequest.m_channel).arg(elapsed.count())
+            .arg(m_channelChangeStandby ? " from standby" : ""));
+    LOG(VB_CHANNEL, LOG_DEBUG, LOC + "Channel changes: " + stats);
+
+    // Put the standby inputs on the new neighbouring channels
+    m_standbyUpdateTime = MythDate::current();
+}
+
+/** \fn TVRec::UpdateStandbyInputs(void)
+ *  \brief Keeps idle tuners on this input's video source tuned to the
+ *         channels above and below the one being watched.
+ *
+ *   The frontend is told about the standby inputs, and switches to one
+ *   when the user changes to its channel, which saves the time it takes
+ *   to tune and to wait for the tables. Channels on the multiplex being
+ *   watched are skipped, they don't need a tuner. Each tuner is used for
+ *   one channel only, and the inputs that share a tuner with this one or
+ *   with a busy input are left alone.
+ *
+ *   You must hold a read lock on s_inputsLock when calling this.
+ */
+void TVRec::UpdateStandbyInputs(void)
+{
+    m_standbyUpdateTime =
+        MythDate::current().addSecs(kStandbyUpdateRate.count());
+
+    if (!m_channel || !GetDTVChannel())
+        return;
+
+    uint    sourceid = m_channel->GetSourceID();
+    QString current  = m_channel->GetChannelName();
+
+    QMap<ChannelChangeDirection,QString> wanted;
+    for (auto dir : { CHANNEL_DIRECTION_UP, CHANNEL_DIRECTION_DOWN })
+    {
+        uint chanid = m_channel->GetNextChannel(0, dir);
+        QString channum = ChannelUtil::GetChanNum(chanid);
+        if (channum.isEmpty() || channum == current ||
+            wanted.values().contains(channum) ||
+            ChannelUtil::IsOnSameMultiplex(sourceid, channum, current))
+        {
+            continue;
+        }
+        wanted[dir] = channum;
+    }
+
+    QList<TVRec*> candidates;
+    QStringList devices(m_genOpt.m_videoDev);
+    for (auto *rec : std::as_const(s_inputs))
+    {
+        if (rec == this || rec->m_parentId || !rec->GetDTVChannel() ||
+            rec->GetSourceID() != sourceid ||
+            !SignalMonitor::IsRequired(rec->m_genOpt.m_inputType) ||
+            devices.contains(rec->m_genOpt.m_videoDev))
+        {
+            continue;
+        }
+        devices << rec->m_genOpt.m_videoDev;
+        candidates << rec;
+    }
+
+    // Inputs already on one of the channels keep it...
+    QList<TVRec*> used;
+    for (auto it = wanted.begin(); it != wanted.end(); )
+    {
+        auto held = std::find_if(candidates.cbegin(), candidates.cend(),
+            [this, &it](TVRec *rec)
+            { return rec->IsStandby(m_inputId, *it) &&
+                     rec->SetStandbyChannel(m_inputId, it.key(), *it); });
+        if (held != candidates.cend())
+        {
+            used << *held;
+            candidates.removeOne(*held);
+            it = wanted.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // ... the other channels go to the first inputs that will take them...
+    for (auto it = wanted.cbegin(); it != wanted.cend(); ++it)
+    {
+        for (auto *rec : std::as_const(candidates))
+        {
+            if (rec->SetStandbyChannel(m_inputId, it.key(), *it))
+            {
+                used << rec;
+                candidates.removeOne(rec);
+                break;
+            }
+        }
+    }
+
+    // ... and the rest are let go.
+    for (auto *rec : std::as_const(candidates))
+        rec->ReleaseStandby(m_inputId);
+
+    LOG(VB_CHANNEL, LOG_DEBUG, LOC +
+        QString("%1 inputs on standby").arg(used.size()));
+}
+
+/// Lets go of the inputs on standby for this input's LiveTV session.
+void TVRec::ReleaseStandbyInputs(void)
+{
+    s_inputsLock.lockForRead();
+    for (auto *rec : std::as_const(s_inputs))
+    {
+        if (rec != this)
+            rec->ReleaseStandby(m_inputId);
+    }
+    s_inputsLock.unlock();
+}
+
+/// Ends this input's standby, leaving the tuner to the caller.
+void TVRec::ClearStandby(void)
+{
+    uint owner = m_standby.GetOwner();
+    if (!owner)
+        return;
+
+    LOG(VB_CHANNEL, LOG_INFO, LOC +
+        QString("End of standby on channel %1 for input %2")
+            .arg(m_standby.GetChannel()).arg(owner));
+
+    m_standby.Clear();
+
+    MythEvent me(QString("LIVETV_STANDBY %1").arg(m_inputId));
+    gCoreContext->dispatch(me);
+
+    if (m_scanner)
+    {
+        auto secs = m_eitCrawlIdleStart + eit_start_rand(m_inputId, m_eitTransportTimeout);
+        m_eitScanStartTime = MythDate::current().addSecs(secs.count());
+    }
+}
+
+/// Tells the frontends this input has a lock on its standby channel.
+void TVRec::AnnounceStandby(void)
+{
+    uint owner = m_standby.GetOwner();
+    if (!owner || !m_channel)
+        return;
+
+    QString channum = m_standby.GetChannel();
+    LOG(VB_CHANNEL, LOG_INFO, LOC +
+        QString("Standby on channel %1 for input %2 is ready")
+            .arg(channum).arg(owner));
+
+    MythEvent me(QString("LIVETV_STANDBY %1 %2 %3 %4 %5")
+                 .arg(m_inputId).arg(owner)
+                 .arg(static_cast<int>(m_standby.GetDirection()))
+                 .arg(m_channel->GetChanID()).arg(channum));
+    gCoreContext->dispatch(me);
+}
+
+/// Whether an input sharing this input's tuner is busy, or this input
+/// has a recording coming up.
+bool TVRec::IsStandbyTunerBusy(void) const
+{
+    m_pendingRecLock.lock();
+    bool pending = !m_pendingRecordings.empty();
+    m_pendingRecLock.unlock();
+    if (pending)
+        return true;
+
+    InputInfo busy_input;
+    return std::any_of(m_eitInputs.cbegin(), m_eitInputs.cend(),
+                       [&busy_input](uint input)
+                       { return RemoteIsBusy(input, busy_input); });
+}
+
 /** \fn TVRec::TuningShutdowns(const TuningRequest&)
  *  \brief This shuts down anything that needs to be shut down
  *         before handling the passed in tuning request.
@@ -3646,7 +3985,16 @@ void TVRec::TuningShutdowns(const TuningRequest &request)
     if (m_scanner && !request.IsOnSameMultiplex())
         m_scanner->StopEITEventProcessing();
 
-    if (HasFlags(kFlagSignalMonitorRunning))
+    // LiveTV on the channel held in standby takes over the signal
+    // monitor, which already has the tables the recorder needs.
+    QString standby = m_standby.GetChannel();
+    bool from_standby = (request.m_flags & kFlagLiveTV) &&
+        !standby.isEmpty() && (request.m_channel == standby) &&
+        m_signalMonitor && m_signalMonitor->IsAllGood();
+    if (from_standby)
+        LOG(VB_CHANNEL, LOG_INFO, LOC + "Using the standby signal monitor");
+
+    if (HasFlags(kFlagSignalMonitorRunning) && !from_standby)
     {
         MPEGStreamData *sd = nullptr;
         if (GetDTVSignalMonitor())
@@ -3737,7 +4085,8 @@ void TVRec::TuningFrequency(const TuningRequest &request)
         const QString tuningmode = (HasFlags(kFlagEITScannerRunning)) ?
             dtvchan->GetSIStandard() :
             dtvchan->GetSuggestedTuningMode(
-                kState_WatchingLiveTV == m_internalState);
+                kState_WatchingLiveTV == m_internalState ||
+                (request.m_flags & kFlagStandby));
 
         dtvchan->SetTuningMode(tuningmode);
 
@@ -3857,6 +4206,9 @@ void TVRec::TuningFrequency(const TuningRequest &request)
     {
         LOG(VB_RECORD, LOG_INFO, LOC + "Starting Signal Monitor");
         bool error = false;
+        // A monitor kept from standby now reports to the frontend
+        if (m_signalMonitor && livetv)
+            m_signalMonitor->SetNotifyFrontend(true);
         if (!SetupSignalMonitor(
                 !antadj, (request.m_flags & kFlagEITScan) != 0U, livetv || antadj))
         {
@@ -4017,7 +4369,8 @@ MPEGStreamData *TVRec::TuningSignalCheck(void)
         ClearFlags(kFlagNeedToStartRecorder, __FILE__, __LINE__);
         newRecStatus = RecStatus::Failed;
 
-        if (m_scanner && HasFlags(kFlagEITScannerRunning))
+        if ((m_scanner && HasFlags(kFlagEITScannerRunning)) ||
+            (m_lastTuningRequest.m_flags & kFlagStandby))
         {
             m_tuningRequests.enqueue(TuningRequest(kFlagNoRec));
         }
@@ -4099,7 +4452,11 @@ MPEGStreamData *TVRec::TuningSignalCheck(void)
     if (GetDTVSignalMonitor())
         streamData = GetDTVSignalMonitor()->GetStreamData();
 
-    if (!HasFlags(kFlagEITScannerRunning))
+    // A standby input keeps monitoring, and the tables seen so far,
+    // for the LiveTV session that may switch to it.
+    bool standby = (m_lastTuningRequest.m_flags & kFlagStandby) &&
+        (newRecStatus == RecStatus::Recording);
+    if (!HasFlags(kFlagEITScannerRunning) && !standby)
     {
         // shut down signal monitoring
         TeardownSignalMonitor();
@@ -4149,6 +4506,10 @@ static int init_jobs(const RecordingInfo *rec, RecordingProfile &profile,
     if ((!autoTrans) || (autoTrans->getValue().toInt() == 0))
         JobQueue::RemoveJobsFromMask(JOB_TRANSCODE, jobs);
 
+    // the seek preview strip is made for every recording when enabled
+    if (gCoreContext->GetBoolSetting("AutoPreviewStrip", false))
+        JobQueue::AddJobsToMask(JOB_PREVIEW, jobs);
+
     bool ml = JobQueue::JobIsInMask(JOB_METADATA, jobs);
     if (ml)
     {
@@ -4564,6 +4925,8 @@ QString TVRec::FlagToString(uint f)
         if (kFlagAntennaAdjust & f)
             msg += "AntennaAdjust,";
     }
+    if (kFlagStandby & f)
+        msg += "Standby,";
     if ((kFlagPendingActions & f) == kFlagPendingActions)
     {
         msg += "PENDINGACTIONS,";
@@ -22,11 +22,13 @@
 #include "libmythbase/mythdeque.h"
 #include "libmythbase/mythtimer.h"
 
+#include "channelchangestats.h"
 #include "inputinfo.h"
 #include "mythtvexp.h"                  // for MTV_PUBLIC
 #include "programtypes.h"   // for RecStatus, RecStatus::Type, etc
 #include "recordinginfo.h"
 #include "signalmonitorlistener.h"
+#include "standbytuner.h"
 #include "tv.h"
 #include "videoouttypes.h"              // for PictureAttribute
 
@@ -207,6 +209,12 @@ class MTV_PUBLIC TVRec : public SignalMonitorListener, public QRunnable
         { SetChannel(QString("NextChannel %1").arg((int)dir)); }
     void SetChannel(const QString& name, uint requestType = kFlagDetect);
     bool QueueEITChannelChange(const QString &name);
+    bool SetStandbyChannel(uint owner, ChannelChangeDirection dir,
+                           const QString &channum);
+    bool IsStandby(uint owner, const QString &channum);
+    bool ClaimStandby(uint owner, const QString &channum);
+    void ReleaseStandby(uint owner);
+    ChannelChangeStats GetChannelChangeStats(void) const;
 
     std::chrono::milliseconds SetSignalMonitoringRate(std::chrono::milliseconds rate, int notifyFrontend = 1);
     int  GetPictureAttribute(PictureAttribute attr);
@@ -300,6 +308,13 @@ class MTV_PUBLIC TVRec : public SignalMonitorListener, public QRunnable
     void TuningRestartRecorder(void);
     QString TuningGetChanNum(const TuningRequest &request, QString &input) const;
     bool TuningOnSameMultiplex(TuningRequest &request);
+    void TuningFinished(void);
+
+    void UpdateStandbyInputs(void);
+    void ReleaseStandbyInputs(void);
+    void ClearStandby(void);
+    void AnnounceStandby(void);
+    bool IsStandbyTunerBusy(void) const;
 
     void HandleStateChange(void);
     void ChangeState(TVState nextState);
@@ -430,6 +445,17 @@ class MTV_PUBLIC TVRec : public SignalMonitorListener, public QRunnable
     MythMediaBuffer   *m_buffer                   {nullptr};
     QString            m_rbFileExt                {"ts"};
 
+    // LiveTV standby tuning, see SetStandbyChannel()
+    bool               m_useStandbyInputs         {false};
+    StandbyTuner       m_standby;
+    QDateTime          m_standbyUpdateTime;
+
+    // Channel change timing
+    MythTimer          m_channelChangeTimer;
+    bool               m_channelChangeStandby     {false};
+    mutable QMutex     m_channelChangeStatsLock;
+    ChannelChangeStats m_channelChangeStats;
+
   public:
     static QReadWriteLock    s_inputsLock;
     static QMap<uint,TVRec*> s_inputs;
@@ -437,6 +463,8 @@ class MTV_PUBLIC TVRec : public SignalMonitorListener, public QRunnable
   public:
     /// How many milliseconds the signal monitor should wait between checks
     static constexpr std::chrono::milliseconds kSignalMonitoringRate { 50ms };
+    /// How often a LiveTV session renews its standby inputs
+    static constexpr std::chrono::seconds kStandbyUpdateRate { 30s };
 
     // General State flags
     static const uint kFlagFrontendReady        = 0x00000001;
@@ -465,6 +493,9 @@ class MTV_PUBLIC TVRec : public SignalMonitorListener, public QRunnable
 
     static const uint kFlagNoRec                = 0x0000F000;
     static const uint kFlagKillRingBuffer       = 0x00010000;
+    /// tune an idle input to a channel likely to be watched next,
+    /// kept out of kFlagNoRec so a standby tune is not a shutdown request
+    static const uint kFlagStandby              = 0x00020000;
 
     // Waiting stuff
     static const uint kFlagWaitingForRecPause   = 0x00100000;
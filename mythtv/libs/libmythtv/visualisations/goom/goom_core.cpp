@@ -14,11 +14,14 @@
 //#include "gfontlib.h"
 
 #include "libmythbase/mythrandom.h"
+#include "libmythtv/audio/audioanalyser.h"
 
 //#define VERBOSE
 
 static constexpr int32_t STOP_SPEED   { 128 };
 static constexpr int16_t TIME_BTW_CHG { 300 };
+// bass this many times its average is a big goom
+static constexpr float   BIG_BEAT     { 4.0F };
 
 /**-----------------------------------------------------**
  **  SHARED DATA                                        **
@@ -132,7 +135,7 @@ void goom_set_resolution (uint32_t resx, uint32_t resy, int cinemascope) {
 }
 
 
-uint32_t * goom_update (GoomDualData& data, int forceMode) {
+uint32_t * goom_update (GoomDualData& data, int forceMode, int beat) {
 	static int s_lockVar = 0;		// pour empecher de nouveaux changements
 	static int s_totalGoom = 0;		// nombre de gooms par seconds
 	static int s_aGoom = 0;			// un goom a eu lieu..
@@ -201,6 +204,15 @@ uint32_t * goom_update (GoomDualData& data, int forceMode) {
 
 	s_speedVar = std::clamp(s_speedVar, 0, 50);
 
+	// a goom is a jump in the volume, unless the caller found the beats
+	bool isGoom = (s_accelVar > s_goomLimit) || (s_accelVar < -s_goomLimit);
+	bool isBigGoom = (s_speedVar > 4) && (s_goomLimit > 4) &&
+		((s_accelVar > (s_goomLimit*9/8)+7)||(s_accelVar < (-s_goomLimit*9/8)-7));
+	if (beat >= 0) {
+		isGoom = (beat > 0);
+		isBigGoom = (beat > 1);
+	}
+
 
 	/* ! calcul du deplacement des petits points ... */
 
@@ -281,8 +293,7 @@ uint32_t * goom_update (GoomDualData& data, int forceMode) {
 	if (--s_aBigGoom < 0)
 		s_aBigGoom = 0;
 
-	if ((!s_aBigGoom) && (s_speedVar > 4) && (s_goomLimit > 4) &&
-			((s_accelVar > (s_goomLimit*9/8)+7)||(s_accelVar < (-s_goomLimit*9/8)-7))) {
+	if ((!s_aBigGoom) && isBigGoom) {
 		static int s_couleur =
 			 (0xc0<<(ROUGE*8))
 			|(0xc0<<(VERT*8))
@@ -295,8 +306,7 @@ uint32_t * goom_update (GoomDualData& data, int forceMode) {
 	}
 
 	// on verifie qu'il ne se pas un truc interressant avec le son.
-	if ((s_accelVar > s_goomLimit) || (s_accelVar < -s_goomLimit) || (forceMode > 0)
-			|| (s_nombreCddc > TIME_BTW_CHG)) {
+	if (isGoom || (forceMode > 0) || (s_nombreCddc > TIME_BTW_CHG)) {
 
 //        if (nombreCDDC > 300) {
 //        }
@@ -393,7 +403,7 @@ uint32_t * goom_update (GoomDualData& data, int forceMode) {
 	if (s_lockVar == 0) {
 		// reperage de goom (acceleration forte de l'acceleration du volume)
 		// -> coup de boost de la vitesse si besoin..
-		if ((s_accelVar > s_goomLimit) || (s_accelVar < -s_goomLimit)) {
+		if (isGoom) {
 			static int s_rndn = 0;
 			static int s_blocker = 0;
 
@@ -627,7 +637,8 @@ uint32_t * goom_update (GoomDualData& data, int forceMode) {
 		s_exvit = s_zfd.vitesse;
 		s_switchMult = 1.0F;
 
-		if (((s_accelVar > s_goomLimit) && (s_totalGoom < 2)) || (forceMode > 0)) {
+		bool rising = (beat < 0) ? (s_accelVar > s_goomLimit) : isGoom;
+		if ((rising && (s_totalGoom < 2)) || (forceMode > 0)) {
 			s_switchIncr = 0;
 			s_switchMult = SWITCHMULT;
 		}
@@ -836,6 +847,15 @@ uint32_t * goom_update (GoomDualData& data, int forceMode) {
 	return return_val;
 }
 
+int goom_beat (const AudioAnalysis *analysis, uint32_t &beatCount) {
+	if (!analysis)
+		return -1;
+	if (!analysis->IsReady() || (analysis->m_beatCount == beatCount))
+		return 0;
+	beatCount = analysis->m_beatCount;
+	return (analysis->m_beatStrength > BIG_BEAT) ? 2 : 1;
+}
+
 void goom_close () {
 	pixel.clear();
 	back.clear();
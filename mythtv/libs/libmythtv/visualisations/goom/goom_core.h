@@ -6,6 +6,8 @@
 
 #include "libmythtv/mythtvexp.h"
 
+class AudioAnalysis;
+
 static constexpr int8_t NB_FX {10};
 
 using GoomSingleData = std::array<int16_t,512>;
@@ -18,8 +20,19 @@ MTV_PUBLIC void goom_set_resolution (uint32_t resx, uint32_t resy, int cinemasco
  * forceMode == 0 : do nothing
  * forceMode == -1 : lock the FX
  * forceMode == 1..NB_FX : force a switch to FX n°forceMode
+ *
+ * beat == -1 : find the gooms in the volume of the data
+ * beat == 0 : no goom
+ * beat == 1 : a goom
+ * beat == 2 : a big goom
+ */
+MTV_PUBLIC uint32_t *goom_update (GoomDualData& data, int forceMode, int beat = -1);
+
+/*
+ * the beat to give goom_update for an analysis, -1 without one.
+ * beatCount is the AudioAnalysis::m_beatCount of the last call.
  */
-MTV_PUBLIC uint32_t *goom_update (GoomDualData& data, int forceMode);
+MTV_PUBLIC int       goom_beat (const AudioAnalysis *analysis, uint32_t &beatCount);
 MTV_PUBLIC void    goom_close (void);
 
 #endif // GOOMCORE_H
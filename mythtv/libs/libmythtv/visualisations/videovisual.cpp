@@ -37,11 +37,14 @@ VideoVisual* VideoVisual::Create(const QString &name,
     return nullptr;
 }
 
-VideoVisual::VideoVisual(AudioPlayer *audio, MythRender *render)
+VideoVisual::VideoVisual(AudioPlayer *audio, MythRender *render, bool analyse)
   : m_audio(audio),
     m_render(render),
     m_lastUpdate(QDateTime::currentDateTimeUtc())
 {
+    if (analyse)
+        m_analyser = new AudioAnalyser();
+
     mutex()->lock();
     if (m_audio)
         m_audio->addVisual(this);
@@ -55,6 +58,7 @@ VideoVisual::~VideoVisual()
         m_audio->removeVisual(this);
     DeleteNodes();
     mutex()->unlock();
+    delete m_analyser;
 }
 
 std::chrono::milliseconds VideoVisual::SetLastUpdate(void)
@@ -79,6 +83,8 @@ void VideoVisual::DeleteNodes(void)
 void VideoVisual::prepare()
 {
     DeleteNodes();
+    if (m_analyser)
+        m_analyser->Reset();
 }
 
 // caller holds lock
@@ -179,5 +185,11 @@ void VideoVisual::add(const void *b, unsigned long b_len,
         len = 0;
     }
 
-    m_nodes.append(new VisualNode(l, r, len, timecode));
+    auto *node = new VisualNode(l, r, len, timecode);
+    if (m_analyser)
+    {
+        m_analyser->SetSampleRate(m_audio->GetSampleRate());
+        node->m_analysis = m_analyser->Add(l, r, static_cast<unsigned long>(len), timecode);
+    }
+    m_nodes.append(node);
 }
@@ -7,6 +7,7 @@
 #include <QList>
 #include <QDateTime>
 
+#include "libmythtv/audio/audioanalyser.h"
 #include "libmythtv/audio/visualization.h"
 #include "libmythtv/mythtvexp.h"
 #include "libmythui/mythpainter.h"
@@ -33,10 +34,17 @@ class VisualNode
         delete [] m_right;
     }
 
+    /// the spectrum and beat of these samples, once they are worked out
+    const AudioAnalysis* Analysis() const
+    {
+        return (m_analysis && m_analysis->IsReady()) ? m_analysis.get() : nullptr;
+    }
+
     short *m_left   {nullptr};
     short *m_right  {nullptr};
     long   m_length;
     std::chrono::milliseconds m_offset;
+    AudioAnalysisPtr m_analysis;
 };
 
 class MTV_PUBLIC VideoVisual : public Visualization
@@ -46,7 +54,7 @@ class MTV_PUBLIC VideoVisual : public Visualization
                                AudioPlayer *audio, MythRender *render);
     static QStringList GetVisualiserList(RenderType type);
 
-    VideoVisual(AudioPlayer *audio, MythRender *render);
+    VideoVisual(AudioPlayer *audio, MythRender *render, bool analyse = false);
    ~VideoVisual() override;
 
     bool NeedsPrepare() const { return m_needsPrepare; }
@@ -72,6 +80,7 @@ class MTV_PUBLIC VideoVisual : public Visualization
     MythRender        *m_render       { nullptr };
     QList<VisualNode*> m_nodes;
     QDateTime          m_lastUpdate;
+    AudioAnalyser     *m_analyser     { nullptr }; ///< only if asked for
 };
 
 class VideoVisualFactory
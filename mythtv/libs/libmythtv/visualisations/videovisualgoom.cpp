@@ -1,3 +1,7 @@
+// C++
+#include <algorithm>
+#include <cstring>
+
 // MythTV
 #include "libmythbase/mythconfig.h"
 #include "libmythbase/mythlogging.h"
@@ -12,7 +16,7 @@
 #include "goom/goom_core.h"
 
 VideoVisualGoom::VideoVisualGoom(AudioPlayer* Audio, MythRender* Render, bool HD)
-  : VideoVisual(Audio, Render),
+  : VideoVisual(Audio, Render, true),
     m_hd(HD)
 {
     int max_width  = m_hd ? 1200 : 600;
@@ -24,10 +28,18 @@ VideoVisualGoom::VideoVisualGoom(AudioPlayer* Audio, MythRender* Render, bool HD
     m_area = QRect(0, 0, width, height);
     goom_init(static_cast<uint32_t>(width), static_cast<uint32_t>(height), 0);
     LOG(VB_GENERAL, LOG_INFO, QString("Initialised Goom (%1x%2)").arg(width).arg(height));
+
+    // Goom is drawn on a thread of its own, the render thread only uploads it
+    m_renderer = new VisualRenderer("VideoVisualGoom",
+        [this](const VisualRenderer::Samples& Input, QSize Size, QImage& Image)
+            { return this->Render(Input, Size, Image); });
+    m_renderer->SetSize(m_area.size());
 }
 
 VideoVisualGoom::~VideoVisualGoom()
 {
+    delete m_renderer;
+
 #if CONFIG_OPENGL
     if (m_glSurface && m_render && (m_render->Type() == kRenderOpenGL))
     {
@@ -46,30 +58,29 @@ void VideoVisualGoom::Draw(const QRect Area, MythPainter* /*Painter*/, QPaintDev
     if (m_disabled || !m_render || Area.isEmpty())
         return;
 
-    QMutexLocker lock(mutex());
-    VisualNode* node = GetNode();
-    if (node)
     {
-        size_t numSamps = 512;
-        if (node->m_length < 512)
-            numSamps = static_cast<size_t>(node->m_length);
-
-        GoomDualData data {};
-        for (size_t i = 0; i < numSamps; i++)
+        QMutexLocker lock(mutex());
+        VisualNode* node = GetNode();
+        if (node && node->m_length > 0)
         {
-            data[0][i] = node->m_left[i];
-            data[1][i] = node->m_right ? node->m_right[i] : data[0][i];
+            size_t numSamps = std::min<size_t>(static_cast<size_t>(node->m_length), 512);
+            VisualRenderer::Samples input;
+            input.m_left.assign(node->m_left, node->m_left + numSamps);
+            if (node->m_right)
+                input.m_right.assign(node->m_right, node->m_right + numSamps);
+            input.m_analysis = node->m_analysis;
+            m_renderer->Post(std::move(input));
         }
-
-        m_buffer = goom_update(data, 0);
     }
 
+    uint64_t serial = 0;
+    QImage frame = m_renderer->Frame(&serial);
+
 #if CONFIG_OPENGL
-    unsigned int* last = m_buffer;
     if ((m_render->Type() == kRenderOpenGL))
     {
         auto * glrender = dynamic_cast<MythRenderOpenGL*>(m_render);
-        if (glrender && m_buffer)
+        if (glrender && !frame.isNull())
         {
             glrender->makeCurrent();
 
@@ -82,9 +93,12 @@ void VideoVisualGoom::Draw(const QRect Area, MythPainter* /*Painter*/, QPaintDev
             if (m_glSurface)
             {
                 m_glSurface->m_crop = false;
-                if (m_buffer != last)
+                if (serial != m_serial)
+                {
                     m_glSurface->m_texture->setData(m_glSurface->m_pixelFormat, m_glSurface->m_pixelType,
-						    reinterpret_cast<const uint8_t *>(m_buffer));
+                                                    frame.constBits());
+                    m_serial = serial;
+                }
                 // goom doesn't render properly due to changes in video alpha blending
                 // so turn blend off
                 glrender->SetBlend(false);
@@ -99,6 +113,27 @@ void VideoVisualGoom::Draw(const QRect Area, MythPainter* /*Painter*/, QPaintDev
 #endif
 }
 
+// called on the render thread
+bool VideoVisualGoom::Render(const VisualRenderer::Samples& Input, QSize Size, QImage& Image)
+{
+    size_t numSamps = std::min<size_t>(Input.m_left.size(), 512);
+    GoomDualData data {};
+    for (size_t i = 0; i < numSamps; i++)
+    {
+        data[0][i] = Input.m_left[i];
+        data[1][i] = Input.m_right.empty() ? data[0][i] : Input.m_right[i];
+    }
+
+    uint32_t* buffer = goom_update(data, 0, goom_beat(Input.m_analysis.get(), m_beatCount));
+    if (!buffer)
+        return false;
+
+    if (Image.size() != Size || Image.format() != QImage::Format_ARGB32)
+        Image = QImage(Size, QImage::Format_ARGB32);
+    memcpy(Image.bits(), buffer, static_cast<size_t>(Image.sizeInBytes()));
+    return true;
+}
+
 static class VideoVisualGoomFactory : public VideoVisualFactory
 {
   public:
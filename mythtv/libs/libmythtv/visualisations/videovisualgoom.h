@@ -4,6 +4,7 @@
 #include "libmythbase/mythconfig.h"
 
 #include "videovisual.h"
+#include "visualrenderer.h"
 
 class MythGLTexture;
 
@@ -20,11 +21,15 @@ class VideoVisualGoom : public VideoVisual
     QString Name(void) override { return m_hd ? GOOMHD_NAME : GOOM_NAME; }
 
   private:
-    unsigned int*  m_buffer    { nullptr };
+    bool Render(const VisualRenderer::Samples& Input, QSize Size, QImage& Image);
+
+    VisualRenderer* m_renderer  { nullptr };
+    uint64_t        m_serial    { 0 };
+    uint32_t        m_beatCount { 0 };  // only used by the render thread
 #if CONFIG_OPENGL
-    MythGLTexture* m_glSurface { nullptr };
+    MythGLTexture*  m_glSurface { nullptr };
 #endif
-    bool           m_hd        { false   };
+    bool            m_hd        { false   };
 };
 
 #endif
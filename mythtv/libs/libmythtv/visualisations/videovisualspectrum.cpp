@@ -4,12 +4,10 @@
 // MythTV
 #include "videovisualspectrum.h"
 
-// FFmpeg
-extern "C" {
-#include "libavutil/mem.h"
-#include "libavutil/tx.h"
-}
+// The bars are scaled as they were for an FFT of this many samples. The
+// AudioAnalysis has kBinsPerBin bins for each of its bins.
 static constexpr int k_FFT_sample_length { 512 };
+static constexpr int kBinsPerBin { AudioAnalysis::kFFTSize / k_FFT_sample_length };
 
 // Std
 #include <algorithm>
@@ -17,30 +15,31 @@ static constexpr int k_FFT_sample_length { 512 };
 #include "libmythbase/mythlogging.h"
 
 VideoVisualSpectrum::VideoVisualSpectrum(AudioPlayer* Audio, MythRender* Render)
-  : VideoVisual(Audio, Render),
-    m_dftL(static_cast<AVComplexFloat*>(av_malloc(sizeof(AVComplexFloat) * k_FFT_sample_length))),
-    m_dftR(static_cast<AVComplexFloat*>(av_malloc(sizeof(AVComplexFloat) * k_FFT_sample_length)))
+  : VideoVisual(Audio, Render, true)
 {
-    // If av_tx_init() fails (returns < 0), the contexts will be nullptr and will crash later,
-    // but av_malloc() is not checked to succeed either.
-    av_tx_init(&m_fftContext , &m_fft , AV_TX_FLOAT_FFT, 0, k_FFT_sample_length, &kScale, AV_TX_INPLACE);
 }
 
-VideoVisualSpectrum::~VideoVisualSpectrum()
+template<typename T> T sq(T a) { return a*a; };
+
+// The peak power of the bins that make up the 512 point bin Index, as that FFT
+// of the raw samples would have given it
+static double PeakPower(const AudioAnalysis& Analysis, int Index, bool Left)
 {
-    av_freep(reinterpret_cast<void*>(&m_dftL));
-    av_freep(reinterpret_cast<void*>(&m_dftR));
-    av_tx_uninit(&m_fftContext);
+    int first = std::max((Index * kBinsPerBin) - (kBinsPerBin / 2), 0);
+    int last  = std::min(first + kBinsPerBin, AudioAnalysis::kBins);
+    float peak = 0.0F;
+    for (int bin = first; bin < last; bin++)
+        peak = std::max(peak, Left ? Analysis.LeftPower(bin) : Analysis.RightPower(bin));
+    return peak * sq(32768.0 * k_FFT_sample_length / Analysis.m_gain);
 }
 
-template<typename T> T sq(T a) { return a*a; };
-
 void VideoVisualSpectrum::Draw(const QRect Area, MythPainter* Painter, QPaintDevice* Device)
 {
     if (m_disabled)
         return;
 
-    uint i = 0;
+    // Keep the analysis, the node may go once the lock is released
+    AudioAnalysisPtr analysis;
     {
         QMutexLocker locker(mutex());
         VisualNode* node = GetNode();
@@ -50,38 +49,22 @@ void VideoVisualSpectrum::Draw(const QRect Area, MythPainter* Painter, QPaintDev
         if (!Initialise(Area))
             return;
 
-        if (node)
-        {
-            i = static_cast<uint>(node->m_length);
-            for (auto k = 0; k < node->m_length; k++)
-            {
-                m_dftL[k] = (AVComplexFloat){ .re = static_cast<float>(node->m_left[k]), .im = 0 };
-                if (node->m_right)
-                    m_dftR[k] = (AVComplexFloat){ .re = static_cast<float>(node->m_right[k]), .im = 0 };
-            }
-        }
-    }
-
-    for (auto k = i; k < k_FFT_sample_length; k++)
-    {
-        m_dftL[k] = (AVComplexFloat){ .re = 0, .im = 0 };
-        m_dftR[k] = (AVComplexFloat){ .re = 0, .im = 0 };
+        if (node && node->Analysis())
+            analysis = node->m_analysis;
     }
-    m_fft(m_fftContext, m_dftL, m_dftL, sizeof(AVComplexFloat));
-    m_fft(m_fftContext, m_dftR, m_dftR, sizeof(AVComplexFloat));
 
     double falloff = std::clamp(((static_cast<double>(SetLastUpdate().count())) / 40.0) * m_falloff, 0.0, 2048.0);
     for (int l = 0, r = m_scale.range(); l < m_scale.range(); l++, r++)
     {
         int index = m_scale[l];
 
-        // The 1D output is Hermitian symmetric (Yk = Yn-k) so Yn = Y0 etc.
-        // The dft_r2c_1d plan doesn't output these redundant values
-        // and furthermore they're not allocated in the ctor
-        double tmp = 2 * sq(m_dftL[index].re);
+        // The whole power, where this used to take twice the square of the
+        // real part which is the same on average. Without an analysis yet the
+        // bars just fall.
+        double tmp = analysis ? PeakPower(*analysis, index, true) : 0.;
         double magL = (tmp > 1.) ? (log(tmp) - 22.0) * m_scaleFactor : 0.;
 
-        tmp = 2 * sq(m_dftR[index].re);
+        tmp = analysis ? PeakPower(*analysis, index, false) : 0.;
         double magR = (tmp > 1.) ? (log(tmp) - 22.0) * m_scaleFactor : 0.;
         if (magL > m_range)
             magL = 1.0;
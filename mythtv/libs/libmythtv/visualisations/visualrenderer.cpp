@@ -0,0 +1,85 @@
+// C++
+#include <utility>
+
+// MythTV
+#include "libmythbase/mythlogging.h"
+#include "visualrenderer.h"
+
+#define LOC QString("VisualRenderer: ")
+
+VisualRenderer::VisualRenderer(const QString &Name, RenderFunction Render)
+  : MThread(Name),
+    m_render(std::move(Render))
+{
+    start();
+}
+
+VisualRenderer::~VisualRenderer()
+{
+    Stop();
+}
+
+void VisualRenderer::Stop(void)
+{
+    {
+        QMutexLocker locker(&m_lock);
+        m_stop = true;
+        m_wait.wakeAll();
+    }
+    wait();
+}
+
+void VisualRenderer::SetSize(QSize Size)
+{
+    QMutexLocker locker(&m_lock);
+    m_size = Size;
+}
+
+void VisualRenderer::Post(Samples &&Input)
+{
+    QMutexLocker locker(&m_lock);
+    m_pending = std::move(Input);
+    m_havePending = true;
+    m_wait.wakeAll();
+}
+
+QImage VisualRenderer::Frame(uint64_t *Serial) const
+{
+    QMutexLocker locker(&m_lock);
+    if (Serial)
+        *Serial = m_serial;
+    return m_front;
+}
+
+void VisualRenderer::run(void)
+{
+    RunProlog();
+    LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("Rendering %1").arg(objectName()));
+
+    QMutexLocker locker(&m_lock);
+    while (!m_stop)
+    {
+        if (!m_havePending)
+        {
+            m_wait.wait(&m_lock);
+            continue;
+        }
+
+        Samples input = std::move(m_pending);
+        m_pending = Samples();
+        m_havePending = false;
+        QSize size = m_size;
+        locker.unlock();
+
+        bool drawn = !size.isEmpty() && m_render(input, size, m_back);
+
+        locker.relock();
+        if (drawn)
+        {
+            std::swap(m_front, m_back);
+            m_serial++;
+        }
+    }
+
+    RunEpilog();
+}
@@ -0,0 +1,74 @@
+#ifndef VISUALRENDERER_H
+#define VISUALRENDERER_H
+
+// C++
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Qt
+#include <QImage>
+#include <QMutex>
+#include <QSize>
+#include <QWaitCondition>
+
+// MythTV
+#include "libmythbase/mthread.h"
+#include "libmythtv/audio/audioanalyser.h"
+#include "libmythtv/mythtvexp.h"
+
+/** \class VisualRenderer
+ *  \brief Renders the frames of a visualiser on a thread of its own.
+ *
+ *  The UI thread posts the samples for each frame and draws whichever frame
+ *  was finished last, so a slow frame costs a dropped frame rather than a
+ *  stalled UI. Frames are drawn into a back image that is swapped with the
+ *  front one when it is done. Only the newest samples are kept, if the
+ *  renderer falls behind older ones are dropped.
+ *
+ *  The render function is called on the render thread and owns everything it
+ *  uses. It is given the size to render at and the back image, which it sets
+ *  up itself, and returns false if it drew nothing new.
+ */
+class MTV_PUBLIC VisualRenderer : public MThread
+{
+  public:
+    struct Samples
+    {
+        std::vector<short> m_left;
+        std::vector<short> m_right;     ///< empty for mono
+        AudioAnalysisPtr   m_analysis;  ///< if the visualiser asked for one
+    };
+
+    using RenderFunction = std::function<bool(const Samples&, QSize, QImage&)>;
+
+    VisualRenderer(const QString &Name, RenderFunction Render);
+   ~VisualRenderer() override;
+
+    void   SetSize(QSize Size);
+    void   Post(Samples &&Input);
+    /// the last finished frame, and how many have been finished so far
+    QImage Frame(uint64_t *Serial = nullptr) const;
+    /// wait for the render thread to finish, before what it renders with goes
+    void   Stop(void);
+
+  protected:
+    void run(void) override; // MThread
+
+  private:
+    RenderFunction        m_render;
+
+    mutable QMutex        m_lock;
+    QWaitCondition        m_wait;
+    Samples               m_pending;
+    bool                  m_havePending { false };
+    bool                  m_stop        { false };
+    QSize                 m_size;
+    QImage                m_front;
+    uint64_t              m_serial      { 0 };
+
+    // only used by the render thread
+    QImage                m_back;
+};
+
+#endif // VISUALRENDERER_H
@@ -26,12 +26,12 @@ HEADERS += mythuilocation.h
 HEADERS += mythuiscreenbounds.h
 HEADERS += myththemebase.h
 HEADERS += mythpainter_qt.h mythuihelper.h
-HEADERS += mythpaintergpu.h
+HEADERS += mythpaintergpu.h mythglyphatlas.h
 HEADERS += mythscreenstack.h mythgesture.h mythuitype.h mythscreentype.h
 HEADERS += mythuiimage.h mythuitext.h mythuistatetype.h  xmlparsebase.h
 HEADERS += mythuibutton.h myththemedmenu.h mythdialogbox.h
 HEADERS += mythuiclock.h mythuitextedit.h mythprogressdialog.h mythuispinbox.h
-HEADERS += mythuicheckbox.h mythuibuttonlist.h mythuigroup.h
+HEADERS += mythuicheckbox.h mythuibuttonlist.h mythuibuttonlistmodel.h mythuigroup.h
 HEADERS += mythuiprogressbar.h mythuifilebrowser.h
 HEADERS += mythscreensaver.h
 HEADERS += x11colors.h
@@ -68,7 +68,7 @@ SOURCES += mythuiscreenbounds.cpp
 SOURCES += myththemebase.cpp
 SOURCES += mythrender.cpp
 SOURCES += mythpainter_qt.cpp xmlparsebase.cpp mythuihelper.cpp
-SOURCES += mythpaintergpu.cpp
+SOURCES += mythpaintergpu.cpp mythglyphatlas.cpp
 SOURCES += mythscreenstack.cpp mythgesture.cpp mythuitype.cpp mythscreentype.cpp
 SOURCES += mythuiimage.cpp mythuitext.cpp mythuifilebrowser.cpp
 SOURCES += mythuistatetype.cpp mythfontproperties.cpp
@@ -118,7 +118,7 @@ inc.files += mythscreenstack.h mythscreentype.h mythuitype.h mythuiimage.h
 inc.files += mythuitext.h mythuibutton.h mythlistbutton.h xmlparsebase.h
 inc.files += myththemedmenu.h mythdialogbox.h mythfontproperties.h
 inc.files += mythuiclock.h mythgesture.h mythuitextedit.h mythprogressdialog.h
-inc.files += mythuispinbox.h mythuicheckbox.h mythuibuttonlist.h mythuigroup.h
+inc.files += mythuispinbox.h mythuicheckbox.h mythuibuttonlist.h mythuibuttonlistmodel.h mythuigroup.h
 inc.files += mythuiprogressbar.h mythuiwebbrowser.h mythuiutils.h
 inc.files += x11colors.h mythgenerictree.h mythuibuttontree.h
 inc.files += mythvirtualkeyboard.h mythuishape.h mythuiguidegrid.h
@@ -0,0 +1,398 @@
+// C++
+#include <algorithm>
+#include <cmath>
+
+// Qt
+#include <QFontMetrics>
+#include <QPainter>
+#include <QPainterPath>
+#include <QRawFont>
+#include <QTextLayout>
+
+// MythTV
+#include "mythfontproperties.h"
+#include "mythrect.h"
+#include "mythglyphatlas.h"
+
+// Transparent gap left around each glyph so that neighbours never bleed
+// into each other when the texture is sampled.
+static constexpr int kPadding { 1 };
+
+MythGlyphAtlas::MythGlyphAtlas()
+{
+    Clear();
+}
+
+/*! \brief Clear the atlas.
+ *
+ * Called when a piece of text does not fit in the space that is left. All
+ * glyphs are dropped and the whole image is marked as needing an upload.
+ */
+void MythGlyphAtlas::Clear(void)
+{
+    if (m_image.isNull())
+        m_image = QImage(kAtlasSize, kAtlasSize, QImage::Format_ARGB32);
+    m_image.fill(qRgba(255, 255, 255, 0));
+    m_dirty       = m_image.rect();
+    m_glyphs.clear();
+    m_lines.clear();
+    m_glyphCount  = 0;
+    m_shelfX      = 0;
+    m_shelfY      = 0;
+    m_shelfHeight = 0;
+}
+
+/// \brief Return the area of the atlas changed since the last call.
+QRect MythGlyphAtlas::TakeDirtyRect(void)
+{
+    QRect result = m_dirty;
+    m_dirty = QRect();
+    return result;
+}
+
+/*! \brief Build the glyph quads for a set of text layouts.
+ *
+ * Used for MythUIText. This matches MythPainter::GetImageFromTextLayout:
+ * the layouts are drawn at Origin offset by their own positions, with an
+ * optional shadow and the outline carried in the layout formats.
+ */
+bool MythGlyphAtlas::Layout(const LayoutVector &Layouts,
+                            const MythFontProperties &Font,
+                            QPoint Origin, QRect Clip, Runs &Result)
+{
+    if (Font.GetBrush().style() != Qt::SolidPattern)
+        return false;
+
+    Style style;
+    style.m_fill = Font.GetBrush().color();
+
+    if (Font.hasShadow())
+    {
+        QPoint offset;
+        int    alpha = 255;
+        Font.GetShadow(offset, style.m_shadow, alpha);
+        style.m_shadow.setAlpha(alpha);
+        MythPoint shadow(offset);
+        shadow.NormPoint(); // scale it to screen resolution
+        style.m_shadowOffset = shadow.toQPoint();
+    }
+
+    // Only the outline set up by MythUIText::FormatTemplate is supported.
+    // Template fonts, colours etc are left to QPainter.
+    for (auto *layout : std::as_const(Layouts))
+    {
+        const FormatVector formats = layout->formats();
+        for (const auto & range : formats)
+        {
+            const auto properties = range.format.properties();
+            for (auto it = properties.cbegin(); it != properties.cend(); ++it)
+                if (it.key() != QTextFormat::TextOutline)
+                    return false;
+
+            QPen pen = range.format.textOutline();
+            if (pen.style() == Qt::NoPen || pen.width() < 1)
+                continue;
+            if (range.start > 0 || range.length < layout->text().size() ||
+                pen.brush().style() != Qt::SolidPattern)
+            {
+                return false;
+            }
+            style.m_outline      = pen.color();
+            style.m_outlineWidth = pen.width();
+        }
+    }
+
+    for (int attempt = 0; attempt < 2; ++attempt)
+    {
+        ResetRuns(Result, style);
+        Status status = kOk;
+        for (auto *layout : std::as_const(Layouts))
+        {
+            status = AddGlyphRuns(layout->glyphRuns(),
+                                  QPointF(Origin) + layout->position(),
+                                  style, Clip, Result);
+            if (status != kOk)
+                break;
+        }
+
+        if (status == kOk)
+            return true;
+        if (status == kUnsupported)
+            return false;
+        Clear();
+    }
+    return false;
+}
+
+/*! \brief Build the glyph quads for a single line of text.
+ *
+ * Used for MythPainter::DrawText. The placement matches
+ * MythPainter::DrawTextPriv, which draws the text into an image the size of
+ * Area. Outlines, word wrapping and multiple lines are not supported.
+ */
+bool MythGlyphAtlas::Layout(const QString &Message, int Flags, QRect Area,
+                            const MythFontProperties &Font, QRect Clip,
+                            Runs &Result)
+{
+    static constexpr int kUnsupportedFlags =
+        Qt::TextWordWrap | Qt::TextWrapAnywhere | Qt::TextShowMnemonic |
+        Qt::TextHideMnemonic | Qt::TextExpandTabs | Qt::AlignJustify;
+
+    if (Font.hasOutline() || (Flags & kUnsupportedFlags) ||
+        Font.GetBrush().style() != Qt::SolidPattern ||
+        Message.contains('\n') || Message.contains('\t') ||
+        Message.isRightToLeft())
+    {
+        return false;
+    }
+
+    Style style;
+    style.m_fill = Font.GetBrush().color();
+    if (Font.hasShadow())
+    {
+        int alpha = 255;
+        Font.GetShadow(style.m_shadowOffset, style.m_shadow, alpha);
+        style.m_shadow.setAlpha(alpha);
+    }
+
+    // Shaping is the expensive part, so keep the glyph runs for strings
+    // seen recently.
+    QString key = Font.GetHash() + QString::number(Flags) + ':' +
+                  QString::number(Area.width()) + ':' +
+                  QString::number(Area.height()) + ':' + Message;
+    TextLine *line = m_lines.object(key);
+    if (!line)
+    {
+        QTextLayout layout(Message, Font.face());
+        layout.beginLayout();
+        QTextLine textline = layout.createLine();
+        if (!textline.isValid())
+        {
+            layout.endLayout();
+            return false;
+        }
+        textline.setLineWidth(0x01000000);
+        textline.setPosition(QPointF(0, 0));
+        layout.endLayout();
+
+        QFontMetrics fm(Font.face());
+        int totalHeight = fm.height() + std::abs(style.m_shadowOffset.y());
+        qreal x = std::max(0, -style.m_shadowOffset.x());
+        qreal y = ((Area.height() - totalHeight) / 2) +
+                  std::max(0, -style.m_shadowOffset.y());
+
+        if (Flags & Qt::AlignRight)
+            x += Area.width() - textline.naturalTextWidth();
+        else if (Flags & Qt::AlignHCenter)
+            x += (Area.width() - textline.naturalTextWidth()) / 2.0;
+
+        if (Flags & Qt::AlignBottom)
+            y += Area.height() - textline.height();
+        else if (Flags & Qt::AlignVCenter)
+            y += (Area.height() - textline.height()) / 2.0;
+
+        line = new TextLine { layout.glyphRuns(), QPointF(x, y) };
+        m_lines.insert(key, line);
+    }
+
+    // Copy before laying out, the cache is emptied if the atlas fills up
+    TextLine text = *line;
+    for (int attempt = 0; attempt < 2; ++attempt)
+    {
+        ResetRuns(Result, style);
+        Status status = AddGlyphRuns(text.m_runs,
+                                     QPointF(Area.topLeft()) + text.m_offset,
+                                     style, Clip, Result);
+        if (status == kOk)
+            return true;
+        if (status == kUnsupported)
+            return false;
+        Clear();
+    }
+    return false;
+}
+
+void MythGlyphAtlas::ResetRuns(Runs &Result, const Style &TextStyle)
+{
+    for (auto & run : Result)
+    {
+        run.m_sources.clear();
+        run.m_destinations.clear();
+    }
+    Result[kShadowPass].m_color  = TextStyle.m_shadow;
+    Result[kFillPass].m_color    = TextStyle.m_fill;
+    Result[kOutlinePass].m_color = TextStyle.m_outline;
+}
+
+MythGlyphAtlas::Status MythGlyphAtlas::AddGlyphRuns(const QList<QGlyphRun> &GlyphRuns,
+                                                    QPointF Origin,
+                                                    const Style &TextStyle,
+                                                    QRect Clip, Runs &Result)
+{
+    for (const auto & run : GlyphRuns)
+    {
+        if (run.underline() || run.overline() || run.strikeOut())
+            return kUnsupported;
+
+        QRawFont font = run.rawFont();
+        QString fontkey = font.familyName() + ':' + font.styleName() + ':' +
+                          QString::number(font.pixelSize()) + ':' +
+                          QString::number(font.weight()) + ':' +
+                          QString::number(font.style());
+
+        const auto indexes   = run.glyphIndexes();
+        const auto positions = run.positions();
+        for (qsizetype i = 0; i < indexes.size() && i < positions.size(); ++i)
+        {
+            // Snap to the pixel grid vertically and to a quarter pixel
+            // horizontally, so that each glyph is rendered at most
+            // kSubPixel times per outline width.
+            QPointF position = Origin + positions[i];
+            qreal left = std::floor(position.x());
+            int subpixel = qRound((position.x() - left) * kSubPixel);
+            if (subpixel >= kSubPixel)
+            {
+                left += 1.0;
+                subpixel = 0;
+            }
+            QPoint pen(static_cast<int>(left), qRound(position.y()));
+
+            Status status = kOk;
+            const Glyph *glyph = GetGlyph(font, fontkey, indexes[i],
+                                          subpixel, 0, status);
+            if (!glyph)
+                return status;
+
+            if (TextStyle.m_shadow.isValid())
+            {
+                AddQuad(Result[kShadowPass], *glyph,
+                        pen + TextStyle.m_shadowOffset, Clip);
+            }
+            AddQuad(Result[kFillPass], *glyph, pen, Clip);
+
+            if (TextStyle.m_outlineWidth > 0)
+            {
+                glyph = GetGlyph(font, fontkey, indexes[i], subpixel,
+                                 TextStyle.m_outlineWidth, status);
+                if (!glyph)
+                    return status;
+                AddQuad(Result[kOutlinePass], *glyph, pen, Clip);
+            }
+        }
+    }
+    return kOk;
+}
+
+/*! \brief Find a glyph in the atlas, rendering it if needed.
+ *
+ * The glyph is filled or, if Outline is non zero, stroked with a pen of that
+ * width. Returns nullptr and sets Result if it could not be added.
+ */
+const MythGlyphAtlas::Glyph* MythGlyphAtlas::GetGlyph(const QRawFont &Font,
+                                                      const QString &FontKey,
+                                                      quint32 Index, int SubPixel,
+                                                      int Outline, Status &Result)
+{
+    quint64 key = static_cast<quint64>(Index) |
+                  (static_cast<quint64>(SubPixel) << 32) |
+                  (static_cast<quint64>(Outline) << 40);
+
+    QHash<quint64, Glyph> &glyphs = m_glyphs[FontKey];
+    auto found = glyphs.constFind(key);
+    if (found != glyphs.constEnd())
+        return &found.value();
+
+    QPainterPath path = Font.pathForGlyph(Index);
+    path.translate(static_cast<qreal>(SubPixel) / kSubPixel, 0.0);
+
+    Glyph glyph;
+    if (!path.isEmpty())
+    {
+        // Allow for antialiasing and half of the outline on each side
+        qreal margin = 1.0 + (Outline / 2.0);
+        QRect bounds = path.boundingRect()
+                           .adjusted(-margin, -margin, margin, margin)
+                           .toAlignedRect();
+
+        if (!Allocate(bounds.size(), glyph.m_source))
+        {
+            bool toobig = bounds.width()  + kPadding > kAtlasSize ||
+                          bounds.height() + kPadding > kAtlasSize;
+            Result = toobig ? kUnsupported : kAtlasFull;
+            return nullptr;
+        }
+        glyph.m_offset = bounds.topLeft();
+
+        QImage coverage(bounds.size(), QImage::Format_Alpha8);
+        coverage.fill(0);
+        QPainter painter(&coverage);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.translate(-bounds.topLeft());
+        if (Outline > 0)
+        {
+            painter.strokePath(path, QPen(Qt::white, Outline, Qt::SolidLine,
+                                          Qt::SquareCap, Qt::BevelJoin));
+        }
+        else
+        {
+            painter.fillPath(path, Qt::white);
+        }
+        painter.end();
+
+        const QRect &dest = glyph.m_source;
+        for (int y = 0; y < dest.height(); ++y)
+        {
+            const uchar *src = coverage.constScanLine(y);
+            auto *dst = reinterpret_cast<QRgb*>(m_image.scanLine(dest.top() + y)) + dest.left();
+            for (int x = 0; x < dest.width(); ++x)
+                dst[x] = qRgba(255, 255, 255, src[x]);
+        }
+        m_dirty |= dest;
+    }
+
+    ++m_glyphCount;
+    return &glyphs.insert(key, glyph).value();
+}
+
+/// \brief Find space for a glyph of the given size using simple shelf packing.
+bool MythGlyphAtlas::Allocate(QSize Size, QRect &Result)
+{
+    int width  = Size.width()  + kPadding;
+    int height = Size.height() + kPadding;
+    if (width > kAtlasSize || height > kAtlasSize)
+        return false;
+
+    if (m_shelfX + width > kAtlasSize)
+    {
+        m_shelfY     += m_shelfHeight;
+        m_shelfX      = 0;
+        m_shelfHeight = 0;
+    }
+    if (m_shelfY + height > kAtlasSize)
+        return false;
+
+    Result = QRect(QPoint(m_shelfX, m_shelfY), Size);
+    m_shelfX     += width;
+    m_shelfHeight = std::max(m_shelfHeight, height);
+    return true;
+}
+
+/// \brief Add a glyph quad to Target, clipped to Clip.
+void MythGlyphAtlas::AddQuad(Run &Target, const Glyph &Source,
+                             QPoint Position, QRect Clip)
+{
+    if (Source.m_source.isEmpty())
+        return;
+
+    QRect dest(Position + Source.m_offset, Source.m_source.size());
+    QRect clipped = dest & Clip;
+    if (clipped.isEmpty())
+        return;
+
+    QRect source = Source.m_source.adjusted(clipped.left() - dest.left(),
+                                            clipped.top() - dest.top(),
+                                            clipped.right() - dest.right(),
+                                            clipped.bottom() - dest.bottom());
+    Target.m_sources.push_back(source);
+    Target.m_destinations.push_back(clipped);
+}
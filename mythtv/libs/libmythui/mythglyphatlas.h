@@ -0,0 +1,120 @@
+#ifndef MYTHGLYPHATLAS_H
+#define MYTHGLYPHATLAS_H
+
+// C++
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Qt
+#include <QCache>
+#include <QColor>
+#include <QGlyphRun>
+#include <QHash>
+#include <QImage>
+#include <QRect>
+
+// MythTV
+#include "mythuiexp.h"
+#include "mythpainter.h"
+
+class QRawFont;
+
+/*! \class MythGlyphAtlas
+ * \brief Rasterises text glyphs once into a shared atlas image.
+ *
+ * Text is broken into glyph runs and each glyph is rendered, at one of
+ * kSubPixel horizontal offsets and optionally as an outline, into a single
+ * ARGB image holding white glyphs with the coverage in the alpha channel.
+ * A painter uploads the atlas as one texture and draws each pass of a piece
+ * of text (shadow, fill, outline) as one batch of quads tinted with the
+ * pass colour, instead of rendering every distinct string to its own image.
+ *
+ * Layout() returns false for text it cannot reproduce exactly (gradient
+ * brushes, rich text formats, decorations etc), in which case the caller
+ * should fall back to MythPainter's image based text rendering.
+ */
+class MUI_PUBLIC MythGlyphAtlas
+{
+  public:
+    enum Pass : std::uint8_t
+    {
+        kShadowPass = 0,
+        kFillPass,
+        kOutlinePass,
+        kPassCount
+    };
+
+    struct Run
+    {
+        QColor             m_color;
+        std::vector<QRect> m_sources;
+        std::vector<QRect> m_destinations;
+    };
+    using Runs = std::array<Run, kPassCount>;
+
+    MythGlyphAtlas();
+
+    bool Layout(const LayoutVector &Layouts, const MythFontProperties &Font,
+                QPoint Origin, QRect Clip, Runs &Result);
+    bool Layout(const QString &Message, int Flags, QRect Area,
+                const MythFontProperties &Font, QRect Clip, Runs &Result);
+
+    const QImage& GetImage(void) const { return m_image; }
+    QRect TakeDirtyRect(void);
+    int   GetGlyphCount(void) const { return m_glyphCount; }
+    void  Clear(void);
+
+    static constexpr int kAtlasSize { 1024 };
+    static constexpr int kSubPixel  { 4 };
+
+  private:
+    struct Glyph
+    {
+        QRect  m_source;
+        QPoint m_offset;
+    };
+
+    struct Style
+    {
+        QColor m_fill;
+        QColor m_shadow;
+        QPoint m_shadowOffset;
+        QColor m_outline;
+        int    m_outlineWidth { 0 };
+    };
+
+    struct TextLine
+    {
+        QList<QGlyphRun> m_runs;
+        QPointF          m_offset;
+    };
+
+    enum Status : std::uint8_t
+    {
+        kOk,
+        kAtlasFull,
+        kUnsupported
+    };
+
+    Status AddGlyphRuns(const QList<QGlyphRun> &GlyphRuns, QPointF Origin,
+                        const Style &TextStyle, QRect Clip, Runs &Result);
+    const Glyph* GetGlyph(const QRawFont &Font, const QString &FontKey,
+                          quint32 Index, int SubPixel, int Outline,
+                          Status &Result);
+    bool Allocate(QSize Size, QRect &Result);
+    static void AddQuad(Run &Target, const Glyph &Source, QPoint Position,
+                        QRect Clip);
+    static void ResetRuns(Runs &Result, const Style &TextStyle);
+
+    QImage m_image;
+    QRect  m_dirty;
+    QHash<QString, QHash<quint64, Glyph>> m_glyphs;
+    QCache<QString, TextLine> m_lines { 512 };
+    int    m_glyphCount  { 0 };
+    int    m_shelfX      { 0 };
+    int    m_shelfY      { 0 };
+    int    m_shelfHeight { 0 };
+};
+
+#endif
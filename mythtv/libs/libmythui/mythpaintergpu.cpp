@@ -1,3 +1,7 @@
+// C++
+#include <algorithm>
+
+// Qt
 #include <QtGlobal>
 #include <QWindow>
 
@@ -22,6 +26,55 @@ void MythPainterGPU::SetViewControl(ViewControls Control)
     m_viewControl = Control;
 }
 
+void MythPainterGPU::Begin(QPaintDevice* Parent)
+{
+    MythPainter::Begin(Parent);
+    m_frameTimer.start();
+}
+
+/*! \brief Record the time taken to draw the current frame.
+ *
+ * Called by the painter once all drawing is submitted and before the buffers
+ * are swapped, so that waiting for vsync is not included. Every 10 seconds
+ * the average and worst frame times and the texture data uploaded per frame
+ * are logged with -v gpu.
+*/
+void MythPainterGPU::FrameDrawn(void)
+{
+    if (!m_frameTimer.isValid())
+        return;
+
+    int64_t elapsed = m_frameTimer.nsecsElapsed();
+    m_frameTimer.invalidate();
+    m_statsFrames++;
+    m_statsTotalNs += elapsed;
+    m_statsMaxNs = std::max(m_statsMaxNs, elapsed);
+
+    if (!m_statsTimer.isValid())
+        m_statsTimer.start();
+    if (m_statsTimer.elapsed() < 10000)
+        return;
+
+    LOG(VB_GPU, LOG_INFO, QString("%1 painter: %2 frames, draw avg %3ms max %4ms, "
+                                  "texture upload %5KB/frame")
+        .arg(GetName()).arg(m_statsFrames)
+        .arg(static_cast<double>(m_statsTotalNs) / m_statsFrames / 1000000.0, 0, 'f', 2)
+        .arg(static_cast<double>(m_statsMaxNs) / 1000000.0, 0, 'f', 2)
+        .arg(m_statsUpload / 1024 / m_statsFrames));
+
+    m_statsFrames  = 0;
+    m_statsTotalNs = 0;
+    m_statsMaxNs   = 0;
+    m_statsUpload  = 0;
+    m_statsTimer.restart();
+}
+
+/// \brief Count texture data sent to the GPU for the frame statistics.
+void MythPainterGPU::AddTextureUpload(int64_t Bytes)
+{
+    m_statsUpload += Bytes;
+}
+
 void MythPainterGPU::DisplayChanged()
 {
     MythDisplay* display = m_parent->GetDisplay();
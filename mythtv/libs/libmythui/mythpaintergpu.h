@@ -1,6 +1,9 @@
 #ifndef MYTHPAINTERGPU_H
 #define MYTHPAINTERGPU_H
 
+// Qt
+#include <QElapsedTimer>
+
 // MythTV
 #include "mythuiexp.h"
 #include "mythpainter.h"
@@ -25,16 +28,28 @@ class MUI_PUBLIC MythPainterGPU : public MythPainter
    ~MythPainterGPU() override = default;
 
     void SetViewControl    (ViewControls Control);
+    void Begin(QPaintDevice* Parent) override;
 
   public slots:
     void DisplayChanged ();
 
   protected:
+    void FrameDrawn        (void);
+    void AddTextureUpload  (int64_t Bytes);
+
     MythMainWindow* m_parent      { nullptr };
     ViewControls   m_viewControl  { Viewport | Framebuffer };
     qreal          m_pixelRatio   { 1.0     };
     bool           m_usingHighDPI { false   };
     QSize          m_lastSize;
+
+  private:
+    QElapsedTimer  m_frameTimer;
+    QElapsedTimer  m_statsTimer;
+    int            m_statsFrames  { 0 };
+    int64_t        m_statsTotalNs { 0 };
+    int64_t        m_statsMaxNs   { 0 };
+    int64_t        m_statsUpload  { 0 };
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(MythPainterGPU::ViewControls)
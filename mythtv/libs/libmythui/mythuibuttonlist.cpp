@@ -12,6 +12,7 @@
 
 // libmythbase headers
 #include "libmythbase/lcddevice.h"
+#include "libmythbase/mthreadpool.h"
 #include "libmythbase/mythlogging.h"
 
 // mythui headers
@@ -68,11 +69,13 @@ void MythUIButtonList::Const(void)
 
 MythUIButtonList::~MythUIButtonList()
 {
+    StopRearrange();
     m_buttonToItem.clear();
     m_clearing = true;
 
     while (!m_itemList.isEmpty())
         delete m_itemList.takeFirst();
+    qDeleteAll(m_modelItems);
 }
 
 void MythUIButtonList::Select()
@@ -121,9 +124,13 @@ void MythUIButtonList::Reset()
 {
     m_buttonToItem.clear();
 
-    if (m_itemList.isEmpty())
+    if (m_itemList.isEmpty() && !m_model)
         return;
 
+    StopRearrange();
+    ClearModelItems();
+    m_model = nullptr;
+
     m_clearing = true;
 
     while (!m_itemList.isEmpty())
@@ -216,7 +223,7 @@ MythUIGroup *MythUIButtonList::PrepareButton(int buttonIdx, int itemIdx,
                                              int &selectedIdx,
                                              int &button_shift)
 {
-    MythUIButtonListItem *buttonItem = m_itemList[itemIdx];
+    MythUIButtonListItem *buttonItem = GetItemAt(itemIdx);
 
     buttonIdx += button_shift;
 
@@ -1333,7 +1340,7 @@ void MythUIButtonList::CalculateButtonPositions(void)
             }
 
             // Adjusted if last item is deleted
-            if (((m_itemList.count() - m_topPosition) < m_itemsVisible) &&
+            if (((m_itemCount - m_topPosition) < m_itemsVisible) &&
                 (m_selPosition - (m_itemsVisible - 1) < m_topPosition) &&
                  m_columns == 1)
                 m_topPosition = m_selPosition - (m_itemsVisible - 1);
@@ -1343,8 +1350,7 @@ void MythUIButtonList::CalculateButtonPositions(void)
         }
     }
 
-    QList<MythUIButtonListItem *>::iterator it = m_itemList.begin() +
-                                                 m_topPosition;
+    int pos = m_topPosition;
 
     if (m_scrollStyle == ScrollCenter || m_scrollStyle == ScrollGroupCenter)
     {
@@ -1355,13 +1361,13 @@ void MythUIButtonList::CalculateButtonPositions(void)
             if (m_wrapStyle == WrapItems && button > 0 &&
                 m_itemCount >= m_itemsVisible)
             {
-                it = m_itemList.end() - button;
+                pos = m_itemCount - button;
                 button = 0;
             }
         }
         else if ((m_itemCount - m_selPosition) < (m_itemsVisible / 2))
         {
-            it = m_itemList.begin() + m_selPosition - (m_itemsVisible / 2);
+            pos = m_selPosition - (m_itemsVisible / 2);
         }
     }
     else if (drawFromBottom && m_itemCount < m_itemsVisible)
@@ -1377,22 +1383,19 @@ void MythUIButtonList::CalculateButtonPositions(void)
     MythUIStateType *realButton = nullptr;
     MythUIButtonListItem *buttonItem = nullptr;
 
-    if (it < m_itemList.begin())
-        it = m_itemList.begin();
-
-    int curItem = it < m_itemList.end() ? GetItemPos(*it) : 0;
+    pos = std::max(pos, 0);
 
-    while (it < m_itemList.end() && button < m_itemsVisible)
+    while (pos < m_itemCount && button < m_itemsVisible)
     {
         realButton = m_buttonList[button];
-        buttonItem = *it;
+        buttonItem = GetItemAt(pos);
 
         if (!realButton || !buttonItem)
             break;
 
         bool selected = false;
 
-        if (!seenSelected && (curItem == m_selPosition))
+        if (!seenSelected && (pos == m_selPosition))
         {
             seenSelected = true;
             selected = true;
@@ -1402,16 +1405,14 @@ void MythUIButtonList::CalculateButtonPositions(void)
         buttonItem->SetToRealButton(realButton, selected);
         realButton->SetVisible(true);
 
-        if (m_wrapStyle == WrapItems && it == (m_itemList.end() - 1) &&
+        if (m_wrapStyle == WrapItems && pos == (m_itemCount - 1) &&
             m_itemCount >= m_itemsVisible)
         {
-            it = m_itemList.begin();
-            curItem = 0;
+            pos = 0;
         }
         else
         {
-            ++it;
-            ++curItem;
+            ++pos;
         }
 
         ++button;
@@ -1424,9 +1425,9 @@ void MythUIButtonList::CalculateButtonPositions(void)
 void MythUIButtonList::SanitizePosition(void)
 {
     if (m_selPosition < 0)
-        m_selPosition = (m_wrapStyle > WrapNone) ? m_itemList.size() - 1 : 0;
-    else if (m_selPosition >= m_itemList.size())
-        m_selPosition = (m_wrapStyle > WrapNone) ? 0 : m_itemList.size() - 1;
+        m_selPosition = (m_wrapStyle > WrapNone) ? m_itemCount - 1 : 0;
+    else if (m_selPosition >= m_itemCount)
+        m_selPosition = (m_wrapStyle > WrapNone) ? 0 : m_itemCount - 1;
 }
 
 void MythUIButtonList::CalculateArrowStates()
@@ -1497,9 +1498,18 @@ void MythUIButtonList::ItemVisible(MythUIButtonListItem *item)
 
 void MythUIButtonList::InsertItem(MythUIButtonListItem *item, int listPosition)
 {
+    if (m_model)
+    {
+        LOG(VB_GENERAL, LOG_ERR, QString("(%1) Cannot add '%2' to a list "
+                                         "showing a model")
+            .arg(objectName(), item->GetText()));
+        item->m_parent = nullptr;
+        return;
+    }
+
     bool wasEmpty = m_itemList.isEmpty();
 
-    if (listPosition >= 0 && listPosition <= m_itemList.count())
+    if (listPosition >= 0 && listPosition <= m_itemCount)
     {
         m_itemList.insert(listPosition, item);
 
@@ -1572,7 +1582,7 @@ void MythUIButtonList::RemoveItem(MythUIButtonListItem *item)
     Update();
 
     if (m_selPosition < m_itemCount)
-        emit itemSelected(m_itemList.at(m_selPosition));
+        emit itemSelected(GetItemAt(m_selPosition));
     else
         emit itemSelected(nullptr);
 
@@ -1585,11 +1595,19 @@ void MythUIButtonList::SetValueByData(const QVariant& data)
     if (!m_initialized)
         Init();
 
-    for (auto *item : std::as_const(m_itemList))
+    if (m_model)
     {
-        if (item->GetData() == data)
+        int row = m_model->FindData(data);
+        if (row >= 0)
+            SetItemCurrent(row);
+        return;
+    }
+
+    for (int pos = 0; pos < m_itemCount; ++pos)
+    {
+        if (GetItemAt(pos)->GetData() == data)
         {
-            SetItemCurrent(item);
+            SetItemCurrent(pos);
             return;
         }
     }
@@ -1597,8 +1615,7 @@ void MythUIButtonList::SetValueByData(const QVariant& data)
 
 void MythUIButtonList::SetItemCurrent(MythUIButtonListItem *item)
 {
-    int newIndex = m_itemList.indexOf(item);
-    SetItemCurrent(newIndex);
+    SetItemCurrent(GetItemPos(item));
 }
 
 void MythUIButtonList::SetItemCurrent(int current, int topPosition)
@@ -1606,10 +1623,10 @@ void MythUIButtonList::SetItemCurrent(int current, int topPosition)
     if (!m_initialized)
         Init();
 
-    if (current == -1 || current >= m_itemList.size())
+    if (current == -1 || current >= m_itemCount)
         return;
 
-    if (!m_itemList.at(current)->isEnabled())
+    if (!GetItemAt(current)->isEnabled())
         return;
 
     if (current == m_selPosition &&
@@ -1630,11 +1647,11 @@ void MythUIButtonList::SetItemCurrent(int current, int topPosition)
 
 MythUIButtonListItem *MythUIButtonList::GetItemCurrent() const
 {
-    if (m_itemList.isEmpty() || m_selPosition >= m_itemList.size() ||
+    if (m_itemCount == 0 || m_selPosition >= m_itemCount ||
         m_selPosition < 0)
         return nullptr;
 
-    return m_itemList.at(m_selPosition);
+    return GetItemAt(m_selPosition);
 }
 
 int MythUIButtonList::GetIntValue() const
@@ -1676,21 +1693,16 @@ MythRect MythUIButtonList::GetButtonArea(void) const
 
 MythUIButtonListItem *MythUIButtonList::GetItemFirst() const
 {
-    if (!m_itemList.empty())
-        return m_itemList[0];
-
-    return nullptr;
+    return GetItemAt(0);
 }
 
 MythUIButtonListItem *MythUIButtonList::GetItemNext(MythUIButtonListItem *item)
 const
 {
-    // Find item
-    auto it = std::ranges::find(m_itemList, item);
-    if (it == m_itemList.end())
+    int pos = GetItemPos(item);
+    if (pos < 0)
         return nullptr;
-    // Return next
-    return (++it != m_itemList.end()) ? *it : nullptr;
+    return GetItemAt(pos + 1);
 }
 
 int MythUIButtonList::GetCount() const
@@ -1716,9 +1728,12 @@ bool MythUIButtonList::IsEmpty() const
 
 MythUIButtonListItem *MythUIButtonList::GetItemAt(int pos) const
 {
-    if (pos < 0 || pos >= m_itemList.size())
+    if (pos < 0 || pos >= m_itemCount)
         return nullptr;
 
+    if (m_model)
+        return GetModelItem(pos);
+
     return m_itemList.at(pos);
 }
 
@@ -1727,8 +1742,13 @@ MythUIButtonListItem *MythUIButtonList::GetItemByData(const QVariant& data)
     if (!m_initialized)
         Init();
 
-    for (auto *item : std::as_const(m_itemList))
+    // Only bind an item to the row that matches
+    if (m_model)
+        return GetItemAt(m_model->FindData(data));
+
+    for (int pos = 0; pos < m_itemCount; ++pos)
     {
+        MythUIButtonListItem *item = GetItemAt(pos);
         if (item->GetData() == data)
             return item;
     }
@@ -1741,13 +1761,16 @@ int MythUIButtonList::GetItemPos(MythUIButtonListItem *item) const
     if (!item)
         return -1;
 
+    if (m_model)
+        return m_modelItems.value(item->m_modelRow) == item ? item->m_modelRow : -1;
+
     return m_itemList.indexOf(item);
 }
 
 void MythUIButtonList::InitButton(int itemIdx, MythUIStateType* & realButton,
                                   MythUIButtonListItem* & buttonItem)
 {
-    buttonItem = m_itemList[itemIdx];
+    buttonItem = GetItemAt(itemIdx);
 
     if (m_maxVisible == 0)
     {
@@ -1880,7 +1903,7 @@ int MythUIButtonList::PageUp(void)
 int MythUIButtonList::PageDown(void)
 {
     int pos        = m_selPosition;
-    int num_items  = m_itemList.size();
+    int num_items  = m_itemCount;
     int total      = 0;
 
     /*
@@ -1987,7 +2010,7 @@ bool MythUIButtonList::MoveUp(MovementUnit unit, uint amount)
 {
     int pos = m_selPosition;
 
-    if (pos == -1 || m_itemList.isEmpty() || !m_initialized)
+    if (pos == -1 || m_itemCount == 0 || !m_initialized)
         return false;
 
     switch (unit)
@@ -1996,7 +2019,7 @@ bool MythUIButtonList::MoveUp(MovementUnit unit, uint amount)
             if (m_selPosition > 0)
                 --m_selPosition;
             else if (m_wrapStyle > WrapNone)
-                m_selPosition = m_itemList.size() - 1;
+                m_selPosition = m_itemCount - 1;
             else if (m_wrapStyle == WrapCaptive)
                 return true;
 
@@ -2012,7 +2035,7 @@ bool MythUIButtonList::MoveUp(MovementUnit unit, uint amount)
             else if (m_wrapStyle == WrapFlowing)
             {
                 if (m_selPosition == 0)
-                    --m_selPosition = m_itemList.size() - 1;
+                    --m_selPosition = m_itemCount - 1;
                 else
                     --m_selPosition;
             }
@@ -2034,9 +2057,9 @@ bool MythUIButtonList::MoveUp(MovementUnit unit, uint amount)
             {
                 m_selPosition -= m_columns;
                 if (m_selPosition < 0)
-                    m_selPosition += m_itemList.size();
+                    m_selPosition += m_itemCount;
                 else
-                    m_selPosition %= m_itemList.size();
+                    m_selPosition %= m_itemCount;
             }
             else if ((pos - m_columns) >= 0)
             {
@@ -2044,12 +2067,12 @@ bool MythUIButtonList::MoveUp(MovementUnit unit, uint amount)
             }
             else if (m_wrapStyle > WrapNone)
             {
-                m_selPosition = (((m_itemList.size() - 1) / m_columns) *
+                m_selPosition = (((m_itemCount - 1) / m_columns) *
                                 m_columns) + pos;
 
                 if ((m_selPosition / m_columns)
-                    < ((m_itemList.size() - 1) / m_columns))
-                    m_selPosition = m_itemList.size() - 1;
+                    < ((m_itemCount - 1) / m_columns))
+                    m_selPosition = m_itemCount - 1;
 
                 if (m_layout == LayoutVertical)
                     m_topPosition = std::max(0, m_selPosition - m_itemsVisible + 1);
@@ -2074,7 +2097,7 @@ bool MythUIButtonList::MoveUp(MovementUnit unit, uint amount)
             break;
 
         case MoveMid:
-            m_selPosition = m_itemList.size() / 2;
+            m_selPosition = m_itemCount / 2;
             FindEnabledUp(unit);
             break;
 
@@ -2089,7 +2112,7 @@ bool MythUIButtonList::MoveUp(MovementUnit unit, uint amount)
                 if (m_selPosition > 0)
                     --m_selPosition;
                 else if (m_wrapStyle > WrapNone)
-                    m_selPosition = m_itemList.size() - 1;
+                    m_selPosition = m_itemCount - 1;
             }
 
             FindEnabledUp(unit);
@@ -2118,8 +2141,8 @@ bool MythUIButtonList::MoveUp(MovementUnit unit, uint amount)
  */
 void MythUIButtonList::FindEnabledDown(MovementUnit unit)
 {
-    if (m_selPosition < 0 || m_selPosition >= m_itemList.size() ||
-        m_itemList.at(m_selPosition)->isEnabled())
+    if (m_selPosition < 0 || m_selPosition >= m_itemCount ||
+        GetItemAt(m_selPosition)->isEnabled())
         return;
 
     int step = (unit == MoveRow) ? m_columns : 1;
@@ -2127,35 +2150,35 @@ void MythUIButtonList::FindEnabledDown(MovementUnit unit)
         unit = MoveItem;
     if (unit == MoveColumn)
     {
-        while (m_selPosition < m_itemList.size() &&
+        while (m_selPosition < m_itemCount &&
                (m_selPosition + 1) % m_columns > 0 &&
-               !m_itemList.at(m_selPosition)->isEnabled())
+               !GetItemAt(m_selPosition)->isEnabled())
             ++m_selPosition;
 
-        if (m_itemList.at(m_selPosition)->isEnabled())
+        if (GetItemAt(m_selPosition)->isEnabled())
             return;
 
         if (m_wrapStyle > WrapNone)
         {
             m_selPosition = m_selPosition - (m_columns - 1);
             while ((m_selPosition + 1) % m_columns > 0 &&
-                   !m_itemList.at(m_selPosition)->isEnabled())
+                   !GetItemAt(m_selPosition)->isEnabled())
                 ++m_selPosition;
         }
     }
     else
     {
-        while (!m_itemList.at(m_selPosition)->isEnabled() &&
-               (m_selPosition < m_itemList.size() - step))
+        while (!GetItemAt(m_selPosition)->isEnabled() &&
+               (m_selPosition < m_itemCount - step))
             m_selPosition += step;
 
-        if (!m_itemList.at(m_selPosition)->isEnabled() &&
+        if (!GetItemAt(m_selPosition)->isEnabled() &&
             m_wrapStyle > WrapNone)
         {
-            m_selPosition = (m_selPosition + step) % m_itemList.size();
+            m_selPosition = (m_selPosition + step) % m_itemCount;
 
-            while (!m_itemList.at(m_selPosition)->isEnabled() &&
-                   (m_selPosition < m_itemList.size() - step))
+            while (!GetItemAt(m_selPosition)->isEnabled() &&
+                   (m_selPosition < m_itemCount - step))
                 m_selPosition += step;
         }
     }
@@ -2163,8 +2186,8 @@ void MythUIButtonList::FindEnabledDown(MovementUnit unit)
 
 void MythUIButtonList::FindEnabledUp(MovementUnit unit)
 {
-    if (m_selPosition < 0 || m_selPosition >= m_itemList.size() ||
-        m_itemList.at(m_selPosition)->isEnabled())
+    if (m_selPosition < 0 || m_selPosition >= m_itemCount ||
+        GetItemAt(m_selPosition)->isEnabled())
         return;
 
     int step = (unit == MoveRow) ? m_columns : 1;
@@ -2173,33 +2196,33 @@ void MythUIButtonList::FindEnabledUp(MovementUnit unit)
     if (unit == MoveColumn)
     {
         while (m_selPosition > 0 && (m_selPosition - 1) % m_columns > 0 &&
-               !m_itemList.at(m_selPosition)->isEnabled())
+               !GetItemAt(m_selPosition)->isEnabled())
             --m_selPosition;
 
-        if (m_itemList.at(m_selPosition)->isEnabled())
+        if (GetItemAt(m_selPosition)->isEnabled())
             return;
 
         if (m_wrapStyle > WrapNone)
         {
             m_selPosition = m_selPosition + (m_columns - 1);
             while ((m_selPosition - 1) % m_columns > 0 &&
-                   !m_itemList.at(m_selPosition)->isEnabled())
+                   !GetItemAt(m_selPosition)->isEnabled())
                 --m_selPosition;
         }
     }
     else
     {
-        while (!m_itemList.at(m_selPosition)->isEnabled() &&
+        while (!GetItemAt(m_selPosition)->isEnabled() &&
                (m_selPosition - step >= 0))
             m_selPosition -= step;
 
-        if (!m_itemList.at(m_selPosition)->isEnabled() &&
+        if (!GetItemAt(m_selPosition)->isEnabled() &&
             m_wrapStyle > WrapNone)
         {
-            m_selPosition = m_itemList.size() - 1;
+            m_selPosition = m_itemCount - 1;
 
             while (m_selPosition > 0 &&
-                   !m_itemList.at(m_selPosition)->isEnabled() &&
+                   !GetItemAt(m_selPosition)->isEnabled() &&
                    (m_selPosition - step >= 0))
                 m_selPosition -= step;
         }
@@ -2211,13 +2234,13 @@ bool MythUIButtonList::MoveDown(MovementUnit unit, uint amount)
 {
     int pos = m_selPosition;
 
-    if (pos == -1 || m_itemList.isEmpty() || !m_initialized)
+    if (pos == -1 || m_itemCount == 0 || !m_initialized)
         return false;
 
     switch (unit)
     {
         case MoveItem:
-            if (m_selPosition < m_itemList.size() - 1)
+            if (m_selPosition < m_itemCount - 1)
                 ++m_selPosition;
             else if (m_wrapStyle > WrapNone)
                 m_selPosition = 0;
@@ -2235,7 +2258,7 @@ bool MythUIButtonList::MoveDown(MovementUnit unit, uint amount)
             }
             else if (m_wrapStyle == WrapFlowing)
             {
-                if (m_selPosition < m_itemList.size() - 1)
+                if (m_selPosition < m_itemCount - 1)
                     ++m_selPosition;
                 else
                     m_selPosition = 0;
@@ -2254,19 +2277,19 @@ bool MythUIButtonList::MoveDown(MovementUnit unit, uint amount)
             break;
 
         case MoveRow:
-            if (m_itemList.empty() || m_columns < 1)
+            if (m_itemCount == 0 || m_columns < 1)
                 return true;
             if (m_scrollStyle != ScrollFree)
             {
                 m_selPosition += m_columns;
-                m_selPosition %= m_itemList.size();
+                m_selPosition %= m_itemCount;
             }
-            else if (((m_itemList.size() - 1) / std::max(m_columns, 0))
+            else if (((m_itemCount - 1) / std::max(m_columns, 0))
                      > (pos / m_columns))
             {
                 m_selPosition += m_columns;
-                if (m_selPosition >= m_itemList.size())
-                    m_selPosition = m_itemList.size() - 1;
+                if (m_selPosition >= m_itemCount)
+                    m_selPosition = m_itemCount - 1;
             }
             else if (m_wrapStyle > WrapNone)
             {
@@ -2304,7 +2327,7 @@ bool MythUIButtonList::MoveDown(MovementUnit unit, uint amount)
         case MoveByAmount:
             for (uint i = 0; i < amount; ++i)
             {
-                if (m_selPosition < m_itemList.size() - 1)
+                if (m_selPosition < m_itemCount - 1)
                     ++m_selPosition;
                 else if (m_wrapStyle > WrapNone)
                     m_selPosition = 0;
@@ -2337,23 +2360,29 @@ bool MythUIButtonList::MoveToNamedPosition(const QString &position_name)
     if (!m_initialized)
         Init();
 
-    if (m_selPosition < 0 || m_itemList.isEmpty() || !m_initialized)
+    if (m_selPosition < 0 || m_itemCount == 0 || !m_initialized)
         return false;
 
     bool found_it = false;
     int selectedPosition = 0;
-    QList<MythUIButtonListItem *>::iterator it = m_itemList.begin();
 
-    while (it != m_itemList.end())
+    if (m_model)
     {
-        if ((*it)->GetText() == position_name)
+        selectedPosition = m_model->FindText(position_name);
+        found_it = selectedPosition >= 0;
+    }
+    else
+    {
+        while (selectedPosition < m_itemCount)
         {
-            found_it = true;
-            break;
-        }
+            if (GetItemAt(selectedPosition)->GetText() == position_name)
+            {
+                found_it = true;
+                break;
+            }
 
-        ++it;
-        ++selectedPosition;
+            ++selectedPosition;
+        }
     }
 
     if (!found_it || m_selPosition == selectedPosition)
@@ -2365,7 +2394,8 @@ bool MythUIButtonList::MoveToNamedPosition(const QString &position_name)
 
 bool MythUIButtonList::MoveItemUpDown(MythUIButtonListItem *item, bool up)
 {
-    if (GetItemCurrent() != item)
+    // The order of a model's rows is up to the model
+    if (m_model || GetItemCurrent() != item)
         return false;
 
     if (item == m_itemList.first() && up)
@@ -2387,7 +2417,7 @@ bool MythUIButtonList::MoveItemUpDown(MythUIButtonListItem *item, bool up)
         else
             ++m_selPosition;
 
-        if (item == m_itemList.at(m_topPosition))
+        if (item == GetItemAt(m_topPosition))
             ++m_topPosition;
     }
     else
@@ -2418,6 +2448,8 @@ void MythUIButtonList::SetAllChecked(MythUIButtonListItem::CheckState state)
     for (const auto & it : std::as_const(m_itemList)) {
         it->setChecked(state);
     }
+    for (auto * it : std::as_const(m_modelItems))
+        it->setChecked(state);
 }
 
 void MythUIButtonList::Init()
@@ -2804,6 +2836,39 @@ class NextButtonListPageEvent : public QEvent
 const QEvent::Type NextButtonListPageEvent::kEventType =
     (QEvent::Type) QEvent::registerEventType();
 
+class ButtonListArrangeEvent : public QEvent
+{
+  public:
+    ButtonListArrangeEvent(uint generation, std::vector<int> rows) :
+        QEvent(kEventType), m_generation(generation), m_rows(std::move(rows)) {}
+    const uint       m_generation;
+    std::vector<int> m_rows;
+    static const Type kEventType;
+};
+
+const QEvent::Type ButtonListArrangeEvent::kEventType =
+    (QEvent::Type) QEvent::registerEventType();
+
+class ButtonListArrangeJob : public QRunnable
+{
+  public:
+    ButtonListArrangeJob(MythUIButtonList *list,
+                         const MythUIButtonListModel *model, uint generation) :
+        m_list(list), m_model(model), m_generation(generation) {}
+
+    void run(void) override
+    {
+        std::vector<int> rows;
+        bool arranged = m_model->Arrange(rows);
+        m_list->RearrangeDone(m_generation, arranged, rows);
+    }
+
+  private:
+    MythUIButtonList            *m_list;
+    const MythUIButtonListModel *m_model;
+    uint                         m_generation;
+};
+
 void MythUIButtonList::customEvent(QEvent *event)
 {
     if (event->type() == NextButtonListPageEvent::kEventType)
@@ -2824,6 +2889,21 @@ void MythUIButtonList::customEvent(QEvent *event)
                 LoadInBackground(cur, npe->m_pageSize);
         }
     }
+    else if (event->type() == ButtonListArrangeEvent::kEventType)
+    {
+        auto *ae = dynamic_cast<ButtonListArrangeEvent*>(event);
+        if (!ae || !m_model)
+            return;
+
+        {
+            QMutexLocker locker(&m_arrangeLock);
+            if (ae->m_generation != m_arrangeGeneration)
+                return;
+        }
+
+        m_model->SetArrangement(std::move(ae->m_rows));
+        ModelChanged();
+    }
 }
 
 void MythUIButtonList::LoadInBackground(int start, int pageSize)
@@ -2840,6 +2920,152 @@ int MythUIButtonList::StopLoad(void)
     return m_nextItemLoaded;
 }
 
+/**
+ * \brief Show the rows of a model instead of items added to the list.
+ *
+ * Any existing items are deleted. The list does not take ownership of the
+ * model, which must outlive it or be replaced first. Only the rows near
+ * the visible ones have a MythUIButtonListItem, so setting a model is
+ * equally quick however many rows it has.
+ */
+void MythUIButtonList::SetModel(MythUIButtonListModel *model)
+{
+    Reset();
+    m_model = model;
+    m_selPosition = 0;
+    m_topPosition = 0;
+    ModelChanged();
+}
+
+/**
+ * \brief Pick up a change to the number, order or content of the rows of
+ *        the model.
+ *
+ * The items for the rows are rebound as they are next needed. The selection
+ * stays on the same row number, as far as the new row count allows.
+ */
+void MythUIButtonList::ModelChanged(void)
+{
+    if (!m_model)
+        return;
+
+    ClearModelItems();
+    m_itemCount   = m_model->Count();
+    m_selPosition = std::clamp(m_selPosition, 0, std::max(m_itemCount - 1, 0));
+    m_topPosition = std::clamp(m_topPosition, 0, m_selPosition);
+
+    Update();
+    emit itemSelected(GetItemCurrent());
+    emit DependChanged(IsEmpty());
+}
+
+/**
+ * \brief Build a new row order for the model, e.g. after changing its
+ *        filter or sort order, without blocking the UI.
+ *
+ * MythUIButtonListModel::Arrange() is run on a pool thread and the result
+ * is applied with ModelChanged() when it is ready. A newer call, or a call
+ * to StopRearrange(), supersedes an older one that has not finished.
+ */
+bool MythUIButtonList::Rearrange(void)
+{
+    if (!m_model)
+        return false;
+
+    QMutexLocker locker(&m_arrangeLock);
+    ++m_arrangeJobs;
+    MThreadPool::globalInstance()->start(
+        new ButtonListArrangeJob(this, m_model, ++m_arrangeGeneration),
+        "ButtonListArrange");
+    return true;
+}
+
+/// \brief Wait for any Rearrange() in progress and discard the result.
+void MythUIButtonList::StopRearrange(void)
+{
+    QMutexLocker locker(&m_arrangeLock);
+    ++m_arrangeGeneration;
+    while (m_arrangeJobs > 0)
+        m_arrangeDone.wait(&m_arrangeLock);
+    locker.unlock();
+
+    QCoreApplication::
+        removePostedEvents(this, ButtonListArrangeEvent::kEventType);
+}
+
+void MythUIButtonList::RearrangeDone(uint generation, bool arranged,
+                                     std::vector<int> &rows)
+{
+    QMutexLocker locker(&m_arrangeLock);
+    if (arranged && generation == m_arrangeGeneration)
+    {
+        QCoreApplication::postEvent(
+            this, new ButtonListArrangeEvent(generation, std::move(rows)));
+    }
+    --m_arrangeJobs;
+    m_arrangeDone.wakeAll();
+}
+
+/**
+ * \brief Return the item bound to a row of the model.
+ *
+ * Items are recycled once there are a few times more than fit on screen,
+ * taking the one furthest from the selection that is not being shown.
+ */
+MythUIButtonListItem *MythUIButtonList::GetModelItem(int row) const
+{
+    auto found = m_modelItems.constFind(row);
+    if (found != m_modelItems.constEnd())
+        return found.value();
+
+    MythUIButtonListItem *item = nullptr;
+    if (m_modelItems.size() >= std::max(kMinModelItems, m_itemsVisible * 4))
+    {
+        auto furthest = m_modelItems.end();
+        int distance = -1;
+        for (auto it = m_modelItems.begin(); it != m_modelItems.end(); ++it)
+        {
+            if (it.value()->isVisible())
+                continue;
+            int dist = std::abs(it.key() - m_selPosition);
+            if (m_wrapStyle > WrapNone)
+                dist = std::min(dist, m_itemCount - dist);
+            if (dist > distance)
+            {
+                distance = dist;
+                furthest = it;
+            }
+        }
+
+        if (furthest != m_modelItems.end())
+        {
+            item = furthest.value();
+            m_modelItems.erase(furthest);
+            item->Clear();
+        }
+    }
+
+    if (!item)
+        item = new MythUIButtonListItem(const_cast<MythUIButtonList *>(this));
+
+    item->m_modelRow = row;
+    m_model->Bind(row, item);
+    m_modelItems.insert(row, item);
+    return item;
+}
+
+void MythUIButtonList::ClearModelItems(void)
+{
+    if (m_modelItems.isEmpty())
+        return;
+
+    m_buttonToItem.clear();
+    m_clearing = true;
+    qDeleteAll(m_modelItems);
+    m_modelItems.clear();
+    m_clearing = false;
+}
+
 QPoint MythUIButtonList::GetButtonPosition(int column, int row) const
 {
     int x = m_contentsRect.x() +
@@ -3339,6 +3565,11 @@ MythUIButtonListItem::MythUIButtonListItem(MythUIButtonList *lbtype,
         m_parent->InsertItem(this, listPosition);
 }
 
+MythUIButtonListItem::MythUIButtonListItem(MythUIButtonList *lbtype)
+  : m_parent(lbtype)
+{
+}
+
 MythUIButtonListItem::~MythUIButtonListItem()
 {
     if (m_parent)
@@ -3356,6 +3587,40 @@ MythUIButtonListItem::~MythUIButtonListItem()
     m_images.clear();
 }
 
+/// \brief Forget everything bound to the item, so it can be reused for
+///        another row of a model.
+void MythUIButtonListItem::Clear(void)
+{
+    m_text.clear();
+    m_fontState.clear();
+    if (m_image)
+        m_image->DecrRef();
+    m_image = nullptr;
+    m_imageFilename.clear();
+    m_checkable = false;
+    m_state     = CantCheck;
+    m_data      = 0;
+    m_showArrow = false;
+    m_isVisible = false;
+    m_enabled   = true;
+    m_progress1 = ProgressInfo();
+    m_progress2 = ProgressInfo();
+
+    m_strings.clear();
+    for (auto * image : std::as_const(m_images))
+    {
+        if (image)
+            image->DecrRef();
+    }
+    m_images.clear();
+    m_imageFilenames.clear();
+    m_states.clear();
+    m_textCb  = muibCbInfo();
+    m_imageCb = muibCbInfo();
+    m_stateCb = muibCbInfo();
+    m_modelRow = -1;
+}
+
 void MythUIButtonListItem::SetText(const QString &text, const QString &name,
                                    const QString &state)
 {
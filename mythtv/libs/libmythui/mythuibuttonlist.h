@@ -2,18 +2,22 @@
 #define MYTHUIBUTTONLIST_H_
 
 #include <utility>
+#include <vector>
 
 // Qt headers
 #include <QHash>
 #include <QList>
+#include <QMutex>
 #include <QString>
 #include <QVariant>
+#include <QWaitCondition>
 #include <optional>
 
 // MythTV headers
 #include "mythuitype.h"
 #include "mythscreentype.h"
 #include "mythimage.h"
+#include "mythuibuttonlistmodel.h"
 
 class MythUIButtonList;
 class MythUIScrollBar;
@@ -143,6 +147,11 @@ class MUI_PUBLIC MythUIButtonListItem
     virtual void SetToRealButton(MythUIStateType *button, bool selected);
 
   private:
+    // Used by MythUIButtonList for the rows of a model, which are owned
+    // by the list rather than added to it.
+    explicit MythUIButtonListItem(MythUIButtonList *lbtype);
+    void Clear(void);
+
     void DoButtonText(MythUIText *buttontext);
     void DoButtonImage(MythUIImage *buttonimage);
     void DoButtonArrow(MythUIImage *buttonarrow) const;
@@ -177,6 +186,7 @@ class MUI_PUBLIC MythUIButtonListItem
     muibCbInfo m_textCb;
     muibCbInfo m_imageCb;
     muibCbInfo m_stateCb;
+    int        m_modelRow       {-1};
 
     friend class MythUIButtonList;
     friend class MythGenericTree;
@@ -268,6 +278,12 @@ class MUI_PUBLIC MythUIButtonList : public MythUIType
     void LoadInBackground(int start = 0, int pageSize = 20);
     int  StopLoad(void);
 
+    void SetModel(MythUIButtonListModel *model);
+    MythUIButtonListModel *GetModel(void) const { return m_model; }
+    void ModelChanged(void);
+    bool Rearrange(void);
+    void StopRearrange(void);
+
   public slots:
     void Select();
     void Deselect();
@@ -346,6 +362,10 @@ class MUI_PUBLIC MythUIButtonList : public MythUIType
 
     void SanitizePosition(void);
 
+    MythUIButtonListItem *GetModelItem(int row) const;
+    void ClearModelItems(void);
+    void RearrangeDone(uint generation, bool arranged, std::vector<int> &rows);
+
     /**/
 
     LayoutType  m_layout              {LayoutVertical};
@@ -402,6 +422,14 @@ class MUI_PUBLIC MythUIButtonList : public MythUIType
     QList<MythUIButtonListItem*> m_itemList;
     int m_nextItemLoaded              {0};
 
+    static constexpr int kMinModelItems {64};
+    MythUIButtonListModel *m_model    {nullptr};
+    mutable QHash<int, MythUIButtonListItem*> m_modelItems;
+    QMutex          m_arrangeLock;
+    QWaitCondition  m_arrangeDone;
+    int             m_arrangeJobs       {0};
+    uint            m_arrangeGeneration {0};
+
     bool m_defaultDrawFromBottom      {false};
     std::optional<bool> m_shadowDrawFromBottom {std::nullopt};
 
@@ -410,6 +438,7 @@ class MUI_PUBLIC MythUIButtonList : public MythUIType
 
     friend class MythUIButtonListItem;
     friend class MythUIButtonTree;
+    friend class ButtonListArrangeJob;
 };
 
 class MUI_PUBLIC SearchButtonListDialog : public MythScreenType
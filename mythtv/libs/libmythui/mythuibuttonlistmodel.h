@@ -0,0 +1,189 @@
+#ifndef MYTHUIBUTTONLISTMODEL_H_
+#define MYTHUIBUTTONLISTMODEL_H_
+
+// C++ headers
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+// Qt headers
+#include <QString>
+#include <QVariant>
+
+// MythTV headers
+#include "mythuiexp.h"
+
+class MythUIButtonListItem;
+
+/**
+ * \class MythUIButtonListModel
+ *
+ * \brief Supplies the rows of a MythUIButtonList, for lists too long to
+ *        create a MythUIButtonListItem for every entry.
+ *
+ * Once set with MythUIButtonList::SetModel() the list only keeps items for
+ * the rows around the ones on screen. An item is bound to a row with Bind()
+ * when the row is first needed, and is recycled for another row when it has
+ * scrolled well out of view. Any item pointer the list hands out, e.g. with
+ * itemSelected(), is therefore only valid until the list next changes; use
+ * GetCurrentPos() or data set in Bind() to identify the row.
+ *
+ * GetData() and GetText() return what Bind() would set as the item's data
+ * and text, so that MythUIButtonList::SetValueByData(), GetItemByData() and
+ * MoveToNamedPosition() can find a row without binding an item to each row
+ * they pass. A model that does not provide them cannot be searched that way.
+ *
+ * Arrange() builds a new order for the rows, such as after a change of
+ * filter or sort order. MythUIButtonList::Rearrange() runs it on a pool
+ * thread, so it must only read data that the UI thread leaves alone until
+ * the result is passed to SetArrangement() on the UI thread.
+ */
+class MUI_PUBLIC MythUIButtonListModel
+{
+  public:
+    virtual ~MythUIButtonListModel() = default;
+
+    virtual int  Count(void) const = 0;
+    virtual void Bind(int row, MythUIButtonListItem *item) const = 0;
+
+    virtual QVariant GetData(int /*row*/) const { return {}; }
+    virtual QString  GetText(int /*row*/) const { return {}; }
+
+    /// The first row whose GetData() equals \p data, or -1.
+    int FindData(const QVariant &data) const
+    {
+        for (int row = 0; row < Count(); ++row)
+            if (GetData(row) == data)
+                return row;
+        return -1;
+    }
+
+    /// The first row whose GetText() equals \p text, or -1.
+    int FindText(const QString &text) const
+    {
+        for (int row = 0; row < Count(); ++row)
+            if (GetText(row) == text)
+                return row;
+        return -1;
+    }
+
+    virtual bool Arrange(std::vector<int> &/*rows*/) const { return false; }
+    virtual void SetArrangement(std::vector<int> /*rows*/) { }
+};
+
+/**
+ * \class MythUIButtonListRecordModel
+ *
+ * \brief A MythUIButtonListModel holding its rows as an array of plain
+ *        records.
+ *
+ * The records are kept in one contiguous array and only an index is kept
+ * per visible row, so filtering and sorting do not copy the records. Call
+ * MythUIButtonList::Rearrange() after SetFilter() or SetCompare() to apply
+ * them in the background, and MythUIButtonList::StopRearrange() before
+ * changing the records or the functions while a rearrange may be running.
+ */
+template <typename Record>
+class MythUIButtonListRecordModel : public MythUIButtonListModel
+{
+  public:
+    using Binder  = std::function<void(const Record &, MythUIButtonListItem *)>;
+    using Filter  = std::function<bool(const Record &)>;
+    using Compare = std::function<bool(const Record &, const Record &)>;
+    using DataKey = std::function<QVariant(const Record &)>;
+    using TextKey = std::function<QString(const Record &)>;
+
+    explicit MythUIButtonListRecordModel(Binder bind)
+      : m_bind(std::move(bind)) {}
+
+    /// Replace the records, shown in the order given until rearranged.
+    /// Call MythUIButtonList::ModelChanged() afterwards.
+    void SetRecords(std::vector<Record> records)
+    {
+        m_records = std::move(records);
+        m_rows.resize(m_records.size());
+        std::iota(m_rows.begin(), m_rows.end(), 0);
+    }
+
+    void SetFilter(Filter filter)    { m_filter  = std::move(filter);  }
+    void SetCompare(Compare compare) { m_compare = std::move(compare); }
+
+    /// Set how to get the data and text the binder gives a record's item.
+    void SetDataKey(DataKey key)     { m_dataKey = std::move(key); }
+    void SetTextKey(TextKey key)     { m_textKey = std::move(key); }
+
+    const std::vector<Record> &GetRecords(void) const { return m_records; }
+
+    const Record *RecordAt(int row) const
+    {
+        if (row < 0 || row >= Count())
+            return nullptr;
+        return &m_records[static_cast<size_t>(m_rows[static_cast<size_t>(row)])];
+    }
+
+    int Count(void) const override { return static_cast<int>(m_rows.size()); }
+
+    void Bind(int row, MythUIButtonListItem *item) const override
+    {
+        const Record *record = RecordAt(row);
+        if (record && m_bind)
+            m_bind(*record, item);
+    }
+
+    QVariant GetData(int row) const override
+    {
+        const Record *record = RecordAt(row);
+        if (record && m_dataKey)
+            return m_dataKey(*record);
+        return {};
+    }
+
+    QString GetText(int row) const override
+    {
+        const Record *record = RecordAt(row);
+        if (record && m_textKey)
+            return m_textKey(*record);
+        return {};
+    }
+
+    /// Select and order the records. Reads only the records and the filter
+    /// and compare functions, not the current order.
+    bool Arrange(std::vector<int> &rows) const override
+    {
+        rows.clear();
+        rows.reserve(m_records.size());
+        for (size_t i = 0; i < m_records.size(); ++i)
+            if (!m_filter || m_filter(m_records[i]))
+                rows.push_back(static_cast<int>(i));
+
+        if (m_compare)
+        {
+            std::stable_sort(rows.begin(), rows.end(), [this](int a, int b)
+                { return m_compare(m_records[static_cast<size_t>(a)],
+                                   m_records[static_cast<size_t>(b)]); });
+        }
+        return true;
+    }
+
+    void SetArrangement(std::vector<int> rows) override
+    {
+        // Ignore an order built for records that have since been replaced
+        auto size = static_cast<int>(m_records.size());
+        if (std::ranges::any_of(rows, [size](int row) { return row >= size; }))
+            return;
+        m_rows = std::move(rows);
+    }
+
+  private:
+    std::vector<Record> m_records;
+    std::vector<int>    m_rows;
+    Binder              m_bind;
+    Filter              m_filter;
+    Compare             m_compare;
+    DataKey             m_dataKey;
+    TextKey             m_textKey;
+};
+
+#endif
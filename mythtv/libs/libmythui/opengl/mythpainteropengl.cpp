@@ -55,6 +55,7 @@ void MythOpenGLPainter::FreeResources(void)
     for (auto * proc : std::as_const(m_procedurals))
         delete proc;
     m_procedurals.clear();
+    ReleaseGlyphTexture();
     MythPainterGPU::FreeResources();
 }
 
@@ -159,6 +160,8 @@ void MythOpenGLPainter::End(void)
     if (VERBOSE_LEVEL_CHECK(VB_GPU, LOG_INFO))
         m_render->logDebugMarker("PAINTER_FRAME_END");
 
+    FrameDrawn();
+
     if (m_viewControl.testFlag(Framebuffer))
     {
         m_render->Flush();
@@ -211,29 +214,17 @@ MythGLTexture* MythOpenGLPainter::GetTextureFromCache(MythImage *Image)
             .arg(m_maxHardwareCacheSize / 1024));
 
         locker.relock();
-        while (m_hardwareCacheSize > m_maxHardwareCacheSize)
-        {
-            MythImage *expiredIm = m_imageExpireList.front();
-            m_imageExpireList.pop_front();
-            DeleteFormatImagePriv(expiredIm);
-            DeleteTextures();
-        }
+        ExpireTextures();
         locker.unlock();
     }
 
     CheckFormatImage(Image);
     m_hardwareCacheSize += MythRenderOpenGL::GetTextureDataSize(texture);
+    AddTextureUpload(MythRenderOpenGL::GetTextureDataSize(texture));
     locker.relock();
     m_imageToTextureMap[Image] = texture;
     m_imageExpireList.push_back(Image);
-
-    while (m_hardwareCacheSize > m_maxHardwareCacheSize)
-    {
-        MythImage *expiredIm = m_imageExpireList.front();
-        m_imageExpireList.pop_front();
-        DeleteFormatImagePriv(expiredIm);
-        DeleteTextures();
-    }
+    ExpireTextures();
 
     return texture;
 }
@@ -297,6 +288,139 @@ QOpenGLShaderProgram* MythOpenGLPainter::GetProceduralShader(const ProcSource& V
     return result;
 }
 
+/*! \brief Draw a single line of text from the glyph atlas.
+ *
+ * Falls back to rendering the whole string to an image (see
+ * MythPainter::DrawText) for anything the atlas cannot reproduce, such as
+ * outlines or wrapped text.
+ *
+ * \note As for DrawRect, high DPI scaling always uses the fallback.
+*/
+void MythOpenGLPainter::DrawText(const QRect Area, const QString &Message, int Flags,
+                                 const MythFontProperties &Font, int Alpha,
+                                 const QRect BoundRect)
+{
+    if (m_render && !m_usingHighDPI &&
+        m_glyphAtlas.Layout(Message, Flags, Area, Font, Area & BoundRect, m_glyphRuns))
+    {
+        DrawGlyphRuns(Alpha);
+        return;
+    }
+    MythPainterGPU::DrawText(Area, Message, Flags, Font, Alpha, BoundRect);
+}
+
+/*! \brief Draw MythUIText layouts from the glyph atlas.
+ *
+ * Each glyph is rendered once and each pass (shadow, fill and outline) is
+ * drawn with a single call, rather than uploading a new texture whenever the
+ * text changes or scrolls.
+*/
+void MythOpenGLPainter::DrawTextLayout(const QRect Canvas, const LayoutVector &Layouts,
+                                       const FormatVector &Formats,
+                                       const MythFontProperties &Font, int Alpha,
+                                       const QRect Dest)
+{
+    if (m_render && !m_usingHighDPI && !Canvas.isNull())
+    {
+        QRect clip(Dest.topLeft(), Dest.size().boundedTo(Canvas.size()));
+        if (m_glyphAtlas.Layout(Layouts, Font, Dest.topLeft() + Canvas.topLeft(),
+                                clip, m_glyphRuns))
+        {
+            DrawGlyphRuns(Alpha);
+            return;
+        }
+    }
+    MythPainterGPU::DrawTextLayout(Canvas, Layouts, Formats, Font, Alpha, Dest);
+}
+
+void MythOpenGLPainter::DrawGlyphRuns(int Alpha)
+{
+    if (!UpdateGlyphTexture())
+        return;
+
+    for (const auto & run : m_glyphRuns)
+    {
+        if (!run.m_destinations.empty())
+        {
+            m_render->DrawGlyphs(m_glyphTexture, nullptr, run.m_sources,
+                                 run.m_destinations, run.m_color, Alpha);
+        }
+    }
+}
+
+/*! \brief Delete the oldest image textures until the cache is back under
+ * its maximum size.
+ *
+ * The glyph atlas texture is counted in the cache size too, and is dropped
+ * last, if the images alone can't bring the cache down far enough.
+ */
+void MythOpenGLPainter::ExpireTextures(void)
+{
+    while (m_hardwareCacheSize > m_maxHardwareCacheSize)
+    {
+        if (m_imageExpireList.empty())
+        {
+            ReleaseGlyphTexture();
+            break;
+        }
+        MythImage *expiredIm = m_imageExpireList.front();
+        m_imageExpireList.pop_front();
+        DeleteFormatImagePriv(expiredIm);
+        DeleteTextures();
+    }
+}
+
+/// \brief Delete the glyph atlas texture and the glyphs in the atlas, they
+/// are rasterised and uploaded again by the next text draw.
+void MythOpenGLPainter::ReleaseGlyphTexture(void)
+{
+    m_glyphAtlas.Clear();
+    if (!m_glyphTexture || !m_render)
+        return;
+
+    OpenGLLocker locker(m_render);
+    m_hardwareCacheSize -= MythRenderOpenGL::GetTextureDataSize(m_glyphTexture);
+    m_render->DeleteTexture(m_glyphTexture);
+    m_glyphTexture = nullptr;
+    LOG(VB_GPU, LOG_INFO, "Released glyph atlas texture");
+}
+
+/// \brief Upload any glyphs added to the atlas since the last draw.
+bool MythOpenGLPainter::UpdateGlyphTexture(void)
+{
+    if (!m_glyphTexture)
+    {
+        QImage atlas = m_glyphAtlas.GetImage();
+        m_glyphTexture = m_render->CreateTextureFromQImage(&atlas);
+        if (!m_glyphTexture)
+        {
+            LOG(VB_GENERAL, LOG_ERR, "Failed to create glyph atlas texture");
+            return false;
+        }
+        m_glyphAtlas.TakeDirtyRect();
+        int size = MythRenderOpenGL::GetTextureDataSize(m_glyphTexture);
+        m_hardwareCacheSize += size;
+        AddTextureUpload(size);
+        LOG(VB_GPU, LOG_INFO, QString("Created %1x%1 glyph atlas texture")
+            .arg(MythGlyphAtlas::kAtlasSize));
+        return true;
+    }
+
+    QRect dirty = m_glyphAtlas.TakeDirtyRect();
+    if (dirty.isEmpty())
+        return true;
+
+    QImage update = m_glyphAtlas.GetImage().copy(dirty)
+                        .convertToFormat(QImage::Format_RGBA8888);
+    OpenGLLocker locker(m_render);
+    m_glyphTexture->m_texture->setData(dirty.left(), dirty.top(), 0,
+                                       dirty.width(), dirty.height(), 1,
+                                       QOpenGLTexture::RGBA, QOpenGLTexture::UInt8,
+                                       update.constBits());
+    AddTextureUpload(update.sizeInBytes());
+    return true;
+}
+
 /*! \brief Draw a rectangle
  *
  * If it is a simple rectangle, then use our own shaders for rendering (which
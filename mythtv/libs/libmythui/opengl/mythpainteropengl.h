@@ -11,6 +11,7 @@
 #include <QQueue>
 
 // MythTV
+#include "libmythui/mythglyphatlas.h"
 #include "libmythui/mythimage.h"
 #include "libmythui/mythpaintergpu.h"
 
@@ -42,6 +43,11 @@ class MUI_PUBLIC MythOpenGLPainter : public MythPainterGPU
     void End() override;
     void DrawImage(QRect Dest, MythImage *Image, QRect Source, int Alpha) override;
     void DrawProcedural(QRect Dest, int Alpha, const ProcSource& VertexSource, const ProcSource& FragmentSource, const QString& SourceHash) override;
+    void DrawText(QRect Area, const QString &Message, int Flags,
+                  const MythFontProperties &Font, int Alpha, QRect BoundRect) override;
+    void DrawTextLayout(QRect Canvas, const LayoutVector &Layouts,
+                        const FormatVector &Formats, const MythFontProperties &Font,
+                        int Alpha, QRect Dest) override;
 
     void DrawRect(QRect Area, const QBrush &FillBrush,
                   const QPen &LinePen, int Alpha) override;
@@ -54,6 +60,10 @@ class MUI_PUBLIC MythOpenGLPainter : public MythPainterGPU
     void  ClearCache(void);
     MythGLTexture* GetTextureFromCache(MythImage *Image);
     QOpenGLShaderProgram* GetProceduralShader(const ProcSource& VertexSource, const ProcSource& FragmentSource, const QString& SourceHash);
+    void  ExpireTextures(void);
+    bool  UpdateGlyphTexture(void);
+    void  ReleaseGlyphTexture(void);
+    void  DrawGlyphRuns(int Alpha);
 
     MythImage* GetFormatImagePriv(void) override { return new MythImage(this); }
     void  DeleteFormatImagePriv(MythImage *Image) override;
@@ -72,6 +82,10 @@ class MUI_PUBLIC MythOpenGLPainter : public MythPainterGPU
     bool                       m_mappedBufferPoolReady { false };
 
     QHash<QString,QOpenGLShaderProgram*> m_procedurals;
+
+    MythGlyphAtlas             m_glyphAtlas;
+    MythGlyphAtlas::Runs       m_glyphRuns;
+    MythGLTexture*             m_glyphTexture { nullptr };
 };
 
 #endif
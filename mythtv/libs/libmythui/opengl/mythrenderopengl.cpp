@@ -950,6 +950,89 @@ void MythRenderOpenGL::DrawBitmap(std::vector<MythGLTexture *> &Textures,
 static const float kLimitedRangeOffset = (16.0F / 255.0F);
 static const float kLimitedRangeScale  = (219.0F / 255.0F);
 
+/*! \brief Draw many areas of one texture, tinted with Color, in a single call.
+ *
+ * Used for text rendered from a glyph atlas, where the texture holds white
+ * glyphs and the coverage is in the alpha channel. Each quad is drawn as two
+ * triangles and the vertices are streamed through a single VBO.
+*/
+void MythRenderOpenGL::DrawGlyphs(MythGLTexture *Texture, QOpenGLFramebufferObject *Target,
+                                  const std::vector<QRect> &Sources,
+                                  const std::vector<QRect> &Destinations,
+                                  const QColor &Color, int Alpha)
+{
+    size_t count = std::min(Sources.size(), Destinations.size());
+    if (!count || !Texture || !Texture->m_texture || Texture->m_size.isEmpty())
+        return;
+
+    makeCurrent();
+
+    if (!m_glyphVBO)
+        m_glyphVBO = CreateVBO(static_cast<int>(kVertexSize));
+    if (!m_glyphVBO)
+    {
+        doneCurrent();
+        return;
+    }
+
+    // All of the positions followed by all of the texture coordinates, as
+    // for DrawBitmap.
+    static constexpr size_t kVerticesPerQuad { 6 };
+    size_t vertices = count * kVerticesPerQuad;
+    size_t texoffset = vertices * static_cast<size_t>(VERTEX_SIZE);
+    m_glyphVertices.resize(vertices * static_cast<size_t>(VERTEX_SIZE + TEXTURE_SIZE));
+    GLfloat* position = m_glyphVertices.data();
+    GLfloat* texcoord = position + texoffset;
+    auto width  = static_cast<GLfloat>(Texture->m_size.width());
+    auto height = static_cast<GLfloat>(Texture->m_size.height());
+
+    auto AddQuad = [](GLfloat*& Data, GLfloat Left, GLfloat Top, GLfloat Right, GLfloat Bottom)
+    {
+        const std::array<GLfloat,12> quad { Left,  Top,    Right, Top,    Left,  Bottom,
+                                            Right, Top,    Right, Bottom, Left,  Bottom };
+        Data = std::ranges::copy(quad, Data).out;
+    };
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const QRect& dest = Destinations[i];
+        const QRect& src  = Sources[i];
+        AddQuad(position, dest.left(), dest.top(),
+                dest.left() + dest.width(), dest.top() + dest.height());
+        AddQuad(texcoord, src.left() / width, src.top() / height,
+                (src.left() + src.width()) / width, (src.top() + src.height()) / height);
+    }
+
+    QOpenGLShaderProgram* program = m_defaultPrograms[kShaderDefault];
+    BindFramebuffer(Target);
+    SetShaderProjection(program);
+    program->setUniformValue("s_texture0", 0);
+    ActiveTexture(GL_TEXTURE0);
+    Texture->m_texture->bind();
+
+    // Reallocate rather than overwrite, so the driver can hand out fresh
+    // storage while the previous batch is still being drawn from.
+    auto bytes = static_cast<int>(m_glyphVertices.size() * sizeof(GLfloat));
+    m_glyphVBO->bind();
+    m_glyphVBO->allocate(m_glyphVertices.data(), bytes);
+
+    // As for DrawBitmap, the default shader maps the colour to limited range
+    glVertexAttrib4f(COLOR_INDEX, static_cast<float>(Color.redF()),
+                     static_cast<float>(Color.greenF()), static_cast<float>(Color.blueF()),
+                     static_cast<float>(Color.alphaF()) * (Alpha / 255.0F));
+
+    glEnableVertexAttribArray(VERTEX_INDEX);
+    glEnableVertexAttribArray(TEXTURE_INDEX);
+    glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat), kVertexOffset);
+    glVertexAttribPointerI(TEXTURE_INDEX, TEXTURE_SIZE, GL_FLOAT, GL_FALSE, TEXTURE_SIZE * sizeof(GLfloat),
+                           static_cast<GLuint>(texoffset * sizeof(GLfloat)));
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices));
+    glDisableVertexAttribArray(TEXTURE_INDEX);
+    glDisableVertexAttribArray(VERTEX_INDEX);
+    QOpenGLBuffer::release(QOpenGLBuffer::VertexBuffer);
+    doneCurrent();
+}
+
 /// \brief An optimised method to clear a QRect to the given color
 void MythRenderOpenGL::ClearRect(QOpenGLFramebufferObject *Target, const QRect Area, int Color, int Alpha)
 {
@@ -1117,6 +1200,8 @@ void MythRenderOpenGL::ReleaseResources(void)
     DeleteDefaultShaders();
     ExpireVertices();
     ExpireVBOS();
+    delete m_glyphVBO;
+    m_glyphVBO = nullptr;
     if (m_vao)
     {
         extraFunctions()->glDeleteVertexArrays(1, &m_vao);
@@ -156,6 +156,10 @@ class MUI_PUBLIC MythRenderOpenGL : public QOpenGLContext, public QOpenGLFunctio
                      QOpenGLFramebufferObject *Target,
                      QRect Source, QRect Destination,
                      QOpenGLShaderProgram *Program, int Rotation);
+    void  DrawGlyphs(MythGLTexture *Texture, QOpenGLFramebufferObject *Target,
+                     const std::vector<QRect> &Sources,
+                     const std::vector<QRect> &Destinations,
+                     const QColor &Color, int Alpha);
     void  DrawRect(QOpenGLFramebufferObject *Target,
                    QRect Area, const QBrush &FillBrush,
                    const QPen &LinePen, int Alpha);
@@ -215,6 +219,8 @@ class MUI_PUBLIC MythRenderOpenGL : public QOpenGLContext, public QOpenGLFunctio
     QList<uint64_t>              m_vertexExpiry;
     QMap<uint64_t,QOpenGLBuffer*>m_cachedVBOS;
     QList<uint64_t>              m_vboExpiry;
+    QOpenGLBuffer*               m_glyphVBO { nullptr };
+    std::vector<GLfloat>         m_glyphVertices;
 
     // Locking
     QRecursiveMutex  m_lock;
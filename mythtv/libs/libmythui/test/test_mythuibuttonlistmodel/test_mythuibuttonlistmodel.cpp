@@ -0,0 +1,173 @@
+/*
+ *  Class TestMythUIButtonListModel
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#include "test_mythuibuttonlistmodel.h"
+
+#include <QString>
+
+struct Track
+{
+    QString m_title;
+    int     m_year {0};
+};
+
+using TrackModel = MythUIButtonListRecordModel<Track>;
+
+static std::vector<Track> MakeTracks(int count)
+{
+    std::vector<Track> tracks;
+    tracks.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        // Titles in a scrambled order, years cycling through 50 values
+        tracks.push_back({ QString("Track %1").arg((i * 7919) % count, 6, 10, QChar('0')),
+                           1970 + (i % 50) });
+    }
+    return tracks;
+}
+
+void TestMythUIButtonListModel::test_records(void)
+{
+    TrackModel model(nullptr);
+    QCOMPARE(model.Count(), 0);
+    QVERIFY(model.RecordAt(0) == nullptr);
+
+    model.SetRecords({{"one", 2001}, {"two", 2002}, {"three", 2003}});
+    QCOMPARE(model.Count(), 3);
+    QCOMPARE(model.RecordAt(0)->m_title, QString("one"));
+    QCOMPARE(model.RecordAt(2)->m_title, QString("three"));
+    QVERIFY(model.RecordAt(-1) == nullptr);
+    QVERIFY(model.RecordAt(3) == nullptr);
+}
+
+void TestMythUIButtonListModel::test_bind(void)
+{
+    QStringList bound;
+    TrackModel model([&bound](const Track &track, MythUIButtonListItem */*item*/)
+                     { bound.append(track.m_title); });
+    model.SetRecords({{"one", 2001}, {"two", 2002}});
+
+    model.Bind(1, nullptr);
+    model.Bind(5, nullptr);
+    model.Bind(0, nullptr);
+    QCOMPARE(bound, QStringList({"two", "one"}));
+}
+
+void TestMythUIButtonListModel::test_lookup(void)
+{
+    int bound = 0;
+    TrackModel model([&bound](const Track &/*track*/, MythUIButtonListItem */*item*/)
+                     { ++bound; });
+    model.SetRecords({{"one", 2001}, {"two", 2002}, {"three", 2003}});
+
+    // Without keys nothing can be found
+    QCOMPARE(model.FindData(2002), -1);
+    QCOMPARE(model.FindText("two"), -1);
+
+    model.SetDataKey([](const Track &track) { return QVariant(track.m_year); });
+    model.SetTextKey([](const Track &track) { return track.m_title; });
+    QCOMPARE(model.GetData(2), QVariant(2003));
+    QCOMPARE(model.GetText(0), QString("one"));
+    QVERIFY(!model.GetData(3).isValid());
+    QCOMPARE(model.FindData(2002), 1);
+    QCOMPARE(model.FindText("three"), 2);
+    QCOMPARE(model.FindText("four"), -1);
+
+    // Lookups follow the arranged order
+    model.SetCompare([](const Track &a, const Track &b) { return a.m_title < b.m_title; });
+    std::vector<int> rows;
+    QVERIFY(model.Arrange(rows));
+    model.SetArrangement(rows);
+    QCOMPARE(model.FindText("three"), 1);
+    QCOMPARE(model.FindData(2002), 2);
+
+    // and never bind a row
+    QCOMPARE(bound, 0);
+}
+
+void TestMythUIButtonListModel::test_arrange(void)
+{
+    TrackModel model(nullptr);
+    model.SetRecords({{"d", 1990}, {"b", 2010}, {"a", 2000}, {"c", 2020}, {"b", 1980}});
+
+    // No filter or compare keeps the records as given
+    std::vector<int> rows;
+    QVERIFY(model.Arrange(rows));
+    QCOMPARE(rows, std::vector<int>({0, 1, 2, 3, 4}));
+
+    // Sorting is stable, the two "b" records stay in their original order
+    model.SetCompare([](const Track &a, const Track &b) { return a.m_title < b.m_title; });
+    QVERIFY(model.Arrange(rows));
+    model.SetArrangement(rows);
+    QCOMPARE(model.Count(), 5);
+    QCOMPARE(model.RecordAt(0)->m_title, QString("a"));
+    QCOMPARE(model.RecordAt(1)->m_year, 2010);
+    QCOMPARE(model.RecordAt(2)->m_year, 1980);
+    QCOMPARE(model.RecordAt(4)->m_title, QString("d"));
+
+    model.SetFilter([](const Track &track) { return track.m_year >= 2000; });
+    QVERIFY(model.Arrange(rows));
+    model.SetArrangement(rows);
+    QCOMPARE(model.Count(), 3);
+    QCOMPARE(model.RecordAt(0)->m_title, QString("a"));
+    QCOMPARE(model.RecordAt(1)->m_title, QString("b"));
+    QCOMPARE(model.RecordAt(2)->m_title, QString("c"));
+
+    // The records themselves are untouched
+    QCOMPARE(model.GetRecords().size(), static_cast<size_t>(5));
+    QCOMPARE(model.GetRecords()[0].m_title, QString("d"));
+}
+
+void TestMythUIButtonListModel::test_stale_arrangement(void)
+{
+    TrackModel model(nullptr);
+    model.SetRecords(MakeTracks(10));
+
+    std::vector<int> rows;
+    model.SetFilter([](const Track &track) { return track.m_year < 1975; });
+    QVERIFY(model.Arrange(rows));
+    QCOMPARE(rows.size(), static_cast<size_t>(5));
+
+    // An order built before the records were replaced by fewer is dropped
+    model.SetRecords(MakeTracks(3));
+    rows = {9, 8, 7};
+    model.SetArrangement(rows);
+    QCOMPARE(model.Count(), 3);
+    QCOMPARE(model.RecordAt(0)->m_year, 1970);
+}
+
+void TestMythUIButtonListModel::test_arrange_speed(void)
+{
+    TrackModel model(nullptr);
+    model.SetRecords(MakeTracks(100000));
+    model.SetFilter([](const Track &track) { return track.m_year % 2 == 0; });
+    model.SetCompare([](const Track &a, const Track &b) { return a.m_title < b.m_title; });
+
+    std::vector<int> rows;
+    QBENCHMARK
+    {
+        model.Arrange(rows);
+    }
+    model.SetArrangement(rows);
+    QCOMPARE(model.Count(), 50000);
+    for (int row = 1; row < model.Count(); ++row)
+        QVERIFY(model.RecordAt(row - 1)->m_title <= model.RecordAt(row)->m_title);
+}
+
+QTEST_APPLESS_MAIN(TestMythUIButtonListModel)
+
+#include "moc_test_mythuibuttonlistmodel.cpp"
@@ -0,0 +1,40 @@
+/*
+ *  Class TestMythUIButtonListModel
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#ifndef LIBMYTHUI_TEST_MYTHUIBUTTONLISTMODEL_H
+#define LIBMYTHUI_TEST_MYTHUIBUTTONLISTMODEL_H
+
+#include <QChar>     // Fix Qt6 GCC SFINAE warning
+#include <QBitArray> // Fix Qt6 GCC SFINAE warning
+#include <QTest>
+
+#include "libmythui/mythuibuttonlistmodel.h"
+
+class TestMythUIButtonListModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    static void test_records(void);
+    static void test_bind(void);
+    static void test_lookup(void);
+    static void test_arrange(void);
+    static void test_stale_arrangement(void);
+    static void test_arrange_speed(void);
+};
+
+#endif // LIBMYTHUI_TEST_MYTHUIBUTTONLISTMODEL_H
@@ -267,11 +267,13 @@ bool MythPainterVulkan::Ready()
  * QVulkanWindowRenderer is ready. startNextFrame is triggered by a call to
  * MythWindowVulkan::requestUpdate.
 */
-void MythPainterVulkan::Begin(QPaintDevice* /*Parent*/)
+void MythPainterVulkan::Begin(QPaintDevice* Parent)
 {
     if (!Ready())
         return;
 
+    MythPainterGPU::Begin(Parent);
+
     // check if we need to adjust cache sizes
     if (m_lastSize != m_vulkan->Window()->size())
     {
@@ -361,6 +363,7 @@ void MythPainterVulkan::End()
         m_vulkan->Render()->EndDebugRegion(currentcmdbuf);
 
     m_queuedTextures.clear();
+    FrameDrawn();
 
     if (m_viewControl.testFlag(Framebuffer))
         m_vulkan->Render()->EndFrame();
@@ -502,6 +505,7 @@ MythTextureVulkan* MythPainterVulkan::GetTextureFromCache(MythImage *Image)
 
     CheckFormatImage(Image);
     m_hardwareCacheSize += texture->m_dataSize;
+    AddTextureUpload(texture->m_dataSize);
     m_imageToTextureMap[Image] = texture;
     m_imageExpire.push_back(Image);
 
@@ -28,6 +28,9 @@
 static constexpr const char* DIDL_LITE_BEGIN { R"(<DIDL-Lite xmlns:dc="http://purl.org/dc/elements/1.1/" xmlns:upnp="urn:schemas-upnp-org:metadata-1-0/upnp/" xmlns="urn:schemas-upnp-org:metadata-1-0/DIDL-Lite/">)" };
 static constexpr const char* DIDL_LITE_END   { "</DIDL-Lite>" };
 
+// Upper bound on the memory used by materialized Browse results, in KiB.
+static constexpr int kBrowseCacheMaxKiB { 32 * 1024 };
+
 /////////////////////////////////////////////////////////////////////////////
 //
 /////////////////////////////////////////////////////////////////////////////
@@ -73,6 +76,21 @@ QString UPnpCDSExtensionResults::GetResultXML(FilterMap &filter,
 //
 /////////////////////////////////////////////////////////////////////////////
 
+int CDSBrowseCacheEntry::Cost() const
+{
+    qsizetype nChars = 0;
+
+    for (const auto & fragment : std::as_const(m_fragments))
+        nChars += fragment.size();
+
+    // QString stores UTF-16, two bytes per character
+    return static_cast<int>((nChars * 2) / 1024) + 1;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
 UPnpCDS::UPnpCDS( UPnpDevice *pDevice, const QString &sSharePath )
   : Eventing( "UPnpCDS", "CDS_Event", sSharePath ),
     m_sControlUrl("/CDS_Control"),
@@ -92,6 +110,8 @@ UPnpCDS::UPnpCDS( UPnpDevice *pDevice, const QString &sSharePath )
     AddVariable( new StateVariable< QString  >( "ServiceResetToken" , true ) );
 
     SetValue< uint16_t >( "SystemUpdateID", 0 );
+
+    m_browseCache.setMaxCost(kBrowseCacheMaxKiB);
     // ServiceResetToken must be unique (never repeat) and it must change when
     // the backend restarts (all internal state is reset)
     //
@@ -364,7 +384,6 @@ void UPnpCDS::DetermineClient( HTTPRequest *pRequest,
 
 void UPnpCDS::HandleBrowse( HTTPRequest *pRequest )
 {
-    UPnpCDSExtensionResults *pResult  = nullptr;
     UPnpCDSRequest           request;
 
     DetermineClient( pRequest, &request );
@@ -474,42 +493,67 @@ void UPnpCDS::HandleBrowse( HTTPRequest *pRequest )
     else
     {
         // ------------------------------------------------------------------
-        // Look for a CDS Extension that knows how to handle this ObjectID
+        // Serve the requested page from the materialized result for this
+        // object, loading it from the extensions on a miss.
         // ------------------------------------------------------------------
 
-        UPnpCDSExtensionList::iterator it = m_extensions.begin();
-        for (; (it != m_extensions.end()) && !pResult; ++it)
+        QString sCacheKey = QString("%1|%2|%3|%4")
+            .arg(request.m_sObjectId)
+            .arg(request.m_eBrowseFlag)
+            .arg(request.m_eClient)
+            .arg(request.m_sFilter);
+
+        QMutexLocker locker(&m_browseCacheLock);
+
+        CDSBrowseCacheEntry *pEntry = m_browseCache.object(sCacheKey);
+
+        if (pEntry == nullptr)
         {
-            LOG(VB_UPNP, LOG_INFO,
-                QString("UPNP Browse : Searching for : %1  / ObjectID : %2")
-                    .arg((*it)->m_sExtensionId, request.m_sObjectId));
+            locker.unlock();
+
+            pEntry = LoadBrowseEntry(request, filter, eErrorCode, sErrorDesc);
 
-            pResult = (*it)->Browse(&request);
+            locker.relock();
+
+            if (pEntry != nullptr)
+            {
+                // Copy before handing ownership to the cache, which may
+                // evict it immediately if it exceeds the cost limit.
+                auto *pCopy = new CDSBrowseCacheEntry(*pEntry);
+                if (!m_browseCache.insert(sCacheKey, pEntry, pEntry->Cost()))
+                    LOG(VB_UPNP, LOG_DEBUG,
+                        QString("UPnpCDS::HandleBrowse: Result for %1 too "
+                                "large to cache").arg(request.m_sObjectId));
+                pEntry = pCopy;
+            }
+        }
+        else
+        {
+            LOG(VB_UPNP, LOG_DEBUG,
+                QString("UPnpCDS::HandleBrowse: Cache hit for %1")
+                    .arg(request.m_sObjectId));
+
+            eErrorCode = UPnPResult_Success;
+            pEntry = new CDSBrowseCacheEntry(*pEntry);
         }
 
-        if (pResult != nullptr)
+        locker.unlock();
+
+        if (pEntry != nullptr)
         {
-            eErrorCode  = pResult->m_eErrorCode;
-            sErrorDesc  = pResult->m_sErrorDesc;
+            auto nSize  = static_cast<uint>(pEntry->m_fragments.size());
+            uint nStart = std::min(static_cast<uint>(request.m_nStartingIndex),
+                                   nSize);
+            uint nEnd   = std::min(nStart + request.m_nRequestedCount, nSize);
 
-            if (eErrorCode == UPnPResult_Success)
-            {
-                while (pResult->m_List.size() > request.m_nRequestedCount)
-                {
-                    pResult->m_List.takeLast()->DecrRef();
-                }
+            for (uint i = nStart; i < nEnd; i++)
+                sResultXML += pEntry->m_fragments[i];
 
-                nNumberReturned = pResult->m_List.count();
-                nTotalMatches   = pResult->m_nTotalMatches;
-                nUpdateID       = pResult->m_nUpdateID;
-                if (request.m_eBrowseFlag == CDS_BrowseMetadata)
-                    sResultXML      = pResult->GetResultXML(filter, true); // Ignore children
-                else
-                    sResultXML      = pResult->GetResultXML(filter);
-            }
+            nNumberReturned = nEnd - nStart;
+            nTotalMatches   = pEntry->m_nTotalMatches;
+            nUpdateID       = pEntry->m_nUpdateID;
 
-            delete pResult;
-            pResult = nullptr;
+            delete pEntry;
         }
     }
 
@@ -539,6 +583,84 @@ void UPnpCDS::HandleBrowse( HTTPRequest *pRequest )
 
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// Ask the extensions for every child of the requested object and serialize
+// each one once.  Returns nullptr if no extension could satisfy the request.
+/////////////////////////////////////////////////////////////////////////////
+
+CDSBrowseCacheEntry *UPnpCDS::LoadBrowseEntry( UPnpCDSRequest &request,
+                                               FilterMap &filter,
+                                               UPnPResultCode &eErrorCode,
+                                               QString &sErrorDesc )
+{
+    UPnpCDSExtensionResults *pResult  = nullptr;
+    UPnpCDSRequest           fullRequest = request;
+
+    fullRequest.m_nStartingIndex  = 0;
+    fullRequest.m_nRequestedCount = UINT16_MAX;
+
+    UPnpCDSExtensionList::iterator it = m_extensions.begin();
+    for (; (it != m_extensions.end()) && !pResult; ++it)
+    {
+        LOG(VB_UPNP, LOG_INFO,
+            QString("UPNP Browse : Searching for : %1  / ObjectID : %2")
+                .arg((*it)->m_sExtensionId, fullRequest.m_sObjectId));
+
+        pResult = (*it)->Browse(&fullRequest);
+    }
+
+    if (pResult == nullptr)
+        return nullptr;
+
+    eErrorCode  = pResult->m_eErrorCode;
+    sErrorDesc  = pResult->m_sErrorDesc;
+
+    CDSBrowseCacheEntry *pEntry = nullptr;
+
+    if (eErrorCode == UPnPResult_Success)
+    {
+        // Metadata requests only ever return the object itself
+        bool bIgnoreChildren = (request.m_eBrowseFlag == CDS_BrowseMetadata);
+        if (bIgnoreChildren)
+        {
+            while (pResult->m_List.size() > 1)
+                pResult->m_List.takeLast()->DecrRef();
+        }
+
+        pEntry = new CDSBrowseCacheEntry();
+        pEntry->m_nTotalMatches = pResult->m_nTotalMatches;
+        pEntry->m_nUpdateID     = pResult->m_nUpdateID;
+        pEntry->m_fragments.reserve(pResult->m_List.size());
+
+        for (auto *item : std::as_const(pResult->m_List))
+            pEntry->m_fragments.append(item->toXml(filter, bIgnoreChildren));
+    }
+
+    delete pResult;
+
+    return pEntry;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void UPnpCDS::IncrementSystemUpdateID( )
+{
+    QMutexLocker locker(&m_browseCacheLock);
+
+    m_browseCache.clear();
+
+    auto nId = GetValue<uint16_t>("SystemUpdateID");
+
+    // Wraps to zero as allowed by the ContentDirectory specification
+    SetValue<uint16_t>("SystemUpdateID", nId + 1);
+
+    LOG(VB_UPNP, LOG_DEBUG,
+        QString("UPnpCDS: SystemUpdateID now %1, browse cache flushed")
+            .arg(static_cast<uint16_t>(nId + 1)));
+}
+
 /////////////////////////////////////////////////////////////////////////////
 //
 /////////////////////////////////////////////////////////////////////////////
@@ -17,10 +17,13 @@
 #include <utility>
 
 // QT headers
+#include <QCache>
 #include <QList>
 #include <QMap>
+#include <QMutex>
 #include <QObject>
 #include <QString>
+#include <QStringList>
 
 #include "libmythbase/mythdbcon.h"
 
@@ -132,6 +135,30 @@ class UPNP_PUBLIC UPnpCDSExtensionResults
 
 //////////////////////////////////////////////////////////////////////////////
 
+/**
+ * \brief Materialized Browse result for a single object
+ *
+ * Holds the serialized DIDL-Lite fragment of every child (or of the object
+ * itself for BrowseMetadata) so that paged requests can be answered by
+ * slicing the list instead of re-querying the database.
+ */
+class UPNP_PUBLIC CDSBrowseCacheEntry
+{
+    public:
+
+        QStringList             m_fragments;
+        uint16_t                m_nTotalMatches {0};
+        uint16_t                m_nUpdateID     {0};
+
+    public:
+
+        CDSBrowseCacheEntry() = default;
+
+        int Cost() const;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
 /**
  * \brief Standard UPnP Shortcut feature
  */
@@ -292,6 +319,11 @@ class UPNP_PUBLIC UPnpCDS : public Eventing
         UPnPFeatureList        m_features;
         UPnPShortcutFeature   *m_pShortCuts {nullptr};
 
+        // Browse results keyed by object/flag/client/filter, cost in KiB.
+        // Flushed whenever SystemUpdateID changes.
+        QCache<QString, CDSBrowseCacheEntry> m_browseCache;
+        QMutex                 m_browseCacheLock;
+
     private:
 
         static UPnpCDSMethod       GetMethod              ( const QString &sURI  );
@@ -306,6 +338,11 @@ class UPNP_PUBLIC UPnpCDS : public Eventing
         void            HandleGetServiceResetToken ( HTTPRequest *pRequest );
         static void     DetermineClient            ( HTTPRequest *pRequest, UPnpCDSRequest *pCDSRequest );
 
+        CDSBrowseCacheEntry *LoadBrowseEntry       ( UPnpCDSRequest &request,
+                                                     FilterMap &filter,
+                                                     UPnPResultCode &eErrorCode,
+                                                     QString &sErrorDesc );
+
     protected:
 
         // Implement UPnpServiceImpl methods that we can
@@ -328,6 +365,8 @@ class UPNP_PUBLIC UPnpCDS : public Eventing
         void     RegisterExtension  ( UPnpCDSExtension *pExtension );
         void     UnregisterExtension( UPnpCDSExtension *pExtension );
 
+        void     IncrementSystemUpdateID( );
+
         void     RegisterShortCut   ( UPnPShortcutFeature::ShortCutType type,
                                       const QString &objectID );
         void     RegisterFeature    ( UPnPFeature *feature );
@@ -34,6 +34,7 @@
 #include "libmythbase/mythcorecontext.h"
 #include "libmythbase/mythdate.h"
 #include "libmythbase/mythdb.h"
+#include "libmythbase/mythevent.h"
 #include "libmythbase/mythlogging.h"
 #include "libmythbase/storagegroup.h"
 #include "libmythprotoserver/requesthandler/fileserverutil.h"
@@ -59,6 +60,12 @@ static constexpr uint64_t kSpaceTooBigKB { 3ULL * 1024 * 1024 };
 // add to the autoexpire list.
 static constexpr int64_t kRecentInterval { 2LL * 60 * 60 };
 
+// How long the ordered expire lists are trusted without an event saying
+// they have changed. Lists that depend on the current time are refreshed
+// more often.
+static constexpr std::chrono::minutes kOrderedMaxAge { 10min };
+static constexpr std::chrono::minutes kTimedOrderedMaxAge { 1min };
+
 /// \brief This calls AutoExpire::RunExpirer() from within a new thread.
 void ExpireThread::run(void)
 {
@@ -108,6 +115,8 @@ AutoExpire::~AutoExpire()
         delete m_expireThread;
         m_expireThread = nullptr;
     }
+
+    ClearOrdered();
 }
 
 /**
@@ -130,21 +139,11 @@ void AutoExpire::CalcParams()
 {
     LOG(VB_FILE, LOG_INFO, LOC + "CalcParams()");
 
-    FileSystemInfoList fsInfos;
-
-    m_instanceLock.lock();
-    if (m_mainServer)
-    {
-        // The scheduler relies on something forcing the mainserver
-        // fsinfos cache to get updated periodically.  Currently, that
-        // is done here.  Don't remove or change this invocation
-        // without handling that issue too.  It is done this way
-        // because the scheduler thread can't afford to be blocked by
-        // an unresponsive, remote filesystem and the autoexpirer
-        // thread can.
-        m_mainServer->GetFilesystemInfos(fsInfos, false);
-    }
-    m_instanceLock.unlock();
+    // RunExpirer() rescans the filesystems before each expire run, in
+    // between the model accounts for recordings started and deleted.
+    if (m_space.IsEmpty())
+        ScanFilesystems();
+    FileSystemInfoList fsInfos = m_space.GetFilesystems();
 
     if (fsInfos.empty())
     {
@@ -226,6 +225,7 @@ void AutoExpire::CalcParams()
             }
         }
         fsMap[fs.getFSysID()] = thisKBperMin;
+        m_space.SetWriteRate(fs.getFSysID(), thisKBperMin);
 
         if (thisKBperMin > maxKBperMin)
         {
@@ -265,6 +265,32 @@ void AutoExpire::CalcParams()
     m_instanceLock.unlock();
 }
 
+/**
+ *  \brief Rescans the storage group directories on all backends and
+ *         restarts the disk space model from the results.
+ */
+void AutoExpire::ScanFilesystems(void)
+{
+    FileSystemInfoList fsInfos;
+
+    m_instanceLock.lock();
+    if (m_mainServer)
+    {
+        // The scheduler relies on something forcing the mainserver
+        // fsinfos cache to get updated periodically.  Currently, that
+        // is done here.  Don't remove or change this invocation
+        // without handling that issue too.  It is done this way
+        // because the scheduler thread can't afford to be blocked by
+        // an unresponsive, remote filesystem and the autoexpirer
+        // thread can.
+        m_mainServer->GetFilesystemInfos(fsInfos, false);
+    }
+    m_instanceLock.unlock();
+
+    if (!fsInfos.empty())
+        m_space.SetFilesystems(fsInfos);
+}
+
 /** \brief This contains the main loop for the auto expire process.
  *
  *   Responsible for cleanup of old LiveTV programs as well as deleting as
@@ -304,6 +330,7 @@ void AutoExpire::RunExpirer(void)
             m_updateLock.unlock();
 
             locker.unlock();
+            ScanFilesystems();
             CalcParams();
             locker.relock();
             if (!m_expireThreadRun)
@@ -414,8 +441,7 @@ void AutoExpire::ExpireRecordings(void)
 
     LOG(VB_FILE, LOG_INFO, LOC + "ExpireRecordings()");
 
-    if (m_mainServer)
-        m_mainServer->GetFilesystemInfos(fsInfos, true);
+    fsInfos = m_space.GetFilesystems();
 
     if (fsInfos.empty())
     {
@@ -655,6 +681,11 @@ void AutoExpire::SendDeleteMessages(pginfolist_t &deleteList)
                      .arg((*it)->GetRecordingStartTime(MythDate::ISODate)));
         gCoreContext->dispatch(me);
 
+        // and don't offer it again while it is being deleted
+        m_updateLock.lock();
+        m_orderedDeleted.insert((*it)->GetRecordingID());
+        m_updateLock.unlock();
+
         ++it; // move on to next program
     }
 }
@@ -807,6 +838,7 @@ void AutoExpire::FillExpireList(pginfolist_t &expireList)
  */
 void AutoExpire::PrintExpireList(const QString& expHost)
 {
+    QMutexLocker locker(&m_instanceLock);
     pginfolist_t expireList;
 
     FillExpireList(expireList);
@@ -906,10 +938,135 @@ void AutoExpire::ClearExpireList(pginfolist_t &expireList, bool deleteProg)
 }
 
 /** \fn AutoExpire::FillDBOrdered(pginfolist_t&, int)
- *  \brief Creates a list of programs to delete using the database to
- *         order list.
+ *  \brief Adds the programs that expire method \a expMethod would delete
+ *         to expireList, in the order they should be deleted.
+ *
+ *  Programs that are in the "Don't Expire" set or already in the list
+ *  are skipped. Must be called with m_instanceLock held.
  */
 void AutoExpire::FillDBOrdered(pginfolist_t &expireList, int expMethod)
+{
+    QSet<QString> listed;
+    for (auto *info : expireList)
+        listed.insert(ExpireKey(info->GetChanID(), info->GetRecordingStartTime()));
+
+    for (auto *info : GetOrdered(expMethod))
+    {
+        uint chanid = info->GetChanID();
+        QDateTime recstartts = info->GetRecordingStartTime();
+        QString key = ExpireKey(chanid, recstartts);
+
+        if (m_dontExpireSet.contains(key))
+        {
+            LOG(VB_FILE, LOG_INFO, LOC +
+                QString("    Skipping %1 at %2 because it is in Don't Expire "
+                        "List")
+                    .arg(chanid).arg(recstartts.toString(Qt::ISODate)));
+        }
+        else if (listed.contains(key))
+        {
+            LOG(VB_FILE, LOG_INFO, LOC +
+                QString("    Skipping %1 at %2 because it is already in Expire "
+                        "List")
+                    .arg(chanid).arg(recstartts.toString(Qt::ISODate)));
+        }
+        else
+        {
+            LOG(VB_FILE, LOG_INFO, LOC + QString("    Adding   %1 at %2")
+                    .arg(chanid).arg(recstartts.toString(Qt::ISODate)));
+            expireList.push_back(new ProgramInfo(*info));
+            listed.insert(key);
+        }
+    }
+}
+
+/**
+ *  \brief Returns the programs expire method \a expMethod would pick, in
+ *         order, loading them from the database if they aren't known or
+ *         may be out of date. Must be called with m_instanceLock held.
+ */
+const pginfolist_t &AutoExpire::GetOrdered(int expMethod)
+{
+    ApplyOrderedChanges();
+
+    bool timed = (expMethod == emShortLiveTVPrograms  ||
+                  expMethod == emNormalLiveTVPrograms ||
+                  expMethod == emOldDeletedPrograms   ||
+                  expMethod == emQuickDeletedPrograms);
+    std::chrono::milliseconds maxAge = timed ? kTimedOrderedMaxAge : kOrderedMaxAge;
+
+    OrderedList &ordered = m_ordered[expMethod];
+    if (!ordered.m_age.isValid() || ordered.m_age.hasExpired(maxAge.count()))
+    {
+        ClearExpireList(ordered.m_list);
+        LoadOrdered(ordered.m_list, expMethod);
+        ordered.m_age.start();
+    }
+    return ordered.m_list;
+}
+
+/**
+ *  \brief Applies the recording changes reported by events since the
+ *         ordered lists were last used. Must be called with
+ *         m_instanceLock held.
+ */
+void AutoExpire::ApplyOrderedChanges(void)
+{
+    bool invalid = false;
+    QSet<uint> deleted;
+    QMap<uint, uint64_t> sizes;
+
+    m_updateLock.lock();
+    std::swap(invalid, m_orderedInvalid);
+    deleted.swap(m_orderedDeleted);
+    sizes.swap(m_orderedSizes);
+    m_updateLock.unlock();
+
+    if (invalid)
+    {
+        ClearOrdered();
+        return;
+    }
+
+    if (deleted.isEmpty() && sizes.isEmpty())
+        return;
+
+    for (auto &ordered : m_ordered)
+    {
+        auto it = ordered.m_list.begin();
+        while (it != ordered.m_list.end())
+        {
+            uint recordedid = (*it)->GetRecordingID();
+            if (deleted.contains(recordedid))
+            {
+                delete *it;
+                it = ordered.m_list.erase(it);
+                continue;
+            }
+            auto size = sizes.constFind(recordedid);
+            if (size != sizes.constEnd())
+                (*it)->SetFilesize(*size);
+            ++it;
+        }
+    }
+}
+
+/**
+ *  \brief Forgets the ordered lists, so they are loaded again when next
+ *         used. Must be called with m_instanceLock held.
+ */
+void AutoExpire::ClearOrdered(void)
+{
+    for (auto &ordered : m_ordered)
+        ClearExpireList(ordered.m_list);
+    m_ordered.clear();
+}
+
+/**
+ *  \brief Loads the programs expire method \a expMethod would pick from
+ *         the database, in the order they should be deleted.
+ */
+void AutoExpire::LoadOrdered(pginfolist_t &ordered, int expMethod)
 {
     QString where;
     QString orderby;
@@ -982,7 +1139,7 @@ void AutoExpire::FillDBOrdered(pginfolist_t &expireList, int expMethod)
             break;
     }
 
-    LOG(VB_FILE, LOG_INFO, LOC + "FillDBOrdered: " + msg);
+    LOG(VB_FILE, LOG_INFO, LOC + "LoadOrdered: " + msg);
 
     MSqlQuery query(MSqlQuery::InitCon());
     QString querystr = QString(
@@ -1002,37 +1159,18 @@ void AutoExpire::FillDBOrdered(pginfolist_t &expireList, int expMethod)
         uint chanid = query.value(0).toUInt();
         QDateTime recstartts = MythDate::as_utc(query.value(1).toDateTime());
 
-        if (IsInDontExpireSet(chanid, recstartts))
+        auto *pginfo = new ProgramInfo(chanid, recstartts);
+        if (pginfo->GetChanID())
         {
-            LOG(VB_FILE, LOG_INFO, LOC +
-                QString("    Skipping %1 at %2 because it is in Don't Expire "
-                        "List")
-                    .arg(chanid).arg(recstartts.toString(Qt::ISODate)));
+            ordered.push_back(pginfo);
         }
-        else if (IsInExpireList(expireList, chanid, recstartts))
+        else
         {
             LOG(VB_FILE, LOG_INFO, LOC +
-                QString("    Skipping %1 at %2 because it is already in Expire "
-                        "List")
+                QString("    Skipping %1 at %2 "
+                        "because it could not be loaded from the DB")
                     .arg(chanid).arg(recstartts.toString(Qt::ISODate)));
-        }
-        else
-        {
-            auto *pginfo = new ProgramInfo(chanid, recstartts);
-            if (pginfo->GetChanID())
-            {
-                LOG(VB_FILE, LOG_INFO, LOC + QString("    Adding   %1 at %2")
-                        .arg(chanid).arg(recstartts.toString(Qt::ISODate)));
-                expireList.push_back(pginfo);
-            }
-            else
-            {
-                LOG(VB_FILE, LOG_INFO, LOC +
-                    QString("    Skipping %1 at %2 "
-                            "because it could not be loaded from the DB")
-                        .arg(chanid).arg(recstartts.toString(Qt::ISODate)));
-                delete pginfo;
-            }
+            delete pginfo;
         }
     }
 }
@@ -1121,19 +1259,67 @@ void AutoExpire::UpdateDontExpireSet(void)
 bool AutoExpire::IsInDontExpireSet(
     uint chanid, const QDateTime &recstartts) const
 {
-    QString key = QString("%1_%2")
-        .arg(chanid).arg(recstartts.toString(Qt::ISODate));
+    return (m_dontExpireSet.contains(ExpireKey(chanid, recstartts)));
+}
+
+QString AutoExpire::ExpireKey(uint chanid, const QDateTime &recstartts)
+{
+    return QString("%1_%2").arg(chanid).arg(recstartts.toString(Qt::ISODate));
+}
+
+/**
+ *  \brief Credits the space of a deleted recording file to the disk space
+ *         model until the next rescan.
+ */
+void AutoExpire::RecordingDeleted(const QString &hostname,
+                                  const QString &filename, int64_t bytes)
+{
+    int fsID = m_space.FindFilesystem(hostname, QFileInfo(filename).path());
+    if (fsID < 0)
+        return;
 
-    return (m_dontExpireSet.contains(key));
+    LOG(VB_FILE, LOG_INFO, LOC + QString("%1 MB freed on fsID %2 by deleting %3")
+        .arg(bytes >> 20).arg(fsID).arg(filename));
+    m_space.AddFreed(fsID, bytes / 1024);
 }
 
-bool AutoExpire::IsInExpireList(
-    const pginfolist_t &expireList, uint chanid, const QDateTime &recstartts)
+/**
+ *  \brief Notes the recording changes that affect the ordered expire
+ *         lists. They are applied by the expire thread, as the instance
+ *         lock can be held for a long time.
+ */
+void AutoExpire::customEvent(QEvent *event)
 {
-    return std::ranges::any_of(expireList,
-                       [chanid,&recstartts](auto *info)
-                           { return ((info->GetChanID()             == chanid) &&
-                                     (info->GetRecordingStartTime() == recstartts)); } );
+    if (event->type() != MythEvent::kMythEventMessage)
+        return;
+
+    auto *me = dynamic_cast<MythEvent *>(event);
+    if (me == nullptr)
+        return;
+
+    QStringList tokens = me->Message().simplified().split(" ", Qt::SkipEmptyParts);
+    if (tokens.isEmpty())
+        return;
+
+    QMutexLocker locker(&m_updateLock);
+    if (tokens[0] == "RECORDING_LIST_CHANGE")
+    {
+        // RECORDING_LIST_CHANGE DELETE recordedid
+        if (tokens.size() == 3 && tokens[1] == "DELETE")
+            m_orderedDeleted.insert(tokens[2].toUInt());
+        else
+            m_orderedInvalid = true;
+    }
+    else if (tokens[0] == "UPDATE_FILE_SIZE" && tokens.size() >= 3)
+    {
+        // UPDATE_FILE_SIZE recordedid size
+        m_orderedSizes[tokens[1].toUInt()] = tokens[2].toULongLong();
+    }
+    else if (tokens[0] == "MASTER_UPDATE_REC_INFO" ||
+             tokens[0] == "CLEAR_SETTINGS_CACHE")
+    {
+        m_orderedInvalid = true;
+    }
 }
 
 #include "moc_autoexpire.cpp"
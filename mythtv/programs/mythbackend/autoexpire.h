@@ -6,6 +6,7 @@
 
 #include <QWaitCondition>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QPointer>
 #include <QObject>
 #include <QString>
@@ -16,6 +17,8 @@
 
 #include "libmythbase/mthread.h"
 
+#include "diskspacemodel.h"
+
 class ProgramInfo;
 class EncoderLink;
 class MainServer;
@@ -71,6 +74,10 @@ class AutoExpire : public QObject
     void PrintExpireList(const QString& expHost = "ALL");
 
     uint64_t GetDesiredSpace(int fsID) const;
+    FileSystemInfoList GetFilesystemInfos(void) const
+        { return m_space.GetFilesystems(); }
+    void RecordingDeleted(const QString &hostname, const QString &filename,
+                          int64_t bytes);
 
     void GetAllExpiring(QStringList &strList);
     void GetAllExpiring(pginfolist_t &list);
@@ -89,6 +96,7 @@ class AutoExpire : public QObject
 
   protected:
     void RunExpirer(void);
+    void customEvent(QEvent *event) override; // QObject
 
   private:
     void ExpireLiveTV(int type);
@@ -97,15 +105,19 @@ class AutoExpire : public QObject
     void ExpireRecordings(void);
     void ExpireEpisodesOverMax(void);
 
+    void ScanFilesystems(void);
     void FillExpireList(pginfolist_t &expireList);
     void FillDBOrdered(pginfolist_t &expireList, int expMethod);
-    static void SendDeleteMessages(pginfolist_t &deleteList);
+    const pginfolist_t &GetOrdered(int expMethod);
+    static void LoadOrdered(pginfolist_t &ordered, int expMethod);
+    void ApplyOrderedChanges(void);
+    void ClearOrdered(void);
+    void SendDeleteMessages(pginfolist_t &deleteList);
     void Sleep(std::chrono::milliseconds sleepTime);
 
     void UpdateDontExpireSet(void);
     bool IsInDontExpireSet(uint chanid, const QDateTime &recstartts) const;
-    static bool IsInExpireList(const pginfolist_t &expireList,
-                               uint chanid, const QDateTime &recstartts);
+    static QString ExpireKey(uint chanid, const QDateTime &recstartts);
 
     // main expire info
     QSet<QString> m_dontExpireSet;
@@ -121,9 +133,24 @@ class AutoExpire : public QObject
 
     MainServer    *m_mainServer       {nullptr};  // protected by m_instanceLock
 
+    DiskSpaceModel m_space;
+
+    // The recordings each expire method would pick, in order, before the
+    // "Don't Expire" set is applied. Kept up to date from the recording
+    // list change events rather than queried on every use.
+    struct OrderedList
+    {
+        pginfolist_t  m_list;
+        QElapsedTimer m_age;
+    };
+    QMap<int, OrderedList> m_ordered;            // protected by m_instanceLock
+
     // update info
     QMutex              m_updateLock;
     QQueue<UpdateEntry> m_updateQueue;           // protected by m_updateLock
+    bool                m_orderedInvalid {false}; // protected by m_updateLock
+    QSet<uint>          m_orderedDeleted;        // protected by m_updateLock
+    QMap<uint, uint64_t> m_orderedSizes;         // protected by m_updateLock
 };
 
 #endif
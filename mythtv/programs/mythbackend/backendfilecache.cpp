@@ -0,0 +1,523 @@
+// C++ headers
+#include <algorithm>
+#include <climits>
+
+// POSIX headers
+#include <sys/stat.h>
+
+// Qt headers
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QTextStream>
+
+// MythTV headers
+#include "libmythbase/mythcorecontext.h"
+#include "libmythbase/mythdirs.h"
+#include "libmythbase/mythlogging.h"
+#include "libmythbase/mythmiscutil.h"
+#include "libmythbase/mthread.h"
+#include "libmythbase/storagegroup.h"
+
+// MythBackend
+#include "backendfilecache.h"
+
+#define LOC QString("FileCache: ")
+
+StorageGroupIndex::StorageGroupIndex()
+  : m_watcher(new QFileSystemWatcher(this))
+{
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged,
+            this, &StorageGroupIndex::DirectoryChanged);
+}
+
+/** \fn StorageGroupIndex::FindFile(const QString&, const QString&, bool)
+ *  \brief Locate a file in a local storage group.
+ *
+ *  Equivalent to StorageGroup::FindFile(), including the fallback to the
+ *  Default group and then to every storage group directory.
+ *  \return Full path of the file, or an empty string if it was not found.
+ */
+QString StorageGroupIndex::FindFile(const QString &groupname,
+                                    const QString &filename,
+                                    bool allowFallback)
+{
+    QString dir = FindFileDir(groupname, gCoreContext->GetHostName(),
+                              filename, allowFallback);
+    if (dir.isEmpty())
+        return dir;
+    return dir + "/" + filename;
+}
+
+/** \fn StorageGroupIndex::GetFileInfo(const QString&, const QString&, bool)
+ *  \brief Equivalent to StorageGroup::GetFileInfo().
+ *  \return The full path, modification time and size of the file, or an
+ *          empty list if it was not found.
+ */
+QStringList StorageGroupIndex::GetFileInfo(const QString &groupname,
+                                           const QString &filename,
+                                           bool allowFallback)
+{
+    Group group = GetGroup(groupname, gCoreContext->GetHostName(),
+                           allowFallback);
+
+    bool inGroup = std::any_of(group.m_dirs.cbegin(), group.m_dirs.cend(),
+        [&filename](const QString &dir){ return filename.startsWith(dir); });
+
+    QString fullname = filename;
+    if (filename.isEmpty() || !inGroup || !QFile::exists(filename))
+        fullname = FindFile(groupname, filename, allowFallback);
+
+    QStringList details;
+    if (fullname.isEmpty())
+        return details;
+
+    QFileInfo fInfo(fullname);
+    details << fullname;
+    if (fInfo.lastModified().isValid())
+        details << QString::number(fInfo.lastModified().toSecsSinceEpoch());
+    else
+        details << QString::number(UINT_MAX);
+    details << QString::number(fInfo.size());
+
+    return details;
+}
+
+/** \fn StorageGroupIndex::ClearGroups(void)
+ *  \brief Forget the storage group directory lists, after the storage
+ *         groups may have been edited.
+ *
+ *  Directories already indexed stay indexed, since they are still watched,
+ *  but those that could not be indexed are tried again.
+ */
+void StorageGroupIndex::ClearGroups(void)
+{
+    QMutexLocker locker(&m_lock);
+    m_groups.clear();
+    for (auto it = m_roots.begin(); it != m_roots.end(); )
+    {
+        if (it.value() == kUnindexed)
+            it = m_roots.erase(it);
+        else
+            ++it;
+    }
+}
+
+StorageGroupIndex::Group StorageGroupIndex::GetGroup(const QString &groupname,
+                                                     const QString &hostname,
+                                                     bool allowFallback)
+{
+    QString key = QString("%1|%2|%3")
+        .arg(groupname, hostname).arg(allowFallback ? 1 : 0);
+
+    {
+        QMutexLocker locker(&m_lock);
+        auto it = m_groups.constFind(key);
+        if (it != m_groups.constEnd())
+            return *it;
+    }
+
+    StorageGroup sgroup(groupname, hostname, allowFallback);
+    Group group { sgroup.getName(), sgroup.GetDirList() };
+
+    QMutexLocker locker(&m_lock);
+    m_groups.insert(key, group);
+    return group;
+}
+
+/// Mirrors StorageGroup::FindFileDir(), answering from the index.
+QString StorageGroupIndex::FindFileDir(const QString &groupname,
+                                       const QString &hostname,
+                                       const QString &filename,
+                                       bool allowFallback)
+{
+    Group group = GetGroup(groupname, hostname, allowFallback);
+
+    for (const auto & dir : std::as_const(group.m_dirs))
+    {
+        if (Contains(dir, filename))
+            return dir;
+    }
+
+    if (group.m_name.isEmpty() || !allowFallback)
+    {
+        // Not found in any dir, so try RecordFilePrefix if it exists
+        QString prefix = gCoreContext->GetSetting("RecordFilePrefix");
+        QFileInfo checkFile(prefix + "/" + filename);
+        if (checkFile.exists() || checkFile.isSymLink())
+            return prefix;
+        return {};
+    }
+
+    // Not found in current group so try Default, and then any dir
+    if (group.m_name != "Default")
+        return FindFileDir("Default", "", filename, true);
+    return FindFileDir("", "", filename, true);
+}
+
+/** \fn StorageGroupIndex::Contains(const QString&, const QString&)
+ *  \brief Check whether a file or symbolic link exists below a storage
+ *         group directory, starting to index the directory if needed.
+ */
+bool StorageGroupIndex::Contains(const QString &dir, const QString &filename)
+{
+    QString root = QDir::cleanPath(dir);
+    QString path = QDir::cleanPath(root + "/" + filename);
+
+    auto onDisk = [&path]()
+    {
+        QFileInfo checkFile(path);
+        return checkFile.exists() || checkFile.isSymLink();
+    };
+
+    QMutexLocker locker(&m_lock);
+
+    auto state = m_roots.constFind(root);
+    if (state == m_roots.constEnd())
+    {
+        m_roots.insert(root, kIndexing);
+        // The watcher must only be touched from the index thread
+        QMetaObject::invokeMethod(this, "IndexRoot", Qt::QueuedConnection,
+                                  Q_ARG(QString, root));
+        locker.unlock();
+        return onDisk();
+    }
+
+    if (*state != kIndexed || !path.startsWith(root + "/"))
+    {
+        locker.unlock();
+        return onDisk();
+    }
+
+    // Walk down from the storage group directory.  Each entry must be
+    // listed in its parent, and each parent must itself be indexed, or
+    // else it is a link to somewhere that is not watched.
+    QStringList names = path.mid(root.size() + 1).split('/');
+    QString parent = root;
+    for (int i = 0; i < names.size(); ++i)
+    {
+        auto entries = m_dirs.constFind(parent);
+        if (entries == m_dirs.constEnd())
+        {
+            locker.unlock();
+            return onDisk();
+        }
+        if (!entries->contains(names[i]))
+            return false;
+        parent += "/" + names[i];
+    }
+
+    return true;
+}
+
+void StorageGroupIndex::IndexRoot(const QString &root)
+{
+    int entries = 0;
+    bool indexed = AddTree(root, entries);
+
+    if (!indexed)
+        DropTree(root);
+
+    {
+        QMutexLocker locker(&m_lock);
+        m_roots.insert(root, indexed ? kIndexed : kUnindexed);
+    }
+
+    if (indexed)
+    {
+        LOG(VB_FILE, LOG_INFO, LOC +
+            QString("Indexed %1 entries in '%2'").arg(entries).arg(root));
+    }
+    else
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC +
+            QString("Unable to index '%1', looking files up on disk")
+                .arg(root));
+    }
+}
+
+/** \fn StorageGroupIndex::AddTree(const QString&, int&)
+ *  \brief Watch and list a directory and the directories below it.
+ *  \return False if a watch could not be added or too many entries were
+ *          found, in which case the caller drops the tree.
+ */
+bool StorageGroupIndex::AddTree(const QString &dir, int &entries)
+{
+    {
+        QMutexLocker locker(&m_lock);
+        if (m_dirs.contains(dir))
+            return true;
+    }
+
+    // Watch before listing, so that no change can be missed in between
+    if (!m_watcher->addPath(dir))
+        return false;
+
+    QDir qdir(dir);
+    qdir.setFilter(QDir::AllEntries | QDir::Hidden | QDir::System |
+                   QDir::NoDotAndDotDot);
+    QFileInfoList list = qdir.entryInfoList();
+
+    QSet<QString> names;
+    QStringList subdirs;
+    names.reserve(list.size());
+    for (const auto & entry : std::as_const(list))
+    {
+        names.insert(entry.fileName());
+        if (entry.isDir() && !entry.isSymLink())
+            subdirs << entry.filePath();
+    }
+
+    entries += names.size();
+    if (entries > kMaxIndexEntries)
+        return false;
+
+    {
+        QMutexLocker locker(&m_lock);
+        m_dirs.insert(dir, names);
+    }
+
+    return std::all_of(subdirs.cbegin(), subdirs.cend(),
+        [this, &entries](const QString &subdir)
+        { return AddTree(subdir, entries); });
+}
+
+/// Stop watching a directory and forget it and everything below it.
+void StorageGroupIndex::DropTree(const QString &dir)
+{
+    QStringList dropped;
+    QString prefix = dir + "/";
+
+    {
+        QMutexLocker locker(&m_lock);
+        for (auto it = m_dirs.begin(); it != m_dirs.end(); )
+        {
+            if (it.key() == dir || it.key().startsWith(prefix))
+            {
+                dropped << it.key();
+                it = m_dirs.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    if (!dropped.isEmpty())
+        m_watcher->removePaths(dropped);
+}
+
+/// The indexed storage group directory that a directory lies below.
+QString StorageGroupIndex::RootOf(const QString &path) const
+{
+    for (auto it = m_roots.cbegin(); it != m_roots.cend(); ++it)
+    {
+        if (it.value() != kUnindexed &&
+            (path == it.key() || path.startsWith(it.key() + "/")))
+            return it.key();
+    }
+    return {};
+}
+
+void StorageGroupIndex::DirectoryChanged(const QString &path)
+{
+    LOG(VB_FILE, LOG_DEBUG, LOC + QString("'%1' changed").arg(path));
+
+    QFileInfo info(path);
+    if (!info.isDir() || info.isSymLink())
+    {
+        // Removed, its parent drops it too when it sees the change.  A
+        // storage group directory is indexed afresh if it comes back.
+        DropTree(path);
+        QMutexLocker locker(&m_lock);
+        m_roots.remove(path);
+        return;
+    }
+
+    QDir qdir(path);
+    qdir.setFilter(QDir::AllEntries | QDir::Hidden | QDir::System |
+                   QDir::NoDotAndDotDot);
+    QFileInfoList list = qdir.entryInfoList();
+
+    QSet<QString> names;
+    QSet<QString> subdirs;
+    names.reserve(list.size());
+    for (const auto & entry : std::as_const(list))
+    {
+        names.insert(entry.fileName());
+        if (entry.isDir() && !entry.isSymLink())
+            subdirs.insert(entry.filePath());
+    }
+
+    QString root;
+    QStringList gone;
+    {
+        QMutexLocker locker(&m_lock);
+        root = RootOf(path);
+        if (root.isEmpty() || !m_dirs.contains(path))
+            return;
+        const QSet<QString> old = m_dirs.value(path);
+        for (const auto & name : old)
+        {
+            // Directories that went away or were replaced by something else
+            QString child = path + "/" + name;
+            if (m_dirs.contains(child) && !subdirs.contains(child))
+                gone << child;
+        }
+        m_dirs.insert(path, names);
+    }
+
+    for (const auto & child : std::as_const(gone))
+        DropTree(child);
+
+    // and index the new ones
+    int entries = 0;
+    for (const auto & subdir : std::as_const(subdirs))
+    {
+        if (!AddTree(subdir, entries))
+        {
+            LOG(VB_GENERAL, LOG_WARNING, LOC +
+                QString("Unable to index '%1', looking files up on disk")
+                    .arg(root));
+            DropTree(root);
+            QMutexLocker locker(&m_lock);
+            m_roots.insert(root, kUnindexed);
+            return;
+        }
+    }
+}
+
+BackendFileCache::BackendFileCache(QObject *parent)
+  : QObject(parent),
+    m_indexThread(new MThread("FileIndex")),
+    m_index(new StorageGroupIndex)
+{
+    m_index->moveToThread(m_indexThread->qthread());
+    m_indexThread->start();
+
+    Load();
+
+    connect(&m_saveTimer, &QTimer::timeout, this, &BackendFileCache::Save);
+    m_saveTimer.start(kSaveInterval);
+}
+
+BackendFileCache::~BackendFileCache()
+{
+    Save();
+
+    // The index, and its watcher, are deleted in the index thread as it exits
+    m_index->deleteLater();
+    m_indexThread->quit();
+    m_indexThread->wait();
+    delete m_indexThread;
+}
+
+/** \fn BackendFileCache::GetFileHash(const QString&)
+ *  \brief Return the FileHash() of a local file, computing it only if the
+ *         file is new or has changed since it was last hashed.
+ */
+QString BackendFileCache::GetFileHash(const QString &fullname)
+{
+    if (fullname.isEmpty())
+        return FileHash(fullname);
+
+    struct stat fileinfo {};
+    if (stat(fullname.toLocal8Bit().constData(), &fileinfo) < 0)
+        return FileHash(fullname);
+
+    QString key = QString("%1:%2").arg(fileinfo.st_dev).arg(fileinfo.st_ino);
+    auto size  = static_cast<int64_t>(fileinfo.st_size);
+    auto mtime = static_cast<int64_t>(fileinfo.st_mtime);
+
+    {
+        QMutexLocker locker(&m_hashLock);
+        auto it = m_hashCache.constFind(key);
+        if (it != m_hashCache.constEnd() &&
+            it->m_size == size && it->m_mtime == mtime)
+        {
+            return it->m_hash;
+        }
+    }
+
+    // Bound the number of files being read at once so that a burst of
+    // requests from a video scan does not thrash the disks.
+    m_hashWorkers.acquire();
+    QString hash = FileHash(fullname);
+    m_hashWorkers.release();
+
+    if (hash == "NULL")
+        return hash;
+
+    QMutexLocker locker(&m_hashLock);
+    if (m_hashCache.size() >= kMaxHashEntries)
+        m_hashCache.clear();
+    m_hashCache.insert(key, { size, mtime, hash });
+    m_dirty = true;
+
+    return hash;
+}
+
+QString BackendFileCache::CacheFilename(void)
+{
+    return GetCacheDir() + "/backendfilehash.cache";
+}
+
+void BackendFileCache::Load(void)
+{
+    QFile file(CacheFilename());
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return;
+
+    QMutexLocker locker(&m_hashLock);
+    QTextStream stream(&file);
+    QString line;
+
+    while (stream.readLineInto(&line))
+    {
+        QStringList fields = line.split(' ');
+        if (fields.size() != 4)
+            continue;
+        m_hashCache.insert(fields[0], { fields[1].toLongLong(),
+                                        fields[2].toLongLong(), fields[3] });
+    }
+
+    LOG(VB_FILE, LOG_INFO, LOC +
+        QString("Loaded %1 file hashes").arg(m_hashCache.size()));
+}
+
+void BackendFileCache::Save(void)
+{
+    QHash<QString, HashEntry> snapshot;
+    {
+        QMutexLocker locker(&m_hashLock);
+        if (!m_dirty)
+            return;
+        snapshot = m_hashCache;
+        m_dirty = false;
+    }
+
+    QSaveFile file(CacheFilename());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Unable to write '%1'").arg(CacheFilename()));
+        return;
+    }
+
+    QTextStream stream(&file);
+    for (auto it = snapshot.cbegin(); it != snapshot.cend(); ++it)
+    {
+        stream << it.key() << ' ' << it->m_size << ' ' << it->m_mtime
+               << ' ' << it->m_hash << '\n';
+    }
+    stream.flush();
+
+    if (!file.commit())
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Unable to save '%1'").arg(CacheFilename()));
+    }
+}
@@ -0,0 +1,143 @@
+#ifndef BACKENDFILECACHE_H
+#define BACKENDFILECACHE_H
+
+// C++ headers
+#include <chrono>
+#include <cstdint>
+
+// Qt headers
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSemaphore>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+class MThread;
+
+/** \class StorageGroupIndex
+ *  \brief An index of the contents of the local storage group directories.
+ *
+ *  Each storage group directory is listed, with all of its subdirectories,
+ *  the first time a lookup touches it.  Every listed directory is watched,
+ *  and a change to it re-lists just that directory, so the index answers
+ *  both hits and misses without touching the disk.
+ *
+ *  The index lives in its own thread, which does all the listing and owns
+ *  the watcher.  Lookups are made from any thread.  A directory that can
+ *  not be indexed, because a watch could not be added or because it holds
+ *  more than kMaxIndexEntries entries, is looked up on disk as before, as
+ *  are symbolic links to directories.  A file created moments before a
+ *  lookup may be missed until the change notification has been handled.
+ */
+class StorageGroupIndex : public QObject
+{
+    Q_OBJECT
+
+  public:
+    StorageGroupIndex();
+
+    QString FindFile(const QString &groupname, const QString &filename,
+                     bool allowFallback);
+    QStringList GetFileInfo(const QString &groupname, const QString &filename,
+                            bool allowFallback);
+    void ClearGroups(void);
+
+  private slots:
+    void IndexRoot(const QString &root);
+    void DirectoryChanged(const QString &path);
+
+  private:
+    enum RootState : std::uint8_t
+    {
+        kIndexing,
+        kIndexed,
+        kUnindexed,
+    };
+
+    struct Group
+    {
+        QString     m_name;
+        QStringList m_dirs;
+    };
+
+    Group   GetGroup(const QString &groupname, const QString &hostname,
+                     bool allowFallback);
+    QString FindFileDir(const QString &groupname, const QString &hostname,
+                        const QString &filename, bool allowFallback);
+    bool    Contains(const QString &dir, const QString &filename);
+    bool    AddTree(const QString &dir, int &entries);
+    void    DropTree(const QString &dir);
+    QString RootOf(const QString &path) const;
+
+    static constexpr int kMaxIndexEntries { 200000 };
+
+    QFileSystemWatcher             *m_watcher {nullptr};
+
+    QMutex                          m_lock;
+    QHash<QString, Group>           m_groups;  // group|host|fallback -> dirs
+    QHash<QString, RootState>       m_roots;   // storage group directory
+    QHash<QString, QSet<QString>>   m_dirs;    // directory -> entry names
+};
+
+/** \class BackendFileCache
+ *  \brief Caches storage group lookups and file hashes for MainServer.
+ *
+ *  Storage group lookups are answered from a StorageGroupIndex, so a
+ *  lookup costs no stat() calls at all, whether the file is found or not.
+ *
+ *  File hashes are keyed on device and inode and validated against the
+ *  file size and modification time, so renamed files keep their hash.
+ *  The hash table is saved to the cache directory periodically and on
+ *  shutdown, and reloaded on startup.
+ *  At most kMaxHashWorkers hashes are computed at the same time.
+ */
+class BackendFileCache : public QObject
+{
+    Q_OBJECT
+
+  public:
+    explicit BackendFileCache(QObject *parent = nullptr);
+    ~BackendFileCache() override;
+
+    QString FindFile(const QString &groupname, const QString &filename,
+                     bool allowFallback = true)
+        { return m_index->FindFile(groupname, filename, allowFallback); }
+    QStringList GetFileInfo(const QString &groupname, const QString &filename,
+                            bool allowFallback = true)
+        { return m_index->GetFileInfo(groupname, filename, allowFallback); }
+    void ClearGroups(void) { m_index->ClearGroups(); }
+
+    QString GetFileHash(const QString &fullname);
+
+    void Save(void);
+
+  private:
+    struct HashEntry
+    {
+        int64_t m_size  {0};
+        int64_t m_mtime {0};
+        QString m_hash;
+    };
+
+    void Load(void);
+    static QString CacheFilename(void);
+
+    static constexpr int kMaxHashWorkers   { 4 };
+    static constexpr int kMaxHashEntries   { 500000 };
+    static constexpr std::chrono::minutes kSaveInterval { 10 };
+
+    MThread                  *m_indexThread {nullptr};
+    StorageGroupIndex        *m_index       {nullptr};
+
+    QMutex                    m_hashLock;
+    QHash<QString, HashEntry> m_hashCache;    // dev:inode -> hash
+    bool                      m_dirty   {false};
+    QTimer                    m_saveTimer;
+    QSemaphore                m_hashWorkers {kMaxHashWorkers};
+};
+
+#endif // BACKENDFILECACHE_H
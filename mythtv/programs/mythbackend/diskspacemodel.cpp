@@ -0,0 +1,150 @@
+// C++ headers
+#include <algorithm>
+
+// Qt headers
+#include <QMutexLocker>
+
+// MythTV headers
+#include "libmythbase/mythlogging.h"
+
+// MythBackend
+#include "diskspacemodel.h"
+
+#define LOC QString("DiskSpaceModel: ")
+
+DiskSpaceModel::DiskSpaceModel()
+  : m_clock([]()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch());
+    })
+{
+}
+
+/// Start again from the results of a scan. The write rates are kept, but
+/// the space written and freed so far is now part of the scanned figures.
+void DiskSpaceModel::SetFilesystems(const FileSystemInfoList &fsInfos)
+{
+    QMutexLocker locker(&m_lock);
+
+    std::chrono::milliseconds now = m_clock();
+    QMap<int, Usage> usage;
+    for (const auto &fs : std::as_const(fsInfos))
+    {
+        int fsID = fs.getFSysID();
+        if (usage.contains(fsID))
+            continue;
+
+        Usage &entry = usage[fsID];
+        entry.m_totalKB   = fs.getTotalSpace();
+        entry.m_usedKB    = fs.getUsedSpace();
+        entry.m_rate      = m_usage.value(fsID).m_rate;
+        entry.m_rateStart = now;
+    }
+
+    m_fsInfos = fsInfos;
+    m_usage   = usage;
+
+    LOG(VB_FILE, LOG_INFO, LOC + QString("Scanned %1 filesystems")
+        .arg(m_usage.size()));
+}
+
+/// Set the rate at which the recorders using filesystem \a fsID may write.
+void DiskSpaceModel::SetWriteRate(int fsID, uint64_t kbPerMin)
+{
+    QMutexLocker locker(&m_lock);
+
+    auto it = m_usage.find(fsID);
+    if (it == m_usage.end() || it->m_rate == kbPerMin)
+        return;
+
+    // Bank what was written at the old rate
+    std::chrono::milliseconds now = m_clock();
+    it->m_writtenKB = Written(*it, now);
+    it->m_rate      = kbPerMin;
+    it->m_rateStart = now;
+}
+
+/// Count \a kb deleted from filesystem \a fsID since the last scan.
+void DiskSpaceModel::AddFreed(int fsID, int64_t kb)
+{
+    QMutexLocker locker(&m_lock);
+
+    auto it = m_usage.find(fsID);
+    if (it != m_usage.end() && kb > 0)
+        it->m_freedKB += kb;
+}
+
+bool DiskSpaceModel::IsEmpty(void) const
+{
+    QMutexLocker locker(&m_lock);
+    return m_usage.isEmpty();
+}
+
+/// Find the filesystem holding storage group directory \a dir on
+/// \a hostname, or -1 if it isn't known.
+int DiskSpaceModel::FindFilesystem(const QString &hostname,
+                                   const QString &dir) const
+{
+    QMutexLocker locker(&m_lock);
+
+    int fsID = -1;
+    qsizetype longest = -1;
+    for (const auto &fs : std::as_const(m_fsInfos))
+    {
+        if (fs.getHostname() != hostname)
+            continue;
+
+        // A recording may be in a subdirectory of a storage group directory
+        QString path = fs.getPath();
+        if ((dir == path || dir.startsWith(path + '/')) && path.size() > longest)
+        {
+            fsID = fs.getFSysID();
+            longest = path.size();
+        }
+    }
+    return fsID;
+}
+
+/// Space written to the filesystem since the last scan, as of \a now
+int64_t DiskSpaceModel::Written(const Usage &usage, std::chrono::milliseconds now)
+{
+    auto elapsed = static_cast<uint64_t>(
+        std::max<int64_t>(0, (now - usage.m_rateStart).count()));
+    return usage.m_writtenKB +
+        static_cast<int64_t>(usage.m_rate * elapsed / 60000);
+}
+
+int64_t DiskSpaceModel::EstimateUsed(const Usage &usage) const
+{
+    int64_t used = usage.m_usedKB + Written(usage, m_clock()) - usage.m_freedKB;
+    return std::clamp<int64_t>(used, 0, std::max<int64_t>(0, usage.m_totalKB));
+}
+
+/// Estimated free space on filesystem \a fsID in KB, or -1 if unknown.
+int64_t DiskSpaceModel::GetFreeSpace(int fsID) const
+{
+    QMutexLocker locker(&m_lock);
+
+    auto it = m_usage.constFind(fsID);
+    if (it == m_usage.constEnd() || it->m_totalKB < 0 || it->m_usedKB < 0)
+        return -1;
+    return it->m_totalKB - EstimateUsed(*it);
+}
+
+/// The directories found by the last scan, with the estimated usage of
+/// their filesystems.
+FileSystemInfoList DiskSpaceModel::GetFilesystems(void) const
+{
+    QMutexLocker locker(&m_lock);
+
+    FileSystemInfoList fsInfos = m_fsInfos;
+    for (auto &fs : fsInfos)
+    {
+        auto it = m_usage.constFind(fs.getFSysID());
+        // Leave invalid figures alone, AutoExpire looks for them
+        if (it != m_usage.constEnd() && it->m_totalKB >= 0 && it->m_usedKB >= 0)
+            fs.setUsedSpace(EstimateUsed(*it));
+    }
+    return fsInfos;
+}
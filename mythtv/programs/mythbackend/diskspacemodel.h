@@ -0,0 +1,69 @@
+#ifndef DISKSPACEMODEL_H_
+#define DISKSPACEMODEL_H_
+
+// C++ headers
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+// Qt headers
+#include <QMap>
+#include <QMutex>
+#include <QString>
+
+// MythTV headers
+#include "libmythbase/filesysteminfo.h"
+
+/** \class DiskSpaceModel
+ *  \brief Estimates the space free on each recording filesystem between
+ *         scans of the storage group directories.
+ *
+ *  A scan asks every backend to statfs every storage group directory, which
+ *  is slow and may block on a remote filesystem, so it is only done by the
+ *  AutoExpire thread every few minutes. In between, the model takes off the
+ *  space the recorders writing to a filesystem could have used since the
+ *  scan, at their maximum bitrate, and adds back the space of recordings
+ *  deleted since then. The scheduler and the expirer read these estimates
+ *  rather than asking for another scan.
+ */
+class DiskSpaceModel
+{
+  public:
+    using Clock = std::function<std::chrono::milliseconds(void)>;
+
+    DiskSpaceModel();
+
+    void SetFilesystems(const FileSystemInfoList &fsInfos);
+    void SetWriteRate(int fsID, uint64_t kbPerMin);
+    void AddFreed(int fsID, int64_t kb);
+
+    bool    IsEmpty(void) const;
+    int     FindFilesystem(const QString &hostname, const QString &dir) const;
+    int64_t GetFreeSpace(int fsID) const;
+    FileSystemInfoList GetFilesystems(void) const;
+
+    /// Replace the time source, for testing.
+    void SetClock(Clock clock) { m_clock = std::move(clock); }
+
+  private:
+    struct Usage
+    {
+        int64_t                   m_totalKB   {0};
+        int64_t                   m_usedKB    {0}; ///< at the last scan
+        int64_t                   m_writtenKB {0}; ///< before m_rateStart
+        int64_t                   m_freedKB   {0};
+        uint64_t                  m_rate      {0}; ///< KB per minute
+        std::chrono::milliseconds m_rateStart {0};
+    };
+
+    static int64_t Written(const Usage &usage, std::chrono::milliseconds now);
+    int64_t EstimateUsed(const Usage &usage) const;
+
+    mutable QMutex     m_lock;
+    FileSystemInfoList m_fsInfos;
+    QMap<int, Usage>   m_usage;
+    Clock              m_clock;
+};
+
+#endif // DISKSPACEMODEL_H_
@@ -911,6 +911,22 @@ bool EncoderLink::CheckChannel(const QString &name)
     return false;
 }
 
+/** \brief Keeps this input on standby on channel \a name for the LiveTV
+ *         session on input \a owner, which is about to switch to it.
+ *         <b>This only works on local recorders.</b>
+ *  \return true if the input was on standby on the channel for \a owner
+ *  \sa TVRec::ClaimStandby(uint,const QString&),
+ *      RemoteEncoder::ClaimStandby(uint,const QString&)
+ */
+bool EncoderLink::ClaimStandby(uint owner, const QString &name)
+{
+    if (m_local)
+        return m_tv->ClaimStandby(owner, name);
+
+    LOG(VB_GENERAL, LOG_ERR, "Should be local only query: ClaimStandby");
+    return false;
+}
+
 /** \fn EncoderLink::ShouldSwitchToAnotherInput(const QString&)
  *  \brief Checks if named channel exists on current tuner, or
  *         another tuner.
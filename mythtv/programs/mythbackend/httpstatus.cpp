@@ -231,6 +231,36 @@ void HttpStatus::FillStatusXML( QDomDocument *pDoc )
             if (elink->IsConnected())
                 numencoders++;
 
+            TVRec *tvrec = isLocal ? TVRec::GetTVRec(elink->GetInputID()) : nullptr;
+            if (tvrec)
+            {
+                ChannelChangeStats stats = tvrec->GetChannelChangeStats();
+
+                QDomElement changes = pDoc->createElement("ChannelChanges");
+                encoder.appendChild(changes);
+
+                changes.setAttribute("count"         , stats.GetCount());
+                changes.setAttribute("standby"       , stats.GetStandbyCount());
+                changes.setAttribute("average"       ,
+                                     static_cast<int>(stats.GetAverage().count()));
+                changes.setAttribute("standbyAverage",
+                                     static_cast<int>(stats.GetStandbyAverage().count()));
+                changes.setAttribute("max"           ,
+                                     static_cast<int>(stats.GetMax().count()));
+
+                // The last bucket has no upper limit
+                const ChannelChangeStats::Buckets &buckets = stats.GetBuckets();
+                for (size_t i = 0; i < buckets.size(); ++i)
+                {
+                    QDomElement bucket = pDoc->createElement("Bucket");
+                    changes.appendChild(bucket);
+                    if (i < ChannelChangeStats::kLimits.size())
+                        bucket.setAttribute("limit",
+                            static_cast<int>(ChannelChangeStats::kLimits[i].count()));
+                    bucket.setAttribute("count", buckets[i]);
+                }
+            }
+
             switch (state)
             {
                 case kState_WatchingLiveTV:
@@ -326,6 +326,8 @@ MainServer::MainServer(bool master, int port,
 
     m_metadatafactory = new MetadataFactory(this);
 
+    m_fileCache = new BackendFileCache(this);
+
     m_autoexpireUpdateTimer = new QTimer(this);
     connect(m_autoexpireUpdateTimer, &QTimer::timeout,
             this, &MainServer::autoexpireUpdate);
@@ -1462,7 +1464,10 @@ void MainServer::customEvent(QEvent *e)
         }
 
         if (me->Message() == "CLEAR_SETTINGS_CACHE")
+        {
             gCoreContext->ClearSettingsCache();
+            m_fileCache->ClearGroups();
+        }
 
         if (me->Message().startsWith("RESET_IDLETIME") && m_sched)
             m_sched->ResetIdleTime();
@@ -2457,8 +2462,15 @@ void MainServer::DoDeleteThread(DeleteStruct *ds)
         return;
     }
 
+    // Slow deletes give the space back bit by bit, the next scan sees that
+    if (m_expirer && !slowDeletes)
+    {
+        m_expirer->RecordingDeleted(gCoreContext->GetHostName(),
+                                    ds->m_filename, pginfo.GetFilesize());
+    }
+
     // Delete all related files, though not the recording itself
-    // i.e. preview thumbnails, srt subtitles, orphaned transcode temporary
+    // i.e. preview thumbnails and strips, srt subtitles, orphaned transcode temporary
     //      files
     //
     // TODO: Delete everything with this basename to catch stray
@@ -2471,6 +2483,7 @@ void MainServer::DoDeleteThread(DeleteStruct *ds)
     nameFilters.push_back(fInfo.fileName() + ".old");
     nameFilters.push_back(fInfo.fileName() + ".map");
     nameFilters.push_back(fInfo.fileName() + ".tmp.map");
+    nameFilters.push_back(fInfo.fileName() + ".strip");
     nameFilters.push_back(fInfo.baseName() + ".srt");  // e.g. 1234_20150213165800.srt
 
     QDir dir (fInfo.path());
@@ -3691,9 +3704,8 @@ void MainServer::HandleQueryFileHash(QStringList &slist, PlaybackSock *pbs)
 
     if (gCoreContext->IsThisHost(hostname))
     {
-        StorageGroup sgroup(storageGroup, gCoreContext->GetHostName());
-        QString fullname = sgroup.FindFile(filename);
-        hash = FileHash(fullname);
+        QString fullname = m_fileCache->FindFile(storageGroup, filename);
+        hash = m_fileCache->GetFileHash(fullname);
     }
     else
     {
@@ -4060,7 +4072,7 @@ void MainServer::HandleQueryFindFile(QStringList &slist, PlaybackSock *pbs)
         }
         else
         {
-            if (!sgroup.FindFile(filename).isEmpty())
+            if (!m_fileCache->FindFile(storageGroup, filename, false).isEmpty())
             {
                 fileList << MythCoreContext::GenMythURL(gCoreContext->GetHostName(),
                                                         gCoreContext->GetBackendServerPort(),
@@ -4232,8 +4244,7 @@ void MainServer::HandleSGFileQuery(QStringList &sList,
         (!addr.isEmpty() && addr == wantHostaddr.toString()))
     {
         LOG(VB_FILE, LOG_INFO, LOC + "HandleSGFileQuery: Getting local info");
-        StorageGroup sg(groupname, gCoreContext->GetHostName(), allowFallback);
-        strList = sg.GetFileInfo(filename);
+        strList = m_fileCache->GetFileInfo(groupname, filename, allowFallback);
     }
     else
     {
@@ -4798,6 +4809,12 @@ void MainServer::HandleRecorderQuery(QStringList &slist, QStringList &commands,
         const QString& name = slist[2];
         retlist << QString::number((int)(enc->CheckChannel(name)));
     }
+    else if (command == "CLAIM_STANDBY")
+    {
+        uint owner = slist[2].toUInt();
+        const QString& name = slist[3];
+        retlist << QString::number((int)(enc->ClaimStandby(owner, name)));
+    }
     else if (command == "SHOULD_SWITCH_CARD")
     {
         const QString& chanid = slist[2];
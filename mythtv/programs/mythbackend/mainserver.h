@@ -26,6 +26,7 @@
 
 // mythbackend headers
 #include "autoexpire.h"
+#include "backendfilecache.h"
 #include "encoderlink.h"
 #include "filetransfer.h"
 #include "playbacksock.h"
@@ -339,6 +340,7 @@ class MainServer : public QObject, public MythSocketCBs
 
     Scheduler  *m_sched                      {nullptr};
     AutoExpire *m_expirer                    {nullptr};
+    BackendFileCache *m_fileCache            {nullptr};
     QMutex      m_addChildInputLock;
 
     struct DeferredDeleteStruct
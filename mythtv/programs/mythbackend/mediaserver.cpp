@@ -22,6 +22,7 @@
 #include "libmythbase/mythcorecontext.h"
 #include "libmythbase/mythdb.h"
 #include "libmythbase/mythdirs.h"
+#include "libmythbase/mythevent.h"
 #include "libmythbase/mythlogging.h"
 
 // MythBackend
@@ -193,11 +194,9 @@ void MediaServer::Init(bool bIsMaster, bool bDisableUPnp /* = false */)
             RegisterExtension(new UPnpCDSVideo());
         }
 
-#if 0
         LOG(VB_UPNP, LOG_INFO, "MediaServer::Adding Context Listener");
 
         gCoreContext->addListener( this );
-#endif
 
         Start();
 
@@ -228,9 +227,7 @@ MediaServer::~MediaServer()
 {
     // -=>TODO: Need to check to see if calling this more than once is ok.
 
-#if 0
     gCoreContext->removeListener(this);
-#endif
 
     delete m_webSocketServer;
     delete m_pHttpServer;
@@ -243,18 +240,27 @@ MediaServer::~MediaServer()
 //////////////////////////////////////////////////////////////////////////////
 //
 //////////////////////////////////////////////////////////////////////////////
-#if 0
 void MediaServer::customEvent( QEvent *e )
 {
-    if (MythEvent::Type(e->type()) == MythEvent::MythEventMessage)
-    {
-        MythEvent *me = static_cast<MythEvent *>(e);
-        QString message = me->Message();
+    if (m_pUPnpCDS == nullptr || e->type() != MythEvent::kMythEventMessage)
+        return;
+
+    auto *me = dynamic_cast<MythEvent *>(e);
+    if (me == nullptr)
+        return;
+
+    const QString& message = me->Message();
 
-        //-=>TODO: Need to handle events to notify clients of changes
+    // Any change to the libraries we expose invalidates the materialized
+    // browse results and must be advertised to control points.
+    if (message.startsWith("RECORDING_LIST_CHANGE") ||
+        message.startsWith("VIDEO_LIST_CHANGE") ||
+        message.startsWith("MUSIC_SCANNER_FINISHED"))
+    {
+        m_pUPnpCDS->IncrementSystemUpdateID();
     }
 }
-#endif
+
 //////////////////////////////////////////////////////////////////////////////
 //
 //////////////////////////////////////////////////////////////////////////////
@@ -5726,7 +5726,11 @@ void Scheduler::FillDirectoryInfoCache(void)
 
     m_fsInfoCache.clear();
 
-    if (m_mainServer)
+    // The expirer's figures account for the recordings written and
+    // deleted since the filesystems were last scanned.
+    if (m_expirer)
+        fsInfos = m_expirer->GetFilesystemInfos();
+    if (fsInfos.empty() && m_mainServer)
         m_mainServer->GetFilesystemInfos(fsInfos, true);
 
     QMap <int, bool> fsMap;
@@ -51,7 +51,8 @@ V2MusicMetadataInfoList* V2Music::GetTrackList(int nStartIndex,
         std::this_thread::sleep_for(50ms);
     }
 
-    MetadataPtrList *musicList = all_music->getAllMetadata();
+    // only create MusicMetadata for the page that was asked for
+    const MusicTrackIdList trackList = all_music->getIndex()->ids();
 
     // ----------------------------------------------------------------------
     // Build Response
@@ -59,7 +60,7 @@ V2MusicMetadataInfoList* V2Music::GetTrackList(int nStartIndex,
 
     auto *pMusicMetadataInfos = new V2MusicMetadataInfoList();
 
-    int musicListCount = musicList->count();
+    int musicListCount = trackList.count();
     nStartIndex   = (nStartIndex > 0) ? std::min( nStartIndex, musicListCount ) : 0;
     nCount        = (nCount > 0) ? std::min( nCount, musicListCount ) : musicListCount;
     int nEndIndex = std::min((nStartIndex + nCount), musicListCount );
@@ -68,7 +69,7 @@ V2MusicMetadataInfoList* V2Music::GetTrackList(int nStartIndex,
     {
         V2MusicMetadataInfo *pMusicMetadataInfo = pMusicMetadataInfos->AddNewMusicMetadataInfo();
 
-        MusicMetadata *metadata = musicList->at(n);
+        MusicMetadata *metadata = all_music->getMetadata(trackList.at(n));
 
         if (metadata)
             V2FillMusicMetadataInfo ( pMusicMetadataInfo, metadata, true );
@@ -79,7 +80,7 @@ V2MusicMetadataInfoList* V2Music::GetTrackList(int nStartIndex,
     if (nCount == 0)
         totalPages = 1;
     else
-        totalPages = (int)std::ceil((float)musicList->count() / nCount);
+        totalPages = (int)std::ceil((float)musicListCount / nCount);
 
     if (totalPages == 1)
     {
@@ -94,7 +95,7 @@ V2MusicMetadataInfoList* V2Music::GetTrackList(int nStartIndex,
     pMusicMetadataInfos->setCount         ( nCount          );
     pMusicMetadataInfos->setCurrentPage   ( curPage         );
     pMusicMetadataInfos->setTotalPages    ( totalPages      );
-    pMusicMetadataInfos->setTotalAvailable( musicList->count()  );
+    pMusicMetadataInfos->setTotalAvailable( musicListCount  );
     pMusicMetadataInfos->setAsOf          ( MythDate::current() );
     pMusicMetadataInfos->setVersion       ( MYTH_BINARY_VERSION );
     pMusicMetadataInfos->setProtoVer      ( MYTH_PROTO_VERSION  );
@@ -418,6 +418,9 @@ bool V2Myth::AddStorageGroupDir( const QString &sGroupName,
         throw( QString( "Database Error executing query." ));
     }
 
+    // Storage group directory lists are cached
+    gCoreContext->SendMessage("CLEAR_SETTINGS_CACHE");
+
     return true;
 }
 
@@ -459,6 +462,9 @@ bool V2Myth::RemoveStorageGroupDir( const QString &sGroupName,
         throw( QString( "Database Error executing query." ));
     }
 
+    // Storage group directory lists are cached
+    gCoreContext->SendMessage("CLEAR_SETTINGS_CACHE");
+
     return true;
 }
 
@@ -0,0 +1,166 @@
+/*
+ *  Class TestDiskSpaceModel
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#include "test_diskspacemodel.h"
+
+#include "libmythbase/mythchrono.h"
+
+// Two directories on filesystem 1 of host "alpha", one on filesystem 2
+// of "beta". Sizes are in KB.
+void TestDiskSpaceModel::SetUp(DiskSpaceModel &model)
+{
+    m_now = 0ms;
+    model.SetClock([this]() { return m_now; });
+
+    FileSystemInfoList fsInfos;
+    fsInfos.push_back(FileSystemInfo("alpha", "/srv/tv",        true,  1, -1, 4096,
+                                     1000000, 400000));
+    fsInfos.push_back(FileSystemInfo("alpha", "/srv/tv/livetv", true,  1, -1, 4096,
+                                     1000000, 400000));
+    fsInfos.push_back(FileSystemInfo("beta",  "/srv/tv",        false, 2, -1, 4096,
+                                     2000000, 1500000));
+    model.SetFilesystems(fsInfos);
+}
+
+void TestDiskSpaceModel::test_empty(void)
+{
+    DiskSpaceModel model;
+    QVERIFY(model.IsEmpty());
+    QCOMPARE(model.GetFreeSpace(1), INT64_C(-1));
+    QCOMPARE(model.FindFilesystem("alpha", "/srv/tv"), -1);
+    QVERIFY(model.GetFilesystems().empty());
+}
+
+void TestDiskSpaceModel::test_scan(void)
+{
+    DiskSpaceModel model;
+    SetUp(model);
+
+    QVERIFY(!model.IsEmpty());
+    QCOMPARE(model.GetFreeSpace(1), INT64_C(600000));
+    QCOMPARE(model.GetFreeSpace(2), INT64_C(500000));
+    QCOMPARE(model.GetFreeSpace(3), INT64_C(-1));
+    QCOMPARE(model.GetFilesystems().size(), 3);
+}
+
+void TestDiskSpaceModel::test_writeRate(void)
+{
+    DiskSpaceModel model;
+    SetUp(model);
+
+    // Nothing is written until a recorder is using the filesystem
+    m_now = 10min;
+    QCOMPARE(model.GetFreeSpace(1), INT64_C(600000));
+
+    model.SetWriteRate(1, 6000);
+    m_now = 15min;
+    QCOMPARE(model.GetFreeSpace(1), INT64_C(570000));
+    QCOMPARE(model.GetFreeSpace(2), INT64_C(500000));
+
+    // A change of rate keeps what was written so far
+    model.SetWriteRate(1, 1000);
+    m_now = 25min;
+    QCOMPARE(model.GetFreeSpace(1), INT64_C(560000));
+
+    // All directories on the filesystem see the estimate
+    for (const auto &fs : model.GetFilesystems())
+    {
+        if (fs.getFSysID() == 1)
+            QCOMPARE(fs.getFreeSpace(), INT64_C(560000));
+    }
+
+    // The filesystem can't be more than full
+    model.SetWriteRate(1, 1000000);
+    m_now = 30min;
+    QCOMPARE(model.GetFreeSpace(1), INT64_C(0));
+}
+
+void TestDiskSpaceModel::test_freed(void)
+{
+    DiskSpaceModel model;
+    SetUp(model);
+
+    model.AddFreed(2, 250000);
+    QCOMPARE(model.GetFreeSpace(2), INT64_C(750000));
+
+    // Unknown filesystems and negative sizes are ignored
+    model.AddFreed(3, 1000);
+    model.AddFreed(2, -1000);
+    QCOMPARE(model.GetFreeSpace(2), INT64_C(750000));
+
+    // Space can't be freed beyond what the filesystem holds
+    model.AddFreed(2, 5000000);
+    QCOMPARE(model.GetFreeSpace(2), INT64_C(2000000));
+}
+
+void TestDiskSpaceModel::test_rescan(void)
+{
+    DiskSpaceModel model;
+    SetUp(model);
+
+    model.SetWriteRate(1, 6000);
+    model.AddFreed(1, 50000);
+    m_now = 10min;
+    QCOMPARE(model.GetFreeSpace(1), INT64_C(590000));
+
+    // The scan replaces the estimate, but the recorders keep writing
+    FileSystemInfoList fsInfos;
+    fsInfos.push_back(FileSystemInfo("alpha", "/srv/tv", true, 1, -1, 4096,
+                                     1000000, 420000));
+    model.SetFilesystems(fsInfos);
+    QCOMPARE(model.GetFreeSpace(1), INT64_C(580000));
+    QCOMPARE(model.GetFreeSpace(2), INT64_C(-1));
+
+    m_now = 11min;
+    QCOMPARE(model.GetFreeSpace(1), INT64_C(574000));
+}
+
+void TestDiskSpaceModel::test_findFilesystem(void)
+{
+    DiskSpaceModel model;
+    SetUp(model);
+
+    QCOMPARE(model.FindFilesystem("alpha", "/srv/tv"), 1);
+    QCOMPARE(model.FindFilesystem("alpha", "/srv/tv/livetv"), 1);
+    QCOMPARE(model.FindFilesystem("alpha", "/srv/tv/2024"), 1);
+    QCOMPARE(model.FindFilesystem("beta",  "/srv/tv"), 2);
+    QCOMPARE(model.FindFilesystem("beta",  "/srv/tvshows"), -1);
+    QCOMPARE(model.FindFilesystem("gamma", "/srv/tv"), -1);
+}
+
+void TestDiskSpaceModel::test_invalid(void)
+{
+    DiskSpaceModel model;
+    m_now = 0ms;
+    model.SetClock([this]() { return m_now; });
+
+    // AutoExpire looks for the -1 a failed statfs leaves behind
+    FileSystemInfoList fsInfos;
+    fsInfos.push_back(FileSystemInfo("alpha", "/srv/tv", true, 1, -1, 4096,
+                                     -1, -1));
+    model.SetFilesystems(fsInfos);
+    model.SetWriteRate(1, 6000);
+    m_now = 10min;
+
+    QCOMPARE(model.GetFreeSpace(1), INT64_C(-1));
+    FileSystemInfoList result = model.GetFilesystems();
+    QCOMPARE(result.size(), 1);
+    QCOMPARE(result[0].getUsedSpace(), INT64_C(-1));
+    QCOMPARE(result[0].getTotalSpace(), INT64_C(-1));
+}
+
+QTEST_APPLESS_MAIN(TestDiskSpaceModel)
@@ -0,0 +1,46 @@
+/*
+ *  Class TestDiskSpaceModel
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#ifndef MYTHBACKEND_TEST_DISKSPACEMODEL_H
+#define MYTHBACKEND_TEST_DISKSPACEMODEL_H
+
+#include <chrono>
+
+#include <QTest>
+
+#include "diskspacemodel.h"
+
+class TestDiskSpaceModel : public QObject
+{
+    Q_OBJECT
+
+  private:
+    void SetUp(DiskSpaceModel &model);
+
+    std::chrono::milliseconds m_now {0};
+
+  private slots:
+    static void test_empty(void);
+    void test_scan(void);
+    void test_writeRate(void);
+    void test_freed(void);
+    void test_rescan(void);
+    void test_findFilesystem(void);
+    void test_invalid(void);
+};
+
+#endif // MYTHBACKEND_TEST_DISKSPACEMODEL_H
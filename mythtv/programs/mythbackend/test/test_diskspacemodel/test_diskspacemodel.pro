@@ -0,0 +1,27 @@
+include ( ../../../../settings.pro )
+include ( ../../../../test.pro )
+
+QT += testlib
+
+TEMPLATE = app
+TARGET = test_diskspacemodel
+DEPENDPATH += . ../..
+INCLUDEPATH += . ../..
+INCLUDEPATH += ../../../../libs
+
+LIBS += ../../obj/diskspacemodel.o
+
+LIBS += -L../../../../libs/libmythbase -lmythbase-$$LIBVERSION
+QMAKE_LFLAGS += -Wl,$$_RPATH_$(PWD)/../../../../libs/libmythbase
+
+# Input
+HEADERS += test_diskspacemodel.h
+SOURCES += test_diskspacemodel.cpp
+
+QMAKE_CLEAN += $(TARGET)
+QMAKE_CLEAN += ; ( cd $(OBJECTS_DIR) && rm -f *.gcov *.gcda *.gcno )
+
+LIBS += $$EXTRA_LIBS $$LATE_LIBS
+
+# Fix runtime linking
+linux:QMAKE_LFLAGS += -Wl,--disable-new-dtags
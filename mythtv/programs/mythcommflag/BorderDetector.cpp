@@ -10,6 +10,7 @@ extern "C" {
 #include "libmythbase/mythchrono.h"
 #include "libmythbase/mythcorecontext.h"
 #include "libmythbase/mythlogging.h"
+#include "libmythtv/borderscanner.h"
 
 // Commercial Flagging headers
 #include "BorderDetector.h"
@@ -132,10 +133,61 @@ BorderDetector::getDimensionsReal(const AVFrame *pgm, int pgmheight,
     bool bottom = false;
     bool monochromatic = false;
 
+    /*
+     * Most rows and columns checked are either entirely bar or content, so
+     * find their range with the vector kernels first. A line whose samples
+     * all fit within kMaxRange of the bar so far can have no outliers, and is
+     * taken as is; anything else (or anything crossing the logo) goes through
+     * the per pixel check, so the result is the same either way.
+     */
+    auto takeRange = [&](int linemin, int linemax, uchar &minval, uchar &maxval)
+    {
+        if (std::max<int>(maxval, linemax) - std::min<int>(minval, linemin) + 1 > kMaxRange)
+            return false;
+        minval = std::min<uchar>(minval, linemin);
+        maxval = std::max<uchar>(maxval, linemax);
+        return true;
+    };
+
+    auto rowInRange = [&](int rr, uchar &minval, uchar &maxval)
+    {
+        if (m_logo && rr >= m_logoRow && rr < m_logoRow + m_logoHeight)
+            return false;
+        BorderLineStats stats = BorderScanner::LineStats(
+            pgm->data[0] + (rr * pgmwidth) + mincol, maxcol1 - mincol);
+        if (stats.m_count < 1)
+            return true;
+        return takeRange(stats.m_min, stats.m_max, minval, maxval);
+    };
+
+    m_colMin.resize(pgmwidth);
+    m_colMax.resize(pgmwidth);
+    auto colInRange = [&](int cc, uchar &minval, uchar &maxval)
+    {
+        if (m_logo && cc >= m_logoCol && cc < m_logoCol + m_logoWidth)
+            return false;
+        if (minrow >= maxrow1)
+            return true;
+        size_t block = cc / kColumnBlock;
+        if (!m_colBlockDone[block])
+        {
+            int first = static_cast<int>(block) * kColumnBlock;
+            BorderScanner::ColumnMinMax(pgm->data[0] + (minrow * pgmwidth) + first,
+                                        pgmwidth, maxrow1 - minrow,
+                                        std::min(kColumnBlock, pgmwidth - first),
+                                        &m_colMin[first], &m_colMax[first]);
+            m_colBlockDone[block] = true;
+        }
+        return takeRange(m_colMin[cc], m_colMax[cc], minval, maxval);
+    };
+
     try
     {
         for (;;)
         {
+            /* Rows to check may have changed since the last pass. */
+            m_colBlockDone.assign((pgmwidth + kColumnBlock - 1) / kColumnBlock, false);
+
             /* Find left edge. */
             bool left = false;
             uchar minval = UCHAR_MAX;
@@ -145,6 +197,12 @@ BorderDetector::getDimensionsReal(const AVFrame *pgm, int pgmheight,
             bool found = false;
             for (int cc = mincol; !found && cc < maxcol1; cc++)
             {
+                if (colInRange(cc, minval, maxval))
+                {
+                    saved = cc;
+                    lines = 0;
+                    continue;
+                }
                 int outliers = 0;
                 bool inrange = true;
                 for (int rr = minrow; rr < maxrow1; rr++)
@@ -195,6 +253,12 @@ BorderDetector::getDimensionsReal(const AVFrame *pgm, int pgmheight,
             found = false;
             for (int cc = maxcol1 - 1; !found && cc >= mincol; cc--)
             {
+                if (colInRange(cc, minval, maxval))
+                {
+                    saved = cc;
+                    lines = 0;
+                    continue;
+                }
                 int outliers = 0;
                 bool inrange = true;
                 for (int rr = minrow; rr < maxrow1; rr++)
@@ -246,6 +310,12 @@ BorderDetector::getDimensionsReal(const AVFrame *pgm, int pgmheight,
             found = false;
             for (int rr = minrow; !found && rr < maxrow1; rr++)
             {
+                if (rowInRange(rr, minval, maxval))
+                {
+                    saved = rr;
+                    lines = 0;
+                    continue;
+                }
                 int outliers = 0;
                 bool inrange = true;
                 for (int cc = mincol; cc < maxcol1; cc++)
@@ -293,6 +363,12 @@ BorderDetector::getDimensionsReal(const AVFrame *pgm, int pgmheight,
             found = true;
             for (int rr = maxrow1 - 1; !found && rr >= minrow; rr--)
             {
+                if (rowInRange(rr, minval, maxval))
+                {
+                    saved = rr;
+                    lines = 0;
+                    continue;
+                }
                 int outliers = 0;
                 bool inrange = true;
                 for (int cc = mincol; cc < maxcol1; cc++)
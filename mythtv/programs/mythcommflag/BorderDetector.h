@@ -12,6 +12,9 @@
 #ifndef BORDERDETECTOR_H
 #define BORDERDETECTOR_H
 
+#include <cstdint>
+#include <vector>
+
 using AVFrame = struct AVFrame;
 class MythPlayer;
 class TemplateFinder;
@@ -47,6 +50,12 @@ private:
     int                     m_height          {-1}; /* content dimensions */
     bool                    m_isMonochromatic {false};
 
+    /* Column ranges, filled in blocks of kColumnBlock as the scan needs them. */
+    static constexpr int    kColumnBlock      {16};
+    std::vector<uint8_t>    m_colMin;
+    std::vector<uint8_t>    m_colMax;
+    std::vector<bool>       m_colBlockDone;
+
     /* Debugging. */
     int                     m_debugLevel      {0};
     std::chrono::microseconds m_analyzeTime   {0us};
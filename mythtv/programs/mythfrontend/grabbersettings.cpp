@@ -11,6 +11,7 @@
 #include "libmythbase/mythlogging.h"
 #include "libmythbase/mythsystemlegacy.h"
 #include "libmythmetadata/metadatacommon.h"
+#include "libmythmetadata/metadatagrabber.h"
 #include "libmythui/mythprogressdialog.h"
 
 // MythFrontend
@@ -143,6 +144,9 @@ void GrabberSettings::slotSave(void)
     gCoreContext->SaveSettingOnHost("DailyArtworkUpdates",
                                     QString::number(dailyupdatestate), "");
 
+    // Don't answer lookups from what the old grabbers said
+    MetaGrabberScript::ClearCache();
+
     Close();
 }
 
@@ -0,0 +1,230 @@
+// C/C++
+#include <algorithm>
+#include <map>
+#include <utility>
+
+// Qt
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+// MythTV
+#include "libmythbase/mythcorecontext.h"
+#include "libmythbase/mythdate.h"
+#include "libmythbase/mythdbcon.h"
+#include "libmythbase/mythevent.h"
+#include "libmythbase/mythlogging.h"
+
+// MythFrontend
+#include "guidedatacache.h"
+
+#define LOC QString("GuideDataCache: ")
+
+GuideDataCache *GuideDataCache::GetCache(void)
+{
+    static GuideDataCache *s_cache = nullptr;
+    if (!s_cache)
+        s_cache = new GuideDataCache(QCoreApplication::instance());
+    return s_cache;
+}
+
+GuideDataCache::GuideDataCache(QObject *parent)
+  : QObject(parent)
+{
+    gCoreContext->addListener(this);
+}
+
+GuideDataCache::~GuideDataCache()
+{
+    if (gCoreContext)
+        gCoreContext->removeListener(this);
+
+    LOG(VB_GUI, LOG_INFO, LOC + GetStats());
+}
+
+/** \fn GuideDataCache::Load(ProgramList&, uint, const QDateTime&, const QDateTime&, const ProgramList&)
+ *  \brief Fill destination with the programs on chanid that overlap
+ *         start to end, in start time order.
+ *
+ *  Gives the same results as querying the program table directly, but
+ *  only the hours missing from the cache are read from the database.
+ */
+void GuideDataCache::Load(ProgramList &destination, uint chanid,
+                          const QDateTime &start, const QDateTime &end,
+                          const ProgramList &schedList)
+{
+    destination.clear();
+
+    std::vector<Bucket> buckets =
+        GetBuckets(chanid, HourOf(start), HourOf(end), schedList, false);
+
+    // A program spanning several hours is in the bucket for each of them,
+    // so collect them by start time to drop the duplicates.
+    QDateTime startLimit = start.addDays(-1);
+    std::map<std::pair<QDateTime, QString>, ProgramPtr> programs;
+    for (const auto & bucket : buckets)
+    {
+        for (const auto & program : bucket)
+        {
+            QDateTime progStart = program->GetScheduledStartTime();
+            if (program->GetScheduledEndTime() >= start &&
+                progStart <= end && progStart >= startLimit)
+            {
+                programs.try_emplace({progStart, program->GetTitle()},
+                                     program);
+            }
+        }
+    }
+
+    for (const auto & program : programs)
+        destination.push_back(new ProgramInfo(*program.second));
+}
+
+/// \brief Make sure the programs on chanid for start to end are cached.
+void GuideDataCache::Prefetch(uint chanid,
+                              const QDateTime &start, const QDateTime &end,
+                              const ProgramList &schedList)
+{
+    GetBuckets(chanid, HourOf(start), HourOf(end), schedList, true);
+}
+
+void GuideDataCache::Clear(void)
+{
+    QMutexLocker locker(&m_lock);
+    m_buckets.clear();
+    ++m_generation;
+}
+
+QString GuideDataCache::GetStats(void) const
+{
+    QMutexLocker locker(&m_lock);
+    uint64_t lookups = m_hits + m_misses;
+    return QString("%1 of %2 hour lookups cached (%3%), "
+                   "%4 database fills (%5 prefetched) averaging %6 ms")
+        .arg(m_hits).arg(lookups)
+        .arg(lookups ? (m_hits * 100 / lookups) : 0)
+        .arg(m_fills).arg(m_prefetches)
+        .arg(m_fills ? (m_fillTimeMs / static_cast<int64_t>(m_fills)) : 0);
+}
+
+void GuideDataCache::customEvent(QEvent *event)
+{
+    if (event->type() != MythEvent::kMythEventMessage)
+        return;
+
+    auto *me = dynamic_cast<MythEvent *>(event);
+    if (me == nullptr)
+        return;
+
+    const QString& message = me->Message();
+    if (message == "SCHEDULE_CHANGE" ||
+        message.startsWith("SYSTEM_EVENT MYTHFILLDATABASE_RAN"))
+    {
+        LOG(VB_GUI, LOG_DEBUG, LOC + QString("%1, flushing").arg(message));
+        Clear();
+    }
+}
+
+std::vector<GuideDataCache::Bucket> GuideDataCache::GetBuckets(
+    uint chanid, qint64 firstHour, qint64 lastHour,
+    const ProgramList &schedList, bool isPrefetch)
+{
+    std::vector<Bucket> buckets;
+    qint64 firstMissing = -1;
+    qint64 lastMissing  = -1;
+    uint   generation   = 0;
+
+    {
+        QMutexLocker locker(&m_lock);
+        for (qint64 hour = firstHour; hour <= lastHour; hour += kHour)
+        {
+            Bucket *bucket = m_buckets.object({chanid, hour});
+            if (bucket)
+            {
+                buckets.push_back(*bucket);
+                if (!isPrefetch)
+                    ++m_hits;
+                continue;
+            }
+            buckets.emplace_back();
+            if (firstMissing < 0)
+                firstMissing = hour;
+            lastMissing = hour;
+            if (!isPrefetch)
+                ++m_misses;
+        }
+        generation = m_generation;
+    }
+
+    if (firstMissing < 0)
+        return buckets;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<Bucket> fetched;
+    if (!Query(chanid, firstMissing, lastMissing, schedList, fetched))
+        return buckets;
+
+    QMutexLocker locker(&m_lock);
+    ++m_fills;
+    if (isPrefetch)
+        ++m_prefetches;
+    m_fillTimeMs += timer.elapsed();
+
+    // Don't cache anything read before the last flush, the recording
+    // status merged into it may already be out of date.
+    bool current = (generation == m_generation);
+    for (size_t i = 0; i < fetched.size(); ++i)
+    {
+        qint64 hour = firstMissing + (static_cast<qint64>(i) * kHour);
+        if (current)
+            m_buckets.insert({chanid, hour}, new Bucket(fetched[i]));
+        buckets[(hour - firstHour) / kHour] = std::move(fetched[i]);
+    }
+
+    return buckets;
+}
+
+bool GuideDataCache::Query(uint chanid, qint64 firstHour, qint64 lastHour,
+                           const ProgramList &schedList,
+                           std::vector<Bucket> &buckets)
+{
+    MSqlBindings bindings;
+    QString querystr = "WHERE program.chanid = :CHANID "
+                       "  AND program.endtime >= :STARTTS "
+                       "  AND program.starttime <= :ENDTS "
+                       "  AND program.starttime >= :STARTLIMITTS "
+                       "  AND program.manualid = 0 ";
+    QDateTime starttime = MythDate::fromSecsSinceEpoch(firstHour);
+    bindings[":CHANID"]  = chanid;
+    bindings[":STARTTS"] = starttime;
+    bindings[":STARTLIMITTS"] = starttime.addDays(-1);
+    bindings[":ENDTS"] = MythDate::fromSecsSinceEpoch(lastHour + kHour);
+
+    ProgramList proglist;
+    if (!LoadFromProgram(proglist, querystr, bindings, schedList,
+                         ProgGroupBy::ChanNum))
+    {
+        return false;
+    }
+
+    buckets.assign(((lastHour - firstHour) / kHour) + 1, Bucket());
+    for (auto *program : proglist)
+    {
+        auto shared = std::make_shared<const ProgramInfo>(*program);
+        qint64 first =
+            std::max(firstHour, HourOf(program->GetScheduledStartTime()));
+        qint64 last =
+            std::min(lastHour, HourOf(program->GetScheduledEndTime()));
+        for (qint64 hour = first; hour <= last; hour += kHour)
+            buckets[(hour - firstHour) / kHour].push_back(shared);
+    }
+
+    return true;
+}
+
+qint64 GuideDataCache::HourOf(const QDateTime &time)
+{
+    qint64 secs = time.toSecsSinceEpoch();
+    return secs - (secs % kHour);
+}
@@ -0,0 +1,85 @@
+// -*- Mode: c++ -*-
+#ifndef GUIDEDATACACHE_H_
+#define GUIDEDATACACHE_H_
+
+// C++
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Qt
+#include <QCache>
+#include <QDateTime>
+#include <QMutex>
+#include <QObject>
+#include <QPair>
+#include <QString>
+
+// MythTV
+#include "libmythtv/programinfo.h"
+
+/** \class GuideDataCache
+ *  \brief Frontend wide cache of program guide listings.
+ *
+ *  Listings are held in one hour buckets per channel, so scrolling the
+ *  guide a page or a few columns only queries the database for the hours
+ *  and channels that have not been seen before.  Each miss fetches every
+ *  missing hour of the channel with a single query.
+ *
+ *  The cached ProgramInfo objects include the recording status merged in
+ *  from the scheduler, so the cache is flushed whenever the schedule or
+ *  the guide data changes.  It is shared by every GuideGrid and lives
+ *  for the lifetime of the application.
+ */
+class GuideDataCache : public QObject
+{
+    Q_OBJECT
+
+  public:
+    // Must first be called from the UI thread.
+    static GuideDataCache *GetCache(void);
+
+    void Load(ProgramList &destination, uint chanid,
+              const QDateTime &start, const QDateTime &end,
+              const ProgramList &schedList);
+    void Prefetch(uint chanid, const QDateTime &start, const QDateTime &end,
+                  const ProgramList &schedList);
+    void Clear(void);
+
+    QString GetStats(void) const;
+
+  protected:
+    void customEvent(QEvent *event) override; // QObject
+
+  private:
+    explicit GuideDataCache(QObject *parent);
+    ~GuideDataCache() override;
+
+    using ProgramPtr = std::shared_ptr<const ProgramInfo>;
+    using Bucket     = std::vector<ProgramPtr>;
+    using BucketKey  = QPair<uint, qint64>; // chanid, start of the hour
+
+    std::vector<Bucket> GetBuckets(uint chanid, qint64 firstHour,
+                                   qint64 lastHour,
+                                   const ProgramList &schedList,
+                                   bool isPrefetch);
+    static bool Query(uint chanid, qint64 firstHour, qint64 lastHour,
+                      const ProgramList &schedList,
+                      std::vector<Bucket> &buckets);
+    static qint64 HourOf(const QDateTime &time);
+
+    static constexpr qint64 kHour       { 60LL * 60 };
+    static constexpr int    kMaxBuckets { 50000 };
+
+    mutable QMutex              m_lock;
+    QCache<BucketKey, Bucket>   m_buckets    {kMaxBuckets};
+    uint                        m_generation {0};
+
+    uint64_t                    m_hits       {0};
+    uint64_t                    m_misses     {0};
+    uint64_t                    m_fills      {0};
+    uint64_t                    m_prefetches {0};
+    int64_t                     m_fillTimeMs {0};
+};
+
+#endif // GUIDEDATACACHE_H_
@@ -6,6 +6,7 @@
 // Qt
 #include <QCoreApplication>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QKeyEvent>
 
 // MythTV
@@ -42,6 +43,7 @@
 #include "libmythui/mythuiutils.h"          // for UIUtilW, UIUtilE
 
 // MythFrontend
+#include "guidedatacache.h"
 #include "guidegrid.h"
 #include "progfind.h"
 
@@ -260,7 +262,10 @@ public:
           m_verticalLayout(gs.m_verticalLayout),
           m_firstTime(gs.m_firstTime),
           m_lastTime(gs.m_lastTime),
-          m_proglists(std::move(proglists)) {}
+          m_proglists(std::move(proglists))
+    {
+        m_timer.start();
+    }
     ~GuideUpdateProgramRow() override = default;
     bool ExecuteNonUI(void) override // GuideUpdaterBase
     {
@@ -290,6 +295,7 @@ public:
         m_guide->updateProgramsUI(m_firstRow, m_numRows,
                                   m_progPast, m_proglists,
                                   m_programInfos, m_result);
+        m_guide->addFillTime(std::chrono::milliseconds(m_timer.elapsed()));
     }
 
 private:
@@ -316,6 +322,38 @@ private:
     ProgInfoGuideArray m_programInfos {};
     int m_progPast {0};
     std::list<GuideUIElement> m_result;
+    QElapsedTimer m_timer;
+};
+
+struct GuidePrefetchJob
+{
+    uint      m_chanId;
+    QDateTime m_start;
+    QDateTime m_end;
+};
+
+class GuidePrefetch : public GuideUpdaterBase
+{
+public:
+    GuidePrefetch(GuideGrid *guide, uint generation,
+                  std::vector<GuidePrefetchJob> jobs)
+        : GuideUpdaterBase(guide), m_generation(generation),
+          m_jobs(std::move(jobs)) {}
+    bool ExecuteNonUI(void) override // GuideUpdaterBase
+    {
+        for (const auto & job : m_jobs)
+        {
+            if (m_generation != m_guide->GetPrefetchGeneration())
+                break;
+            m_guide->prefetchPrograms(job.m_chanId, job.m_start, job.m_end);
+        }
+        // Nothing to show, the listings are now in the GuideDataCache.
+        return false;
+    }
+    void ExecuteUI(void) override {} // GuideUpdaterBase
+private:
+    const uint m_generation;
+    const std::vector<GuidePrefetchJob> m_jobs;
 };
 
 class GuideUpdateChannels : public GuideUpdaterBase
@@ -497,6 +535,7 @@ GuideGrid::GuideGrid(MythScreenStack *parent,
     m_channelOrdering(gCoreContext->GetSetting("ChannelOrdering", "channum")),
     m_updateTimer(new QTimer(this)),
     m_threadPool("GuideGridHelperPool"),
+    m_dataCache(GuideDataCache::GetCache()),
     m_changrpid(changrpid),
     m_changrplist(ChannelGroup::GetChannelGroups(false)),
     m_channelGroupListManual(ChannelGroup::GetManualChannelGroups(true))
@@ -633,10 +672,16 @@ GuideGrid::~GuideGrid()
     m_updateTimer->disconnect(this);
     m_updateTimer = nullptr;
 
+    ++m_prefetchGeneration;
     GuideHelper::Wait(this);
 
     gCoreContext->removeListener(this);
 
+    LOG(VB_GUI, LOG_INFO, LOC + QString("%1 row fills averaging %2 ms, %3")
+        .arg(m_fillCount)
+        .arg(m_fillCount ? m_fillTime.count() / m_fillCount : 0)
+        .arg(m_dataCache->GetStats()));
+
     while (!m_programs.empty())
     {
         if (m_programs.back())
@@ -1571,25 +1616,71 @@ ProgramList *GuideGrid::getProgramListFromProgram(int chanNum)
 
     if (proglist)
     {
-        MSqlBindings bindings;
-        QString querystr = "WHERE program.chanid = :CHANID "
-                           "  AND program.endtime >= :STARTTS "
-                           "  AND program.starttime <= :ENDTS "
-                           "  AND program.starttime >= :STARTLIMITTS "
-                           "  AND program.manualid = 0 ";
         QDateTime starttime = m_currentStartTime.addSecs(0 - m_currentStartTime.time().second());
-        bindings[":CHANID"]  = GetChannelInfo(chanNum)->m_chanId;
-        bindings[":STARTTS"] = starttime;
-        bindings[":STARTLIMITTS"] = starttime.addDays(-1);
-        bindings[":ENDTS"] = m_currentEndTime.addSecs(0 - m_currentEndTime.time().second());
+        QDateTime endtime = m_currentEndTime.addSecs(0 - m_currentEndTime.time().second());
 
-        LoadFromProgram(*proglist, querystr, bindings, m_recList,
-                        ProgGroupBy::ChanNum);
+        m_dataCache->Load(*proglist, GetChannelInfo(chanNum)->m_chanId,
+                          starttime, endtime, m_recList);
     }
 
     return proglist;
 }
 
+void GuideGrid::prefetchPrograms(uint chanid, const QDateTime &start,
+                                 const QDateTime &end)
+{
+    m_dataCache->Prefetch(chanid, start, end, m_recList);
+}
+
+void GuideGrid::addFillTime(std::chrono::milliseconds elapsed)
+{
+    ++m_fillCount;
+    m_fillTime += elapsed;
+    LOG(VB_GUI, LOG_DEBUG, LOC +
+        QString("Filled guide rows in %1 ms").arg(elapsed.count()));
+}
+
+/** \brief Warm the GuideDataCache for the places the guide is most
+ *         likely to move to next: the following and preceding time
+ *         windows and pages of channels.
+ */
+void GuideGrid::queuePrefetch(void)
+{
+    uint generation = ++m_prefetchGeneration;
+    int rows = m_guideGrid->getChannelCount();
+    int channels = m_channelInfos.size();
+    if (rows <= 0 || channels <= 0)
+        return;
+
+    QDateTime start = m_currentStartTime.addSecs(0 - m_currentStartTime.time().second());
+    QDateTime end = m_currentEndTime.addSecs(0 - m_currentEndTime.time().second());
+    qint64 span = start.secsTo(end);
+
+    std::vector<GuidePrefetchJob> jobs;
+    auto addPage = [&](int offset, const QDateTime &pstart, const QDateTime &pend)
+    {
+        for (int row = 0; row < rows; ++row)
+        {
+            int chanNum = (static_cast<int>(m_currentStartChannel) + offset + row)
+                % channels;
+            if (chanNum < 0)
+                chanNum += channels;
+            const ChannelInfo *chinfo = GetChannelInfo(chanNum);
+            if (chinfo)
+                jobs.push_back({chinfo->m_chanId, pstart, pend});
+        }
+    };
+    addPage(0, end, end.addSecs(span));
+    addPage(rows, start, end);
+    addPage(-rows, start, end);
+    addPage(0, start.addSecs(-span), start);
+
+    // Lower priority runs after the row updates already queued.
+    m_threadPool.start(new GuideHelper(this, new GuidePrefetch(this, generation,
+                                                               std::move(jobs))),
+                       "GuidePrefetch", 1);
+}
+
 void GuideGrid::fillProgramRowInfos(int firstRow, bool useExistingData)
 {
     bool allRows = false;
@@ -1654,6 +1745,9 @@ void GuideGrid::fillProgramRowInfos(int firstRow, bool useExistingData)
     auto *updater = new GuideUpdateProgramRow(this, gs, proglists);
     if (updater)
         m_threadPool.start(new GuideHelper(this, updater), "GuideHelper");
+
+    if (allRows)
+        queuePrefetch();
 }
 
 void GuideUpdateProgramRow::fillProgramRowInfosWith(int row,
@@ -1906,8 +2000,10 @@ void GuideGrid::customEvent(QEvent *event)
 
         if (message == "SCHEDULE_CHANGE")
         {
+            ++m_prefetchGeneration;
             GuideHelper::Wait(this);
             LoadFromScheduler(m_recList);
+            m_dataCache->Clear();
             fillProgramInfos();
         }
     }
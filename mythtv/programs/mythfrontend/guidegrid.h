@@ -3,6 +3,7 @@
 #define GUIDEGRID_H_
 
 // C++
+#include <atomic>
 #include <list>
 #include <utility>
 #include <vector>
@@ -24,6 +25,7 @@
 // MythFrontend
 #include "schedulecommon.h"
 
+class GuideDataCache;
 class ProgramInfo;
 class QTimer;
 class MythUIButtonList;
@@ -129,6 +131,8 @@ class GuideGrid : public ScheduleCommon, public JumpToChannelListener
     // skip the work if not.
     uint GetCurrentStartChannel(void) const { return m_currentStartChannel; }
     QDateTime GetCurrentStartTime(void) const { return m_currentStartTime; }
+    // Allow class GuidePrefetch to drop work that a newer prefetch replaces.
+    uint GetPrefetchGeneration(void) const { return m_prefetchGeneration; }
     int  FindChannel(uint chanid, const QString &channum,
                      bool exact = true) const override; // JumpToChannelListener
 
@@ -210,9 +214,13 @@ class GuideGrid : public ScheduleCommon, public JumpToChannelListener
     void fillProgramInfos(bool useExistingData = false);
     // Set row=-1 to fill all rows.
     void fillProgramRowInfos(int row, bool useExistingData);
+    void queuePrefetch(void);
 public:
     // These need to be public so that the helper classes can operate.
     ProgramList *getProgramListFromProgram(int chanNum);
+    void prefetchPrograms(uint chanid, const QDateTime &start,
+                          const QDateTime &end);
+    void addFillTime(std::chrono::milliseconds elapsed);
     void updateProgramsUI(unsigned int firstRow, unsigned int numRows,
                           int progPast,
                           const QVector<ProgramList*> &proglists,
@@ -276,6 +284,10 @@ private:
     QTimer *m_updateTimer                 {nullptr}; // audited ref #5318
 
     MThreadPool       m_threadPool;
+    GuideDataCache   *m_dataCache         {nullptr};
+    std::atomic<uint> m_prefetchGeneration {0};
+    uint              m_fillCount         {0};
+    std::chrono::milliseconds m_fillTime  {0ms};
 
     int               m_changrpid {-1};
     ChannelGroupList  m_changrplist;
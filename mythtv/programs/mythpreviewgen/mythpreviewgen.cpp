@@ -38,6 +38,7 @@
 #include "libmythtv/dbcheck.h"
 #include "libmythtv/mythsystemevent.h"
 #include "libmythtv/previewgenerator.h"
+#include "libmythtv/previewstripbuilder.h"
 #include "libmythtv/programinfo.h"
 
 //MythPreviewGen
@@ -112,6 +113,40 @@ int preview_helper(uint chanid, QDateTime starttime,
     return ok ? GENERIC_EXIT_OK : GENERIC_EXIT_NOT_OK;
 }
 
+static int preview_strip_helper(uint chanid, const QDateTime &starttime,
+                                const QString &infile)
+{
+    ProgramInfo *pginfo = nullptr;
+    if (chanid && starttime.isValid())
+    {
+        pginfo = new ProgramInfo(chanid, starttime);
+        if (!pginfo->GetChanID())
+        {
+            LOG(VB_GENERAL, LOG_ERR,
+                QString("Cannot locate recording made on '%1' at '%2'")
+                .arg(chanid).arg(starttime.toString(Qt::ISODate)));
+            delete pginfo;
+            return GENERIC_EXIT_NO_RECORDING_DATA;
+        }
+    }
+    else
+    {
+        pginfo = new ProgramInfo(infile);
+    }
+
+    // The strip is decoded from, and saved next to, the local file
+    QString filename = infile;
+    if (filename.isEmpty())
+        filename = pginfo->GetPlaybackURL(false, true);
+
+    PreviewStripBuilder builder(*pginfo, filename);
+    bool ok = builder.Run();
+
+    delete pginfo;
+
+    return ok ? GENERIC_EXIT_OK : GENERIC_EXIT_NO_RECORDING_DATA;
+}
+
 int main(int argc, char **argv)
 {
     MythPreviewGeneratorCommandLineParser cmdline;
@@ -176,6 +211,13 @@ int main(int argc, char **argv)
         return GENERIC_EXIT_NO_MYTHCONTEXT;
     }
 
+    if (cmdline.toBool("strip"))
+    {
+        return preview_strip_helper(
+            cmdline.toUInt("chanid"), cmdline.toDateTime("starttime"),
+            cmdline.toString("inputfile"));
+    }
+
     int ret = preview_helper(
         cmdline.toUInt("chanid"), cmdline.toDateTime("starttime"),
         cmdline.toLongLong("frame"), std::chrono::seconds(cmdline.toLongLong("seconds")),
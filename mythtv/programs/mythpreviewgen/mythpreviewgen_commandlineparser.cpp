@@ -20,6 +20,8 @@ void MythPreviewGeneratorCommandLineParser::LoadArguments(void)
     add("--size", "size", QSize(0,0), "Dimensions of preview image.", "");
     add("--infile", "inputfile", "", "Input video for preview generation.", "");
     add("--outfile", "outputfile", "", "Optional output file for preview generation.", "");
+    add("--strip", "strip", false, "Make the keyframe thumbnail strip used "
+        "for seek previews, rather than a single preview image.", "");
 }
 
 
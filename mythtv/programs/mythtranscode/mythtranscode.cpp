@@ -30,6 +30,7 @@
 // MythTranscode
 #include "mpeg2fix.h"
 #include "mythtranscode_commandlineparser.h"
+#include "smartcut.h"
 #include "transcode.h"
 
 static void CompleteJob(int jobID, ProgramInfo *pginfo, bool useCutlist,
@@ -629,6 +630,29 @@ int main(int argc, char *argv[])
             else
                 UpdatePositionMap(posMap, durMap, outfile + QString(".map"), pginfo);
         }
+        else if (!cmdline.toBool("ostream") && SmartCut::CanCut(infile))
+        {
+            // H.264 and HEVC are cut by re-encoding only the partial GOPs
+            // at each cut point, keeping the transport stream container.
+            SmartCut cutter(infile, outfile, deleteMap, update_func, check_func);
+            result = cutter.Start();
+            if (result == REENCODE_OK)
+            {
+                result = SmartCut::BuildKeyframeIndex(outfile, posMap, durMap);
+                if (result == REENCODE_OK)
+                {
+                    if (update_index)
+                        UpdatePositionMap(posMap, durMap, nullptr, pginfo);
+                    else
+                        UpdatePositionMap(posMap, durMap, outfile + QString(".map"),
+                                          pginfo);
+                }
+                RecordingInfo recInfo(*pginfo);
+                RecordingFile *recFile = recInfo.GetRecordingFile();
+                recFile->m_containerFormat = formatMPEG2_TS;
+                recFile->Save();
+            }
+        }
         else
         {
             result = m2f->Start();
@@ -0,0 +1,936 @@
+// C++
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+// Qt
+#include <QRunnable>
+#include <QThread>
+
+// MythTV
+#include "libmythbase/exitcodes.h"
+#include "libmythbase/mythlogging.h"
+#include "libmythtv/mythaverror.h"
+
+extern "C" {
+#include "libavutil/opt.h"
+}
+
+// MythTranscode
+#include "smartcut.h"
+#include "transcodedefs.h"
+
+#define LOC QString("SmartCut: ")
+
+class SmartCutEncodeJob : public QRunnable
+{
+  public:
+    SmartCutEncodeJob(SmartCut *parent, size_t segment)
+      : m_parent(parent), m_segment(segment) {}
+
+    void run(void) override
+    {
+        SmartCut::Segment &segment = m_parent->m_segments[m_segment];
+        bool ok = !m_parent->m_abort && m_parent->EncodeSegment(segment);
+
+        QMutexLocker locker(&m_parent->m_lock);
+        segment.m_ok   = ok;
+        segment.m_done = true;
+        m_parent->m_segmentDone.wakeAll();
+    }
+
+  private:
+    SmartCut *m_parent  {nullptr};
+    size_t    m_segment {0};
+};
+
+static AVCodecContext *OpenEncoder(const AVStream *stream, const AVFrame *frame,
+                                   AVRational frameRate)
+{
+    const AVCodec *codec = avcodec_find_encoder(stream->codecpar->codec_id);
+    if (!codec)
+        return nullptr;
+
+    AVCodecContext *enc = avcodec_alloc_context3(codec);
+    if (!enc)
+        return nullptr;
+
+    enc->width                  = frame->width;
+    enc->height                 = frame->height;
+    enc->pix_fmt                = static_cast<AVPixelFormat>(frame->format);
+    enc->sample_aspect_ratio    = frame->sample_aspect_ratio;
+    enc->color_range            = frame->color_range;
+    enc->color_primaries        = frame->color_primaries;
+    enc->color_trc              = frame->color_trc;
+    enc->colorspace             = frame->colorspace;
+    enc->chroma_sample_location = frame->chroma_location;
+    enc->time_base              = stream->time_base;
+    enc->framerate              = frameRate;
+
+    // A segment is at most one GOP long, so a single leading keyframe and
+    // no reordering. The parameter sets stay in band, which lets the new
+    // ones take over from the originals for just this segment.
+    enc->gop_size     = 1000;
+    enc->max_b_frames = 0;
+    enc->thread_count = 1;
+    av_opt_set(enc->priv_data, "crf", "18", 0);
+
+    if (frame->flags & AV_FRAME_FLAG_INTERLACED)
+    {
+        enc->flags |= AV_CODEC_FLAG_INTERLACED_DCT | AV_CODEC_FLAG_INTERLACED_ME;
+        enc->field_order = (frame->flags & AV_FRAME_FLAG_TOP_FIELD_FIRST) ?
+            AV_FIELD_TT : AV_FIELD_BB;
+    }
+
+    int ret = avcodec_open2(enc, codec, nullptr);
+    if (ret < 0)
+    {
+        std::string error;
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Couldn't open %1 encoder: %2")
+            .arg(codec->name).arg(av_make_error_stdstring(error, ret)));
+        avcodec_free_context(&enc);
+    }
+    return enc;
+}
+
+static bool EncodeFrame(AVCodecContext *enc, const AVFrame *frame,
+                        std::vector<AVPacket*> &packets)
+{
+    int ret = avcodec_send_frame(enc, frame);
+    if (ret < 0)
+    {
+        std::string error;
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Encoding failed: %1")
+            .arg(av_make_error_stdstring(error, ret)));
+        return false;
+    }
+
+    while (true)
+    {
+        AVPacket *pkt = av_packet_alloc();
+        if (!pkt)
+            return false;
+        ret = avcodec_receive_packet(enc, pkt);
+        if (ret < 0)
+        {
+            av_packet_free(&pkt);
+            return ret == AVERROR(EAGAIN) || ret == AVERROR_EOF;
+        }
+        packets.push_back(pkt);
+    }
+}
+
+SmartCut::SmartCut(QString inf, QString outf, const frm_dir_map_t &deleteMap,
+                   void (*update_func)(float), int (*check_func)())
+  : m_infile(std::move(inf)),
+    m_outfile(std::move(outf)),
+    m_deleteMap(deleteMap),
+    m_checkAbort(check_func),
+    m_updateStatus(update_func)
+{
+    m_pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount()));
+}
+
+SmartCut::~SmartCut()
+{
+    m_abort = true;
+    m_pool.waitForDone();
+    ReleaseSegments();
+    if (m_inputFC)
+        avformat_close_input(&m_inputFC);
+}
+
+/** \fn SmartCut::CanCut(const QString&)
+ *  \brief Returns true if file is an H.264 or HEVC transport stream that
+ *         this system has an encoder for.
+ */
+bool SmartCut::CanCut(const QString &file)
+{
+    AVFormatContext *context = OpenInput(file);
+    if (!context)
+        return false;
+
+    bool result = false;
+    int index = av_find_best_stream(context, AVMEDIA_TYPE_VIDEO, -1, -1,
+                                    nullptr, 0);
+    if (index >= 0 && strcmp(context->iformat->name, "mpegts") == 0)
+    {
+        AVCodecID codec = context->streams[index]->codecpar->codec_id;
+        if (codec == AV_CODEC_ID_H264 || codec == AV_CODEC_ID_HEVC)
+        {
+            result = avcodec_find_decoder(codec) && avcodec_find_encoder(codec);
+            if (!result)
+            {
+                LOG(VB_GENERAL, LOG_WARNING, LOC +
+                    QString("No %1 encoder available, can't smart cut")
+                        .arg(avcodec_get_name(codec)));
+            }
+        }
+    }
+
+    avformat_close_input(&context);
+    return result;
+}
+
+int SmartCut::Start(void)
+{
+    QElapsedTimer timer;
+    timer.start();
+    m_statusTime.start();
+
+    if (!Scan())
+        return m_abort ? REENCODE_STOPPED : REENCODE_ERROR;
+    if (!Plan())
+        return REENCODE_ERROR;
+
+    // The segments are encoded in the order they are needed, while the
+    // copy pass runs.
+    for (size_t i = 0; i < m_segments.size(); ++i)
+    {
+        if (!m_segments[i].m_copy)
+            m_pool.start(new SmartCutEncodeJob(this, i),
+                         QString("SmartCutEncode%1").arg(i));
+    }
+
+    int result = Mux();
+    if (result != REENCODE_OK)
+        m_abort = true;
+    m_pool.waitForDone();
+    ReleaseSegments();
+
+    if (result == REENCODE_OK)
+    {
+        LOG(VB_GENERAL, LOG_NOTICE, LOC + QString("Cut %1 in %2 seconds")
+            .arg(m_infile).arg(timer.elapsed() / 1000.0, 0, 'f', 1));
+    }
+    return result;
+}
+
+AVFormatContext *SmartCut::OpenInput(const QString &file)
+{
+    AVFormatContext *context = nullptr;
+    QByteArray name = file.toLocal8Bit();
+
+    int ret = avformat_open_input(&context, name.constData(), nullptr, nullptr);
+    if (ret < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Couldn't open input file, error #%1").arg(ret));
+        return nullptr;
+    }
+
+    ret = avformat_find_stream_info(context, nullptr);
+    if (ret < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Couldn't get stream info, error #%1").arg(ret));
+        avformat_close_input(&context);
+        return nullptr;
+    }
+    return context;
+}
+
+/// \brief Index every video packet, and find where each GOP starts.
+bool SmartCut::Scan(void)
+{
+    m_inputFC = OpenInput(m_infile);
+    if (!m_inputFC)
+        return false;
+
+    m_videoIndex = av_find_best_stream(m_inputFC, AVMEDIA_TYPE_VIDEO, -1, -1,
+                                       nullptr, 0);
+    if (m_videoIndex < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "No video stream found");
+        return false;
+    }
+
+    AVStream *video = m_inputFC->streams[m_videoIndex];
+    m_timeBase  = video->time_base;
+    m_frameRate = video->avg_frame_rate.num ? video->avg_frame_rate
+                                            : video->r_frame_rate;
+    m_fileSize  = avio_size(m_inputFC->pb);
+    m_audio.assign(m_inputFC->nb_streams, AudioTrack());
+
+    LOG(VB_GENERAL, LOG_INFO, LOC + QString("Scanning %1").arg(m_infile));
+
+    AVPacket *pkt = av_packet_alloc();
+    if (!pkt)
+        return false;
+
+    while (!m_abort && av_read_frame(m_inputFC, pkt) >= 0)
+    {
+        if (pkt->stream_index == m_videoIndex)
+        {
+            VideoPacket packet;
+            packet.m_pts = pkt->pts;
+            packet.m_dts = pkt->dts;
+            packet.m_pos = pkt->pos;
+            packet.m_key = (pkt->flags & AV_PKT_FLAG_KEY) != 0;
+            m_packets.push_back(packet);
+            if (m_packets.size() % 1000 == 0)
+                UpdateStatus();
+        }
+        av_packet_unref(pkt);
+    }
+    av_packet_free(&pkt);
+
+    if (m_abort)
+        return false;
+
+    // Frames before the first keyframe can't be decoded, so don't count.
+    size_t first = 0;
+    while (first < m_packets.size() &&
+           !(m_packets[first].m_key && m_packets[first].m_pts != AV_NOPTS_VALUE))
+        ++first;
+    if (first == m_packets.size())
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "No keyframes found");
+        return false;
+    }
+
+    int64_t startPts = m_packets[first].m_pts;
+    for (size_t i = first; i < m_packets.size(); ++i)
+    {
+        const VideoPacket &packet = m_packets[i];
+        if (packet.m_pts == AV_NOPTS_VALUE)
+        {
+            LOG(VB_GENERAL, LOG_ERR, LOC +
+                QString("Video packet %1 has no timestamp").arg(i));
+            return false;
+        }
+        if (packet.m_pts >= startPts)
+            m_framePts.push_back(packet.m_pts);
+        if (packet.m_dts != AV_NOPTS_VALUE)
+            m_delay = std::max(m_delay, packet.m_pts - packet.m_dts);
+    }
+    std::sort(m_framePts.begin(), m_framePts.end());
+
+    // A GOP is closed when nothing decoded after its keyframe is shown
+    // before it. In an open GOP those leading frames refer back to the GOP
+    // before, so copying from the keyframe has to drop them.
+    int keys = 0;
+    int closed = 0;
+    for (size_t i = first; i < m_packets.size(); ++i)
+    {
+        VideoPacket &key = m_packets[i];
+        if (!key.m_key)
+            continue;
+        key.m_lead = key.m_pts;
+        for (size_t j = i + 1; j < m_packets.size() && !m_packets[j].m_key; ++j)
+            key.m_lead = std::min(key.m_lead, m_packets[j].m_pts);
+        ++keys;
+        if (key.m_lead == key.m_pts)
+            ++closed;
+    }
+
+    if (!m_frameRate.num && m_framePts.size() > 1)
+    {
+        double seconds = (m_framePts.back() - m_framePts.front()) *
+            av_q2d(m_timeBase);
+        m_frameRate = av_d2q((m_framePts.size() - 1) / seconds, 100000);
+    }
+
+    LOG(VB_GENERAL, LOG_INFO, LOC +
+        QString("%1 frames, %2 keyframes of which %3 start a closed GOP")
+            .arg(m_framePts.size()).arg(keys).arg(closed));
+    return true;
+}
+
+/// \brief Split the kept sections into GOPs to copy and frames to encode.
+bool SmartCut::Plan(void)
+{
+    auto frames = static_cast<uint64_t>(m_framePts.size());
+    auto FramePts = [&](uint64_t frame)
+        { return frame < frames ? m_framePts[frame] : INT64_MAX; };
+
+    bool inCut = !m_deleteMap.isEmpty() &&
+                 m_deleteMap.first() == MARK_CUT_END;
+    uint64_t keepStart = 0;
+    int64_t  outPts = m_framePts.front();
+    auto AddRange = [&](uint64_t start, uint64_t end)
+    {
+        KeepRange range;
+        range.m_start  = FramePts(start);
+        range.m_end    = FramePts(end);
+        range.m_offset = range.m_start - outPts;
+        if (range.m_start >= range.m_end)
+            return;
+        if (range.m_end != INT64_MAX)
+            outPts += range.m_end - range.m_start;
+        m_ranges.push_back(range);
+    };
+
+    for (auto it = m_deleteMap.cbegin(); it != m_deleteMap.cend(); ++it)
+    {
+        if (*it == MARK_CUT_START && !inCut)
+        {
+            AddRange(keepStart, it.key());
+            inCut = true;
+        }
+        else if (*it == MARK_CUT_END && inCut)
+        {
+            keepStart = it.key();
+            inCut = false;
+        }
+    }
+    if (!inCut)
+        AddRange(keepStart, UINT64_MAX);
+
+    if (m_ranges.empty())
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "The cutlist leaves nothing to keep");
+        return false;
+    }
+
+    std::vector<size_t> keys;
+    for (size_t i = 0; i < m_packets.size(); ++i)
+        if (m_packets[i].m_lead != AV_NOPTS_VALUE)
+            keys.push_back(i);
+
+    auto FirstPacket = [&](int64_t pts)
+    {
+        size_t i = 0;
+        while (i < m_packets.size() && m_packets[i].m_pts < pts)
+            ++i;
+        return i;
+    };
+    auto AddEncode = [&](int64_t start, int64_t end, int range)
+    {
+        Segment segment;
+        segment.m_start       = start;
+        segment.m_end         = end;
+        segment.m_range       = range;
+        segment.m_firstPacket = FirstPacket(start);
+        m_segments.push_back(std::move(segment));
+    };
+
+    for (size_t r = 0; r < m_ranges.size(); ++r)
+    {
+        const KeepRange &range = m_ranges[r];
+        auto rangeIndex = static_cast<int>(r);
+        bool toEnd = (range.m_end == INT64_MAX);
+
+        auto first = std::lower_bound(keys.cbegin(), keys.cend(), range.m_start,
+            [this](size_t key, int64_t pts) { return m_packets[key].m_pts < pts; });
+        auto last = std::upper_bound(keys.cbegin(), keys.cend(), range.m_end,
+            [this](int64_t pts, size_t key) { return pts < m_packets[key].m_pts; });
+
+        // Copy from the first keyframe in the range up to the last one
+        // that starts inside it. The copy leaves out the leading frames of
+        // an open GOP at either end, which Mux() drops by their timestamps,
+        // and they are re-encoded with the frames around the copy instead.
+        size_t  copyEnd    = m_packets.size();
+        int64_t copyEndPts = INT64_MAX;
+        bool    copy       = (first != keys.cend());
+        if (copy && !toEnd)
+        {
+            copy = (last != keys.cbegin()) && (*(last - 1) > *first);
+            if (copy)
+            {
+                copyEnd    = *(last - 1);
+                copyEndPts = m_packets[copyEnd].m_lead;
+                copy       = copyEndPts > m_packets[*first].m_pts;
+            }
+        }
+
+        if (!copy)
+        {
+            AddEncode(range.m_start, range.m_end, rangeIndex);
+            continue;
+        }
+
+        int64_t copyStart = m_packets[*first].m_pts;
+        if (copyStart > range.m_start)
+            AddEncode(range.m_start, copyStart, rangeIndex);
+
+        Segment segment;
+        segment.m_copy        = true;
+        segment.m_start       = copyStart;
+        segment.m_end         = copyEndPts;
+        segment.m_range       = rangeIndex;
+        segment.m_firstPacket = *first;
+        segment.m_endPacket   = copyEnd;
+        m_segments.push_back(std::move(segment));
+
+        if (copyEndPts < range.m_end)
+            AddEncode(copyEndPts, range.m_end, rangeIndex);
+    }
+
+    int64_t encodeFrames = 0;
+    for (const auto &segment : m_segments)
+    {
+        if (segment.m_copy)
+            continue;
+        encodeFrames +=
+            std::lower_bound(m_framePts.cbegin(), m_framePts.cend(), segment.m_end) -
+            std::lower_bound(m_framePts.cbegin(), m_framePts.cend(), segment.m_start);
+    }
+
+    LOG(VB_GENERAL, LOG_INFO, LOC +
+        QString("Keeping %1 sections in %2 segments, re-encoding %3 of %4 frames")
+            .arg(m_ranges.size()).arg(m_segments.size())
+            .arg(encodeFrames).arg(frames));
+    return true;
+}
+
+/// \brief Decode and re-encode the frames of one segment, on a pool thread.
+bool SmartCut::EncodeSegment(Segment &segment)
+{
+    // Decode from the last keyframe at or before the segment start
+    int64_t seekPos = -1;
+    for (const auto &packet : m_packets)
+    {
+        if (packet.m_key && packet.m_pos >= 0 &&
+            packet.m_pts != AV_NOPTS_VALUE && packet.m_pts <= segment.m_start)
+        {
+            seekPos = packet.m_pos;
+        }
+    }
+
+    AVFormatContext *input = OpenInput(m_infile);
+    if (!input)
+        return false;
+
+    AVStream *stream = input->streams[m_videoIndex];
+    const AVCodec *decoder = avcodec_find_decoder(stream->codecpar->codec_id);
+    AVCodecContext *dec = decoder ? avcodec_alloc_context3(decoder) : nullptr;
+    if (!dec || avcodec_parameters_to_context(dec, stream->codecpar) < 0)
+    {
+        avcodec_free_context(&dec);
+        avformat_close_input(&input);
+        return false;
+    }
+    dec->pkt_timebase = stream->time_base;
+    dec->thread_count = 1;
+    if (avcodec_open2(dec, decoder, nullptr) < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Couldn't open video decoder");
+        avcodec_free_context(&dec);
+        avformat_close_input(&input);
+        return false;
+    }
+
+    if (seekPos >= 0)
+        av_seek_frame(input, m_videoIndex, seekPos, AVSEEK_FLAG_BYTE);
+
+    AVCodecContext *enc = nullptr;
+    AVPacket *pkt = av_packet_alloc();
+    AVFrame *frame = av_frame_alloc();
+    bool ok = pkt && frame;
+    bool eof = false;
+    bool finished = false;
+    int64_t count = 0;
+
+    while (ok && !finished && !m_abort)
+    {
+        if (!eof)
+        {
+            if (av_read_frame(input, pkt) < 0)
+            {
+                eof = true;
+                avcodec_send_packet(dec, nullptr);
+            }
+            else
+            {
+                bool isVideo = (pkt->stream_index == m_videoIndex);
+                if (isVideo)
+                    avcodec_send_packet(dec, pkt);
+                av_packet_unref(pkt);
+                if (!isVideo)
+                    continue;
+            }
+        }
+
+        while (ok && !finished)
+        {
+            int ret = avcodec_receive_frame(dec, frame);
+            if (ret == AVERROR(EAGAIN))
+                break;
+            if (ret < 0)
+            {
+                finished = true;
+                break;
+            }
+
+            int64_t pts = frame->best_effort_timestamp;
+            if (pts != AV_NOPTS_VALUE && pts >= segment.m_end)
+            {
+                finished = true;
+            }
+            else if (pts != AV_NOPTS_VALUE && pts >= segment.m_start)
+            {
+                if (!enc)
+                    enc = OpenEncoder(stream, frame, m_frameRate);
+                frame->pts       = pts;
+                frame->pict_type = count ? AV_PICTURE_TYPE_NONE
+                                         : AV_PICTURE_TYPE_I;
+                ok = enc && EncodeFrame(enc, frame, segment.m_packets);
+                ++count;
+            }
+            av_frame_unref(frame);
+        }
+    }
+
+    if (ok && enc)
+        ok = EncodeFrame(enc, nullptr, segment.m_packets);
+
+    auto expected =
+        std::lower_bound(m_framePts.cbegin(), m_framePts.cend(), segment.m_end) -
+        std::lower_bound(m_framePts.cbegin(), m_framePts.cend(), segment.m_start);
+    if (ok && count != expected)
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC +
+            QString("Re-encoded %1 of %2 frames from %3")
+                .arg(count).arg(expected).arg(segment.m_start));
+    }
+
+    av_frame_free(&frame);
+    av_packet_free(&pkt);
+    avcodec_free_context(&enc);
+    avcodec_free_context(&dec);
+    avformat_close_input(&input);
+    return ok && !m_abort;
+}
+
+/// \brief Copy the kept GOPs and audio, and splice in the encoded segments.
+int SmartCut::Mux(void)
+{
+    // Read the input again from the top, so the video packets come back in
+    // the same order as they were indexed.
+    avformat_close_input(&m_inputFC);
+    m_inputFC = OpenInput(m_infile);
+    if (!m_inputFC)
+        return REENCODE_ERROR;
+
+    AVFormatContext *output = nullptr;
+    QByteArray name = m_outfile.toLocal8Bit();
+    if (avformat_alloc_output_context2(&output, nullptr, "mpegts",
+                                       name.constData()) < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Couldn't create output context");
+        return REENCODE_ERROR;
+    }
+
+    for (uint i = 0; i < m_inputFC->nb_streams; ++i)
+    {
+        AVStream *in = m_inputFC->streams[i];
+        bool isVideo = (static_cast<int>(i) == m_videoIndex);
+        if (!isVideo && in->codecpar->codec_type != AVMEDIA_TYPE_AUDIO)
+            continue;
+
+        AVStream *out = avformat_new_stream(output, nullptr);
+        if (!out || avcodec_parameters_copy(out->codecpar, in->codecpar) < 0)
+        {
+            avformat_free_context(output);
+            return REENCODE_ERROR;
+        }
+        out->codecpar->codec_tag = 0;
+        out->time_base   = in->time_base;
+        out->disposition = in->disposition;
+        av_dict_copy(&out->metadata, in->metadata, 0);
+
+        if (isVideo)
+            m_videoOutput = out->index;
+        else
+            m_audio[i].m_output = out->index;
+    }
+
+    if (avio_open(&output->pb, name.constData(), AVIO_FLAG_WRITE) < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Couldn't open output file %1").arg(m_outfile));
+        avformat_free_context(output);
+        return REENCODE_ERROR;
+    }
+
+    bool ok = avformat_write_header(output, nullptr) >= 0;
+    AVPacket *pkt = av_packet_alloc();
+    ok = ok && pkt;
+
+    size_t segment = 0;
+    size_t index   = 0;
+    while (ok && !m_abort && av_read_frame(m_inputFC, pkt) >= 0)
+    {
+        if (pkt->stream_index == m_videoIndex)
+        {
+            // Write out anything due before this packet
+            while (ok && segment < m_segments.size())
+            {
+                Segment &current = m_segments[segment];
+                if (index < (current.m_copy ? current.m_endPacket
+                                            : current.m_firstPacket))
+                    break;
+                if (!current.m_copy)
+                    ok = WriteSegment(output, current);
+                ++segment;
+            }
+
+            if (ok && segment < m_segments.size())
+            {
+                const Segment &current = m_segments[segment];
+                if (current.m_copy && index >= current.m_firstPacket &&
+                    pkt->pts >= current.m_start && pkt->pts < current.m_end)
+                {
+                    ok = WriteVideo(output, pkt, current.m_range, false);
+                }
+            }
+
+            if (++index % 1000 == 0)
+                UpdateStatus();
+        }
+        else if (m_audio[pkt->stream_index].m_output >= 0)
+        {
+            ok = WriteAudio(output, pkt);
+        }
+        av_packet_unref(pkt);
+    }
+
+    for (; ok && !m_abort && segment < m_segments.size(); ++segment)
+    {
+        if (!m_segments[segment].m_copy)
+            ok = WriteSegment(output, m_segments[segment]);
+    }
+
+    av_packet_free(&pkt);
+    if (ok && !m_abort)
+        ok = av_write_trailer(output) >= 0;
+    avio_closep(&output->pb);
+    avformat_free_context(output);
+
+    if (m_abort)
+        return REENCODE_STOPPED;
+    return ok ? REENCODE_OK : REENCODE_ERROR;
+}
+
+void SmartCut::UpdateStatus(void)
+{
+    if (m_statusTime.elapsed() < 5000)
+        return;
+    m_statusTime.restart();
+
+    if (m_checkAbort && m_checkAbort())
+        m_abort = true;
+
+    if (m_updateStatus && m_fileSize > 0)
+    {
+        // Half for the scan, half for writing the output
+        float percent = 50.0F * avio_tell(m_inputFC->pb) / m_fileSize;
+        if (m_videoOutput >= 0)
+            percent += 50.0F;
+        m_updateStatus(percent);
+    }
+}
+
+bool SmartCut::WriteSegment(AVFormatContext *output, Segment &segment)
+{
+    {
+        QMutexLocker locker(&m_lock);
+        while (!segment.m_done)
+            m_segmentDone.wait(&m_lock);
+    }
+
+    if (!segment.m_ok)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC +
+            QString("Couldn't re-encode the frames from %1 to %2")
+                .arg(segment.m_start).arg(segment.m_end));
+        return false;
+    }
+
+    bool ok = true;
+    for (auto *& pkt : segment.m_packets)
+    {
+        ok = ok && WriteVideo(output, pkt, segment.m_range, true);
+        av_packet_free(&pkt);
+    }
+    segment.m_packets.clear();
+    return ok;
+}
+
+bool SmartCut::WriteVideo(AVFormatContext *output, AVPacket *pkt, int range,
+                          bool encoded)
+{
+    int64_t offset = m_ranges[range].m_offset;
+    pkt->pts -= offset;
+
+    // Re-encoded frames are not reordered, so lag the decode timestamps by
+    // the source's reorder delay to line up with the copied GOPs around them.
+    if (encoded || pkt->dts == AV_NOPTS_VALUE)
+        pkt->dts = pkt->pts - m_delay;
+    else
+        pkt->dts -= offset;
+    if (m_lastDts != AV_NOPTS_VALUE && pkt->dts <= m_lastDts)
+        pkt->dts = m_lastDts + 1;
+    m_lastDts = pkt->dts;
+
+    pkt->stream_index = m_videoOutput;
+    pkt->pos = -1;
+    av_packet_rescale_ts(pkt, m_timeBase,
+                         output->streams[m_videoOutput]->time_base);
+
+    int ret = av_interleaved_write_frame(output, pkt);
+    if (ret < 0)
+    {
+        std::string error;
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Writing video failed: %1")
+            .arg(av_make_error_stdstring(error, ret)));
+        return false;
+    }
+    return true;
+}
+
+bool SmartCut::WriteAudio(AVFormatContext *output, AVPacket *pkt)
+{
+    if (pkt->pts == AV_NOPTS_VALUE)
+        return true;
+
+    AVStream *stream = m_inputFC->streams[pkt->stream_index];
+    AudioTrack &track = m_audio[pkt->stream_index];
+
+    int64_t duration = pkt->duration;
+    if (duration <= 0 && stream->codecpar->frame_size > 0 &&
+        stream->codecpar->sample_rate > 0)
+    {
+        duration = av_rescale_q(stream->codecpar->frame_size,
+                                {1, stream->codecpar->sample_rate},
+                                stream->time_base);
+    }
+
+    int range = FindRange(av_rescale_q(pkt->pts + (duration / 2),
+                                       stream->time_base, m_timeBase));
+    if (range < 0)
+        return true;
+
+    int64_t offset = av_rescale_q(m_ranges[range].m_offset, m_timeBase,
+                                  stream->time_base);
+    int64_t pts = pkt->pts - offset;
+
+    if (range != track.m_range)
+    {
+        // First frame after a splice. Butt it up against the end of the
+        // last one if they overlap by up to half a frame, otherwise drop
+        // it and try the next.
+        track.m_range = range;
+        track.m_shift = 0;
+        if (track.m_end != AV_NOPTS_VALUE && pts < track.m_end)
+        {
+            if (track.m_end - pts > duration / 2)
+            {
+                track.m_range = -1;
+                return true;
+            }
+            track.m_shift = track.m_end - pts;
+        }
+    }
+
+    pts += track.m_shift;
+    pkt->dts = (pkt->dts == AV_NOPTS_VALUE) ? pts
+                                            : pkt->dts - offset + track.m_shift;
+    pkt->pts = pts;
+    track.m_end = pts + duration;
+
+    pkt->stream_index = track.m_output;
+    pkt->pos = -1;
+    av_packet_rescale_ts(pkt, stream->time_base,
+                         output->streams[track.m_output]->time_base);
+
+    int ret = av_interleaved_write_frame(output, pkt);
+    if (ret < 0)
+    {
+        std::string error;
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Writing audio failed: %1")
+            .arg(av_make_error_stdstring(error, ret)));
+        return false;
+    }
+    return true;
+}
+
+int SmartCut::FindRange(int64_t pts) const
+{
+    auto it = std::upper_bound(m_ranges.cbegin(), m_ranges.cend(), pts,
+        [](int64_t value, const KeepRange &range) { return value < range.m_start; });
+    if (it == m_ranges.cbegin())
+        return -1;
+    --it;
+    if (pts >= it->m_end)
+        return -1;
+    return static_cast<int>(it - m_ranges.cbegin());
+}
+
+void SmartCut::ReleaseSegments(void)
+{
+    for (auto &segment : m_segments)
+    {
+        for (auto *& pkt : segment.m_packets)
+            av_packet_free(&pkt);
+        segment.m_packets.clear();
+    }
+}
+
+/** \fn SmartCut::BuildKeyframeIndex(const QString&, frm_pos_map_t&, frm_pos_map_t&)
+ *  \brief Build the seek table for a cut file, mapping the frame number of
+ *         each keyframe to its byte offset and to its time in milliseconds.
+ */
+int SmartCut::BuildKeyframeIndex(const QString &file, frm_pos_map_t &posMap,
+                                 frm_pos_map_t &durMap)
+{
+    LOG(VB_GENERAL, LOG_INFO, LOC + "Generating Keyframe Index");
+
+    AVFormatContext *context = OpenInput(file);
+    if (!context)
+        return GENERIC_EXIT_NOT_OK;
+
+    int index = av_find_best_stream(context, AVMEDIA_TYPE_VIDEO, -1, -1,
+                                    nullptr, 0);
+    AVPacket *pkt = av_packet_alloc();
+    if (index < 0 || !pkt)
+    {
+        av_packet_free(&pkt);
+        avformat_close_input(&context);
+        return GENERIC_EXIT_NOT_OK;
+    }
+
+    AVStream *stream = context->streams[index];
+    AVRational rate = stream->avg_frame_rate.num ? stream->avg_frame_rate
+                                                 : stream->r_frame_rate;
+    int64_t frameDuration = rate.num ? av_rescale_q(1, av_inv_q(rate),
+                                                    stream->time_base) : 0;
+
+    int64_t count = 0;
+    int64_t firstPts = AV_NOPTS_VALUE;
+    int64_t lastMs = 0;
+    while (av_read_frame(context, pkt) >= 0)
+    {
+        if (pkt->stream_index == index)
+        {
+            if (firstPts == AV_NOPTS_VALUE && pkt->pts != AV_NOPTS_VALUE)
+                firstPts = pkt->pts;
+
+            if (pkt->flags & AV_PKT_FLAG_KEY)
+            {
+                // Position the keyframe by its timestamp where there is one,
+                // it is exact where the running duration is not.
+                if (pkt->pts != AV_NOPTS_VALUE && firstPts != AV_NOPTS_VALUE)
+                {
+                    lastMs = av_rescale_q(pkt->pts - firstPts, stream->time_base,
+                                          {1, 1000});
+                }
+                posMap[count] = pkt->pos;
+                durMap[count] = lastMs;
+            }
+
+            int64_t duration = pkt->duration > 0 ? pkt->duration : frameDuration;
+            lastMs += av_rescale_q(duration, stream->time_base, {1, 1000});
+            count++;
+        }
+        av_packet_unref(pkt);
+    }
+
+    av_packet_free(&pkt);
+    avformat_close_input(&context);
+
+    LOG(VB_GENERAL, LOG_INFO, LOC +
+        QString("Indexed %1 keyframes in %2 frames").arg(posMap.size()).arg(count));
+    return REENCODE_OK;
+}
@@ -0,0 +1,139 @@
+#ifndef SMARTCUT_H
+#define SMARTCUT_H
+
+// C++
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Qt
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+
+extern "C"
+{
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+}
+
+// MythTV
+#include "libmythbase/mthreadpool.h"
+#include "libmythtv/programtypes.h"
+
+/** \class SmartCut
+ *  \brief Lossless cutting of H.264 and HEVC transport streams.
+ *
+ *  The video is copied a whole GOP at a time. Only the frames between a
+ *  cut point and the nearest GOP boundary inside the kept section are
+ *  decoded and re-encoded, on a thread pool while the copy pass runs, so
+ *  the cost of a cut no longer depends on the length of the recording.
+ *
+ *  Broadcasts mostly use open GOPs, whose leading frames are shown before
+ *  the keyframe but refer back to the GOP before it. Such a GOP is copied
+ *  from its keyframe without its leading frames, and those are re-encoded
+ *  along with the frames ahead of it instead.
+ *
+ *  Audio is copied a codec frame at a time. At each splice the frames
+ *  whose centre falls inside the kept section are kept and the audio
+ *  is lined up against the video timeline of that section, so the sync
+ *  error stays below half an audio frame and does not build up from one
+ *  cut to the next.
+ */
+class SmartCut
+{
+  public:
+    SmartCut(QString inf, QString outf, const frm_dir_map_t &deleteMap,
+             void (*update_func)(float) = nullptr, int (*check_func)() = nullptr);
+    ~SmartCut();
+
+    static bool CanCut(const QString &file);
+    int  Start(void);
+    static int BuildKeyframeIndex(const QString &file, frm_pos_map_t &posMap,
+                                  frm_pos_map_t &durMap);
+
+  private:
+    friend class SmartCutEncodeJob;
+
+    struct VideoPacket
+    {
+        int64_t m_pts    {AV_NOPTS_VALUE};
+        int64_t m_dts    {AV_NOPTS_VALUE};
+        int64_t m_pos    {-1};
+        bool    m_key    {false};
+        /// Keyframes only: the earliest pts decoded from here up to the
+        /// next keyframe. Before m_pts when the GOP is open.
+        int64_t m_lead   {AV_NOPTS_VALUE};
+    };
+
+    /// A kept section of the video, in video stream time base.
+    struct KeepRange
+    {
+        int64_t m_start  {0};
+        int64_t m_end    {INT64_MAX};
+        int64_t m_offset {0}; ///< subtracted from input timestamps
+    };
+
+    struct Segment
+    {
+        bool    m_copy        {false};
+        int64_t m_start       {0};
+        int64_t m_end         {INT64_MAX};
+        size_t  m_firstPacket {0};  ///< video packet, in decode order, that
+        size_t  m_endPacket   {0};  ///< the segment is written at / before
+        int     m_range       {0};
+        bool    m_done        {false};
+        bool    m_ok          {false};
+        std::vector<AVPacket*> m_packets; ///< encode only
+    };
+
+    struct AudioTrack
+    {
+        int     m_output {-1};
+        int     m_range  {-1};
+        int64_t m_shift  {0};
+        int64_t m_end    {AV_NOPTS_VALUE};
+    };
+
+    static AVFormatContext *OpenInput(const QString &file);
+    bool Scan(void);
+    bool Plan(void);
+    int  Mux(void);
+    void UpdateStatus(void);
+    bool EncodeSegment(Segment &segment);
+    bool WriteSegment(AVFormatContext *output, Segment &segment);
+    bool WriteVideo(AVFormatContext *output, AVPacket *pkt, int range,
+                    bool encoded);
+    bool WriteAudio(AVFormatContext *output, AVPacket *pkt);
+    int  FindRange(int64_t pts) const;
+    void ReleaseSegments(void);
+
+    QString                   m_infile;
+    QString                   m_outfile;
+    frm_dir_map_t             m_deleteMap;
+    int                     (*m_checkAbort)()                      {nullptr};
+    void                    (*m_updateStatus)(float percent_done) {nullptr};
+
+    AVFormatContext          *m_inputFC     {nullptr};
+    int                       m_videoIndex  {-1};
+    int                       m_videoOutput {-1};
+    AVRational                m_timeBase    {1, 90000};
+    AVRational                m_frameRate   {0, 1};
+    int64_t                   m_delay       {0}; ///< largest pts - dts
+    std::vector<VideoPacket>  m_packets;
+    std::vector<int64_t>      m_framePts;   ///< display order
+    std::vector<KeepRange>    m_ranges;
+    std::vector<Segment>      m_segments;
+    std::vector<AudioTrack>   m_audio;      ///< indexed by input stream
+    int64_t                   m_lastDts     {AV_NOPTS_VALUE};
+    int64_t                   m_fileSize    {0};
+    QElapsedTimer             m_statusTime;
+
+    MThreadPool               m_pool        {"SmartCut"};
+    QMutex                    m_lock;
+    QWaitCondition            m_segmentDone;
+    std::atomic<bool>         m_abort       {false};
+};
+
+#endif // SMARTCUT_H
@@ -340,6 +340,19 @@ static GlobalCheckBoxSetting *DisableAutomaticBackup()
     return gc;
 };
 
+static GlobalCheckBoxSetting *LiveTVStandbyInputs()
+{
+    auto *gc = new GlobalCheckBoxSetting("LiveTVStandbyInputs");
+    gc->setLabel(QObject::tr("Tune idle inputs for Live TV channel changes"));
+    gc->setValue(false);
+    gc->setHelpText(QObject::tr("If enabled, idle tuners on the video "
+                                "source being watched in Live TV are tuned "
+                                "to the channels above and below, so "
+                                "changing to them is faster. The tuners "
+                                "are freed as soon as they are needed."));
+    return gc;
+};
+
 static HostCheckBoxSetting *DisableFirewireReset()
 {
     auto *hc = new HostCheckBoxSetting("DisableFirewireReset");
@@ -625,7 +638,9 @@ static HostSpinBoxSetting *JobQueueMaxSimultaneousJobs()
     auto *gc = new HostSpinBoxSetting("JobQueueMaxSimultaneousJobs", 1, 10, 1);
     gc->setLabel(QObject::tr("Maximum simultaneous jobs on this backend"));
     gc->setHelpText(QObject::tr("The Job Queue will be limited to running "
-                    "this many simultaneous jobs on this backend."));
+                    "this many simultaneous jobs on this backend. Fewer may "
+                    "run if the backend doesn't have the CPU, memory or disk "
+                    "bandwidth for more."));
     gc->setValue(1);
     return gc;
 };
@@ -634,8 +649,9 @@ static HostSpinBoxSetting *JobQueueCheckFrequency()
 {
     auto *gc = new HostSpinBoxSetting("JobQueueCheckFrequency", 5, 300, 5);
     gc->setLabel(QObject::tr("Job Queue check frequency (secs)"));
-    gc->setHelpText(QObject::tr("When looking for new jobs to process, the "
-                    "Job Queue will wait this many seconds between checks."));
+    gc->setHelpText(QObject::tr("The Job Queue starts jobs as soon as they "
+                    "are queued or a running job finishes. It will also look "
+                    "for jobs to process at least this often, in seconds."));
     gc->setValue(60);
     return gc;
 };
@@ -711,6 +727,19 @@ static GlobalCheckBoxSetting *AutoCommflagWhileRecording()
     return gc;
 };
 
+static GlobalCheckBoxSetting *AutoPreviewStrip()
+{
+    auto *gc = new GlobalCheckBoxSetting("AutoPreviewStrip");
+    gc->setLabel(QObject::tr("Make seek preview strips for new recordings"));
+    gc->setValue(false);
+    gc->setHelpText(QObject::tr("If enabled, a preview job is queued when "
+                                "each recording finishes. It saves a small "
+                                "thumbnail for every ten seconds of the "
+                                "recording, which the player shows while "
+                                "seeking and editing."));
+    return gc;
+};
+
 static GlobalTextEditSetting *UserJob(uint job_num)
 {
     auto *gc = new GlobalTextEditSetting(QString("UserJob%1").arg(job_num));
@@ -991,6 +1020,7 @@ BackendSettings::BackendSettings()
     group2->addChild(MiscStatusScript());
     group2->addChild(DisableAutomaticBackup());
     group2->addChild(DisableFirewireReset());
+    group2->addChild(LiveTVStandbyInputs());
     addChild(group2);
 
     auto* group2a1 = new GroupSetting();
@@ -1062,6 +1092,7 @@ BackendSettings::BackendSettings()
     group6->addChild(JobQueueCommFlagCommand());
     group6->addChild(JobQueueTranscodeCommand());
     group6->addChild(AutoTranscodeBeforeAutoCommflag());
+    group6->addChild(AutoPreviewStrip());
     group6->addChild(SaveTranscoding());
     addChild(group6);
 
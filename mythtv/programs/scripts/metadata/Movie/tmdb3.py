@@ -48,7 +48,7 @@ def performSelfTest():
         print ("Everything appears in order.")
     return err
 
-def main(showType, command):
+def main(showType, command, argv=None):
 
     parser = OptionParser()
 
@@ -72,7 +72,7 @@ def main(showType, command):
                       dest="debug", help=("Disable caching and enable raw "
                                           "data output."))
 
-    opts, args = parser.parse_args()
+    opts, args = parser.parse_args(argv)
 
     from MythTV.tmdb3.lookup import timeouthandler
     signal.signal(signal.SIGALRM, timeouthandler)
@@ -147,4 +147,7 @@ def main(showType, command):
     return 0
 
 if __name__ == '__main__':
+    if sys.argv[1:] == ['--session']:
+        from MythTV.tmdb3.lookup import runSession
+        sys.exit(runSession(lambda argv: main("movie",'tmdb3.py', argv)))
     sys.exit(main("movie",'tmdb3.py'))
@@ -46,7 +46,7 @@ def performSelfTest():
         print ("Everything appears in order.")
     return err
 
-def main(showType, command):
+def main(showType, command, argv=None):
 
     parser = OptionParser()
 
@@ -74,7 +74,7 @@ def main(showType, command):
                       dest="debug", help=("Disable caching and enable raw "
                                           "data output."))
 
-    opts, args = parser.parse_args()
+    opts, args = parser.parse_args(argv)
 
     from MythTV.tmdb3.lookup import timeouthandler
     signal.signal(signal.SIGALRM, timeouthandler)
@@ -156,4 +156,7 @@ def main(showType, command):
     return 0
 
 if __name__ == '__main__':
+    if sys.argv[1:] == ['--session']:
+        from MythTV.tmdb3.lookup import runSession
+        sys.exit(runSession(lambda argv: main("television",'tmdb3tv.py', argv)))
     sys.exit(main("television",'tmdb3tv.py'))